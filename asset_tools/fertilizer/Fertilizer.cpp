@@ -6,38 +6,157 @@
 #include <TextureCompression.h>
 #include <EnvironmentMapProcessing.h>
 #include <models/ModelProcessing.h>
+#include <cctype>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <unordered_map>
 #include <filesystem>
+#include <rapidjson/document.h>
 #include "core/utils/stringmanip.h"
+#include "core/io/IO.h"
 
 namespace Fertilizer {
     using fspath = std::filesystem::path;
 
+    using DependencyListFunction = std::vector<fspath>(*)(const fspath& inputFile);
+
+    static std::vector<fspath> noDependencies(const fspath& inputFile) {
+        return {};
+    }
+
+    static std::vector<fspath> listGLTFDependencies(const fspath& inputFile);
+    static std::vector<fspath> listOBJDependencies(const fspath& inputFile);
+
+    // Increase when the output of the corresponding converter changes
+    constexpr std::uint32_t TextureConverterVersion = 1;
+    constexpr std::uint32_t ModelConverterVersion = 2;
+    constexpr std::uint32_t EnvironmentMapConverterVersion = 1;
+
     struct Convertor {
         std::filesystem::path replacementExtension;
         ConversionFunction func;
+        std::uint32_t version = 1;
+        DependencyListFunction listDependencies = noDependencies;
     };
 
     static std::unordered_map<std::string, Convertor> ConversionFunctions = {
-            { ".png", { ".ktx2", compressTexture } },
-            { ".jpg", { ".ktx2",  compressTexture } },
-            { ".jpeg", { ".ktx2", compressTexture } },
-            { ".tga", { ".ktx2",  compressTexture } },
-            { ".bmp", { ".ktx2",  compressTexture } },
-            { ".psd", { ".ktx2",  compressTexture } },
-            { ".gif", { ".ktx2",  compressTexture } },
-            { ".pic", { ".ktx2",  compressTexture } },
-            { ".pnm", { ".ktx2",  compressTexture } },
-
-            { ".gltf", { ".gltf", processGLTF } },
-            { ".glb", { ".gltf", processGLTF } },
-            { ".obj", { ".gltf", processAssimp } },
-            { ".fbx", { ".gltf", processAssimp } },
-
-        { ".hdr", { ".ktx2",  processEnvironmentMap } },
+            { ".png", { ".ktx2", compressTexture, TextureConverterVersion } },
+            { ".jpg", { ".ktx2",  compressTexture, TextureConverterVersion } },
+            { ".jpeg", { ".ktx2", compressTexture, TextureConverterVersion } },
+            { ".tga", { ".ktx2",  compressTexture, TextureConverterVersion } },
+            { ".bmp", { ".ktx2",  compressTexture, TextureConverterVersion } },
+            { ".psd", { ".ktx2",  compressTexture, TextureConverterVersion } },
+            { ".gif", { ".ktx2",  compressTexture, TextureConverterVersion } },
+            { ".pic", { ".ktx2",  compressTexture, TextureConverterVersion } },
+            { ".pnm", { ".ktx2",  compressTexture, TextureConverterVersion } },
+
+            { ".gltf", { ".gltf", processGLTF, ModelConverterVersion, listGLTFDependencies } },
+            { ".glb", { ".gltf", processGLTF, ModelConverterVersion, listGLTFDependencies } },
+            { ".obj", { ".gltf", processAssimp, ModelConverterVersion, listOBJDependencies } },
+            { ".fbx", { ".gltf", processAssimp, ModelConverterVersion } },
+
+        { ".hdr", { ".ktx2",  processEnvironmentMap, EnvironmentMapConverterVersion } },
     };
 
+    /// Decodes %XX sequences found in glTF URIs
+    static std::string decodeURI(const std::string& uri) {
+        std::string result;
+        result.reserve(uri.size());
+        for(std::size_t i = 0; i < uri.size(); i++) {
+            if(uri[i] == '%' && i + 2 < uri.size()) {
+                result += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                result += uri[i];
+            }
+        }
+        return result;
+    }
+
+    static std::vector<fspath> listGLTFDependencies(const fspath& inputFile) {
+        std::string json;
+        if(inputFile.extension() == ".glb") {
+            // binary glTF: 12-byte header, then the JSON chunk (4 bytes of length, 4 bytes of type)
+            std::ifstream file(inputFile, std::ios::binary);
+            std::uint32_t header[5];
+            if(!file.read(reinterpret_cast<char*>(header), sizeof(header))) {
+                return {};
+            }
+            json.resize(header[3]);
+            file.read(json.data(), json.size());
+        } else {
+            json = Carrot::IO::readFileAsText(inputFile.string());
+        }
+
+        rapidjson::Document document;
+        document.Parse(json.c_str(), json.size());
+        if(document.HasParseError() || !document.IsObject()) {
+            return {};
+        }
+
+        std::vector<fspath> dependencies;
+        const fspath parentFolder = inputFile.parent_path();
+        for(const char* arrayName : { "buffers", "images" }) {
+            auto arrayIt = document.FindMember(arrayName);
+            if(arrayIt == document.MemberEnd() || !arrayIt->value.IsArray()) {
+                continue;
+            }
+            for(const auto& element : arrayIt->value.GetArray()) {
+                auto uriIt = element.FindMember("uri");
+                if(uriIt == element.MemberEnd() || !uriIt->value.IsString()) {
+                    continue; // embedded inside GLB
+                }
+                const std::string uri = uriIt->value.GetString();
+                if(uri.starts_with("data:")) {
+                    continue;
+                }
+                dependencies.emplace_back((parentFolder / decodeURI(uri)).lexically_normal());
+            }
+        }
+        return dependencies;
+    }
+
+    static void listMTLDependencies(const fspath& mtlFile, std::vector<fspath>& dependencies) {
+        std::ifstream file(mtlFile);
+        std::string line;
+        while(std::getline(file, line)) {
+            std::istringstream tokens(line);
+            std::string keyword;
+            tokens >> keyword;
+            if(!keyword.starts_with("map_") && keyword != "bump" && keyword != "disp" && keyword != "norm") {
+                continue;
+            }
+            // texture name is the last token, options come before
+            std::string texture;
+            for(std::string token; tokens >> token;) {
+                texture = token;
+            }
+            if(!texture.empty()) {
+                dependencies.emplace_back((mtlFile.parent_path() / texture).lexically_normal());
+            }
+        }
+    }
+
+    static std::vector<fspath> listOBJDependencies(const fspath& inputFile) {
+        std::vector<fspath> dependencies;
+        std::ifstream file(inputFile);
+        std::string line;
+        while(std::getline(file, line)) {
+            if(!line.starts_with("mtllib ")) {
+                continue;
+            }
+            std::string mtlName = line.substr(7);
+            while(!mtlName.empty() && std::isspace(static_cast<unsigned char>(mtlName.back()))) { // '\r' on files with Windows line endings
+                mtlName.pop_back();
+            }
+            const fspath mtlFile = (inputFile.parent_path() / mtlName).lexically_normal();
+            dependencies.emplace_back(mtlFile);
+            listMTLDependencies(mtlFile, dependencies);
+        }
+        return dependencies;
+    }
+
     bool isSupportedFormat(const fspath& input) {
         return ConversionFunctions.find(input.extension().string()) != ConversionFunctions.end();
     }
@@ -48,6 +167,22 @@ namespace Fertilizer {
         return std::filesystem::last_write_time(inputFile) != std::filesystem::last_write_time(outputFile);
     }
 
+    std::uint32_t getConverterVersion(const fspath& inputFile) {
+        auto convertorIt = ConversionFunctions.find(inputFile.extension().string());
+        if(convertorIt == ConversionFunctions.end()) {
+            return 0;
+        }
+        return convertorIt->second.version;
+    }
+
+    std::vector<fspath> getDependencies(const fspath& inputFile) {
+        auto convertorIt = ConversionFunctions.find(inputFile.extension().string());
+        if(convertorIt == ConversionFunctions.end()) {
+            return {};
+        }
+        return convertorIt->second.listDependencies(inputFile);
+    }
+
     std::filesystem::path makeOutputPath(const std::filesystem::path& inputFile) {
         auto convertorIt = ConversionFunctions.find(inputFile.extension().string());
         if(convertorIt == ConversionFunctions.end()) {
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 namespace Fertilizer {
     enum class ConversionResultError {
@@ -15,6 +18,7 @@ namespace Fertilizer {
         TextureCompressionError,
         ModelCompressionError,
         EnvironmentMapError,
+        CookedModelError,
     };
 
     struct ConversionResult {
@@ -36,6 +40,20 @@ namespace Fertilizer {
      */
     bool requiresModifications(const std::filesystem::path& inputFile, const std::filesystem::path& outputFile);
 
+    /**
+     * Version of the converter used for the given input file. Increased each time the output of a converter changes,
+     * so that tools caching conversion results know they need to convert again.
+     * Returns 0 if the format is not supported.
+     */
+    std::uint32_t getConverterVersion(const std::filesystem::path& inputFile);
+
+    /**
+     * Lists the files the conversion of 'inputFile' reads, in addition to 'inputFile' itself.
+     * For instance, the buffers and images referenced by a glTF file, or the material libraries of an OBJ file.
+     * Returned paths are absolute, and files are not guaranteed to exist.
+     */
+    std::vector<std::filesystem::path> getDependencies(const std::filesystem::path& inputFile);
+
     /**
      * Creates a new path with the extension of the input replaced with the extension used for the output.
      * NO GUARANTEE TO be different than input!
@@ -3,7 +3,10 @@
 //
 
 #include <TextureCompression.h>
+#include <models/ModelProcessing.h>
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <thread>
 #include "core/Macros.h"
 #include "core/utils/stringmanip.h"
@@ -13,6 +16,9 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// conversion threads currently running, used to share the hardware threads between their parallelFor calls
+static std::atomic<std::size_t> runningConversionThreads { 0 };
+
 int main(int argc, char** argv) {
     auto start = std::chrono::steady_clock::now();
 
@@ -24,6 +30,7 @@ int main(int argc, char** argv) {
     bool hasInput = false;
     bool hasOutput = false;
     bool forceConvert = false;
+    bool validateCookedModels = false;
     std::filesystem::path inputFile;
     std::filesystem::path outputFile;
     for (int i = 1; i < argc;) {
@@ -32,6 +39,8 @@ int main(int argc, char** argv) {
             recursive = true;
         } else if(arg == "-f" || arg == "--force") {
             forceConvert = true;
+        } else if(arg == "--validate") {
+            validateCookedModels = true;
         } else {
             if(!hasInput) {
                 inputFile = arg;
@@ -59,6 +68,32 @@ int main(int argc, char** argv) {
         return 4;
     }
 
+    if(validateCookedModels) {
+        // input is a glTF exported by Fertilizer (or a folder of exported glTFs with --recursive), checked against its cooked model
+        std::vector<std::filesystem::path> gltfFiles;
+        if(recursive) {
+            for(const auto& entry : std::filesystem::recursive_directory_iterator(inputFile)) {
+                if(entry.path().extension() == ".gltf") {
+                    gltfFiles.emplace_back(entry.path());
+                }
+            }
+        } else {
+            gltfFiles.emplace_back(inputFile);
+        }
+
+        int errorCode = 0;
+        for(const auto& gltfFile : gltfFiles) {
+            Fertilizer::ConversionResult result = Fertilizer::validateCookedModel(gltfFile);
+            if(result.errorCode != Fertilizer::ConversionResultError::Success) {
+                errorCode = -1;
+                std::cerr << "[" << gltfFile << "] Validation failed: " << result.errorMessage << std::endl;
+            } else {
+                std::cout << "[" << gltfFile << "] OK" << std::endl;
+            }
+        }
+        return errorCode;
+    }
+
     if(!hasOutput) {
         std::cerr << "Missing output file." << std::endl;
         return 4;
@@ -87,17 +122,59 @@ int main(int argc, char** argv) {
     const unsigned int stepSize = ceil(allInputs.size() / (float)maxThreads);
 
     Carrot::Async::parallelFor = [](std::size_t count, const std::function<void(std::size_t)>& forEach, std::size_t granularity) {
-        // TODO: make it actually parallel
-        for(std::size_t i = 0; i < count; i++) {
-            forEach(i);
+        // no task scheduler in this executable: split the work in chunks of 'granularity' elements, processed by short-lived threads
+        // called from conversion threads which already run in parallel: each one only gets its share of the hardware threads
+        const std::size_t chunkSize = std::max<std::size_t>(1, granularity);
+        const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+        const std::size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t threadBudget = std::max<std::size_t>(1, hardwareThreads / std::max<std::size_t>(1, runningConversionThreads.load()));
+        const std::size_t threadCount = std::min(chunkCount, threadBudget);
+        if(threadCount <= 1) {
+            for(std::size_t i = 0; i < count; i++) {
+                forEach(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> nextChunk { 0 };
+        std::mutex exceptionAccess;
+        std::exception_ptr exception = nullptr;
+        auto work = [&]() {
+            try {
+                for(std::size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                    const std::size_t end = std::min(count, (chunk + 1) * chunkSize);
+                    for(std::size_t i = chunk * chunkSize; i < end; i++) {
+                        forEach(i);
+                    }
+                }
+            } catch(...) {
+                std::lock_guard l { exceptionAccess };
+                exception = std::current_exception();
+                nextChunk = chunkCount; // stop other threads as soon as possible
+            }
+        };
+
+        std::vector<std::thread> helpers;
+        helpers.reserve(threadCount - 1);
+        for(std::size_t i = 0; i < threadCount - 1; i++) {
+            helpers.emplace_back(work);
+        }
+        work(); // calling thread participates
+        for(auto& t : helpers) {
+            t.join();
+        }
+        if(exception) {
+            std::rethrow_exception(exception);
         }
     };
 
     std::vector<std::thread> threads;
     threads.reserve(maxThreads);
     for(std::size_t i = 0; i < allInputs.size(); i += stepSize) {
+        runningConversionThreads++;
         threads.emplace_back([&, i]()
         {
+            CLEANUP(runningConversionThreads--);
             for (int j = 0; j < stepSize; ++j) {
                 unsigned int index = j + i;
                 if(index >= allInputs.size()) {
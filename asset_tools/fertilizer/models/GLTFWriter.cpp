@@ -8,6 +8,8 @@
 #include "glm/detail/type_quat.hpp"
 #include "glm/gtx/matrix_decompose.hpp"
 #include "core/scene/GLTFLoader.h" // for extension names
+#include "core/math/BasicFunctions.h"
+#include "core/render/MeshCompression.h"
 
 namespace Fertilizer {
     static glm::mat4 carrotSpaceToGLTFSpace = glm::rotate(glm::mat4{1.0f}, -glm::pi<float>()/2.0f, glm::vec3(1,0,0));
@@ -36,6 +38,10 @@ namespace Fertilizer {
         return { v.x, v.y, v.z, v.w };
     }
 
+    static tinygltf::Value arrayValue(const glm::vec3& v) {
+        return tinygltf::Value { tinygltf::Value::Array { tinygltf::Value { static_cast<double>(v.x) }, tinygltf::Value { static_cast<double>(v.y) }, tinygltf::Value { static_cast<double>(v.z) } } };
+    }
+
     static std::vector<double> vectorOfDoubles(const glm::quat& q) {
         return { q.x, q.y, q.z, q.w };
     }
@@ -376,43 +382,45 @@ namespace Fertilizer {
                     accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
                 }
 
-                // vertex indices
-                {
-                    const std::size_t count = primitive.meshletVertexIndices.size();
+                // compressed streams are stored as byte blobs (like meshlet data), their decoded size is stored in the extension
+                auto writeCompressedStream = [&](const std::vector<std::uint8_t>& compressed, const char* suffix) {
                     const std::size_t startIndex = clustersBuffer.data.size();
-                    const std::size_t bufferSize = count * sizeof(std::uint32_t);
-                    clustersBuffer.data.resize(startIndex + bufferSize);
-                    memcpy(clustersBuffer.data.data() + startIndex, primitive.meshletVertexIndices.data(), bufferSize);
+                    clustersBuffer.data.resize(startIndex + Carrot::Math::alignUp<std::size_t>(compressed.size(), sizeof(std::uint32_t)));
+                    memcpy(clustersBuffer.data.data() + startIndex, compressed.data(), compressed.size());
 
                     tinygltf::Accessor& accessor = model.accessors.emplace_back();
                     accessor.bufferView = clustersBufferViewIndex;
                     accessor.byteOffset = startIndex;
-                    accessor.count = count;
-                    accessor.name = Carrot::sprintf("%s-meshlets-vertex-indices", primitive.name.c_str());
+                    accessor.count = compressed.size();
+                    accessor.name = Carrot::sprintf("%s-%s", primitive.name.c_str(), suffix);
                     accessor.type = TINYGLTF_TYPE_SCALAR;
-                    accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
-                }
+                    accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+                };
 
-                // indices
-                {
-                    const std::size_t count = primitive.meshletIndices.size();
-                    const std::size_t startIndex = clustersBuffer.data.size();
-                    const std::size_t bufferSize = count * sizeof(std::uint32_t);
-                    clustersBuffer.data.resize(startIndex + bufferSize);
-                    memcpy(clustersBuffer.data.data() + startIndex, primitive.meshletIndices.data(), bufferSize);
+                // vertex indices
+                writeCompressedStream(Carrot::MeshCompression::encodeIndexSequence(primitive.meshletVertexIndices), "meshlets-vertex-indices");
 
-                    tinygltf::Accessor& accessor = model.accessors.emplace_back();
-                    accessor.bufferView = clustersBufferViewIndex;
-                    accessor.byteOffset = startIndex;
-                    accessor.count = count;
-                    accessor.name = Carrot::sprintf("%s-meshlets-indices", primitive.name.c_str());
-                    accessor.type = TINYGLTF_TYPE_SCALAR;
-                    accessor.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+                // indices
+                writeCompressedStream(Carrot::MeshCompression::encodeIndexBuffer(primitive.meshletIndices), "meshlets-indices");
+
+                // quantized vertices, used for rendering instead of the float vertices
+                if(!primitive.quantizedVertices.empty()) {
+                    const int quantizedVerticesAccessorIndex = accessorIndex;
+                    accessorIndex++;
+                    writeCompressedStream(Carrot::MeshCompression::encodeVertexBuffer(std::span<const Carrot::QuantizedVertex> { primitive.quantizedVertices }), "quantized-vertices");
+
+                    meshletsExtension["quantized_vertices"] = tinygltf::Value { quantizedVerticesAccessorIndex };
+                    meshletsExtension["quantized_vertices_count"] = tinygltf::Value { static_cast<int>(primitive.quantizedVertices.size()) };
+                    meshletsExtension["quantization_bounds_min"] = arrayValue(primitive.quantizationBounds.min);
+                    meshletsExtension["quantization_bounds_max"] = arrayValue(primitive.quantizationBounds.max);
                 }
 
                 meshletsExtension["meshlets"] = tinygltf::Value { meshletsAccessorIndex };
                 meshletsExtension["meshlets_vertex_indices"] = tinygltf::Value { meshletVertexIndicesAccessorIndex };
                 meshletsExtension["meshlets_indices"] = tinygltf::Value { meshletIndicesAccessorIndex };
+                meshletsExtension["compression"] = tinygltf::Value { std::string { Carrot::Render::GLTFLoader::CARROT_MESHLETS_MESHOPT_COMPRESSION } };
+                meshletsExtension["meshlets_vertex_indices_count"] = tinygltf::Value { static_cast<int>(primitive.meshletVertexIndices.size()) };
+                meshletsExtension["meshlets_indices_count"] = tinygltf::Value { static_cast<int>(primitive.meshletIndices.size()) };
                 meshletsExtensionJSON = tinygltf::Value{ std::move(meshletsExtension) };
             }
         }
@@ -8,13 +8,18 @@
 #include <core/scene/LoadedScene.h>
 #include <core/Macros.h>
 #include <core/scene/GLTFLoader.h>
+#include <core/scene/CookedModel.h>
 #include <models/GLTFWriter.h>
 #include <unordered_set>
+#include <fstream>
+#include <array>
+#include <atomic>
 #include <core/io/Logging.hpp>
 #include <glm/gtx/component_wise.hpp>
 #include <core/tasks/Tasks.h>
 #include <core/data/Hashes.h>
 #include <core/containers/KDTree.hpp>
+#include <core/utils/RadixSort.h>
 #include <glm/gtx/hash.hpp>
 
 #include <models/MikkTSpaceInterface.h>
@@ -27,6 +32,7 @@
 #include <robin_hood.h>
 #include <core/math/Sphere.h>
 #include <core/render/VkAccelerationStructureHeader.h>
+#include <core/render/VertexQuantization.h>
 #include <core/scene/AssimpLoader.h>
 #include <glm/gtx/norm.hpp>
 #include <gpu_assistance/VulkanHelper.h>
@@ -272,23 +278,6 @@ namespace Fertilizer {
     /**
      * Connections betweens meshlets
      */
-    struct MeshletEdge {
-        explicit MeshletEdge(std::size_t a, std::size_t b): first(std::min(a, b)), second(std::max(a, b)) {}
-
-        bool operator==(const MeshletEdge& other) const = default;
-
-        const std::size_t first;
-        const std::size_t second;
-    };
-
-    struct MeshletEdgeHasher {
-        std::size_t operator()(const MeshletEdge& edge) const {
-            std::size_t h = edge.first;
-            Carrot::hash_combine(h, edge.second);
-            return h;
-        }
-    };
-
     /// trick to allow getPosition() on Carrot::Vertex for KDTree, without needing to allocate anything
     struct VertexWrapper {
         const Carrot::Vertex* vertices = nullptr;
@@ -299,23 +288,32 @@ namespace Fertilizer {
         }
     };
 
+    /// Edge of a meshlet, used to find which meshlets share edges by sorting instead of hashing
+    struct MeshletEdgeReference {
+        std::uint64_t edgeKey; // smallest vertex index in high 32 bits, largest in low 32 bits
+        std::uint32_t meshletIndex;
+    };
+
     /**
-     * Find which vertices are part of meshlet boundaries. These should not be merged to avoid cracks between LOD levels
+     * Lists all edges of the given meshlets (vertex indices are remapped with 'vertexRemap', if not empty), sorted by edge.
+     * References to the same edge are sorted by meshlet index, and each (edge, meshlet) pair is present only once.
+     * Degenerate edges are ignored. Memory comes from 'allocator'.
      */
-    static Carrot::Vector<bool> findBoundaryVertices(Carrot::Allocator& allocator, LoadedPrimitive& primitive, std::span<Meshlet> meshlets) {
-        Carrot::Vector<bool> boundaryVertices { allocator };
-        boundaryVertices.resize(primitive.vertices.size());
-        boundaryVertices.fill(false);
-
-        // meshlets represented by their index into 'previousLevelMeshlets'
-        std::unordered_map<MeshletEdge, std::unordered_set<std::size_t>, MeshletEdgeHasher> edges2Meshlets;
+    static Carrot::Vector<MeshletEdgeReference> collectMeshletEdges(Carrot::Allocator& allocator, const LoadedPrimitive& primitive, std::span<const Meshlet> meshlets, std::span<const std::int64_t> vertexRemap) {
+        std::size_t maxEdgeCount = 0;
+        for(const auto& meshlet : meshlets) {
+            maxEdgeCount += (meshlet.indexCount / 3) * 3;
+        }
 
-        // for each meshlet
+        Carrot::Vector<MeshletEdgeReference> edges { allocator };
+        edges.resize(maxEdgeCount);
+        std::size_t edgeCount = 0;
+        // meshlets represented by their index into 'meshlets'
         for(std::size_t meshletIndex = 0; meshletIndex < meshlets.size(); meshletIndex++) {
             const auto& meshlet = meshlets[meshletIndex];
-            auto getVertexIndex = [&](std::size_t index) {
+            auto getVertexIndex = [&](std::size_t index) -> std::uint64_t {
                 const std::size_t vertexIndex = primitive.meshletVertexIndices[primitive.meshletIndices[index + meshlet.indexOffset] + meshlet.vertexOffset];
-                return vertexIndex;
+                return vertexRemap.empty() ? vertexIndex : static_cast<std::uint64_t>(vertexRemap[vertexIndex]);
             };
 
             const std::size_t triangleCount = meshlet.indexCount / 3;
@@ -323,19 +321,57 @@ namespace Fertilizer {
             for(std::size_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++) {
                 // for each edge of the triangle
                 for(std::size_t i = 0; i < 3; i++) {
-                    MeshletEdge edge { getVertexIndex(i + triangleIndex * 3), getVertexIndex(((i+1) % 3) + triangleIndex * 3) };
-                    if(edge.first != edge.second) {
-                        edges2Meshlets[edge].insert(meshletIndex);
+                    const std::uint64_t a = getVertexIndex(i + triangleIndex * 3);
+                    const std::uint64_t b = getVertexIndex(((i+1) % 3) + triangleIndex * 3);
+                    if(a != b) {
+                        edges[edgeCount++] = MeshletEdgeReference {
+                            .edgeKey = (std::min(a, b) << 32) | std::max(a, b),
+                            .meshletIndex = static_cast<std::uint32_t>(meshletIndex),
+                        };
                     }
                 }
             }
         }
+        edges.resize(edgeCount);
+
+        // edges were emitted in meshlet order, and the sort is stable: references to the same edge stay sorted by meshlet
+        Carrot::Vector<MeshletEdgeReference> scratch { allocator };
+        scratch.resize(edgeCount);
+        Carrot::radixSort(std::span { edges.data(), edgeCount }, std::span { scratch.data(), edgeCount }, [](const MeshletEdgeReference& e) { return e.edgeKey; });
+
+        // remove duplicate (edge, meshlet) pairs, which are now adjacent
+        std::size_t uniqueCount = 0;
+        for(std::size_t i = 0; i < edgeCount; i++) {
+            if(uniqueCount > 0 && edges[uniqueCount-1].edgeKey == edges[i].edgeKey && edges[uniqueCount-1].meshletIndex == edges[i].meshletIndex) {
+                continue;
+            }
+            edges[uniqueCount++] = edges[i];
+        }
+        edges.resize(uniqueCount);
+        return edges;
+    }
+
+    /**
+     * Find which vertices are part of meshlet boundaries. These should not be merged to avoid cracks between LOD levels
+     */
+    static Carrot::Vector<bool> findBoundaryVertices(Carrot::Allocator& allocator, LoadedPrimitive& primitive, std::span<Meshlet> meshlets) {
+        Carrot::Vector<bool> boundaryVertices { allocator };
+        boundaryVertices.resize(primitive.vertices.size());
+        boundaryVertices.fill(false);
+
+        const Carrot::Vector<MeshletEdgeReference> edges = collectMeshletEdges(allocator, primitive, meshlets, {});
 
-        for(const auto& [edge, meshlets] : edges2Meshlets) {
-            if(meshlets.size() == 1) {
-                boundaryVertices[edge.first] = true;
-                boundaryVertices[edge.second] = true;
+        // edges referenced by a single meshlet are on the boundary
+        for(std::size_t runStart = 0; runStart < edges.size();) {
+            std::size_t runEnd = runStart + 1;
+            while(runEnd < edges.size() && edges[runEnd].edgeKey == edges[runStart].edgeKey) {
+                runEnd++;
+            }
+            if(runEnd - runStart == 1) {
+                boundaryVertices[edges[runStart].edgeKey >> 32] = true;
+                boundaryVertices[edges[runStart].edgeKey & 0xFFFFFFFFull] = true;
             }
+            runStart = runEnd;
         }
 
         return boundaryVertices;
@@ -359,40 +395,48 @@ namespace Fertilizer {
             return groupWithAllMeshlets();
         }
 
-        // meshlets represented by their index into 'previousLevelMeshlets'
-        std::unordered_map<MeshletEdge, std::unordered_set<std::size_t>, MeshletEdgeHasher> edges2Meshlets;
-        std::unordered_map<std::size_t, std::unordered_set<MeshletEdge, MeshletEdgeHasher>> meshlets2Edges;
+        const Carrot::Vector<MeshletEdgeReference> edges = collectMeshletEdges(allocator, primitive, meshlets, vertexRemap);
 
-        // for each meshlet
-        for(std::size_t meshletIndex = 0; meshletIndex < meshlets.size(); meshletIndex++) {
-            const auto& meshlet = meshlets[meshletIndex];
-            auto getVertexIndex = [&](std::size_t index) {
-                std::size_t vertexIndex = primitive.meshletVertexIndices[primitive.meshletIndices[index + meshlet.indexOffset] + meshlet.vertexOffset];
-                return static_cast<std::size_t>(vertexRemap[vertexIndex]);
-            };
+        // for each edge shared by multiple meshlets, link all these meshlets together (in both directions)
+        // link key = (meshlet << 32) | connectedMeshlet
+        std::size_t linkCount = 0;
+        for(std::size_t runStart = 0; runStart < edges.size();) {
+            std::size_t runEnd = runStart + 1;
+            while(runEnd < edges.size() && edges[runEnd].edgeKey == edges[runStart].edgeKey) {
+                runEnd++;
+            }
+            const std::size_t meshletsOnEdge = runEnd - runStart;
+            linkCount += meshletsOnEdge * (meshletsOnEdge - 1);
+            runStart = runEnd;
+        }
 
-            const std::size_t triangleCount = meshlet.indexCount / 3;
-            // for each triangle of the meshlet
-            for(std::size_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++) {
-                // for each edge of the triangle
-                for(std::size_t i = 0; i < 3; i++) {
-                    MeshletEdge edge { getVertexIndex(i + triangleIndex * 3), getVertexIndex(((i+1) % 3) + triangleIndex * 3) };
-                    if(edge.first != edge.second) {
-                        edges2Meshlets[edge].insert(meshletIndex);
-                        meshlets2Edges[meshletIndex].insert(edge);
+        // edges which are not connected to 2 different meshlets do not matter
+        if(linkCount == 0) {
+            return groupWithAllMeshlets();
+        }
+
+        Carrot::Vector<std::uint64_t> links { allocator };
+        links.resize(linkCount);
+        std::size_t linkIndex = 0;
+        for(std::size_t runStart = 0; runStart < edges.size();) {
+            std::size_t runEnd = runStart + 1;
+            while(runEnd < edges.size() && edges[runEnd].edgeKey == edges[runStart].edgeKey) {
+                runEnd++;
+            }
+            for(std::size_t i = runStart; i < runEnd; i++) {
+                for(std::size_t j = runStart; j < runEnd; j++) {
+                    if(i != j) {
+                        links[linkIndex++] = (static_cast<std::uint64_t>(edges[i].meshletIndex) << 32) | edges[j].meshletIndex;
                     }
                 }
             }
+            runStart = runEnd;
         }
+        verify(linkIndex == linkCount, "Link count mismatch");
 
-        // remove edges which are not connected to 2 different meshlets
-        std::erase_if(edges2Meshlets, [&](const auto& pair) {
-            return pair.second.size() <= 1;
-        });
-
-        if(edges2Meshlets.empty()) {
-            return groupWithAllMeshlets();
-        }
+        Carrot::Vector<std::uint64_t> linksScratch { allocator };
+        linksScratch.resize(linkCount);
+        Carrot::radixSort(std::span { links.data(), linkCount }, std::span { linksScratch.data(), linkCount }, [](std::uint64_t link) { return link; });
 
         // at this point, we have basically built a graph of meshlets, in which edges represent which meshlets are connected together
 
@@ -411,42 +455,37 @@ namespace Fertilizer {
         Carrot::Vector<idx_t> partition { allocator };
         partition.resize(vertexCount);
 
+        // build the CSR representation expected by METIS directly from the sorted links:
+        // identical links are adjacent, and their count is the weight of the connection (= number of shared edges)
         Carrot::Vector<idx_t> xadjacency { allocator };
-        xadjacency.setCapacity(vertexCount + 1);
+        xadjacency.resize(vertexCount + 1);
+        xadjacency.fill(0);
 
         Carrot::Vector<idx_t> edgeAdjacency { allocator };
         Carrot::Vector<idx_t> edgeWeights { allocator };
-        edgeAdjacency.setGrowthFactor(2);
-        edgeWeights.setGrowthFactor(2);
-
-        for(std::size_t meshletIndex = 0; meshletIndex < meshlets.size(); meshletIndex++) {
-            std::size_t startIndexInEdgeAdjacency = edgeAdjacency.size();
-            for(const auto& edge : meshlets2Edges[meshletIndex]) {
-                auto connectionsIter = edges2Meshlets.find(edge);
-                if(connectionsIter == edges2Meshlets.end()) {
-                    continue;
-                }
-                const auto& connections = connectionsIter->second;
-                for(const auto& connectedMeshlet : connections) {
-                    if(connectedMeshlet != meshletIndex) {
-                        auto existingEdgeIter = edgeAdjacency.find(connectedMeshlet, startIndexInEdgeAdjacency);
-                        if(existingEdgeIter == edgeAdjacency.end()) {
-                            verify(edgeAdjacency.size() == edgeWeights.size(), "edgeWeights and edgeAdjacency must have the same length");
-                            edgeAdjacency.emplaceBack(connectedMeshlet);
-                            edgeWeights.emplaceBack(1);
-                        } else {
-                            std::ptrdiff_t d = existingEdgeIter - edgeAdjacency.begin();
-                            assert(d >= 0);
-                            verify(d < edgeWeights.size(), "edgeWeights and edgeAdjacency do not have the same length?");
-                            edgeWeights[d]++;
-                        }
-                    }
-                }
+        edgeAdjacency.resize(linkCount);
+        edgeWeights.resize(linkCount);
+
+        std::size_t adjacencyCount = 0;
+        for(std::size_t i = 0; i < linkCount;) {
+            const std::uint64_t link = links[i];
+            std::size_t j = i + 1;
+            while(j < linkCount && links[j] == link) {
+                j++;
             }
-            xadjacency.pushBack(startIndexInEdgeAdjacency);
+            const std::size_t meshletIndex = link >> 32;
+            edgeAdjacency[adjacencyCount] = static_cast<idx_t>(link & 0xFFFFFFFFull);
+            edgeWeights[adjacencyCount] = static_cast<idx_t>(j - i);
+            adjacencyCount++;
+            xadjacency[meshletIndex + 1]++;
+            i = j;
+        }
+        for(std::size_t meshletIndex = 0; meshletIndex < meshlets.size(); meshletIndex++) {
+            xadjacency[meshletIndex + 1] += xadjacency[meshletIndex];
         }
-        xadjacency.pushBack(edgeAdjacency.size());
-        verify(xadjacency.size() == vertexCount + 1, "unexpected count of vertices for METIS graph?");
+        edgeAdjacency.resize(adjacencyCount);
+        edgeWeights.resize(adjacencyCount);
+        verify(xadjacency[vertexCount] == adjacencyCount, "unexpected count of vertices for METIS graph?");
 
         // coherency checks
 #if 0
@@ -554,22 +593,29 @@ namespace Fertilizer {
             }
         }
 #elif 1
+        // boundary vertices are never merged, so only query the neighbors of the other vertices
+        Carrot::Vector<VertexWrapper> queries { Carrot::MallocAllocator::instance };
+        Carrot::Vector<std::int64_t> queryIndices { Carrot::MallocAllocator::instance }; // vertex -> index inside 'queries'
+        queries.setCapacity(groupVerticesPreWeld.size());
+        queryIndices.resize(groupVerticesPreWeld.size());
         for(std::size_t v = 0; v < groupVerticesPreWeld.size(); v++) {
+            if(boundary[groupVerticesPreWeld[v].index]) {
+                queryIndices[v] = -1;
+            } else {
+                queryIndices[v] = queries.size();
+                queries.pushBack(groupVerticesPreWeld[v]);
+            }
+        }
+        for(std::size_t q = 0; q < queries.size(); q++) {
             neighborsForAllVertices.emplaceBack(Carrot::MallocAllocator::instance);
-            neighborsForAllVertices[v].setGrowthFactor(1.5f);
+            neighborsForAllVertices[q].setGrowthFactor(1.5f);
         }
-        Carrot::Async::parallelFor(groupVerticesPreWeld.size(), [&](std::size_t v) {
-            const VertexWrapper& currentVertexWrapped = groupVerticesPreWeld[v];
-            if(boundary[currentVertexWrapped.index]) {
-                return; // no need to compute neighbors
-            }
-            kdtree.getNeighbors(neighborsForAllVertices[v], currentVertexWrapped, maxDistance);
-        }, (groupVerticesPreWeld.size()+31) / 32);
+        kdtree.getNeighborsBatch(neighborsForAllVertices, queries, maxDistance);
         for(std::int64_t v = 0; v < groupVerticesPreWeld.size(); v++) {
             std::int64_t replacement = -1;
             const auto& currentVertexWrapped = groupVerticesPreWeld[v];
             if(!boundary[currentVertexWrapped.index]) { // boundary vertices must not be merged with others (to avoid cracks)
-                auto& neighbors = neighborsForAllVertices[v];
+                auto& neighbors = neighborsForAllVertices[queryIndices[v]];
                 const Carrot::Vertex& currentVertex = primitive.vertices[currentVertexWrapped.index];
 
                 float maxDistanceSq = maxDistance*maxDistance;
@@ -648,6 +694,8 @@ namespace Fertilizer {
 
 
         // meshlets are ready, process them in the format used by Carrot:
+        const std::uint32_t firstGroupIndex = *pUniqueGroupIndex;
+        *pUniqueGroupIndex += meshletCount;
         Carrot::Async::parallelFor(meshletCount, [&](std::size_t index) {
             auto& meshoptMeshlet = meshoptMeshlets[index];
             auto& carrotMeshlet = primitive.meshlets[meshletOffset + index];
@@ -657,13 +705,38 @@ namespace Fertilizer {
 
             carrotMeshlet.indexOffset = indexOffset + meshoptMeshlet.triangle_offset;
             carrotMeshlet.indexCount = meshoptMeshlet.triangle_count*3;
-            carrotMeshlet.groupIndex = (*pUniqueGroupIndex)++;
+            carrotMeshlet.groupIndex = firstGroupIndex + index;
 
             carrotMeshlet.boundingSphere = clusterBounds;
             carrotMeshlet.clusterError = clusterError;
         }, 32);
     }
 
+    /// Geometry of a group of meshlets, in the format expected to build its BLAS
+    struct GroupBLASInput {
+        std::vector<glm::vec3> vertices;
+        std::vector<std::uint16_t> indices;
+        std::vector<std::size_t> firstVertices; // per meshlet of the group
+        std::vector<std::size_t> firstIndices; // per meshlet of the group
+    };
+
+    /// GPU objects used while building the BLAS of a group, which need to stay alive until the build is complete
+    struct GroupBLASBuild {
+        GPUBuffer vertices;
+        GPUBuffer indices;
+        GPUBuffer rtTransform;
+        GPUBuffer scratchBuffer;
+        GPUBuffer asBuffer;
+        GPUBuffer serializedASStorageBuffer;
+        vk::UniqueHandle<vk::AccelerationStructureKHR, vk::DispatchLoaderDynamic> as;
+        std::vector<vk::AccelerationStructureGeometryKHR> geometries;
+        std::vector<vk::AccelerationStructureBuildRangeInfoKHR> buildRanges;
+        vk::AccelerationStructureBuildGeometryInfoKHR buildInfo;
+    };
+
+    /// How many groups have their BLAS built in a single submission. Limits the amount of GPU memory used at once
+    constexpr std::size_t BLASBuildBatchSize = 64;
+
     /**
      * From a primitive with meshlets, pregenerate BLASes for the groups of meshlets inside the primitive
      * Note: these BLASes may be valid only for a given driver version :c
@@ -682,156 +755,297 @@ namespace Fertilizer {
             rebuiltGroups[meshlet.groupIndex].meshlets.push_back(i);
         }
 
-        // maybe this could be done directly inside generateClusterHierarchy, but speed is not the most important thing for the asset pipeline
-        // (but needs to stay reasonable)
-        Carrot::StackAllocator allocator { Carrot::Allocator::getDefault() };
-        for(std::size_t groupIndex = 0; groupIndex < groupCount; groupIndex++) {
+        // generate the meshes that will be used to generate the BLAS, in parallel
+        // (that is: the concatenation of the meshlets composing the group)
+        // the runtime expects one mesh per cluster, otherwise the lighting shader may access invalid memory
+        std::vector<GroupBLASInput> inputs;
+        inputs.resize(groupCount);
+        Carrot::Async::parallelFor(groupCount, [&](std::size_t groupIndex) {
             const MeshletGroup& group = rebuiltGroups[groupIndex];
-            allocator.clear();
-
-            if(group.meshlets.empty()) {
-                continue;
-            }
-
-            // generate the meshes that will be used to generate the BLAS
-            // (that is: the concatenation of the meshlets composing the group)
-            // the runtime expects one mesh per cluster, otherwise the lighting shader may access invalid memory
-
-            Carrot::Vector<glm::vec3> verticesCPU{ allocator };
-            Carrot::Vector<std::uint16_t> indicesCPU{ allocator };
-            Carrot::Vector<std::size_t> firstVertices { allocator };
-            Carrot::Vector<std::size_t> firstIndices { allocator };
-            firstVertices.resize(group.meshlets.size());
-            firstIndices.resize(group.meshlets.size());
+            GroupBLASInput& input = inputs[groupIndex];
+            input.firstVertices.resize(group.meshlets.size());
+            input.firstIndices.resize(group.meshlets.size());
             for(std::size_t groupMeshletIndex = 0; groupMeshletIndex < group.meshlets.size(); groupMeshletIndex++) {
                 const auto& meshletIndex = group.meshlets[groupMeshletIndex];
                 const auto& meshlet = primitive.meshlets[meshletIndex];
 
-                const std::size_t firstVertexIndex = verticesCPU.size();
-                firstVertices[groupMeshletIndex] = firstVertexIndex;
-                verticesCPU.resize(firstVertexIndex + meshlet.vertexCount);
+                const std::size_t firstVertexIndex = input.vertices.size();
+                input.firstVertices[groupMeshletIndex] = firstVertexIndex;
+                input.vertices.resize(firstVertexIndex + meshlet.vertexCount);
 
-                const std::size_t firstIndexIndex = indicesCPU.size();
-                firstIndices[groupMeshletIndex] = firstIndexIndex;
-                indicesCPU.resize(firstIndexIndex + meshlet.indexCount);
+                const std::size_t firstIndexIndex = input.indices.size();
+                input.firstIndices[groupMeshletIndex] = firstIndexIndex;
+                input.indices.resize(firstIndexIndex + meshlet.indexCount);
 
                 for(std::size_t index = 0; index < meshlet.vertexCount; index++) {
-                    verticesCPU[index + firstVertexIndex] = glm::vec3 { primitive.vertices[primitive.meshletVertexIndices[index + meshlet.vertexOffset]].pos.xyz };
+                    input.vertices[index + firstVertexIndex] = glm::vec3 { primitive.vertices[primitive.meshletVertexIndices[index + meshlet.vertexOffset]].pos.xyz };
                 }
                 for(std::size_t index = 0; index < meshlet.indexCount; index++) {
-                    indicesCPU[index + firstIndexIndex] = static_cast<std::uint16_t>(primitive.meshletIndices[index + meshlet.indexOffset]);
+                    input.indices[index + firstIndexIndex] = static_cast<std::uint16_t>(primitive.meshletIndices[index + meshlet.indexOffset]);
                 }
             }
+        }, 1);
+
+        // build the BLASes on the GPU, by batches: the GPU only needs to be waited on a few times per batch, instead of a few times per group
+        const vk::TransformMatrixKHR rtTransformValue = VulkanHelper::glmToRTTransformMatrix(instanceTransform);
+        std::vector<GroupBLASBuild> builds;
+        for(std::size_t batchStart = 0; batchStart < groupCount; batchStart += BLASBuildBatchSize) {
+            const std::size_t batchEnd = std::min<std::size_t>(groupCount, batchStart + BLASBuildBatchSize);
+            builds.clear();
+            builds.reserve(batchEnd - batchStart);
+
+            std::vector<std::uint32_t> groupIndices; // index of group for each build
+            for(std::size_t groupIndex = batchStart; groupIndex < batchEnd; groupIndex++) {
+                const MeshletGroup& group = rebuiltGroups[groupIndex];
+                const GroupBLASInput& input = inputs[groupIndex];
+                if(group.meshlets.empty()) {
+                    continue;
+                }
+                groupIndices.push_back(static_cast<std::uint32_t>(groupIndex));
+                GroupBLASBuild& build = builds.emplace_back();
+
+                build.vertices = vkHelper.newHostVisibleBuffer(input.vertices.size() * sizeof(glm::vec3), vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
+                build.indices = vkHelper.newHostVisibleBuffer(input.indices.size() * sizeof(std::uint16_t), vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
+                void* pGPUVertices = vkHelper.getDevice().mapMemory(*build.vertices.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher());
+                memcpy(pGPUVertices, input.vertices.data(), input.vertices.size() * sizeof(glm::vec3));
+                void* pGPUIndices = vkHelper.getDevice().mapMemory(*build.indices.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher());
+                memcpy(pGPUIndices, input.indices.data(), input.indices.size() * sizeof(std::uint16_t));
+                vk::DeviceAddress verticesAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo { .buffer = *build.vertices.vkBuffer }, vkHelper.getDispatcher());
+                vk::DeviceAddress indicesAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo { .buffer = *build.indices.vkBuffer }, vkHelper.getDispatcher());
+
+                // compute storage size of BLAS
+                build.rtTransform = vkHelper.newHostVisibleBuffer(sizeof(vk::TransformMatrixKHR), vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
+                vk::TransformMatrixKHR* pRTTransform = static_cast<vk::TransformMatrixKHR *>(vkHelper.getDevice().mapMemory(*build.rtTransform.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher()));
+                *pRTTransform = rtTransformValue;
+                vk::DeviceAddress rtTransformAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo { .buffer = *build.rtTransform.vkBuffer }, vkHelper.getDispatcher());
+
+                std::vector<std::uint32_t> maxPrimitiveCounts;
+                build.geometries.resize(group.meshlets.size());
+                maxPrimitiveCounts.resize(group.meshlets.size());
+                build.buildRanges.resize(group.meshlets.size());
+                for(std::size_t groupMeshletIndex = 0; groupMeshletIndex < group.meshlets.size(); groupMeshletIndex++) {
+                    const auto& meshletIndex = group.meshlets[groupMeshletIndex];
+                    const auto& meshlet = primitive.meshlets[meshletIndex];
+                    vk::AccelerationStructureGeometryKHR& geometry = build.geometries[groupMeshletIndex];
+                    geometry.geometryType = vk::GeometryTypeKHR::eTriangles;
+                    geometry.flags = vk::GeometryFlagBitsKHR::eOpaque;
+
+                    geometry.geometry = vk::AccelerationStructureGeometryTrianglesDataKHR {
+                        .vertexFormat = vk::Format::eR32G32B32Sfloat,
+                        .vertexData = verticesAddress + sizeof(glm::vec3) * input.firstVertices[groupMeshletIndex],
+                        .vertexStride = sizeof(glm::vec3),
+                        .maxVertex = meshlet.vertexCount-1,
+                        .indexType = vk::IndexType::eUint16,
+                        .indexData = indicesAddress + sizeof(std::uint16_t) * input.firstIndices[groupMeshletIndex],
+                        .transformData = rtTransformAddress,
+                    };
+
+                    maxPrimitiveCounts[groupMeshletIndex] = meshlet.indexCount / 3;
+                    build.buildRanges[groupMeshletIndex].primitiveCount = maxPrimitiveCounts[groupMeshletIndex];
+                }
 
-            GPUBuffer vertices = vkHelper.newHostVisibleBuffer(verticesCPU.size() * sizeof(glm::vec3), vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
-            GPUBuffer indices = vkHelper.newHostVisibleBuffer(indicesCPU.size() * sizeof(std::uint16_t), vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
-            void* pGPUVertices = vkHelper.getDevice().mapMemory(*vertices.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher());
-            memcpy(pGPUVertices, verticesCPU.data(), verticesCPU.size() * sizeof(glm::vec3));
-            void* pGPUIndices = vkHelper.getDevice().mapMemory(*indices.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher());
-            memcpy(pGPUIndices, indicesCPU.data(), indicesCPU.size() * sizeof(std::uint16_t));
-            vk::DeviceAddress verticesAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo { .buffer = *vertices.vkBuffer }, vkHelper.getDispatcher());
-            vk::DeviceAddress indicesAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo { .buffer = *indices.vkBuffer }, vkHelper.getDispatcher());
-
-            // compute storage size of BLAS
-            GPUBuffer rtTransform = vkHelper.newHostVisibleBuffer(sizeof(vk::TransformMatrixKHR), vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
-            vk::TransformMatrixKHR* pRTTransform = static_cast<vk::TransformMatrixKHR *>(vkHelper.getDevice().mapMemory(*rtTransform.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher()));
-            *pRTTransform = VulkanHelper::glmToRTTransformMatrix(instanceTransform);
-            vk::DeviceAddress rtTransformAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo { .buffer = *rtTransform.vkBuffer }, vkHelper.getDispatcher());
-
-            Carrot::Vector<vk::AccelerationStructureGeometryKHR> geometries { allocator };
-            Carrot::Vector<std::uint32_t> maxPrimitiveCounts { allocator };
-            Carrot::Vector<vk::AccelerationStructureBuildRangeInfoKHR> buildRanges { allocator };
-            geometries.resize(group.meshlets.size());
-            maxPrimitiveCounts.resize(group.meshlets.size());
-            buildRanges.resize(group.meshlets.size());
-            for(std::size_t groupMeshletIndex = 0; groupMeshletIndex < group.meshlets.size(); groupMeshletIndex++) {
-                const auto& meshletIndex = group.meshlets[groupMeshletIndex];
-                const auto& meshlet = primitive.meshlets[meshletIndex];
-                vk::AccelerationStructureGeometryKHR& geometry = geometries[groupMeshletIndex];
-                geometry.geometryType = vk::GeometryTypeKHR::eTriangles;
-                geometry.flags = vk::GeometryFlagBitsKHR::eOpaque;
-
-                geometry.geometry = vk::AccelerationStructureGeometryTrianglesDataKHR {
-                    .vertexFormat = vk::Format::eR32G32B32Sfloat,
-                    .vertexData = verticesAddress + sizeof(glm::vec3) * firstVertices[groupMeshletIndex],
-                    .vertexStride = sizeof(glm::vec3),
-                    .maxVertex = meshlet.vertexCount-1,
-                    .indexType = vk::IndexType::eUint16,
-                    .indexData = indicesAddress + sizeof(std::uint16_t) * firstIndices[groupMeshletIndex],
-                    .transformData = rtTransformAddress,
+                build.buildInfo = vk::AccelerationStructureBuildGeometryInfoKHR {
+                    .type = vk::AccelerationStructureTypeKHR::eBottomLevel,
+                    .flags = vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace,
+                    .mode = vk::BuildAccelerationStructureModeKHR::eBuild,
+                    .geometryCount = static_cast<std::uint32_t>(build.geometries.size()),
+                    .pGeometries = build.geometries.data(),
                 };
 
-                maxPrimitiveCounts[groupMeshletIndex] = meshlet.indexCount / 3;
-                buildRanges[groupMeshletIndex].primitiveCount = maxPrimitiveCounts[groupMeshletIndex];
-            }
-
-            vk::AccelerationStructureBuildGeometryInfoKHR buildInfo {
-                .type = vk::AccelerationStructureTypeKHR::eBottomLevel,
-                .flags = vk::BuildAccelerationStructureFlagBitsKHR::ePreferFastTrace,
-                .mode = vk::BuildAccelerationStructureModeKHR::eBuild,
-                .geometryCount = static_cast<std::uint32_t>(geometries.size()),
-                .pGeometries = geometries.data(),
-            };
+                vk::AccelerationStructureBuildSizesInfoKHR sizeInfo = vkHelper.getDevice().getAccelerationStructureBuildSizesKHR(vk::AccelerationStructureBuildTypeKHR::eHostOrDevice, build.buildInfo, maxPrimitiveCounts, vkHelper.getDispatcher());
 
-            vk::AccelerationStructureBuildSizesInfoKHR sizeInfo = vkHelper.getDevice().getAccelerationStructureBuildSizesKHR(vk::AccelerationStructureBuildTypeKHR::eHostOrDevice, buildInfo, maxPrimitiveCounts, vkHelper.getDispatcher());
+                build.scratchBuffer = vkHelper.newDeviceLocalBuffer(sizeInfo.buildScratchSize, vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eStorageBuffer);
+                vk::DeviceAddress scratchBufferAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo {
+                    .buffer = *build.scratchBuffer.vkBuffer,
+                }, vkHelper.getDispatcher());
 
-            GPUBuffer scratchBuffer = vkHelper.newDeviceLocalBuffer(sizeInfo.buildScratchSize, vk::BufferUsageFlagBits::eShaderDeviceAddress | vk::BufferUsageFlagBits::eStorageBuffer);
-            vk::DeviceAddress scratchBufferAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo {
-                .buffer = *scratchBuffer.vkBuffer,
-            }, vkHelper.getDispatcher());
+                // create BLAS
+                vk::DeviceSize asSize = sizeInfo.accelerationStructureSize;
+                build.asBuffer = vkHelper.newHostVisibleBuffer(asSize, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR);
+                vk::AccelerationStructureCreateInfoKHR createInfo {
+                    .buffer = *build.asBuffer.vkBuffer,
+                    .size = asSize,
+                    .type = vk::AccelerationStructureTypeKHR::eBottomLevel,
+                };
+                build.as = vkHelper.getDevice().createAccelerationStructureKHRUnique(createInfo, nullptr, vkHelper.getDispatcher());
 
-            // create and build BLAS
-            vk::DeviceSize asSize = sizeInfo.accelerationStructureSize;
-            GPUBuffer asBuffer = vkHelper.newHostVisibleBuffer(asSize, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR);
-            vk::AccelerationStructureCreateInfoKHR createInfo {
-                .buffer = *asBuffer.vkBuffer,
-                .size = asSize,
-                .type = vk::AccelerationStructureTypeKHR::eBottomLevel,
-            };
-            auto as = vkHelper.getDevice().createAccelerationStructureKHRUnique(createInfo, nullptr, vkHelper.getDispatcher());
+                build.buildInfo.scratchData = scratchBufferAddress;
+                build.buildInfo.dstAccelerationStructure = *build.as;
+            }
 
-            buildInfo.scratchData = scratchBufferAddress;
-            buildInfo.dstAccelerationStructure = *as;
+            if(builds.empty()) {
+                continue;
+            }
+            const std::uint32_t buildCount = static_cast<std::uint32_t>(builds.size());
+
+            // each build has its own scratch buffer, so all builds of the batch can run at the same time
+            std::vector<vk::AccelerationStructureBuildGeometryInfoKHR> buildInfos;
+            std::vector<const vk::AccelerationStructureBuildRangeInfoKHR*> buildRanges;
+            std::vector<vk::AccelerationStructureKHR> accelerationStructures;
+            buildInfos.reserve(buildCount);
+            buildRanges.reserve(buildCount);
+            accelerationStructures.reserve(buildCount);
+            for(const GroupBLASBuild& build : builds) {
+                buildInfos.push_back(build.buildInfo);
+                buildRanges.push_back(build.buildRanges.data());
+                accelerationStructures.push_back(*build.as);
+            }
 
             auto queryPool = vkHelper.getDevice().createQueryPoolUnique(vk::QueryPoolCreateInfo {
                 .queryType = vk::QueryType::eAccelerationStructureSerializationSizeKHR,
-                .queryCount = 1,
+                .queryCount = buildCount,
             }, nullptr, vkHelper.getDispatcher());
-            vkHelper.getDevice().resetQueryPool(*queryPool, 0, 1, vkHelper.getDispatcher());
+            vkHelper.getDevice().resetQueryPool(*queryPool, 0, buildCount, vkHelper.getDispatcher());
             vkHelper.executeCommands([&](vk::CommandBuffer cmds) {
-                cmds.buildAccelerationStructuresKHR(buildInfo, buildRanges.cdata(), vkHelper.getDispatcher());
+                cmds.buildAccelerationStructuresKHR(buildInfos, buildRanges, vkHelper.getDispatcher());
             });
             vkHelper.executeCommands([&](vk::CommandBuffer cmds) {
-                cmds.writeAccelerationStructuresPropertiesKHR(1, &as.get(), vk::QueryType::eAccelerationStructureSerializationSizeKHR, *queryPool, 0, vkHelper.getDispatcher());
+                cmds.writeAccelerationStructuresPropertiesKHR(accelerationStructures, vk::QueryType::eAccelerationStructureSerializationSizeKHR, *queryPool, 0, vkHelper.getDispatcher());
             });
 
-            auto queryResult = vkHelper.getDevice().getQueryPoolResult<std::uint64_t>(*queryPool, 0, 1, sizeof(std::uint64_t), vk::QueryResultFlagBits::eWait | vk::QueryResultFlagBits::e64, vkHelper.getDispatcher());
+            auto queryResult = vkHelper.getDevice().getQueryPoolResults<std::uint64_t>(*queryPool, 0, buildCount, buildCount * sizeof(std::uint64_t), sizeof(std::uint64_t), vk::QueryResultFlagBits::eWait | vk::QueryResultFlagBits::e64, vkHelper.getDispatcher());
             verify(queryResult.result == vk::Result::eSuccess, "Failed to get query result");
-            const std::uint64_t serializedSize = queryResult.value;
-
-            // copy BLAS to cpu buffer
-            GPUBuffer serializedASStorageBuffer = vkHelper.newHostVisibleBuffer(serializedSize, vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress);
-            vk::DeviceAddress serializedASStorageBufferAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo {
-                .buffer = *serializedASStorageBuffer.vkBuffer,
-            }, vkHelper.getDispatcher());
-            vk::CopyAccelerationStructureToMemoryInfoKHR copyOp {
-                .src = *as,
-                .dst = serializedASStorageBufferAddress,
-                .mode = vk::CopyAccelerationStructureModeKHR::eSerialize,
-            };
+            const std::vector<std::uint64_t>& serializedSizes = queryResult.value;
+
+            // copy BLASes to cpu buffers
+            std::vector<vk::CopyAccelerationStructureToMemoryInfoKHR> copyOps;
+            copyOps.reserve(buildCount);
+            for(std::uint32_t buildIndex = 0; buildIndex < buildCount; buildIndex++) {
+                GroupBLASBuild& build = builds[buildIndex];
+                build.serializedASStorageBuffer = vkHelper.newHostVisibleBuffer(serializedSizes[buildIndex], vk::BufferUsageFlagBits::eAccelerationStructureStorageKHR | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eShaderDeviceAddress);
+                vk::DeviceAddress serializedASStorageBufferAddress = vkHelper.getDevice().getBufferAddress(vk::BufferDeviceAddressInfo {
+                    .buffer = *build.serializedASStorageBuffer.vkBuffer,
+                }, vkHelper.getDispatcher());
+                copyOps.push_back(vk::CopyAccelerationStructureToMemoryInfoKHR {
+                    .src = *build.as,
+                    .dst = serializedASStorageBufferAddress,
+                    .mode = vk::CopyAccelerationStructureModeKHR::eSerialize,
+                });
+            }
             vkHelper.executeCommands([&](vk::CommandBuffer cmds) {
-                cmds.copyAccelerationStructureToMemoryKHR(copyOp, vkHelper.getDispatcher());
+                for(const auto& copyOp : copyOps) {
+                    cmds.copyAccelerationStructureToMemoryKHR(copyOp, vkHelper.getDispatcher());
+                }
             });
 
-            void* serializedASPtr = vkHelper.getDevice().mapMemory(*serializedASStorageBuffer.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher());
-            // TODO: compress blas bytes?
+            for(std::uint32_t buildIndex = 0; buildIndex < buildCount; buildIndex++) {
+                GroupBLASBuild& build = builds[buildIndex];
+                void* serializedASPtr = vkHelper.getDevice().mapMemory(*build.serializedASStorageBuffer.vkMemory, 0, VK_WHOLE_SIZE, {}, vkHelper.getDispatcher());
+                // TODO: compress blas bytes?
+
+                // copy cpu buffer to storage
+                // key = nodeIndex + meshIndex + groupIndex
+                PrecomputedBLAS& precomputedBLAS = scene.precomputedBLASes[nodeKey][Carrot::Pair(static_cast<std::uint32_t>(primitiveIndex), groupIndices[buildIndex])];
+                precomputedBLAS.blasBytes.resize(serializedSizes[buildIndex]);
+                memcpy(precomputedBLAS.blasBytes.data(), serializedASPtr, precomputedBLAS.blasBytes.size());
+            }
+        }
+    }
+
+    /// Result of the simplification of a single group of meshlets
+    struct SimplifiedGroup {
+        std::vector<unsigned int> indices; // mesh-wide vertex indices. Empty if the group could not be simplified
+        Carrot::Math::Sphere bounds;
+        float error = 0.0f; // mesh-space error, including the error of the meshlets of the group
+    };
+
+    /**
+     * Merges the meshlets of the group and simplifies the result.
+     * Only reads from 'primitive' and 'previousLevelMeshlets', so multiple groups can be simplified in parallel
+     */
+    static void simplifyGroup(SimplifiedGroup& output, const LoadedPrimitive& primitive, std::span<const Meshlet> previousLevelMeshlets, const MeshletGroup& group, std::span<const std::int64_t> mergeVertexRemap, float tLod) {
+        Carrot::Vector<unsigned int> groupVertexIndices {};
+        Carrot::Vector<Carrot::Vertex> groupVertexBuffer {};
+        groupVertexBuffer.setGrowthFactor(1.5f);
+        Carrot::Vector<std::size_t> group2meshVertexRemap {};
+        group2meshVertexRemap.setGrowthFactor(1.5f);
+        robin_hood::unordered_flat_map<std::size_t, std::size_t> mesh2groupVertexRemap {};
+
+        // add cluster vertices to this group
+        for(const auto& meshletIndex : group.meshlets) {
+            const auto& meshlet = previousLevelMeshlets[meshletIndex];
+
+            std::size_t start = groupVertexIndices.size();
+            groupVertexIndices.ensureReserve(start + meshlet.indexCount);
+            for(std::size_t j = 0; j < meshlet.indexCount; j += 3) { // triangle per triangle
+                std::int64_t triangle[3] = {
+                    mergeVertexRemap[primitive.meshletVertexIndices[primitive.meshletIndices[meshlet.indexOffset + j + 0] + meshlet.vertexOffset]],
+                    mergeVertexRemap[primitive.meshletVertexIndices[primitive.meshletIndices[meshlet.indexOffset + j + 1] + meshlet.vertexOffset]],
+                    mergeVertexRemap[primitive.meshletVertexIndices[primitive.meshletIndices[meshlet.indexOffset + j + 2] + meshlet.vertexOffset]],
+                };
+
+                // remove triangles which have collapsed on themselves due to vertex merge
+                if(triangle[0] == triangle[1] && triangle[0] == triangle[2]) {
+                    continue;
+                }
+
+                for(std::size_t vertex = 0; vertex < 3; vertex++) {
+                    const std::size_t vertexIndex = triangle[vertex];
+
+                    // map vertex index valid for entire to a smaller vertex buffer just for this group
+                    auto [iter, bWasNew] = mesh2groupVertexRemap.try_emplace(vertexIndex);
+                    if(bWasNew) {
+                        iter->second = groupVertexBuffer.size();
+                        groupVertexBuffer.emplaceBack(primitive.vertices[vertexIndex]);
+                        group2meshVertexRemap.pushBack(vertexIndex);
+                    }
+                    groupVertexIndices.pushBack(iter->second);
+                }
+            }
+        }
+
+        if(groupVertexIndices.empty()) {
+            return;
+        }
+
+        float targetError = (0.1f * tLod + 0.01f * (1-tLod));
+
+        // simplify this group
+        const float threshold = 0.5f;
+        std::size_t targetIndexCount = groupVertexIndices.size() * threshold;
+        unsigned int options = meshopt_SimplifyLockBorder; // we want all group borders to be locked (because they are shared between groups)
+
+        std::vector<unsigned int>& simplifiedIndexBuffer = output.indices;
+        simplifiedIndexBuffer.resize(groupVertexIndices.size());
+        float simplificationError = 0.f;
+
+        std::size_t simplifiedIndexCount = meshopt_simplify(simplifiedIndexBuffer.data(), // output
+                                                            groupVertexIndices.data(), groupVertexIndices.size(), // index buffer
+                                                            &groupVertexBuffer[0].pos.x, groupVertexBuffer.size(), sizeof(Carrot::Vertex), // vertex buffer
+                                                            targetIndexCount, targetError, options, &simplificationError
+        );
+        if(simplifiedIndexCount == 0 || simplifiedIndexCount == groupVertexIndices.size()) {
+            simplifiedIndexBuffer.clear();
+            return;
+        }
+        simplifiedIndexBuffer.resize(simplifiedIndexCount);
+
+        float localScale = meshopt_simplifyScale(&groupVertexBuffer[0].pos.x, groupVertexBuffer.size(), sizeof(Carrot::Vertex));
+        // TODO: numerical stability
+        float meshSpaceError = simplificationError * localScale;
+        float parentError = 0.0f;
+
+        glm::vec3 min { +INFINITY, +INFINITY, +INFINITY };
+        glm::vec3 max { -INFINITY, -INFINITY, -INFINITY };
+
+        // remap simplified index buffer to mesh-wide vertex indices
+        for(auto& index : simplifiedIndexBuffer) {
+            index = group2meshVertexRemap[index];
+
+            const glm::vec3 vertexPos = glm::vec3 { primitive.vertices[index].pos.xyz };
+            min = glm::min(min, vertexPos);
+            max = glm::max(max, vertexPos);
+        }
+
+        output.bounds.loadFromAABB(min, max);
 
-            // copy cpu buffer to storage
-            // key = nodeIndex + meshIndex + groupIndex
-            PrecomputedBLAS& precomputedBLAS = scene.precomputedBLASes[nodeKey][Carrot::Pair(static_cast<std::uint32_t>(primitiveIndex), static_cast<std::uint32_t>(groupIndex))];
-            precomputedBLAS.blasBytes.resize(serializedSize);
-            memcpy(precomputedBLAS.blasBytes.data(), serializedASPtr, precomputedBLAS.blasBytes.size());
+        for(const auto& meshletIndex : group.meshlets) {
+            const auto& previousMeshlet = previousLevelMeshlets[meshletIndex];
+            // ensure parent(this) error >= child(members of group) error
+            parentError = std::max(parentError, previousMeshlet.clusterError);
         }
+
+        output.error = meshSpaceError + parentError;
     }
 
     /**
@@ -867,12 +1081,11 @@ namespace Fertilizer {
 
         // level n+1
         const int maxLOD = 25;
-        Carrot::Vector<unsigned int> groupVertexIndices;
         Carrot::Vector<VertexWrapper> groupVerticesPreWeld;
 
         // TODO: move higher in call chain
-        // allocator used for meshlet grouping, used to reuse memory between passes
-        Carrot::StackAllocator groupingAllocator { Carrot::MallocAllocator::instance };
+        // allocator used for vertex collection, boundary detection and meshlet grouping, used to reuse memory between passes
+        Carrot::StackAllocator groupingAllocator { Carrot::MallocAllocator::instance, 16 * 1024 * 1024 };
         for (int lod = 0; lod < maxLOD; ++lod) {
             Carrot::UserNotifications::getInstance().setBody(notificationID, Carrot::sprintf("Generating LOD %d", lod+1));
             float tLod = lod / (float)maxLOD;
@@ -881,26 +1094,23 @@ namespace Fertilizer {
                 return; // we have reached the end
             }
 
-            std::unordered_set<std::size_t> meshletVertexIndices;
+            groupingAllocator.clear();
 
+            // collect the vertices used by this level, each only once
+            Carrot::Vector<bool> vertexUsed { groupingAllocator };
+            vertexUsed.resize(primitive.vertices.size());
+            vertexUsed.fill(false);
+            groupVerticesPreWeld.clear();
             for(const auto& meshlet : previousLevelMeshlets) {
-                auto getVertexIndex = [&](std::size_t index) {
-                    return primitive.meshletVertexIndices[primitive.meshletIndices[index + meshlet.indexOffset] + meshlet.vertexOffset];
-                };
-
-                const std::size_t triangleCount = meshlet.indexCount / 3;
-                // for each triangle of the meshlet
                 for(std::size_t i = 0; i < meshlet.indexCount; i++) {
-                    meshletVertexIndices.insert(getVertexIndex(i));
+                    const std::size_t vertexIndex = primitive.meshletVertexIndices[primitive.meshletIndices[i + meshlet.indexOffset] + meshlet.vertexOffset];
+                    if(!vertexUsed[vertexIndex]) {
+                        vertexUsed[vertexIndex] = true;
+                        groupVerticesPreWeld.emplaceBack(primitive.vertices.data(), vertexIndex);
+                    }
                 }
             }
 
-            groupVerticesPreWeld.clear();
-            groupVerticesPreWeld.ensureReserve(meshletVertexIndices.size());
-            for(const std::size_t i : meshletVertexIndices) {
-                groupVerticesPreWeld.emplaceBack(primitive.vertices.data(), i);
-            }
-
             std::span<const VertexWrapper> wrappedVertices = groupVerticesPreWeld;
             kdtree.build(wrappedVertices);
 
@@ -908,134 +1118,52 @@ namespace Fertilizer {
             const float maxUVDistance = tLod * 0.5f + (1-tLod) * 1.0f / 256.0f;
             Carrot::UserNotifications::getInstance().setBody(notificationID, Carrot::sprintf("Generating LOD %d - Merge vertices", lod+1));
 
-            Carrot::StackAllocator tempAllocator { Carrot::Allocator::getDefault() };
-            Carrot::Vector<bool> boundary = findBoundaryVertices(tempAllocator, primitive, previousLevelMeshlets);
+            Carrot::Vector<bool> boundary = findBoundaryVertices(groupingAllocator, primitive, previousLevelMeshlets);
 
             const std::vector<std::int64_t> mergeVertexRemap = mergeByDistance(primitive, boundary, groupVerticesPreWeld, maxDistance, maxUVDistance, kdtree);
 
-            groupingAllocator.clear();
             Carrot::UserNotifications::getInstance().setBody(notificationID, Carrot::sprintf("Generating LOD %d - Group clusters", lod+1));
             const Carrot::Vector<MeshletGroup> groups = groupMeshlets(groupingAllocator, primitive, previousLevelMeshlets, mergeVertexRemap);
 
             // ===== Simplify groups
+            // Each group is simplified independently (in parallel), results are then appended in group order, so the
+            // output does not depend on the scheduling
             const std::size_t newMeshletStart = primitive.meshlets.size();
             Carrot::UserNotifications::getInstance().setBody(notificationID, Carrot::sprintf("Generating LOD %d - Simplify cluster groups", lod+1));
+            std::vector<SimplifiedGroup> simplifiedGroups;
+            simplifiedGroups.resize(groups.size());
+            std::atomic<std::size_t> simplifiedGroupCount { 0 };
+            Carrot::Async::parallelFor(groups.size(), [&](std::size_t groupIndex) {
+                simplifyGroup(simplifiedGroups[groupIndex], primitive, previousLevelMeshlets, groups[groupIndex], mergeVertexRemap, tLod);
+                const std::size_t doneCount = ++simplifiedGroupCount;
+                Carrot::UserNotifications::getInstance().setProgress(notificationID, doneCount/static_cast<float>(groups.size()));
+            }, 1);
+
+            Carrot::UserNotifications::getInstance().setBody(notificationID, Carrot::sprintf("Generating LOD %d - Build meshlets", lod+1));
             for(std::size_t groupIndex = 0; groupIndex < groups.size(); groupIndex++) {
                 const std::uint32_t currentGroupIndex = uniqueGroupIndex++;
                 const auto& group = groups[groupIndex];
-                Carrot::UserNotifications::getInstance().setProgress(notificationID, groupIndex/static_cast<float>(groups.size()));
-                groupVertexIndices.clear();
+                const SimplifiedGroup& simplifiedGroup = simplifiedGroups[groupIndex];
                 // meshlets vector is modified during the loop
                 previousLevelMeshlets = std::span { primitive.meshlets.data() + previousMeshletsStart, primitive.meshlets.size() - previousMeshletsStart };
 
-                Carrot::Vector<Carrot::Vertex> groupVertexBuffer {};
-                groupVertexBuffer.setGrowthFactor(1.5f);
-                Carrot::Vector<std::size_t> group2meshVertexRemap {};
-                std::unordered_map<std::size_t, std::size_t> mesh2groupVertexRemap {};
-
-                // add cluster vertices to this group
-                // and remove clusters from clusters to merge
                 for(const auto& meshletIndex : group.meshlets) {
-                    auto& meshlet = previousLevelMeshlets[meshletIndex];
-                    meshlet.groupIndex = currentGroupIndex;
-
-                    std::size_t start = groupVertexIndices.size();
-                    groupVertexIndices.ensureReserve(start + meshlet.indexCount);
-                    for(std::size_t j = 0; j < meshlet.indexCount; j += 3) { // triangle per triangle
-                        std::int64_t triangle[3] = {
-                            mergeVertexRemap[primitive.meshletVertexIndices[primitive.meshletIndices[meshlet.indexOffset + j + 0] + meshlet.vertexOffset]],
-                            mergeVertexRemap[primitive.meshletVertexIndices[primitive.meshletIndices[meshlet.indexOffset + j + 1] + meshlet.vertexOffset]],
-                            mergeVertexRemap[primitive.meshletVertexIndices[primitive.meshletIndices[meshlet.indexOffset + j + 2] + meshlet.vertexOffset]],
-                        };
-
-                        // remove triangles which have collapsed on themselves due to vertex merge
-                        if(triangle[0] == triangle[1] && triangle[0] == triangle[2]) {
-                            continue;
-                        }
-
-                        for(std::size_t vertex = 0; vertex < 3; vertex++) {
-                            const std::size_t vertexIndex = triangle[vertex];
-
-                            // map vertex index valid for entire to a smaller vertex buffer just for this group
-                            auto [iter, bWasNew] = mesh2groupVertexRemap.try_emplace(vertexIndex);
-                            if(bWasNew) {
-                                iter->second = groupVertexBuffer.size();
-                                groupVertexBuffer.emplaceBack(primitive.vertices[iter->second]);
-                            }
-                            groupVertexIndices.pushBack(iter->second);
-                        }
-                    }
+                    previousLevelMeshlets[meshletIndex].groupIndex = currentGroupIndex;
                 }
 
-                if(groupVertexIndices.empty()) {
+                // ===== Generate meshlets for this group
+                // TODO: if cluster is not simplified, use it for next LOD
+                if(simplifiedGroup.indices.empty()) {
                     continue;
                 }
 
-                // create reverse mapping from group to mesh-wide vertex indices
-                group2meshVertexRemap.resize(groupVertexBuffer.size());
-                group2meshVertexRemap.fill(~0ull);
-
-                for(const auto& [meshIndex, groupIndex] : mesh2groupVertexRemap) {
-                    verify(groupIndex < group2meshVertexRemap.size(), "Wrong size!");
-                    group2meshVertexRemap[groupIndex] = meshIndex;
+                for(const auto& meshletIndex : group.meshlets) {
+                    previousLevelMeshlets[meshletIndex].parentError = simplifiedGroup.error;
+                    previousLevelMeshlets[meshletIndex].parentBoundingSphere = simplifiedGroup.bounds;
                 }
 
-                float targetError = (0.1f * tLod + 0.01f * (1-tLod));
-
-                // simplify this group
-                const float threshold = 0.5f;
-                std::size_t targetIndexCount = groupVertexIndices.size() * threshold;
-                unsigned int options = meshopt_SimplifyLockBorder; // we want all group borders to be locked (because they are shared between groups)
-
-                std::vector<unsigned int> simplifiedIndexBuffer;
-                simplifiedIndexBuffer.resize(groupVertexIndices.size());
-                float simplificationError = 0.f;
-
-                std::size_t simplifiedIndexCount = meshopt_simplify(simplifiedIndexBuffer.data(), // output
-                                                                    groupVertexIndices.data(), groupVertexIndices.size(), // index buffer
-                                                                    &groupVertexBuffer[0].pos.x, groupVertexBuffer.size(), sizeof(Carrot::Vertex), // vertex buffer
-                                                                    targetIndexCount, targetError, options, &simplificationError
-                );
-                simplifiedIndexBuffer.resize(simplifiedIndexCount);
-
-                // ===== Generate meshlets for this group
-                // TODO: if cluster is not simplified, use it for next LOD
-                if(simplifiedIndexCount > 0 && simplifiedIndexCount != groupVertexIndices.size()) {
-                    float localScale = meshopt_simplifyScale(&groupVertexBuffer[0].pos.x, groupVertexBuffer.size(), sizeof(Carrot::Vertex));
-                    // TODO: numerical stability
-                    float meshSpaceError = simplificationError * localScale;
-                    float parentError = 0.0f;
-
-                    glm::vec3 min { +INFINITY, +INFINITY, +INFINITY };
-                    glm::vec3 max { -INFINITY, -INFINITY, -INFINITY };
-
-                    // remap simplified index buffer to mesh-wide vertex indices
-                    for(auto& index : simplifiedIndexBuffer) {
-                        index = group2meshVertexRemap[index];
-
-                        const glm::vec3 vertexPos = glm::vec3 { primitive.vertices[index].pos.xyz };
-                        min = glm::min(min, vertexPos);
-                        max = glm::max(max, vertexPos);
-                    }
-
-                    Carrot::Math::Sphere simplifiedClusterBounds;
-                    simplifiedClusterBounds.loadFromAABB(min, max);
-
-                    for(const auto& meshletIndex : group.meshlets) {
-                        const auto& previousMeshlet = previousLevelMeshlets[meshletIndex];
-                        // ensure parent(this) error >= child(members of group) error
-                        parentError = std::max(parentError, previousMeshlet.clusterError);
-                    }
-
-                    meshSpaceError += parentError;
-                    for(const auto& meshletIndex : group.meshlets) {
-                        previousLevelMeshlets[meshletIndex].parentError = meshSpaceError;
-                        previousLevelMeshlets[meshletIndex].parentBoundingSphere = simplifiedClusterBounds;
-                    }
-
-                    // group index is replaced on next iteration of loop (if there is one) to group the meshlets together based on partitionning
-                    appendMeshlets(primitive, simplifiedIndexBuffer, simplifiedClusterBounds, meshSpaceError, &uniqueGroupIndex);
-                }
+                // group index is replaced on next iteration of loop (if there is one) to group the meshlets together based on partitionning
+                appendMeshlets(primitive, simplifiedGroup.indices, simplifiedGroup.bounds, simplifiedGroup.error, &uniqueGroupIndex);
             }
 
             for(std::size_t i = newMeshletStart; i < primitive.meshlets.size(); i++) {
@@ -1059,6 +1187,23 @@ namespace Fertilizer {
         }
     }
 
+    /**
+     * Creates the quantized vertices used to render the meshlets of the primitive.
+     * A single set of bounds is used for the entire primitive, so that vertices shared by different meshlets (and LODs) stay
+     * at the exact same position after decoding.
+     */
+    static void quantizeVertices(LoadedPrimitive& primitive) {
+        std::vector<Carrot::PackedVertex> packedVertices;
+        packedVertices.resize(primitive.vertices.size());
+        Carrot::Async::parallelFor(packedVertices.size(), [&](std::size_t index) {
+            packedVertices[index] = Carrot::PackedVertex { primitive.vertices[index] };
+        }, 1024);
+
+        primitive.quantizationBounds = Carrot::VertexQuantization::computeBounds(packedVertices);
+        primitive.quantizedVertices.resize(packedVertices.size());
+        Carrot::VertexQuantization::encode(packedVertices, primitive.quantizationBounds, primitive.quantizedVertices);
+    }
+
     static void processScene(LoadedScene& scene, const std::string& modelName, const Carrot::NotificationID& loadNotifID) {
         for(std::size_t i = 0; i < scene.primitives.size(); i++) {
             Carrot::UserNotifications::getInstance().setProgress(loadNotifID, float(i) / scene.primitives.size());
@@ -1089,6 +1234,7 @@ namespace Fertilizer {
                 // TODO: support for skinned meshes
                 const float simplifyScale = meshopt_simplifyScale(&primitive.vertices[0].pos.x, primitive.vertices.size(), sizeof(Carrot::Vertex));
                 generateClusterHierarchy(primitive, simplifyScale);
+                quantizeVertices(primitive);
             }
         }
 
@@ -1130,6 +1276,91 @@ namespace Fertilizer {
         model = std::move(reexported);
     }
 
+    /// Writes the cooked version of 'model' next to 'outputFile'. The cooked model is created from the exported glTF, with
+    /// the same loader as the engine, so that both formats give the same LoadedScene
+    static ConversionResult writeCookedModel(const tinygltf::Model& model, const std::filesystem::path& outputFile) {
+        GLTFLoader loader{};
+        LoadedScene scene = loader.load(model, {});
+        std::vector<std::uint8_t> cooked = CookedModel::cook(scene);
+
+        std::filesystem::path cookedFile = outputFile;
+        cookedFile.replace_extension(CookedModel::Extension);
+        std::ofstream file(cookedFile, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(cooked.data()), static_cast<std::streamsize>(cooked.size()));
+        if(!file) {
+            return {
+                .errorCode = ConversionResultError::CookedModelError,
+                .errorMessage = "Could not write cooked model",
+            };
+        }
+
+        return {
+            .errorCode = ConversionResultError::Success,
+        };
+    }
+
+    ConversionResult validateCookedModel(const std::filesystem::path& gltfFile) {
+        tinygltf::TinyGLTF parser;
+        tinygltf::FsCallbacks callbacks;
+
+        callbacks.ReadWholeFile = gltfReadWholeFile;
+        callbacks.ExpandFilePath = gltfExpandFilePath;
+        callbacks.FileExists = gltfFileExists;
+        callbacks.WriteWholeFile = nullptr;
+
+        fspath parentPath = gltfFile.parent_path();
+        callbacks.user_data = (void*)&parentPath;
+        parser.SetFsCallbacks(callbacks);
+
+        tinygltf::Model model;
+        std::string errors;
+        std::string warnings;
+        if(!parser.LoadASCIIFromFile(&model, &errors, &warnings, gltfFile.string())) {
+            return {
+                .errorCode = ConversionResultError::CookedModelError,
+                .errorMessage = errors,
+            };
+        }
+
+        std::filesystem::path cookedFile = gltfFile;
+        cookedFile.replace_extension(CookedModel::Extension);
+        if(!std::filesystem::exists(cookedFile)) {
+            return {
+                .errorCode = ConversionResultError::InputFileDoesNotExist,
+                .errorMessage = Carrot::sprintf("Missing cooked model %s", cookedFile.string().c_str()),
+            };
+        }
+
+        std::vector<std::uint8_t> cooked;
+        cooked.resize(std::filesystem::file_size(cookedFile));
+        std::ifstream file(cookedFile, std::ios::in | std::ios::binary);
+        file.read(reinterpret_cast<char*>(cooked.data()), static_cast<std::streamsize>(cooked.size()));
+
+        std::vector<std::string> problems = CookedModel::validate(cooked);
+        if(problems.empty()) {
+            GLTFLoader loader{};
+            const LoadedScene expected = loader.load(model, {});
+            const LoadedScene actual = CookedModel::load(cooked, {});
+            problems = CookedModel::compare(expected, actual);
+        }
+
+        if(!problems.empty()) {
+            std::string message = Carrot::sprintf("%llu problem(s) found in %s:", static_cast<std::uint64_t>(problems.size()), cookedFile.string().c_str());
+            for(const std::string& problem : problems) {
+                message += "\n - ";
+                message += problem;
+            }
+            return {
+                .errorCode = ConversionResultError::CookedModelError,
+                .errorMessage = message,
+            };
+        }
+
+        return {
+            .errorCode = ConversionResultError::Success,
+        };
+    }
+
     ConversionResult processAssimp(const std::filesystem::path& inputFile, const std::filesystem::path& outputFile) {
         AssimpLoader loader;
         Assimp::Importer importer;
@@ -1151,9 +1382,7 @@ namespace Fertilizer {
             };
         }
 
-        return {
-            .errorCode = ConversionResultError::Success,
-        };
+        return writeCookedModel(reexported, outputFile);
     }
 
 
@@ -1207,8 +1436,6 @@ namespace Fertilizer {
             };
         }
 
-        return {
-            .errorCode = ConversionResultError::Success,
-        };
+        return writeCookedModel(model, outputFile);
     }
 }
@@ -10,4 +10,8 @@
 namespace Fertilizer {
     ConversionResult processGLTF(const std::filesystem::path& inputFile, const std::filesystem::path& outputFile);
     ConversionResult processAssimp(const std::filesystem::path& inputFile, const std::filesystem::path& outputFile);
+
+    /// Checks the cooked model next to 'gltfFile' (a glTF exported by Fertilizer): deep validation of its content, then
+    /// comparison with what GLTFLoader reads from the glTF
+    ConversionResult validateCookedModel(const std::filesystem::path& gltfFile);
 }
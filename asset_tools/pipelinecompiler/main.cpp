@@ -7,23 +7,50 @@
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <set>
 #include <core/Macros.h>
 #include <core/utils/stringmanip.h>
 #include <rapidjson/filewritestream.h>
 #include <rapidjson/prettywriter.h>
 
 #include "../shadercompiler/ShaderCompiler.h"
+#include "../shadercompiler/ShaderCache.h"
+#include "../shadercompiler/Depfile.h"
 
 
 void printUsage() {
-    std::cerr << "pipelinecompiler [base path] [output base path] [relative path of pipeline]\n"
-                 "Inputs filepaths (pipeline and shader paths) are relative to [base path] and outputs are relative to [output base path]" << std::endl;
+    std::cerr << "pipelinecompiler [options] [base path] [output base path] [relative path of pipeline]...\n"
+                 "Inputs filepaths (pipeline and shader paths) are relative to [base path] and outputs are relative to [output base path]\n"
+                 "Multiple pipelines can be given: their shaders are compiled in parallel, and shaders shared by multiple pipelines are compiled once.\n"
+                 "Pipelines more recent than their dependencies are not recompiled.\n"
+                 "Options:\n"
+                 "\t--cache [folder]: Reuses SPIR-V from [folder] when the preprocessed source of a shader did not change\n"
+                 "\t--jobs [count]: Thread count for shader compilation, defaults to one per hardware thread\n"
+                 "\t--depfile [file]: Writes a depfile covering all the given pipelines to [file]" << std::endl;
 }
 
 bool hasShaderCompiler() {
     return std::filesystem::exists("shadercompiler.exe");
 }
 
+struct PipelineJob {
+    std::filesystem::path inputFilepath;
+    std::filesystem::path outFilename;
+    bool upToDate = false;
+
+    rapidjson::Document document;
+    std::vector<std::size_t> shaderRequests; // indices inside the list of shaders to compile
+    std::vector<std::filesystem::path> dependencies;
+};
+
+static std::filesystem::path getDepfilePath(const std::filesystem::path& outFilename) {
+    std::filesystem::path depfilePath = outFilename;
+    depfilePath.replace_extension(".pipeline.d");
+    return depfilePath;
+}
+
 int main(int argc, char** argv) {
     if(!hasShaderCompiler()) {
         std::cerr << "Missing shadercompiler.exe in working dir, won't be able to launch" << std::endl;
@@ -31,153 +58,193 @@ int main(int argc, char** argv) {
         return -1;
     }
 
-    if(argc != 4) {
+    std::unique_ptr<ShaderCompiler::ShaderCache> pCache;
+    std::size_t jobCount = 0;
+    std::filesystem::path batchDepfilePath;
+    std::vector<const char*> positionalArgs;
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if(arg == "--cache" && i + 1 < argc) {
+            pCache = std::make_unique<ShaderCompiler::ShaderCache>(argv[++i]);
+        } else if(arg == "--jobs" && i + 1 < argc) {
+            jobCount = std::stoull(argv[++i]);
+        } else if(arg == "--depfile" && i + 1 < argc) {
+            batchDepfilePath = argv[++i];
+        } else {
+            positionalArgs.push_back(argv[i]);
+        }
+    }
+
+    if(positionalArgs.size() < 3) {
         printUsage();
         return -2;
     }
 
-    const std::filesystem::path basePath { argv[1] };
-    const std::filesystem::path outputBasePath { argv[2] };
-    const std::filesystem::path relativePipelinePath { argv[3] };
+    const std::filesystem::path basePath { positionalArgs[0] };
+    const std::filesystem::path outputBasePath { positionalArgs[1] };
 
     if(!std::filesystem::exists(outputBasePath)) {
         std::filesystem::create_directories(outputBasePath);
     }
 
-    const std::filesystem::path inputFilepath{ basePath / relativePipelinePath };
-    std::ifstream stream{ inputFilepath, std::ios::binary | std::ios::in };
-    std::string fileContents;
-
-    std::string line;
-    while (getline(stream, line)) {
-        if (!fileContents.empty()) {
-            fileContents += '\n';
+    const std::filesystem::path shaderCompilerBasePath = basePath / "resources" / "shaders";
+    std::vector<ShaderCompiler::CompileRequest> shaderRequests;
+    std::map<std::filesystem::path, std::size_t> shaderRequestIndices; // output -> index in shaderRequests
+
+    std::vector<PipelineJob> pipelines { positionalArgs.size() - 2 };
+    for(std::size_t pipelineIndex = 0; pipelineIndex < pipelines.size(); pipelineIndex++) {
+        PipelineJob& pipeline = pipelines[pipelineIndex];
+        const std::filesystem::path relativePipelinePath { positionalArgs[pipelineIndex + 2] };
+        pipeline.inputFilepath = basePath / relativePipelinePath;
+        pipeline.outFilename = outputBasePath / relativePipelinePath;
+        pipeline.outFilename.replace_extension(".pipeline");
+
+        const std::filesystem::path depfilePath = getDepfilePath(pipeline.outFilename);
+        if(ShaderCompiler::isUpToDate(depfilePath, std::span { &pipeline.outFilename, 1 }, std::span { &pipeline.inputFilepath, 1 })) {
+            pipeline.upToDate = true;
+            pipeline.dependencies = ShaderCompiler::readDepfile(depfilePath).value();
+            std::filesystem::last_write_time(pipeline.outFilename, std::filesystem::file_time_type::clock::now()); // output is part of this batch, it must look rebuilt
+            continue;
         }
-        fileContents += line;
-    }
-    rapidjson::Document d;
-    d.Parse(fileContents.data());
 
-    if(d.HasParseError()) {
-        std::cerr << rapidjson::GetParseError_En(d.GetParseError()) << std::endl;
-        return -3;
-    }
+        std::ifstream stream{ pipeline.inputFilepath, std::ios::binary | std::ios::in };
+        std::string fileContents;
 
-    const std::filesystem::path shaderCompilerBasePath = basePath / "resources" / "shaders";
-    std::vector<std::filesystem::path> dependencies;
-    auto handleShaderRef = [&](const char* memberName, ShaderCompiler::Stage stage) -> bool{
-        auto memberIter = d.FindMember(memberName);
-        if(memberIter == d.MemberEnd()) {
-            return true;
+        std::string line;
+        while (getline(stream, line)) {
+            if (!fileContents.empty()) {
+                fileContents += '\n';
+            }
+            fileContents += line;
         }
+        rapidjson::Document& d = pipeline.document;
+        d.Parse(fileContents.data());
 
-        auto& value = memberIter->value;
-        if(!value.IsObject()) {
-            std::cerr << memberName << " is not an object: old format not supported" << std::endl;
-            return false;
+        if(d.HasParseError()) {
+            std::cerr << pipeline.inputFilepath.string() << ": " << rapidjson::GetParseError_En(d.GetParseError()) << std::endl;
+            return -3;
         }
 
-        auto fileIter = value.FindMember("file");
-        if(fileIter == value.MemberEnd()) {
-            std::cerr << memberName << " is missing 'file' field" << std::endl;
-            return false;
-        }
+        auto handleShaderRef = [&](const char* memberName, ShaderCompiler::Stage stage) -> bool{
+            auto memberIter = d.FindMember(memberName);
+            if(memberIter == d.MemberEnd()) {
+                return true;
+            }
 
-        auto entryPointIter = value.FindMember("entry_point");
-        if(entryPointIter == value.MemberEnd()) {
-            std::cerr << memberName << " is missing 'entryPoint' field" << std::endl;
-            return false;
-        }
+            auto& value = memberIter->value;
+            if(!value.IsObject()) {
+                std::cerr << memberName << " is not an object: old format not supported" << std::endl;
+                return false;
+            }
 
-        // make sure pipeline refers to compiled shader
-        const std::string shaderPath{ fileIter->value.GetString(), fileIter->value.GetStringLength() };
+            auto fileIter = value.FindMember("file");
+            if(fileIter == value.MemberEnd()) {
+                std::cerr << memberName << " is missing 'file' field" << std::endl;
+                return false;
+            }
 
-        // removes file & entry object by a single path (which contains entry point name)
-        const std::string compiledShaderPath = ShaderCompiler::createCompiledShaderName(fileIter->value.GetString(), entryPointIter->value.GetString());
-        value = rapidjson::Value{ compiledShaderPath.c_str(), d.GetAllocator() };
+            auto entryPointIter = value.FindMember("entry_point");
+            if(entryPointIter == value.MemberEnd()) {
+                std::cerr << memberName << " is missing 'entryPoint' field" << std::endl;
+                return false;
+            }
 
-        const std::filesystem::path shaderAbsoluteInputPath = basePath / shaderPath;
-        const std::filesystem::path shaderAbsoluteOutputPath = outputBasePath / compiledShaderPath;
+            // make sure pipeline refers to compiled shader
+            const std::string shaderPath{ fileIter->value.GetString(), fileIter->value.GetStringLength() };
+            const std::string entryPoint{ entryPointIter->value.GetString(), entryPointIter->value.GetStringLength() };
+
+            // removes file & entry object by a single path (which contains entry point name)
+            const std::string compiledShaderPath = ShaderCompiler::createCompiledShaderName(shaderPath.c_str(), entryPoint.c_str());
+            value = rapidjson::Value{ compiledShaderPath.c_str(), d.GetAllocator() };
+
+            const std::filesystem::path shaderAbsoluteInputPath = basePath / shaderPath;
+            const std::filesystem::path shaderAbsoluteOutputPath = outputBasePath / compiledShaderPath;
+
+            // pipelines often share shaders: compile each of them once
+            auto [requestIter, isNew] = shaderRequestIndices.try_emplace(shaderAbsoluteOutputPath, shaderRequests.size());
+            if(isNew) {
+                shaderRequests.emplace_back(ShaderCompiler::CompileRequest {
+                    .basePath = shaderCompilerBasePath,
+                    .inputFile = shaderAbsoluteInputPath,
+                    .outputFile = shaderAbsoluteOutputPath,
+                    .stage = stage,
+                    .entryPoint = entryPoint,
+                });
+            }
+            pipeline.shaderRequests.push_back(requestIter->second);
+            pipeline.dependencies.push_back(shaderAbsoluteInputPath);
+            return true;
+        };
 
-        int result = ShaderCompiler::compileShader(
-            shaderCompilerBasePath.string().data(),
-            shaderAbsoluteInputPath.string().data(),
-            shaderAbsoluteOutputPath.string().data(),
-            stage,
-            dependencies,
-            entryPointIter->value.GetString()
-            );
+        bool valid = true;
+        valid &= handleShaderRef("vertexShader", ShaderCompiler::Stage::Vertex);
+        valid &= handleShaderRef("fragmentShader", ShaderCompiler::Stage::Fragment);
+        valid &= handleShaderRef("computeShader", ShaderCompiler::Stage::Compute);
+        valid &= handleShaderRef("meshShader", ShaderCompiler::Stage::Mesh);
+        valid &= handleShaderRef("taskShader", ShaderCompiler::Stage::Task);
+        if(!valid) {
+            std::cerr << "Invalid pipeline " << pipeline.inputFilepath.string() << std::endl;
+            return -4;
+        }
 
-        dependencies.push_back(shaderAbsoluteInputPath);
+        auto importIter = d.FindMember("_import");
+        if(importIter != d.MemberEnd()) {
+            std::filesystem::path importedPath = pipeline.inputFilepath.parent_path() / importIter->value.GetString();
+            pipeline.dependencies.push_back(importedPath);
 
-        if(result != 0) {
-            std::cerr << "shadercompiler failed." << std::endl;
-            return false;
+            std::filesystem::path importVal { importIter->value.GetString() };
+            importVal.replace_extension(".pipeline");
+            importIter->value = rapidjson::Value { importVal.string().c_str(), d.GetAllocator() };
         }
-        return true;
-    };
-
-    bool valid = true;
-    valid &= handleShaderRef("vertexShader", ShaderCompiler::Stage::Vertex);
-    valid &= handleShaderRef("fragmentShader", ShaderCompiler::Stage::Fragment);
-    valid &= handleShaderRef("computeShader", ShaderCompiler::Stage::Compute);
-    valid &= handleShaderRef("meshShader", ShaderCompiler::Stage::Mesh);
-    valid &= handleShaderRef("taskShader", ShaderCompiler::Stage::Task);
-    if(!valid) {
-        return -4;
     }
 
-    std::filesystem::path outFilename = outputBasePath / relativePipelinePath;
-    outFilename.replace_extension(".pipeline");
+    std::vector<std::vector<std::filesystem::path>> shaderDependencies;
+    if(ShaderCompiler::compileShaders(shaderRequests, shaderDependencies, pCache.get(), jobCount) != 0) {
+        std::cerr << "shadercompiler failed." << std::endl;
+        return -4;
+    }
 
-    auto importIter = d.FindMember("_import");
-    if(importIter != d.MemberEnd()) {
-        std::filesystem::path importedPath = inputFilepath.parent_path() / importIter->value.GetString();
-        dependencies.push_back(importedPath);
+    for(PipelineJob& pipeline : pipelines) {
+        if(pipeline.upToDate) {
+            continue;
+        }
 
-        std::filesystem::path importVal { importIter->value.GetString() };
-        importVal.replace_extension(".pipeline");
-        importIter->value = rapidjson::Value { importVal.string().c_str(), d.GetAllocator() };
-    }
+        for(const std::size_t requestIndex : pipeline.shaderRequests) {
+            const auto& dependencies = shaderDependencies[requestIndex];
+            pipeline.dependencies.insert(pipeline.dependencies.end(), dependencies.begin(), dependencies.end());
+        }
 
-    if(!std::filesystem::exists(outFilename.parent_path())) {
-        std::filesystem::create_directories(outFilename.parent_path());
-    }
+        if(!std::filesystem::exists(pipeline.outFilename.parent_path())) {
+            std::filesystem::create_directories(pipeline.outFilename.parent_path());
+        }
 
-    {
         // depfile (for CMake)
-        std::filesystem::path depfilePath = outFilename;
-        depfilePath.replace_extension(".pipeline.d");
-        std::wofstream outputFile(depfilePath);
-
-        outputFile << outFilename.c_str() << ": ";
-
-        auto addDependency = [&](const std::filesystem::path& dependencyPath) {
-            std::wstring path = dependencyPath.c_str();
-            // replace separators
-            for(std::size_t i = 0; i < path.size(); i++) {
-                if(path[i] == L'\\') {
-                    path[i] = L'/';
-                }
-            }
-            outputFile << path << " ";
-        };
-        for(const auto& includedFile : dependencies) {
-            addDependency(includedFile);
-        }
-    }
+        ShaderCompiler::writeDepfile(getDepfilePath(pipeline.outFilename), std::span { &pipeline.outFilename, 1 }, pipeline.dependencies);
 
-    // write to output file
-    {
-        FILE *fp = fopen(Carrot::toString(outFilename.u8string()).c_str(), "wb"); // non-Windows use "w"
+        // write to output file
+        {
+            FILE *fp = fopen(Carrot::toString(pipeline.outFilename.u8string()).c_str(), "wb"); // non-Windows use "w"
 
-        char writeBuffer[65536];
-        rapidjson::FileWriteStream os(fp, writeBuffer, sizeof(writeBuffer));
+            char writeBuffer[65536];
+            rapidjson::FileWriteStream os(fp, writeBuffer, sizeof(writeBuffer));
 
-        rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
+            rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
 
-        d.Accept(writer);
+            pipeline.document.Accept(writer);
+            fclose(fp);
+        }
+    }
+
+    if(!batchDepfilePath.empty()) {
+        std::vector<std::filesystem::path> outputs;
+        std::set<std::filesystem::path> allDependencies;
+        for(const PipelineJob& pipeline : pipelines) {
+            outputs.push_back(pipeline.outFilename);
+            allDependencies.insert(pipeline.dependencies.begin(), pipeline.dependencies.end());
+        }
+        const std::vector<std::filesystem::path> allDependenciesList { allDependencies.begin(), allDependencies.end() };
+        ShaderCompiler::writeDepfile(batchDepfilePath, outputs, allDependenciesList);
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,115 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "Depfile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <core/utils/stringmanip.h>
+
+namespace ShaderCompiler {
+    static std::string escapePath(const std::filesystem::path& path) {
+        // forward slashes everywhere, spaces must be escaped
+        const std::string str = Carrot::toString(path.generic_u8string());
+        std::string escaped;
+        escaped.reserve(str.size());
+        for(char c : str) {
+            if(c == ' ') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    void writeDepfile(const std::filesystem::path& depfilePath, std::span<const std::filesystem::path> targets, std::span<const std::filesystem::path> dependencies) {
+        std::ofstream outputFile(depfilePath, std::ios::out | std::ios::binary);
+        for(std::size_t i = 0; i < targets.size(); i++) {
+            if(i != 0) {
+                outputFile << ' ';
+            }
+            outputFile << escapePath(targets[i]);
+        }
+        outputFile << ": ";
+        for(const auto& dependency : dependencies) {
+            outputFile << escapePath(dependency) << ' ';
+        }
+    }
+
+    std::optional<std::vector<std::filesystem::path>> readDepfile(const std::filesystem::path& depfilePath) {
+        std::ifstream inputFile(depfilePath, std::ios::in | std::ios::binary);
+        if(!inputFile) {
+            return {};
+        }
+        std::stringstream buffer;
+        buffer << inputFile.rdbuf();
+        const std::string contents = buffer.str();
+
+        // targets end at the first ": " (colons followed by slashes are part of Windows drives)
+        const std::size_t separator = contents.find(": ");
+        if(separator == std::string::npos) {
+            return {};
+        }
+
+        std::vector<std::filesystem::path> dependencies;
+        std::string current;
+        auto flush = [&]() {
+            if(!current.empty()) {
+                dependencies.emplace_back(std::u8string { current.begin(), current.end() });
+                current.clear();
+            }
+        };
+        for(std::size_t i = separator + 2; i < contents.size(); i++) {
+            const char c = contents[i];
+            if(c == '\\' && i + 1 < contents.size() && (contents[i + 1] == ' ' || contents[i + 1] == '\n' || contents[i + 1] == '\r')) {
+                if(contents[i + 1] == ' ') {
+                    current += ' ';
+                }
+                i++; // escaped space, or line continuation
+            } else if(c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                flush();
+            } else {
+                current += c;
+            }
+        }
+        flush();
+        return dependencies;
+    }
+
+    bool isUpToDate(const std::filesystem::path& depfilePath, std::span<const std::filesystem::path> outputs, std::span<const std::filesystem::path> extraInputs) {
+        const std::optional<std::vector<std::filesystem::path>> dependencies = readDepfile(depfilePath);
+        if(!dependencies.has_value() || outputs.empty()) {
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::file_time_type oldestOutput = std::filesystem::file_time_type::max();
+        for(const auto& output : outputs) {
+            const auto timestamp = std::filesystem::last_write_time(output, ec);
+            if(ec) {
+                return false; // missing output
+            }
+            oldestOutput = std::min(oldestOutput, timestamp);
+        }
+
+        auto isOlderThanOutputs = [&](const std::filesystem::path& input) {
+            const auto timestamp = std::filesystem::last_write_time(input, ec);
+            // missing inputs (deleted includes) require a recompilation. Equal timestamps are ambiguous with coarse filesystem clocks
+            return !ec && timestamp < oldestOutput;
+        };
+        for(const auto& input : dependencies.value()) {
+            if(!isOlderThanOutputs(input)) {
+                return false;
+            }
+        }
+        for(const auto& input : extraInputs) {
+            if(!isOlderThanOutputs(input)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,22 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace ShaderCompiler {
+    /// Writes a Make-style depfile ("target1 target2: dependency1 dependency2"), as expected by the DEPFILE option of CMake
+    void writeDepfile(const std::filesystem::path& depfilePath, std::span<const std::filesystem::path> targets, std::span<const std::filesystem::path> dependencies);
+
+    /// Dependencies listed inside a depfile written by 'writeDepfile'. Empty if the depfile does not exist or could not be read
+    std::optional<std::vector<std::filesystem::path>> readDepfile(const std::filesystem::path& depfilePath);
+
+    /// Are all 'outputs' present, and more recent than both the dependencies listed inside 'depfilePath' and 'extraInputs'?
+    /// Used by batch compilations to skip entries which did not change since the last run
+    bool isUpToDate(const std::filesystem::path& depfilePath, std::span<const std::filesystem::path> outputs, std::span<const std::filesystem::path> extraInputs);
+}
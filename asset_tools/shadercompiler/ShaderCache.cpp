@@ -0,0 +1,87 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "ShaderCache.h"
+
+#include <fstream>
+#include <random>
+#include <core/utils/CRC64.hpp>
+#include <core/utils/stringmanip.h>
+
+namespace ShaderCompiler {
+    ShaderCacheKey ShaderCacheKey::compute(std::string_view preprocessedSource, std::string_view preamble, std::string_view entryPoint,
+                                           int stage, const std::filesystem::path& inputFile) {
+        const std::string inputFileStr = Carrot::toString(std::filesystem::absolute(inputFile).u8string());
+
+        std::uint64_t hash = 0;
+        auto add = [&](const void* pData, std::size_t size) {
+            hash = Carrot::CRC64Continue(hash, static_cast<const char*>(pData), size);
+            // separator, to avoid ambiguities between consecutive strings
+            const char zero = '\0';
+            hash = Carrot::CRC64Continue(hash, &zero, 1);
+        };
+        const std::uint32_t version = ShaderCache::FormatVersion;
+        add(&version, sizeof(version));
+        add(&stage, sizeof(stage));
+        add(entryPoint.data(), entryPoint.size());
+        add(preamble.data(), preamble.size());
+        add(inputFileStr.data(), inputFileStr.size());
+        add(preprocessedSource.data(), preprocessedSource.size());
+
+        return ShaderCacheKey {
+            .hash = hash,
+            .sourceLength = preprocessedSource.size(),
+        };
+    }
+
+    ShaderCache::ShaderCache(const std::filesystem::path& folder): folder(folder) {
+        std::filesystem::create_directories(folder);
+    }
+
+    std::filesystem::path ShaderCache::getEntryPath(const ShaderCacheKey& key) const {
+        return folder / Carrot::sprintf("%016llx-%llx.spv", key.hash, key.sourceLength);
+    }
+
+    std::optional<std::vector<std::uint32_t>> ShaderCache::get(const ShaderCacheKey& key) const {
+        const std::filesystem::path entryPath = getEntryPath(key);
+        std::error_code ec;
+        const std::uintmax_t size = std::filesystem::file_size(entryPath, ec);
+        if(ec || size == 0 || size % sizeof(std::uint32_t) != 0) {
+            return {};
+        }
+
+        std::vector<std::uint32_t> spirv;
+        spirv.resize(size / sizeof(std::uint32_t));
+        std::ifstream file(entryPath, std::ios::in | std::ios::binary);
+        file.read(reinterpret_cast<char*>(spirv.data()), static_cast<std::streamsize>(size));
+        if(!file) {
+            return {};
+        }
+        return spirv;
+    }
+
+    void ShaderCache::put(const ShaderCacheKey& key, std::span<const std::uint32_t> spirv) const {
+        const std::filesystem::path entryPath = getEntryPath(key);
+
+        // other processes may be writing the same entry, never expose a partially written file
+        thread_local std::mt19937_64 rng { std::random_device{}() };
+        std::filesystem::path temporaryPath = entryPath;
+        temporaryPath += Carrot::sprintf(".%016llx.tmp", static_cast<std::uint64_t>(rng()));
+        {
+            std::ofstream file(temporaryPath, std::ios::out | std::ios::binary);
+            file.write(reinterpret_cast<const char*>(spirv.data()), static_cast<std::streamsize>(spirv.size_bytes()));
+            if(!file) {
+                file.close();
+                std::filesystem::remove(temporaryPath);
+                return; // the cache is only an optimisation
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temporaryPath, entryPath, ec);
+        if(ec) {
+            std::filesystem::remove(temporaryPath, ec);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace ShaderCompiler {
+    /// Identifies the SPIR-V produced from a given preprocessed source. See ShaderCache
+    struct ShaderCacheKey {
+        std::uint64_t hash = 0;
+        std::uint64_t sourceLength = 0; // reduces the likelihood of collisions further
+
+        /// Hashes everything which can change the SPIR-V: preprocessed source, stage, entry point, preamble (with defines), compilation options.
+        /// 'inputFile' is part of the key because debug info references source files by name
+        static ShaderCacheKey compute(std::string_view preprocessedSource, std::string_view preamble, std::string_view entryPoint,
+                                      int stage, const std::filesystem::path& inputFile);
+    };
+
+    /**
+     * Content-addressed cache of compiled SPIR-V, stored as one file per entry inside a folder.
+     * Shaders are looked up by the hash of their preprocessed source, so a change to a shared include only recompiles shaders
+     * whose preprocessed output actually changed (for instance, code inside #if branches not taken by a shader does not count).
+     * Can be shared between threads and processes: entries are written to a temporary file, then renamed.
+     */
+    class ShaderCache {
+    public:
+        /// Bump when the compilation settings change, to invalidate all existing entries
+        static constexpr std::uint32_t FormatVersion = 1;
+
+        explicit ShaderCache(const std::filesystem::path& folder);
+
+        std::optional<std::vector<std::uint32_t>> get(const ShaderCacheKey& key) const;
+        void put(const ShaderCacheKey& key, std::span<const std::uint32_t> spirv) const;
+
+    private:
+        std::filesystem::path getEntryPath(const ShaderCacheKey& key) const;
+
+        std::filesystem::path folder;
+    };
+}
@@ -4,8 +4,12 @@
 
 #include "ShaderCompiler.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
+#include <thread>
 #include <filesystem>
 #include <fstream>
 #include <core/data/ShaderMetadata.h>
@@ -17,6 +21,7 @@
 #include <SPIRV/GlslangToSpv.h>
 
 #include "FileIncluder.h"
+#include "ShaderCache.h"
 #include "glslang/Public/ShaderLang.h"
 #include "glslang/Public/ResourceLimits.h"
 
@@ -98,14 +103,56 @@ namespace ShaderCompiler {
         return compiled.string();
     }
 
+    bool parseStage(const char* stageStr, Stage& outStage) {
+        const std::string lowercase = Carrot::toLowerCase(stageStr);
+        if(lowercase == "fragment") {
+            outStage = Stage::Fragment;
+        } else if(lowercase == "vertex") {
+            outStage = Stage::Vertex;
+        } else if(lowercase == "rgen") {
+            outStage = Stage::RayGen;
+        } else if(lowercase == "rchit") {
+            outStage = Stage::RayClosestHit;
+        } else if(lowercase == "compute") {
+            outStage = Stage::Compute;
+        } else if(lowercase == "rmiss") {
+            outStage = Stage::RayMiss;
+        } else if(lowercase == "task") {
+            outStage = Stage::Task;
+        } else if(lowercase == "mesh") {
+            outStage = Stage::Mesh;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    static bool initializeGlslang() {
+        // once per process: batch compilations share the same initialization
+        static const bool initialized = glslang::InitializeProcess();
+        return initialized;
+    }
+
     int compileShader(const char *basePath, const char *inputFilepath, const char *outputFilepath, Stage stageCarrot, std::vector<std::filesystem::path>& includedFiles, const char* entryPointName) {
-        if(!glslang::InitializeProcess()) {
+        const CompileRequest request {
+            .basePath = basePath,
+            .inputFile = inputFilepath,
+            .outputFile = outputFilepath,
+            .stage = stageCarrot,
+            .entryPoint = entryPointName,
+        };
+        return compileShader(request, includedFiles, nullptr);
+    }
+
+    int compileShader(const CompileRequest& request, std::vector<std::filesystem::path>& includedFiles, ShaderCache* pCache) {
+        if(!initializeGlslang()) {
             std::cerr << "Failed to setup glslang." << std::endl;
             return -2;
         }
 
-        std::filesystem::path inputFile = inputFilepath;
-        std::filesystem::path outputPath = outputFilepath;
+        const std::filesystem::path& inputFile = request.inputFile;
+        const std::filesystem::path& outputPath = request.outputFile;
+        const char* entryPointName = request.entryPoint.c_str();
 
         if(!std::filesystem::exists(inputFile)) {
             std::cerr << "File does not exist: " << inputFile.string().c_str() << std::endl;
@@ -116,16 +163,8 @@ namespace ShaderCompiler {
             std::filesystem::create_directories(outputPath.parent_path());
         }
 
-        EShLanguage stage = convertToGLSLang(stageCarrot);
-        const char* stageStr = convertToStr(stageCarrot);
-
-        glslang::TShader shader(stage);
-
-        shader.setEntryPoint("main");
-        shader.setSourceEntryPoint(entryPointName);
-        shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
-        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
-        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+        EShLanguage stage = convertToGLSLang(request.stage);
+        const char* stageStr = convertToStr(request.stage);
 
         std::ifstream file(inputFile, std::ios::in);
 
@@ -146,6 +185,14 @@ namespace ShaderCompiler {
     #extension GL_EXT_samplerless_texture_functions: enable
     #extension GL_ARB_shader_draw_parameters: enable
     )";
+        for(const std::string& define : request.defines) {
+            std::string defineLine = define;
+            std::replace(defineLine.begin(), defineLine.end(), '=', ' ');
+            preamble += "#define ";
+            preamble += defineLine;
+            preamble += '\n';
+        }
+
         auto filepath = inputFile.string();
         std::array strs {
             filecontents.c_str(),
@@ -153,47 +200,88 @@ namespace ShaderCompiler {
         std::array names {
                 filepath.c_str(),
         };
-        shader.setPreamble(preamble.c_str());
-        shader.setStringsWithLengthsAndNames(strs.data(), nullptr, names.data(), strs.size());
+        auto setupShader = [&](glslang::TShader& shader) {
+            shader.setEntryPoint("main");
+            shader.setSourceEntryPoint(entryPointName);
+            shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
+            shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
+            shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+            shader.setPreamble(preamble.c_str());
+            shader.setStringsWithLengthsAndNames(strs.data(), nullptr, names.data(), strs.size());
+        };
 
-        ShaderCompiler::FileIncluder includer { basePath };
         TBuiltInResource Resources = *GetDefaultResources();
-        if(!shader.parse(&Resources, 460, false, EShMsgDefault, includer)) {
-            std::cerr << "Failed shader compilation. " << shader.getInfoLog() << std::endl;
-            return -4;
-        }
 
-        glslang::TProgram program;
-        program.addShader(&shader);
-        if(!program.link(EShMsgDefault)) {
-            std::cerr << "Failed shader linking. " << program.getInfoLog() << std::endl;
-            return -5;
-        }
+        // preprocessing is cheap compared to a full compilation: use it to find the includes, and to look up the cache
+        ShaderCompiler::FileIncluder includer { request.basePath };
+        std::optional<ShaderCacheKey> cacheKey;
+        std::vector<std::uint32_t> spirv;
+        bool fromCache = false;
+        if(pCache != nullptr) {
+            glslang::TShader preprocessedShader(stage);
+            setupShader(preprocessedShader);
+            std::string preprocessed;
+            if(!preprocessedShader.preprocess(&Resources, 460, ENoProfile, false, false, EShMsgDefault, &preprocessed, includer)) {
+                std::cerr << "Failed shader preprocessing. " << preprocessedShader.getInfoLog() << std::endl;
+                return -4;
+            }
 
-        auto& shaders = program.getShaders(stage);
-        if(shaders.empty()) {
-            std::cerr << "No program of type " << stageStr << " has been linked. This should NOT happen!!" << std::endl;
-            return -6;
+            cacheKey = ShaderCacheKey::compute(preprocessed, preamble, request.entryPoint, static_cast<int>(request.stage), inputFile);
+            if(auto cached = pCache->get(cacheKey.value())) {
+                spirv = std::move(cached.value());
+                fromCache = true;
+            }
         }
 
-        if(!program.mapIO()) {
-            std::cerr << "Failed shader linking (glslang mapIO). " << program.getInfoLog() << std::endl;
-            return -7;
-        }
+        if(!fromCache) {
+            glslang::TShader shader(stage);
+            setupShader(shader);
 
-        std::vector<std::uint32_t> spirv;
-        spv::SpvBuildLogger logger;
-        glslang::SpvOptions spvOptions;
+            ShaderCompiler::FileIncluder compilationIncluder { request.basePath };
+            if(!shader.parse(&Resources, 460, false, EShMsgDefault, compilationIncluder)) {
+                std::cerr << "Failed shader compilation. " << shader.getInfoLog() << std::endl;
+                return -4;
+            }
+            if(pCache == nullptr) {
+                includer.includedFiles = std::move(compilationIncluder.includedFiles);
+            }
 
-        // TODO: argument
-        spvOptions.generateDebugInfo = true;
-        spvOptions.stripDebugInfo = false;
+            glslang::TProgram program;
+            program.addShader(&shader);
+            if(!program.link(EShMsgDefault)) {
+                std::cerr << "Failed shader linking. " << program.getInfoLog() << std::endl;
+                return -5;
+            }
+
+            auto& shaders = program.getShaders(stage);
+            if(shaders.empty()) {
+                std::cerr << "No program of type " << stageStr << " has been linked. This should NOT happen!!" << std::endl;
+                return -6;
+            }
+
+            if(!program.mapIO()) {
+                std::cerr << "Failed shader linking (glslang mapIO). " << program.getInfoLog() << std::endl;
+                return -7;
+            }
+
+            spv::SpvBuildLogger logger;
+            glslang::SpvOptions spvOptions;
 
-        spvOptions.disableOptimizer = true;
-        spvOptions.optimizeSize = false;
-        spvOptions.disassemble = false;
-        spvOptions.validate = true;
-        glslang::GlslangToSpv(*program.getIntermediate(stage), spirv, &logger, &spvOptions);
+            // TODO: argument
+            // if these options change, bump ShaderCache::FormatVersion
+            spvOptions.generateDebugInfo = true;
+            spvOptions.stripDebugInfo = false;
+
+            spvOptions.disableOptimizer = true;
+            spvOptions.optimizeSize = false;
+            spvOptions.disassemble = false;
+            spvOptions.validate = true;
+            glslang::GlslangToSpv(*program.getIntermediate(stage), spirv, &logger, &spvOptions);
+
+            if(pCache != nullptr) {
+                pCache->put(cacheKey.value(), spirv);
+            }
+        }
 
         {
             std::ofstream outputFile(outputPath, std::ios::binary);
@@ -210,9 +298,9 @@ namespace ShaderCompiler {
             }
             metadata.sourceFiles.push_back(std::filesystem::absolute(inputFile));
 
-            metadata.commandArguments[0] = basePath;
-            metadata.commandArguments[1] = inputFilepath;
-            metadata.commandArguments[2] = outputFilepath;
+            metadata.commandArguments[0] = request.basePath.string();
+            metadata.commandArguments[1] = inputFile.string();
+            metadata.commandArguments[2] = outputPath.string();
             metadata.commandArguments[3] = stageStr;
             metadata.commandArguments[4] = entryPointName;
 
@@ -237,4 +325,40 @@ namespace ShaderCompiler {
         return 0;
     }
 
+    int compileShaders(std::span<const CompileRequest> requests, std::vector<std::vector<std::filesystem::path>>& dependencies, ShaderCache* pCache, std::size_t threadCount) {
+        if(!initializeGlslang()) {
+            std::cerr << "Failed to setup glslang." << std::endl;
+            return -2;
+        }
+
+        dependencies.resize(requests.size());
+        if(threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threadCount = std::min(threadCount, requests.size());
+
+        std::atomic<std::size_t> nextRequest { 0 };
+        std::atomic<int> result { 0 };
+        auto work = [&]() {
+            for(std::size_t i = nextRequest++; i < requests.size(); i = nextRequest++) {
+                const int requestResult = compileShader(requests[i], dependencies[i], pCache);
+                if(requestResult != 0) {
+                    std::cerr << "Failed to compile " << requests[i].inputFile.string() << " (" << requests[i].entryPoint << ")" << std::endl;
+                    int expected = 0;
+                    result.compare_exchange_strong(expected, requestResult);
+                }
+            }
+        };
+
+        std::vector<std::thread> helpers;
+        for(std::size_t i = 1; i < threadCount; i++) {
+            helpers.emplace_back(work);
+        }
+        work(); // calling thread participates
+        for(auto& t : helpers) {
+            t.join();
+        }
+        return result.load();
+    }
+
 }
\ No newline at end of file
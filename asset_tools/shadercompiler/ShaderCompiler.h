@@ -4,8 +4,12 @@
 
 #pragma once
 #include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
 
 namespace ShaderCompiler {
+    class ShaderCache;
 
     enum class Stage {
         Vertex,
@@ -19,7 +23,28 @@ namespace ShaderCompiler {
         RayClosestHit,
     };
 
+    /// Parses the stage names used on the command line ("vertex", "fragment", "compute", etc.). Returns false if unknown
+    bool parseStage(const char* stageStr, Stage& outStage);
+
+    struct CompileRequest {
+        std::filesystem::path basePath; //< <source folder>/resources/shaders, root of system includes
+        std::filesystem::path inputFile;
+        std::filesystem::path outputFile;
+        Stage stage = Stage::Fragment;
+        std::string entryPoint = "main";
+        std::vector<std::string> defines; //< "NAME" or "NAME=VALUE"
+    };
+
     std::string createCompiledShaderName(const char* shaderFilename, const char* entryPointName);
 
     int compileShader(const char* basePath, const char* inputFilepath, const char* outputFilepath, Stage stage, std::vector<std::filesystem::path>& dependencies, const char* entryPointName);
+
+    /// Compiles a single shader, and writes its SPIR-V and metadata next to request.outputFile.
+    /// If 'pCache' is not null, the SPIR-V is reused from the cache when the preprocessed source did not change.
+    /// Included files are added to 'dependencies'. Returns 0 on success
+    int compileShader(const CompileRequest& request, std::vector<std::filesystem::path>& dependencies, ShaderCache* pCache);
+
+    /// Compiles all 'requests' in parallel, on 'threadCount' threads (0 for one per hardware thread), inside this process.
+    /// dependencies[i] receives the included files of requests[i]. Returns 0 if all compilations succeeded
+    int compileShaders(std::span<const CompileRequest> requests, std::vector<std::vector<std::filesystem::path>>& dependencies, ShaderCache* pCache, std::size_t threadCount);
 }
@@ -7,18 +7,25 @@
 #include <string>
 #include <fstream>
 #include <filesystem>
+#include <memory>
+#include <set>
+#include <sstream>
 #include "FileIncluder.h"
 #include <core/data/ShaderMetadata.h>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/filewritestream.h>
 #include <core/utils/stringmanip.h>
 
 // imports from glslang
 #include "ShaderCompiler.h"
+#include "ShaderCache.h"
+#include "Depfile.h"
 
 void showUsage() {
     std::cerr <<
-        "shadercompiler [base path] [input file] [output file] [stage] (entry point)" << '\n'
+        "shadercompiler [options] [base path] [input file] [output file] [stage] (entry point)" << '\n'
         << "\tCompiles a shader and write additional metadata next to the output." << '\n'
         << "\t\t- [base path]: Path to <source folder>/resources/shaders" << '\n'
         << "\t\t- [input file]: Path of file inside <source folder>/resources/shaders to compile" << '\n'
@@ -26,63 +33,174 @@ void showUsage() {
         << "\t\t- [stage]: Shader type to add" << '\n'
         << "\t\t- (entry point): Name of entry point, defaults to 'main'" << '\n'
         << '\n'
+        << "shadercompiler [options] --batch [manifest] [depfile]" << '\n'
+        << "\tCompiles all shaders listed inside [manifest] in parallel, and writes a depfile covering all of them to [depfile]." << '\n'
+        << "\tShaders which are more recent than their dependencies and the manifest are not recompiled." << '\n'
+        << "\t\t- [manifest]: JSON file, of the form { \"shaders\": [ { \"base_path\", \"input\", \"output\", \"stage\", \"entry_point\" (optional), \"defines\" (optional) } ] }" << '\n'
+        << '\n'
+        << "Options:" << '\n'
+        << "\t--cache [folder]: Reuses SPIR-V from [folder] when the preprocessed source of a shader did not change" << '\n'
+        << "\t--jobs [count]: Thread count for batch compilations, defaults to one per hardware thread" << '\n'
         << std::endl;
 }
 
+static std::filesystem::path getDepfilePath(const std::filesystem::path& outputFile) {
+    std::filesystem::path depfilePath = outputFile;
+    depfilePath.replace_extension(".spv.d");
+    return depfilePath;
+}
+
+static bool readManifest(const std::filesystem::path& manifestPath, std::vector<ShaderCompiler::CompileRequest>& requests) {
+    std::ifstream stream{ manifestPath, std::ios::binary | std::ios::in };
+    if(!stream) {
+        std::cerr << "Could not open manifest " << manifestPath.string() << std::endl;
+        return false;
+    }
+    std::stringstream contents;
+    contents << stream.rdbuf();
+
+    rapidjson::Document d;
+    d.Parse(contents.str().c_str());
+    if(d.HasParseError()) {
+        std::cerr << rapidjson::GetParseError_En(d.GetParseError()) << std::endl;
+        return false;
+    }
+
+    auto shadersIter = d.FindMember("shaders");
+    if(!d.IsObject() || shadersIter == d.MemberEnd() || !shadersIter->value.IsArray()) {
+        std::cerr << "Manifest is missing 'shaders' array" << std::endl;
+        return false;
+    }
+
+    for(const auto& entry : shadersIter->value.GetArray()) {
+        for(const char* requiredMember : { "base_path", "input", "output", "stage" }) {
+            if(!entry.HasMember(requiredMember)) {
+                std::cerr << "Manifest entry is missing '" << requiredMember << "' field" << std::endl;
+                return false;
+            }
+        }
+
+        ShaderCompiler::CompileRequest& request = requests.emplace_back();
+        request.basePath = entry["base_path"].GetString();
+        request.inputFile = entry["input"].GetString();
+        request.outputFile = entry["output"].GetString();
+        if(!ShaderCompiler::parseStage(entry["stage"].GetString(), request.stage)) {
+            std::cerr << "Invalid stage: " << entry["stage"].GetString() << std::endl;
+            return false;
+        }
+        if(entry.HasMember("entry_point")) {
+            request.entryPoint = entry["entry_point"].GetString();
+        }
+        if(entry.HasMember("defines")) {
+            for(const auto& define : entry["defines"].GetArray()) {
+                request.defines.emplace_back(define.GetString());
+            }
+        }
+    }
+    return true;
+}
+
+static int compileBatch(const std::filesystem::path& manifestPath, const std::filesystem::path& batchDepfilePath, ShaderCompiler::ShaderCache* pCache, std::size_t jobCount) {
+    std::vector<ShaderCompiler::CompileRequest> requests;
+    if(!readManifest(manifestPath, requests)) {
+        return -1;
+    }
+
+    // only recompile shaders which changed since the last run, the others keep the dependencies listed in their depfile
+    std::vector<ShaderCompiler::CompileRequest> toCompile;
+    std::vector<std::vector<std::filesystem::path>> dependencies;
+    dependencies.resize(requests.size());
+    std::vector<std::size_t> compiledIndices;
+    for(std::size_t i = 0; i < requests.size(); i++) {
+        const auto& request = requests[i];
+        const std::filesystem::path depfilePath = getDepfilePath(request.outputFile);
+        const std::array extraInputs { manifestPath, request.inputFile };
+        if(ShaderCompiler::isUpToDate(depfilePath, std::span { &request.outputFile, 1 }, extraInputs)) {
+            dependencies[i] = ShaderCompiler::readDepfile(depfilePath).value();
+            std::filesystem::last_write_time(request.outputFile, std::filesystem::file_time_type::clock::now()); // output is part of this batch, it must look rebuilt
+        } else {
+            toCompile.push_back(request);
+            compiledIndices.push_back(i);
+        }
+    }
+
+    std::vector<std::vector<std::filesystem::path>> compiledDependencies;
+    int result = ShaderCompiler::compileShaders(toCompile, compiledDependencies, pCache, jobCount);
+    if(result != 0) {
+        return result;
+    }
+    for(std::size_t i = 0; i < compiledIndices.size(); i++) {
+        const std::size_t requestIndex = compiledIndices[i];
+        auto& requestDependencies = dependencies[requestIndex];
+        requestDependencies = std::move(compiledDependencies[i]);
+        requestDependencies.push_back(requests[requestIndex].inputFile);
+        ShaderCompiler::writeDepfile(getDepfilePath(requests[requestIndex].outputFile), std::span { &requests[requestIndex].outputFile, 1 }, requestDependencies);
+    }
+
+    // depfile of the entire batch (for CMake)
+    std::vector<std::filesystem::path> outputs;
+    std::set<std::filesystem::path> allDependencies;
+    for(std::size_t i = 0; i < requests.size(); i++) {
+        outputs.push_back(requests[i].outputFile);
+        allDependencies.insert(dependencies[i].begin(), dependencies[i].end());
+    }
+    const std::vector<std::filesystem::path> allDependenciesList { allDependencies.begin(), allDependencies.end() };
+    ShaderCompiler::writeDepfile(batchDepfilePath, outputs, allDependenciesList);
+
+    std::cout << "Compiled " << toCompile.size() << " shader(s), " << (requests.size() - toCompile.size()) << " up-to-date." << std::endl;
+    return 0;
+}
+
 int main(int argc, const char** argv) {
-    if(argc < 5) {
+    std::unique_ptr<ShaderCompiler::ShaderCache> pCache;
+    std::size_t jobCount = 0;
+    bool batch = false;
+    std::vector<const char*> positionalArgs;
+    for(int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if(arg == "--cache" && i + 1 < argc) {
+            pCache = std::make_unique<ShaderCompiler::ShaderCache>(argv[++i]);
+        } else if(arg == "--jobs" && i + 1 < argc) {
+            jobCount = std::stoull(argv[++i]);
+        } else if(arg == "--batch") {
+            batch = true;
+        } else {
+            positionalArgs.push_back(argv[i]);
+        }
+    }
+
+    if(batch) {
+        if(positionalArgs.size() != 2) {
+            std::cerr << "Batch mode expects a manifest and a depfile" << std::endl;
+            showUsage();
+            return -1;
+        }
+        return compileBatch(positionalArgs[0], positionalArgs[1], pCache.get(), jobCount);
+    }
+
+    if(positionalArgs.size() < 4) {
         std::cerr << "Missing arguments" << std::endl;
         showUsage();
         return -1;
     }
 
-    const char* basePath = argv[1];
-    const char* filename = argv[2];
-    const char* outFilename = argv[3];
-    const char* stageStr = argv[4];
-    const char* entryPointName = argc >= 6 ? argv[5] : "main";
-
-    ShaderCompiler::Stage stage = ShaderCompiler::Stage::Fragment;
-    if(stricmp(stageStr, "fragment") == 0) {
-        stage = ShaderCompiler::Stage::Fragment;
-    } else if(stricmp(stageStr, "vertex") == 0) {
-        stage = ShaderCompiler::Stage::Vertex;
-    } else if(stricmp(stageStr, "rgen") == 0) {
-        stage = ShaderCompiler::Stage::RayGen;
-    } else if(stricmp(stageStr, "rchit") == 0) {
-        stage = ShaderCompiler::Stage::RayClosestHit;
-    } else if(stricmp(stageStr, "compute") == 0) {
-        stage = ShaderCompiler::Stage::Compute;
-    } else if(stricmp(stageStr, "rmiss") == 0) {
-        stage = ShaderCompiler::Stage::RayMiss;
-    } else if(stricmp(stageStr, "task") == 0) {
-        stage = ShaderCompiler::Stage::Task;
-    } else if(stricmp(stageStr, "mesh") == 0) {
-        stage = ShaderCompiler::Stage::Mesh;
-    } else {
+    const char* stageStr = positionalArgs[3];
+    ShaderCompiler::CompileRequest request {
+        .basePath = positionalArgs[0],
+        .inputFile = positionalArgs[1],
+        .outputFile = positionalArgs[2],
+        .entryPoint = positionalArgs.size() >= 5 ? positionalArgs[4] : "main",
+    };
+
+    if(!ShaderCompiler::parseStage(stageStr, request.stage)) {
         std::cerr << "Invalid stage: " << stageStr << std::endl;
         return -1;
     }
     std::vector<std::filesystem::path> includedFiles;
-    int res = ShaderCompiler::compileShader(basePath, filename, outFilename, stage, includedFiles, entryPointName);
+    int res = ShaderCompiler::compileShader(request, includedFiles, pCache.get());
     if(res == 0) {
         // depfile (for CMake)
-        std::filesystem::path depfilePath = outFilename;
-        depfilePath.replace_extension(".spv.d");
-        std::wofstream outputFile(depfilePath);
-
-        std::filesystem::path relativeOutput = std::filesystem::relative(outFilename, std::filesystem::current_path());
-        outputFile << outFilename << ": ";
-        for(const auto& includedFile : includedFiles) {
-            std::wstring path = includedFile.c_str();
-            // replace separators
-            for(std::size_t i = 0; i < path.size(); i++) {
-                if(path[i] == L'\\') {
-                    path[i] = L'/';
-                }
-            }
-            outputFile << path << " ";
-        }
+        ShaderCompiler::writeDepfile(getDepfilePath(request.outputFile), std::span { &request.outputFile, 1 }, includedFiles);
     }
     return res;
-}
\ No newline at end of file
+}
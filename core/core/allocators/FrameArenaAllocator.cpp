@@ -0,0 +1,250 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "FrameArenaAllocator.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <core/allocators/LowLevelMemoryAllocations.h>
+#include <core/utils/Assert.h>
+
+namespace Carrot {
+    constexpr std::size_t ChunkAlignment = 64;
+    constexpr std::uint64_t NoFrame = std::numeric_limits<std::uint64_t>::max();
+
+    // Chunks go directly through Carrot::alloc/free instead of MallocAllocator::instance: orphaned chunks are freed
+    // during static destruction, possibly after MallocAllocator::instance is destroyed
+    static MemoryBlock allocateChunk(std::size_t size) {
+        return { .ptr = Carrot::alloc(size, ChunkAlignment), .size = size };
+    }
+
+    static void freeChunk(const MemoryBlock& chunk) {
+        Carrot::free(chunk.ptr);
+    }
+
+    /// Memory used by a single thread during a single frame
+    struct Arena {
+        std::vector<MemoryBlock> chunks;
+        std::size_t currentChunk = 0;
+        std::size_t cursor = 0; // inside current chunk
+        void* pLastAllocation = nullptr; // can be grown in-place
+
+        // read by other threads for stats
+        std::atomic<std::uint64_t> frame = NoFrame;
+        std::atomic<std::size_t> usedBytes = 0;
+        std::atomic<std::size_t> reservedBytes = 0;
+
+        ~Arena() {
+            for(const MemoryBlock& chunk : chunks) {
+                freeChunk(chunk);
+            }
+        }
+
+        /// Prepares this arena for a new frame. Previous allocations are lost
+        void reset(std::uint64_t newFrame) {
+            if(chunks.size() > 1) {
+                // merge chunks, to fit the same amount of data in a single chunk next time
+                std::size_t totalSize = 0;
+                for(const MemoryBlock& chunk : chunks) {
+                    totalSize += chunk.size;
+                    freeChunk(chunk);
+                }
+                chunks.clear();
+                chunks.emplace_back(allocateChunk(totalSize));
+                reservedBytes.store(totalSize, std::memory_order_relaxed);
+            }
+            currentChunk = 0;
+            cursor = 0;
+            pLastAllocation = nullptr;
+            usedBytes.store(0, std::memory_order_relaxed);
+            frame.store(newFrame, std::memory_order_relaxed);
+        }
+
+        MemoryBlock allocate(std::size_t size, std::size_t alignment) {
+            for(; currentChunk < chunks.size(); currentChunk++, cursor = 0) {
+                if(void* ptr = tryAllocateInChunk(chunks[currentChunk], size, alignment)) {
+                    return { .ptr = ptr, .size = size };
+                }
+            }
+
+            // no chunk is large enough, allocate a new one
+            const std::size_t previousChunkSize = chunks.empty() ? 0 : chunks.back().size;
+            const std::size_t chunkSize = std::max({ FrameArenaAllocator::DefaultChunkSize, previousChunkSize * 2, size + alignment });
+            chunks.emplace_back(allocateChunk(chunkSize));
+            reservedBytes.fetch_add(chunkSize, std::memory_order_relaxed);
+            currentChunk = chunks.size() - 1;
+            cursor = 0;
+            void* ptr = tryAllocateInChunk(chunks[currentChunk], size, alignment);
+            verify(ptr != nullptr, "New chunk should be large enough");
+            return { .ptr = ptr, .size = size };
+        }
+
+        /// Resizes the latest allocation if it is 'block' and there is enough space in its chunk
+        bool tryResizeInPlace(const MemoryBlock& block, std::size_t newSize) {
+            if(block.ptr == nullptr || block.ptr != pLastAllocation) {
+                return false;
+            }
+            const MemoryBlock& chunk = chunks[currentChunk];
+            const std::size_t offset = static_cast<std::uint8_t*>(block.ptr) - static_cast<std::uint8_t*>(chunk.ptr);
+            if(offset + newSize > chunk.size) {
+                return false;
+            }
+            cursor = offset + newSize;
+            if(newSize > block.size) {
+                usedBytes.fetch_add(newSize - block.size, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+    private:
+        void* tryAllocateInChunk(const MemoryBlock& chunk, std::size_t size, std::size_t alignment) {
+            std::size_t remainingSize = chunk.size - cursor;
+            void* ptr = static_cast<std::uint8_t*>(chunk.ptr) + cursor;
+            if(!std::align(alignment, size, ptr, remainingSize)) {
+                return nullptr;
+            }
+            cursor = chunk.size - remainingSize + size;
+            pLastAllocation = ptr;
+            usedBytes.fetch_add(size, std::memory_order_relaxed);
+            return ptr;
+        }
+    };
+
+    /// Arenas of a single thread, one per frame kept alive
+    struct ThreadArenas {
+        std::array<Arena, FrameArenaAllocator::FrameCount> arenas;
+
+        ThreadArenas();
+        ~ThreadArenas();
+
+        Arena& getArena(std::uint64_t frame) {
+            Arena& arena = arenas[frame % arenas.size()];
+            if(arena.frame.load(std::memory_order_relaxed) != frame) {
+                arena.reset(frame);
+            }
+            return arena;
+        }
+    };
+
+    /// Chunks of a thread which exited, freed once no frame can reference them anymore
+    struct OrphanedChunk {
+        MemoryBlock chunk;
+        std::uint64_t lastUseFrame = 0;
+    };
+
+    struct OrphanedChunkList: std::vector<OrphanedChunk> {
+        ~OrphanedChunkList() {
+            // program exit
+            for(const OrphanedChunk& orphan : *this) {
+                freeChunk(orphan.chunk);
+            }
+        }
+    };
+
+    static std::mutex RegistryAccess;
+    static std::vector<ThreadArenas*> RegisteredThreads;
+    static OrphanedChunkList OrphanedChunks;
+
+    static thread_local ThreadArenas CurrentThreadArenas;
+
+    ThreadArenas::ThreadArenas() {
+        std::lock_guard l { RegistryAccess };
+        RegisteredThreads.push_back(this);
+    }
+
+    ThreadArenas::~ThreadArenas() {
+        std::lock_guard l { RegistryAccess };
+        std::erase(RegisteredThreads, this);
+
+        // memory of this thread may still be used by other threads, until its frame is over
+        const std::uint64_t currentFrame = FrameArenaAllocator::get().getCurrentFrame();
+        for(Arena& arena : arenas) {
+            for(const MemoryBlock& chunk : arena.chunks) {
+                OrphanedChunks.push_back({ chunk, currentFrame });
+            }
+            arena.chunks.clear();
+        }
+    }
+
+    FrameArenaAllocator& FrameArenaAllocator::get() {
+        static FrameArenaAllocator instance;
+        return instance;
+    }
+
+    void FrameArenaAllocator::newFrame() {
+        const std::uint64_t endingFrame = currentFrame.load();
+
+        std::lock_guard l { RegistryAccess };
+        std::size_t frameBytes = 0;
+        for(ThreadArenas* pThreadArenas : RegisteredThreads) {
+            const Arena& arena = pThreadArenas->arenas[endingFrame % FrameCount];
+            if(arena.frame.load(std::memory_order_relaxed) == endingFrame) {
+                frameBytes += arena.usedBytes.load(std::memory_order_relaxed);
+            }
+        }
+        previousFrameBytes = frameBytes;
+        highWaterMark = std::max(highWaterMark.load(), frameBytes);
+
+        const std::uint64_t newFrameIndex = endingFrame + 1;
+        std::erase_if(OrphanedChunks, [&](const OrphanedChunk& orphan) {
+            if(orphan.lastUseFrame + FrameCount <= newFrameIndex) {
+                freeChunk(orphan.chunk);
+                return true;
+            }
+            return false;
+        });
+        currentFrame = newFrameIndex;
+    }
+
+    std::uint64_t FrameArenaAllocator::getCurrentFrame() const {
+        return currentFrame.load();
+    }
+
+    FrameArenaAllocator::Stats FrameArenaAllocator::getStats() const {
+        const std::uint64_t frame = currentFrame.load();
+        Stats stats;
+        stats.previousFrameBytes = previousFrameBytes.load();
+        stats.highWaterMark = highWaterMark.load();
+
+        std::lock_guard l { RegistryAccess };
+        stats.threadCount = RegisteredThreads.size();
+        for(const ThreadArenas* pThreadArenas : RegisteredThreads) {
+            for(const Arena& arena : pThreadArenas->arenas) {
+                stats.reservedBytes += arena.reservedBytes.load(std::memory_order_relaxed);
+                if(arena.frame.load(std::memory_order_relaxed) == frame) {
+                    stats.currentFrameBytes += arena.usedBytes.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        stats.highWaterMark = std::max(stats.highWaterMark, stats.currentFrameBytes);
+        return stats;
+    }
+
+    MemoryBlock FrameArenaAllocator::allocate(std::size_t size, std::size_t alignment) {
+        if(size == 0) {
+            return {};
+        }
+        return CurrentThreadArenas.getArena(currentFrame.load(std::memory_order_relaxed)).allocate(size, alignment);
+    }
+
+    void FrameArenaAllocator::deallocate([[maybe_unused]] const MemoryBlock& block) {
+        // memory is reclaimed when the arena is reused
+    }
+
+    MemoryBlock FrameArenaAllocator::reallocate(const MemoryBlock& block, const std::size_t size, std::size_t alignment) {
+        Arena& arena = CurrentThreadArenas.getArena(currentFrame.load(std::memory_order_relaxed));
+        if(arena.tryResizeInPlace(block, size)) {
+            return { .ptr = block.ptr, .size = size };
+        }
+        return Allocator::reallocate(block, size, alignment);
+    }
+
+    bool FrameArenaAllocator::isCompatibleWith(const Allocator& other) const {
+        return this == &other;
+    }
+}
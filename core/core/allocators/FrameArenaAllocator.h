@@ -0,0 +1,79 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <core/Allocator.h>
+
+namespace Carrot {
+    /**
+     * \brief Allocator for transient data which does not need to outlive the next few frames (render packets, temporary arrays, etc.)
+     * Each thread allocates from its own arenas (one per frame kept alive), so there is no contention between threads.
+     * Memory allocated during frame N stays valid until the start of frame N + FrameCount, where the arena of frame N
+     * is reused by its thread. Deallocations do nothing, and reallocating the latest allocation of a thread grows it in-place.
+     *
+     * Memory can be freed and reallocated by a different thread than the one which allocated it.
+     * Arenas which required multiple chunks during a frame are merged into a single chunk when they are reused, so that
+     * steady-state frames only bump a pointer.
+     */
+    class FrameArenaAllocator: public Allocator {
+    public:
+        /// How many frames an allocation survives. Must cover the frames in flight, plus the frame being prepared.
+        constexpr static std::size_t FrameCount = 4;
+
+        /// Size of the first chunk of each arena
+        constexpr static std::size_t DefaultChunkSize = 64 * 1024;
+
+        struct Stats {
+            /// Bytes allocated (all threads) since the start of the current frame
+            std::size_t currentFrameBytes = 0;
+
+            /// Bytes allocated (all threads) during the previous frame
+            std::size_t previousFrameBytes = 0;
+
+            /// Highest number of bytes allocated during a single frame (all threads)
+            std::size_t highWaterMark = 0;
+
+            /// Memory reserved by arenas, all frames and threads included
+            std::size_t reservedBytes = 0;
+
+            /// Threads which allocated from this allocator and are still alive
+            std::size_t threadCount = 0;
+        };
+
+    public:
+        /// The allocator shared by the whole program
+        static FrameArenaAllocator& get();
+
+        /**
+         * \brief Starts a new frame. Call once per frame, at the beginning of the frame.
+         * Threads reuse the arena of frame (N - FrameCount) on their first allocation of frame N
+         */
+        void newFrame();
+
+        std::uint64_t getCurrentFrame() const;
+
+        Stats getStats() const;
+
+    public:
+        MemoryBlock allocate(std::size_t size, std::size_t alignment = 1) override;
+
+        /// Does nothing, memory is reclaimed when the arena is reused
+        void deallocate(const MemoryBlock& block) override;
+
+        MemoryBlock reallocate(const MemoryBlock& block, const std::size_t size, std::size_t alignment = 1) override;
+
+        /// All threads allocate from the same instance, memory can be moved between containers using it
+        bool isCompatibleWith(const Allocator& other) const override;
+
+    private:
+        FrameArenaAllocator() = default;
+
+        std::atomic<std::uint64_t> currentFrame = 0;
+        std::atomic<std::size_t> highWaterMark = 0;
+        std::atomic<std::size_t> previousFrameBytes = 0;
+    };
+}
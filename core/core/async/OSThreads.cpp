@@ -11,6 +11,7 @@
 
 #elif __has_include(<unistd.h>)
 #include <unistd.h>
+#include <pthread.h>
 #endif
 
 namespace Carrot::Threads {
@@ -45,8 +46,10 @@ namespace Carrot::Threads {
         HRESULT hr = SetThreadDescription(static_cast<HANDLE>(nativeHandle), description);
         verify(!FAILED(hr), "Failed to set thread name");
 #elif __has_include(<unistd.h>)
-        auto handle = thread.native_handle();
-        pthread_setname_np(handle, name.data());
+        // names are limited to 16 characters (including the null terminator) on Linux
+        char shortName[16] {};
+        name.copy(shortName, sizeof(shortName) - 1);
+        pthread_setname_np(reinterpret_cast<pthread_t>(nativeHandle), shortName);
 #else
 #error "Don't know how to set thread name on this OS. Please fix."
 #endif
@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
 #include <functional>
+#include <memory>
 #include <optional>
-#include <list>
-#include <xhash>
+#include <vector>
 #include <cider/Mutex.h>
 
 #include "core/Macros.h"
@@ -19,18 +23,91 @@ namespace Carrot::Async {
     ///  Access to different keys can be done in multiple threads, with minimal blocking.
     ///  Access to the same key can be done in multiple threads, but will block if generation started
     ///  Once created, values are never moved. Erase a value via its key and then re-set a value
+    ///  Keys are spread over 'ShardCount' independent shards, each with its own lock: inserting a key only blocks
+    ///  accesses to keys of the same shard, and reading an already computed value never waits on a generator.
+    ///  Each shard is an open-addressing table (linear probing) storing the hash of its keys, so keys are hashed only
+    ///  once per access and never rehashed when the table grows.
     /// KeyType: must be hashable
     /// ValueType: must meet std::is_move_constructible_v
-    template<typename KeyType, typename ValueType> requires Concepts::IsMoveable<ValueType> && Concepts::Hashable<KeyType>
+    template<typename KeyType, typename ValueType, std::size_t ShardCount = 64> requires Concepts::IsMoveable<ValueType> && Concepts::Hashable<KeyType>
     class ParallelMap {
-        using Hash = std::size_t;
+        static_assert(std::has_single_bit(ShardCount), "ShardCount must be a power of 2");
 
         struct Node {
+            explicit Node(const KeyType& key): key(key) {}
+
             Cider::Mutex nodeAccess;
 
+            /// Set once 'value' is written, to read it without taking 'nodeAccess'
+            std::atomic<bool> ready = false;
+            const KeyType key;
             std::optional<ValueType> value;
         };
 
+        /// Aligned to avoid false sharing between the locks of different shards
+        struct alignas(64) Shard {
+            mutable Async::ReadWriteLock access{};
+
+            // open-addressing table, size is 0 or a power of 2. Nodes are allocated separately, so that they never move
+            // Nodes are only removed on clear, so there is no need for tombstones
+            std::vector<std::size_t> hashes{};
+            std::vector<std::unique_ptr<Node>> nodes{};
+            std::size_t nodeCount = 0;
+
+            /// Returns the node of the given key, or nullptr if there is none
+            Node* find(std::size_t hash, const KeyType& key) const {
+                if(nodes.empty()) {
+                    return nullptr;
+                }
+                const std::size_t mask = nodes.size() - 1;
+                for(std::size_t slot = hash & mask; nodes[slot]; slot = (slot + 1) & mask) {
+                    if(hashes[slot] == hash && nodes[slot]->key == key) {
+                        return nodes[slot].get();
+                    }
+                }
+                return nullptr;
+            }
+
+            /// Adds a node for a key which is not already inside this shard
+            Node& insert(std::size_t hash, const KeyType& key) {
+                // keep load factor under 1/2 to keep probe sequences short
+                if((nodeCount + 1) * 2 > nodes.size()) {
+                    grow();
+                }
+                const std::size_t mask = nodes.size() - 1;
+                std::size_t slot = hash & mask;
+                while(nodes[slot]) {
+                    slot = (slot + 1) & mask;
+                }
+                hashes[slot] = hash;
+                nodes[slot] = std::make_unique<Node>(key);
+                nodeCount++;
+                return *nodes[slot];
+            }
+
+            void grow() {
+                std::vector<std::size_t> oldHashes = std::move(hashes);
+                std::vector<std::unique_ptr<Node>> oldNodes = std::move(nodes);
+                const std::size_t newSize = std::max<std::size_t>(16, oldNodes.size() * 2);
+                hashes.assign(newSize, 0);
+                nodes.clear();
+                nodes.resize(newSize);
+
+                const std::size_t mask = newSize - 1;
+                for(std::size_t i = 0; i < oldNodes.size(); i++) {
+                    if(!oldNodes[i]) {
+                        continue;
+                    }
+                    std::size_t slot = oldHashes[i] & mask;
+                    while(nodes[slot]) {
+                        slot = (slot + 1) & mask;
+                    }
+                    hashes[slot] = oldHashes[i];
+                    nodes[slot] = std::move(oldNodes[i]);
+                }
+            }
+        };
+
         template<bool isConst>
         class Snapshot {
         public:
@@ -50,7 +127,7 @@ namespace Carrot::Async {
 
         private:
             std::vector<ElementType> keyValuePairs;
-            friend class ParallelMap<KeyType, ValueType>;
+            friend class ParallelMap<KeyType, ValueType, ShardCount>;
         };
 
     public:
@@ -61,211 +138,204 @@ namespace Carrot::Async {
         ParallelMap() = default;
 
         /// Gets the value corresponding to the given key. If no such value exists, the value is created via generator.
-        ValueType& getOrCompute(const KeyType& key, std::function<ValueType()> generator) {
-            Node* existingNode = nullptr;
-            {
-                Async::LockGuard l { storageAccess.read() };
-                auto iter = storage.find(key);
-                if(iter != storage.end()) {
-                    auto& node = iter->second;
-                    if(node.value.has_value()) {
-                        return node.value.value();
-                    } else {
-                        existingNode = &node;
-                    }
-                }
+        ///  The generator is called at most once per key, even if multiple threads request the same key at once.
+        template<typename Generator> requires std::invocable<Generator>
+        ValueType& getOrCompute(const KeyType& key, Generator&& generator) {
+            Node& node = getOrCreateNode(key);
+            if(node.ready.load(std::memory_order_acquire)) {
+                return node.value.value();
             }
 
-            // Value does not exist
-            {
-                auto& writeLock = storageAccess.write();
-                writeLock.lock();
-
-                // node might have been created by another thread
-                if(!existingNode) {
-                    auto iter = storage.find(key);
-                    if(iter != storage.end()) {
-                        existingNode = &iter->second;
-                    }
-                }
-
-                // insert empty node
-                if(!existingNode) {
-                    existingNode = &storage[key];
-                    existingNode->value = {};
-                }
-
-                writeLock.unlock();
-                Cider::BlockingMutexGuard l { existingNode->nodeAccess };
-
-                if(existingNode->value.has_value()) {
-                    return existingNode->value.value();
-                }
-
-                existingNode->value = std::move(generator());
-
-                return existingNode->value.value();
-            }
-        }
-
-        /// Sets the value corresponding to the given key. If no such value exists, the node is created.
-        void replace(const KeyType& key, ValueType&& newValue) {
-            {
-                Async::LockGuard l { storageAccess.read() };
-                auto iter = storage.find(key);
-                if(iter != storage.end()) {
-                    auto& node = iter->second;
-                    Cider::BlockingMutexGuard l2 { node.nodeAccess };
-                    node.value = std::move(newValue);
-                    return;
-                }
-            }
-
-            Node* existingNode = nullptr;
-            auto& writeLock = storageAccess.write();
-            writeLock.lock();
-
-            // node might have been created by another thread
-            auto iter = storage.find(key);
-            if(iter != storage.end()) {
-                existingNode = &iter->second;
-            }
-
-            // insert empty node
-            if(!existingNode) {
-                existingNode = &storage[key];
-                existingNode->value = {};
-            }
-
-            writeLock.unlock();
-            Cider::BlockingMutexGuard l { existingNode->nodeAccess };
-
-            existingNode->value = std::move(newValue);
+            Cider::BlockingMutexGuard l { node.nodeAccess };
+            return computeIfMissing(node, generator);
         }
 
         /// Gets the value corresponding to the given key. If no such value exists, the value is created via generator.
-        ValueType& getOrCompute(Cider::FiberHandle& fiberHandle, const KeyType& key, std::function<ValueType()> generator) {
-            Node* existingNode = nullptr;
-            {
-                Async::LockGuard l { storageAccess.read() };
-                auto iter = storage.find(key);
-                if(iter != storage.end()) {
-                    auto& node = iter->second;
-                    if(node.value.has_value()) {
-                        return node.value.value();
-                    } else {
-                        existingNode = &node;
-                    }
-                }
+        ///  The generator is called at most once per key, even if multiple threads request the same key at once.
+        ///  Yields the given fiber while another task generates the value.
+        template<typename Generator> requires std::invocable<Generator>
+        ValueType& getOrCompute(Cider::FiberHandle& fiberHandle, const KeyType& key, Generator&& generator) {
+            Node& node = getOrCreateNode(key);
+            if(node.ready.load(std::memory_order_acquire)) {
+                return node.value.value();
             }
 
-            // Value does not exist
-            {
-                auto& writeLock = storageAccess.write();
-                writeLock.lock();
-
-                // node might have been created by another thread
-                if(!existingNode) {
-                    auto iter = storage.find(key);
-                    if(iter != storage.end()) {
-                        existingNode = &iter->second;
-                    }
-                }
-
-                // insert empty node
-                if(!existingNode) {
-                    existingNode = &storage[key];
-                    existingNode->value = {};
-                }
-
-                writeLock.unlock();
-                Cider::LockGuard l { fiberHandle, existingNode->nodeAccess };
-
-                if(existingNode->value.has_value()) {
-                    return existingNode->value.value();
-                }
-
-                existingNode->value = std::move(generator());
+            Cider::LockGuard l { fiberHandle, node.nodeAccess };
+            return computeIfMissing(node, generator);
+        }
 
-                return existingNode->value.value();
+        /// Sets the value corresponding to the given key. If no such value exists, the node is created.
+        void replace(const KeyType& key, ValueType&& newValue) {
+            Node& node = getOrCreateNode(key);
+            Cider::BlockingMutexGuard l { node.nodeAccess };
+            if(!node.ready.load(std::memory_order_relaxed)) {
+                valueCount++;
             }
+            node.value = std::move(newValue);
+            node.ready.store(true, std::memory_order_release);
         }
 
         /// Removes the value corresponding to the given key. If no such value exists, returns false. Returns true otherwise.
         bool remove(const KeyType& key) {
-            Async::LockGuard l { storageAccess.write() };
-            auto iter = storage.find(key);
-            if(iter != storage.end()) {
-                auto& node = iter->second;
+            const std::size_t hash = hashKey(key);
+            Shard& shard = getShard(hash);
+            Async::LockGuard l { shard.access.write() };
+            if(Node* pNode = shard.find(hash, key)) {
+                auto& node = *pNode;
                 Cider::BlockingMutexGuard l1 { node.nodeAccess };
                 bool result = node.value.has_value();
+                if(result) {
+                    valueCount--;
+                }
+                node.ready.store(false, std::memory_order_relaxed);
                 node.value.reset();
                 return result;
             }
             return false;
         }
 
+        /// Returns the value corresponding to the given key, or nullptr if there is none (or if it is being generated)
         ValueType* find(const KeyType& key) {
-            Async::LockGuard l{storageAccess.read()};
-            auto iter = storage.find(key);
-            if(iter == storage.end()) {
+            const std::size_t hash = hashKey(key);
+            Shard& shard = getShard(hash);
+            Async::LockGuard l { shard.access.read() };
+            Node* pNode = shard.find(hash, key);
+            if(!pNode || !pNode->ready.load(std::memory_order_acquire)) {
                 return nullptr;
             }
-            return &iter->second.value.value();
+            return &pNode->value.value();
         }
 
+        /// Returns the value corresponding to the given key, or nullptr if there is none (or if it is being generated)
         const ValueType* find(const KeyType& key) const {
-            Async::LockGuard l { storageAccess.read() };
-            auto iter = storage.find(key);
-            if(iter == storage.end()) {
+            const std::size_t hash = hashKey(key);
+            const Shard& shard = getShard(hash);
+            Async::LockGuard l { shard.access.read() };
+            Node* pNode = shard.find(hash, key);
+            if(!pNode || !pNode->ready.load(std::memory_order_acquire)) {
                 return nullptr;
             }
-            return &iter->second.value.value();
+            return &pNode->value.value();
+        }
+
+        /// How many values are inside this map. Approximate if other threads modify the map at the same time
+        std::size_t size() const {
+            return valueCount.load(std::memory_order_relaxed);
         }
 
         /// Provides a copy of this map's contents. Can be used to iterate over this structure
+        ///  Shards are locked one at a time, so concurrent modifications can be partially visible.
         NonConstSnapshot snapshot() {
-            Async::LockGuard l { storageAccess.read() };
-
             NonConstSnapshot result;
-            result.keyValuePairs.reserve(storage.size());
-            for(auto& [key, node] : storage) {
-                if(node.value.has_value()) {
-                    result.keyValuePairs.emplace_back(key, &node.value.value());
-                }
-            }
-            result.keyValuePairs.shrink_to_fit();
-
+            fillSnapshot(*this, result);
             return result;
         }
 
         /// Provides a copy of this map's contents. Can be used to iterate over this structure
+        ///  Shards are locked one at a time, so concurrent modifications can be partially visible.
         ConstSnapshot snapshot() const {
-            Async::LockGuard l { storageAccess.read() };
-
             ConstSnapshot result;
-            result.keyValuePairs.reserve(storage.size());
-            for(auto& [key, node] : storage) {
-                if(node.value.has_value()) {
-                    result.keyValuePairs.emplace_back(key, &node.value.value());
+            fillSnapshot(*this, result);
+            return result;
+        }
+
+        void clear() {
+            for(Shard& shard : shards) {
+                Async::LockGuard g { shard.access.write() };
+                for(auto& pNode : shard.nodes) {
+                    if(!pNode) {
+                        continue;
+                    }
+                    Cider::BlockingMutexGuard g2 { pNode->nodeAccess };
+                    if(pNode->value.has_value()) {
+                        valueCount--;
+                    }
+                    pNode->ready.store(false, std::memory_order_relaxed);
+                    pNode->value.reset();
                 }
+                shard.hashes.clear();
+                shard.nodes.clear();
+                shard.nodeCount = 0;
             }
-            result.keyValuePairs.shrink_to_fit();
+        }
 
-            return result;
+    private:
+        static std::size_t hashKey(const KeyType& key) {
+            // std::hash is the identity for integers: mix the bits (murmur3 finalizer), the highest bits select the
+            // shard and the lowest bits select the slot inside the shard
+            std::uint64_t hash = static_cast<std::uint64_t>(std::hash<KeyType>{}(key));
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return static_cast<std::size_t>(hash);
         }
 
-        void clear() {
-            Async::LockGuard g { storageAccess.write() };
-            for(auto& [key, node] : storage) {
-                Cider::BlockingMutexGuard g2 { node.nodeAccess };
-                node.value.reset();
+        Shard& getShard(std::size_t hash) {
+            return shards[getShardIndex(hash)];
+        }
+
+        const Shard& getShard(std::size_t hash) const {
+            return shards[getShardIndex(hash)];
+        }
+
+        static std::size_t getShardIndex(std::size_t hash) {
+            constexpr std::size_t ShardBits = std::countr_zero(ShardCount);
+            if constexpr (ShardBits == 0) {
+                return 0;
+            } else {
+                return static_cast<std::size_t>(static_cast<std::uint64_t>(hash) >> (64 - ShardBits));
+            }
+        }
+
+        /// Finds the node of the given key, or inserts an empty one. Only the shard of the key is write-locked, and only on insertion
+        Node& getOrCreateNode(const KeyType& key) {
+            const std::size_t hash = hashKey(key);
+            Shard& shard = getShard(hash);
+            {
+                Async::LockGuard l { shard.access.read() };
+                if(Node* pNode = shard.find(hash, key)) {
+                    return *pNode;
+                }
+            }
+
+            // node might have been created by another thread in-between
+            Async::LockGuard l { shard.access.write() };
+            if(Node* pNode = shard.find(hash, key)) {
+                return *pNode;
+            }
+            return shard.insert(hash, key);
+        }
+
+        /// Must be called with node.nodeAccess locked
+        template<typename Generator>
+        ValueType& computeIfMissing(Node& node, Generator& generator) {
+            if(node.ready.load(std::memory_order_relaxed)) {
+                return node.value.value();
+            }
+
+            node.value = generator();
+            valueCount++;
+            node.ready.store(true, std::memory_order_release);
+            return node.value.value();
+        }
+
+        template<typename Self, typename SnapshotType>
+        static void fillSnapshot(Self& self, SnapshotType& result) {
+            result.keyValuePairs.reserve(self.size());
+            for(auto& shard : self.shards) {
+                Async::LockGuard l { shard.access.read() };
+                for(auto& pNode : shard.nodes) {
+                    if(pNode && pNode->ready.load(std::memory_order_acquire)) {
+                        result.keyValuePairs.emplace_back(pNode->key, &pNode->value.value());
+                    }
+                }
             }
-            storage.clear();
         }
 
     private:
-        mutable Async::ReadWriteLock storageAccess{};
-        std::unordered_map<KeyType, Node> storage{};
+        std::array<Shard, ShardCount> shards{};
+        std::atomic<std::size_t> valueCount = 0;
     };
-}
\ No newline at end of file
+}
@@ -4,9 +4,10 @@
 
 #pragma once
 
+#include <cmath>
 #include <core/Allocator.h>
 #include <core/containers/Vector.hpp>
-#include <core/UniquePtr.hpp>
+#include <glm/vec3.hpp>
 
 namespace Carrot {
     template<typename T>
@@ -18,12 +19,19 @@ namespace Carrot {
     /**
      * \brief Binary Space Partitioning tree mostly used for neighbor searches. Elements are expected to outlive this tree!
      * Also, all methods return indices to the input elements
+     *
+     * Nodes are stored in a single array (in pre-order, the left child of a node is right after it), and leaves hold
+     * buckets of up to 'LeafSize' elements, whose positions are stored contiguously to be tested with SIMD.
+     * The build is parallel (via Carrot::Async::parallelFor, when available), and queries are thread-safe.
      * \tparam TElement Element type to store inside this tree. Must match concept 'HasSpatialInfo'
      */
     template<typename TElement>
     requires HasSpatialInfo<TElement>
     class KDTree {
     public:
+        /// Max number of elements inside a leaf
+        constexpr static std::size_t LeafSize = 16;
+
         /**
          * \brief Creates an empty K-d tree
          * \param allocator the allocator which will be used for this tree
@@ -52,19 +60,38 @@ namespace Carrot {
         std::int64_t closestNeighbor(const TElement& from, float maxDistance = INFINITY) const;
 
         /**
-         * \brief Finds all elements in this tree that are less than 'maxDistance' in distance to 'from'.
+         * \brief Finds all elements in this tree that are less than 'maxDistance' in distance to 'from' (inclusive).
          * \param out vector where to store the neighbors, not cleared when filled
          * \param from element to search neighbors of
          * \param maxDistance max distance to 'from'
          */
         void getNeighbors(Vector<std::size_t>& out, const TElement& from, float maxDistance) const;
 
+        /**
+         * \brief Finds the 'k' closest elements to 'from', at most 'maxDistance' away.
+         * \param out vector where to store the neighbors, sorted by increasing distance. Not cleared when filled
+         */
+        void getKNearestNeighbors(Vector<std::size_t>& out, const TElement& from, std::size_t k, float maxDistance = INFINITY) const;
+
         /**
          * \brief Finds all elements in this tree that are inside the region defined by min and max.
          * \param out vector where to store the elements, not cleared when filled
          */
         void rangeSearch(Vector<std::size_t>& out, const glm::vec3& min, const glm::vec3& max) const;
 
+        /**
+         * \brief getNeighbors for multiple elements at once, spread over multiple threads.
+         * \param out one vector per query, which is cleared before being filled. Must have the same size as 'queries'
+         */
+        void getNeighborsBatch(std::span<Vector<std::size_t>> out, std::span<const TElement> queries, float maxDistance) const;
+
+        /**
+         * \brief getKNearestNeighbors for multiple elements at once, spread over multiple threads.
+         * \param out 'k' indices per query (row-major), sorted by increasing distance. Missing neighbors are set to -1.
+         *  Must have a size of queries.size() * k
+         */
+        void getKNearestNeighborsBatch(std::span<std::int64_t> out, std::span<const TElement> queries, std::size_t k, float maxDistance = INFINITY) const;
+
     public:
         /**
          * How many elements are in this tree
@@ -78,23 +105,47 @@ namespace Carrot {
 
     private:
         struct Node {
+            glm::vec3 boundsMin; // bounds of the elements inside this node
+            glm::vec3 boundsMax;
+            std::uint32_t begin = 0; // range of elements inside this node
+            std::uint32_t end = 0;
+            std::uint32_t rightChild = 0; // 0 for leaves. Left child is always right after its parent
+        };
+
+        /// Element position, with its index inside the input. Only used during build
+        struct BuildPoint {
+            glm::vec3 position;
             std::size_t elementIndex;
-            glm::vec3 medianPoint;
-            glm::vec3 regionMin;
-            glm::vec3 regionMax;
-            UniquePtr<Node> pLeft = nullptr;
-            UniquePtr<Node> pRight = nullptr;
-            Node* pParent = nullptr;
         };
 
-        void buildInner(Node* pDestination, Carrot::Allocator& tempAllocator, std::span<const TElement> allElements, const Carrot::Vector<std::size_t>& subset, std::size_t depth, const glm::vec3& regionMin, const glm::vec3& regionMax);
-        Node* findClosest(const TElement& element) const;
-        void rangeSearchInner(Vector<std::size_t>& out, const Node* pRoot, const glm::vec3& min, const glm::vec3& max) const;
+        /// Range of points to build starting at a given node
+        struct BuildTask {
+            std::uint32_t nodeIndex;
+            std::uint32_t begin;
+            std::uint32_t end;
+        };
+
+        /// How many nodes are needed for a subtree with 'elementCount' elements
+        static std::size_t computeNodeCount(std::size_t elementCount);
+
+        /// Builds the node 'nodeIndex', and its children. Subtrees with at most 'taskThreshold' elements are added to 'tasks' instead of being built
+        void buildNode(std::span<BuildPoint> points, std::uint32_t nodeIndex, std::uint32_t begin, std::uint32_t end, std::size_t taskThreshold, Vector<BuildTask>* tasks);
+
+        /// Adds elements [begin; end[ which are at most sqrt(maxDistanceSq) away from 'center'
+        void collectInRadius(Vector<std::size_t>& out, std::uint32_t begin, std::uint32_t end, const glm::vec3& center, float maxDistanceSq) const;
+
+        /// Calls 'forEach' for each index in [0; count[, in parallel if possible
+        static void runParallel(std::size_t count, const std::function<void(std::size_t)>& forEach, std::size_t granularity);
 
         Allocator& allocator;
-        Node root;
-        std::size_t elementCount = 0;
+        Vector<Node> nodes;
+
+        // element data, sorted so that the elements of each node are contiguous
+        Vector<float> positionsX;
+        Vector<float> positionsY;
+        Vector<float> positionsZ;
+        Vector<std::size_t> elementIndices;
     };
 }
 
-#include "KDTree.ipp"
\ No newline at end of file
+#include "KDTree.ipp"
@@ -4,18 +4,49 @@
 
 #pragma once
 
-#include <core/allocators/InlineAllocator.h>
-#include <core/allocators/StackAllocator.h>
-#include <core/containers/Vector.hpp>
-#include <core/utils/RNG.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <core/tasks/Tasks.h>
+#include <glm/common.hpp>
 #include <glm/gtx/norm.hpp>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CARROT_KDTREE_SSE 1
+#include <xmmintrin.h>
+#else
+#define CARROT_KDTREE_SSE 0
+#endif
+
 namespace Carrot {
 
 #define KD_TREE_TEMPLATE template<typename TElement> requires HasSpatialInfo<TElement>
 
+    namespace KDTreeDetail {
+        /// Max depth of the traversal stacks. Depth of a tree is log2(size/LeafSize) at most, so this is plenty
+        constexpr std::size_t MaxStackSize = 64;
+
+        /// Squared distance between a point and an AABB (0 if inside)
+        inline float distance2ToBox(const glm::vec3& point, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+            const glm::vec3 closest = glm::clamp(point, boxMin, boxMax);
+            return glm::distance2(point, closest);
+        }
+
+        /// Squared distance between a point and the farthest corner of an AABB
+        inline float farthestDistance2ToBox(const glm::vec3& point, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+            const glm::vec3 farthest = glm::max(glm::abs(point - boxMin), glm::abs(point - boxMax));
+            return glm::length2(farthest);
+        }
+    }
+
     KD_TREE_TEMPLATE
-    KDTree<TElement>::KDTree(Allocator& allocator): allocator(allocator) {}
+    KDTree<TElement>::KDTree(Allocator& allocator): allocator(allocator)
+        , nodes(allocator)
+        , positionsX(allocator)
+        , positionsY(allocator)
+        , positionsZ(allocator)
+        , elementIndices(allocator)
+    {}
 
     KD_TREE_TEMPLATE
     KDTree<TElement>::KDTree(Allocator& allocator, std::span<const TElement> elements): KDTree(allocator) {
@@ -24,223 +55,334 @@ namespace Carrot {
 
     KD_TREE_TEMPLATE
     void KDTree<TElement>::build(std::span<const TElement> elements) {
-        root = {};
-        elementCount = elements.size();
-        Carrot::Vector<std::size_t> allPoints;
-        allPoints.setCapacity(elements.size());
-        for(std::size_t i = 0; i < elements.size(); i++) {
-            allPoints.pushBack(i);
-        }
-        const glm::vec3 regionMin { -INFINITY,-INFINITY,-INFINITY };
-        const glm::vec3 regionMax { +INFINITY,+INFINITY,+INFINITY };
-
-        Carrot::StackAllocator stackAllocator { Carrot::Allocator::getDefault() };
-        buildInner(&root, stackAllocator, elements, allPoints, 0, regionMin, regionMax);
+        verify(elements.size() < std::numeric_limits<std::uint32_t>::max(), "Too many elements for a KDTree");
+        nodes.clear();
+        positionsX.clear();
+        positionsY.clear();
+        positionsZ.clear();
+        elementIndices.clear();
+        if(elements.empty()) {
+            return;
+        }
+
+        Vector<BuildPoint> points { allocator };
+        points.resize(elements.size());
+        runParallel(elements.size(), [&](std::size_t i) {
+            points[i].position = elements[i].getPosition();
+            points[i].elementIndex = i;
+        }, 1024);
+
+        nodes.resize(computeNodeCount(elements.size()));
+
+        // build the top of the tree on this thread, then build the subtrees in parallel
+        // the layout of the subtrees is known in advance, so they can be written to 'nodes' directly
+        constexpr std::size_t TargetTaskCount = 64;
+        const std::size_t taskThreshold = std::max(LeafSize * 16, elements.size() / TargetTaskCount);
+        Vector<BuildTask> tasks { allocator };
+        buildNode(points, 0, 0, static_cast<std::uint32_t>(elements.size()), taskThreshold, &tasks);
+        runParallel(tasks.size(), [&](std::size_t taskIndex) {
+            const BuildTask& task = tasks[taskIndex];
+            buildNode(points, task.nodeIndex, task.begin, task.end, 0, nullptr);
+        }, 1);
+
+        positionsX.resize(elements.size());
+        positionsY.resize(elements.size());
+        positionsZ.resize(elements.size());
+        elementIndices.resize(elements.size());
+        for(std::size_t i = 0; i < points.size(); i++) {
+            positionsX[i] = points[i].position.x;
+            positionsY[i] = points[i].position.y;
+            positionsZ[i] = points[i].position.z;
+            elementIndices[i] = points[i].elementIndex;
+        }
     }
 
     KD_TREE_TEMPLATE
     std::int64_t KDTree<TElement>::closestNeighbor(const TElement& from, float maxDistance) const {
-        Node* closest = findClosest(from);
-        if(closest == nullptr) {
-            return -1;
-        }
-        if(glm::distance2(from.getPosition(), closest->medianPoint) < maxDistance*maxDistance) {
-            return closest->elementIndex;
-        }
-        return -1;
+        std::int64_t result = -1;
+        getKNearestNeighborsBatch(std::span(&result, 1), std::span(&from, 1), 1, maxDistance);
+        return result;
     }
 
     KD_TREE_TEMPLATE
     void KDTree<TElement>::getNeighbors(Vector<std::size_t>& out, const TElement& from, float maxDistance) const {
-        const glm::vec3 pos = from.getPosition();
-        const glm::vec3 min = pos - glm::vec3(maxDistance);
-        const glm::vec3 max = pos + glm::vec3(maxDistance);
-        rangeSearch(out, min, max);
-        // TODO: remove all > maxDistance (range search = hyperrectangle, neighbor search = hypersphere)
+        if(empty()) {
+            return;
+        }
+
+        const glm::vec3 center = from.getPosition();
+        const float maxDistanceSq = maxDistance * maxDistance;
+        std::array<std::uint32_t, KDTreeDetail::MaxStackSize> stack;
+        std::size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while(stackSize > 0) {
+            const std::uint32_t nodeIndex = stack[--stackSize];
+            const Node& node = nodes[nodeIndex];
+            if(KDTreeDetail::distance2ToBox(center, node.boundsMin, node.boundsMax) > maxDistanceSq) {
+                continue;
+            }
+            if(KDTreeDetail::farthestDistance2ToBox(center, node.boundsMin, node.boundsMax) <= maxDistanceSq) {
+                // whole node is inside the sphere
+                for(std::uint32_t i = node.begin; i < node.end; i++) {
+                    out.pushBack(elementIndices[i]);
+                }
+                continue;
+            }
+            if(node.rightChild == 0) {
+                collectInRadius(out, node.begin, node.end, center, maxDistanceSq);
+                continue;
+            }
+            verify(stackSize + 2 <= stack.size(), "KDTree is too deep");
+            stack[stackSize++] = node.rightChild;
+            stack[stackSize++] = nodeIndex + 1;
+        }
     }
 
     KD_TREE_TEMPLATE
-    void KDTree<TElement>::rangeSearch(Vector<std::size_t>& out, const glm::vec3& min, const glm::vec3& max) const {
-        rangeSearchInner(out, &root, min, max);
+    void KDTree<TElement>::getKNearestNeighbors(Vector<std::size_t>& out, const TElement& from, std::size_t k, float maxDistance) const {
+        Vector<std::int64_t> neighbors { allocator };
+        neighbors.resize(k);
+        getKNearestNeighborsBatch(neighbors, std::span(&from, 1), k, maxDistance);
+        for(const std::int64_t neighbor : neighbors) {
+            if(neighbor < 0) {
+                break;
+            }
+            out.pushBack(static_cast<std::size_t>(neighbor));
+        }
     }
 
     KD_TREE_TEMPLATE
-    std::size_t KDTree<TElement>::size() const {
-        return this->elementCount;
+    void KDTree<TElement>::rangeSearch(Vector<std::size_t>& out, const glm::vec3& min, const glm::vec3& max) const {
+        if(empty()) {
+            return;
+        }
+
+        auto isInside = [&](const glm::vec3& p) {
+            return glm::all(glm::greaterThanEqual(p, min)) && glm::all(glm::lessThan(p, max));
+        };
+
+        std::array<std::uint32_t, KDTreeDetail::MaxStackSize> stack;
+        std::size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while(stackSize > 0) {
+            const std::uint32_t nodeIndex = stack[--stackSize];
+            const Node& node = nodes[nodeIndex];
+            if(glm::any(glm::greaterThanEqual(node.boundsMin, max)) || glm::any(glm::lessThan(node.boundsMax, min))) {
+                continue;
+            }
+            if(isInside(node.boundsMin) && isInside(node.boundsMax)) {
+                for(std::uint32_t i = node.begin; i < node.end; i++) {
+                    out.pushBack(elementIndices[i]);
+                }
+                continue;
+            }
+            if(node.rightChild == 0) {
+                for(std::uint32_t i = node.begin; i < node.end; i++) {
+                    if(isInside(glm::vec3 { positionsX[i], positionsY[i], positionsZ[i] })) {
+                        out.pushBack(elementIndices[i]);
+                    }
+                }
+                continue;
+            }
+            verify(stackSize + 2 <= stack.size(), "KDTree is too deep");
+            stack[stackSize++] = node.rightChild;
+            stack[stackSize++] = nodeIndex + 1;
+        }
     }
 
     KD_TREE_TEMPLATE
-    bool KDTree<TElement>::empty() const {
-        return size() == 0;
+    void KDTree<TElement>::getNeighborsBatch(std::span<Vector<std::size_t>> out, std::span<const TElement> queries, float maxDistance) const {
+        verify(out.size() == queries.size(), "Must have one output vector per query");
+        runParallel(queries.size(), [&](std::size_t queryIndex) {
+            out[queryIndex].clear();
+            getNeighbors(out[queryIndex], queries[queryIndex], maxDistance);
+        }, 64);
     }
 
-
     KD_TREE_TEMPLATE
-    void KDTree<TElement>::buildInner(Node* pDestination, Carrot::Allocator& tempAllocator, std::span<const TElement> allElements, const Carrot::Vector<std::size_t>& subset, const std::size_t depth, const glm::vec3& regionMin, const glm::vec3& regionMax) {
-        verify(pDestination != nullptr, "Cannot add to nullptr node");
-        pDestination->regionMin = regionMin;
-        pDestination->regionMax = regionMax;
-        if(subset.size() == 1) {
-            pDestination->elementIndex = *subset.begin();
-            pDestination->medianPoint = allElements[pDestination->elementIndex].getPosition();
-            return;
-        }
-        if(subset.empty()) {
+    void KDTree<TElement>::getKNearestNeighborsBatch(std::span<std::int64_t> out, std::span<const TElement> queries, std::size_t k, float maxDistance) const {
+        verify(out.size() == queries.size() * k, "Output must have 'k' elements per query");
+        std::fill(out.begin(), out.end(), -1);
+        if(empty() || k == 0) {
             return;
         }
 
-        const std::size_t axisIndex = depth % 3;
+        const float maxDistanceSq = maxDistance * maxDistance;
+        runParallel(queries.size(), [&](std::size_t queryIndex) {
+            const glm::vec3 center = queries[queryIndex].getPosition();
+            std::span<std::int64_t> result = out.subspan(queryIndex * k, k);
+
+            // max-heap of the closest elements found so far (squared distance, element index)
+            thread_local std::vector<std::pair<float, std::int64_t>> heap;
+            heap.clear();
+            auto worstDistanceSq = [&]() {
+                return heap.size() < k ? maxDistanceSq : heap.front().first;
+            };
+
+            // nearest child is visited first, to shrink the search radius as fast as possible
+            std::array<std::pair<float, std::uint32_t>, KDTreeDetail::MaxStackSize> stack;
+            std::size_t stackSize = 0;
+            stack[stackSize++] = { KDTreeDetail::distance2ToBox(center, nodes[0].boundsMin, nodes[0].boundsMax), 0 };
+            while(stackSize > 0) {
+                const auto [nodeDistanceSq, nodeIndex] = stack[--stackSize];
+                if(nodeDistanceSq > worstDistanceSq()) {
+                    continue;
+                }
 
-        // find median
-        {
-            Vector<std::size_t> points { tempAllocator };
-            if(subset.size() < 512) {
-                points.setCapacity(subset.size());
-                for(std::size_t pointIndex : subset) {
-                    points.pushBack(pointIndex);
+                const Node& node = nodes[nodeIndex];
+                if(node.rightChild == 0) {
+                    for(std::uint32_t i = node.begin; i < node.end; i++) {
+                        const float distanceSq = glm::distance2(center, glm::vec3 { positionsX[i], positionsY[i], positionsZ[i] });
+                        if(distanceSq > worstDistanceSq()) {
+                            continue;
+                        }
+                        if(heap.size() == k) {
+                            std::pop_heap(heap.begin(), heap.end());
+                            heap.pop_back();
+                        }
+                        heap.emplace_back(distanceSq, static_cast<std::int64_t>(elementIndices[i]));
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                    continue;
                 }
-            } else {
-                points.resize(512);
-                for(std::size_t i = 0; i < 512; i++) {
-                    std::size_t randomIndex = Carrot::RNG::randomFloat(0.0f, subset.size()-1);
-                    points[i] = subset[randomIndex];
+
+                const std::uint32_t leftIndex = nodeIndex + 1;
+                const std::uint32_t rightIndex = node.rightChild;
+                const float leftDistanceSq = KDTreeDetail::distance2ToBox(center, nodes[leftIndex].boundsMin, nodes[leftIndex].boundsMax);
+                const float rightDistanceSq = KDTreeDetail::distance2ToBox(center, nodes[rightIndex].boundsMin, nodes[rightIndex].boundsMax);
+                verify(stackSize + 2 <= stack.size(), "KDTree is too deep");
+                if(leftDistanceSq < rightDistanceSq) {
+                    stack[stackSize++] = { rightDistanceSq, rightIndex };
+                    stack[stackSize++] = { leftDistanceSq, leftIndex };
+                } else {
+                    stack[stackSize++] = { leftDistanceSq, leftIndex };
+                    stack[stackSize++] = { rightDistanceSq, rightIndex };
                 }
             }
-            points.sort([&](const std::size_t& a, const std::size_t& b) {
-                const float posA = allElements[a].getPosition()[axisIndex];
-                const float posB = allElements[b].getPosition()[axisIndex];
-                return posA < posB;
-            });
 
-            pDestination->elementIndex = points[points.size() / 2];
-            pDestination->medianPoint = allElements[pDestination->elementIndex].getPosition();
-        }
+            std::sort_heap(heap.begin(), heap.end());
+            for(std::size_t i = 0; i < heap.size(); i++) {
+                result[i] = heap[i].second;
+            }
+        }, 64);
+    }
 
-        const float split = pDestination->medianPoint[axisIndex];
+    KD_TREE_TEMPLATE
+    std::size_t KDTree<TElement>::size() const {
+        return elementIndices.size();
+    }
 
-        Carrot::Vector<std::size_t> pointsBefore { tempAllocator };
-        Carrot::Vector<std::size_t> pointsAfter { tempAllocator };
-        pointsBefore.setGrowthFactor(2);
-        pointsAfter.setGrowthFactor(2);
+    KD_TREE_TEMPLATE
+    bool KDTree<TElement>::empty() const {
+        return size() == 0;
+    }
 
-        for(std::size_t index : subset) {
-            if(index == pDestination->elementIndex) {
-                continue; // already in tree
+    KD_TREE_TEMPLATE
+    std::size_t KDTree<TElement>::computeNodeCount(std::size_t elementCount) {
+        // nodes are split in halves (left = n/2, right = n - n/2), so subtrees at a given depth only have two possible sizes:
+        // compute the node counts for n and n+1 at once, to avoid visiting the entire tree
+        std::function<std::pair<std::size_t, std::size_t>(std::size_t)> countPair = [&](std::size_t n) -> std::pair<std::size_t, std::size_t> {
+            if(n + 1 <= LeafSize) {
+                return { 1, 1 };
             }
-
-            const glm::vec3 position = allElements[index].getPosition();
-            if(position[axisIndex] < split) {
-                pointsBefore.pushBack(index);
-            } else {
-                pointsAfter.pushBack(index);
+            if(n <= LeafSize) {
+                return { 1, 3 };
             }
-        }
-
-        if(!pointsBefore.empty()) {
-            pDestination->pLeft = makeUnique<Node>(allocator);
-            pDestination->pLeft->pParent = pDestination;
-            glm::vec3 newMax = regionMax;
-            newMax[axisIndex] = split;
-            buildInner(pDestination->pLeft.get(), tempAllocator, allElements, pointsBefore, depth+1, regionMin, newMax);
-        }
-        if(!pointsAfter.empty()) {
-            auto ptr = makeUnique<Node>(allocator);
-            pDestination->pRight = std::move(ptr);
-            pDestination->pRight->pParent = pDestination;
-            glm::vec3 newMin = regionMin;
-            newMin[axisIndex] = split;
-            buildInner(pDestination->pRight.get(), tempAllocator, allElements, pointsAfter, depth+1, newMin, regionMax);
-        }
+            const auto [countHalf, countHalfPlusOne] = countPair(n / 2);
+            if(n % 2 == 0) {
+                return { 1 + 2 * countHalf, 1 + countHalf + countHalfPlusOne };
+            }
+            return { 1 + countHalf + countHalfPlusOne, 1 + 2 * countHalfPlusOne };
+        };
+        return countPair(elementCount).first;
     }
 
     KD_TREE_TEMPLATE
-    typename KDTree<TElement>::Node* KDTree<TElement>::findClosest(const TElement& from) const {
-        if(empty()) {
-            return nullptr;
+    void KDTree<TElement>::buildNode(std::span<BuildPoint> points, std::uint32_t nodeIndex, std::uint32_t begin, std::uint32_t end, std::size_t taskThreshold, Vector<BuildTask>* tasks) {
+        const std::size_t count = end - begin;
+        if(tasks != nullptr && count <= taskThreshold) {
+            tasks->pushBack(BuildTask { nodeIndex, begin, end });
+            return;
         }
 
-        // 1. find leaf with the closest element
-        Node* currentNode = &root;
-        std::size_t depth = 0;
+        Node& node = nodes[nodeIndex];
+        node.begin = begin;
+        node.end = end;
+        node.boundsMin = glm::vec3 { +INFINITY };
+        node.boundsMax = glm::vec3 { -INFINITY };
+        for(std::uint32_t i = begin; i < end; i++) {
+            node.boundsMin = glm::min(node.boundsMin, points[i].position);
+            node.boundsMax = glm::max(node.boundsMax, points[i].position);
+        }
 
-        const float nodePositions[3] = {
-            from.getPosition()[0],
-            from.getPosition()[1],
-            from.getPosition()[2],
-        };
+        if(count <= LeafSize) {
+            node.rightChild = 0;
+            return;
+        }
 
-        const std::size_t maxIterations = size();
-        std::size_t iteration = 0;
-        bool found = false;
-        while(iteration++ < maxIterations) {
-            const std::size_t axisIndex = depth % 3;
-            depth++;
-
-            const float split = currentNode->medianPoint[axisIndex];
-            if(nodePositions[axisIndex] < split) {
-                Node* nextNode = currentNode->pLeft.get();
-                if(nextNode == nullptr) {
-                    found = true;
-                    break; // closest is 'currentNode'
-                } else {
-                    currentNode = nextNode;
-                }
-            } else {
-                Node* nextNode = currentNode->pRight.get();
-                if(nextNode == nullptr) {
-                    found = true;
-                    break; // closest is 'currentNode'
-                } else {
-                    currentNode = nextNode;
-                }
-            }
+        // split along the largest axis, at the median
+        const glm::vec3 extent = node.boundsMax - node.boundsMin;
+        std::size_t axisIndex = 0;
+        if(extent.y > extent[axisIndex]) {
+            axisIndex = 1;
+        }
+        if(extent.z > extent[axisIndex]) {
+            axisIndex = 2;
         }
 
-        verify(found, "Potential infinite loop!");
+        const std::uint32_t leftCount = static_cast<std::uint32_t>(count / 2);
+        const std::uint32_t middle = begin + leftCount;
+        std::nth_element(points.begin() + begin, points.begin() + middle, points.begin() + end, [&](const BuildPoint& a, const BuildPoint& b) {
+            return a.position[axisIndex] < b.position[axisIndex];
+        });
 
-        return currentNode;
+        node.rightChild = static_cast<std::uint32_t>(nodeIndex + 1 + computeNodeCount(leftCount));
+        buildNode(points, nodeIndex + 1, begin, middle, taskThreshold, tasks);
+        buildNode(points, node.rightChild, middle, end, taskThreshold, tasks);
     }
 
     KD_TREE_TEMPLATE
-    void KDTree<TElement>::rangeSearchInner(Vector<std::size_t>& out, const Node* pRoot, const glm::vec3& min, const glm::vec3& max) const {
-        const bool isLeaf = pRoot->pLeft == nullptr && pRoot->pRight == nullptr;
-        if(isLeaf) {
-            if(glm::all(glm::greaterThanEqual(pRoot->medianPoint, min))
-                && glm::all(glm::lessThan(pRoot->medianPoint, max))) {
-                out.pushBack(pRoot->elementIndex);
+    void KDTree<TElement>::collectInRadius(Vector<std::size_t>& out, std::uint32_t begin, std::uint32_t end, const glm::vec3& center, float maxDistanceSq) const {
+        const float* pX = positionsX.data();
+        const float* pY = positionsY.data();
+        const float* pZ = positionsZ.data();
+        std::uint32_t i = begin;
+#if CARROT_KDTREE_SSE
+        // test 4 elements at once
+        const __m128 centerX = _mm_set1_ps(center.x);
+        const __m128 centerY = _mm_set1_ps(center.y);
+        const __m128 centerZ = _mm_set1_ps(center.z);
+        const __m128 radiusSq = _mm_set1_ps(maxDistanceSq);
+        for(; i + 4 <= end; i += 4) {
+            const __m128 dx = _mm_sub_ps(_mm_loadu_ps(pX + i), centerX);
+            const __m128 dy = _mm_sub_ps(_mm_loadu_ps(pY + i), centerY);
+            const __m128 dz = _mm_sub_ps(_mm_loadu_ps(pZ + i), centerZ);
+            const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(distanceSq, radiusSq)));
+            while(mask != 0) {
+                const int lane = std::countr_zero(mask);
+                out.pushBack(elementIndices[i + lane]);
+                mask &= mask - 1;
             }
-        } else {
-            auto regionFullyContained = [&](const Node& node) -> bool {
-                return glm::all(glm::greaterThanEqual(node.regionMin, min))
-                    && glm::all(glm::lessThan(node.regionMax, max));
-            };
-            auto regionIntersects = [&](const Node& node) -> bool {
-                return glm::all(glm::lessThanEqual(node.regionMin, max)) && glm::all(glm::greaterThan(node.regionMax, min));
-            };
-
-            std::function<void(const Node&)> reportSubTree = [&](const Node& node) {
-                out.pushBack(node.elementIndex);
-                if(node.pLeft) {
-                    reportSubTree(*node.pLeft);
-                }
-                if(node.pRight) {
-                    reportSubTree(*node.pRight);
-                }
-            };
-
-            if(pRoot->pLeft) {
-                if(regionFullyContained(*pRoot->pLeft)) {
-                    reportSubTree(*pRoot->pLeft);
-                } else if(regionIntersects(*pRoot->pLeft)) {
-                    rangeSearchInner(out, pRoot->pLeft, min, max);
-                }
+        }
+#endif
+        for(; i < end; i++) {
+            const float dx = pX[i] - center.x;
+            const float dy = pY[i] - center.y;
+            const float dz = pZ[i] - center.z;
+            if(dx * dx + dy * dy + dz * dz <= maxDistanceSq) {
+                out.pushBack(elementIndices[i]);
             }
-            if(pRoot->pRight) {
-                if(regionFullyContained(*pRoot->pRight)) {
-                    reportSubTree(*pRoot->pRight);
-                } else if(regionIntersects(*pRoot->pRight)) {
-                    rangeSearchInner(out, pRoot->pRight, min, max);
-                }
+        }
+    }
+
+    KD_TREE_TEMPLATE
+    void KDTree<TElement>::runParallel(std::size_t count, const std::function<void(std::size_t)>& forEach, std::size_t granularity) {
+        if(Async::parallelFor != nullptr && count > granularity) {
+            Async::parallelFor(count, forEach, granularity);
+        } else {
+            for(std::size_t i = 0; i < count; i++) {
+                forEach(i);
             }
         }
     }
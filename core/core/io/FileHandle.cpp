@@ -12,6 +12,8 @@
 
 #ifdef _WIN32
 #include "windows/PlatformFileHandle.h"
+#else
+#include "posix/PlatformFileHandle.h"
 #endif
 
 
@@ -24,6 +26,7 @@ namespace Carrot::IO {
         { t.write(constdata) } -> std::convertible_to<void>; // fills the file with the data, advances cursor, throws if error
         { t.seek(seek, seekDirection) } -> std::convertible_to<void>; // fills the file with the data, advances cursor, throws if error
         { t.tell() } -> std::convertible_to<std::uint64_t>; // where is the cursor?
+        { t.map(seek) } -> std::convertible_to<std::shared_ptr<const std::uint8_t>>; // maps the start of the file in memory, throws if error
     };
 
     static_assert(IsPlatformFileFormatValid<PlatformFileHandle>, "Platform file handle for this configuration is not valid.");
@@ -140,6 +143,12 @@ namespace Carrot::IO {
         return std::move(ptr);
     }
 
+    std::shared_ptr<const std::uint8_t> FileHandle::map() const {
+        assert(opened);
+        assert(isReadableMode(currentOpenMode));
+        return PLATFORM_HANDLE->map(fileSize);
+    }
+
     std::unique_ptr<FileHandle> FileHandle::copyReadable() const {
         auto result = std::make_unique<FileHandle>();
         if(opened) {
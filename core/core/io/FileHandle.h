@@ -93,6 +93,13 @@ namespace Carrot::IO {
         void readAll(void* buffer);
         std::unique_ptr<uint8_t[]> readAll();
 
+        /**
+         * Maps the entire file in memory, read-only, without copying it.
+         * The mapping is released once the returned pointer (and all its copies) are destroyed, and stays valid even
+         * after this handle is closed. Returns nullptr for empty files.
+         */
+        std::shared_ptr<const std::uint8_t> map() const;
+
     private:
         PlatformFileHandle* handle = nullptr;
         bool opened = false;
@@ -6,7 +6,8 @@
 #include "core/io/Logging.hpp"
 
 namespace Carrot::IO {
-    FileWatcher::FileWatcher(const Action& action, const std::vector<std::filesystem::path>& filesToWatch): action(action), files() {
+    FileWatcher::FileWatcher(const Action& action, const std::vector<std::filesystem::path>& filesToWatch) {
+        auto& service = FileWatcherService::getInstance();
         for(const auto& p : filesToWatch) {
             std::error_code ec;
             auto fullPath = std::filesystem::absolute(p, ec);
@@ -15,24 +16,17 @@ namespace Carrot::IO {
             }
 
             if(std::filesystem::exists(fullPath)) {
-                files.push_back(fullPath);
-                timestamps[fullPath] = std::filesystem::last_write_time(fullPath, ec);
-                if(ec) {
-                    throw std::runtime_error(Carrot::sprintf("Got error when accessing last_write_time of %s: 0x%x", fullPath.u8string().c_str(), ec.value()));
-                }
+                subscriptions.push_back(service.subscribe(fullPath, action));
             } else {
                 Carrot::Log::warn("Tried to watch file '%s' but it does not exist.", fullPath.u8string().c_str());
             }
         }
     }
 
-    void FileWatcher::tick() {
-        for(const auto& p : files) {
-            auto timestamp = std::filesystem::last_write_time(p);
-            if(timestamp > timestamps[p]) {
-                timestamps[p] = timestamp;
-                action(p);
-            }
+    FileWatcher::~FileWatcher() {
+        auto& service = FileWatcherService::getInstance();
+        for(const auto& subscription : subscriptions) {
+            service.unsubscribe(subscription);
         }
     }
-}
\ No newline at end of file
+}
@@ -8,22 +8,23 @@
 #include <string>
 #include <functional>
 #include <vector>
-#include "core/data/Hashes.h"
+#include "core/io/FileWatcherService.h"
 
 namespace Carrot::IO {
+    /// Subscription to FileWatcherService for a set of files. Stops watching when destroyed.
     class FileWatcher {
     public:
         using Action = std::function<void(const std::filesystem::path&)>;
 
         // Creates a new file watcher which will react to modifications inside files in 'filesToWatch'
+        // 'action' is called from FileWatcherService::dispatchEvents
         explicit FileWatcher(const Action& action, const std::vector<std::filesystem::path>& filesToWatch);
+        ~FileWatcher();
 
-        // Checks if files have been modified, and calls the action if it is the case
-        void tick();
+        FileWatcher(const FileWatcher&) = delete;
+        FileWatcher& operator=(const FileWatcher&) = delete;
 
     private:
-        std::vector<std::filesystem::path> files;
-        std::unordered_map<std::filesystem::path, std::filesystem::file_time_type> timestamps;
-        Action action;
+        std::vector<FileWatcherService::SubscriptionID> subscriptions;
     };
 }
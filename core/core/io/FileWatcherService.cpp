@@ -0,0 +1,245 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "FileWatcherService.h"
+#include "core/io/Logging.hpp"
+#include "core/async/OSThreads.h"
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace Carrot::IO {
+    static Carrot::Log::Category category { "FileWatcher" };
+
+#ifdef __linux__
+    constexpr std::uint32_t WatchMask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE;
+#else
+    /// Polling interval used when the OS has no file notification API supported by this service
+    constexpr std::chrono::milliseconds PollingInterval { 250 };
+#endif
+
+    FileWatcherService& FileWatcherService::getInstance() {
+        static FileWatcherService instance;
+        return instance;
+    }
+
+    FileWatcherService::FileWatcherService() {
+#ifdef __linux__
+        inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if(inotifyFD < 0) {
+            throw std::runtime_error(Carrot::sprintf("Could not initialize inotify: errno %d", errno));
+        }
+        wakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(wakeFD < 0) {
+            close(inotifyFD);
+            throw std::runtime_error(Carrot::sprintf("Could not create eventfd: errno %d", errno));
+        }
+#endif
+        watchThread = std::thread([this]() { watchLoop(); });
+        Carrot::Threads::setName(watchThread, "File watcher");
+    }
+
+    FileWatcherService::~FileWatcherService() {
+        running = false;
+#ifdef __linux__
+        const std::uint64_t one = 1;
+        [[maybe_unused]] auto r = write(wakeFD, &one, sizeof(one));
+#endif
+        watchThread.join();
+#ifdef __linux__
+        close(wakeFD);
+        close(inotifyFD);
+#endif
+    }
+
+    FileWatcherService::SubscriptionID FileWatcherService::subscribe(const std::filesystem::path& file, Callback callback) {
+        std::error_code ec;
+        const std::filesystem::path fullPath = std::filesystem::absolute(file, ec).lexically_normal();
+        if(ec) {
+            throw std::runtime_error(Carrot::sprintf("Got error when converting %s to absolute path: 0x%x", file.u8string().c_str(), ec.value()));
+        }
+
+        std::lock_guard l { access };
+        const SubscriptionID id = nextSubscriptionID++;
+        subscriptions[id] = Subscription {
+            .file = fullPath,
+            .callback = std::make_shared<Callback>(std::move(callback)),
+        };
+
+        auto [fileIt, newFile] = watchedFiles.try_emplace(fullPath);
+        fileIt->second.subscriptions.push_back(id);
+        if(!newFile) {
+            return id;
+        }
+
+        fileIt->second.lastWriteTime = std::filesystem::last_write_time(fullPath, ec);
+        if(ec) {
+            throw std::runtime_error(Carrot::sprintf("Got error when accessing last_write_time of %s: 0x%x", fullPath.u8string().c_str(), ec.value()));
+        }
+
+        const std::filesystem::path directory = fullPath.parent_path();
+        WatchedDirectory& watchedDirectory = watchedDirectories[directory];
+        if(watchedDirectory.refCount++ == 0) {
+#ifdef __linux__
+            watchedDirectory.watchDescriptor = inotify_add_watch(inotifyFD, directory.c_str(), WatchMask);
+            if(watchedDirectory.watchDescriptor < 0) {
+                Carrot::Log::error(category, "Could not watch directory %s: errno %d", directory.u8string().c_str(), errno);
+            } else {
+                directoriesByWatchDescriptor[watchedDirectory.watchDescriptor] = directory;
+            }
+#endif
+        }
+        return id;
+    }
+
+    void FileWatcherService::unsubscribe(SubscriptionID subscription) {
+        std::lock_guard l { access };
+        auto subscriptionIt = subscriptions.find(subscription);
+        if(subscriptionIt == subscriptions.end()) {
+            return;
+        }
+
+        const std::filesystem::path file = subscriptionIt->second.file;
+        subscriptions.erase(subscriptionIt);
+
+        auto fileIt = watchedFiles.find(file);
+        std::erase(fileIt->second.subscriptions, subscription);
+        if(!fileIt->second.subscriptions.empty()) {
+            return;
+        }
+        watchedFiles.erase(fileIt);
+        pendingEvents.erase(file);
+
+        auto directoryIt = watchedDirectories.find(file.parent_path());
+        if(--directoryIt->second.refCount == 0) {
+#ifdef __linux__
+            if(directoryIt->second.watchDescriptor >= 0) {
+                inotify_rm_watch(inotifyFD, directoryIt->second.watchDescriptor);
+                directoriesByWatchDescriptor.erase(directoryIt->second.watchDescriptor);
+            }
+#endif
+            watchedDirectories.erase(directoryIt);
+        }
+    }
+
+    void FileWatcherService::dispatchEvents() {
+        std::vector<std::pair<SubscriptionID, std::filesystem::path>> toNotify;
+        {
+            std::lock_guard l { access };
+            if(pendingEvents.empty()) {
+                return;
+            }
+
+            const auto now = Clock::now();
+            for(auto it = pendingEvents.begin(); it != pendingEvents.end();) {
+                if(now - it->second < debounceDelay) {
+                    ++it;
+                    continue;
+                }
+
+                for(const SubscriptionID id : watchedFiles[it->first].subscriptions) {
+                    toNotify.emplace_back(id, it->first);
+                }
+                it = pendingEvents.erase(it);
+            }
+        }
+
+        for(const auto& [id, file] : toNotify) {
+            // callbacks are allowed to (un)subscribe, so the lock cannot be held while calling them
+            std::shared_ptr<Callback> callback;
+            {
+                std::lock_guard l { access };
+                auto it = subscriptions.find(id);
+                if(it == subscriptions.end()) {
+                    continue;
+                }
+                callback = it->second.callback;
+            }
+            (*callback)(file);
+        }
+    }
+
+    void FileWatcherService::setDebounceDelay(std::chrono::milliseconds delay) {
+        std::lock_guard l { access };
+        debounceDelay = delay;
+    }
+
+    void FileWatcherService::onFileModified(const std::filesystem::path& file) {
+        if(watchedFiles.contains(file)) {
+            pendingEvents[file] = Clock::now();
+        }
+    }
+
+#ifdef __linux__
+    void FileWatcherService::watchLoop() {
+        alignas(inotify_event) char buffer[4096];
+        pollfd fds[2] {
+            { .fd = inotifyFD, .events = POLLIN },
+            { .fd = wakeFD, .events = POLLIN },
+        };
+
+        while(running) {
+            // blocks until something happens, nothing is done while files do not change
+            if(poll(fds, 2, -1) < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                Carrot::Log::error(category, "poll failed: errno %d", errno);
+                return;
+            }
+
+            if((fds[0].revents & POLLIN) == 0) {
+                continue;
+            }
+
+            while(true) {
+                const ssize_t length = read(inotifyFD, buffer, sizeof(buffer));
+                if(length <= 0) {
+                    break; // EAGAIN: all events have been read
+                }
+
+                std::lock_guard l { access };
+                for(char* ptr = buffer; ptr < buffer + length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                    ptr += sizeof(inotify_event) + event->len;
+
+                    if(event->mask & IN_IGNORED) {
+                        directoriesByWatchDescriptor.erase(event->wd);
+                        continue;
+                    }
+                    if(event->len == 0) {
+                        continue;
+                    }
+
+                    auto directoryIt = directoriesByWatchDescriptor.find(event->wd);
+                    if(directoryIt == directoriesByWatchDescriptor.end()) {
+                        continue;
+                    }
+                    onFileModified(directoryIt->second / event->name);
+                }
+            }
+        }
+    }
+#else
+    void FileWatcherService::watchLoop() {
+        while(running) {
+            std::this_thread::sleep_for(PollingInterval);
+
+            std::lock_guard l { access };
+            for(auto& [file, watchedFile] : watchedFiles) {
+                std::error_code ec;
+                const auto timestamp = std::filesystem::last_write_time(file, ec);
+                if(!ec && timestamp > watchedFile.lastWriteTime) {
+                    watchedFile.lastWriteTime = timestamp;
+                    onFileModified(file);
+                }
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,99 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "core/data/Hashes.h"
+
+namespace Carrot::IO {
+
+    /**
+     * Single service watching files for modifications.
+     * On Linux, directories containing watched files are watched with inotify: a background thread blocks until the OS
+     * reports changes, so there is no cost when nothing changes.
+     * On other platforms, the background thread polls the timestamps of the watched files at a low frequency.
+     *
+     * Events are coalesced per file and debounced: callbacks are called once the file has not been modified for
+     * 'debounceDelay'. Callbacks are only ever called from dispatchEvents(), which is expected to run on the main loop.
+     */
+    class FileWatcherService {
+    public:
+        using Callback = std::function<void(const std::filesystem::path&)>;
+        using SubscriptionID = std::uint64_t;
+
+        static FileWatcherService& getInstance();
+
+        FileWatcherService();
+        ~FileWatcherService();
+
+        FileWatcherService(const FileWatcherService&) = delete;
+        FileWatcherService& operator=(const FileWatcherService&) = delete;
+
+        /**
+         * Calls 'callback' each time 'file' is modified. 'file' must exist.
+         * @return an ID to use with 'unsubscribe'
+         */
+        SubscriptionID subscribe(const std::filesystem::path& file, Callback callback);
+
+        /**
+         * Stops calling the callback associated to the given subscription. Safe to call from a callback.
+         */
+        void unsubscribe(SubscriptionID subscription);
+
+        /**
+         * Calls the callbacks of all files which were modified, and have not been modified for at least 'debounceDelay'.
+         */
+        void dispatchEvents();
+
+        void setDebounceDelay(std::chrono::milliseconds delay);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Subscription {
+            std::filesystem::path file;
+            std::shared_ptr<Callback> callback;
+        };
+
+        struct WatchedFile {
+            std::vector<SubscriptionID> subscriptions;
+            std::filesystem::file_time_type lastWriteTime; // only used by the polling implementation
+        };
+
+        struct WatchedDirectory {
+            int watchDescriptor = -1;
+            std::size_t refCount = 0;
+        };
+
+        /// Background thread: waits for OS events (or polls), and records modified files inside 'pendingEvents'
+        void watchLoop();
+
+        /// Records a modification for the given file, if it is watched. Must be called with 'access' locked
+        void onFileModified(const std::filesystem::path& file);
+
+    private:
+        std::mutex access;
+        std::chrono::milliseconds debounceDelay { 100 };
+        SubscriptionID nextSubscriptionID = 1;
+        std::unordered_map<SubscriptionID, Subscription> subscriptions;
+        std::unordered_map<std::filesystem::path, WatchedFile> watchedFiles;
+        std::unordered_map<std::filesystem::path, WatchedDirectory> watchedDirectories;
+        std::unordered_map<int, std::filesystem::path> directoriesByWatchDescriptor;
+        std::unordered_map<std::filesystem::path, Clock::time_point> pendingEvents; // file -> time of last modification
+
+        std::atomic<bool> running { true };
+        int inotifyFD = -1;
+        int wakeFD = -1;
+        std::thread watchThread;
+    };
+}
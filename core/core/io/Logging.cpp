@@ -3,41 +3,395 @@
 //
 #include "Logging.hpp"
 #include "core/utils/Assert.h"
+#include "core/async/OSThreads.h"
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
 
-std::list<Carrot::Log::Message>& Carrot::Log::getMessages() {
-    static std::list<Carrot::Log::Message> messages;
+namespace Carrot::Log {
+    /// One message waiting to be formatted and written by the logging thread
+    struct Record {
+        Severity severity = Severity::Debug;
+        std::uint64_t timestamp = 0;
+        std::string_view category; // interned, see Category::name
+        std::source_location sourceLoc;
+        Internal::DeferredFormatFunction formatFunction = nullptr;
+        alignas(std::max_align_t) std::byte payload[Internal::MaxDeferredPayloadSize];
+    };
 
-    return messages;
-}
+    /// Single-producer single-consumer ring buffer of records. Each thread which logs owns one, the logging thread is the only consumer.
+    struct ThreadBuffer {
+        constexpr static std::uint64_t Capacity = 512;
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
 
-const std::chrono::system_clock::time_point& Carrot::Log::getStartTime() {
-    static auto start = std::chrono::system_clock::now();
-    return start;
-}
+        std::array<Record, Capacity> records;
+        alignas(64) std::atomic<std::uint64_t> head { 0 }; // written by producer
+        alignas(64) std::atomic<std::uint64_t> tail { 0 }; // written by consumer
+        std::atomic<bool> abandoned { false }; // set when the owning thread exits
+
+        Record& at(std::uint64_t index) {
+            return records[index & (Capacity - 1)];
+        }
+    };
+
+    /// Used to format and write messages synchronously once the backend is destroyed (static destruction)
+    static std::atomic<bool> backendDestroyed { false };
+
+    static std::string formatLine(const Message& message) {
+        return Carrot::sprintf("[%s] [%.*s] (T %llu) %s [%s:%llu]\n", getSeverityString(message.severity), static_cast<int>(message.category.size()), message.category.data(), message.timestamp, message.message.c_str(), message.sourceLoc.file_name(), (std::uint64_t)message.sourceLoc.line());
+    }
+
+    static Message toMessage(Record& record) {
+        return Message {
+            .severity = record.severity,
+            .timestamp = record.timestamp,
+            .message = record.formatFunction(record.payload),
+
+            .category = record.category,
+            .sourceLoc = record.sourceLoc,
+        };
+    }
+
+    class Backend {
+    public:
+        Backend() {
+            drainThread = std::thread([this]() { drainLoop(); });
+            Carrot::Threads::setName(drainThread, "Log drain");
+        }
+
+        ~Backend() {
+            {
+                std::lock_guard l { wakeMutex };
+                running = false;
+            }
+            wakeCondition.notify_all();
+            drainThread.join();
+            drainAll(); // messages pushed while the thread was stopping
+            backendDestroyed.store(true);
+        }
+
+        std::shared_ptr<ThreadBuffer> registerThread() {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard l { buffersMutex };
+            buffers.push_back(buffer);
+            return buffer;
+        }
+
+        void wake() {
+            {
+                std::lock_guard l { wakeMutex };
+                wakeRequested = true;
+            }
+            wakeCondition.notify_one();
+        }
+
+        void flush() {
+            if(std::this_thread::get_id() == drainThread.get_id()) {
+                return;
+            }
+
+            std::vector<std::pair<std::shared_ptr<ThreadBuffer>, std::uint64_t>> targets;
+            {
+                std::lock_guard l { buffersMutex };
+                targets.reserve(buffers.size());
+                for(const auto& buffer : buffers) {
+                    targets.emplace_back(buffer, buffer->head.load(std::memory_order_acquire));
+                }
+            }
+
+            std::unique_lock l { wakeMutex };
+            wakeRequested = true;
+            wakeCondition.notify_one();
+            drainedCondition.wait(l, [&]() {
+                if(!running) {
+                    return true;
+                }
+                for(const auto& [buffer, head] : targets) {
+                    if(buffer->tail.load(std::memory_order_acquire) < head) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        }
+
+        void visitHistory(const std::function<void(const MessageHistory&)>& visitor) {
+            std::lock_guard l { historyMutex };
+            visitor(history);
+        }
+
+        void setConsoleOutput(bool enabled) {
+            std::lock_guard l { outputMutex };
+            consoleOutput = enabled;
+        }
+
+        void setFileOutput(const std::filesystem::path& path) {
+            std::lock_guard l { outputMutex };
+            fileOutput.close();
+            if(!path.empty()) {
+                fileOutput.open(path, std::ios::out | std::ios::trunc);
+                if(!fileOutput.is_open()) {
+                    // cannot log from here: we hold the output lock
+                    std::cerr << "Could not open log file " << path.string() << std::endl;
+                }
+            }
+        }
+
+    private:
+        void drainLoop() {
+            std::unique_lock l { wakeMutex };
+            while(running) {
+                wakeCondition.wait_for(l, std::chrono::milliseconds(10), [&]() { return wakeRequested || !running; });
+                wakeRequested = false;
+                l.unlock();
+                drainAll();
+                l.lock();
+                drainedCondition.notify_all();
+            }
+            drainedCondition.notify_all();
+        }
+
+        void drainAll() {
+            pending.clear();
+            {
+                std::lock_guard l { buffersMutex };
+                for(auto it = buffers.begin(); it != buffers.end();) {
+                    ThreadBuffer& buffer = **it;
+                    const std::uint64_t head = buffer.head.load(std::memory_order_acquire);
+                    std::uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+                    for(; tail < head; tail++) {
+                        pending.emplace_back(toMessage(buffer.at(tail)));
+                    }
+                    buffer.tail.store(tail, std::memory_order_release);
+
+                    if(buffer.abandoned.load(std::memory_order_acquire) && buffer.head.load(std::memory_order_acquire) == tail) {
+                        it = buffers.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            if(pending.empty()) {
+                return;
+            }
+
+            // each thread buffer is already sorted, restore the global order
+            std::stable_sort(pending.begin(), pending.end(), [](const Message& a, const Message& b) {
+                return a.timestamp < b.timestamp;
+            });
+            write(pending);
+
+            std::lock_guard l { historyMutex };
+            for(auto& message : pending) {
+                history.emplace(std::move(message));
+            }
+        }
+
+        void write(const std::vector<Message>& messages) {
+            std::lock_guard l { outputMutex };
+            for(const auto& message : messages) {
+                const std::string line = formatLine(message);
+                if(consoleOutput) {
+                    std::ostream& out = message.severity == Severity::Error ? std::cerr : std::cout;
+                    out << line;
+                }
+                if(fileOutput.is_open()) {
+                    fileOutput << line;
+                }
+            }
+            std::cout.flush();
+            if(fileOutput.is_open()) {
+                fileOutput.flush();
+            }
+        }
+
+    private:
+        std::thread drainThread;
+        bool running = true;
+        bool wakeRequested = false;
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        std::condition_variable drainedCondition;
+
+        std::mutex buffersMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        std::vector<Message> pending; // only accessed by the logging thread
+
+        std::mutex historyMutex;
+        MessageHistory history;
 
-void Carrot::Log::log(Severity severity, const Category& category, const std::string& message, const std::source_location& src, std::ostream& out) {
-/*#ifndef IS_DEBUG_BUILD
-        if(severity == Severity::Debug)
+        std::mutex outputMutex;
+        bool consoleOutput = true;
+        std::ofstream fileOutput;
+    };
+
+    /// Started on first use. Returns nullptr once destroyed
+    static Backend* getBackend() {
+        if(backendDestroyed.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        static Backend backend;
+        return &backend;
+    }
+
+    /// Owns the buffer of the current thread, and lets the logging thread release it once the thread exits
+    struct ThreadBufferHandle {
+        std::shared_ptr<ThreadBuffer> buffer;
+        Record fallbackRecord; // used if the backend is not available anymore
+
+        ~ThreadBufferHandle() {
+            if(buffer) {
+                buffer->abandoned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    static thread_local ThreadBufferHandle threadBuffer;
+
+    static std::atomic<Severity> globalMinimumSeverity { Severity::Debug };
+
+    /// Returns a view on a copy of 'name' which lives until the end of the program. Each distinct name is stored once
+    static std::string_view internCategoryName(std::string_view name) {
+        static std::mutex namesMutex;
+        // never destroyed: categories and messages may still be used during static destruction
+        static auto* pNames = new std::set<std::string, std::less<>>;
+
+        std::lock_guard l { namesMutex };
+        auto it = pNames->find(name);
+        if(it == pNames->end()) {
+            it = pNames->emplace(name).first;
+        }
+        return *it;
+    }
+
+    Category::Category(std::string_view name, Severity minimumSeverity): name(internCategoryName(name)), minimumSeverity(minimumSeverity) {}
+
+    Category::Category(const Category& other): name(other.name), minimumSeverity(other.getMinimumSeverity()) {}
+
+    Category& Category::operator=(const Category& other) {
+        name = other.name;
+        minimumSeverity.store(other.getMinimumSeverity(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void Category::setMinimumSeverity(Severity severity) const {
+        minimumSeverity.store(severity, std::memory_order_relaxed);
+    }
+
+    Severity Category::getMinimumSeverity() const {
+        return minimumSeverity.load(std::memory_order_relaxed);
+    }
+
+    void setGlobalMinimumSeverity(Severity severity) {
+        globalMinimumSeverity.store(severity, std::memory_order_relaxed);
+    }
+
+    Severity getGlobalMinimumSeverity() {
+        return globalMinimumSeverity.load(std::memory_order_relaxed);
+    }
+
+    void setConsoleOutput(bool enabled) {
+        if(Backend* backend = getBackend()) {
+            backend->setConsoleOutput(enabled);
+        }
+    }
+
+    void setFileOutput(const std::filesystem::path& path) {
+        if(Backend* backend = getBackend()) {
+            backend->setFileOutput(path);
+        }
+    }
+
+    void visitMessageHistory(const std::function<void(const MessageHistory&)>& visitor) {
+        if(Backend* backend = getBackend()) {
+            backend->visitHistory(visitor);
+        }
+    }
+
+    const std::chrono::system_clock::time_point& getStartTime() {
+        static auto start = std::chrono::system_clock::now();
+        return start;
+    }
+
+    void flush() {
+        if(Backend* backend = getBackend()) {
+            backend->flush();
+        }
+        std::cout.flush();
+        std::cerr.flush();
+    }
+
+    struct PreformattedPayload {
+        std::string message;
+
+        static std::string formatAndDestroy(void* pPayload) {
+            PreformattedPayload* self = static_cast<PreformattedPayload*>(pPayload);
+            std::string result = std::move(self->message);
+            self->~PreformattedPayload();
+            return result;
+        }
+    };
+
+    void log(Severity severity, const Category& category, std::string_view message, const std::source_location& src) {
+        if(!isEnabled(severity, category)) {
             return;
-#endif*/
-    // TODO: write to file?
+        }
+        void* storage = Internal::reservePayload();
+        new (storage) PreformattedPayload { std::string(message) };
+        Internal::commitRecord(severity, category.name, src, &PreformattedPayload::formatAndDestroy);
+    }
+
+    void* Internal::reservePayload() {
+        getStartTime(); // make sure start time is initialized before the first message
+        Backend* backend = getBackend();
+        if(backend == nullptr) {
+            return threadBuffer.fallbackRecord.payload;
+        }
+
+        if(threadBuffer.buffer == nullptr) {
+            threadBuffer.buffer = backend->registerThread();
+        }
 
-    const auto timestamp = std::chrono::system_clock::now() - getStartTime();
+        ThreadBuffer& buffer = *threadBuffer.buffer;
+        const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+        while(head - buffer.tail.load(std::memory_order_acquire) >= ThreadBuffer::Capacity) {
+            // full: let the logging thread catch up
+            backend->wake();
+            Carrot::Threads::reduceCPULoad();
+        }
+        return buffer.at(head).payload;
+    }
 
-    out << Carrot::sprintf("[%s] [%s] (T %llu) %s [%s:%llu]\n", getSeverityString(severity), category.name.c_str(), timestamp.count(), message.c_str(), src.file_name(), (std::uint64_t)src.line());
-//        out << "[" << getSeverityString(severity) << "] (T " << timestamp << ") " << message << '\n';
+    void Internal::commitRecord(Severity severity, std::string_view category, const std::source_location& src, DeferredFormatFunction formatFunction) {
+        const auto timestamp = std::chrono::system_clock::now() - getStartTime();
 
-    getMessages().emplace_back(Message {
-            .severity = severity,
-            .timestamp = static_cast<std::uint64_t>(timestamp.count()),
-            .message = message,
+        Backend* backend = getBackend();
+        Record& record = backend == nullptr ? threadBuffer.fallbackRecord : threadBuffer.buffer->at(threadBuffer.buffer->head.load(std::memory_order_relaxed));
+        record.severity = severity;
+        record.timestamp = static_cast<std::uint64_t>(timestamp.count());
+        record.category = category;
+        record.sourceLoc = src;
+        record.formatFunction = formatFunction;
 
-            .category = category,
-            .sourceLoc = src,
-    });
+        if(backend == nullptr) {
+            // no logging thread anymore (static destruction), format and write on the calling thread
+            const Message message = toMessage(record);
+            (severity == Severity::Error ? std::cerr : std::cout) << formatLine(message);
+            return;
+        }
+
+        threadBuffer.buffer->head.fetch_add(1, std::memory_order_release);
+        if(severity == Severity::Error) {
+            // errors are often followed by a crash, write them as soon as possible
+            backend->wake();
+        }
+    }
 }
 
 void Carrot::Assertions::printVerify(const std::string& condition, const std::string& message) {
     Carrot::Log::error(Carrot::sprintf("%s - %s", message.c_str(), condition.c_str()));
     Carrot::Log::flush();
-}
\ No newline at end of file
+}
@@ -7,13 +7,18 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <atomic>
 #include <chrono>
 #include <ctime>
+#include <filesystem>
+#include <functional>
 #include <iomanip>
-#include <list>
 #include <cassert>
 #include <strstream>
+#include <string_view>
+#include <tuple>
 #include "core/utils/stringmanip.h"
+#include "core/containers/CircleBuffer.h"
 #include <source_location>
 
 namespace Carrot::Log {
@@ -36,24 +41,58 @@ namespace Carrot::Log {
         Error,
     };
 
+    /// Category of log messages. Each category has its own severity filter: messages below 'minimumSeverity' are
+    /// discarded before being formatted.
     struct Category {
-        std::string name;
+        Category(std::string_view name, Severity minimumSeverity = Severity::Debug);
+        Category(const Category& other);
+        Category& operator=(const Category& other);
+
+        /// Changes the minimum severity of messages accepted by this category. Thread-safe.
+        void setMinimumSeverity(Severity severity) const;
+        Severity getMinimumSeverity() const;
+
+        /// Interned: valid until the end of the program, so log records only keep a view on it
+        std::string_view name;
+
+    private:
+        mutable std::atomic<Severity> minimumSeverity;
     };
 
     struct Message {
-        Severity severity;
-        std::uint64_t timestamp;
+        Severity severity = Severity::Debug;
+        std::uint64_t timestamp = 0;
         std::string message;
 
-        Category category;
+        std::string_view category; //< name of the category, interned (see Category::name)
         std::source_location sourceLoc;
     };
 
-    static const Category defaultCategory { "Default" };
+    inline const Category defaultCategory { "Default" };
+
+    /// Maximum count of messages kept for display (console). Older messages are discarded.
+    constexpr std::int64_t MessageHistorySize = 4096;
+    using MessageHistory = Carrot::CircleBuffer<Message, MessageHistorySize>;
 
-    std::list<Message>& getMessages();
+    /// Calls 'visitor' with the history of the latest messages. The history is locked for the duration of the call,
+    /// so 'visitor' must not log anything.
+    void visitMessageHistory(const std::function<void(const MessageHistory&)>& visitor);
     const std::chrono::system_clock::time_point& getStartTime();
 
+    /// Messages with a severity below this value are discarded, whatever their category. Thread-safe.
+    void setGlobalMinimumSeverity(Severity severity);
+    Severity getGlobalMinimumSeverity();
+
+    /// Should messages be written to stdout/stderr? Enabled by default.
+    void setConsoleOutput(bool enabled);
+
+    /// Also writes messages to the given file (truncated on open). An empty path closes the current log file.
+    void setFileOutput(const std::filesystem::path& path);
+
+    inline bool isEnabled(Severity severity, const Category& category) {
+        return severity >= getGlobalMinimumSeverity() && severity >= category.getMinimumSeverity();
+    }
+
     inline const char* getSeverityString(Severity severity) {
         switch (severity) {
             case Severity::Debug:
@@ -69,95 +108,135 @@ namespace Carrot::Log {
         throw std::runtime_error("Unknown severity. Have you tested your code in debug?");
     }
 
-    void log(Severity severity, const Category& category, const std::string& message, const std::source_location& src, std::ostream& out = std::cout);
-
-    inline void flush() {
-        std::cout.flush();
-        std::cerr.flush();
-    }
-
-    inline void debug_log(const std::string& message, const Category& category, const std::source_location& src) {
-        log(Severity::Debug, category, message, src);
-    }
-
-    inline void info_log(const std::string& message, const Category& category, const std::source_location& src) {
-        log(Severity::Info, category, message, src);
-    }
-
-    inline void warn_log(const std::string& message, const Category& category, const std::source_location& src) {
-        log(Severity::Warning, category, message, src);
-    }
+    /// Logs an already formatted message. Messages are written asynchronously by the logging thread, use flush() to wait for them.
+    void log(Severity severity, const Category& category, std::string_view message, const std::source_location& src);
+
+    /// Blocks until all messages logged before this call are written to their outputs
+    void flush();
+
+    namespace Internal {
+        /// Maximum size of the captured arguments of a single log call
+        constexpr std::size_t MaxDeferredPayloadSize = 256;
+
+        /// Formats the message stored inside 'payload', then destroys the payload
+        using DeferredFormatFunction = std::string(*)(void* payload);
+
+        /// Returns storage for the arguments of the next message of the current thread.
+        /// Must be followed by a call to commitRecord on the same thread.
+        void* reservePayload();
+
+        /// Publishes the message reserved by the last call to reservePayload. Formatting happens on the logging thread.
+        /// 'category' must be interned (see Category::name).
+        void commitRecord(Severity severity, std::string_view category, const std::source_location& src, DeferredFormatFunction formatFunction);
+
+        /// How an argument is stored until its message is formatted: C-strings are copied because they may not outlive the log call.
+        template<typename T>
+        struct StoredArg {
+            using Type = std::decay_t<T>;
+        };
+
+        template<typename T> requires std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>
+        struct StoredArg<T> {
+            using Type = std::string;
+        };
+
+        template<typename T>
+        decltype(auto) unwrap(const T& arg) {
+            if constexpr(std::is_same_v<T, std::string>) {
+                return arg.c_str();
+            } else {
+                return arg;
+            }
+        }
 
-    inline void error_log(const std::string& message, const Category& category, const std::source_location& src) {
-        log(Severity::Error, category,message, src, std::cerr);
+        template<typename... StoredArgs>
+        struct DeferredPayload {
+            std::string format;
+            std::tuple<StoredArgs...> args;
+
+            static std::string formatAndDestroy(void* pPayload) {
+                DeferredPayload* self = static_cast<DeferredPayload*>(pPayload);
+                std::string result = std::apply([&](const StoredArgs&... a) {
+                    return Carrot::sprintf(self->format, unwrap(a)...);
+                }, self->args);
+                self->~DeferredPayload();
+                return result;
+            }
+        };
     }
 
-    using LogFunctionType = void(const std::string& message, const Category& category, const std::source_location& src);
-
-    template<LogFunctionType logFunction, typename Arg0, typename... Args>
-    void formattedLog(const Category& category, const std::source_location& sourceLocation, const std::string& format, Arg0 arg0, Args... args) {
-        auto size = std::snprintf(nullptr, 0, format.c_str(), arg0, args...) + 1;
-        if(size <= 0) {
-            throw LogError("Failed to format message " + format);
+    template<Severity severity, typename... Args>
+    void formattedLog(const Category& category, const std::source_location& sourceLocation, std::string_view format, Args... args) {
+        if(!isEnabled(severity, category)) {
+            return;
         }
 
-        auto buffer = std::make_unique<char[]>(size);
-        std::snprintf(buffer.get(), size, format.c_str(), arg0, args...);
+        using Payload = Internal::DeferredPayload<typename Internal::StoredArg<Args>::Type...>;
+        static_assert(sizeof(Payload) <= Internal::MaxDeferredPayloadSize, "Too many arguments to log, increase MaxDeferredPayloadSize");
+        static_assert(alignof(Payload) <= alignof(std::max_align_t));
 
-        std::string formatResult{buffer.get(), buffer.get() + size - 1};
-
-        logFunction(formatResult, category, sourceLocation);
+        void* storage = Internal::reservePayload();
+        new (storage) Payload {
+            .format = std::string(format),
+            .args = { typename Internal::StoredArg<Args>::Type(args)... },
+        };
+        Internal::commitRecord(severity, category.name, sourceLocation, &Payload::formatAndDestroy);
     }
 
-    template<LogFunctionType logFunction, typename Arg0, typename... Args>
-    void formattedLog(const std::string& format, Arg0 arg0, Args... args) {
-        formattedLog<logFunction>(defaultCategory, std::source_location::current(), format, std::forward<Arg0>(arg0), std::forward<Args>(args)...);
+    template<Severity severity, typename Arg0, typename... Args>
+    void formattedLog(std::string_view format, Arg0 arg0, Args... args) {
+        formattedLog<severity>(defaultCategory, std::source_location::current(), format, std::forward<Arg0>(arg0), std::forward<Args>(args)...);
     }
 
-    template<LogFunctionType logFunction, typename Arg0, typename... Args>
-    void cformattedLog(const Category& category, const std::source_location& src, const std::string& format, Arg0 arg0, Args... args) {
-        formattedLog<logFunction>(category, src, format, std::forward<Arg0>(arg0), std::forward<Args>(args)...);
+    template<Severity severity, typename Arg0, typename... Args>
+    void cformattedLog(const Category& category, const std::source_location& src, std::string_view format, Arg0 arg0, Args... args) {
+        formattedLog<severity>(category, src, format, std::forward<Arg0>(arg0), std::forward<Args>(args)...);
     }
 
+    constexpr Severity debug_severity = Severity::Debug;
+    constexpr Severity info_severity = Severity::Info;
+    constexpr Severity warn_severity = Severity::Warning;
+    constexpr Severity error_severity = Severity::Error;
+
 #define DEFINE_LOG_FUNCTION_SUBHELPER6(NAME) \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t, typename Arg3_t, typename Arg4_t, typename Arg5_t> \
-    void NAME (const Category& category, const std::string& format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, Arg4_t arg4, Arg5_t arg5, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3), std::forward<Arg4_t>(arg4), std::forward<Arg5_t>(arg5)); } \
+    void NAME (const Category& category, std::string_view format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, Arg4_t arg4, Arg5_t arg5, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3), std::forward<Arg4_t>(arg4), std::forward<Arg5_t>(arg5)); } \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t, typename Arg3_t, typename Arg4_t, typename Arg5_t> \
-    void NAME (const std::string& format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, Arg4_t arg4, Arg5_t arg5, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3), std::forward<Arg4_t>(arg4), std::forward<Arg5_t>(arg5), sourceLoc); } \
+    void NAME (std::string_view format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, Arg4_t arg4, Arg5_t arg5, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3), std::forward<Arg4_t>(arg4), std::forward<Arg5_t>(arg5), sourceLoc); } \
 
 #define DEFINE_LOG_FUNCTION_SUBHELPER5(NAME) \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t, typename Arg3_t, typename Arg4_t> \
-    void NAME (const Category& category, const std::string& format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, Arg4_t arg4, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3), std::forward<Arg4_t>(arg4)); } \
+    void NAME (const Category& category, std::string_view format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, Arg4_t arg4, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3), std::forward<Arg4_t>(arg4)); } \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t, typename Arg3_t, typename Arg4_t> \
-    void NAME (const std::string& format, Arg0_t Arg0, Arg1_t Arg1, Arg2_t Arg2, Arg3_t Arg3, Arg4_t Arg4, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, Arg2, Arg3, Arg4, sourceLoc); }
+    void NAME (std::string_view format, Arg0_t Arg0, Arg1_t Arg1, Arg2_t Arg2, Arg3_t Arg3, Arg4_t Arg4, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, Arg2, Arg3, Arg4, sourceLoc); }
 
 #define DEFINE_LOG_FUNCTION_SUBHELPER4(NAME) \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t, typename Arg3_t> \
-    void NAME (const Category& category, const std::string& format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3)); } \
+    void NAME (const Category& category, std::string_view format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, Arg3_t arg3, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2), std::forward<Arg3_t>(arg3)); } \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t, typename Arg3_t> \
-    void NAME (const std::string& format, Arg0_t Arg0, Arg1_t Arg1, Arg2_t Arg2, Arg3_t Arg3, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, Arg2, Arg3, sourceLoc); }
+    void NAME (std::string_view format, Arg0_t Arg0, Arg1_t Arg1, Arg2_t Arg2, Arg3_t Arg3, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, Arg2, Arg3, sourceLoc); }
 
 #define DEFINE_LOG_FUNCTION_SUBHELPER3(NAME) \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t> \
-    void NAME (const Category& category, const std::string& format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2)); } \
+    void NAME (const Category& category, std::string_view format, Arg0_t arg0, Arg1_t arg1, Arg2_t arg2, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1), std::forward<Arg2_t>(arg2)); } \
     template<typename Arg0_t, typename Arg1_t, typename Arg2_t> \
-    void NAME (const std::string& format, Arg0_t Arg0, Arg1_t Arg1, Arg2_t Arg2, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, Arg2, sourceLoc); }
+    void NAME (std::string_view format, Arg0_t Arg0, Arg1_t Arg1, Arg2_t Arg2, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, Arg2, sourceLoc); }
 
 #define DEFINE_LOG_FUNCTION_SUBHELPER2(NAME) \
     template<typename Arg0_t, typename Arg1_t> \
-    void NAME (const Category& category, const std::string& format, Arg0_t arg0, Arg1_t arg1, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1)); } \
+    void NAME (const Category& category, std::string_view format, Arg0_t arg0, Arg1_t arg1, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, std::forward<Arg0_t>(arg0), std::forward<Arg1_t>(arg1)); } \
     template<typename Arg0_t, typename Arg1_t> \
-    void NAME (const std::string& format, Arg0_t Arg0, Arg1_t Arg1, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, sourceLoc); }
+    void NAME (std::string_view format, Arg0_t Arg0, Arg1_t Arg1, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, Arg1, sourceLoc); }
 
 #define DEFINE_LOG_FUNCTION_SUBHELPER1(NAME) \
     template<typename Arg0_t> \
-    void NAME (const Category& category, const std::string& format, Arg0_t arg0, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, std::forward<Arg0_t>(arg0)); } \
+    void NAME (const Category& category, std::string_view format, Arg0_t arg0, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, std::forward<Arg0_t>(arg0)); } \
     template<typename Arg0_t> \
-    void NAME (const std::string& format, Arg0_t Arg0, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, sourceLoc); }
+    void NAME (std::string_view format, Arg0_t Arg0, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, Arg0, sourceLoc); }
 
 #define DEFINE_LOG_FUNCTION_SUBHELPER0(NAME) \
-    inline void NAME (const Category& category, const std::string& format, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _log>(category, sourceLoc, format, ""); } \
-    inline void NAME (const std::string& format, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, sourceLoc); }
+    inline void NAME (const Category& category, std::string_view format, const std::source_location& sourceLoc = std::source_location::current()) { cformattedLog<NAME ## _severity>(category, sourceLoc, format, ""); } \
+    inline void NAME (std::string_view format, const std::source_location& sourceLoc = std::source_location::current()) { NAME(defaultCategory, format, sourceLoc); }
 
 #define DEFINE_LOG_FUNCTION_HELPER(name) \
     DEFINE_LOG_FUNCTION_SUBHELPER6(name) \
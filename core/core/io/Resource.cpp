@@ -171,6 +171,24 @@ namespace Carrot::IO {
         return result;
     }
 
+    MappedResource Resource::map() const {
+        if(data.isRawData) {
+            return MappedResource { data.raw, std::span<const std::uint8_t>{ *data.raw } };
+        }
+
+        auto mapFile = [](const FileHandle& handle) {
+            std::shared_ptr<const std::uint8_t> mapping = handle.map();
+            const std::span<const std::uint8_t> bytes { mapping.get(), mapping ? handle.getSize() : 0 };
+            return MappedResource { std::move(mapping), bytes };
+        };
+
+        if(data.fileHandle) {
+            return mapFile(*data.fileHandle);
+        }
+        FileHandle handle { filename, OpenMode::Read };
+        return mapFile(handle); // the mapping outlives the handle
+    }
+
     void Resource::name(const std::filesystem::path& _filename, const std::string& _name) {
         filename = _filename;
         debugName = _name;
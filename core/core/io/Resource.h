@@ -13,6 +13,35 @@
 namespace Carrot::IO {
     class VirtualFileSystem;
 
+    /**
+     * Read-only view of the entire content of a Resource, obtained via Resource::map.
+     * The data stays valid as long as this object (or one of its copies) is alive, even if the Resource itself is destroyed.
+     */
+    class MappedResource {
+    public:
+        MappedResource() = default;
+
+        std::span<const std::uint8_t> getData() const {
+            return bytes;
+        }
+
+        const std::uint8_t* data() const {
+            return bytes.data();
+        }
+
+        std::size_t size() const {
+            return bytes.size();
+        }
+
+    private:
+        MappedResource(std::shared_ptr<const void> owner, std::span<const std::uint8_t> bytes): owner(std::move(owner)), bytes(bytes) {}
+
+        std::shared_ptr<const void> owner; // mapped file or in-memory data
+        std::span<const std::uint8_t> bytes;
+
+        friend class Resource;
+    };
+
     /**
      * Represents a read-only file that can be on disk, or in memory
      */
@@ -110,6 +139,13 @@ namespace Carrot::IO {
          */
         std::string readText() const;
 
+        /**
+         * Gives access to all data of this resource without copying it: files are mapped in memory (read-only), and
+         * in-memory resources directly expose their data.
+         * Prefer this over readAll for large files which are only read once (textures, models), to avoid keeping two copies in RAM.
+         */
+        MappedResource map() const;
+
     public:
         /// Copies this resource to a new in-memory Resource.
         /// For files, this reads the entire file to memory
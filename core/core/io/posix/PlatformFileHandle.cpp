@@ -0,0 +1,152 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "PlatformFileHandle.h"
+#include "core/utils/Assert.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Carrot::IO {
+    static std::error_code lastError() {
+        return std::error_code{ errno, std::system_category() };
+    }
+
+    PlatformFileHandle* PlatformFileHandle::open(const std::filesystem::path& path, OpenMode openMode) {
+        int flags = O_CLOEXEC;
+        switch(openMode) {
+            case OpenMode::Read:
+                flags |= O_RDONLY;
+                break;
+
+            case OpenMode::NewReadWrite:
+                flags |= O_RDWR | O_CREAT | O_EXCL;
+                break;
+
+            case OpenMode::AlreadyExistingReadWrite:
+                flags |= O_RDWR;
+                break;
+
+            case OpenMode::Write:
+                flags |= O_WRONLY | O_TRUNC;
+                break;
+
+            case OpenMode::Append:
+                flags |= O_RDWR | O_APPEND;
+                break;
+
+            case OpenMode::Invalid:
+            default:
+                verify(false, "Invalid parameter");
+                break;
+        }
+
+        int result;
+        do {
+            result = ::open(path.c_str(), flags, 0644);
+        } while(result < 0 && errno == EINTR);
+
+        if(result < 0) {
+            throw std::filesystem::filesystem_error("Could not open", path, lastError());
+        }
+        PlatformFileHandle* fileHandle = new PlatformFileHandle;
+        fileHandle->fd = result;
+        return fileHandle;
+    }
+
+    void PlatformFileHandle::close() {
+        ::close(fd);
+        fd = -1;
+    }
+
+    void PlatformFileHandle::write(std::span<const std::uint8_t> data) {
+        verify(fd >= 0, "File is not open!");
+        std::size_t written = 0;
+        while(written < data.size()) {
+            const ssize_t result = ::write(fd, data.data() + written, data.size() - written);
+            if(result < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                throw std::filesystem::filesystem_error("Could not write to file", lastError());
+            }
+            if(result == 0) {
+                throw std::filesystem::filesystem_error("Could not write all bytes to file", lastError());
+            }
+            written += result;
+        }
+    }
+
+    void PlatformFileHandle::seek(std::int64_t position, int seekDirection) {
+        int whence;
+        switch(seekDirection) {
+            case SEEK_CUR:
+            case SEEK_SET:
+            case SEEK_END:
+                whence = seekDirection;
+                break;
+            default:
+                verify(false, "Unsupported seek operation");
+                return;
+        }
+        if(lseek(fd, position, whence) < 0) {
+            throw std::filesystem::filesystem_error("Could not seek", lastError());
+        }
+    }
+
+    void PlatformFileHandle::read(std::span<std::uint8_t> data) const {
+        verify(fd >= 0, "File is not open!");
+
+        // read() may return less than asked (large reads, signals), loop until the span is filled
+        std::size_t readCount = 0;
+        while(readCount < data.size_bytes()) {
+            const ssize_t result = ::read(fd, data.data() + readCount, data.size_bytes() - readCount);
+            if(result < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                throw std::filesystem::filesystem_error("Could not read", lastError());
+            }
+            if(result == 0) {
+                throw std::filesystem::filesystem_error("Could not read all bytes", std::make_error_code(std::errc::io_error));
+            }
+            readCount += result;
+        }
+    }
+
+    std::uint64_t PlatformFileHandle::tell() const {
+        const off_t position = lseek(fd, 0, SEEK_CUR);
+        if(position < 0) {
+            throw std::filesystem::filesystem_error("Could not get file position", lastError());
+        }
+        return static_cast<std::uint64_t>(position);
+    }
+
+    std::shared_ptr<const std::uint8_t> PlatformFileHandle::map(std::uint64_t size) const {
+        verify(fd >= 0, "File is not open!");
+        if(size == 0) {
+            // mmap does not support empty mappings
+            return nullptr;
+        }
+
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(address == MAP_FAILED) {
+            throw std::filesystem::filesystem_error("Could not map file", lastError());
+        }
+        return std::shared_ptr<const std::uint8_t>(static_cast<const std::uint8_t*>(address), [size](const std::uint8_t* p) {
+            munmap(const_cast<std::uint8_t*>(p), size);
+        });
+    }
+
+    PlatformFileHandle::~PlatformFileHandle() {
+        if(fd >= 0) {
+            close();
+        }
+    }
+} // Carrot::IO
+
+#endif // _WIN32
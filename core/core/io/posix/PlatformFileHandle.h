@@ -0,0 +1,41 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+#ifndef _WIN32
+#include <core/io/FileHandle.h>
+
+namespace Carrot::IO {
+
+    /**
+     * Platform file handle for POSIX systems (Linux, macOS)
+     */
+    class PlatformFileHandle {
+    public:
+        /**
+         * Responsibility of user code to delete pointer
+         */
+        static PlatformFileHandle* open(const std::filesystem::path& path, OpenMode openMode);
+        ~PlatformFileHandle();
+
+        void close();
+        void write(std::span<const std::uint8_t> data);
+        void seek(std::int64_t position, int seekDirection);
+
+        void read(std::span<std::uint8_t> data) const;
+        std::uint64_t tell() const;
+
+        /**
+         * Maps the first 'size' bytes of the file in memory, read-only. The mapping is released once the returned pointer
+         * (and all its copies) are destroyed, and stays valid after this handle is closed.
+         */
+        std::shared_ptr<const std::uint8_t> map(std::uint64_t size) const;
+
+    private:
+        int fd = -1;
+    };
+
+} // Carrot::IO
+
+#endif
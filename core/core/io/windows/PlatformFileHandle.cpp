@@ -123,6 +123,28 @@ namespace Carrot::IO {
         return position.QuadPart;
     }
 
+    std::shared_ptr<const std::uint8_t> PlatformFileHandle::map(std::uint64_t size) const {
+        verify(handle != INVALID_HANDLE_VALUE, "File is not open!");
+        if(size == 0) {
+            // CreateFileMapping does not support empty files
+            return nullptr;
+        }
+
+        HANDLE mapping = CreateFileMapping(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mapping == nullptr) {
+            throw std::filesystem::filesystem_error("Could not create file mapping", std::error_code{ static_cast<int>(GetLastError()), std::system_category() });
+        }
+        void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+        const DWORD error = GetLastError();
+        CloseHandle(mapping); // the view keeps the mapping alive
+        if(address == nullptr) {
+            throw std::filesystem::filesystem_error("Could not map file", std::error_code{ static_cast<int>(error), std::system_category() });
+        }
+        return std::shared_ptr<const std::uint8_t>(static_cast<const std::uint8_t*>(address), [](const std::uint8_t* p) {
+            UnmapViewOfFile(p);
+        });
+    }
+
     PlatformFileHandle::~PlatformFileHandle() {
         if(handle != INVALID_HANDLE_VALUE) {
             close();
@@ -28,6 +28,12 @@ namespace Carrot::IO {
         void read(std::span<std::uint8_t> data) const;
         std::uint64_t tell() const;
 
+        /**
+         * Maps the first 'size' bytes of the file in memory, read-only. The mapping is released once the returned pointer
+         * (and all its copies) are destroyed, and stays valid after this handle is closed.
+         */
+        std::shared_ptr<const std::uint8_t> map(std::uint64_t size) const;
+
     private:
         HANDLE handle = INVALID_HANDLE_VALUE;
     };
@@ -0,0 +1,179 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "CullingGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <robin_hood.h>
+#include <core/tasks/Tasks.h>
+#include <core/utils/Assert.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define CARROT_CULLING_SSE 1
+#include <xmmintrin.h>
+#else
+#define CARROT_CULLING_SSE 0
+#endif
+
+namespace Carrot::Math {
+    /// Cell coordinates are clamped to this range, so that they fit in 21 bits each
+    static constexpr float MaxCellCoordinate = static_cast<float>((1 << 20) - 1);
+
+    enum class Containment {
+        Outside,
+        Inside,
+        Intersecting,
+    };
+
+    static std::uint64_t toCellCoordinate(float position, float cellSize) {
+        float coordinate = std::floor(position / cellSize);
+        // also catches NaNs
+        if(!(coordinate > -MaxCellCoordinate)) {
+            coordinate = -MaxCellCoordinate;
+        }
+        if(!(coordinate < MaxCellCoordinate)) {
+            coordinate = MaxCellCoordinate;
+        }
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(coordinate) + (1 << 20));
+    }
+
+    static Containment classify(const Math::AABB& box, const std::array<Math::Plane, 6>& frustum) {
+        Containment result = Containment::Inside;
+        for(const Math::Plane& plane : frustum) {
+            // corners of the box which are the furthest along the normal, and against it
+            const glm::vec3 positiveCorner = glm::mix(box.min, box.max, glm::greaterThanEqual(plane.normal, glm::vec3{0.0f}));
+            const glm::vec3 negativeCorner = glm::mix(box.max, box.min, glm::greaterThanEqual(plane.normal, glm::vec3{0.0f}));
+            if(plane.getSignedDistance(positiveCorner) < 0.0f) {
+                return Containment::Outside;
+            }
+            if(plane.getSignedDistance(negativeCorner) < 0.0f) {
+                result = Containment::Intersecting;
+            }
+        }
+        return result;
+    }
+
+    CullingGrid::CullingGrid(float cellSize): cellSize(cellSize) {
+        verify(cellSize > 0.0f, "Cell size must be positive");
+    }
+
+    void CullingGrid::rebuild(std::span<const Math::Sphere> bounds) {
+        verify(bounds.size() <= UINT32_MAX, "Too many objects");
+        const std::size_t objectCount = bounds.size();
+
+        cells.clear();
+        cellOfObject.resize(objectCount);
+        robin_hood::unordered_flat_map<std::uint64_t, std::uint32_t> cellIndices;
+        for(std::size_t i = 0; i < objectCount; i++) {
+            const Math::Sphere& sphere = bounds[i];
+            const std::uint64_t key = toCellCoordinate(sphere.center.x, cellSize)
+                                    | (toCellCoordinate(sphere.center.y, cellSize) << 21)
+                                    | (toCellCoordinate(sphere.center.z, cellSize) << 42);
+            const glm::vec3 sphereMin = sphere.center - sphere.radius;
+            const glm::vec3 sphereMax = sphere.center + sphere.radius;
+
+            auto [iter, inserted] = cellIndices.try_emplace(key, static_cast<std::uint32_t>(cells.size()));
+            if(inserted) {
+                cells.emplace_back(Cell {
+                    .bounds = Math::AABB { sphereMin, sphereMax },
+                });
+            }
+            Cell& cell = cells[iter->second];
+            cell.bounds.min = glm::min(cell.bounds.min, sphereMin);
+            cell.bounds.max = glm::max(cell.bounds.max, sphereMax);
+            cell.objectCount++;
+            cellOfObject[i] = iter->second;
+        }
+
+        std::uint32_t offset = 0;
+        for(Cell& cell : cells) {
+            cell.firstObject = offset;
+            offset += cell.objectCount;
+            cell.objectCount = 0;
+        }
+
+        centersX.resize(objectCount);
+        centersY.resize(objectCount);
+        centersZ.resize(objectCount);
+        radii.resize(objectCount);
+        objectIndices.resize(objectCount);
+        for(std::size_t i = 0; i < objectCount; i++) {
+            Cell& cell = cells[cellOfObject[i]];
+            const std::uint32_t slot = cell.firstObject + cell.objectCount++;
+            centersX[slot] = bounds[i].center.x;
+            centersY[slot] = bounds[i].center.y;
+            centersZ[slot] = bounds[i].center.z;
+            radii[slot] = bounds[i].radius;
+            objectIndices[slot] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    void CullingGrid::cull(const std::array<Math::Plane, 6>& frustum, std::span<std::uint8_t> visibility) const {
+        verify(visibility.size() == objectIndices.size(), "Visibility must have one element per object");
+
+        if(Carrot::Async::parallelFor != nullptr && objectIndices.size() >= MinItemsForParallelCulling && cells.size() > 1) {
+            Carrot::Async::parallelFor(cells.size(), [&](std::size_t cellIndex) {
+                cullCell(cells[cellIndex], frustum, visibility);
+            }, 16);
+        } else {
+            for(const Cell& cell : cells) {
+                cullCell(cell, frustum, visibility);
+            }
+        }
+    }
+
+    void CullingGrid::cullCell(const Cell& cell, const std::array<Math::Plane, 6>& frustum, std::span<std::uint8_t> visibility) const {
+        const std::uint32_t begin = cell.firstObject;
+        const std::uint32_t end = cell.firstObject + cell.objectCount;
+        const Containment containment = classify(cell.bounds, frustum);
+        if(containment != Containment::Intersecting) {
+            const std::uint8_t visible = containment == Containment::Inside ? 1 : 0;
+            for(std::uint32_t i = begin; i < end; i++) {
+                visibility[objectIndices[i]] = visible;
+            }
+            return;
+        }
+
+        std::uint32_t i = begin;
+#if CARROT_CULLING_SSE
+        // test 4 spheres at once: a sphere is culled if it is fully behind one of the planes
+        for(; i + 4 <= end; i += 4) {
+            const __m128 x = _mm_loadu_ps(centersX.data() + i);
+            const __m128 y = _mm_loadu_ps(centersY.data() + i);
+            const __m128 z = _mm_loadu_ps(centersZ.data() + i);
+            const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii.data() + i));
+            __m128 culled = _mm_setzero_ps();
+            for(const Math::Plane& plane : frustum) {
+                const __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.normal.x)), _mm_mul_ps(y, _mm_set1_ps(plane.normal.y))),
+                        _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.normal.z)), _mm_set1_ps(plane.distanceFromOrigin)));
+                culled = _mm_or_ps(culled, _mm_cmplt_ps(distance, negativeRadius));
+            }
+            const int mask = _mm_movemask_ps(culled);
+            for(std::uint32_t lane = 0; lane < 4; lane++) {
+                visibility[objectIndices[i + lane]] = (mask & (1 << lane)) ? 0 : 1;
+            }
+        }
+#endif
+        for(; i < end; i++) {
+            const glm::vec3 center { centersX[i], centersY[i], centersZ[i] };
+            bool visible = true;
+            for(const Math::Plane& plane : frustum) {
+                if(plane.getSignedDistance(center) < -radii[i]) {
+                    visible = false;
+                    break;
+                }
+            }
+            visibility[objectIndices[i]] = visible ? 1 : 0;
+        }
+    }
+
+    std::size_t CullingGrid::getObjectCount() const {
+        return objectIndices.size();
+    }
+
+    std::size_t CullingGrid::getCellCount() const {
+        return cells.size();
+    }
+}
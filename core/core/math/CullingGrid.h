@@ -0,0 +1,71 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <core/math/AABB.h>
+#include <core/math/Plane.h>
+#include <core/math/Sphere.h>
+
+namespace Carrot::Math {
+    /**
+     * Loose grid of bounding spheres, used to find which objects are visible from a frustum.
+     * Objects are put in the cell containing their center, and each cell keeps the box enclosing all of its objects.
+     * Culling is hierarchical: cells fully outside of the frustum are skipped, objects of cells fully inside are accepted
+     * without being tested, and objects of the remaining cells are tested 4 at a time (with SSE when available).
+     *
+     * Meant to be rebuilt each frame from world-space bounds, then queried once per viewport.
+     */
+    class CullingGrid {
+    public:
+        /// Below this count, culling is done on the calling thread
+        static constexpr std::size_t MinItemsForParallelCulling = 4096;
+
+        /// \param cellSize size of a cell, in world units. Objects much larger than a cell still work, but make their cell less useful
+        explicit CullingGrid(float cellSize = 16.0f);
+
+        /**
+         * Replaces the contents of this grid.
+         * \param bounds world-space bounds of each object. The index of a sphere in this span is the index used by 'cull'
+         */
+        void rebuild(std::span<const Math::Sphere> bounds);
+
+        /**
+         * Tests all objects from the last 'rebuild' against the given frustum. Uses Carrot::Async::parallelFor when available
+         * and there are enough objects.
+         * \param frustum normalized frustum planes, pointing inside the frustum (same convention as Camera::isInFrustum)
+         * \param visibility output, must have one element per object. Set to 1 if the object may be visible, 0 if it is not
+         */
+        void cull(const std::array<Math::Plane, 6>& frustum, std::span<std::uint8_t> visibility) const;
+
+        std::size_t getObjectCount() const;
+        std::size_t getCellCount() const;
+
+    private:
+        struct Cell {
+            Math::AABB bounds; // encloses all objects of this cell
+            std::uint32_t firstObject = 0;
+            std::uint32_t objectCount = 0;
+        };
+
+        void cullCell(const Cell& cell, const std::array<Math::Plane, 6>& frustum, std::span<std::uint8_t> visibility) const;
+
+        float cellSize = 1.0f;
+        std::vector<Cell> cells;
+
+        // objects sorted by cell, as a structure of arrays for SIMD tests
+        std::vector<float> centersX;
+        std::vector<float> centersY;
+        std::vector<float> centersZ;
+        std::vector<float> radii;
+        std::vector<std::uint32_t> objectIndices;
+
+        // scratch memory kept between rebuilds
+        std::vector<std::uint32_t> cellOfObject;
+    };
+}
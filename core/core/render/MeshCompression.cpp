@@ -0,0 +1,61 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "MeshCompression.h"
+#include <algorithm>
+#include <stdexcept>
+#include <meshoptimizer.h>
+#include <core/utils/Assert.h>
+#include <core/utils/stringmanip.h>
+
+namespace Carrot::MeshCompression {
+    /// Upper bound of vertex indices, used to size output buffers
+    static std::size_t computeVertexCount(std::span<const std::uint32_t> indices) {
+        if(indices.empty()) {
+            return 0;
+        }
+        return static_cast<std::size_t>(*std::max_element(indices.begin(), indices.end())) + 1;
+    }
+
+    static void checkDecodeResult(int result, const char* streamType) {
+        if(result != 0) {
+            throw std::runtime_error(Carrot::sprintf("Failed to decode %s (error %d)", streamType, result));
+        }
+    }
+
+    std::vector<std::uint8_t> encodeVertexBuffer(const void* pVertices, std::size_t vertexCount, std::size_t vertexSize) {
+        verify(vertexSize % 4 == 0 && vertexSize <= 256, "Vertex size must be a multiple of 4, and at most 256");
+        std::vector<std::uint8_t> encoded;
+        encoded.resize(meshopt_encodeVertexBufferBound(vertexCount, vertexSize));
+        encoded.resize(meshopt_encodeVertexBuffer(encoded.data(), encoded.size(), pVertices, vertexCount, vertexSize));
+        return encoded;
+    }
+
+    void decodeVertexBuffer(std::span<const std::uint8_t> encoded, void* pOutVertices, std::size_t vertexCount, std::size_t vertexSize) {
+        checkDecodeResult(meshopt_decodeVertexBuffer(pOutVertices, vertexCount, vertexSize, encoded.data(), encoded.size()), "vertex buffer");
+    }
+
+    std::vector<std::uint8_t> encodeIndexBuffer(std::span<const std::uint32_t> indices) {
+        verify(indices.size() % 3 == 0, "Index buffer must be a triangle list");
+        std::vector<std::uint8_t> encoded;
+        encoded.resize(meshopt_encodeIndexBufferBound(indices.size(), computeVertexCount(indices)));
+        encoded.resize(meshopt_encodeIndexBuffer(encoded.data(), encoded.size(), indices.data(), indices.size()));
+        return encoded;
+    }
+
+    void decodeIndexBuffer(std::span<const std::uint8_t> encoded, std::span<std::uint32_t> outIndices) {
+        checkDecodeResult(meshopt_decodeIndexBuffer(outIndices.data(), outIndices.size(), sizeof(std::uint32_t), encoded.data(), encoded.size()), "index buffer");
+    }
+
+    std::vector<std::uint8_t> encodeIndexSequence(std::span<const std::uint32_t> indices) {
+        std::vector<std::uint8_t> encoded;
+        encoded.resize(meshopt_encodeIndexSequenceBound(indices.size(), computeVertexCount(indices)));
+        encoded.resize(meshopt_encodeIndexSequence(encoded.data(), encoded.size(), indices.data(), indices.size()));
+        return encoded;
+    }
+
+    void decodeIndexSequence(std::span<const std::uint8_t> encoded, std::span<std::uint32_t> outIndices) {
+        checkDecodeResult(meshopt_decodeIndexSequence(outIndices.data(), outIndices.size(), sizeof(std::uint32_t), encoded.data(), encoded.size()), "index sequence");
+    }
+}
@@ -0,0 +1,35 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// Lossless compression of vertex and index streams, with meshoptimizer codecs.
+/// Decompression is fast enough to be done while loading. Decoding functions throw on invalid data
+namespace Carrot::MeshCompression {
+    /// Compresses 'vertexCount' vertices of 'vertexSize' bytes each. 'vertexSize' must be a multiple of 4, and at most 256
+    std::vector<std::uint8_t> encodeVertexBuffer(const void* pVertices, std::size_t vertexCount, std::size_t vertexSize);
+    void decodeVertexBuffer(std::span<const std::uint8_t> encoded, void* pOutVertices, std::size_t vertexCount, std::size_t vertexSize);
+
+    template<typename Vertex>
+    std::vector<std::uint8_t> encodeVertexBuffer(std::span<const Vertex> vertices) {
+        return encodeVertexBuffer(vertices.data(), vertices.size(), sizeof(Vertex));
+    }
+
+    template<typename Vertex>
+    void decodeVertexBuffer(std::span<const std::uint8_t> encoded, std::span<Vertex> outVertices) {
+        decodeVertexBuffer(encoded, outVertices.data(), outVertices.size(), sizeof(Vertex));
+    }
+
+    /// Compresses a triangle list (index count must be a multiple of 3)
+    std::vector<std::uint8_t> encodeIndexBuffer(std::span<const std::uint32_t> indices);
+    void decodeIndexBuffer(std::span<const std::uint8_t> encoded, std::span<std::uint32_t> outIndices);
+
+    /// Compresses a list of indices which is not a triangle list (for instance, the list of vertices used by meshlets)
+    std::vector<std::uint8_t> encodeIndexSequence(std::span<const std::uint32_t> indices);
+    void decodeIndexSequence(std::span<const std::uint8_t> encoded, std::span<std::uint32_t> outIndices);
+}
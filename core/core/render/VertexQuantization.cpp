@@ -0,0 +1,97 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "VertexQuantization.h"
+#include <limits>
+#include <glm/packing.hpp>
+#include <core/utils/Assert.h>
+
+namespace Carrot::VertexQuantization {
+    constexpr std::uint32_t NegativeBitangentBit = 1u << 31;
+
+    /// Avoids divisions by 0 for flat bounds
+    static glm::vec3 safeExtent(const Math::AABB& bounds) {
+        const glm::vec3 extent = bounds.max - bounds.min;
+        return glm::max(extent, glm::vec3 { std::numeric_limits<float>::min() });
+    }
+
+    static glm::vec2 signNotZero(const glm::vec2& v) {
+        return { v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f };
+    }
+
+    Math::AABB computeBounds(std::span<const PackedVertex> vertices) {
+        if(vertices.empty()) {
+            return {};
+        }
+        Math::AABB bounds { vertices[0].pos, vertices[0].pos };
+        for(const PackedVertex& vertex : vertices) {
+            bounds.min = glm::min(bounds.min, vertex.pos);
+            bounds.max = glm::max(bounds.max, vertex.pos);
+        }
+        return bounds;
+    }
+
+    glm::vec3 getMaxPositionError(const Math::AABB& bounds) {
+        // values are rounded to the nearest step
+        return (bounds.max - bounds.min) / 65535.0f * 0.5f;
+    }
+
+    glm::vec2 encodeOctahedral(const glm::vec3& direction) {
+        const float l1Norm = glm::abs(direction.x) + glm::abs(direction.y) + glm::abs(direction.z);
+        if(l1Norm <= 0.0f) {
+            return glm::vec2 { 0.0f };
+        }
+        glm::vec2 p = glm::vec2 { direction.x, direction.y } / l1Norm;
+        if(direction.z < 0.0f) {
+            // fold lower hemisphere over the diagonals
+            p = (1.0f - glm::abs(glm::vec2 { p.y, p.x })) * signNotZero(p);
+        }
+        return p;
+    }
+
+    glm::vec3 decodeOctahedral(const glm::vec2& encoded) {
+        glm::vec3 n { encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y) };
+        const float t = glm::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    QuantizedVertex encode(const PackedVertex& vertex, const Math::AABB& bounds) {
+        const glm::vec3 relativePosition = glm::clamp((vertex.pos - bounds.min) / safeExtent(bounds), 0.0f, 1.0f);
+
+        QuantizedVertex result;
+        result.positionXY = glm::packUnorm2x16(glm::vec2 { relativePosition.x, relativePosition.y });
+        result.positionZ = glm::packUnorm2x16(glm::vec2 { relativePosition.z, 0.0f });
+        if(vertex.tangent.w < 0.0f) {
+            result.positionZ |= NegativeBitangentBit;
+        }
+        result.normal = glm::packSnorm2x16(encodeOctahedral(vertex.normal));
+        result.tangent = glm::packSnorm2x16(encodeOctahedral(glm::vec3 { vertex.tangent }));
+        result.uv = glm::packHalf2x16(vertex.uv);
+        result.color = glm::packUnorm4x8(glm::vec4 { vertex.color, 1.0f });
+        return result;
+    }
+
+    PackedVertex decode(const QuantizedVertex& vertex, const Math::AABB& bounds) {
+        const glm::vec2 xy = glm::unpackUnorm2x16(vertex.positionXY);
+        const float z = glm::unpackUnorm2x16(vertex.positionZ & 0xFFFFu).x;
+
+        PackedVertex result;
+        result.pos = bounds.min + glm::vec3 { xy, z } * (bounds.max - bounds.min);
+        result.normal = decodeOctahedral(glm::unpackSnorm2x16(vertex.normal));
+        const float bitangentSign = (vertex.positionZ & NegativeBitangentBit) != 0 ? -1.0f : 1.0f;
+        result.tangent = glm::vec4 { decodeOctahedral(glm::unpackSnorm2x16(vertex.tangent)), bitangentSign };
+        result.uv = glm::unpackHalf2x16(vertex.uv);
+        result.color = glm::vec3 { glm::unpackUnorm4x8(vertex.color) };
+        return result;
+    }
+
+    void encode(std::span<const PackedVertex> vertices, const Math::AABB& bounds, std::span<QuantizedVertex> out) {
+        verify(vertices.size() == out.size(), "Mismatched sizes");
+        for(std::size_t i = 0; i < vertices.size(); i++) {
+            out[i] = encode(vertices[i], bounds);
+        }
+    }
+}
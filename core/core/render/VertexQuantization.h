@@ -0,0 +1,31 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <core/math/AABB.h>
+#include <core/render/VertexTypes.h>
+
+/// Conversion between PackedVertex and QuantizedVertex.
+/// Keep in sync with decodeQuantizedVertex in shaders/includes/buffers.glsl !!
+namespace Carrot::VertexQuantization {
+    /// Bounds of the positions of the given vertices, to use for quantization
+    Math::AABB computeBounds(std::span<const PackedVertex> vertices);
+
+    /// Largest error on each axis of positions quantized with the given bounds
+    glm::vec3 getMaxPositionError(const Math::AABB& bounds);
+
+    QuantizedVertex encode(const PackedVertex& vertex, const Math::AABB& bounds);
+    PackedVertex decode(const QuantizedVertex& vertex, const Math::AABB& bounds);
+
+    /// Encodes each vertex of 'vertices' into 'out', which must have the same size
+    void encode(std::span<const PackedVertex> vertices, const Math::AABB& bounds, std::span<QuantizedVertex> out);
+
+    /// Maps a unit vector to the [-1; 1]² square (octahedral mapping)
+    glm::vec2 encodeOctahedral(const glm::vec3& direction);
+
+    /// Inverse of encodeOctahedral, returns a normalized vector
+    glm::vec3 decodeOctahedral(const glm::vec2& encoded);
+}
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Carrot {
@@ -44,6 +45,21 @@ namespace Carrot {
         explicit PackedVertex(const Vertex&);
     };
 
+    /// Compact version of "PackedVertex" (24 bytes instead of 60), intended for meshlets.
+    /// Positions are quantized relative to bounds given when encoding (the bounds of the whole mesh for meshlets: vertices shared
+    /// by neighbouring meshlets must be quantized the same way, otherwise cracks appear), normals and tangents use octahedral
+    /// encoding, UVs are half-floats and colors use 8 bits per channel.
+    /// See core/render/VertexQuantization.h for encoding and decoding
+    struct QuantizedVertex {
+        std::uint32_t positionXY = 0; //< unorm16 x2, relative to the quantization bounds
+        std::uint32_t positionZ = 0; //< unorm16 in the low bits, highest bit is set if the bitangent sign is negative
+        std::uint32_t normal = 0; //< octahedral, snorm16 x2
+        std::uint32_t tangent = 0; //< octahedral, snorm16 x2
+        std::uint32_t uv = 0; //< half x2
+        std::uint32_t color = 0; //< unorm8 x4, alpha is unused
+    };
+    static_assert(sizeof(QuantizedVertex) == 24);
+
     struct ComputeSkinnedVertex {
         /// World position of the vertex
         alignas(16) glm::vec4 pos;
@@ -0,0 +1,768 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "CookedModel.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <core/math/BasicFunctions.h>
+#include <core/utils/Assert.h>
+#include <core/utils/Profiling.h>
+#include <core/utils/stringmanip.h>
+
+namespace Carrot::Render::CookedModel {
+    // everything inside a cooked model is used directly from the file bytes
+    static_assert(std::is_trivially_copyable_v<Header>);
+    static_assert(std::is_trivially_copyable_v<SectionEntry>);
+    static_assert(std::is_trivially_copyable_v<SceneRecord>);
+    static_assert(std::is_trivially_copyable_v<MaterialRecord>);
+    static_assert(std::is_trivially_copyable_v<PrimitiveRecord>);
+    static_assert(std::is_trivially_copyable_v<NodeRecord>);
+    static_assert(std::is_trivially_copyable_v<PrecomputedBLASRecord>);
+    static_assert(std::is_trivially_copyable_v<BoneMappingRecord>);
+    static_assert(std::is_trivially_copyable_v<OffsetMatrixRecord>);
+    static_assert(std::is_trivially_copyable_v<AnimationNameRecord>);
+    static_assert(std::is_trivially_copyable_v<AnimationRecord>);
+    static_assert(std::is_trivially_copyable_v<KeyframeRecord>);
+    static_assert(std::is_trivially_copyable_v<Carrot::Vertex>);
+    static_assert(std::is_trivially_copyable_v<Carrot::SkinnedVertex>);
+    static_assert(std::is_trivially_copyable_v<Meshlet>);
+    static_assert(std::is_trivially_copyable_v<Carrot::QuantizedVertex>);
+    static_assert(alignof(Carrot::SkinnedVertex) <= SectionAlignment);
+
+    // -- View
+
+    View::View(std::span<const std::uint8_t> bytes): bytes(bytes) {
+        if(bytes.size() < sizeof(Header)) {
+            throw std::runtime_error("Not enough data for a cooked model header");
+        }
+        if(reinterpret_cast<std::uintptr_t>(bytes.data()) % SectionAlignment != 0) {
+            throw std::runtime_error(Carrot::sprintf("Cooked model data must be aligned to %llu bytes", SectionAlignment));
+        }
+
+        const Header& header = *reinterpret_cast<const Header*>(bytes.data());
+        if(header.magic != Magic) {
+            throw std::runtime_error("Not a cooked model");
+        }
+        if(header.version != Version) {
+            throw std::runtime_error(Carrot::sprintf("Unsupported cooked model version %u (expected %u)", header.version, Version));
+        }
+        if(header.fileSize != bytes.size()) {
+            throw std::runtime_error(Carrot::sprintf("Cooked model size mismatch: header says %llu bytes, got %llu", header.fileSize, static_cast<std::uint64_t>(bytes.size())));
+        }
+        if(header.sectionCount > static_cast<std::uint32_t>(SectionType::Count)
+        || sizeof(Header) + header.sectionCount * sizeof(SectionEntry) > bytes.size()) {
+            throw std::runtime_error("Invalid cooked model section table");
+        }
+
+        sections = std::span { reinterpret_cast<const SectionEntry*>(bytes.data() + sizeof(Header)), header.sectionCount };
+        std::uint32_t seenSections = 0;
+        for(const SectionEntry& entry : sections) {
+            const std::uint32_t typeIndex = static_cast<std::uint32_t>(entry.type);
+            if(typeIndex >= static_cast<std::uint32_t>(SectionType::Count)) {
+                throw std::runtime_error(Carrot::sprintf("Unknown section type %u", typeIndex));
+            }
+            if(seenSections & (1u << typeIndex)) {
+                throw std::runtime_error(Carrot::sprintf("Duplicate section %u", typeIndex));
+            }
+            seenSections |= 1u << typeIndex;
+
+            if(entry.offset % SectionAlignment != 0) {
+                throw std::runtime_error(Carrot::sprintf("Section %u is not aligned", typeIndex));
+            }
+            if(entry.offset > bytes.size() || entry.size > bytes.size() - entry.offset) {
+                throw std::runtime_error(Carrot::sprintf("Section %u is out of bounds", typeIndex));
+            }
+            if(entry.elementSize == 0 || entry.size % entry.elementSize != 0) {
+                throw std::runtime_error(Carrot::sprintf("Section %u has an invalid size", typeIndex));
+            }
+        }
+    }
+
+    const SectionEntry* View::findSection(SectionType type, std::size_t elementSize) const {
+        for(const SectionEntry& entry : sections) {
+            if(entry.type != type) {
+                continue;
+            }
+            if(entry.elementSize != elementSize) {
+                throw std::runtime_error(Carrot::sprintf("Section %u has records of %u bytes, expected %llu",
+                                                         static_cast<std::uint32_t>(type), entry.elementSize, static_cast<std::uint64_t>(elementSize)));
+            }
+            return &entry;
+        }
+        return nullptr;
+    }
+
+    void View::checkRange(std::size_t sectionElementCount, const Range& range) const {
+        if(range.first > sectionElementCount || range.count > sectionElementCount - range.first) {
+            throw std::runtime_error(Carrot::sprintf("Range [%llu; %llu+%llu[ is out of bounds (section has %llu elements)",
+                                                     range.first, range.first, range.count, static_cast<std::uint64_t>(sectionElementCount)));
+        }
+    }
+
+    std::string_view View::getString(const StringRef& ref) const {
+        std::span<const char> chars = getRange<char>(SectionType::Strings, Range { ref.offset, ref.length });
+        return std::string_view { chars.data(), chars.size() };
+    }
+
+    bool isCookedModel(std::span<const std::uint8_t> bytes) {
+        if(bytes.size() < sizeof(Header)) {
+            return false;
+        }
+        std::uint32_t magic;
+        std::memcpy(&magic, bytes.data(), sizeof(magic));
+        return magic == Magic;
+    }
+
+    // -- Cooking
+
+    template<typename T>
+    static Range append(std::vector<T>& section, std::span<const T> elements) {
+        Range range { section.size(), elements.size() };
+        section.insert(section.end(), elements.begin(), elements.end());
+        return range;
+    }
+
+    static void copyVertexMembers(Carrot::Vertex& destination, const Carrot::Vertex& source) {
+        destination.pos = source.pos;
+        destination.color = source.color;
+        destination.normal = source.normal;
+        destination.tangent = source.tangent;
+        destination.uv = source.uv;
+    }
+
+    static void copyVertexMembers(Carrot::SkinnedVertex& destination, const Carrot::SkinnedVertex& source) {
+        copyVertexMembers(static_cast<Carrot::Vertex&>(destination), source);
+        destination.boneWeights = source.boneWeights;
+        destination.boneIDs = source.boneIDs;
+    }
+
+    /// Vertex types have padding between their members (alignas(16)): vertices are copied member by member over zeroed
+    /// memory, so that the padding bytes of the source never end up in the file and cooking is deterministic
+    template<typename VertexType>
+    static Range appendVertices(std::vector<VertexType>& section, std::span<const VertexType> vertices) {
+        Range range { section.size(), vertices.size() };
+        section.resize(section.size() + vertices.size());
+        VertexType* pDestination = section.data() + range.first;
+        std::memset(static_cast<void*>(pDestination), 0, vertices.size() * sizeof(VertexType));
+        for(std::size_t i = 0; i < vertices.size(); i++) {
+            copyVertexMembers(pDestination[i], vertices[i]);
+        }
+        return range;
+    }
+
+    struct SectionData {
+        SectionType type;
+        std::uint32_t elementSize;
+        std::span<const std::uint8_t> bytes;
+    };
+
+    template<typename T>
+    static SectionData makeSection(SectionType type, const std::vector<T>& elements) {
+        return SectionData {
+            .type = type,
+            .elementSize = sizeof(T),
+            .bytes = std::span { reinterpret_cast<const std::uint8_t*>(elements.data()), elements.size() * sizeof(T) },
+        };
+    }
+
+    std::vector<std::uint8_t> cook(const LoadedScene& scene) {
+        ZoneScoped;
+        std::vector<char> strings;
+        std::unordered_map<std::string, StringRef> stringRefs; // names are often repeated (bones)
+        auto addString = [&](std::string_view str) -> StringRef {
+            auto [iter, wasNew] = stringRefs.try_emplace(std::string { str });
+            if(wasNew) {
+                verify(strings.size() + str.size() <= std::numeric_limits<std::uint32_t>::max(), "Too many strings in model");
+                iter->second = StringRef { static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(str.size()) };
+                strings.insert(strings.end(), str.begin(), str.end());
+            }
+            return iter->second;
+        };
+        auto addPath = [&](const IO::VFS::Path& path) -> StringRef {
+            if(path.isEmpty()) {
+                return {};
+            }
+            return addString(path.toString());
+        };
+
+        std::vector<SceneRecord> sceneRecords;
+        SceneRecord& sceneRecord = sceneRecords.emplace_back();
+        if(scene.nodeHierarchy) {
+            sceneRecord.hasNodeHierarchy = 1;
+            sceneRecord.globalInverseTransform = scene.nodeHierarchy->getGlobalInverseTransform();
+        }
+
+        std::vector<MaterialRecord> materials;
+        materials.reserve(scene.materials.size());
+        for(const LoadedMaterial& material : scene.materials) {
+            MaterialRecord& record = materials.emplace_back();
+            record.name = addString(material.name);
+            record.blendMode = static_cast<std::uint32_t>(material.blendMode);
+            record.metallicFactor = material.metallicFactor;
+            record.roughnessFactor = material.roughnessFactor;
+            record.albedo = addPath(material.albedo);
+            record.normalMap = addPath(material.normalMap);
+            record.metallicRoughness = addPath(material.metallicRoughness);
+            record.occlusion = addPath(material.occlusion);
+            record.emissive = addPath(material.emissive);
+            record.baseColorFactor = material.baseColorFactor;
+            record.emissiveFactor = material.emissiveFactor;
+        }
+
+        std::vector<PrimitiveRecord> primitives;
+        std::vector<Carrot::Vertex> vertices;
+        std::vector<Carrot::SkinnedVertex> skinnedVertices;
+        std::vector<std::uint32_t> indices;
+        std::vector<Meshlet> meshlets;
+        std::vector<Carrot::QuantizedVertex> quantizedVertices;
+        primitives.reserve(scene.primitives.size());
+        for(const LoadedPrimitive& primitive : scene.primitives) {
+            PrimitiveRecord& record = primitives.emplace_back();
+            record.name = addString(primitive.name);
+            record.flags = (primitive.isSkinned ? PrimitiveRecord::Skinned : 0)
+                         | (primitive.hadTangents ? PrimitiveRecord::HadTangents : 0)
+                         | (primitive.hadNormals ? PrimitiveRecord::HadNormals : 0)
+                         | (primitive.hadTexCoords ? PrimitiveRecord::HadTexCoords : 0);
+            record.materialIndex = primitive.materialIndex;
+            record.transform = primitive.transform;
+            record.minPos = primitive.minPos;
+            record.maxPos = primitive.maxPos;
+            record.quantizationBoundsMin = primitive.quantizationBounds.min;
+            record.quantizationBoundsMax = primitive.quantizationBounds.max;
+            if(primitive.isSkinned) {
+                record.vertices = appendVertices<Carrot::SkinnedVertex>(skinnedVertices, primitive.skinnedVertices);
+            } else {
+                record.vertices = appendVertices<Carrot::Vertex>(vertices, primitive.vertices);
+            }
+            record.indices = append<std::uint32_t>(indices, primitive.indices);
+            record.meshletVertexIndices = append<std::uint32_t>(indices, primitive.meshletVertexIndices);
+            record.meshletIndices = append<std::uint32_t>(indices, primitive.meshletIndices);
+            record.meshlets = append<Meshlet>(meshlets, primitive.meshlets);
+            record.quantizedVertices = append<Carrot::QuantizedVertex>(quantizedVertices, primitive.quantizedVertices);
+        }
+
+        std::vector<NodeRecord> nodes;
+        std::vector<std::uint64_t> nodeMeshIndices;
+        if(scene.nodeHierarchy) {
+            std::function<void(const SkeletonTreeNode&, std::int32_t)> addNode = [&](const SkeletonTreeNode& node, std::int32_t parentIndex) {
+                const std::int32_t nodeIndex = static_cast<std::int32_t>(nodes.size());
+                NodeRecord& record = nodes.emplace_back();
+                record.name = addString(node.bone.name);
+                record.parentIndex = parentIndex;
+                record.nodeKey = node.nodeKey.value;
+                record.transform = node.bone.transform;
+                record.originalTransform = node.bone.originalTransform;
+                if(node.meshIndices.has_value()) {
+                    record.hasMeshIndices = 1;
+                    record.meshIndices.first = nodeMeshIndices.size();
+                    record.meshIndices.count = node.meshIndices->size();
+                    nodeMeshIndices.insert(nodeMeshIndices.end(), node.meshIndices->begin(), node.meshIndices->end());
+                }
+
+                for(const SkeletonTreeNode& child : node.getChildren()) {
+                    addNode(child, nodeIndex);
+                }
+            };
+            addNode(scene.nodeHierarchy->hierarchy, -1);
+        }
+
+        // maps are sorted to make cooking deterministic
+        std::vector<PrecomputedBLASRecord> blases;
+        std::vector<std::uint8_t> blasBytes;
+        for(const auto& [nodeKey, nodeBLASes] : scene.precomputedBLASes) {
+            for(const auto& [key, blas] : nodeBLASes) {
+                PrecomputedBLASRecord& record = blases.emplace_back();
+                record.nodeKey = nodeKey.value;
+                record.primitiveIndex = key.first;
+                record.groupIndex = key.second;
+                record.bytes.count = blas.blasBytes.size();
+            }
+        }
+        std::sort(blases.begin(), blases.end(), [](const PrecomputedBLASRecord& a, const PrecomputedBLASRecord& b) {
+            return std::tie(a.nodeKey, a.primitiveIndex, a.groupIndex) < std::tie(b.nodeKey, b.primitiveIndex, b.groupIndex);
+        });
+        for(PrecomputedBLASRecord& record : blases) {
+            const PrecomputedBLAS& blas = scene.precomputedBLASes.at(NodeKey { record.nodeKey }).at(Pair<std::uint32_t, std::uint32_t> { record.primitiveIndex, record.groupIndex });
+            record.bytes.first = Math::alignUp<std::uint64_t>(blasBytes.size(), SectionAlignment);
+            blasBytes.resize(record.bytes.first);
+            blasBytes.insert(blasBytes.end(), blas.blasBytes.cdata(), blas.blasBytes.cdata() + blas.blasBytes.size());
+        }
+
+        std::vector<BoneMappingRecord> boneMappings;
+        for(const auto& [meshIndex, mapping] : scene.boneMapping) {
+            for(const auto& [boneName, boneIndex] : mapping) {
+                boneMappings.emplace_back(BoneMappingRecord {
+                    .meshIndex = meshIndex,
+                    .boneIndex = boneIndex,
+                    .boneName = addString(boneName),
+                });
+            }
+        }
+        std::sort(boneMappings.begin(), boneMappings.end(), [](const BoneMappingRecord& a, const BoneMappingRecord& b) {
+            return std::tie(a.meshIndex, a.boneIndex, a.boneName.offset) < std::tie(b.meshIndex, b.boneIndex, b.boneName.offset);
+        });
+
+        std::vector<OffsetMatrixRecord> offsetMatrices;
+        for(const auto& [meshIndex, matrices] : scene.offsetMatrices) {
+            for(const auto& [boneName, matrix] : matrices) {
+                offsetMatrices.emplace_back(OffsetMatrixRecord {
+                    .meshIndex = meshIndex,
+                    .boneName = addString(boneName),
+                    .offsetMatrix = matrix,
+                });
+            }
+        }
+        std::sort(offsetMatrices.begin(), offsetMatrices.end(), [](const OffsetMatrixRecord& a, const OffsetMatrixRecord& b) {
+            return std::tie(a.meshIndex, a.boneName.offset) < std::tie(b.meshIndex, b.boneName.offset);
+        });
+
+        std::vector<AnimationNameRecord> animationNames;
+        for(const auto& [name, animationIndex] : scene.animationMapping) { // std::map: already sorted
+            animationNames.emplace_back(AnimationNameRecord {
+                .name = addString(name),
+                .animationIndex = animationIndex,
+            });
+        }
+
+        std::vector<AnimationRecord> animations;
+        std::vector<KeyframeRecord> keyframes;
+        std::vector<glm::mat4> boneTransforms;
+        animations.reserve(scene.animationData.size());
+        for(const Animation& animation : scene.animationData) {
+            AnimationRecord& record = animations.emplace_back();
+            record.keyframeCount = animation.keyframeCount;
+            record.duration = animation.duration;
+            record.keyframes.first = keyframes.size();
+            record.keyframes.count = animation.keyframes.size();
+            for(const Keyframe& keyframe : animation.keyframes) {
+                keyframes.emplace_back(KeyframeRecord {
+                    .timestamp = keyframe.timestamp,
+                    .boneTransforms = append<glm::mat4>(boneTransforms, keyframe.boneTransforms),
+                });
+            }
+        }
+
+        const SectionData sections[] = {
+            makeSection(SectionType::Strings, strings),
+            makeSection(SectionType::Scene, sceneRecords),
+            makeSection(SectionType::Materials, materials),
+            makeSection(SectionType::Primitives, primitives),
+            makeSection(SectionType::Vertices, vertices),
+            makeSection(SectionType::SkinnedVertices, skinnedVertices),
+            makeSection(SectionType::Indices, indices),
+            makeSection(SectionType::Meshlets, meshlets),
+            makeSection(SectionType::Nodes, nodes),
+            makeSection(SectionType::NodeMeshIndices, nodeMeshIndices),
+            makeSection(SectionType::PrecomputedBLASes, blases),
+            makeSection(SectionType::BLASBytes, blasBytes),
+            makeSection(SectionType::BoneMappings, boneMappings),
+            makeSection(SectionType::OffsetMatrices, offsetMatrices),
+            makeSection(SectionType::AnimationNames, animationNames),
+            makeSection(SectionType::Animations, animations),
+            makeSection(SectionType::Keyframes, keyframes),
+            makeSection(SectionType::BoneTransforms, boneTransforms),
+            makeSection(SectionType::QuantizedVertices, quantizedVertices),
+        };
+        static_assert(std::size(sections) == static_cast<std::size_t>(SectionType::Count));
+
+        Header header;
+        header.sectionCount = static_cast<std::uint32_t>(std::size(sections));
+        std::vector<SectionEntry> entries;
+        std::uint64_t offset = Math::alignUp<std::uint64_t>(sizeof(Header) + sizeof(SectionEntry) * std::size(sections), SectionAlignment);
+        for(const SectionData& section : sections) {
+            entries.emplace_back(SectionEntry {
+                .type = section.type,
+                .elementSize = section.elementSize,
+                .offset = offset,
+                .size = section.bytes.size(),
+            });
+            offset = Math::alignUp<std::uint64_t>(offset + section.bytes.size(), SectionAlignment);
+        }
+        header.fileSize = offset;
+
+        std::vector<std::uint8_t> result;
+        result.resize(header.fileSize); // zero-filled padding
+        std::memcpy(result.data(), &header, sizeof(header));
+        std::memcpy(result.data() + sizeof(header), entries.data(), entries.size() * sizeof(SectionEntry));
+        for(std::size_t i = 0; i < entries.size(); i++) {
+            if(!sections[i].bytes.empty()) {
+                std::memcpy(result.data() + entries[i].offset, sections[i].bytes.data(), sections[i].bytes.size());
+            }
+        }
+        return result;
+    }
+
+    // -- Loading
+
+    template<typename T>
+    static void assign(std::vector<T>& destination, std::span<const T> source) {
+        destination.assign(source.begin(), source.end());
+    }
+
+    LoadedScene load(std::span<const std::uint8_t> bytes, const IO::VFS::Path& modelFilepath) {
+        ZoneScoped;
+        const View view { bytes };
+        LoadedScene scene;
+        scene.debugName = modelFilepath.toString();
+
+        auto toPath = [&](const StringRef& ref) -> IO::VFS::Path {
+            if(ref.length == 0) {
+                return {};
+            }
+            return modelFilepath.relative(IO::Path(view.getString(ref)));
+        };
+
+        std::span<const MaterialRecord> materials = view.getSection<MaterialRecord>(SectionType::Materials);
+        scene.materials.reserve(materials.size());
+        for(const MaterialRecord& record : materials) {
+            LoadedMaterial& material = scene.materials.emplace_back();
+            material.name = view.getString(record.name);
+            material.blendMode = static_cast<LoadedMaterial::BlendMode>(record.blendMode);
+            material.metallicFactor = record.metallicFactor;
+            material.roughnessFactor = record.roughnessFactor;
+            material.albedo = toPath(record.albedo);
+            material.normalMap = toPath(record.normalMap);
+            material.metallicRoughness = toPath(record.metallicRoughness);
+            material.occlusion = toPath(record.occlusion);
+            material.emissive = toPath(record.emissive);
+            material.baseColorFactor = record.baseColorFactor;
+            material.emissiveFactor = record.emissiveFactor;
+        }
+
+        std::span<const PrimitiveRecord> primitives = view.getSection<PrimitiveRecord>(SectionType::Primitives);
+        scene.primitives.resize(primitives.size());
+        for(std::size_t i = 0; i < primitives.size(); i++) {
+            const PrimitiveRecord& record = primitives[i];
+            LoadedPrimitive& primitive = scene.primitives[i];
+            primitive.name = view.getString(record.name);
+            primitive.isSkinned = (record.flags & PrimitiveRecord::Skinned) != 0;
+            primitive.hadTangents = (record.flags & PrimitiveRecord::HadTangents) != 0;
+            primitive.hadNormals = (record.flags & PrimitiveRecord::HadNormals) != 0;
+            primitive.hadTexCoords = (record.flags & PrimitiveRecord::HadTexCoords) != 0;
+            primitive.materialIndex = record.materialIndex;
+            primitive.transform = record.transform;
+            primitive.minPos = record.minPos;
+            primitive.maxPos = record.maxPos;
+            primitive.quantizationBounds = Math::AABB { record.quantizationBoundsMin, record.quantizationBoundsMax };
+            if(primitive.isSkinned) {
+                assign(primitive.skinnedVertices, view.getRange<Carrot::SkinnedVertex>(SectionType::SkinnedVertices, record.vertices));
+            } else {
+                assign(primitive.vertices, view.getRange<Carrot::Vertex>(SectionType::Vertices, record.vertices));
+            }
+            assign(primitive.indices, view.getRange<std::uint32_t>(SectionType::Indices, record.indices));
+            assign(primitive.meshletVertexIndices, view.getRange<std::uint32_t>(SectionType::Indices, record.meshletVertexIndices));
+            assign(primitive.meshletIndices, view.getRange<std::uint32_t>(SectionType::Indices, record.meshletIndices));
+            assign(primitive.meshlets, view.getRange<Meshlet>(SectionType::Meshlets, record.meshlets));
+            assign(primitive.quantizedVertices, view.getRange<Carrot::QuantizedVertex>(SectionType::QuantizedVertices, record.quantizedVertices));
+        }
+
+        std::span<const SceneRecord> sceneRecords = view.getSection<SceneRecord>(SectionType::Scene);
+        if(sceneRecords.size() != 1) {
+            throw std::runtime_error("Cooked model must have exactly one scene record");
+        }
+        if(sceneRecords[0].hasNodeHierarchy) {
+            std::span<const NodeRecord> nodes = view.getSection<NodeRecord>(SectionType::Nodes);
+            if(nodes.empty() || nodes[0].parentIndex != -1) {
+                throw std::runtime_error("Node hierarchy must start with its root");
+            }
+
+            scene.nodeHierarchy = std::make_unique<Skeleton>(sceneRecords[0].globalInverseTransform);
+            std::vector<SkeletonTreeNode*> treeNodes;
+            treeNodes.resize(nodes.size());
+            for(std::size_t i = 0; i < nodes.size(); i++) {
+                const NodeRecord& record = nodes[i];
+                if(i == 0) {
+                    treeNodes[i] = &scene.nodeHierarchy->hierarchy;
+                } else {
+                    if(record.parentIndex < 0 || record.parentIndex >= static_cast<std::int32_t>(i)) {
+                        throw std::runtime_error(Carrot::sprintf("Node %llu has an invalid parent", static_cast<std::uint64_t>(i)));
+                    }
+                    treeNodes[i] = &treeNodes[record.parentIndex]->newChild();
+                }
+
+                SkeletonTreeNode& node = *treeNodes[i];
+                node.bone.name = view.getString(record.name);
+                node.bone.transform = record.transform;
+                node.bone.originalTransform = record.originalTransform;
+                node.nodeKey.value = record.nodeKey;
+                if(record.hasMeshIndices) {
+                    std::span<const std::uint64_t> meshIndices = view.getRange<std::uint64_t>(SectionType::NodeMeshIndices, record.meshIndices);
+                    node.meshIndices = std::vector<std::size_t> { meshIndices.begin(), meshIndices.end() };
+                }
+            }
+
+            // the root is named after the model file, like GLTFLoader does
+            scene.nodeHierarchy->hierarchy.bone.name = "Model root " + modelFilepath.toString();
+        }
+
+        for(const PrecomputedBLASRecord& record : view.getSection<PrecomputedBLASRecord>(SectionType::PrecomputedBLASes)) {
+            std::span<const std::uint8_t> blasBytes = view.getRange<std::uint8_t>(SectionType::BLASBytes, record.bytes);
+            PrecomputedBLAS& blas = scene.precomputedBLASes[NodeKey { record.nodeKey }][Pair<std::uint32_t, std::uint32_t> { record.primitiveIndex, record.groupIndex }];
+            blas.blasBytes.resize(blasBytes.size());
+            std::memcpy(blas.blasBytes.data(), blasBytes.data(), blasBytes.size());
+        }
+
+        for(const BoneMappingRecord& record : view.getSection<BoneMappingRecord>(SectionType::BoneMappings)) {
+            scene.boneMapping[record.meshIndex][std::string { view.getString(record.boneName) }] = record.boneIndex;
+        }
+        for(const OffsetMatrixRecord& record : view.getSection<OffsetMatrixRecord>(SectionType::OffsetMatrices)) {
+            scene.offsetMatrices[record.meshIndex][std::string { view.getString(record.boneName) }] = record.offsetMatrix;
+        }
+
+        std::span<const AnimationRecord> animations = view.getSection<AnimationRecord>(SectionType::Animations);
+        scene.animationData.resize(animations.size());
+        for(std::size_t i = 0; i < animations.size(); i++) {
+            const AnimationRecord& record = animations[i];
+            Animation& animation = scene.animationData[i];
+            animation.keyframeCount = record.keyframeCount;
+            animation.duration = record.duration;
+
+            std::span<const KeyframeRecord> keyframes = view.getRange<KeyframeRecord>(SectionType::Keyframes, record.keyframes);
+            animation.keyframes.reserve(keyframes.size());
+            for(const KeyframeRecord& keyframeRecord : keyframes) {
+                Keyframe& keyframe = animation.keyframes.emplace_back(keyframeRecord.timestamp);
+                assign(keyframe.boneTransforms, view.getRange<glm::mat4>(SectionType::BoneTransforms, keyframeRecord.boneTransforms));
+            }
+        }
+        for(const AnimationNameRecord& record : view.getSection<AnimationNameRecord>(SectionType::AnimationNames)) {
+            if(record.animationIndex >= animations.size()) {
+                throw std::runtime_error(Carrot::sprintf("Animation index %u is out of bounds", record.animationIndex));
+            }
+            scene.animationMapping[std::string { view.getString(record.name) }] = record.animationIndex;
+        }
+
+        return scene;
+    }
+
+    LoadedScene load(const IO::Resource& resource, const IO::VFS::Path& modelFilepath) {
+        const IO::MappedResource mapping = resource.map();
+        LoadedScene scene = load(mapping.getData(), modelFilepath);
+        scene.debugName = resource.getName();
+        return scene;
+    }
+
+    // -- Validation
+
+    std::vector<std::string> validate(std::span<const std::uint8_t> bytes) {
+        ZoneScoped;
+        std::vector<std::string> problems;
+        try {
+            // structure and ranges are checked while loading
+            const LoadedScene scene = load(bytes, {});
+            const View view { bytes };
+
+            // then check the content
+            for(std::size_t primitiveIndex = 0; primitiveIndex < scene.primitives.size(); primitiveIndex++) {
+                const LoadedPrimitive& primitive = scene.primitives[primitiveIndex];
+                auto report = [&](const std::string& problem) {
+                    problems.emplace_back(Carrot::sprintf("Primitive %llu (%s): %s", static_cast<std::uint64_t>(primitiveIndex), primitive.name.c_str(), problem.c_str()));
+                };
+
+                if(primitive.materialIndex < -1 || primitive.materialIndex >= static_cast<std::int64_t>(scene.materials.size())) {
+                    report(Carrot::sprintf("invalid material index %lld", primitive.materialIndex));
+                }
+
+                const std::size_t vertexCount = primitive.isSkinned ? primitive.skinnedVertices.size() : primitive.vertices.size();
+                if(primitive.indices.size() % 3 != 0) {
+                    report("index count is not a multiple of 3");
+                }
+                if(std::any_of(primitive.indices.begin(), primitive.indices.end(), [&](std::uint32_t index) { return index >= vertexCount; })) {
+                    report("index out of bounds");
+                }
+                if(std::any_of(primitive.meshletVertexIndices.begin(), primitive.meshletVertexIndices.end(), [&](std::uint32_t index) { return index >= vertexCount; })) {
+                    report("meshlet vertex index out of bounds");
+                }
+                if(!primitive.quantizedVertices.empty() && primitive.quantizedVertices.size() != vertexCount) {
+                    report("quantized vertex count does not match vertex count");
+                }
+
+                for(std::size_t meshletIndex = 0; meshletIndex < primitive.meshlets.size(); meshletIndex++) {
+                    const Meshlet& meshlet = primitive.meshlets[meshletIndex];
+                    if(static_cast<std::uint64_t>(meshlet.vertexOffset) + meshlet.vertexCount > primitive.meshletVertexIndices.size()
+                    || static_cast<std::uint64_t>(meshlet.indexOffset) + meshlet.indexCount > primitive.meshletIndices.size()) {
+                        report(Carrot::sprintf("meshlet %llu references data out of bounds", static_cast<std::uint64_t>(meshletIndex)));
+                        continue;
+                    }
+                    for(std::uint32_t i = 0; i < meshlet.indexCount; i++) {
+                        // meshlet indices are relative to the vertices of the meshlet
+                        if(primitive.meshletIndices[meshlet.indexOffset + i] >= meshlet.vertexCount) {
+                            report(Carrot::sprintf("meshlet %llu has an index out of bounds", static_cast<std::uint64_t>(meshletIndex)));
+                            break;
+                        }
+                    }
+                }
+            }
+
+            std::function<void(const SkeletonTreeNode&)> checkNode = [&](const SkeletonTreeNode& node) {
+                if(node.meshIndices.has_value()) {
+                    for(const std::size_t meshIndex : node.meshIndices.value()) {
+                        if(meshIndex >= scene.primitives.size()) {
+                            problems.emplace_back(Carrot::sprintf("Node %s references primitive %llu, which does not exist", node.bone.name.c_str(), static_cast<std::uint64_t>(meshIndex)));
+                        }
+                    }
+                }
+                for(const SkeletonTreeNode& child : node.getChildren()) {
+                    checkNode(child);
+                }
+            };
+            if(scene.nodeHierarchy) {
+                checkNode(scene.nodeHierarchy->hierarchy);
+            }
+
+            for(const auto& [nodeKey, nodeBLASes] : scene.precomputedBLASes) {
+                for(const auto& [key, blas] : nodeBLASes) {
+                    if(blas.blasBytes.size() < sizeof(Carrot::VkAccelerationStructureHeader)) {
+                        problems.emplace_back(Carrot::sprintf("Precomputed BLAS (node %u, primitive %u, group %u) is too small", nodeKey.value, key.first, key.second));
+                    }
+                }
+            }
+
+            for(std::size_t animationIndex = 0; animationIndex < scene.animationData.size(); animationIndex++) {
+                const Animation& animation = scene.animationData[animationIndex];
+                if(animation.keyframeCount != static_cast<std::int32_t>(animation.keyframes.size())) {
+                    problems.emplace_back(Carrot::sprintf("Animation %llu: keyframe count mismatch", static_cast<std::uint64_t>(animationIndex)));
+                }
+            }
+            if(scene.animationMapping.size() != scene.animationData.size()) {
+                problems.emplace_back("There must be as many entries in animation mapping as there are animations");
+            }
+        } catch(std::exception& e) {
+            problems.emplace_back(e.what());
+        }
+        return problems;
+    }
+
+    // -- Comparison
+
+    template<typename Vertex>
+    static bool sameBaseVertex(const Vertex& a, const Vertex& b) {
+        return a.pos == b.pos && a.color == b.color && a.normal == b.normal && a.tangent == b.tangent && a.uv == b.uv;
+    }
+
+    static bool sameVertex(const Carrot::Vertex& a, const Carrot::Vertex& b) {
+        return sameBaseVertex(a, b);
+    }
+
+    static bool sameVertex(const Carrot::SkinnedVertex& a, const Carrot::SkinnedVertex& b) {
+        return sameBaseVertex(a, b) && a.boneIDs == b.boneIDs && a.boneWeights == b.boneWeights;
+    }
+
+    static bool sameMeshlet(const Meshlet& a, const Meshlet& b) {
+        auto sameSphere = [](const Math::Sphere& a, const Math::Sphere& b) {
+            return a.center == b.center && a.radius == b.radius;
+        };
+        return a.vertexOffset == b.vertexOffset && a.vertexCount == b.vertexCount
+            && a.indexOffset == b.indexOffset && a.indexCount == b.indexCount
+            && a.groupIndex == b.groupIndex && a.lod == b.lod
+            && sameSphere(a.boundingSphere, b.boundingSphere) && sameSphere(a.parentBoundingSphere, b.parentBoundingSphere)
+            && a.parentError == b.parentError && a.clusterError == b.clusterError;
+    }
+
+    std::vector<std::string> compare(const LoadedScene& expected, const LoadedScene& actual) {
+        ZoneScoped;
+        std::vector<std::string> differences;
+        auto check = [&](bool same, const std::string& what) {
+            if(!same) {
+                differences.emplace_back(what);
+            }
+        };
+        auto checkArray = [&](const auto& a, const auto& b, auto sameElement, const std::string& what) {
+            if(a.size() != b.size()) {
+                differences.emplace_back(Carrot::sprintf("%s: size mismatch (%llu vs %llu)", what.c_str(), static_cast<std::uint64_t>(a.size()), static_cast<std::uint64_t>(b.size())));
+                return;
+            }
+            for(std::size_t i = 0; i < a.size(); i++) {
+                if(!sameElement(a[i], b[i])) {
+                    differences.emplace_back(Carrot::sprintf("%s: element %llu differs", what.c_str(), static_cast<std::uint64_t>(i)));
+                    return; // one is enough
+                }
+            }
+        };
+        auto equal = [](const auto& a, const auto& b) { return a == b; };
+
+        check(expected.materials.size() == actual.materials.size(), "Material count");
+        for(std::size_t i = 0; i < std::min(expected.materials.size(), actual.materials.size()); i++) {
+            const LoadedMaterial& a = expected.materials[i];
+            const LoadedMaterial& b = actual.materials[i];
+            const bool same = a.name == b.name && a.blendMode == b.blendMode
+                           && a.albedo == b.albedo && a.normalMap == b.normalMap && a.metallicRoughness == b.metallicRoughness
+                           && a.occlusion == b.occlusion && a.emissive == b.emissive
+                           && a.baseColorFactor == b.baseColorFactor && a.emissiveFactor == b.emissiveFactor
+                           && a.metallicFactor == b.metallicFactor && a.roughnessFactor == b.roughnessFactor;
+            check(same, Carrot::sprintf("Material %llu (%s)", static_cast<std::uint64_t>(i), a.name.c_str()));
+        }
+
+        check(expected.primitives.size() == actual.primitives.size(), "Primitive count");
+        for(std::size_t i = 0; i < std::min(expected.primitives.size(), actual.primitives.size()); i++) {
+            const LoadedPrimitive& a = expected.primitives[i];
+            const LoadedPrimitive& b = actual.primitives[i];
+            const std::string name = Carrot::sprintf("Primitive %llu (%s)", static_cast<std::uint64_t>(i), a.name.c_str());
+            check(a.name == b.name && a.isSkinned == b.isSkinned && a.materialIndex == b.materialIndex
+               && a.hadTangents == b.hadTangents && a.hadNormals == b.hadNormals && a.hadTexCoords == b.hadTexCoords
+               && a.transform == b.transform && a.minPos == b.minPos && a.maxPos == b.maxPos, name + " properties");
+            checkArray(a.vertices, b.vertices, [](const Carrot::Vertex& x, const Carrot::Vertex& y) { return sameVertex(x, y); }, name + " vertices");
+            checkArray(a.skinnedVertices, b.skinnedVertices, [](const Carrot::SkinnedVertex& x, const Carrot::SkinnedVertex& y) { return sameVertex(x, y); }, name + " skinned vertices");
+            checkArray(a.indices, b.indices, equal, name + " indices");
+            checkArray(a.meshletVertexIndices, b.meshletVertexIndices, equal, name + " meshlet vertex indices");
+            checkArray(a.meshletIndices, b.meshletIndices, equal, name + " meshlet indices");
+            checkArray(a.meshlets, b.meshlets, sameMeshlet, name + " meshlets");
+            checkArray(a.quantizedVertices, b.quantizedVertices, [](const Carrot::QuantizedVertex& x, const Carrot::QuantizedVertex& y) { return std::memcmp(&x, &y, sizeof(x)) == 0; }, name + " quantized vertices");
+            check(a.quantizationBounds.min == b.quantizationBounds.min && a.quantizationBounds.max == b.quantizationBounds.max, name + " quantization bounds");
+        }
+
+        std::function<void(const SkeletonTreeNode&, const SkeletonTreeNode&)> compareNodes = [&](const SkeletonTreeNode& a, const SkeletonTreeNode& b) {
+            const bool same = a.bone.name == b.bone.name && a.bone.transform == b.bone.transform && a.bone.originalTransform == b.bone.originalTransform
+                           && a.nodeKey == b.nodeKey && a.meshIndices == b.meshIndices && a.getChildren().size() == b.getChildren().size();
+            if(!same) {
+                differences.emplace_back(Carrot::sprintf("Node %s", a.bone.name.c_str()));
+                return;
+            }
+            auto childB = b.getChildren().begin();
+            for(const SkeletonTreeNode& childA : a.getChildren()) {
+                compareNodes(childA, *childB);
+                ++childB;
+            }
+        };
+        check((expected.nodeHierarchy == nullptr) == (actual.nodeHierarchy == nullptr), "Node hierarchy presence");
+        if(expected.nodeHierarchy && actual.nodeHierarchy) {
+            check(expected.nodeHierarchy->getGlobalInverseTransform() == actual.nodeHierarchy->getGlobalInverseTransform(), "Global inverse transform");
+            compareNodes(expected.nodeHierarchy->hierarchy, actual.nodeHierarchy->hierarchy);
+        }
+
+        check(expected.precomputedBLASes.size() == actual.precomputedBLASes.size(), "Precomputed BLAS node count");
+        for(const auto& [nodeKey, nodeBLASes] : expected.precomputedBLASes) {
+            auto iter = actual.precomputedBLASes.find(nodeKey);
+            if(iter == actual.precomputedBLASes.end() || iter->second.size() != nodeBLASes.size()) {
+                differences.emplace_back(Carrot::sprintf("Precomputed BLASes of node %u", nodeKey.value));
+                continue;
+            }
+            for(const auto& [key, blas] : nodeBLASes) {
+                auto blasIter = iter->second.find(key);
+                const bool same = blasIter != iter->second.end()
+                               && blasIter->second.blasBytes.size() == blas.blasBytes.size()
+                               && std::memcmp(blasIter->second.blasBytes.cdata(), blas.blasBytes.cdata(), blas.blasBytes.size()) == 0;
+                check(same, Carrot::sprintf("Precomputed BLAS (node %u, primitive %u, group %u)", nodeKey.value, key.first, key.second));
+            }
+        }
+
+        check(expected.boneMapping == actual.boneMapping, "Bone mapping");
+        check(expected.offsetMatrices == actual.offsetMatrices, "Offset matrices");
+        check(expected.animationMapping == actual.animationMapping, "Animation mapping");
+        check(expected.animationData.size() == actual.animationData.size(), "Animation count");
+        for(std::size_t i = 0; i < std::min(expected.animationData.size(), actual.animationData.size()); i++) {
+            const Animation& a = expected.animationData[i];
+            const Animation& b = actual.animationData[i];
+            const std::string name = Carrot::sprintf("Animation %llu", static_cast<std::uint64_t>(i));
+            check(a.keyframeCount == b.keyframeCount && a.duration == b.duration, name + " properties");
+            checkArray(a.keyframes, b.keyframes, [](const Keyframe& x, const Keyframe& y) {
+                return x.timestamp == y.timestamp && x.boneTransforms == y.boneTransforms;
+            }, name + " keyframes");
+        }
+        return differences;
+    }
+}
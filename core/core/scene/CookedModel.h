@@ -0,0 +1,242 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <core/io/Resource.h>
+#include <core/scene/LoadedScene.h>
+
+/**
+ * Cooked model format, written by Fertilizer next to the glTF it exports (same name, ".cmodel" extension).
+ *
+ * The file is a header, followed by a table of sections. Each section is an array of fixed-size records, aligned to
+ * SectionAlignment bytes and referenced by its offset from the start of the file. Records only reference other data via
+ * indices or element ranges, never via pointers: the file is relocatable and can be used directly from a memory mapping.
+ * Vertices, indices and meshlets are stored with the exact layout used at runtime, so loading them is a copy, without
+ * any parsing or per-element conversion.
+ *
+ * The content is the LoadedScene GLTFLoader would create from the glTF exported by Fertilizer: both paths must give the
+ * same result (see 'compare').
+ */
+namespace Carrot::Render::CookedModel {
+    constexpr const char* const Extension = ".cmodel";
+    constexpr std::uint32_t Magic = 0x4C444D43; // "CMDL"
+    constexpr std::uint32_t Version = 2;
+    constexpr std::uint64_t SectionAlignment = 16;
+
+    enum class SectionType: std::uint32_t {
+        Strings, // chars
+        Scene, // single SceneRecord
+        Materials, // MaterialRecord
+        Primitives, // PrimitiveRecord
+        Vertices, // Carrot::Vertex
+        SkinnedVertices, // Carrot::SkinnedVertex
+        Indices, // u32, for 'indices', 'meshletVertexIndices' and 'meshletIndices' of primitives
+        Meshlets, // Carrot::Render::Meshlet
+        Nodes, // NodeRecord, in depth-first order
+        NodeMeshIndices, // u64
+        PrecomputedBLASes, // PrecomputedBLASRecord
+        BLASBytes, // u8, each BLAS starts on a SectionAlignment boundary
+        BoneMappings, // BoneMappingRecord
+        OffsetMatrices, // OffsetMatrixRecord
+        AnimationNames, // AnimationNameRecord
+        Animations, // AnimationRecord
+        Keyframes, // KeyframeRecord
+        BoneTransforms, // glm::mat4
+        QuantizedVertices, // Carrot::QuantizedVertex
+
+        Count,
+    };
+
+    struct Header {
+        std::uint32_t magic = Magic;
+        std::uint32_t version = Version;
+        std::uint32_t sectionCount = 0; // SectionEntry array follows the header
+        std::uint32_t reserved = 0;
+        std::uint64_t fileSize = 0;
+    };
+
+    struct SectionEntry {
+        SectionType type = SectionType::Count;
+        std::uint32_t elementSize = 0; // size of a single record, checked against the type expected by the reader
+        std::uint64_t offset = 0; // from the start of the file
+        std::uint64_t size = 0; // in bytes
+    };
+
+    /// Elements [first; first+count[ of a section
+    struct Range {
+        std::uint64_t first = 0;
+        std::uint64_t count = 0;
+    };
+
+    /// Range of bytes inside the Strings section
+    struct StringRef {
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    };
+
+    struct SceneRecord {
+        glm::mat4 globalInverseTransform { 1.0f };
+        std::uint32_t hasNodeHierarchy = 0;
+        std::uint32_t reserved[3] {};
+    };
+
+    struct MaterialRecord {
+        StringRef name;
+        std::uint32_t blendMode = 0;
+        float metallicFactor = 1.0f;
+        float roughnessFactor = 1.0f;
+
+        // paths relative to the model, empty if none
+        StringRef albedo;
+        StringRef normalMap;
+        StringRef metallicRoughness;
+        StringRef occlusion;
+        StringRef emissive;
+
+        glm::vec4 baseColorFactor { 1.0f };
+        glm::vec3 emissiveFactor { 1.0f };
+    };
+
+    struct PrimitiveRecord {
+        enum Flags: std::uint32_t {
+            Skinned = 1 << 0,
+            HadTangents = 1 << 1,
+            HadNormals = 1 << 2,
+            HadTexCoords = 1 << 3,
+        };
+
+        StringRef name;
+        std::uint32_t flags = 0;
+        std::int32_t reserved = 0;
+        std::int64_t materialIndex = -1;
+        glm::mat4 transform { 1.0f };
+        glm::vec3 minPos { 0.0f };
+        glm::vec3 maxPos { 0.0f };
+        glm::vec3 quantizationBoundsMin { 0.0f };
+        glm::vec3 quantizationBoundsMax { 0.0f };
+
+        Range vertices; // inside SkinnedVertices if skinned, Vertices otherwise
+        Range indices;
+        Range meshletVertexIndices; // inside Indices
+        Range meshletIndices; // inside Indices
+        Range meshlets;
+        Range quantizedVertices; // empty, or as many as 'vertices'
+    };
+
+    struct NodeRecord {
+        StringRef name;
+        std::int32_t parentIndex = -1; // always before this node, -1 for the root
+        std::uint32_t nodeKey = 0;
+        glm::mat4 transform { 1.0f };
+        glm::mat4 originalTransform { 1.0f };
+        std::uint32_t hasMeshIndices = 0;
+        std::uint32_t reserved = 0;
+        Range meshIndices; // inside NodeMeshIndices
+    };
+
+    struct PrecomputedBLASRecord {
+        std::uint32_t nodeKey = 0;
+        std::uint32_t primitiveIndex = 0;
+        std::uint32_t groupIndex = 0;
+        std::uint32_t reserved = 0;
+        Range bytes; // inside BLASBytes
+    };
+
+    struct BoneMappingRecord {
+        std::int32_t meshIndex = 0;
+        std::uint32_t boneIndex = 0;
+        StringRef boneName;
+    };
+
+    struct OffsetMatrixRecord {
+        std::int32_t meshIndex = 0;
+        StringRef boneName;
+        std::uint32_t reserved = 0;
+        glm::mat4 offsetMatrix { 1.0f };
+    };
+
+    struct AnimationNameRecord {
+        StringRef name;
+        std::uint32_t animationIndex = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    struct AnimationRecord {
+        std::int32_t keyframeCount = 0;
+        float duration = 0.0f;
+        Range keyframes;
+    };
+
+    struct KeyframeRecord {
+        float timestamp = 0.0f;
+        std::uint32_t reserved = 0;
+        Range boneTransforms;
+    };
+
+    /**
+     * Read-only access to the sections of a cooked model, directly inside 'bytes' (for instance a memory mapping).
+     * Construction checks the header and section table, and throws std::runtime_error if they are invalid. The content of
+     * the sections is only checked by 'validate'.
+     * 'bytes' must outlive this view.
+     */
+    class View {
+    public:
+        explicit View(std::span<const std::uint8_t> bytes);
+
+        /// Records of the given section, empty if the section is not present
+        template<typename T>
+        std::span<const T> getSection(SectionType type) const {
+            const SectionEntry* pEntry = findSection(type, sizeof(T));
+            if(pEntry == nullptr) {
+                return {};
+            }
+            return std::span { reinterpret_cast<const T*>(bytes.data() + pEntry->offset), pEntry->size / sizeof(T) };
+        }
+
+        /// Elements of 'range' inside the given section. Throws if the range is out of bounds
+        template<typename T>
+        std::span<const T> getRange(SectionType type, const Range& range) const {
+            std::span<const T> section = getSection<T>(type);
+            checkRange(section.size(), range);
+            return section.subspan(range.first, range.count);
+        }
+
+        std::string_view getString(const StringRef& ref) const;
+
+    private:
+        const SectionEntry* findSection(SectionType type, std::size_t elementSize) const;
+        void checkRange(std::size_t sectionElementCount, const Range& range) const;
+
+        std::span<const std::uint8_t> bytes;
+        std::span<const SectionEntry> sections;
+    };
+
+    /// Does 'bytes' start with the header of a cooked model? (does not check the version)
+    bool isCookedModel(std::span<const std::uint8_t> bytes);
+
+    /// Serializes 'scene' into the cooked format. Material paths are expected to be relative to the model, as they are
+    /// when GLTFLoader loads a glTF with an empty path
+    std::vector<std::uint8_t> cook(const LoadedScene& scene);
+
+    /// Deep validation of a cooked model: layout, ranges, and indices inside primitives and meshlets. Returns the list of
+    /// problems found, empty if the model is valid
+    std::vector<std::string> validate(std::span<const std::uint8_t> bytes);
+
+    /// Creates the LoadedScene stored inside a cooked model. Material paths are made relative to 'modelFilepath', which
+    /// should be the path of the glTF the model was cooked from (the same paths are then obtained with both formats).
+    /// Throws if the model is invalid
+    LoadedScene load(std::span<const std::uint8_t> bytes, const IO::VFS::Path& modelFilepath);
+
+    /// Maps 'resource' and loads the cooked model inside it, see load(std::span, const IO::VFS::Path&)
+    LoadedScene load(const IO::Resource& resource, const IO::VFS::Path& modelFilepath);
+
+    /// Lists the differences between two scenes, empty if they are the same. Used to check cooked models against the glTF path
+    std::vector<std::string> compare(const LoadedScene& expected, const LoadedScene& actual);
+}
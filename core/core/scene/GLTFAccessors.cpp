@@ -0,0 +1,156 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "GLTFAccessors.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <core/utils/Assert.h>
+#include <core/utils/stringmanip.h>
+
+namespace Carrot::Render::GLTFAccessors {
+    std::size_t getComponentSize(ComponentType type) {
+        switch(type) {
+            case ComponentType::Byte:
+            case ComponentType::UnsignedByte:
+                return 1;
+
+            case ComponentType::Short:
+            case ComponentType::UnsignedShort:
+                return 2;
+
+            case ComponentType::UnsignedInt:
+            case ComponentType::Float:
+                return 4;
+        }
+        verify(false, Carrot::sprintf("Unsupported component type: %d", static_cast<int>(type)));
+        return 0;
+    }
+
+    template<typename Source, typename Destination, bool Normalized>
+    static Destination convertComponent(Source value) {
+        if constexpr(Normalized && std::is_integral_v<Source> && std::is_floating_point_v<Destination>) {
+            // same formulas as the glTF 2.0 spec, see "normalized" accessors
+            constexpr Destination maxValue = static_cast<Destination>(std::numeric_limits<Source>::max());
+            if constexpr(std::is_signed_v<Source>) {
+                return std::max(static_cast<Destination>(value) / maxValue, static_cast<Destination>(-1));
+            } else {
+                return static_cast<Destination>(value) / maxValue;
+            }
+        } else {
+            return static_cast<Destination>(value);
+        }
+    }
+
+    template<typename Source, typename Destination, bool Normalized>
+    static void convertElements(const StridedElements& source, std::uint8_t* pDestination, std::size_t destinationStride, std::size_t componentCount) {
+        if constexpr(std::is_same_v<Source, Destination> && !Normalized) {
+            const std::size_t elementSize = componentCount * sizeof(Source);
+            if(source.stride == elementSize && destinationStride == elementSize) {
+                std::memcpy(pDestination, source.pData, elementSize * source.count);
+                return;
+            }
+            for(std::size_t i = 0; i < source.count; i++) {
+                std::memcpy(pDestination + i * destinationStride, source.pData + i * source.stride, elementSize);
+            }
+        } else {
+            for(std::size_t i = 0; i < source.count; i++) {
+                const std::uint8_t* pSourceElement = source.pData + i * source.stride;
+                Destination* pDestinationElement = reinterpret_cast<Destination*>(pDestination + i * destinationStride);
+                for(std::size_t c = 0; c < componentCount; c++) {
+                    // glTF only aligns elements to their component size, and strides can be arbitrary: don't dereference directly
+                    Source value;
+                    std::memcpy(&value, pSourceElement + c * sizeof(Source), sizeof(Source));
+                    pDestinationElement[c] = convertComponent<Source, Destination, Normalized>(value);
+                }
+            }
+        }
+    }
+
+    template<typename Source, typename Destination>
+    static void convertElements(bool normalized, const StridedElements& source, std::uint8_t* pDestination, std::size_t destinationStride, std::size_t componentCount) {
+        if(normalized) {
+            convertElements<Source, Destination, true>(source, pDestination, destinationStride, componentCount);
+        } else {
+            convertElements<Source, Destination, false>(source, pDestination, destinationStride, componentCount);
+        }
+    }
+
+    template<typename Destination>
+    void convert(const StridedElements& source, Destination* pDestination, std::size_t destinationStride, std::size_t destinationComponentCount) {
+        const std::size_t componentCount = std::min(source.componentCount, destinationComponentCount);
+        std::uint8_t* pDestinationBytes = reinterpret_cast<std::uint8_t*>(pDestination);
+
+        if(source.pData == nullptr) {
+            for(std::size_t i = 0; i < source.count; i++) {
+                Destination* pDestinationElement = reinterpret_cast<Destination*>(pDestinationBytes + i * destinationStride);
+                std::fill_n(pDestinationElement, componentCount, static_cast<Destination>(0));
+            }
+            return;
+        }
+
+        const bool normalized = source.normalized && std::is_floating_point_v<Destination>;
+        switch(source.componentType) {
+            case ComponentType::Byte:
+                convertElements<std::int8_t, Destination>(normalized, source, pDestinationBytes, destinationStride, componentCount);
+                break;
+
+            case ComponentType::UnsignedByte:
+                convertElements<std::uint8_t, Destination>(normalized, source, pDestinationBytes, destinationStride, componentCount);
+                break;
+
+            case ComponentType::Short:
+                convertElements<std::int16_t, Destination>(normalized, source, pDestinationBytes, destinationStride, componentCount);
+                break;
+
+            case ComponentType::UnsignedShort:
+                convertElements<std::uint16_t, Destination>(normalized, source, pDestinationBytes, destinationStride, componentCount);
+                break;
+
+            case ComponentType::UnsignedInt:
+                convertElements<std::uint32_t, Destination>(normalized, source, pDestinationBytes, destinationStride, componentCount);
+                break;
+
+            case ComponentType::Float:
+                convertElements<float, Destination>(false, source, pDestinationBytes, destinationStride, componentCount);
+                break;
+
+            default:
+                verify(false, Carrot::sprintf("Unsupported component type: %d", static_cast<int>(source.componentType)));
+                break;
+        }
+    }
+
+    template<typename Destination>
+    void convertSparse(const StridedElements& indices, const StridedElements& values, std::size_t destinationCount,
+                       Destination* pDestination, std::size_t destinationStride, std::size_t destinationComponentCount) {
+        verify(indices.count == values.count, "Mismatched sparse indices/values count");
+        std::vector<std::uint32_t> destinationIndices;
+        destinationIndices.resize(indices.count);
+        convert(indices, destinationIndices.data(), sizeof(std::uint32_t), 1);
+
+        std::uint8_t* pDestinationBytes = reinterpret_cast<std::uint8_t*>(pDestination);
+        StridedElements value = values;
+        value.count = 1;
+        for(std::size_t i = 0; i < destinationIndices.size(); i++) {
+            const std::uint32_t destinationIndex = destinationIndices[i];
+            verify(destinationIndex < destinationCount, "Sparse accessor index out of bounds");
+            value.pData = values.pData + i * values.stride;
+            convert(value, reinterpret_cast<Destination*>(pDestinationBytes + destinationIndex * destinationStride), destinationStride, destinationComponentCount);
+        }
+    }
+
+#define INSTANTIATE_CONVERSIONS(Destination) \
+    template void convert<Destination>(const StridedElements&, Destination*, std::size_t, std::size_t); \
+    template void convertSparse<Destination>(const StridedElements&, const StridedElements&, std::size_t, Destination*, std::size_t, std::size_t);
+
+    INSTANTIATE_CONVERSIONS(float)
+    INSTANTIATE_CONVERSIONS(std::uint8_t)
+    INSTANTIATE_CONVERSIONS(std::uint16_t)
+    INSTANTIATE_CONVERSIONS(std::uint32_t)
+
+#undef INSTANTIATE_CONVERSIONS
+}
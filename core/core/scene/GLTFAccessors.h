@@ -0,0 +1,63 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/// Bulk conversion of glTF accessor data into engine types.
+/// Kept independent of tinygltf: GLTFLoader describes accessors with StridedElements, and the conversion kernels
+/// here are specialised per (source, destination) component types, outside of the per-element loops.
+namespace Carrot::Render::GLTFAccessors {
+    /// Component types allowed inside glTF accessors, with their glTF values
+    enum class ComponentType: int {
+        Byte = 5120,
+        UnsignedByte = 5121,
+        Short = 5122,
+        UnsignedShort = 5123,
+        UnsignedInt = 5125,
+        Float = 5126,
+    };
+
+    /// Size in bytes of a single component. Throws on unsupported types
+    std::size_t getComponentSize(ComponentType type);
+
+    /// Elements of an accessor, as found inside a buffer
+    struct StridedElements {
+        /// Start of the first element. nullptr means all elements are zero (accessors without buffer views)
+        const std::uint8_t* pData = nullptr;
+
+        /// Distance in bytes between two consecutive elements
+        std::size_t stride = 0;
+
+        /// Element count
+        std::size_t count = 0;
+
+        ComponentType componentType = ComponentType::Float;
+
+        /// Component count per element (3 for a VEC3, 16 for a MAT4, etc.)
+        std::size_t componentCount = 1;
+
+        /// Integer components are mapped to [0; 1] (unsigned) or [-1; 1] (signed) when converted to floats
+        bool normalized = false;
+    };
+
+    /**
+     * Converts all elements of 'source', element i is written to 'pDestination' + i * 'destinationStride' (in bytes).
+     * Only the first 'destinationComponentCount' components are written: if the source has fewer components, the
+     * remaining destination components are left untouched, so callers can fill default values beforehand.
+     * Integers are cast as-is unless the source is normalized and the destination is float.
+     */
+    template<typename Destination>
+    void convert(const StridedElements& source, Destination* pDestination, std::size_t destinationStride, std::size_t destinationComponentCount);
+
+    /**
+     * Applies sparse substitution: element indices[i] of the destination is replaced by values[i].
+     * 'destinationCount' is the element count of the destination, used to check the indices.
+     */
+    template<typename Destination>
+    void convertSparse(const StridedElements& indices, const StridedElements& values, std::size_t destinationCount,
+                       Destination* pDestination, std::size_t destinationStride, std::size_t destinationComponentCount);
+}
@@ -3,14 +3,18 @@
 //
 
 #include "GLTFLoader.h"
+#include "GLTFAccessors.h"
 #include "core/io/Logging.hpp"
 #include <core/utils/Profiling.h>
 #include <core/utils/UserNotifications.h>
 #include <glm/gtx/quaternion.hpp>
+#include <algorithm>
+#include <atomic>
 #include <set>
 
 #include "core/io/vfs/VirtualFileSystem.h"
 #include "core/tasks/Tasks.h"
+#include "core/render/MeshCompression.h"
 
 namespace Carrot::Render {
 
@@ -43,10 +47,10 @@ namespace Carrot::Render {
                            std::string* err, const std::string& filepath,
                            void* userData) {
         ZoneScoped;
+        // tinygltf wants its own vector: copy straight from the mapped file, without zero-filling the vector first
         IO::FileHandle file { filepath, IO::OpenMode::Read };
-        std::uint64_t resourceSize = file.getSize();
-        out->resize(resourceSize);
-        file.read(out->data(), resourceSize);
+        std::shared_ptr<const std::uint8_t> mapping = file.map();
+        out->assign(mapping.get(), mapping.get() + (mapping ? file.getSize() : 0));
         return true;
     }
 
@@ -107,6 +111,15 @@ namespace Carrot::Render {
         };
     }
 
+    static glm::vec3 toVec3(const tinygltf::Value& array) {
+        verify(array.IsArray() && array.ArrayLen() == 3, "Array must have exactly 3 values");
+        return glm::vec3 {
+                static_cast<float>(array.Get(0).GetNumberAsDouble()),
+                static_cast<float>(array.Get(1).GetNumberAsDouble()),
+                static_cast<float>(array.Get(2).GetNumberAsDouble()),
+        };
+    }
+
     static glm::vec4 toVec4(std::span<const double> doubles, const glm::vec4& defaultValue) {
         if(doubles.empty())
             return defaultValue;
@@ -208,6 +221,70 @@ namespace Carrot::Render {
         return *((const T*)pointerFromAccessor(index, accessor, model));
     }
 
+    static GLTFAccessors::StridedElements describeAccessor(const tinygltf::Accessor& accessor, const tinygltf::Model& model) {
+        GLTFAccessors::StridedElements elements;
+        elements.count = accessor.count;
+        elements.componentType = static_cast<GLTFAccessors::ComponentType>(accessor.componentType);
+        elements.componentCount = tinygltf::GetNumComponentsInType(accessor.type);
+        elements.normalized = accessor.normalized;
+        if(accessor.bufferView >= 0) { // without buffer view, elements are zeros (which sparse accessors can override)
+            const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+            elements.pData = model.buffers[bufferView.buffer].data.data() + bufferView.byteOffset + accessor.byteOffset;
+            elements.stride = computeStride(bufferView, accessor);
+        }
+        return elements;
+    }
+
+    /**
+     * Reads all elements of 'accessor' at once, converting their components to T and applying sparse substitution.
+     * Element i is written at 'pDestination' + i * 'destinationStride' (in bytes), see GLTFAccessors::convert
+     */
+    template<typename T>
+    static void readAccessor(const tinygltf::Accessor& accessor, const tinygltf::Model& model, T* pDestination, std::size_t destinationStride, std::size_t destinationComponentCount) {
+        ZoneScoped;
+        GLTFAccessors::convert(describeAccessor(accessor, model), pDestination, destinationStride, destinationComponentCount);
+        if(!accessor.sparse.isSparse) {
+            return;
+        }
+
+        const auto& sparse = accessor.sparse;
+        const tinygltf::BufferView& indicesView = model.bufferViews[sparse.indices.bufferView];
+        GLTFAccessors::StridedElements indices;
+        indices.pData = model.buffers[indicesView.buffer].data.data() + indicesView.byteOffset + sparse.indices.byteOffset;
+        indices.componentType = static_cast<GLTFAccessors::ComponentType>(sparse.indices.componentType);
+        indices.stride = GLTFAccessors::getComponentSize(indices.componentType);
+        indices.count = sparse.count;
+
+        const tinygltf::BufferView& valuesView = model.bufferViews[sparse.values.bufferView];
+        GLTFAccessors::StridedElements values = describeAccessor(accessor, model);
+        values.pData = model.buffers[valuesView.buffer].data.data() + valuesView.byteOffset + sparse.values.byteOffset;
+        values.stride = values.componentCount * GLTFAccessors::getComponentSize(values.componentType); // sparse values are tightly packed
+        values.count = sparse.count;
+
+        GLTFAccessors::convertSparse(indices, values, accessor.count, pDestination, destinationStride, destinationComponentCount);
+    }
+
+    /// Reads all elements of 'accessor' into an array of float-based types (float, glm::vec3, glm::mat4, ...)
+    template<typename T>
+    static std::vector<T> readAccessorElements(const tinygltf::Accessor& accessor, const tinygltf::Model& model) {
+        static_assert(sizeof(T) % sizeof(float) == 0);
+        std::vector<T> elements;
+        elements.resize(accessor.count);
+        readAccessor(accessor, model, reinterpret_cast<float*>(elements.data()), sizeof(T), sizeof(T) / sizeof(float));
+        return elements;
+    }
+
+    /// Runs 'forEach' for each index in [0; count[, in parallel when a task scheduler is available (tools can load models without one)
+    static void forEachInParallel(std::size_t count, const std::function<void(std::size_t)>& forEach) {
+        if(Carrot::Async::parallelFor != nullptr) {
+            Carrot::Async::parallelFor(count, forEach, 1);
+        } else {
+            for(std::size_t i = 0; i < count; i++) {
+                forEach(i);
+            }
+        }
+    }
+
     static void loadVertices(LoadedPrimitive& loadedPrimitive, const tinygltf::Model& model, const tinygltf::Primitive& primitive, PrimitiveInformation& info) {
         ZoneScoped;
         std::vector<Vertex>& vertices = loadedPrimitive.vertices;
@@ -249,7 +326,7 @@ namespace Carrot::Render {
 
         int jointWeightsAccessorIndex = -1;
         auto jointWeightsAttributeIt = primitive.attributes.find("WEIGHTS_0");
-        if(jointsAttributeIt != primitive.attributes.end()) {
+        if(jointWeightsAttributeIt != primitive.attributes.end()) {
             jointWeightsAccessorIndex = jointWeightsAttributeIt->second;
         }
 
@@ -263,7 +340,8 @@ namespace Carrot::Render {
         const bool usesSkinning = jointsAccessor != nullptr && jointWeightsAccessor != nullptr;
         loadedPrimitive.isSkinned = usesSkinning;
         // TODO: UV2
-        // TODO: support compressed meshes
+        // standard attributes are never compressed by Fertilizer: they are the float copy used for raytracing and non-cluster
+        // rendering. Meshlets use the compressed and quantized vertices of CARROT_meshlets instead (see loadMeshlets)
 
         if(normalsAccessor != nullptr) {
             verify(positionsAccessor.count == normalsAccessor->count, "Mismatched position/normal count");
@@ -288,77 +366,64 @@ namespace Carrot::Render {
         loadedPrimitive.minPos = toVec3(positionsAccessor.minValues, glm::vec3{INFINITY});
         loadedPrimitive.maxPos = toVec3(positionsAccessor.maxValues, glm::vec3{-INFINITY});
 
+        const std::size_t vertexCount = positionsAccessor.count;
         if(usesSkinning) {
-            skinnedVertices.resize(positionsAccessor.count);
+            skinnedVertices.resize(vertexCount);
         } else {
-            vertices.resize(positionsAccessor.count);
+            vertices.resize(vertexCount);
+        }
+        if(vertexCount == 0) {
+            return;
         }
-        for (std::size_t i = 0; i < positionsAccessor.count; ++i) {
-            Carrot::Vertex& vertex = usesSkinning ? skinnedVertices[i] : vertices[i];
-            const glm::vec3 pos = readFromAccessor<glm::vec3>(i, positionsAccessor, model);
-            vertex.pos = glm::vec4 { pos, 1.0f };
-            loadedPrimitive.minPos = glm::min(loadedPrimitive.minPos, pos);
-            loadedPrimitive.maxPos = glm::max(loadedPrimitive.maxPos, pos);
-
-            if(normalsAccessor) {
-                vertex.normal = readFromAccessor<glm::vec3>(i, *normalsAccessor, model);
-            } else {
-                vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
-            }
-
-            if(tangentsAccessor) {
-                vertex.tangent = readFromAccessor<glm::vec4>(i, *tangentsAccessor, model);
-            } else {
-                vertex.tangent = glm::vec4(0.0, 0.0, 0.0, 1.0);
-            }
 
-            if(texCoordsAccessor) {
-                vertex.uv = readFromAccessor<glm::vec2>(i, *texCoordsAccessor, model);
-            } else {
-                vertex.uv = glm::vec2(0.0f);
-            }
+        // fill default values first, then each attribute is converted in bulk, straight into the vertices
+        for(std::size_t i = 0; i < vertexCount; i++) {
+            Carrot::Vertex& vertex = usesSkinning ? skinnedVertices[i] : vertices[i];
+            vertex.pos = glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f };
+            vertex.normal = glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.tangent = glm::vec4(0.0, 0.0, 0.0, 1.0);
+            vertex.uv = glm::vec2(0.0f);
+            vertex.color = glm::vec3 { 1.0f };
+        }
 
-            if(vertexColorAccessor) {
-                vertex.color = readFromAccessor<glm::vec4>(i, *vertexColorAccessor, model);
-            } else {
-                vertex.color = glm::vec4 { 1.0f };
-            }
+        Carrot::Vertex& firstVertex = usesSkinning ? skinnedVertices[0] : vertices[0];
+        const std::size_t vertexStride = usesSkinning ? sizeof(SkinnedVertex) : sizeof(Vertex);
+        readAccessor(positionsAccessor, model, &firstVertex.pos.x, vertexStride, 3);
+        if(normalsAccessor) {
+            readAccessor(*normalsAccessor, model, &firstVertex.normal.x, vertexStride, 3);
+        }
+        if(tangentsAccessor) {
+            readAccessor(*tangentsAccessor, model, &firstVertex.tangent.x, vertexStride, 4);
+        }
+        if(texCoordsAccessor) {
+            readAccessor(*texCoordsAccessor, model, &firstVertex.uv.x, vertexStride, 2);
+        }
+        if(vertexColorAccessor) {
+            // RGB or RGBA, alpha is ignored
+            readAccessor(*vertexColorAccessor, model, &firstVertex.color.x, vertexStride, 3);
+        }
+        if(usesSkinning) {
+            SkinnedVertex& firstSkinnedVertex = skinnedVertices[0];
+            readAccessor(*jointsAccessor, model, &firstSkinnedVertex.boneIDs.x, vertexStride, 4);
+            readAccessor(*jointWeightsAccessor, model, &firstSkinnedVertex.boneWeights.x, vertexStride, 4);
+        }
 
-            if(usesSkinning) {
-                SkinnedVertex& skinnedVertex = (SkinnedVertex&)vertex;
-                skinnedVertex.boneIDs = readFromAccessor<glm::u8vec4>(i, *jointsAccessor, model);
-                skinnedVertex.boneWeights = readFromAccessor<glm::vec4>(i, *jointWeightsAccessor, model);
-            }
+        for(std::size_t i = 0; i < vertexCount; i++) {
+            const glm::vec3 pos { usesSkinning ? skinnedVertices[i].pos : vertices[i].pos };
+            loadedPrimitive.minPos = glm::min(loadedPrimitive.minPos, pos);
+            loadedPrimitive.maxPos = glm::max(loadedPrimitive.maxPos, pos);
         }
     }
 
     static void loadIndices(std::vector<std::uint32_t>& indices, const tinygltf::Model& model, const tinygltf::Primitive& primitive) {
         ZoneScoped;
         const tinygltf::Accessor& accessor = model.accessors[primitive.indices];
+        verify(accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE
+            || accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+            || accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, Carrot::sprintf("Unsupported component type: %d", accessor.componentType));
 
-        // TODO: support compressed meshes
         indices.resize(accessor.count);
-
-        // TODO: parallelization?
-        for (int j = 0; j < indices.size(); ++j) {
-            switch(accessor.componentType) {
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: // u8
-                    indices[j] = readFromAccessor<std::uint8_t>(j, accessor, model);
-                    break;
-
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: // u16
-                    indices[j] = readFromAccessor<std::uint16_t>(j, accessor, model);
-                    break;
-
-                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: // u32
-                    indices[j] = readFromAccessor<std::uint32_t>(j, accessor, model);
-                    break;
-
-                default:
-                    verify(false, Carrot::sprintf("Unsupported component type: %d", accessor.componentType));
-                    break;
-            }
-        }
+        readAccessor(accessor, model, indices.data(), sizeof(std::uint32_t), 1);
     }
 
     static void loadMeshlets(LoadedPrimitive& loadedPrimitive, const tinygltf::Model& model, const tinygltf::Primitive& primitive) {
@@ -381,23 +446,40 @@ namespace Carrot::Render {
             //Carrot::Async::parallelFor(loadedPrimitive.meshlets.size(), [&](std::size_t i) {
             //  }, 16);
         }
+        if(value.Has("compression")) {
+            const std::string& compression = value.Get("compression").Get<std::string>();
+            verify(compression == GLTFLoader::CARROT_MESHLETS_MESHOPT_COMPRESSION, Carrot::sprintf("Unsupported meshlet compression: %s", compression.c_str()));
+
+            auto getCompressedBytes = [&](int accessorIndex) {
+                const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+                return std::span<const std::uint8_t> { static_cast<const std::uint8_t*>(pointerFromAccessor(0, accessor, model)), accessor.count };
+            };
+            loadedPrimitive.meshletVertexIndices.resize(value.Get("meshlets_vertex_indices_count").GetNumberAsInt());
+            MeshCompression::decodeIndexSequence(getCompressedBytes(meshletsVertexIndicesAccessorIndex), loadedPrimitive.meshletVertexIndices);
+
+            loadedPrimitive.meshletIndices.resize(value.Get("meshlets_indices_count").GetNumberAsInt());
+            MeshCompression::decodeIndexBuffer(getCompressedBytes(meshletsIndicesAccessorIndex), loadedPrimitive.meshletIndices);
+
+            if(value.Has("quantized_vertices")) {
+                loadedPrimitive.quantizedVertices.resize(value.Get("quantized_vertices_count").GetNumberAsInt());
+                verify(loadedPrimitive.quantizedVertices.size() == loadedPrimitive.vertices.size(), "Quantized vertices do not match the vertices of the primitive");
+                MeshCompression::decodeVertexBuffer(getCompressedBytes(value.Get("quantized_vertices").GetNumberAsInt()), std::span { loadedPrimitive.quantizedVertices });
+                loadedPrimitive.quantizationBounds.min = toVec3(value.Get("quantization_bounds_min"));
+                loadedPrimitive.quantizationBounds.max = toVec3(value.Get("quantization_bounds_max"));
+            }
+            return;
+        }
+
+        // uncompressed streams, from older versions of Fertilizer
         {
             const tinygltf::Accessor& accessor = model.accessors[meshletsVertexIndicesAccessorIndex];
             loadedPrimitive.meshletVertexIndices.resize(accessor.count);
-            for(std::size_t i = 0; i < loadedPrimitive.meshletVertexIndices.size(); i++) {
-                //Carrot::Async::parallelFor(loadedPrimitive.meshletVertexIndices.size(), [&](std::size_t i) {
-                loadedPrimitive.meshletVertexIndices[i] = readFromAccessor<std::uint32_t>(i, accessor, model);
-                //}, 16);
-            }
+            readAccessor(accessor, model, loadedPrimitive.meshletVertexIndices.data(), sizeof(std::uint32_t), 1);
         }
         {
             const tinygltf::Accessor& accessor = model.accessors[meshletsIndicesAccessorIndex];
             loadedPrimitive.meshletIndices.resize(accessor.count);
-            for(std::size_t i = 0; i < loadedPrimitive.meshletIndices.size(); i++) {
-            //Carrot::Async::parallelFor(loadedPrimitive.meshletIndices.size(), [&](std::size_t i) {
-                loadedPrimitive.meshletIndices[i] = readFromAccessor<std::uint32_t>(i, accessor, model);
-            //}, 16);
-            }
+            readAccessor(accessor, model, loadedPrimitive.meshletIndices.data(), sizeof(std::uint32_t), 1);
         }
     }
 
@@ -421,8 +503,8 @@ namespace Carrot::Render {
 
         IO::VFS::Path vfsPath { resource.getName() };
 
-        std::string gltfContents = resource.readText();
-        const char* gltfStr = gltfContents.c_str();
+        const IO::MappedResource gltfContents = resource.map();
+        const char* gltfStr = reinterpret_cast<const char*>(gltfContents.data());
         const std::size_t gltfStrSize = gltfContents.size();
 
         std::string baseDir = Carrot::toString(resource.getFilepath().parent_path().u8string());
@@ -509,34 +591,47 @@ namespace Carrot::Render {
             }
         }
 
-        bool hasAnySkin = false;
+        // primitives are independent from each other: assign their slots in glTF order, then load them in parallel
         std::vector<GLTFMesh> meshes;
-        meshes.reserve(model.meshes.size());
+        std::vector<std::pair<std::size_t, std::size_t>> primitiveSources; // (mesh index, primitive index inside mesh)
+        meshes.resize(model.meshes.size());
         for(std::size_t i = 0; i < model.meshes.size(); i++) {
-            const auto& mesh = model.meshes[i];
-            UserNotifications::getInstance().setBody(loadNotifID, Carrot::sprintf("Loading mesh (%llu / %llu)", i, model.meshes.size()));
-            UserNotifications::getInstance().setProgress(loadNotifID, float(i) / model.meshes.size());
+            GLTFMesh& gltfMesh = meshes[i];
+            gltfMesh.firstPrimitive = primitiveSources.size();
+            gltfMesh.primitiveCount = model.meshes[i].primitives.size();
+            for(std::size_t j = 0; j < gltfMesh.primitiveCount; j++) {
+                primitiveSources.emplace_back(i, j);
+            }
+        }
 
-            GLTFMesh& gltfMesh = meshes.emplace_back();
-            gltfMesh.firstPrimitive = result.primitives.size();
+        result.primitives.resize(primitiveSources.size());
+        std::atomic<std::size_t> loadedPrimitiveCount { 0 };
+        forEachInParallel(primitiveSources.size(), [&](std::size_t primitiveIndex) {
+            const auto& [meshIndex, indexInMesh] = primitiveSources[primitiveIndex];
+            const tinygltf::Mesh& mesh = model.meshes[meshIndex];
+            const tinygltf::Primitive& primitive = mesh.primitives[indexInMesh];
 
-            for(const auto& primitive : mesh.primitives) {
-                LoadedPrimitive& loadedPrimitive = result.primitives.emplace_back();
-                loadedPrimitive.materialIndex = primitive.material;
-                loadedPrimitive.name = mesh.name;
+            LoadedPrimitive& loadedPrimitive = result.primitives[primitiveIndex];
+            loadedPrimitive.materialIndex = primitive.material;
+            loadedPrimitive.name = mesh.name;
 
-                PrimitiveInformation info;
-                loadVertices(loadedPrimitive, model, primitive, info);
-                loadIndices(loadedPrimitive.indices, model, primitive);
-                loadMeshlets(loadedPrimitive, model, primitive);
-                hasAnySkin |= loadedPrimitive.isSkinned;
+            PrimitiveInformation info;
+            loadVertices(loadedPrimitive, model, primitive, info);
+            loadIndices(loadedPrimitive.indices, model, primitive);
+            loadMeshlets(loadedPrimitive, model, primitive);
 
-                loadedPrimitive.hadNormals = info.hasNormals;
-                loadedPrimitive.hadTexCoords = info.hasTexCoords;
-                loadedPrimitive.hadTangents = info.hasTangents;
+            loadedPrimitive.hadNormals = info.hasNormals;
+            loadedPrimitive.hadTexCoords = info.hasTexCoords;
+            loadedPrimitive.hadTangents = info.hasTangents;
 
-                gltfMesh.primitiveCount++;
-            }
+            const std::size_t loadedCount = ++loadedPrimitiveCount;
+            UserNotifications::getInstance().setBody(loadNotifID, Carrot::sprintf("Loading primitive (%llu / %llu)", loadedCount, primitiveSources.size()));
+            UserNotifications::getInstance().setProgress(loadNotifID, float(loadedCount) / primitiveSources.size());
+        });
+
+        bool hasAnySkin = false;
+        for(const LoadedPrimitive& loadedPrimitive : result.primitives) {
+            hasAnySkin |= loadedPrimitive.isSkinned;
         }
 
         auto precomputedBLASesExt = model.extensions.find(CARROT_PRECOMPUTED_MESHLETS_BLAS_EXTENSION_NAME);
@@ -584,196 +679,210 @@ namespace Carrot::Render {
     }
 
     void GLTFLoader::loadAnimations(LoadedScene& result, const tinygltf::Model& model, const NodeMapping& nodeMapping) {
-        for(const auto& animation : model.animations) {
-            const std::size_t animationIndex = result.animationData.size();
-            Animation& carrotAnimation = result.animationData.emplace_back();
-
-            std::string animationName = animation.name;
+        result.animationData.resize(model.animations.size());
+        for(std::size_t animationIndex = 0; animationIndex < model.animations.size(); animationIndex++) {
+            std::string animationName = model.animations[animationIndex].name;
             if(animationName.empty()) {
                 animationName = Carrot::sprintf("animation %d", animationIndex);
             }
             result.animationMapping[animationName] = animationIndex;
+        }
 
-            // mimic what is done in AssimpLoader: load all timestamps and fill translation/rotation/scale of each bone for each timestamp
-            //  not great for memory, but dumb enough for fast runtime usage
-
-            std::set<float> timestampsSet; // we want them sorted
-            float duration = 0.0f;
-            for(const auto& channel : animation.channels) {
-                const auto& sampler = animation.samplers[channel.sampler];
-                const auto& timestampAccessor = model.accessors[sampler.input];
-                for(std::size_t timestampIndex = 0; timestampIndex < timestampAccessor.count; timestampIndex++) {
-                    const float timestamp = readFromAccessor<float>(timestampIndex, timestampAccessor, model);
-                    timestampsSet.emplace(timestamp);
-                    carrotAnimation.duration = std::max(timestamp, carrotAnimation.duration);
-                }
-            }
+        // animations only read the rest of the scene: create the entries they look at before going wide
+        const int meshIndex = 0; // TODO: like AssimpLoader, only a single mesh can be animated at once per glTF file when loaded into Carrot
+        const auto& boneMapping = result.boneMapping[meshIndex];
+        const auto& offsetMatrices = result.offsetMatrices[meshIndex];
+        forEachInParallel(model.animations.size(), [&](std::size_t animationIndex) {
+            loadAnimation(result.animationData[animationIndex], *result.nodeHierarchy, boneMapping, offsetMatrices, model, model.animations[animationIndex], nodeMapping);
+        });
+    }
 
-            std::vector<float> allTimestamps;
-            allTimestamps.reserve(timestampsSet.size());
-            for(const float& timestamp : timestampsSet) {
-                allTimestamps.emplace_back(timestamp);
-            }
+    void GLTFLoader::loadAnimation(Animation& carrotAnimation, Skeleton& nodeHierarchy,
+                                   const std::unordered_map<std::string, std::uint32_t>& boneMapping, const std::unordered_map<std::string, glm::mat4>& offsetMatrices,
+                                   const tinygltf::Model& model, const tinygltf::Animation& animation, const NodeMapping& nodeMapping) {
+        ZoneScoped;
+        // mimic what is done in AssimpLoader: load all timestamps and fill translation/rotation/scale of each bone for each timestamp
+        //  not great for memory, but dumb enough for fast runtime usage
 
-            carrotAnimation.keyframeCount = allTimestamps.size();
-            carrotAnimation.keyframes.resize(carrotAnimation.keyframeCount);
-            for(auto& keyframe : carrotAnimation.keyframes) {
-                keyframe.boneTransforms.resize(nodeMapping.size(), glm::mat4{1.0f});
+        // convert the samplers of each channel once
+        struct ChannelData {
+            std::vector<float> timestamps;
+            std::vector<glm::vec4> values; // vec3 for translation and scale, XYZW quaternion for rotation
+        };
+        std::vector<ChannelData> channelsData;
+        channelsData.resize(animation.channels.size());
+
+        std::set<float> timestampsSet; // we want them sorted
+        for(std::size_t channelIndex = 0; channelIndex < animation.channels.size(); channelIndex++) {
+            const auto& sampler = animation.samplers[animation.channels[channelIndex].sampler];
+            ChannelData& channelData = channelsData[channelIndex];
+            channelData.timestamps = readAccessorElements<float>(model.accessors[sampler.input], model);
+            channelData.values = readAccessorElements<glm::vec4>(model.accessors[sampler.output], model);
+            for(const float timestamp : channelData.timestamps) {
+                timestampsSet.emplace(timestamp);
+                carrotAnimation.duration = std::max(timestamp, carrotAnimation.duration);
             }
+        }
 
-            // read the TRS of each node over time for this animation
-            struct GLTFKeyframe {
-                std::optional<glm::vec3> position;
-                std::optional<glm::quat> rotation;
-                std::optional<glm::vec3> scale;
+        std::vector<float> allTimestamps;
+        allTimestamps.reserve(timestampsSet.size());
+        for(const float& timestamp : timestampsSet) {
+            allTimestamps.emplace_back(timestamp);
+        }
 
-                bool worldSpace = false;
-                glm::mat4 worldSpaceTransform = glm::identity<glm::mat4>();
-            };
+        carrotAnimation.keyframeCount = allTimestamps.size();
+        carrotAnimation.keyframes.resize(carrotAnimation.keyframeCount);
+        for(auto& keyframe : carrotAnimation.keyframes) {
+            keyframe.boneTransforms.resize(nodeMapping.size(), glm::mat4{1.0f});
+        }
 
-            std::unordered_map<std::uint32_t, std::vector<GLTFKeyframe>> keyframesForAllNodes;
-            std::size_t keyframeIndex = 0;
-            for(const float& timestamp : allTimestamps) {
-                Keyframe& carrotKeyframe = carrotAnimation.keyframes[keyframeIndex];
-                carrotKeyframe.timestamp = timestamp;
-                for(const auto& channel : animation.channels) {
-                    const auto& sampler = animation.samplers[channel.sampler];
-                    const auto& timestampAccessor = model.accessors[sampler.input];
-                    const auto& keyframeValueAccessor = model.accessors[sampler.output];
-
-                    std::vector<GLTFKeyframe>& keyframes = keyframesForAllNodes[channel.target_node];
-                    if(keyframes.empty()) {
-                        keyframes.resize(allTimestamps.size());
-                    }
+        // read the TRS of each node over time for this animation
+        struct GLTFKeyframe {
+            std::optional<glm::vec3> position;
+            std::optional<glm::quat> rotation;
+            std::optional<glm::vec3> scale;
 
-                    // find which keyframe corresponds to the given timestamp
-                    std::size_t timestampIndex = 0;
-                    for(; timestampIndex < timestampAccessor.count; timestampIndex++) {
-                        const float keyframeTimestamp = readFromAccessor<float>(timestampIndex, timestampAccessor, model);
-                        if(keyframeTimestamp >= timestamp) {
-                            break;
-                        }
-                    }
+            bool worldSpace = false;
+            glm::mat4 worldSpaceTransform = glm::identity<glm::mat4>();
+        };
 
-                    GLTFKeyframe& keyframe = keyframes[timestampIndex];
+        std::unordered_map<std::uint32_t, std::vector<GLTFKeyframe>> keyframesForAllNodes;
+        std::size_t keyframeIndex = 0;
+        for(const float& timestamp : allTimestamps) {
+            Keyframe& carrotKeyframe = carrotAnimation.keyframes[keyframeIndex];
+            carrotKeyframe.timestamp = timestamp;
+            for(std::size_t channelIndex = 0; channelIndex < animation.channels.size(); channelIndex++) {
+                const auto& channel = animation.channels[channelIndex];
+                const ChannelData& channelData = channelsData[channelIndex];
+
+                std::vector<GLTFKeyframe>& keyframes = keyframesForAllNodes[channel.target_node];
+                if(keyframes.empty()) {
+                    keyframes.resize(allTimestamps.size());
+                }
 
-                    const std::string& target = channel.target_path;
-                    if(target == "translation") {
-                        keyframe.position = readFromAccessor<glm::vec3>(timestampIndex, keyframeValueAccessor, model);
-                    } else if(target == "rotation") {
-                        glm::vec4 keyframeRotationXYZW = readFromAccessor<glm::vec4>(timestampIndex, keyframeValueAccessor, model);
-                        keyframe.rotation = { keyframeRotationXYZW.w, keyframeRotationXYZW.x, keyframeRotationXYZW.y, keyframeRotationXYZW.z };
-                    } else if(target == "scale") {
-                        keyframe.scale = readFromAccessor<glm::vec3>(timestampIndex, keyframeValueAccessor, model);
-                    } else {
-                        verify(false, "Unknown target_path in glTF: " + target);
-                    }
+                // find which keyframe corresponds to the given timestamp (sampler inputs are strictly increasing)
+                const std::size_t timestampIndex = std::lower_bound(channelData.timestamps.begin(), channelData.timestamps.end(), timestamp) - channelData.timestamps.begin();
+                if(timestampIndex >= channelData.timestamps.size()) {
+                    continue; // channel has already ended
                 }
 
-                keyframeIndex++;
+                GLTFKeyframe& keyframe = keyframes[timestampIndex];
+                const glm::vec4& keyframeValue = channelData.values[timestampIndex];
+
+                const std::string& target = channel.target_path;
+                if(target == "translation") {
+                    keyframe.position = glm::vec3 { keyframeValue };
+                } else if(target == "rotation") {
+                    keyframe.rotation = { keyframeValue.w, keyframeValue.x, keyframeValue.y, keyframeValue.z };
+                } else if(target == "scale") {
+                    keyframe.scale = glm::vec3 { keyframeValue };
+                } else {
+                    verify(false, "Unknown target_path in glTF: " + target);
+                }
             }
 
-            // interpolate keyframe values when none exist
-            for(auto& [nodeID, keyframes] : keyframesForAllNodes) {
-                // used if there are no more keyframes with a value at this timestamp (keep same keyframe value until end of animation)
-                GLTFKeyframe latestKeyframe{
-                        .position = glm::vec3{0.0f},
-                        .rotation = glm::identity<glm::quat>(),
-                        .scale = glm::vec3{1.0f}
-                };
-                auto interpolate = [&](auto pMemberPtr, std::size_t index) {
-                    if (index == 0) {
-                        return (latestKeyframe.*pMemberPtr).value();
-                    }
+            keyframeIndex++;
+        }
 
-                    // find next keyframe with a value
-                    std::size_t nextIndex = index;
-                    for (std::size_t i = index + 1; i < allTimestamps.size(); i++) {
-                        if ((keyframes[i].*pMemberPtr).has_value()) {
-                            nextIndex = i;
-                            break;
-                        }
+        // interpolate keyframe values when none exist
+        for(auto& [nodeID, keyframes] : keyframesForAllNodes) {
+            // used if there are no more keyframes with a value at this timestamp (keep same keyframe value until end of animation)
+            GLTFKeyframe latestKeyframe{
+                    .position = glm::vec3{0.0f},
+                    .rotation = glm::identity<glm::quat>(),
+                    .scale = glm::vec3{1.0f}
+            };
+            auto interpolate = [&](auto pMemberPtr, std::size_t index) {
+                if (index == 0) {
+                    return (latestKeyframe.*pMemberPtr).value();
+                }
+
+                // find next keyframe with a value
+                std::size_t nextIndex = index;
+                for (std::size_t i = index + 1; i < allTimestamps.size(); i++) {
+                    if ((keyframes[i].*pMemberPtr).has_value()) {
+                        nextIndex = i;
+                        break;
                     }
+                }
 
-                    if (nextIndex <= index) { // there is no keyframe after this one which contains a value
-                        return (latestKeyframe.*pMemberPtr).value();
-                    } else {
-                        std::size_t previousIndex = index - 1;
-                        const GLTFKeyframe& previousKeyframe = keyframes[previousIndex];
-                        const GLTFKeyframe& nextKeyframe = keyframes[nextIndex];
+                if (nextIndex <= index) { // there is no keyframe after this one which contains a value
+                    return (latestKeyframe.*pMemberPtr).value();
+                } else {
+                    std::size_t previousIndex = index - 1;
+                    const GLTFKeyframe& previousKeyframe = keyframes[previousIndex];
+                    const GLTFKeyframe& nextKeyframe = keyframes[nextIndex];
 
-                        float previousTime = allTimestamps[previousIndex];
-                        float nextTime = allTimestamps[nextIndex];
+                    float previousTime = allTimestamps[previousIndex];
+                    float nextTime = allTimestamps[nextIndex];
 
-                        float currentTime = allTimestamps[index];
-                        float t = (currentTime - previousTime) / (nextTime - previousTime);
-                        return (previousKeyframe.*pMemberPtr).value() * (1 - t) +
-                               (nextKeyframe.*pMemberPtr).value() * t;
-                    }
-                };
-                for (std::size_t i = 0; i < allTimestamps.size(); i++) {
-                    GLTFKeyframe& currentKeyframe = keyframes[i];
-                    if (!currentKeyframe.position.has_value()) {
-                        currentKeyframe.position = interpolate(&GLTFKeyframe::position, i);
-                    }
-                    if (!currentKeyframe.rotation.has_value()) {
-                        currentKeyframe.rotation = interpolate(&GLTFKeyframe::rotation, i);
-                    }
-                    if (!currentKeyframe.scale.has_value()) {
-                        currentKeyframe.scale = interpolate(&GLTFKeyframe::scale, i);
-                    }
-                    latestKeyframe = currentKeyframe;
+                    float currentTime = allTimestamps[index];
+                    float t = (currentTime - previousTime) / (nextTime - previousTime);
+                    return (previousKeyframe.*pMemberPtr).value() * (1 - t) +
+                           (nextKeyframe.*pMemberPtr).value() * t;
+                }
+            };
+            for (std::size_t i = 0; i < allTimestamps.size(); i++) {
+                GLTFKeyframe& currentKeyframe = keyframes[i];
+                if (!currentKeyframe.position.has_value()) {
+                    currentKeyframe.position = interpolate(&GLTFKeyframe::position, i);
+                }
+                if (!currentKeyframe.rotation.has_value()) {
+                    currentKeyframe.rotation = interpolate(&GLTFKeyframe::rotation, i);
                 }
+                if (!currentKeyframe.scale.has_value()) {
+                    currentKeyframe.scale = interpolate(&GLTFKeyframe::scale, i);
+                }
+                latestKeyframe = currentKeyframe;
             }
+        }
 
-            for(auto& [nodeID, keyframes] : keyframesForAllNodes) {
-                const int meshIndex = 0; // TODO: like AssimpLoader, only a single mesh can be animated at once per glTF file when loaded into Carrot
-                // at this point, all keyframes have values
-                // now compute global transform for each keyframe
-                for(std::size_t timestampIndex = 0; timestampIndex < allTimestamps.size(); timestampIndex++) {
-                    Keyframe& finalKeyframe = carrotAnimation.keyframes[timestampIndex];
-
-                    std::function<glm::mat4(SkeletonTreeNode&, GLTFKeyframe&)> computeTransformRecursively =
-                            [&](SkeletonTreeNode& treeNode, GLTFKeyframe& keyframe) -> glm::mat4 {
-                                if(keyframe.worldSpace) {
-                                    return keyframe.worldSpaceTransform;
-                                }
+        for(auto& [nodeID, keyframes] : keyframesForAllNodes) {
+            // at this point, all keyframes have values
+            // now compute global transform for each keyframe
+            for(std::size_t timestampIndex = 0; timestampIndex < allTimestamps.size(); timestampIndex++) {
+                Keyframe& finalKeyframe = carrotAnimation.keyframes[timestampIndex];
 
-                                glm::mat4 translationMat = glm::translate(glm::mat4{1.0f}, keyframe.position.value());
-                                glm::mat4 rotationMat = glm::toMat4(glm::normalize(keyframe.rotation.value()));
-                                glm::mat4 scalingMat = glm::scale(glm::mat4{1.0f}, keyframe.scale.value());
-                                glm::mat4 localTransform = translationMat * rotationMat * scalingMat;
-
-                                glm::mat4 parentMatrix = glm::identity<glm::mat4>();
-                                if(treeNode.pParent) {
-                                    auto parentIter = nodeMapping.find(treeNode.pParent);
-                                    if(parentIter != nodeMapping.end()) { // == end if the root is the scene root, which is not a node inside glTF
-                                        int parentNodeIndex = parentIter->second;
-                                        auto iter = keyframesForAllNodes.find(parentNodeIndex);
-                                        if(iter != keyframesForAllNodes.end()) {
-                                            parentMatrix = computeTransformRecursively(*treeNode.pParent, iter->second[timestampIndex]);
-                                        }
+                std::function<glm::mat4(SkeletonTreeNode&, GLTFKeyframe&)> computeTransformRecursively =
+                        [&](SkeletonTreeNode& treeNode, GLTFKeyframe& keyframe) -> glm::mat4 {
+                            if(keyframe.worldSpace) {
+                                return keyframe.worldSpaceTransform;
+                            }
+
+                            glm::mat4 translationMat = glm::translate(glm::mat4{1.0f}, keyframe.position.value());
+                            glm::mat4 rotationMat = glm::toMat4(glm::normalize(keyframe.rotation.value()));
+                            glm::mat4 scalingMat = glm::scale(glm::mat4{1.0f}, keyframe.scale.value());
+                            glm::mat4 localTransform = translationMat * rotationMat * scalingMat;
+
+                            glm::mat4 parentMatrix = glm::identity<glm::mat4>();
+                            if(treeNode.pParent) {
+                                auto parentIter = nodeMapping.find(treeNode.pParent);
+                                if(parentIter != nodeMapping.end()) { // == end if the root is the scene root, which is not a node inside glTF
+                                    int parentNodeIndex = parentIter->second;
+                                    auto iter = keyframesForAllNodes.find(parentNodeIndex);
+                                    if(iter != keyframesForAllNodes.end()) {
+                                        parentMatrix = computeTransformRecursively(*treeNode.pParent, iter->second[timestampIndex]);
                                     }
                                 }
-
-                                glm::mat4 globalTransform = parentMatrix * localTransform;
-                                keyframe.worldSpaceTransform = globalTransform;
-                                keyframe.worldSpace = true;
-                                return keyframe.worldSpaceTransform;
-                            };
-
-                    GLTFKeyframe& currentKeyframe = keyframes[timestampIndex];
-                    const std::string& nodeName = getNodeName(model, nodeID);
-                    auto boneMappingIter = result.boneMapping[meshIndex].find(nodeName);
-                    if(boneMappingIter == result.boneMapping[meshIndex].end()) {
-                        continue;
-                    }
-                    std::uint32_t boneIndex = boneMappingIter->second;
-                    SkeletonTreeNode* pTreeNode = result.nodeHierarchy->findNode(nodeName);
-                    verify(pTreeNode, "Could not find matching node in tree");
-                    const glm::mat4& boneOffset = result.offsetMatrices[meshIndex].at(nodeName);
-                    finalKeyframe.boneTransforms[boneIndex] = glTFSpaceToCarrotSpace * computeTransformRecursively(*pTreeNode, currentKeyframe) * boneOffset;
+                            }
+
+                            glm::mat4 globalTransform = parentMatrix * localTransform;
+                            keyframe.worldSpaceTransform = globalTransform;
+                            keyframe.worldSpace = true;
+                            return keyframe.worldSpaceTransform;
+                        };
+
+                GLTFKeyframe& currentKeyframe = keyframes[timestampIndex];
+                const std::string& nodeName = getNodeName(model, nodeID);
+                auto boneMappingIter = boneMapping.find(nodeName);
+                if(boneMappingIter == boneMapping.end()) {
+                    continue;
                 }
+                std::uint32_t boneIndex = boneMappingIter->second;
+                SkeletonTreeNode* pTreeNode = nodeHierarchy.findNode(nodeName);
+                verify(pTreeNode, "Could not find matching node in tree");
+                const glm::mat4& boneOffset = offsetMatrices.at(nodeName);
+                finalKeyframe.boneTransforms[boneIndex] = glTFSpaceToCarrotSpace * computeTransformRecursively(*pTreeNode, currentKeyframe) * boneOffset;
             }
         }
     }
@@ -820,6 +929,11 @@ namespace Carrot::Render {
 
             if(node.skin != -1) {
                 auto& glTFSkin = model.skins[node.skin];
+                std::vector<glm::mat4> inverseBindMatrices;
+                if(glTFSkin.inverseBindMatrices != -1) {
+                    inverseBindMatrices = readAccessorElements<glm::mat4>(model.accessors[glTFSkin.inverseBindMatrices], model);
+                    verify(inverseBindMatrices.size() >= glTFSkin.joints.size(), "Mismatched joints/inverseBindMatrices count");
+                }
                 for(std::size_t jointIndex = 0; jointIndex < glTFSkin.joints.size(); jointIndex++) {
                     int jointNodeID = glTFSkin.joints[jointIndex];
                     const auto& jointNode = model.nodes[jointNodeID];
@@ -827,7 +941,7 @@ namespace Carrot::Render {
                     skinBoneMapping[jointName] = jointIndex;
 
                     if(glTFSkin.inverseBindMatrices != -1) {
-                        skinInverseBinds[jointName] = readFromAccessor<glm::mat4>(jointIndex, model.accessors[glTFSkin.inverseBindMatrices], model);
+                        skinInverseBinds[jointName] = inverseBindMatrices[jointIndex];
                     } else {
                         skinInverseBinds[jointName] = glm::identity<glm::mat4>();
                     }
@@ -18,6 +18,9 @@ namespace Carrot::Render {
         static constexpr const char* const CARROT_PRECOMPUTED_MESHLETS_BLAS_EXTENSION_NAME = "CARROT_precomputed_meshlets_blas";
         static constexpr const char* const CARROT_NODE_KEY_EXTENSION_NAME = "CARROT_node_key";
 
+        /// Value of "compression" inside CARROT_meshlets, when meshlet index streams and quantized vertices are compressed with meshoptimizer codecs
+        static constexpr const char* const CARROT_MESHLETS_MESHOPT_COMPRESSION = "meshopt";
+
         LoadedScene load(const Carrot::IO::Resource& resource);
         LoadedScene load(const tinygltf::Model& model, const IO::VFS::Path& modelFilepath);
 
@@ -31,6 +34,11 @@ namespace Carrot::Render {
         using NodeMapping = std::unordered_map<SkeletonTreeNode*, int>;
 
         void loadAnimations(LoadedScene& result, const tinygltf::Model& model, const NodeMapping& nodeMapping);
+
+        /// Loads a single animation, only reads from the given scene data so multiple animations can be loaded in parallel
+        void loadAnimation(Animation& carrotAnimation, Skeleton& nodeHierarchy,
+                           const std::unordered_map<std::string, std::uint32_t>& boneMapping, const std::unordered_map<std::string, glm::mat4>& offsetMatrices,
+                           const tinygltf::Model& model, const tinygltf::Animation& animation, const NodeMapping& nodeMapping);
         void loadNodesRecursively(LoadedScene& scene, const tinygltf::Model& model, int nodeIndex, const std::span<const GLTFMesh>& meshes, SkeletonTreeNode& parentNode, NodeMapping& nodeMapping, const glm::mat4& parentTransform);
     };
 }
\ No newline at end of file
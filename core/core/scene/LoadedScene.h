@@ -13,6 +13,7 @@
 #include <core/render/Animation.h>
 #include <core/containers/Vector.hpp>
 #include <core/containers/Pair.hpp>
+#include <core/math/AABB.h>
 #include <core/render/VkAccelerationStructureHeader.h>
 #include <glm/glm.hpp>
 
@@ -116,6 +117,13 @@ namespace Carrot::Render {
         std::vector<std::uint32_t> meshletVertexIndices; // all vertices of all meshlets (indices of vertices inside original vertex buffer, ie 'vertices' in this struct)
         std::vector<std::uint32_t> meshletIndices; // all triangles of all meshlets (indices of vertices inside meshletVertexIndices)
         std::vector<Meshlet> meshlets;
+
+        /// Quantized copy of 'vertices' (same size), used to render the meshlets. Empty if the primitive was not quantized
+        /// (skinned primitives, or models exported by older versions of Fertilizer)
+        std::vector<Carrot::QuantizedVertex> quantizedVertices;
+
+        /// Bounds used to quantize the positions of 'quantizedVertices'
+        Math::AABB quantizationBounds;
     };
 
     /**
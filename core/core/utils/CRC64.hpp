@@ -45,11 +45,17 @@ namespace Carrot {
 	    0x25577eeb6e6bb820ULL, 0x196c0603e6b3b7c1ULL, 0x5d218f3a7fdba7e2ULL, 0x611af7d2f703a803ULL, 0x505b5e9e1edfea83ULL, 0x6c6026769607e562ULL, 0x282daf4f0f6ff541ULL, 0x1416d7a787b7faa0ULL,
 	};
 
-    constexpr std::uint64_t CRC64(const char* pData, std::size_t length) {
-		std::uint64_t crc = -1ull;
+    /// Continues a CRC64 computation over a new chunk of data. Start with 'crc' = 0.
+    /// CRC64Continue(CRC64(a), b) == CRC64(a + b)
+    constexpr std::uint64_t CRC64Continue(std::uint64_t crc, const char* pData, std::size_t length) {
+		crc ^= -1ull;
 		while(length--) {
 			crc = CRCTable[((crc ^ *(pData++)) & 0xFF)] ^ (crc >> 8);
 		}
         return crc ^ -1ull;
     }
+
+    constexpr std::uint64_t CRC64(const char* pData, std::size_t length) {
+        return CRC64Continue(0, pData, length);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "RadixSort.h"
+
+namespace Carrot {
+    void radixSort(std::span<SortKeyIndex> items, std::span<SortKeyIndex> scratch) {
+        radixSort(items, scratch, [](const SortKeyIndex& item) { return item.key; });
+    }
+}
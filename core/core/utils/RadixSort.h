@@ -0,0 +1,33 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace Carrot {
+    /// Element sorted by radixSort: a 64-bit key, and the index of the element it represents
+    struct SortKeyIndex {
+        std::uint64_t key = 0;
+        std::uint32_t index = 0;
+    };
+
+    /**
+     * \brief Sorts 'items' by increasing key, as returned by 'getKey' (std::uint64_t(const T&)). The sort is stable: items with
+     * the same key keep their relative order.
+     * LSD radix sort, 8 bits at a time. Digits which are the same for all keys are skipped, so keys which only use their
+     * lower bits are cheaper to sort.
+     * Large inputs are split in blocks sorted in parallel (via Carrot::Async::parallelFor, when available).
+     * \param items items to sort, sorted in-place
+     * \param scratch temporary storage, must have the same size as 'items'. Contents are undefined after the call
+     */
+    template<typename T, typename GetKey>
+    void radixSort(std::span<T> items, std::span<T> scratch, const GetKey& getKey);
+
+    /// Sorts 'items' by increasing SortKeyIndex::key, see radixSort above
+    void radixSort(std::span<SortKeyIndex> items, std::span<SortKeyIndex> scratch);
+}
+
+#include <core/utils/RadixSort.ipp>
@@ -0,0 +1,113 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <core/tasks/Tasks.h>
+#include <core/utils/Assert.h>
+
+namespace Carrot {
+    namespace RadixSortDetails {
+        constexpr std::size_t RadixBits = 8;
+        constexpr std::size_t BucketCount = 1 << RadixBits;
+        constexpr std::size_t DigitCount = 64 / RadixBits;
+
+        /// Below this count, a single block is used: parallelism is not worth the synchronisation
+        constexpr std::size_t MinItemsPerBlock = 16 * 1024;
+        constexpr std::size_t MaxBlockCount = 64;
+
+        using Histogram = std::array<std::uint32_t, BucketCount>;
+
+        inline std::size_t getDigit(std::uint64_t key, std::size_t digitIndex) {
+            return (key >> (digitIndex * RadixBits)) & (BucketCount - 1);
+        }
+    }
+
+    template<typename T, typename GetKey>
+    void radixSort(std::span<T> items, std::span<T> scratch, const GetKey& getKey) {
+        using namespace RadixSortDetails;
+        static_assert(std::is_trivially_copyable_v<T>);
+        verify(items.size() == scratch.size(), "Scratch buffer must have the same size as the items to sort");
+        verify(items.size() <= UINT32_MAX, "Too many items to sort");
+        if(items.size() <= 1) {
+            return;
+        }
+
+        const bool parallel = Carrot::Async::parallelFor != nullptr;
+        const std::size_t blockCount = parallel ? std::clamp<std::size_t>(items.size() / MinItemsPerBlock, 1, MaxBlockCount) : 1;
+        const std::size_t blockSize = (items.size() + blockCount - 1) / blockCount;
+        auto forEachBlock = [&](const std::function<void(std::size_t)>& forEach) {
+            if(blockCount > 1) {
+                Carrot::Async::parallelFor(blockCount, forEach, 1);
+            } else {
+                forEach(0);
+            }
+        };
+        auto getBlock = [&](std::span<T> data, std::size_t blockIndex) {
+            const std::size_t start = blockIndex * blockSize;
+            return data.subspan(start, std::min(blockSize, data.size() - start));
+        };
+
+        // which digits actually differ between keys, in a single read of the input. Others are skipped: nothing would move
+        std::vector<std::uint64_t> blockDifferences;
+        blockDifferences.resize(blockCount);
+        forEachBlock([&](std::size_t blockIndex) {
+            const std::uint64_t firstKey = getKey(items[0]);
+            std::uint64_t differences = 0;
+            for(const T& item : getBlock(items, blockIndex)) {
+                differences |= getKey(item) ^ firstKey;
+            }
+            blockDifferences[blockIndex] = differences;
+        });
+        std::uint64_t differences = 0;
+        for(std::uint64_t blockDifference : blockDifferences) {
+            differences |= blockDifference;
+        }
+
+        std::span<T> source = items;
+        std::span<T> destination = scratch;
+        std::vector<Histogram> blockHistograms;
+        blockHistograms.resize(blockCount);
+        for(std::size_t digitIndex = 0; digitIndex < DigitCount; digitIndex++) {
+            if(getDigit(differences, digitIndex) == 0) {
+                continue;
+            }
+
+            forEachBlock([&](std::size_t blockIndex) {
+                Histogram& histogram = blockHistograms[blockIndex];
+                histogram.fill(0);
+                for(const T& item : getBlock(source, blockIndex)) {
+                    histogram[getDigit(getKey(item), digitIndex)]++;
+                }
+            });
+
+            // where each block writes each bucket: buckets in order, and blocks in order inside a bucket (keeps the sort stable)
+            std::uint32_t offset = 0;
+            for(std::size_t bucket = 0; bucket < BucketCount; bucket++) {
+                for(std::size_t blockIndex = 0; blockIndex < blockCount; blockIndex++) {
+                    const std::uint32_t count = blockHistograms[blockIndex][bucket];
+                    blockHistograms[blockIndex][bucket] = offset;
+                    offset += count;
+                }
+            }
+
+            forEachBlock([&](std::size_t blockIndex) {
+                Histogram& offsets = blockHistograms[blockIndex];
+                for(const T& item : getBlock(source, blockIndex)) {
+                    destination[offsets[getDigit(getKey(item), digitIndex)]++] = item;
+                }
+            });
+            std::swap(source, destination);
+        }
+
+        if(source.data() != items.data()) {
+            std::copy(source.begin(), source.end(), items.begin());
+        }
+    }
+}
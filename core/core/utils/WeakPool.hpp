@@ -4,60 +4,159 @@
 
 #pragma once
 
+#include <algorithm>
+#include <concepts>
 #include <cstdint>
-#include <unordered_map>
-#include <queue>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
 
 namespace Carrot {
 
     class WeakPoolHandle {
     public:
-        explicit WeakPoolHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor): index(index), destructor(std::move(destructor)) {}
+        /// Gives the slot of a handle back to its pool. Plain function pointer + pool pointer: no allocation per handle
+        struct Releaser {
+            void (*release)(void* pPool, std::uint32_t slot, std::uint32_t generation) = nullptr;
+            void* pPool = nullptr;
+            std::uint32_t generation = 0;
+        };
+
+        explicit WeakPoolHandle(std::uint32_t index, Releaser releaser): index(index), releaser(releaser) {}
 
         std::uint32_t getSlot() const { return index; }
 
+        /// Incremented each time the slot is reused, used to detect stale IDs
+        std::uint32_t getGeneration() const { return releaser.generation; }
+
+        /// Slot + generation, can be stored instead of a pointer and resolved with WeakPool::find
+        std::uint64_t getID() const { return (static_cast<std::uint64_t>(releaser.generation) << 32) | index; }
+
         virtual ~WeakPoolHandle() {
-            destructor(this);
+            if(releaser.release) {
+                releaser.release(releaser.pPool, index, releaser.generation);
+            }
         }
 
     private:
         std::uint32_t index = -1;
-        std::function<void(WeakPoolHandle*)> destructor;
+        Releaser releaser;
     };
 
     /// Pool of weak_ptr to a given ElementType (which must be derived from WeakPoolHandle)
     ///  Getting an item out of the pool is done with ::create. The returned object (wrapped inside a shared_ptr) will
     ///  release the slot back to the pool once its destructor is called.
     ///  This pool does not store the objects, but their ID! This is used to distribute slots inside a buffer.
+    ///
+    ///  Implemented as a generational slot map: slots are stored contiguously (slot index = index in the GPU buffer),
+    ///  iteration is a linear scan over [0; getRequiredStorageCount()[ and freed slots are reused lowest first to keep
+    ///  buffers compact. Slots which changed (created, freed, or marked with markDirty) are tracked as a single range,
+    ///  so that buffer updates can be restricted to that range.
+    ///  Not thread-safe.
     /// \tparam ElementType
     template<typename ElementType> requires std::derived_from<ElementType, WeakPoolHandle>
     class WeakPool {
     public:
-        using Registry = std::unordered_map<std::uint32_t, std::weak_ptr<ElementType>>;
+        using Entry = std::pair<const std::uint32_t, std::weak_ptr<ElementType>>;
+
+        /// Range of slots [begin; end[
+        struct DirtyRange {
+            std::uint32_t begin = std::numeric_limits<std::uint32_t>::max();
+            std::uint32_t end = 0;
+
+            bool empty() const {
+                return begin >= end;
+            }
+
+            void add(std::uint32_t slot) {
+                begin = std::min(begin, slot);
+                end = std::max(end, slot + 1);
+            }
+
+            void merge(const DirtyRange& other) {
+                if(!other.empty()) {
+                    begin = std::min(begin, other.begin);
+                    end = std::max(end, other.end);
+                }
+            }
+        };
+
+        /// Iterates over occupied slots, in slot order
+        template<bool IsConst>
+        class Iterator {
+        public:
+            using PoolType = std::conditional_t<IsConst, const WeakPool, WeakPool>;
+            using value_type = Entry;
+            using reference = std::conditional_t<IsConst, const Entry&, Entry&>;
+            using pointer = std::conditional_t<IsConst, const Entry*, Entry*>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            Iterator() = default;
+            Iterator(PoolType* pPool, std::uint32_t slot): pPool(pPool), slot(slot) {
+                skipFreeSlots();
+            }
+
+            reference operator*() const { return pPool->slots[slot].entry; }
+            pointer operator->() const { return &pPool->slots[slot].entry; }
+
+            Iterator& operator++() {
+                slot++;
+                skipFreeSlots();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(const Iterator& other) const { return slot == other.slot; }
+
+        private:
+            void skipFreeSlots() {
+                const std::uint32_t end = pPool->requiredStorageCount;
+                while(slot < end && !pPool->slots[slot].occupied) {
+                    slot++;
+                }
+                slot = std::min(slot, end);
+            }
+
+            PoolType* pPool = nullptr;
+            std::uint32_t slot = 0;
+        };
 
     public:
-        std::size_t size() const {
-            return registry.size();
+        WeakPool() {
+            // slot 0 is never given out: GPU data uses 0 as "no element"
+            slots.emplace_back(0);
         }
 
-        auto begin() {
-            return registry.begin();
+        // handles keep a pointer to their pool
+        WeakPool(const WeakPool&) = delete;
+        WeakPool& operator=(const WeakPool&) = delete;
+
+        /// Number of occupied slots
+        std::size_t size() const {
+            return occupiedCount;
         }
 
-        auto begin() const {
-            return registry.begin();
+        Iterator<false> begin() {
+            return { this, 0 };
         }
 
-        auto end() {
-            return registry.end();
+        Iterator<true> begin() const {
+            return { this, 0 };
         }
 
-        auto end() const {
-            return registry.end();
+        Iterator<false> end() {
+            return { this, requiredStorageCount };
         }
 
-        void erase(auto start, auto end) {
-            registry.erase(start, end);
+        Iterator<true> end() const {
+            return { this, requiredStorageCount };
         }
 
         /**
@@ -70,71 +169,136 @@ namespace Carrot {
     public:
         struct Reservation {
             std::uint32_t index;
+            std::uint32_t generation;
             std::weak_ptr<ElementType>& ptr;
         };
 
         template<typename... Args>
         std::shared_ptr<ElementType> create(Args&&... args) {
             auto slot = reserveSlot();
-            auto ptr = std::make_shared<ElementType>(slot.index, [this](WeakPoolHandle* element) {
-                freeSlot(element->getSlot());
-            }, std::forward<Args>(args)...);
-            slot.ptr = ptr;
+            WeakPoolHandle::Releaser releaser {
+                .release = [](void* pPool, std::uint32_t slotIndex, std::uint32_t generation) {
+                    static_cast<WeakPool*>(pPool)->freeSlot(slotIndex, generation);
+                },
+                .pPool = this,
+                .generation = slot.generation,
+            };
+            auto ptr = std::make_shared<ElementType>(slot.index, releaser, std::forward<Args>(args)...);
+            // not through slot.ptr: the constructor may have created other elements and moved the slots
+            slots[slot.index].entry.second = ptr;
             return ptr;
         }
 
         Reservation reserveSlot() {
             std::uint32_t slot;
             if(!freeSlots.empty()) {
-                slot = freeSlots.front();
-                freeSlots.pop();
+                // lowest free slot first, to keep storage compact
+                std::pop_heap(freeSlots.begin(), freeSlots.end(), std::greater<>{});
+                slot = freeSlots.back();
+                freeSlots.pop_back();
             } else {
-                slot = nextID++;
+                slot = static_cast<std::uint32_t>(slots.size());
+                slots.emplace_back(slot);
             }
+            Slot& entry = slots[slot];
+            entry.occupied = true;
+            occupiedCount++;
             requiredStorageCount = std::max(slot+1, requiredStorageCount);
+            dirtyRange.add(slot);
             return Reservation {
                 .index = slot,
-                .ptr = registry[slot],
+                .generation = entry.generation,
+                .ptr = entry.entry.second,
             };
         }
 
-        void freeSlot(std::uint32_t slot) {
-            registry.erase(slot);
-            freeSlots.push(slot);
+        /// Releases the given slot, if it is still used by the given generation
+        void freeSlot(std::uint32_t slot, std::uint32_t generation) {
+            if(slot >= slots.size() || !slots[slot].occupied || slots[slot].generation != generation) {
+                return; // already freed
+            }
+            Slot& entry = slots[slot];
+            entry.entry.second.reset();
+            entry.occupied = false;
+            entry.generation++;
+            occupiedCount--;
+            freeSlots.push_back(slot);
+            std::push_heap(freeSlots.begin(), freeSlots.end(), std::greater<>{});
+            dirtyRange.add(slot);
 
-            std::uint32_t highestIndex = 0;
-            for(const auto& [index, ptr] : registry) {
-                if(auto handle = ptr.lock()) {
-                    highestIndex = std::max(handle->getSlot(), highestIndex);
-                }
+            while(requiredStorageCount > 0 && !slots[requiredStorageCount-1].occupied) {
+                requiredStorageCount--;
             }
-            requiredStorageCount = highestIndex+1;
         }
 
         void free(ElementType& handle) {
-            freeSlot(handle.getSlot());
+            freeSlot(handle.getSlot(), handle.getGeneration());
         }
 
         std::weak_ptr<ElementType> find(std::uint32_t slot) {
-            auto iter = registry.find(slot);
-            if(iter != registry.end()) {
-                return iter->second;
+            if(slot < slots.size() && slots[slot].occupied) {
+                return slots[slot].entry.second;
             }
             return {};
         }
 
         std::weak_ptr<const ElementType> find(std::uint32_t slot) const {
-            auto iter = registry.find(slot);
-            if(iter != registry.end()) {
-                return iter->second;
+            if(slot < slots.size() && slots[slot].occupied) {
+                return slots[slot].entry.second;
+            }
+            return {};
+        }
+
+        /// Finds the handle with the given ID (see WeakPoolHandle::getID). Returns an empty pointer if the slot was reused since
+        std::weak_ptr<ElementType> findByID(std::uint64_t id) {
+            const std::uint32_t slot = static_cast<std::uint32_t>(id);
+            const std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+            if(slot < slots.size() && slots[slot].occupied && slots[slot].generation == generation) {
+                return slots[slot].entry.second;
             }
             return {};
         }
 
+    public: // dirty tracking
+        /// Marks a slot as modified, for users which only update the slots that changed
+        void markDirty(std::uint32_t slot) {
+            dirtyRange.add(slot);
+        }
+
+        /// Marks all slots in [0; getRequiredStorageCount()[ as modified, for instance after the storage was reallocated
+        void markAllDirty() {
+            dirtyRange.merge(DirtyRange { .begin = 0, .end = requiredStorageCount });
+        }
+
+        /// Range of slots created, freed or marked dirty since the last call to clearDirtyRange
+        const DirtyRange& getDirtyRange() const {
+            return dirtyRange;
+        }
+
+        /// Returns the dirty range and resets it
+        DirtyRange consumeDirtyRange() {
+            DirtyRange result = dirtyRange;
+            dirtyRange = {};
+            return result;
+        }
+
+        void clearDirtyRange() {
+            dirtyRange = {};
+        }
+
     private:
-        Registry registry;
-        std::queue<std::uint32_t> freeSlots;
-        std::uint32_t nextID = 1;
+        struct Slot {
+            explicit Slot(std::uint32_t index): entry(index, std::weak_ptr<ElementType>{}) {}
+
+            Entry entry;
+            std::uint32_t generation = 0;
+            bool occupied = false;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<std::uint32_t> freeSlots; // min-heap
+        std::uint32_t occupiedCount = 0;
         std::uint32_t requiredStorageCount = 0;
+        DirtyRange dirtyRange;
     };
 }
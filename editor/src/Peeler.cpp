@@ -16,6 +16,7 @@
 #include <core/utils/stringmanip.h>
 #include <core/utils/UserNotifications.h>
 #include <engine/edition/DragDropTypes.h>
+#include <engine/scene/BinaryScene.h>
 #include <core/io/Logging.hpp>
 #include <engine/physics/PhysicsSystem.h>
 
@@ -993,9 +994,7 @@ namespace Peeler {
         isPaused = false;
         requestedSingleStep = false;
         hasDoneSingleStep = false;
-        savedScene.copyFrom(currentScene);
-
-        savedScene.unload();
+        playSnapshot = currentScene.takeSnapshot();
 
         currentScene.world.unfreezeLogic();
         currentScene.world.broadcastStartEvent();
@@ -1026,9 +1025,11 @@ namespace Peeler {
         requestedSingleStep = false;
         hasDoneSingleStep = false;
         currentScene.world.broadcastStopEvent();
-        savedScene.load();
-        currentScene.copyFrom(savedScene);
-        savedScene.clear();
+        if(playSnapshot.has_value() && playSnapshot->world->isRecording()) { // not recording if the world was replaced while playing
+            currentScene.restoreSnapshot(std::move(playSnapshot.value()));
+        }
+        playSnapshot.reset();
+        currentScene.load();
         GetPhysics().pause();
         GetEngine().ungrabCursor();
         stopSimulationRequested = false;
@@ -1325,7 +1326,17 @@ namespace Peeler {
             scenePath = path;
             try {
                 Carrot::IO::Resource sceneData = scenePath;
-                scene.Parse(sceneData.readText());
+                if(Carrot::BinaryScene::isBinaryScene(scenePath)) {
+                    // JSON stays the source format, the binary version is regenerated on save
+                    std::vector<std::uint8_t> binaryScene;
+                    binaryScene.resize(sceneData.getSize());
+                    sceneData.read(binaryScene);
+                    Carrot::BinaryScene::toJSON(binaryScene, scene);
+                    scenePath = scenePath.withExtension(".json");
+                } else {
+                    scene.Parse(sceneData.readText());
+                }
+                GetAssetServer().prefetchScene(scene);
                 currentScene.clear();
                 currentScene.deserialise(scene);
             } catch (std::exception& e) {
@@ -1351,6 +1362,10 @@ namespace Peeler {
 
         writeJSON(GetVFS().resolve(scenePath), sceneData);
 
+        std::vector<std::uint8_t> binaryScene = Carrot::BinaryScene::fromJSON(sceneData);
+        const std::filesystem::path binaryScenePath = GetVFS().resolve(scenePath.withExtension(Carrot::BinaryScene::Extension));
+        Carrot::IO::writeFile(binaryScenePath.string(), binaryScene.data(), binaryScene.size());
+
         addCurrentSceneToSceneList();
     }
 
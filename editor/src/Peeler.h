@@ -229,7 +229,7 @@ namespace Peeler {
         Carrot::Scene& currentScene;
 
     private:
-        Carrot::Scene savedScene;
+        std::optional<Carrot::Scene::Snapshot> playSnapshot; //< state of the scene before pressing Play
 
     private: // inputs
         Carrot::IO::ActionSet editorActions { "editor_actions" };
@@ -51,15 +51,16 @@ namespace Peeler {
     static void editLightComponent(EditContext& edition, const Carrot::Vector<Carrot::ECS::LightComponent*>& components) {
         multiEditField(edition, "Enabled", components,
             +[](Carrot::ECS::LightComponent& c) -> bool { return (c.lightRef->light.flags & Carrot::Render::LightFlags::Enabled) != Carrot::Render::LightFlags::None; },
-            +[](Carrot::ECS::LightComponent& c, const bool& newValue) { c.lightRef->light.flags = newValue ? Carrot::Render::LightFlags::Enabled : Carrot::Render::LightFlags::None; });
+            +[](Carrot::ECS::LightComponent& c, const bool& newValue) { c.lightRef->light.flags = newValue ? Carrot::Render::LightFlags::Enabled : Carrot::Render::LightFlags::None; c.lightRef->markDirty(); });
 
         multiEditEnumField(edition, "Light type", components,
             +[](Carrot::ECS::LightComponent& c) { return c.lightRef->light.type ; },
-            +[](Carrot::ECS::LightComponent& c, const Carrot::Render::LightType& v) { c.lightRef->light.type = v; },
+            +[](Carrot::ECS::LightComponent& c, const Carrot::Render::LightType& v) { c.lightRef->light.type = v; c.lightRef->markDirty(); },
             Carrot::Render::Light::nameOf, { Carrot::Render::LightType::Point, Carrot::Render::LightType::Directional, Carrot::Render::LightType::Spot });
 
         multiEditField(edition, "Intensity", components,
-            +[](Carrot::ECS::LightComponent& c) -> float& { return c.lightRef->light.intensity; });
+            +[](Carrot::ECS::LightComponent& c) { return c.lightRef->light.intensity; },
+            +[](Carrot::ECS::LightComponent& c, const float& v) { c.lightRef->light.intensity = v; c.lightRef->markDirty(); });
 
         if(ImGui::CollapsingHeader("Parameters")) {
             bool allSameType = true;
@@ -75,19 +76,22 @@ namespace Peeler {
                     case Carrot::Render::LightType::Spot: {
                         multiEditField(edition, "Cutoff angle", components,
                             +[](Carrot::ECS::LightComponent& c) { return Helpers::CosAngleWrapper { c.lightRef->light.spot.cutoffCosAngle }; },
-                            +[](Carrot::ECS::LightComponent& c, const Helpers::CosAngleWrapper& v) { c.lightRef->light.spot.cutoffCosAngle = v.cosRadianValue; });
+                            +[](Carrot::ECS::LightComponent& c, const Helpers::CosAngleWrapper& v) { c.lightRef->light.spot.cutoffCosAngle = v.cosRadianValue; c.lightRef->markDirty(); });
                         multiEditField(edition, "Outer cutoff angle", components,
                             +[](Carrot::ECS::LightComponent& c) { return Helpers::CosAngleWrapper { c.lightRef->light.spot.outerCutoffCosAngle }; },
-                            +[](Carrot::ECS::LightComponent& c, const Helpers::CosAngleWrapper& v) { c.lightRef->light.spot.outerCutoffCosAngle = v.cosRadianValue; });
+                            +[](Carrot::ECS::LightComponent& c, const Helpers::CosAngleWrapper& v) { c.lightRef->light.spot.outerCutoffCosAngle = v.cosRadianValue; c.lightRef->markDirty(); });
                     } break;
 
                     case Carrot::Render::LightType::Point: {
                         multiEditField(edition, "Constant attenuation", components,
-                            +[](Carrot::ECS::LightComponent& c) -> float& { return c.lightRef->light.point.constantAttenuation; });
+                            +[](Carrot::ECS::LightComponent& c) { return c.lightRef->light.point.constantAttenuation; },
+                            +[](Carrot::ECS::LightComponent& c, const float& v) { c.lightRef->light.point.constantAttenuation = v; c.lightRef->markDirty(); });
                         multiEditField(edition, "Linear attenuation", components,
-                            +[](Carrot::ECS::LightComponent& c) -> float& { return c.lightRef->light.point.linearAttenuation; });
+                            +[](Carrot::ECS::LightComponent& c) { return c.lightRef->light.point.linearAttenuation; },
+                            +[](Carrot::ECS::LightComponent& c, const float& v) { c.lightRef->light.point.linearAttenuation = v; c.lightRef->markDirty(); });
                         multiEditField(edition, "Quadratic attenuation", components,
-                            +[](Carrot::ECS::LightComponent& c) -> float& { return c.lightRef->light.point.quadraticAttenuation; });
+                            +[](Carrot::ECS::LightComponent& c) { return c.lightRef->light.point.quadraticAttenuation; },
+                            +[](Carrot::ECS::LightComponent& c, const float& v) { c.lightRef->light.point.quadraticAttenuation = v; c.lightRef->markDirty(); });
                     } break;
 
                     default: {
@@ -101,7 +105,7 @@ namespace Peeler {
 
         multiEditField(edition, "Light color", components,
             +[](Carrot::ECS::LightComponent& c) { return Helpers::RGBColorWrapper { .rgb = c.lightRef->light.color }; },
-            +[](Carrot::ECS::LightComponent& c, const Helpers::RGBColorWrapper& v) { c.lightRef->light.color = v.rgb; });
+            +[](Carrot::ECS::LightComponent& c, const Helpers::RGBColorWrapper& v) { c.lightRef->light.color = v.rgb; c.lightRef->markDirty(); });
     }
 
     static void editSpriteComponent(EditContext& edition, const Carrot::Vector<Carrot::ECS::SpriteComponent*>& components) {
@@ -53,25 +53,33 @@ namespace Peeler {
 
         Carrot::Render::Texture::Ref albedoRef = getTexture(albedo);
         if(edition.inspector.drawPickTextureWidget("Albedo##editModelComponent", &albedoRef)) {
-            modifyTextures()->albedo = materialSystem.createTextureHandle(albedoRef);
+            auto pMaterial = modifyTextures();
+            pMaterial->albedo = materialSystem.createTextureHandle(albedoRef);
+            pMaterial->markDirty();
             edition.hasModifications = true;
         }
 
         Carrot::Render::Texture::Ref normalMapRef = getTexture(normalMap);
         if(edition.inspector.drawPickTextureWidget("Normal map##editModelComponent", &normalMapRef)) {
-            modifyTextures()->normalMap = materialSystem.createTextureHandle(normalMapRef);
+            auto pMaterial = modifyTextures();
+            pMaterial->normalMap = materialSystem.createTextureHandle(normalMapRef);
+            pMaterial->markDirty();
             edition.hasModifications = true;
         }
 
         Carrot::Render::Texture::Ref metallicRoughnessRef = getTexture(metallicRoughness);
         if(edition.inspector.drawPickTextureWidget("Metallic Roughness##editModelComponent", &metallicRoughnessRef)) {
-            modifyTextures()->metallicRoughness = materialSystem.createTextureHandle(metallicRoughnessRef);
+            auto pMaterial = modifyTextures();
+            pMaterial->metallicRoughness = materialSystem.createTextureHandle(metallicRoughnessRef);
+            pMaterial->markDirty();
             edition.hasModifications = true;
         }
 
         Carrot::Render::Texture::Ref emissiveRef = getTexture(emissive);
         if(edition.inspector.drawPickTextureWidget("Emissive##editModelComponent", &emissiveRef)) {
-            modifyTextures()->emissive = materialSystem.createTextureHandle(emissiveRef);
+            auto pMaterial = modifyTextures();
+            pMaterial->emissive = materialSystem.createTextureHandle(emissiveRef);
+            pMaterial->markDirty();
             edition.hasModifications = true;
         }
 
@@ -55,6 +55,20 @@ namespace Carrot {
          * Can be costly on low-end machines
          */
         bool enableFileWatching = true;
+
+        /**
+         * File in which the Vulkan pipeline cache is persisted between runs (relative to the executable folder).
+         * Empty to keep the cache in memory only.
+         */
+        std::string pipelineCacheFile = "pipeline_cache.bin";
+
+        /**
+         * Max number of idle fibers kept for reuse by the task scheduler, for tasks with small and large stacks (see TaskScheduler::setPoolCapacity).
+         * The task scheduler logs a warning when a fiber is destroyed because its pool is full.
+         */
+        std::size_t smallStackFiberPoolCapacity = 1024;
+        std::size_t largeStackFiberPoolCapacity = 64;
+
         bool startInFullscreen = false;
 
     };
@@ -15,6 +15,7 @@
 #include <vector>
 #include <set>
 #include <core/async/OSThreads.h>
+#include <core/allocators/FrameArenaAllocator.h>
 #include "engine/constants.h"
 #include "engine/render/resources/Image.h"
 #include "engine/render/resources/SingleMesh.h"
@@ -120,6 +121,8 @@ renderer(vkDriver, config), screenQuad(std::make_unique<SingleMesh>(
     ZoneScoped;
     instance = this;
     changeTickRate(config.tickRate);
+    taskScheduler.setPoolCapacity(TaskStackSize::Small, config.smallStackFiberPoolCapacity);
+    taskScheduler.setPoolCapacity(TaskStackSize::Large, config.largeStackFiberPoolCapacity);
 
 #if USE_LIVEPP
     if (settings.useLivePP) {
@@ -371,22 +374,9 @@ void Carrot::Engine::run() {
 
         {
             ZoneScopedN("File watching");
-            Carrot::removeIf(fileWatchers, [](auto p) { return p.expired(); });
-
             if(config.enableFileWatching) {
-                Carrot::Async::Counter watchSync;
-                for(const auto& ref : fileWatchers) {
-                    if(auto ptr = ref.lock()) {
-                        taskScheduler.schedule(Carrot::TaskDescription {
-                                .name = "File watching",
-                                .task = [ptr](Carrot::TaskHandle& task) {
-                                    ptr->tick();
-                                },
-                                .joiner = &watchSync,
-                        }, Carrot::TaskScheduler::FrameParallelWork);
-                    }
-                }
-                watchSync.busyWait();
+                // file modifications are detected by the watcher service thread, only callbacks run here
+                IO::FileWatcherService::getInstance().dispatchEvents();
             }
         }
 
@@ -421,6 +411,7 @@ void Carrot::Engine::run() {
 
         {
             ZoneScopedN("Setup frame");
+            FrameArenaAllocator::get().newFrame();
             renderer.newFrame();
 
             {
@@ -1648,9 +1639,7 @@ Carrot::AssetServer& Carrot::Engine::getAssetServer() {
 }
 
 std::shared_ptr<Carrot::IO::FileWatcher> Carrot::Engine::createFileWatcher(const Carrot::IO::FileWatcher::Action& action, const std::vector<std::filesystem::path>& filesToWatch) {
-    auto watcher = std::make_shared<Carrot::IO::FileWatcher>(action, filesToWatch);
-    fileWatchers.emplace_back(watcher);
-    return watcher;
+    return std::make_shared<Carrot::IO::FileWatcher>(action, filesToWatch);
 }
 
 Carrot::TaskScheduler& Carrot::Engine::getTaskScheduler() {
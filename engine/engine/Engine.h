@@ -398,8 +398,8 @@ namespace Carrot {
     public:
         IO::VFS& getVFS() { return vfs; }
 
-        /// Creates a file watcher while will be automatically be updated inside the main loop (once per loop iteration)
-        ///  The engine object only holds a weak reference to the created file watcher.
+        /// Creates a file watcher whose action will be called inside the main loop when watched files are modified
+        ///  Files stop being watched once the returned file watcher is destroyed.
         std::shared_ptr<IO::FileWatcher> createFileWatcher(const IO::FileWatcher::Action& action, const std::vector<std::filesystem::path>& filesToWatch);
 
     private: // async private
@@ -438,7 +438,6 @@ namespace Carrot {
 
         VulkanDriver vkDriver;
         std::unique_ptr<ResourceAllocator> resourceAllocator;
-        std::vector<std::weak_ptr<IO::FileWatcher>> fileWatchers; //< renderer depends on it (because it loads a few default pipelines)
         AssetServer assetServer{ vfs }; // before the renderer: the renderer needs a few default assets for its initialisation
         VulkanRenderer renderer;
         std::uint32_t lastFrameIndex = 0;
@@ -0,0 +1,393 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "AssetDatabase.h"
+#include <core/io/IO.h>
+#include <core/io/Logging.hpp>
+#include <core/utils/CRC64.hpp>
+#include <rapidjson/document.h>
+#include <rapidjson/filewritestream.h>
+#include <rapidjson/writer.h>
+#include <fstream>
+
+namespace Carrot {
+    namespace fs = std::filesystem;
+
+    static Carrot::Log::Category category { "AssetDatabase" };
+
+    /// Increase when the layout of the database file changes. Databases with another version are discarded.
+    constexpr std::uint32_t DatabaseFormatVersion = 1;
+
+    /// Checks the shape of a database file before reading it, because rapidjson asserts on type mismatches.
+    /// Does not check the version
+    static bool hasValidLayout(const rapidjson::Document& document) {
+        if(!document.HasMember("files") || !document["files"].IsObject()
+        || !document.HasMember("assets") || !document["assets"].IsObject()) {
+            return false;
+        }
+
+        for(const auto& [path, state] : document["files"].GetObject()) {
+            if(!state.IsObject()
+            || !state.HasMember("size") || !state["size"].IsUint64()
+            || !state.HasMember("timestamp") || !state["timestamp"].IsInt64()
+            || !state.HasMember("hash") || !state["hash"].IsUint64()) {
+                return false;
+            }
+        }
+
+        for(const auto& [source, recordJSON] : document["assets"].GetObject()) {
+            if(!recordJSON.IsObject()
+            || !recordJSON.HasMember("output") || !recordJSON["output"].IsString()
+            || !recordJSON.HasMember("hash") || !recordJSON["hash"].IsUint64()
+            || !recordJSON.HasMember("converter_version") || !recordJSON["converter_version"].IsUint()
+            || (recordJSON.HasMember("invalidated") && !recordJSON["invalidated"].IsBool())
+            || !recordJSON.HasMember("dependencies") || !recordJSON["dependencies"].IsObject()) {
+                return false;
+            }
+            for(const auto& [dependency, hash] : recordJSON["dependencies"].GetObject()) {
+                if(!hash.IsUint64()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    AssetDatabase::AssetDatabase(fs::path databaseFile): databaseFile(std::move(databaseFile)) {}
+
+    void AssetDatabase::load() {
+        std::lock_guard l { access };
+        std::lock_guard fl { fileStatesAccess };
+        records.clear();
+        dependents.clear();
+        fileStates.clear();
+        dirty = false;
+
+        if(!fs::exists(databaseFile)) {
+            return;
+        }
+
+        rapidjson::Document document;
+        const std::string text = Carrot::IO::readFileAsText(databaseFile.string());
+        document.Parse(text.c_str(), text.size());
+        if(document.HasParseError() || !document.IsObject()) {
+            Carrot::Log::warn(category, "Asset database %s is invalid, starting from scratch.", databaseFile.string().c_str());
+            return;
+        }
+        if(!document.HasMember("version") || !document["version"].IsUint() || document["version"].GetUint() != DatabaseFormatVersion) {
+            Carrot::Log::info(category, "Asset database %s has a different version, starting from scratch.", databaseFile.string().c_str());
+            return;
+        }
+        if(!hasValidLayout(document)) {
+            Carrot::Log::warn(category, "Asset database %s is truncated or corrupted, starting from scratch.", databaseFile.string().c_str());
+            return;
+        }
+
+        for(const auto& [path, state] : document["files"].GetObject()) {
+            fileStates[path.GetString()] = FileState {
+                .size = state["size"].GetUint64(),
+                .timestamp = state["timestamp"].GetInt64(),
+                .hash = state["hash"].GetUint64(),
+            };
+        }
+
+        for(const auto& [source, recordJSON] : document["assets"].GetObject()) {
+            const fs::path sourcePath = source.GetString();
+            AssetRecord& record = records[sourcePath];
+            record.output = recordJSON["output"].GetString();
+            record.sourceHash = recordJSON["hash"].GetUint64();
+            record.converterVersion = recordJSON["converter_version"].GetUint();
+            record.invalidated = recordJSON.HasMember("invalidated") && recordJSON["invalidated"].GetBool();
+            for(const auto& [dependency, hash] : recordJSON["dependencies"].GetObject()) {
+                const fs::path dependencyPath = dependency.GetString();
+                record.dependencies[dependencyPath] = hash.GetUint64();
+                dependents[dependencyPath].insert(sourcePath);
+            }
+        }
+    }
+
+    void AssetDatabase::save() {
+        std::lock_guard l { access };
+        if(!dirty) {
+            return;
+        }
+
+        rapidjson::Document document;
+        document.SetObject();
+        auto& allocator = document.GetAllocator();
+        document.AddMember("version", DatabaseFormatVersion, allocator);
+
+        rapidjson::Value files(rapidjson::kObjectType);
+        {
+            std::lock_guard fl { fileStatesAccess };
+            for(const auto& [path, state] : fileStates) {
+                rapidjson::Value stateJSON(rapidjson::kObjectType);
+                stateJSON.AddMember("size", state.size, allocator);
+                stateJSON.AddMember("timestamp", state.timestamp, allocator);
+                stateJSON.AddMember("hash", state.hash, allocator);
+                files.AddMember(rapidjson::Value(path.generic_string().c_str(), allocator), stateJSON, allocator);
+            }
+        }
+        document.AddMember("files", files, allocator);
+
+        rapidjson::Value assets(rapidjson::kObjectType);
+        for(const auto& [source, record] : records) {
+            rapidjson::Value recordJSON(rapidjson::kObjectType);
+            recordJSON.AddMember("output", rapidjson::Value(record.output.generic_string().c_str(), allocator), allocator);
+            recordJSON.AddMember("hash", record.sourceHash, allocator);
+            recordJSON.AddMember("converter_version", record.converterVersion, allocator);
+            if(record.invalidated) {
+                recordJSON.AddMember("invalidated", true, allocator);
+            }
+
+            rapidjson::Value dependencies(rapidjson::kObjectType);
+            for(const auto& [dependency, hash] : record.dependencies) {
+                dependencies.AddMember(rapidjson::Value(dependency.generic_string().c_str(), allocator), rapidjson::Value(hash), allocator);
+            }
+            recordJSON.AddMember("dependencies", dependencies, allocator);
+            assets.AddMember(rapidjson::Value(source.generic_string().c_str(), allocator), recordJSON, allocator);
+        }
+        document.AddMember("assets", assets, allocator);
+
+        // write to a temporary file first, to never leave a partially written database if the engine crashes
+        fs::path tmpFile = databaseFile;
+        tmpFile += ".tmp";
+        FILE* fp = fopen(tmpFile.string().c_str(), "wb");
+        if(fp == nullptr) {
+            Carrot::Log::error(category, "Could not write asset database to %s", tmpFile.string().c_str());
+            return;
+        }
+        char writeBuffer[65536];
+        rapidjson::FileWriteStream os(fp, writeBuffer, sizeof(writeBuffer));
+        rapidjson::Writer<rapidjson::FileWriteStream> writer(os);
+        document.Accept(writer);
+        fclose(fp);
+
+        std::error_code ec;
+        fs::rename(tmpFile, databaseFile, ec);
+        if(ec) {
+            Carrot::Log::error(category, "Could not replace asset database %s: %s", databaseFile.string().c_str(), ec.message().c_str());
+            return;
+        }
+        dirty = false;
+    }
+
+    bool AssetDatabase::computeContentHash(const fs::path& file, std::uint64_t& outHash) {
+        std::error_code ec;
+        const std::uint64_t size = fs::file_size(file, ec);
+        if(ec) {
+            return false;
+        }
+        const std::int64_t timestamp = fs::last_write_time(file, ec).time_since_epoch().count();
+        if(ec) {
+            return false;
+        }
+
+        {
+            std::lock_guard l { fileStatesAccess };
+            auto it = fileStates.find(file);
+            if(it != fileStates.end() && it->second.size == size && it->second.timestamp == timestamp) {
+                outHash = it->second.hash;
+                return true;
+            }
+        }
+
+        // file is new or was touched: read it again, without holding the lock
+        std::ifstream input(file, std::ios::binary);
+        if(!input) {
+            return false;
+        }
+        std::uint64_t hash = 0;
+        std::vector<char> buffer(1024 * 1024);
+        while(input) {
+            input.read(buffer.data(), buffer.size());
+            hash = Carrot::CRC64Continue(hash, buffer.data(), input.gcount());
+        }
+
+        {
+            std::lock_guard l { fileStatesAccess };
+            fileStates[file] = FileState {
+                .size = size,
+                .timestamp = timestamp,
+                .hash = hash,
+            };
+        }
+        dirty = true;
+        outHash = hash;
+        return true;
+    }
+
+    bool AssetDatabase::isUpToDate(const fs::path& source, const fs::path& output, std::uint32_t converterVersion) {
+        // list the files to check while holding the lock, then hash them without it
+        std::vector<std::pair<fs::path, std::uint64_t>> filesToCheck;
+        {
+            std::lock_guard l { access };
+            auto recordIt = records.find(source);
+            if(recordIt == records.end()) {
+                return false;
+            }
+            if(recordIt->second.invalidated || recordIt->second.output != output || recordIt->second.converterVersion != converterVersion) {
+                return false;
+            }
+
+            std::unordered_set<fs::path> visited;
+            if(!collectFilesToCheck(source, visited, filesToCheck)) {
+                return false;
+            }
+        }
+
+        for(const auto& [file, expectedHash] : filesToCheck) {
+            std::uint64_t hash;
+            if(!computeContentHash(file, hash) || hash != expectedHash) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AssetDatabase::collectFilesToCheck(const fs::path& source, std::unordered_set<fs::path>& visited, std::vector<std::pair<fs::path, std::uint64_t>>& filesToCheck) {
+        if(!visited.insert(source).second) {
+            return true;
+        }
+
+        auto recordIt = records.find(source);
+        if(recordIt == records.end() || recordIt->second.invalidated) {
+            return false;
+        }
+        const AssetRecord& record = recordIt->second;
+        if(!fs::exists(record.output)) {
+            return false;
+        }
+
+        filesToCheck.emplace_back(source, record.sourceHash);
+        for(const auto& [dependency, hash] : record.dependencies) {
+            filesToCheck.emplace_back(dependency, hash);
+
+            // dependencies which are converted assets themselves must be up-to-date too
+            if(records.contains(dependency) && !collectFilesToCheck(dependency, visited, filesToCheck)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AssetDatabase::canAdoptExistingOutput(const fs::path& source) {
+        std::lock_guard l { access };
+        // records are never erased, only invalidated, so this also covers the records loaded from disk
+        return !records.contains(source);
+    }
+
+    void AssetDatabase::recordConversion(const fs::path& source, const fs::path& output, std::uint32_t converterVersion, const std::vector<fs::path>& dependencies) {
+        AssetRecord record;
+        record.output = output;
+        record.converterVersion = converterVersion;
+        if(!computeContentHash(source, record.sourceHash)) {
+            return;
+        }
+        for(const auto& dependency : dependencies) {
+            std::uint64_t hash = 0;
+            if(!computeContentHash(dependency, hash)) {
+                Carrot::Log::warn(category, "Dependency %s of %s does not exist", dependency.string().c_str(), source.string().c_str());
+            }
+            record.dependencies[dependency] = hash;
+        }
+
+        std::lock_guard l { access };
+        // the output of 'source' changed, so assets using it must be converted again
+        std::unordered_set<fs::path> visited { source };
+        for(const auto& dependent : std::unordered_set<fs::path>(dependents[source])) {
+            invalidateRecursive(dependent, visited);
+        }
+
+        removeRecord(source);
+        for(const auto& [dependency, hash] : record.dependencies) {
+            dependents[dependency].insert(source);
+        }
+        records[source] = std::move(record);
+        dirty = true;
+    }
+
+    void AssetDatabase::invalidate(const fs::path& source) {
+        std::lock_guard l { access };
+        if(!records.contains(source)) {
+            // never converted successfully: keep a tombstone so that its output is not adopted later
+            records[source].invalidated = true;
+            dirty = true;
+        }
+        std::unordered_set<fs::path> visited;
+        invalidateRecursive(source, visited);
+    }
+
+    void AssetDatabase::invalidateRecursive(const fs::path& source, std::unordered_set<fs::path>& visited) {
+        if(!visited.insert(source).second) {
+            return;
+        }
+
+        auto dependentsIt = dependents.find(source);
+        if(dependentsIt != dependents.end()) {
+            // copy: removeRecord modifies 'dependents'
+            const std::unordered_set<fs::path> toInvalidate = dependentsIt->second;
+            for(const auto& dependent : toInvalidate) {
+                invalidateRecursive(dependent, visited);
+            }
+        }
+        auto recordIt = records.find(source);
+        if(recordIt != records.end() && !recordIt->second.invalidated) {
+            recordIt->second.invalidated = true;
+            dirty = true;
+        }
+    }
+
+    void AssetDatabase::removeRecord(const fs::path& source) {
+        auto recordIt = records.find(source);
+        if(recordIt == records.end()) {
+            return;
+        }
+        for(const auto& [dependency, hash] : recordIt->second.dependencies) {
+            auto dependentsIt = dependents.find(dependency);
+            if(dependentsIt != dependents.end()) {
+                dependentsIt->second.erase(source);
+                if(dependentsIt->second.empty()) {
+                    dependents.erase(dependentsIt);
+                }
+            }
+        }
+        records.erase(recordIt);
+    }
+
+    std::vector<fs::path> AssetDatabase::getDependents(const fs::path& file) {
+        std::lock_guard l { access };
+        std::vector<fs::path> result;
+        std::unordered_set<fs::path> visited { file };
+        std::vector<fs::path> toVisit { file };
+        while(!toVisit.empty()) {
+            const fs::path current = std::move(toVisit.back());
+            toVisit.pop_back();
+
+            auto dependentsIt = dependents.find(current);
+            if(dependentsIt == dependents.end()) {
+                continue;
+            }
+            for(const auto& dependent : dependentsIt->second) {
+                if(visited.insert(dependent).second) {
+                    result.push_back(dependent);
+                    toVisit.push_back(dependent);
+                }
+            }
+        }
+        return result;
+    }
+
+    void AssetDatabase::dump() {
+        std::lock_guard l { access };
+        Carrot::Log::info(category, "Asset database %s: %llu converted assets", databaseFile.string().c_str(), static_cast<std::uint64_t>(records.size()));
+        for(const auto& [source, record] : records) {
+            Carrot::Log::info(category, "- %s -> %s (converter v%u, hash %llx)%s", source.string().c_str(), record.output.string().c_str(), record.converterVersion, record.sourceHash, record.invalidated ? " [invalidated]" : "");
+            for(const auto& [dependency, hash] : record.dependencies) {
+                Carrot::Log::info(category, "    depends on %s (hash %llx)", dependency.string().c_str(), hash);
+            }
+        }
+    }
+
+} // Carrot
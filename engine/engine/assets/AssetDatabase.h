@@ -0,0 +1,104 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <core/data/Hashes.h>
+
+namespace Carrot {
+
+    /**
+     * Persistent record of the conversions done by the AssetServer, stored inside the asset_server folder.
+     * For each converted asset, stores the content hash of its source, the version of the converter used, and the content
+     * hashes of the files it depends on (eg. buffers and textures of a glTF file).
+     *
+     * An asset is up-to-date if none of these changed, and if all its dependencies which are converted assets themselves
+     * are up-to-date. Content hashes are cached with the size and timestamp of the file, so files are only read again
+     * when they are touched.
+     *
+     * Thread-safe.
+     */
+    class AssetDatabase {
+    public:
+        explicit AssetDatabase(std::filesystem::path databaseFile);
+
+        /// Loads the database from disk. Missing or invalid files result in an empty database
+        void load();
+
+        /// Writes the database to disk if it changed since the last save
+        void save();
+
+        /// Is the conversion of 'source' into 'output' up-to-date?
+        bool isUpToDate(const std::filesystem::path& source, const std::filesystem::path& output, std::uint32_t converterVersion);
+
+        /**
+         * Can the existing output of 'source' be trusted based on its timestamp alone?
+         * Only true for assets this database never heard of (converted before the database existed): invalidated
+         * conversions keep a record, so that they are always converted again.
+         */
+        bool canAdoptExistingOutput(const std::filesystem::path& source);
+
+        /// Records a successful conversion of 'source' to 'output'. Assets which depend on 'source' are invalidated.
+        void recordConversion(const std::filesystem::path& source, const std::filesystem::path& output, std::uint32_t converterVersion, const std::vector<std::filesystem::path>& dependencies);
+
+        /// Marks the conversion of 'source', and of all assets which depend on it (directly or not), as out-of-date
+        void invalidate(const std::filesystem::path& source);
+
+        /// Assets which depend on 'file', directly or not
+        std::vector<std::filesystem::path> getDependents(const std::filesystem::path& file);
+
+        /// Writes the content of the database to the log
+        void dump();
+
+    private:
+        /// Content hash of a file, with the information used to know whether it needs to be computed again
+        struct FileState {
+            std::uint64_t size = 0;
+            std::int64_t timestamp = 0;
+            std::uint64_t hash = 0;
+        };
+
+        struct AssetRecord {
+            std::filesystem::path output;
+            std::uint64_t sourceHash = 0;
+            std::uint32_t converterVersion = 0;
+            std::unordered_map<std::filesystem::path, std::uint64_t> dependencies; // path -> hash at conversion time
+
+            /// Tombstone: the asset was converted once, but must be converted again. Dependencies are kept to be able
+            /// to invalidate dependents of dependents
+            bool invalidated = false;
+        };
+
+        /// Returns false if the file does not exist. Rehashes only if the size or timestamp changed
+        bool computeContentHash(const std::filesystem::path& file, std::uint64_t& outHash);
+
+        /// Lists the files (with their expected hash) to check to know if 'source' is up-to-date, including the files of
+        /// converted dependencies. Returns false if 'source' is known to be out-of-date already.
+        /// Must be called with 'access' locked
+        bool collectFilesToCheck(const std::filesystem::path& source, std::unordered_set<std::filesystem::path>& visited, std::vector<std::pair<std::filesystem::path, std::uint64_t>>& filesToCheck);
+
+        /// Must be called with 'access' locked
+        void invalidateRecursive(const std::filesystem::path& source, std::unordered_set<std::filesystem::path>& visited);
+        void removeRecord(const std::filesystem::path& source);
+
+    private:
+        std::filesystem::path databaseFile;
+        std::atomic<bool> dirty = false;
+
+        std::mutex fileStatesAccess;
+        std::unordered_map<std::filesystem::path, FileState> fileStates;
+
+        std::mutex access;
+        std::unordered_map<std::filesystem::path, AssetRecord> records; // source -> record
+        std::unordered_map<std::filesystem::path, std::unordered_set<std::filesystem::path>> dependents; // file -> assets which depend on it
+    };
+
+} // Carrot
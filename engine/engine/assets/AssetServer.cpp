@@ -38,9 +38,14 @@ namespace Carrot {
             std::filesystem::create_directories(vfsRoot);
         }
         GetVFS().addRoot("asset_server", vfsRoot);
+
+        assetDatabase = std::make_unique<AssetDatabase>(vfsRoot / "asset_database.json");
+        indexAssets();
     }
 
-    AssetServer::~AssetServer() {}
+    AssetServer::~AssetServer() {
+        assetDatabase->save();
+    }
 
     void AssetServer::freeupResources() {
         pipelines.clear();
@@ -50,7 +55,13 @@ namespace Carrot {
     }
 
     void AssetServer::tick(double deltaTime) {
-        // TODO
+        // Saving is not free, do not do it every time an asset is converted
+        constexpr double DatabaseSaveInterval = 5.0;
+        timeSinceDatabaseSave += deltaTime;
+        if(timeSinceDatabaseSave >= DatabaseSaveInterval) {
+            timeSinceDatabaseSave = 0.0;
+            assetDatabase->save();
+        }
     }
 
     void AssetServer::beginFrame(const Carrot::Render::Context& renderContext) {
@@ -72,7 +83,7 @@ namespace Carrot {
         Carrot::IO::Resource from;
         const std::string modelPath = path.toString();
         try {
-            fs::path convertedPath = convert(path);
+            fs::path convertedPath = convert(path, &task);
             if(convertedPath.empty()) {
                 from = modelPath; // probably won't work, but at least the error message will be readable
             } else {
@@ -87,6 +98,9 @@ namespace Carrot {
             // in case file could not be opened
             from = "resources/models/simple_cube.obj";
         }
+
+        loadingCount++;
+        CLEANUP(loadingCount--);
         return Carrot::Model::load(task, GetEngine(), std::move(from));
     }
 
@@ -135,8 +149,6 @@ namespace Carrot {
         const std::string textureName = path.toString();
         ZoneText(textureName.c_str(), textureName.size());
         return textures.getOrCompute(textureName, [&]() {
-            loadingCount++;
-            CLEANUP(loadingCount--);
             Carrot::IO::Resource from;
             try {
                 fs::path convertedPath = convert(path);
@@ -155,6 +167,8 @@ namespace Carrot {
                 from = "resources/textures/default.png";
             }
 
+            loadingCount++;
+            CLEANUP(loadingCount--);
             return std::make_shared<Carrot::Render::Texture>(GetVulkanDriver(), std::move(from));
         });
     }
@@ -226,11 +240,12 @@ namespace Carrot {
     }
 
     void AssetServer::indexAssets() {
-        // TODO
+        Carrot::Profiling::PrintingScopedTimer timer{ "Loading asset database" };
+        assetDatabase->load();
     }
 
     void AssetServer::dumpAssetReferences() {
-        // TODO
+        assetDatabase->dump();
     }
 
     fs::path AssetServer::getConvertedPath(const Carrot::IO::VFS::Path& path) {
@@ -248,20 +263,237 @@ namespace Carrot {
         return convertedPath;
     }
 
-    fs::path AssetServer::convert(const Carrot::IO::VFS::Path& path) {
+    void AssetServer::prefetch(const Carrot::IO::VFS::Path& path, std::int64_t priority) {
+        if(getConvertedPath(path).empty()) {
+            return; // nothing to convert
+        }
+
+        getOrCreateConversionJob(path, priority, true);
+    }
+
+    void AssetServer::prefetchScene(const rapidjson::Value& sceneJSON) {
+        // Scenes do not have a list of their assets: look for all strings which look like paths to convertible assets
+        std::unordered_map<std::string, std::int64_t> referenceCounts;
+        std::vector<std::string> referencedPaths; // in order of appearance, to keep the conversion order deterministic
+        std::vector<const rapidjson::Value*> toVisit { &sceneJSON };
+        while(!toVisit.empty()) {
+            const rapidjson::Value& value = *toVisit.back();
+            toVisit.pop_back();
+
+            if(value.IsObject()) {
+                for(auto it = value.MemberEnd(); it != value.MemberBegin();) {
+                    --it;
+                    toVisit.push_back(&it->value);
+                }
+            } else if(value.IsArray()) {
+                for(auto it = value.End(); it != value.Begin();) {
+                    --it;
+                    toVisit.push_back(it);
+                }
+            } else if(value.IsString()) {
+                std::string str { value.GetString(), value.GetStringLength() };
+                if(!Fertilizer::isSupportedFormat(fs::path { str })) {
+                    continue;
+                }
+                if(referenceCounts[str]++ == 0) {
+                    referencedPaths.emplace_back(std::move(str));
+                }
+            }
+        }
+
+        std::vector<std::int64_t> pathReferenceCounts;
+        pathReferenceCounts.reserve(referencedPaths.size());
+        for(const auto& pathStr : referencedPaths) {
+            pathReferenceCounts.push_back(referenceCounts[pathStr]);
+        }
+        prefetchStrings(referencedPaths, pathReferenceCounts);
+    }
+
+    void AssetServer::prefetchStrings(std::span<const std::string> strings, std::span<const std::int64_t> referenceCounts) {
+        verify(strings.size() == referenceCounts.size(), "Mismatched sizes");
+        for(std::size_t i = 0; i < strings.size(); i++) {
+            const std::string& pathStr = strings[i];
+            if(!Fertilizer::isSupportedFormat(fs::path { pathStr })) {
+                continue;
+            }
+            try {
+                const Carrot::IO::VFS::Path path { pathStr };
+                if(vfs.exists(path)) {
+                    prefetch(path, referenceCounts[i]);
+                }
+            } catch(std::exception& e) {
+                // not a path after all
+            }
+        }
+    }
+
+    std::int64_t AssetServer::getCurrentlyLoadingCount() const {
+        return queuedConversionCount + convertingCount + loadingCount;
+    }
+
+    std::int64_t AssetServer::getCurrentlyLoadingCount(LoadingStage stage) const {
+        switch(stage) {
+            case LoadingStage::QueuedForConversion:
+                return queuedConversionCount;
+            case LoadingStage::Converting:
+                return convertingCount;
+            case LoadingStage::Loading:
+                return loadingCount;
+        }
+        verify(false, "Unknown loading stage");
+        return 0;
+    }
+
+    /// Ordering of the conversion queue. std heaps put the largest element on top
+    static auto compareConversionJobs = [](const auto& a, const auto& b) {
+        if(a->priority != b->priority) {
+            return a->priority < b->priority;
+        }
+        return a->order > b->order;
+    };
+
+    std::shared_ptr<AssetServer::ConversionJob> AssetServer::getOrCreateConversionJob(const Carrot::IO::VFS::Path& path, std::int64_t priority, bool enqueue) {
+        const std::string key = path.toString();
+        auto job = std::make_shared<ConversionJob>();
+        {
+            std::lock_guard l { conversionJobsAccess };
+            auto it = conversionJobs.find(key);
+            if(it != conversionJobs.end()) {
+                return it->second;
+            }
+
+            job->path = path;
+            job->priority = priority;
+            job->order = nextConversionOrder++;
+            job->queued = enqueue;
+            job->done.increment();
+            conversionJobs[key] = job;
+
+            if(enqueue) {
+                conversionQueue.push_back(job);
+                std::push_heap(conversionQueue.begin(), conversionQueue.end(), compareConversionJobs);
+                queuedConversionCount++;
+            }
+        }
+
+        if(enqueue) {
+            // the task does not necessarily convert this job: it takes the most important one when it starts
+            GetTaskScheduler().schedule(TaskDescription {
+                .name = "Asset pre-conversion",
+                .task = [this](TaskHandle& task) {
+                    runNextQueuedConversion(task);
+                },
+                .priority = TaskPriority::Background,
+            }, TaskScheduler::AssetLoading);
+        }
+        return job;
+    }
+
+    void AssetServer::runNextQueuedConversion(TaskHandle& task) {
+        std::shared_ptr<ConversionJob> job;
+        {
+            std::lock_guard l { conversionJobsAccess };
+            while(!conversionQueue.empty() && !job) {
+                std::pop_heap(conversionQueue.begin(), conversionQueue.end(), compareConversionJobs);
+                job = std::move(conversionQueue.back());
+                conversionQueue.pop_back();
+                if(job->started) {
+                    job = nullptr; // already converted by a load which needed it
+                }
+            }
+        }
+
+        if(!job) {
+            return;
+        }
+
+        bool expected = false;
+        if(!job->started.compare_exchange_strong(expected, true)) {
+            return;
+        }
+        executeConversion(*job);
+        if(job->error) {
+            return; // reported when the asset is actually loaded
+        }
+
+        // start loading, so that reading the converted asset overlaps with the conversion of the next ones
+        const fs::path sourceExtension = fs::path { job->path.toString() }.extension();
+        if(job->result.extension() == ".gltf") {
+            loadModel(task, job->path);
+        } else if(job->result.extension() == ".ktx2" && sourceExtension != ".hdr") { // environment maps are not loaded as regular textures
+            loadTexture(task, job->path);
+        }
+    }
+
+    void AssetServer::executeConversion(ConversionJob& job) {
+        if(job.queued) {
+            queuedConversionCount--;
+        }
+        convertingCount++;
+        try {
+            job.result = convertNow(job.path);
+        } catch(...) {
+            job.error = std::current_exception();
+        }
+        convertingCount--;
+
+        {
+            std::lock_guard l { conversionJobsAccess };
+            conversionJobs.erase(job.path.toString());
+        }
+        job.done.decrement();
+    }
+
+    fs::path AssetServer::convert(const Carrot::IO::VFS::Path& path, TaskHandle* pTask) {
+        if(getConvertedPath(path).empty()) {
+            return {};
+        }
+
+        std::shared_ptr<ConversionJob> job = getOrCreateConversionJob(path, 0, false);
+        bool expected = false;
+        if(job->started.compare_exchange_strong(expected, true)) {
+            // not started yet (even if queued): this load needs it now, so convert it on this thread
+            executeConversion(*job);
+        } else if(pTask) {
+            job->done.wait(*pTask);
+        } else {
+            job->done.busyWait();
+        }
+
+        if(job->error) {
+            std::rethrow_exception(job->error);
+        }
+        return job->result;
+    }
+
+    fs::path AssetServer::convertNow(const Carrot::IO::VFS::Path& path) {
         fs::path convertedPath = getConvertedPath(path);
         if(convertedPath.empty()) {
             return {};
         }
 
-        Carrot::Profiling::PrintingScopedTimer convertTimer{ Carrot::sprintf("Converting %s", path.toString().c_str()) };
         const fs::path diskPath = GetVFS().resolve(path);
-        Fertilizer::ConversionResult result = Fertilizer::convert(diskPath, convertedPath, false);
+        const std::uint32_t converterVersion = Fertilizer::getConverterVersion(diskPath);
+        if(assetDatabase->isUpToDate(diskPath, convertedPath, converterVersion)) {
+            return convertedPath;
+        }
+
+        const std::vector<fs::path> dependencies = Fertilizer::getDependencies(diskPath);
+        if(assetDatabase->canAdoptExistingOutput(diskPath) && !Fertilizer::requiresModifications(diskPath, convertedPath)) {
+            // converted before the asset database existed: trust the timestamps once instead of converting again
+            assetDatabase->recordConversion(diskPath, convertedPath, converterVersion, dependencies);
+            return convertedPath;
+        }
+
+        Carrot::Profiling::PrintingScopedTimer convertTimer{ Carrot::sprintf("Converting %s", path.toString().c_str()) };
+        Fertilizer::ConversionResult result = Fertilizer::convert(diskPath, convertedPath, true);
 
         if(result.errorCode != Fertilizer::ConversionResultError::Success) {
+            assetDatabase->invalidate(diskPath);
             throw AssetConversionException(path, result.errorMessage);
         }
 
+        assetDatabase->recordConversion(diskPath, convertedPath, converterVersion, dependencies);
         return convertedPath;
     }
 
@@ -10,6 +10,10 @@
 #include <engine/ecs/EntityTypes.h>
 #include <engine/task/TaskScheduler.h>
 #include <engine/render/animation/AnimatedModel.h>
+#include <engine/assets/AssetDatabase.h>
+#include <rapidjson/document.h>
+#include <mutex>
+#include <span>
 
 namespace Carrot {
     struct Model;
@@ -65,21 +69,80 @@ namespace Carrot {
         LoadTaskProc<Carrot::Render::AnimatedModel::Handle> loadAnimatedModelInstanceTask(const Carrot::IO::VFS::Path& path);
         std::shared_ptr<Carrot::Render::AnimatedModel::Handle> loadAnimatedModelInstance(Carrot::TaskHandle& currentTask, const Carrot::IO::VFS::Path& path);
 
+    public: // prefetching
+        /**
+         * Converts the given asset in the background (on the AssetLoading lane), then starts loading it.
+         * Assets with a higher priority are converted first. Does nothing if the asset is already being converted.
+         */
+        void prefetch(const Carrot::IO::VFS::Path& path, std::int64_t priority = 0);
+
+        /**
+         * Prefetches all assets referenced by the given scene (in its JSON form).
+         * Assets referenced more often are converted first.
+         */
+        void prefetchScene(const rapidjson::Value& sceneJSON);
+
+        /**
+         * Prefetches the assets referenced by the given strings, for instance the string table of a binary scene.
+         * Strings which are not paths to convertible assets are ignored. 'referenceCounts[i]' is used as the priority of 'strings[i]'
+         */
+        void prefetchStrings(std::span<const std::string> strings, std::span<const std::int64_t> referenceCounts);
+
     public:
+        enum class LoadingStage {
+            QueuedForConversion, //< waiting for a thread to convert it
+            Converting,
+            Loading, //< converted (or did not need conversion), being read and uploaded
+        };
+
+        /// Count of assets in any stage of loading
         std::int64_t getCurrentlyLoadingCount() const;
 
+        /// Count of assets in the given stage of loading
+        std::int64_t getCurrentlyLoadingCount(LoadingStage stage) const;
+
     private:
+        /// Conversion of a single asset, shared between the background queue and the loads which need its result
+        struct ConversionJob {
+            Carrot::IO::VFS::Path path;
+            std::int64_t priority = 0;
+            std::uint64_t order = 0; // first come, first served for assets with the same priority
+            bool queued = false; // inside the background queue?
+            std::atomic<bool> started = false;
+            Async::Counter done;
+            std::filesystem::path result;
+            std::exception_ptr error;
+        };
+
         void indexAssets();
         void dumpAssetReferences();
 
         std::shared_ptr<Model> asyncLoadModel(TaskHandle& task, const Carrot::IO::VFS::Path& path);
         std::filesystem::path getConvertedPath(const Carrot::IO::VFS::Path& path); // find the path inside asset_server folder for the converted asset
-        std::filesystem::path convert(const Carrot::IO::VFS::Path& path); // performs conversion
+
+        /// Performs conversion, or waits for the background conversion of the asset if it was already started.
+        /// If 'pTask' is not null, waiting yields the task instead of blocking the thread
+        std::filesystem::path convert(const Carrot::IO::VFS::Path& path, TaskHandle* pTask = nullptr);
+        std::filesystem::path convertNow(const Carrot::IO::VFS::Path& path); // performs conversion on the current thread
+
+        /// Returns the conversion job for the given asset, creating it if none is in progress. New jobs are added to the background queue if 'enqueue' is true
+        std::shared_ptr<ConversionJob> getOrCreateConversionJob(const Carrot::IO::VFS::Path& path, std::int64_t priority, bool enqueue);
+        void executeConversion(ConversionJob& job);
+        void runNextQueuedConversion(TaskHandle& task);
 
     private:
         IO::VirtualFileSystem& vfs;
         std::filesystem::path vfsRoot;
+        std::unique_ptr<AssetDatabase> assetDatabase; // created once vfsRoot is known
+        double timeSinceDatabaseSave = 0.0;
         std::atomic_int64_t loadingCount{0};
+        std::atomic_int64_t queuedConversionCount{0};
+        std::atomic_int64_t convertingCount{0};
+
+        std::mutex conversionJobsAccess;
+        std::vector<std::shared_ptr<ConversionJob>> conversionQueue; // heap, highest priority on top
+        std::unordered_map<std::string, std::shared_ptr<ConversionJob>> conversionJobs; // jobs in progress, by asset path
+        std::uint64_t nextConversionOrder = 0;
 
         Async::ParallelMap<std::pair<std::string, std::uint64_t>, std::shared_ptr<Pipeline>> pipelines{};
         Async::ParallelMap<std::string, std::shared_ptr<Render::Texture>> textures{};
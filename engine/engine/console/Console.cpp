@@ -80,46 +80,44 @@ namespace Carrot {
                     ImGui::TableSetupColumn("Location");
                     ImGui::TableHeadersRow();
 
-                    ImGuiListClipper clipper;
-                    clipper.Begin(100);
-                    const auto& messageList = Carrot::Log::getMessages();
-
-                    while(clipper.Step()) {
-                        auto messageIterator = messageList.begin();
-                        for (int index = 0; index < clipper.DisplayStart; index++) {
-                            messageIterator++;
-                        }
-
-                        for (int index = clipper.DisplayStart; index < clipper.DisplayEnd && messageIterator != messageList.end(); index++) {
-                            const auto& message = *messageIterator;
-                            messageIterator++;
-                            ImGui::TableNextRow();
-                            ImGui::TableNextColumn();
-                            ImColor color = ImColor(1.0f, 1.0f, 1.0f, 1.0f);
-                            switch(message.severity) {
-                                case Log::Severity::Warning:
-                                    color = ImColor(1.0f, 1.0f, 0.0f, 1.0f);
-                                    break;
-                                case Log::Severity::Error:
-                                    color = ImColor(1.0f, 0.0f, 0.0f, 1.0f);
-                                    break;
-                                case Log::Severity::Debug:
-                                    color = ImColor(0.25f, 0.75f, 0.0f, 1.0f);
-                                    break;
+                    Carrot::Log::visitMessageHistory([&](const Carrot::Log::MessageHistory& history) {
+                        // oldest message first
+                        const std::int64_t messageCount = history.getCount();
+                        const std::int64_t firstMessage = history.getCurrentPosition() - messageCount;
+
+                        ImGuiListClipper clipper;
+                        clipper.Begin(static_cast<int>(messageCount));
+                        while(clipper.Step()) {
+                            for (int index = clipper.DisplayStart; index < clipper.DisplayEnd; index++) {
+                                const auto& message = history[firstMessage + index];
+                                ImGui::TableNextRow();
+                                ImGui::TableNextColumn();
+                                ImColor color = ImColor(1.0f, 1.0f, 1.0f, 1.0f);
+                                switch(message.severity) {
+                                    case Log::Severity::Warning:
+                                        color = ImColor(1.0f, 1.0f, 0.0f, 1.0f);
+                                        break;
+                                    case Log::Severity::Error:
+                                        color = ImColor(1.0f, 0.0f, 0.0f, 1.0f);
+                                        break;
+                                    case Log::Severity::Debug:
+                                        color = ImColor(0.25f, 0.75f, 0.0f, 1.0f);
+                                        break;
+                                }
+                                ImGui::PushStyleColor(ImGuiCol_::ImGuiCol_Text, color.Value);
+                                ImGui::Text("%s", Carrot::Log::getSeverityString(message.severity));
+                                ImGui::TableNextColumn();
+                                ImGui::TextUnformatted(message.category.data(), message.category.data() + message.category.size());
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%llu", message.timestamp);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%s", message.message.c_str());
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%s : %llu", message.sourceLoc.file_name(), (std::uint64_t)message.sourceLoc.line());
+                                ImGui::PopStyleColor();
                             }
-                            ImGui::PushStyleColor(ImGuiCol_::ImGuiCol_Text, color.Value);
-                            ImGui::Text("%s", Carrot::Log::getSeverityString(message.severity));
-                            ImGui::TableNextColumn();
-                            ImGui::Text("%s", message.category.name.c_str());
-                            ImGui::TableNextColumn();
-                            ImGui::Text("%llu", message.timestamp);
-                            ImGui::TableNextColumn();
-                            ImGui::Text("%s", message.message.c_str());
-                            ImGui::TableNextColumn();
-                            ImGui::Text("%s : %llu", message.sourceLoc.file_name(), (std::uint64_t)message.sourceLoc.line());
-                            ImGui::PopStyleColor();
                         }
-                    }
+                    });
 
                     ImGui::EndTable();
                 }
@@ -22,6 +22,7 @@ namespace Carrot::ECS {
     }
 
     Entity World::newEntityWithID(EntityID entity, std::string_view name) {
+        recordEntityWrite(entity);
         auto toReturn = Entity(entity, *this);
         entityNames[entity] = name;
         entitiesToAdd.emplace_back(toReturn);
@@ -29,11 +30,13 @@ namespace Carrot::ECS {
     }
 
     Entity& Entity::setFlags(EntityFlags flags) {
+        getWorld().recordEntityWrite(internalEntity);
         getWorld().entityFlags[internalEntity] |= flags;
         return *this;
     }
 
     Entity& Entity::removeFlags(EntityFlags flags) {
+        getWorld().recordEntityWrite(internalEntity);
         getWorld().entityFlags[internalEntity] &= ~flags;
         return *this;
     }
@@ -101,6 +104,7 @@ namespace Carrot::ECS {
     }
 
     void Entity::updateName(std::string_view name) {
+        getWorld().recordEntityWrite(internalEntity);
         getWorld().entityNames[internalEntity] = name;
     }
 
@@ -129,6 +133,7 @@ namespace Carrot::ECS {
     }
 
     Entity& Entity::removeComponent(const ComponentID& componentID) {
+        getWorld().recordComponentWrite(internalEntity, componentID);
         auto& componentMap = getWorld().entityComponents[internalEntity];
         componentMap.erase(componentID);
         getWorld().entitiesUpdated.push_back(internalEntity);
@@ -149,6 +154,9 @@ namespace Carrot::ECS {
     }
 
     World::~World() {
+        if(pRecordingSnapshot) {
+            pRecordingSnapshot->pWorld = nullptr;
+        }
         GetCSharpBindings().unregisterGameAssemblyLoadCallback(csharpLoadCallbackHandle);
         GetCSharpBindings().unregisterGameAssemblyUnloadCallback(csharpUnloadCallbackHandle);
     }
@@ -261,6 +269,15 @@ namespace Carrot::ECS {
             }
 
             for(const auto& toRemove : entitiesToRemove) {
+                if(pRecordingSnapshot) {
+                    recordEntityWrite(toRemove);
+                    if(auto componentsIt = entityComponents.find(toRemove); componentsIt != entityComponents.end()) {
+                        for(const auto& [componentID, _] : componentsIt->second) {
+                            recordComponentWrite(toRemove, componentID);
+                        }
+                    }
+                }
+
                 auto position = find(entities.begin(), entities.end(), toRemove);
                 if(position != entities.end()) { // clear components
                     entityComponents.erase(entityComponents.find(toRemove));
@@ -456,6 +473,15 @@ namespace Carrot::ECS {
     void World::setParent(const Entity& toSet, std::optional<Entity> parent) {
         assert(toSet);
         auto previousParent = entityParents.find(toSet);
+        if(pRecordingSnapshot) {
+            recordEntityWrite(toSet);
+            if(previousParent != entityParents.end()) {
+                recordEntityWrite(previousParent->second);
+            }
+            if(parent) {
+                recordEntityWrite(parent->getID());
+            }
+        }
         if(previousParent != entityParents.end()) {
             auto& parentChildren = entityChildren[previousParent->second];
             parentChildren.erase(std::remove(parentChildren.begin(), parentChildren.end(), toSet.internalEntity), parentChildren.end());
@@ -579,6 +605,7 @@ namespace Carrot::ECS {
     std::span<const EntityWithComponents> World::queryEntities(const Signature& signature) {
         for(auto& query : queries) {
             if(query.signature == signature) {
+                recordComponentWrites(query.matchingEntities);
                 return query.matchingEntities;
             }
         }
@@ -631,6 +658,7 @@ namespace Carrot::ECS {
     std::string& World::getName(const EntityID& entityID) {
         auto it = entityNames.find(entityID);
         if(it != entityNames.end()) {
+            recordEntityWrite(entityID);
             return it->second;
         }
         throw std::runtime_error("Non-existent entity.");
@@ -664,6 +692,7 @@ namespace Carrot::ECS {
     std::vector<Component *> World::getAllComponents(const EntityID& entityID) const {
         std::vector<Component*> comps;
         for(auto& [id, comp] : entityComponents.at(entityID)) {
+            recordComponentWrite(entityID, id);
             comps.push_back(comp.get());
         }
         return comps;
@@ -674,10 +703,19 @@ namespace Carrot::ECS {
     }
 
     Memory::OptionalRef<Component> World::getComponent(const EntityID& entityID, ComponentID component) const {
+        Component* pComponent = findComponent(entityID, component);
+        if(pComponent == nullptr) {
+            return {};
+        }
+        recordComponentWrite(entityID, component);
+        return pComponent;
+    }
+
+    Component* World::findComponent(const EntityID& entityID, ComponentID component) const {
         auto componentMapLocation = this->entityComponents.find(entityID);
         if(componentMapLocation == this->entityComponents.end()) {
             // no such entity
-            return {};
+            return nullptr;
         }
 
         auto& componentMap = componentMapLocation->second;
@@ -685,7 +723,7 @@ namespace Carrot::ECS {
 
         if(componentLocation == componentMap.end()) {
             // no such component
-            return {};
+            return nullptr;
         }
         return componentLocation->second.get();
     }
@@ -695,6 +733,11 @@ namespace Carrot::ECS {
     }
 
     World& World::operator=(const World& toCopy) {
+        if(pRecordingSnapshot) {
+            // everything is replaced, the snapshot can no longer track what changed
+            pRecordingSnapshot->pWorld = nullptr;
+            pRecordingSnapshot = nullptr;
+        }
         queries.clear(); // make sure we don't reference entities that no longer exist
         entitiesUpdated.clear();
         entityParents = toCopy.entityParents;
@@ -732,6 +775,122 @@ namespace Carrot::ECS {
         return *this;
     }
 
+    std::unique_ptr<WorldSnapshot> World::takeSnapshot() {
+        verify(pRecordingSnapshot == nullptr, "A snapshot is already recording changes of this world");
+        std::unique_ptr<WorldSnapshot> snapshot { new WorldSnapshot(*this) };
+        snapshot->entitiesToAdd = entitiesToAdd;
+        snapshot->entitiesToRemove = entitiesToRemove;
+        snapshot->frozenLogic = frozenLogic;
+
+        // few systems, and they can be modified in ways we cannot track
+        for(const auto& system : logicSystems) {
+            snapshot->logicSystems.emplace_back(system->duplicate(*this));
+        }
+        for(const auto& system : renderSystems) {
+            snapshot->renderSystems.emplace_back(system->duplicate(*this));
+        }
+
+        pRecordingSnapshot = snapshot.get();
+        return snapshot;
+    }
+
+    void World::restoreSnapshot(std::unique_ptr<WorldSnapshot>&& snapshot) {
+        ZoneScoped;
+        verify(snapshot && snapshot->pWorld == this && pRecordingSnapshot == snapshot.get(), "Snapshot is not recording changes of this world");
+        pRecordingSnapshot = nullptr;
+        snapshot->pWorld = nullptr;
+
+        queries.clear();
+
+        // current systems may reference components which are about to be replaced
+        logicSystems = std::move(snapshot->logicSystems);
+        renderSystems = std::move(snapshot->renderSystems);
+
+        {
+            ZoneScopedN("Restore components");
+            auto& componentLib = getComponentLibrary();
+            for(auto& [key, saved] : snapshot->savedComponents) {
+                if(!saved.existed) {
+                    if(auto componentsIt = entityComponents.find(key.entity); componentsIt != entityComponents.end()) {
+                        componentsIt->second.erase(key.component);
+                    }
+                    continue;
+                }
+                entityComponents[key.entity][key.component] = componentLib.deserialise(saved.typeName, saved.json, wrap(key.entity));
+            }
+        }
+
+        {
+            ZoneScopedN("Restore entities");
+            for(auto& [entity, saved] : snapshot->savedEntities) {
+                auto restore = [&](auto& map, auto& savedValue) {
+                    if(savedValue.has_value()) {
+                        map[entity] = std::move(savedValue.value());
+                    } else {
+                        map.erase(entity);
+                    }
+                };
+
+                if(!saved.existed) {
+                    entityNames.erase(entity);
+                    entityFlags.erase(entity);
+                    entityParents.erase(entity);
+                    entityChildren.erase(entity);
+                    entityComponents.erase(entity);
+                    continue;
+                }
+                entityNames[entity] = std::move(saved.name);
+                restore(entityFlags, saved.flags);
+                restore(entityParents, saved.parent);
+                restore(entityChildren, saved.children);
+            }
+
+            entitiesToAdd = std::move(snapshot->entitiesToAdd);
+            entitiesToRemove = std::move(snapshot->entitiesToRemove);
+            entitiesUpdated.clear();
+            frozenLogic = snapshot->frozenLogic;
+
+            const std::unordered_set<EntityID> pendingEntities { entitiesToAdd.begin(), entitiesToAdd.end() };
+            std::erase_if(entities, [&](const EntityID& entity) {
+                return !exists(entity) || pendingEntities.contains(entity);
+            });
+
+            // entities removed since the snapshot was taken
+            const std::unordered_set<EntityID> activeEntities { entities.begin(), entities.end() };
+            for(const auto& [entity, saved] : snapshot->savedEntities) {
+                if(saved.existed && !activeEntities.contains(entity) && !pendingEntities.contains(entity)) {
+                    entities.push_back(entity);
+                }
+            }
+        }
+
+        for(auto& system : logicSystems) {
+            system->onEntitiesAdded(entities);
+        }
+        for(auto& system : renderSystems) {
+            system->onEntitiesAdded(entities);
+        }
+    }
+
+    const WorldSnapshot* World::getRecordingSnapshot() const {
+        return pRecordingSnapshot;
+    }
+
+    void World::markModified(const EntityID& entity, ComponentID component) const {
+        recordComponentWrite(entity, component);
+    }
+
+    void World::recordComponentWrites(std::span<const EntityWithComponents> entitiesWithComponents) const {
+        if(pRecordingSnapshot == nullptr) {
+            return;
+        }
+        for(const auto& entityWithComponents : entitiesWithComponents) {
+            for(const Component* pComponent : entityWithComponents.components) {
+                recordComponentWrite(entityWithComponents.entity.getID(), pComponent->getComponentTypeID());
+            }
+        }
+    }
+
     void World::reloadSystems() {
         for(auto& s : logicSystems) {
             s->reload();
@@ -12,6 +12,7 @@
 #include <engine/ecs/components/Component.h>
 #include <engine/ecs/systems/System.h>
 #include <engine/ecs/WorldData.h>
+#include <engine/ecs/WorldSnapshot.h>
 #include <eventpp/callbacklist.h>
 
 #include "EntityTypes.h"
@@ -38,6 +39,11 @@ namespace Carrot::ECS {
 
         Memory::OptionalRef<Component> getComponent(const EntityID& entityID, ComponentID component) const;
 
+        /// Read-only access to a component, which the recording snapshot (if any) does not consider as a modification.
+        /// nullptr if the entity has no such component
+        template<class Comp>
+        const Comp* readComponent(const EntityID& entityID) const;
+
         EntityFlags getFlags(const Entity& entity) const;
 
         std::vector<Entity> getEntitiesWithFlags(EntityFlags tags) const;
@@ -162,6 +168,31 @@ namespace Carrot::ECS {
         /// Gets the first entity with the given name
         std::optional<Entity> findEntityByName(std::string_view name) const;
 
+    public: // snapshots & change tracking
+        /**
+         * Takes a copy-on-write snapshot of this world, see WorldSnapshot. Components and entities are not copied by this call,
+         * but the first time they are modified while the snapshot is recording.
+         * Only one snapshot can record changes at a given time.
+         */
+        std::unique_ptr<WorldSnapshot> takeSnapshot();
+
+        /**
+         * Brings back this world to the state it had when 'snapshot' was taken. Only components and entities modified since
+         * the snapshot are restored. Systems are replaced by the ones which existed when the snapshot was taken.
+         * Systems are not reloaded, call reloadSystems afterwards if they were unloaded.
+         */
+        void restoreSnapshot(std::unique_ptr<WorldSnapshot>&& snapshot);
+
+        /// Snapshot currently recording changes to this world, nullptr if none
+        const WorldSnapshot* getRecordingSnapshot() const;
+
+        /**
+         * Notifies the recording snapshot (if any) that the given component is about to be modified.
+         * Mutable accesses through World, Entity and systems already do this, this is only required for code which keeps
+         * pointers to components across frames.
+         */
+        void markModified(const EntityID& entity, ComponentID component) const;
+
     public:
         World& operator=(const World& toCopy);
 
@@ -182,6 +213,25 @@ namespace Carrot::ECS {
          */
         void repairLinks(const Carrot::ECS::Entity& root, const std::unordered_map<Carrot::ECS::EntityID, Carrot::ECS::EntityID>& remap);
 
+        /// Finds a component, without considering it modified
+        Component* findComponent(const EntityID& entity, ComponentID component) const;
+
+        /// Must be called before modifying a component (or giving out mutable access to it), saves it for the recording snapshot if any
+        void recordComponentWrite(const EntityID& entity, ComponentID component) const {
+            if(pRecordingSnapshot != nullptr) [[unlikely]] {
+                pRecordingSnapshot->saveComponent(*this, entity, component);
+            }
+        }
+
+        /// Must be called before modifying the name, flags or hierarchy of an entity, or before creating/removing it
+        void recordEntityWrite(const EntityID& entity) const {
+            if(pRecordingSnapshot != nullptr) [[unlikely]] {
+                pRecordingSnapshot->saveEntity(*this, entity);
+            }
+        }
+
+        void recordComponentWrites(std::span<const EntityWithComponents> entitiesWithComponents) const;
+
     private:
         WorldData worldData;
         std::vector<EntityID> entities;
@@ -200,6 +250,8 @@ namespace Carrot::ECS {
 
         bool frozenLogic = false;
 
+        WorldSnapshot* pRecordingSnapshot = nullptr;
+
         // used to invalidate structures that hold csharp components
         eventpp::CallbackList<void()>::Handle csharpLoadCallbackHandle;
         eventpp::CallbackList<void()>::Handle csharpUnloadCallbackHandle;
@@ -209,6 +261,8 @@ namespace Carrot::ECS {
         std::unordered_map<EntityID, std::vector<EntityID>> entityChildren;
 
         friend class Entity;
+        friend class WorldSnapshot;
+        friend class System; // recordComponentWrites
     };
 }
 
@@ -1,6 +1,7 @@
 #include "World.h"
 #include <algorithm>
 #include <core/async/Counter.h>
+#include <core/tasks/Tasks.h>
 
 namespace Carrot::ECS {
     template<class Comp>
@@ -23,11 +24,18 @@ namespace Carrot::ECS {
             // no such component
             return {};
         }
+        recordComponentWrite(entityID, Comp::getID());
         return dynamic_cast<Comp*>(componentLocation->second.get());
     }
 
+    template<class Comp>
+    const Comp* World::readComponent(const EntityID& entityID) const {
+        return dynamic_cast<const Comp*>(findComponent(entityID, Comp::getID()));
+    }
+
     template<typename Comp>
     Entity& Entity::addComponent(std::unique_ptr<Comp>&& component) {
+        getWorld().recordComponentWrite(internalEntity, component->getComponentTypeID());
         auto& componentMap = getWorld().entityComponents[internalEntity];
         componentMap[component->getComponentTypeID()] = std::move(component);
         getWorld().entitiesUpdated.push_back(internalEntity);
@@ -36,6 +44,7 @@ namespace Carrot::ECS {
 
     template<typename Comp, typename... Args>
     Entity& Entity::addComponent(Args&&... args) {
+        getWorld().recordComponentWrite(internalEntity, Comp::getID());
         auto& componentMap = getWorld().entityComponents[internalEntity];
         componentMap[Comp::getID()] = std::make_unique<Comp>(*this, args...);
         getWorld().entitiesUpdated.push_back(internalEntity);
@@ -44,6 +53,7 @@ namespace Carrot::ECS {
 
     template<typename Comp>
     Entity& Entity::removeComponent() {
+        getWorld().recordComponentWrite(internalEntity, Comp::getID());
         auto& componentMap = getWorld().entityComponents[internalEntity];
         componentMap.erase(Comp::getID());
         getWorld().entitiesUpdated.push_back(internalEntity);
@@ -122,6 +132,7 @@ namespace Carrot::ECS {
 
     template<SystemType type, typename... RequiredComponents>
     void SignedSystem<type, RequiredComponents...>::forEachEntity(const std::function<void(Entity&, RequiredComponents&...)>& action) {
+        this->recordComponentWritesIfLogic();
         for(auto& entity : entitiesWithComponents) {
             if (entity.entity) {
                 // TODO: lift getComponentIndex out of loop
@@ -130,25 +141,43 @@ namespace Carrot::ECS {
         }
     }
 
+    template<SystemType type, typename... RequiredComponents>
+    void SignedSystem<type, RequiredComponents...>::forEachEntityWithIndex(const std::function<void(std::size_t, Entity&, RequiredComponents&...)>& action) {
+        this->recordComponentWritesIfLogic();
+        for(std::size_t localIndex = 0; localIndex < entitiesWithComponents.size(); localIndex++) {
+            auto& entity = entitiesWithComponents[localIndex];
+            if (entity.entity) {
+                action(localIndex, entity.entity, (*((RequiredComponents*)entity.components[signature.getComponentIndex(RequiredComponents::getID())]))...);
+            }
+        }
+    }
+
     template<SystemType type, typename... RequiredComponents>
     void SignedSystem<type, RequiredComponents...>::parallelForEachEntity(const std::function<void(Entity&, RequiredComponents&...)>& action) {
         if(entities.empty())
             return;
-        Async::Counter counter;
+        this->recordComponentWritesIfLogic();
         const std::size_t entityCount = entities.size();
-        const std::size_t stepSize = static_cast<std::size_t>(ceil((double)entityCount / concurrency()));
-        for(std::size_t index = 0; index < entityCount; index += stepSize) {
-            parallelSubmit([&, startIndex = index, endIndex = index + stepSize -1]() {
-                for(std::size_t localIndex = startIndex; localIndex <= endIndex && localIndex < entityCount; localIndex++) {
-                    auto& entity = entitiesWithComponents[localIndex];
-                    if (entity.entity) {
-                        // TODO: lift getComponentIndex out of loop
-                        action(entity.entity, (*((RequiredComponents*)entity.components[signature.getComponentIndex(RequiredComponents::getID())]))...);
-                    }
-                }
-            }, counter);
-        }
+        Async::parallelFor(entityCount, [&](std::size_t localIndex) {
+            auto& entity = entitiesWithComponents[localIndex];
+            if (entity.entity) {
+                // TODO: lift getComponentIndex out of loop
+                action(entity.entity, (*((RequiredComponents*)entity.components[signature.getComponentIndex(RequiredComponents::getID())]))...);
+            }
+        }, 1);
+    }
 
-        counter.sleepWait();
+    template<SystemType type, typename... RequiredComponents>
+    void SignedSystem<type, RequiredComponents...>::parallelForEachEntityWithIndex(const std::function<void(std::size_t, Entity&, RequiredComponents&...)>& action) {
+        if(entities.empty())
+            return;
+        this->recordComponentWritesIfLogic();
+        const std::size_t entityCount = entities.size();
+        Async::parallelFor(entityCount, [&](std::size_t localIndex) {
+            auto& entity = entitiesWithComponents[localIndex];
+            if (entity.entity) {
+                action(localIndex, entity.entity, (*((RequiredComponents*)entity.components[signature.getComponentIndex(RequiredComponents::getID())]))...);
+            }
+        }, 1);
     }
 }
\ No newline at end of file
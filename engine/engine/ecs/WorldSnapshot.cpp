@@ -0,0 +1,93 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "WorldSnapshot.h"
+#include <atomic>
+#include <engine/ecs/World.h>
+
+namespace Carrot::ECS {
+    static std::atomic<std::uint64_t> NextSnapshotID = 1;
+
+    WorldSnapshot::WorldSnapshot(World& world): pWorld(&world), id(NextSnapshotID++) {}
+
+    WorldSnapshot::~WorldSnapshot() {
+        if(pWorld != nullptr && pWorld->pRecordingSnapshot == this) {
+            pWorld->pRecordingSnapshot = nullptr;
+        }
+    }
+
+    bool WorldSnapshot::isRecording() const {
+        return pWorld != nullptr;
+    }
+
+    std::uint64_t WorldSnapshot::getID() const {
+        return id;
+    }
+
+    bool WorldSnapshot::wasModified(const EntityID& entity, ComponentID component) const {
+        std::lock_guard l { access };
+        return savedComponents.contains(ComponentKey { entity, component });
+    }
+
+    std::vector<ComponentKey> WorldSnapshot::getModifiedComponents() const {
+        std::lock_guard l { access };
+        std::vector<ComponentKey> result;
+        result.reserve(savedComponents.size());
+        for(const auto& [key, _] : savedComponents) {
+            result.push_back(key);
+        }
+        return result;
+    }
+
+    std::vector<EntityID> WorldSnapshot::getModifiedEntities() const {
+        std::lock_guard l { access };
+        std::vector<EntityID> result;
+        result.reserve(savedEntities.size());
+        for(const auto& [entity, _] : savedEntities) {
+            result.push_back(entity);
+        }
+        return result;
+    }
+
+    void WorldSnapshot::saveComponent(const World& world, const EntityID& entity, ComponentID component) {
+        std::lock_guard l { access };
+        auto [it, inserted] = savedComponents.try_emplace(ComponentKey { entity, component });
+        if(!inserted) {
+            return; // the value from the snapshot is already saved
+        }
+
+        if(const Component* pComponent = world.findComponent(entity, component)) {
+            SavedComponent& saved = it->second;
+            saved.existed = true;
+            saved.typeName = pComponent->getName();
+            saved.json = pComponent->toJSON(jsonStorage);
+        }
+    }
+
+    void WorldSnapshot::saveEntity(const World& world, const EntityID& entity) {
+        std::lock_guard l { access };
+        auto [it, inserted] = savedEntities.try_emplace(entity);
+        if(!inserted) {
+            return;
+        }
+
+        auto nameIt = world.entityNames.find(entity);
+        if(nameIt == world.entityNames.end()) {
+            return; // created after the snapshot
+        }
+
+        SavedEntity& saved = it->second;
+        saved.existed = true;
+        saved.name = nameIt->second;
+        if(auto flagsIt = world.entityFlags.find(entity); flagsIt != world.entityFlags.end()) {
+            saved.flags = flagsIt->second;
+        }
+        if(auto parentIt = world.entityParents.find(entity); parentIt != world.entityParents.end()) {
+            saved.parent = parentIt->second;
+        }
+        if(auto childrenIt = world.entityChildren.find(entity); childrenIt != world.entityChildren.end()) {
+            saved.children = childrenIt->second;
+        }
+    }
+}
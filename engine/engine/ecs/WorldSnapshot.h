@@ -0,0 +1,106 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <rapidjson/document.h>
+#include <engine/ecs/EntityTypes.h>
+
+namespace Carrot::ECS {
+    class World;
+    class System;
+
+    /// Identifies a single component inside a World
+    struct ComponentKey {
+        EntityID entity;
+        ComponentID component = 0;
+
+        bool operator==(const ComponentKey& other) const = default;
+    };
+
+    struct ComponentKeyHasher {
+        std::size_t operator()(const ComponentKey& key) const {
+            return std::hash<EntityID>{}(key.entity) * 31 + key.component;
+        }
+    };
+
+    /**
+     * Copy-on-write copy of a World, created by World::takeSnapshot and given back to the world with World::restoreSnapshot.
+     *
+     * Taking a snapshot copies no entity and no component. Instead, while the snapshot is recording, the world saves a
+     * component (as JSON, like when saving a scene) the first time mutable access to it is given out, and saves the
+     * name/flags/hierarchy of an entity the first time they are modified. Iteration by render systems and
+     * World::readComponent are read-only, and do not save anything.
+     * Restoring therefore only touches what was potentially modified since the snapshot was taken.
+     *
+     * The list of modified components/entities can also be queried while recording, for tools which need to know what changed.
+     */
+    class WorldSnapshot {
+    public:
+        ~WorldSnapshot();
+
+        /// False once restored, or if the world was destroyed or overwritten
+        bool isRecording() const;
+
+        /// Unique ID of this snapshot, never 0
+        std::uint64_t getID() const;
+
+        /// Was the given component potentially modified, added or removed since this snapshot was taken?
+        bool wasModified(const EntityID& entity, ComponentID component) const;
+
+        /// Components potentially modified, added or removed since this snapshot was taken. In no particular order
+        std::vector<ComponentKey> getModifiedComponents() const;
+
+        /// Entities which were created or removed, or had their name, flags or hierarchy modified since this snapshot was taken. In no particular order
+        std::vector<EntityID> getModifiedEntities() const;
+
+    private:
+        explicit WorldSnapshot(World& world);
+
+        /// Saves the given component if it was not saved yet. Called before modifications
+        void saveComponent(const World& world, const EntityID& entity, ComponentID component);
+
+        /// Saves the name, flags and hierarchy of the given entity if it was not saved yet. Called before modifications
+        void saveEntity(const World& world, const EntityID& entity);
+
+        struct SavedComponent {
+            bool existed = false; //< false if the component was added after the snapshot was taken
+            std::string typeName;
+            rapidjson::Value json; //< memory owned by WorldSnapshot::jsonStorage
+        };
+
+        struct SavedEntity {
+            bool existed = false; //< false if the entity was created after the snapshot was taken
+            std::string name;
+            std::optional<EntityFlags> flags;
+            std::optional<EntityID> parent;
+            std::optional<std::vector<EntityID>> children;
+        };
+
+        World* pWorld = nullptr;
+        std::uint64_t id = 0;
+
+        // components can be accessed from multiple threads, and saving a component can access other components
+        mutable std::recursive_mutex access;
+        rapidjson::Document jsonStorage; //< allocator shared by all saved components
+        std::unordered_map<ComponentKey, SavedComponent, ComponentKeyHasher> savedComponents;
+        std::unordered_map<EntityID, SavedEntity> savedEntities;
+
+        // small enough to be copied directly
+        std::vector<EntityID> entitiesToAdd;
+        std::vector<EntityID> entitiesToRemove;
+        bool frozenLogic = false;
+        std::vector<std::unique_ptr<System>> logicSystems;
+        std::vector<std::unique_ptr<System>> renderSystems;
+
+        friend class World;
+    };
+}
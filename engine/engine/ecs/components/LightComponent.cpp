@@ -11,6 +11,7 @@ namespace Carrot::ECS {
         if(!lightRef) {
             lightRef = GetRenderer().getLighting().create();
             lightRef->light.flags = Render::LightFlags::Enabled;
+            lightRef->markDirty();
         }
     };
 
@@ -37,6 +38,7 @@ namespace Carrot::ECS {
                 light.spot.outerCutoffCosAngle = params["outer_cutoff_cos_angle"].GetFloat();
             }
         }
+        lightRef->markDirty();
     }
 
     rapidjson::Value LightComponent::toJSON(rapidjson::Document& doc) const {
@@ -76,6 +78,7 @@ namespace Carrot::ECS {
     std::shared_ptr<Render::LightHandle> LightComponent::duplicateLight(const Render::LightHandle& light) {
         auto clone = GetRenderer().getLighting().create();
         clone->light = light.light;
+        clone->markDirty();
         return clone;
     }
 
@@ -83,6 +86,7 @@ namespace Carrot::ECS {
         if(savedLight) {
             lightRef = GetRenderer().getLighting().create();
             lightRef->light = savedLight.value();
+            lightRef->markDirty();
         }
     }
 
@@ -10,7 +10,7 @@ namespace Carrot::ECS {
     glm::mat4 TransformComponent::toTransformMatrix() const {
         auto parent = getEntity().getParent();
         if(parent) {
-            if(auto parentTransform = getEntity().getWorld().getComponent<TransformComponent>(parent.value())) {
+            if(auto parentTransform = getEntity().getWorld().readComponent<TransformComponent>(parent.value())) {
                 glm::mat4 parentGlobalTransform = parentTransform->toTransformMatrix();
                 return parentGlobalTransform * localTransform.toTransformMatrix();
             }
@@ -29,7 +29,7 @@ namespace Carrot::ECS {
     void TransformComponent::setGlobalTransform(const Carrot::Math::Transform& newTransform) {
         auto parent = getEntity().getParent();
         if(parent) {
-            if (auto parentTransform = getEntity().getWorld().getComponent<TransformComponent>(parent.value())) {
+            if (auto parentTransform = getEntity().getWorld().readComponent<TransformComponent>(parent.value())) {
                 glm::mat4 inverseParent = glm::inverse(parentTransform->toTransformMatrix());
                 glm::vec4 localTranslationH = inverseParent * glm::vec4{ newTransform.position, 1.0 };
                 glm::vec3 localTranslation = { localTranslationH.x, localTranslationH.y, localTranslationH.z };
@@ -65,7 +65,7 @@ namespace Carrot::ECS {
     glm::vec3 TransformComponent::computeFinalScale() const {
         auto parent = getEntity().getParent();
         if(parent) {
-            if (auto parentTransform = getEntity().getWorld().getComponent<TransformComponent>(parent.value())) {
+            if (auto parentTransform = getEntity().getWorld().readComponent<TransformComponent>(parent.value())) {
                 return parentTransform->computeFinalScale() * localTransform.scale;
             }
         }
@@ -75,7 +75,7 @@ namespace Carrot::ECS {
     glm::quat TransformComponent::computeFinalOrientation() const {
         auto parent = getEntity().getParent();
         if(parent) {
-            if (auto parentTransform = getEntity().getWorld().getComponent<TransformComponent>(parent.value())) {
+            if (auto parentTransform = getEntity().getWorld().readComponent<TransformComponent>(parent.value())) {
                 return parentTransform->computeFinalOrientation() * localTransform.rotation;
             }
         }
@@ -90,7 +90,7 @@ namespace Carrot::ECS {
     Carrot::Math::Transform TransformComponent::computeGlobalPhysicsTransform() const {
         auto parent = getEntity().getParent();
         if(parent) {
-            if (auto parentTransform = getEntity().getWorld().getComponent<TransformComponent>(parent.value())) {
+            if (auto parentTransform = getEntity().getWorld().readComponent<TransformComponent>(parent.value())) {
                 glm::mat4 finalTransform = toTransformMatrix();
 
                 glm::vec4 globalTranslation{ 0, 0, 0, 1 };
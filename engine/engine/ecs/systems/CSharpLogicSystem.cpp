@@ -96,6 +96,7 @@ namespace Carrot::ECS {
             return;
         }
         if(*csSystem) {
+            recordComponentWrites(); // scripts get direct access to the components of this system
             void* args[1] { (void*)&dt };
             csTickMethod->invoke(*csSystem, args);
         }
@@ -51,6 +51,7 @@ namespace Carrot::ECS {
     }
 
     void LuaRenderSystem::onFrame(Carrot::Render::Context renderContext) {
+        recordComponentWrites(); // scripts can modify their components, even from a render system
         forEachEntity([&](Entity& entity, LuaScriptComponent& component) {
             for(const auto& [p, pScript] : component.scripts) {
                 if(pScript) {
@@ -9,8 +9,21 @@
 #include <engine/render/InstanceData.h>
 #include <engine/render/RenderPacket.h>
 #include <engine/render/ClusterManager.h>
+#include <engine/console/RuntimeOption.hpp>
+
+extern Carrot::RuntimeOption DisableFrustumCheck;
 
 namespace Carrot::ECS {
+    /// Clustered geometry is culled on the GPU, so it must still be given to its renderer when culled on the CPU.
+    /// Same for storage which was never used by a renderer: clusters are created on first render
+    static bool canSkipCulledModel(const Render::ModelRendererStorage& storage, const Carrot::Render::Context& renderContext) {
+        if(storage.pCreator == nullptr) {
+            return false;
+        }
+        auto iter = storage.clusterModelsPerViewport.find(renderContext.pViewport);
+        return iter == storage.clusterModelsPerViewport.end() || !iter->second;
+    }
+
     ModelRenderSystem::ModelRenderSystem(const rapidjson::Value& json, World& world): RenderSystem<TransformComponent, ModelComponent>(world) {
 
     }
@@ -23,13 +36,40 @@ namespace Carrot::ECS {
 
     }
 
+    void ModelRenderSystem::cullModels(const Carrot::Render::Context& renderContext) {
+        ZoneScoped;
+        const std::size_t entityCount = getEntities().size();
+        if(boundsFrame != renderContext.frameCount || worldBounds.size() != entityCount) {
+            ZoneScopedN("Update bounds");
+            boundsFrame = renderContext.frameCount;
+            worldBounds.clear();
+            worldBounds.resize(entityCount);
+            parallelForEachEntityWithIndex([&](std::size_t index, Entity& entity, TransformComponent& transform, ModelComponent& modelComp) {
+                Math::Sphere& bounds = worldBounds[index];
+                if(modelComp.asyncModel.isReady()) {
+                    bounds = modelComp.asyncModel->getStaticBoundingSphere();
+                }
+                bounds.transform(transform.toTransformMatrix());
+            });
+            cullingGrid.rebuild(worldBounds);
+        }
+
+        visibility.resize(entityCount);
+        if(DisableFrustumCheck) {
+            std::fill(visibility.begin(), visibility.end(), 1);
+        } else {
+            cullingGrid.cull(renderContext.getCamera().getFrustum(), visibility);
+        }
+    }
+
     void ModelRenderSystem::renderModels(const Carrot::Render::Context& renderContext) {
-        parallelForEachEntity([&](Entity& entity, TransformComponent& transform, ModelComponent& modelComp) {
+        parallelForEachEntityWithIndex([&](std::size_t entityIndex, Entity& entity, TransformComponent& transform, ModelComponent& modelComp) {
             ZoneScopedN("Per entity");
             if(!entity.isVisible()) {
                 auto pMeshlets = modelComp.rendererStorage.clusterModelsPerViewport[renderContext.pViewport];
-                if(pMeshlets) {
+                if(pMeshlets && pMeshlets->enabled) {
                     pMeshlets->enabled = false;
+                    pMeshlets->markDirty();
                 }
                 if(modelComp.tlas) {
                     modelComp.tlas->enabled = false;
@@ -44,11 +84,15 @@ namespace Carrot::ECS {
                 instanceData.uuid = entity.getID();
                 instanceData.color = modelComp.color;
 
-                if(modelComp.modelRenderer) {
-                    modelComp.modelRenderer->render(modelComp.rendererStorage, renderContext, instanceData, Render::PassEnum::OpaqueGBuffer);
-                } else {
-                    // TODO: support for virtualized geometry?
-                    modelComp.asyncModel->renderStatic(modelComp.rendererStorage, renderContext, instanceData, Render::PassEnum::OpaqueGBuffer);
+                // culled models generate no packet for this viewport, but their TLAS is still updated below: they can cast shadows on visible objects
+                const bool culled = !visibility[entityIndex] && canSkipCulledModel(modelComp.rendererStorage, renderContext);
+                if(!culled) {
+                    if(modelComp.modelRenderer) {
+                        modelComp.modelRenderer->render(modelComp.rendererStorage, renderContext, instanceData, Render::PassEnum::OpaqueGBuffer);
+                    } else {
+                        // TODO: support for virtualized geometry?
+                        modelComp.asyncModel->renderStatic(modelComp.rendererStorage, renderContext, instanceData, Render::PassEnum::OpaqueGBuffer);
+                    }
                 }
                 //modelComp.asyncModel->renderStatic(renderContext, instanceData, Render::PassEnum::TransparentGBuffer);
 
@@ -72,6 +116,7 @@ namespace Carrot::ECS {
     }
 
     void ModelRenderSystem::onFrame(Carrot::Render::Context renderContext) {
+        cullModels(renderContext);
         renderModels(renderContext);
     }
 
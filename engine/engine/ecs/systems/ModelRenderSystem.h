@@ -7,6 +7,7 @@
 #include <engine/ecs/systems/System.h>
 #include <engine/ecs/components/TransformComponent.h>
 #include <engine/ecs/components/ModelComponent.h>
+#include <core/math/CullingGrid.h>
 
 namespace Carrot::ECS {
     class ModelRenderSystem: public RenderSystem<TransformComponent, Carrot::ECS::ModelComponent>, public Identifiable<ModelRenderSystem> {
@@ -40,7 +41,14 @@ namespace Carrot::ECS {
         std::unordered_map<Carrot::Model*, std::pair<std::uint32_t, std::unique_ptr<Buffer>>> opaqueInstancingBuffers;
         std::unordered_map<Carrot::Model*, std::pair<std::uint32_t, std::unique_ptr<Buffer>>> transparentInstancingBuffers;
 
+        /// Updates 'visibility' for the viewport of the given context. World-space bounds are only recomputed once per frame
+        void cullModels(const Carrot::Render::Context& renderContext);
         void renderModels(const Carrot::Render::Context& renderContext);
+
+        Math::CullingGrid cullingGrid;
+        std::vector<Math::Sphere> worldBounds; // indexed by entity index inside this system
+        std::vector<std::uint8_t> visibility; // indexed by entity index inside this system
+        std::size_t boundsFrame = -1;
     };
 }
 
@@ -5,8 +5,14 @@
 #include "SpriteRenderSystem.h"
 #include <engine/vulkan/CustomTracyVulkan.h>
 #include <engine/render/GBufferDrawData.h>
+#include <engine/console/RuntimeOption.hpp>
+
+extern Carrot::RuntimeOption DisableFrustumCheck;
 
 namespace Carrot::ECS {
+    /// Sprites are drawn as a quad going from -0.5 to 0.5 on X and Y
+    static constexpr float SpriteBoundingRadius = 0.70710678f;
+
     void SpriteRenderSystem::transparentGBufferRender(const vk::RenderPass& renderPass, Carrot::Render::Context renderContext, vk::CommandBuffer& commands) {
         // TODO: remove
     }
@@ -19,9 +25,35 @@ namespace Carrot::ECS {
         // TODO: remove
     }
 
+    void SpriteRenderSystem::cullSprites(const Carrot::Render::Context& renderContext) {
+        ZoneScoped;
+        const std::size_t entityCount = getEntities().size();
+        if(boundsFrame != renderContext.frameCount || worldBounds.size() != entityCount) {
+            boundsFrame = renderContext.frameCount;
+            worldBounds.clear();
+            worldBounds.resize(entityCount);
+            forEachEntityWithIndex([&](std::size_t index, Entity& entity, TransformComponent& transform, SpriteComponent& spriteComp) {
+                if(spriteComp.sprite) {
+                    spriteComp.sprite->parentTransform = transform.toTransformMatrix();
+                    worldBounds[index] = Math::Sphere { .radius = SpriteBoundingRadius };
+                    worldBounds[index].transform(spriteComp.sprite->computeTransformMatrix());
+                }
+            });
+            cullingGrid.rebuild(worldBounds);
+        }
+
+        visibility.resize(entityCount);
+        if(DisableFrustumCheck) {
+            std::fill(visibility.begin(), visibility.end(), 1);
+        } else {
+            cullingGrid.cull(renderContext.getCamera().getFrustum(), visibility);
+        }
+    }
+
     void SpriteRenderSystem::onFrame(Carrot::Render::Context renderContext) {
-        forEachEntity([&](Entity& entity, TransformComponent& transform, SpriteComponent& spriteComp) {
-            if(!entity.isVisible()) {
+        cullSprites(renderContext);
+        forEachEntityWithIndex([&](std::size_t entityIndex, Entity& entity, TransformComponent& transform, SpriteComponent& spriteComp) {
+            if(!entity.isVisible() || !visibility[entityIndex]) {
                 return;
             }
 
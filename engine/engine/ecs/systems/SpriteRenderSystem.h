@@ -7,6 +7,7 @@
 #include <engine/ecs/systems/System.h>
 #include <engine/ecs/components/TransformComponent.h>
 #include <engine/ecs/components/SpriteComponent.h>
+#include <core/math/CullingGrid.h>
 
 namespace Carrot::ECS {
     class SpriteRenderSystem: public RenderSystem<TransformComponent, Carrot::ECS::SpriteComponent>, public Identifiable<SpriteRenderSystem> {
@@ -35,6 +36,14 @@ namespace Carrot::ECS {
     private:
         void setupEntityData(const Entity& entity, const Carrot::Render::Sprite& sprite, const Carrot::Render::Context& renderContext, vk::CommandBuffer& commands);
         void updateSprite(Carrot::Render::Context renderContext, const TransformComponent& transform, Carrot::Render::Sprite& sprite);
+
+        /// Updates 'visibility' for the viewport of the given context. World-space bounds are only recomputed once per frame
+        void cullSprites(const Carrot::Render::Context& renderContext);
+
+        Math::CullingGrid cullingGrid;
+        std::vector<Math::Sphere> worldBounds; // indexed by entity index inside this system
+        std::vector<std::uint8_t> visibility; // indexed by entity index inside this system
+        std::size_t boundsFrame = -1;
     };
 }
 
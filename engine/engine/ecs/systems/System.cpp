@@ -4,6 +4,7 @@
 #include "System.h"
 #include <core/async/Counter.h>
 #include <engine/Engine.h>
+#include <engine/ecs/World.h>
 #include <engine/task/TaskScheduler.h>
 
 namespace Carrot::ECS {
@@ -87,6 +88,7 @@ namespace Carrot::ECS {
                 action();
             },
             .joiner = &counter,
+            .priority = TaskPriority::FrameCritical,
         };
         GetTaskScheduler().schedule(std::move(description), TaskScheduler::FrameParallelWork);
     }
@@ -98,6 +100,16 @@ namespace Carrot::ECS {
     void System::recreateEntityWithComponentsList() {
         entitiesWithComponents.resize(entities.size());
         world.fillComponents(signature, entities, entitiesWithComponents);
+        componentsRecordedForSnapshot = 0;
+    }
+
+    void System::recordComponentWrites() {
+        const WorldSnapshot* pSnapshot = world.getRecordingSnapshot();
+        if(pSnapshot == nullptr || pSnapshot->getID() == componentsRecordedForSnapshot) {
+            return;
+        }
+        world.recordComponentWrites(entitiesWithComponents);
+        componentsRecordedForSnapshot = pSnapshot->getID();
     }
 
     SystemLibrary& getSystemLibrary() {
@@ -89,6 +89,11 @@ namespace Carrot::ECS {
         void parallelSubmit(const std::function<void()>& action, Async::Counter& counter);
         static std::size_t concurrency(); // avoids to include TaskScheduler
 
+        /// Tells the snapshot recording changes of the world (if any) that the components of this system are about to be modified.
+        /// Called by the iteration helpers of logic systems (render systems only read their components). Systems accessing
+        /// their components in other ways, or render systems which modify components, must call it themselves
+        void recordComponentWrites();
+
     protected:
         World& world;
         Signature signature;
@@ -101,6 +106,8 @@ namespace Carrot::ECS {
 
         void recreateEntityWithComponentsList();
 
+        std::uint64_t componentsRecordedForSnapshot = 0; //< ID of the snapshot which already saved all components of this system
+
         friend class World;
     };
 
@@ -113,10 +120,24 @@ namespace Carrot::ECS {
         /// Calls 'action' of each entity in this system. Immediately called, so capturing on the stack is safe.
         void forEachEntity(const std::function<void(Entity&, RequiredComponents&...)>& action);
 
+        /// Same as forEachEntity, but also gives the index of the entity inside this system to 'action'.
+        ///  Indices go from 0 to getEntities().size() (excluded), and stay the same until entities are added to or removed from this system.
+        void forEachEntityWithIndex(const std::function<void(std::size_t, Entity&, RequiredComponents&...)>& action);
+
         /// Calls 'action' of each entity in this system, using a different Task for each entity.
         ///  It is up to the user to ensure no data race arise from performing the action concurrently and on other threads.
         ///  Immediately called, so capturing on the stack is safe.
         void parallelForEachEntity(const std::function<void(Entity&, RequiredComponents&...)>& action);
+
+        /// Same as parallelForEachEntity, but also gives the index of the entity inside this system to 'action' (see forEachEntityWithIndex)
+        void parallelForEachEntityWithIndex(const std::function<void(std::size_t, Entity&, RequiredComponents&...)>& action);
+
+    private:
+        void recordComponentWritesIfLogic() {
+            if constexpr(systemType == SystemType::Logic) {
+                this->recordComponentWrites();
+            }
+        }
     };
 
     template<typename... RequiredComponents>
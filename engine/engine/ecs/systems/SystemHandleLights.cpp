@@ -3,6 +3,7 @@
 //
 
 #include "SystemHandleLights.h"
+#include <cstring>
 
 namespace Carrot::ECS {
     void SystemHandleLights::onFrame(Carrot::Render::Context renderContext) {
@@ -11,19 +12,25 @@ namespace Carrot::ECS {
             glm::vec3 position = transformMatrix * glm::vec4{0,0,0,1};
             glm::vec3 forward = transformMatrix * glm::vec4{0,1,0,0};
 
-            switch (light.lightRef->light.type) {
+            auto& lightData = light.lightRef->light;
+            const Render::Light previous = lightData;
+            switch (lightData.type) {
                 case Render::LightType::Point:
-                    light.lightRef->light.point.position = position;
+                    lightData.point.position = position;
                     break;
                 case Render::LightType::Directional:
-                    light.lightRef->light.directional.direction = forward;
+                    lightData.directional.direction = forward;
                     break;
                 case Render::LightType::Spot:
-                    light.lightRef->light.spot.position = position;
-                    light.lightRef->light.spot.direction = forward;
+                    lightData.spot.position = position;
+                    lightData.spot.direction = forward;
                     break;
             }
 
+            // most lights do not move: avoid rewriting them every frame
+            if(std::memcmp(&previous, &lightData, sizeof(Render::Light)) != 0) {
+                light.lightRef->markDirty();
+            }
         });
     }
 
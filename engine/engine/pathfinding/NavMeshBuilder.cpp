@@ -98,7 +98,8 @@ namespace Carrot::AI {
         GetTaskScheduler().schedule(TaskDescription {
             .name = "Build NavMesh",
             .task = [this](TaskHandle& task) { build(task); },
-            .joiner = &taskRunning
+            .joiner = &taskRunning,
+            .priority = TaskPriority::Background,
         }, TaskScheduler::AssetLoading);
     }
 
@@ -43,7 +43,7 @@ namespace Carrot::Physics {
         renderPacket.vertexBuffer = vertexBuffer;
         renderPacket.indexBuffer = indexBuffer;
 
-        auto& cmd = renderPacket.commands.emplace_back().drawIndexedInstanced;
+        auto& cmd = renderPacket.commands.emplaceBack().drawIndexedInstanced;
         cmd.indexCount = indices.size();
         cmd.instanceCount = 1;
 
@@ -40,6 +40,7 @@ namespace Carrot {
                 .name = "Loading AsyncResource",
                 .task = asTask(storage),
                 // TODO: joiner counter?
+                .priority = TaskPriority::Background,
             };
             GetTaskScheduler().schedule(std::move(desc), TaskScheduler::AssetLoading);
         }
@@ -122,6 +122,10 @@ namespace Carrot {
         return frustum[index];
     }
 
+    const std::array<Math::Plane, 6>& Camera::getFrustum() const {
+        return frustum;
+    }
+
     bool Camera::isInFrustum(const Math::Sphere& sphere) const {
         for(int i = 0; i < 6; i++) {
             auto& plane = frustum[i];
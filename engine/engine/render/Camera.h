@@ -42,6 +42,7 @@ namespace Carrot {
         void updateFrustum();
 
         const Math::Plane& getFrustumPlane(std::size_t index) const;
+        const std::array<Math::Plane, 6>& getFrustum() const;
 
     public:
         bool isInFrustum(const Math::Sphere& sphere) const;
@@ -32,15 +32,16 @@ namespace Carrot::Render {
         std::uint8_t pad[15];
     };
 
-    ClustersTemplate::ClustersTemplate(std::size_t index, std::function<void(WeakPoolHandle*)> destructor,
+    ClustersTemplate::ClustersTemplate(std::size_t index, WeakPoolHandle::Releaser releaser,
                                        ClusterManager& manager,
                                        std::size_t firstGroupIndex,
                                        std::size_t firstCluster, std::span<const Cluster> clusters,
                                        Carrot::BufferAllocation&& vertexData,
                                        Carrot::BufferAllocation&& indexData,
-                                       Carrot::BufferAllocation&& rtTransformData
+                                       Carrot::BufferAllocation&& rtTransformData,
+                                       Carrot::BufferAllocation&& rtVertexData
                                        )
-                                       : WeakPoolHandle(index, destructor)
+                                       : WeakPoolHandle(index, releaser)
                                        , manager(manager)
                                        , firstGroupIndex(firstGroupIndex)
                                        , firstCluster(firstCluster)
@@ -48,6 +49,7 @@ namespace Carrot::Render {
                                        , vertexData(std::move(vertexData))
                                        , indexData(std::move(indexData))
                                        , rtTransformData(std::move(rtTransformData))
+                                       , rtVertexData(std::move(rtVertexData))
     {
 
     }
@@ -56,14 +58,14 @@ namespace Carrot::Render {
 
     }
 
-    ClusterModel::ClusterModel(std::size_t index, std::function<void(WeakPoolHandle*)> destructor,
+    ClusterModel::ClusterModel(std::size_t index, WeakPoolHandle::Releaser releaser,
                                        ClusterManager& manager,
                                        std::span<std::shared_ptr<ClustersTemplate>> _templates,
                                        std::span<std::shared_ptr<MaterialHandle>> _materials,
                                        Viewport* pViewport,
                                        std::uint32_t firstInstance,
                                        std::uint32_t instanceCount)
-                                       : WeakPoolHandle(index, destructor)
+                                       : WeakPoolHandle(index, releaser)
                                        , manager(manager)
                                        , templates{_templates.begin(), _templates.end()}
                                        , pViewport(pViewport)
@@ -85,6 +87,11 @@ namespace Carrot::Render {
         return manager.addModel(cloneDesc);
     }
 
+    void ClusterModel::markDirty() {
+        Async::LockGuard l { manager.accessLock };
+        manager.models.markDirty(getSlot());
+    }
+
     ClusterManager::ClusterManager(VulkanRenderer& renderer): renderer(renderer) {
         onSwapchainImageCountChange(renderer.getSwapchainImageCount());
         templateClusterGroups.setGrowthFactor(2);
@@ -102,7 +109,13 @@ namespace Carrot::Render {
         clusterTransforms.resize(gpuClusters.size());
         clusterMeshes.resize(gpuClusters.size());
 
+        // quantized vertices are enough for rendering, float vertices are only needed by raytracing in that case
+        const bool quantized = !desc.quantizedVertices.empty();
+        verify(!quantized || desc.quantizedVertices.size() == desc.originalVertices.size(), "There must be as many quantized vertices as original vertices!");
+        const bool needsFloatVertices = !quantized || GetCapabilities().supportsRaytracing;
+
         std::vector<ClusterVertex> vertices;
+        std::vector<QuantizedVertex> quantizedVertices;
         std::vector<ClusterIndex> indices;
         std::vector<vk::TransformMatrixKHR> transforms;
         transforms.reserve(desc.meshlets.size());
@@ -123,6 +136,7 @@ namespace Carrot::Render {
             templateClusterGroups[globalGroupIndex].clusters.ensureReserve(4);
         }
 
+        std::size_t totalVertexCount = 0;
         for(std::size_t i = 0; i < desc.meshlets.size(); i++) {
             Meshlet& meshlet = desc.meshlets[i];
             Cluster& cluster = gpuClusters[i + firstClusterIndex];
@@ -131,6 +145,9 @@ namespace Carrot::Render {
             cluster.lod = meshlet.lod;
             cluster.triangleCount = static_cast<std::uint8_t>(meshlet.indexCount/3);
             cluster.vertexCount = static_cast<std::uint8_t>(meshlet.vertexCount);
+            cluster.vertexFormat = quantized ? ClusterVertexFormat::Quantized : ClusterVertexFormat::Packed;
+            cluster.quantizationBoundsMin = desc.quantizationBounds.min;
+            cluster.quantizationBoundsMax = desc.quantizationBounds.max;
 
             transforms.emplace_back(ASBuilder::glmToRTTransformMatrix(desc.transform));
 
@@ -139,14 +156,23 @@ namespace Carrot::Render {
             cluster.parentError = meshlet.parentError;
             cluster.error = meshlet.clusterError;
 
-            const std::size_t firstVertexIndex = vertices.size();
-            vertices.resize(firstVertexIndex + meshlet.vertexCount);
+            const std::size_t firstVertexIndex = totalVertexCount;
+            totalVertexCount += meshlet.vertexCount;
 
             const std::size_t firstIndexIndex = indices.size();
             indices.resize(firstIndexIndex + meshlet.indexCount);
 
-            for(std::size_t index = 0; index < meshlet.vertexCount; index++) {
-                vertices[index + firstVertexIndex] = ClusterVertex{ desc.originalVertices[desc.meshletVertexIndices[index + meshlet.vertexOffset]] };
+            if(needsFloatVertices) {
+                vertices.resize(totalVertexCount);
+                for(std::size_t index = 0; index < meshlet.vertexCount; index++) {
+                    vertices[index + firstVertexIndex] = ClusterVertex{ desc.originalVertices[desc.meshletVertexIndices[index + meshlet.vertexOffset]] };
+                }
+            }
+            if(quantized) {
+                quantizedVertices.resize(totalVertexCount);
+                for(std::size_t index = 0; index < meshlet.vertexCount; index++) {
+                    quantizedVertices[index + firstVertexIndex] = desc.quantizedVertices[desc.meshletVertexIndices[index + meshlet.vertexOffset]];
+                }
             }
             for(std::size_t index = 0; index < meshlet.indexCount; index++) {
                 indices[index + firstIndexIndex] = static_cast<ClusterIndex>(desc.meshletIndices[index + meshlet.indexOffset]);
@@ -156,9 +182,19 @@ namespace Carrot::Render {
             templateClusterGroups[globalGroupIndex].clusters.pushBack(firstClusterIndex + i);
         }
 
-        BufferAllocation vertexData = GetResourceAllocator().allocateDeviceBuffer(sizeof(ClusterVertex) * vertices.size(), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
-        vertexData.name(Carrot::sprintf("Virtual geometry vertex buffer %llu meshlets", desc.meshlets.size()));
-        vertexData.view.stageUpload(std::span<const ClusterVertex>{vertices});
+        BufferAllocation floatVertexData;
+        if(needsFloatVertices) {
+            floatVertexData = GetResourceAllocator().allocateDeviceBuffer(sizeof(ClusterVertex) * vertices.size(), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
+            floatVertexData.name(Carrot::sprintf("Virtual geometry vertex buffer %llu meshlets", desc.meshlets.size()));
+            floatVertexData.view.stageUpload(std::span<const ClusterVertex>{vertices});
+        }
+
+        BufferAllocation quantizedVertexData;
+        if(quantized) {
+            quantizedVertexData = GetResourceAllocator().allocateDeviceBuffer(sizeof(QuantizedVertex) * quantizedVertices.size(), vk::BufferUsageFlagBits::eStorageBuffer);
+            quantizedVertexData.name(Carrot::sprintf("Virtual geometry quantized vertex buffer %llu meshlets", desc.meshlets.size()));
+            quantizedVertexData.view.stageUpload(std::span<const QuantizedVertex>{quantizedVertices});
+        }
 
         BufferAllocation indexData = GetResourceAllocator().allocateDeviceBuffer(sizeof(ClusterIndex) * indices.size(), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR);
         indexData.name(Carrot::sprintf("Virtual geometry index buffer %llu meshlets", desc.meshlets.size()));
@@ -168,28 +204,39 @@ namespace Carrot::Render {
         rtTransformData.name(Carrot::sprintf("Virtual geometry transform buffer %llu meshlets", transforms.size()));
         rtTransformData.view.stageUpload(std::span<const vk::TransformMatrixKHR>{transforms});
 
-        std::size_t vertexOffset = 0;
+        const BufferAllocation& rasterVertexData = quantized ? quantizedVertexData : floatVertexData;
+        const std::size_t rasterVertexSize = quantized ? sizeof(QuantizedVertex) : sizeof(ClusterVertex);
+        std::size_t firstVertex = 0;
         std::size_t indexOffset = 0;
         for(std::size_t i = 0; i < desc.meshlets.size(); i++) {
             auto& cluster = gpuClusters[i + firstClusterIndex];
             const auto& meshlet = desc.meshlets[i];
 
-            cluster.vertexBufferAddress = vertexData.view.getDeviceAddress() + vertexOffset;
+            cluster.vertexBufferAddress = rasterVertexData.view.getDeviceAddress() + firstVertex * rasterVertexSize;
             cluster.indexBufferAddress = indexData.view.getDeviceAddress() + indexOffset;
             clusterTransforms[i + firstClusterIndex].address = rtTransformData.view.getDeviceAddress() + i * sizeof(vk::TransformMatrixKHR);
 
-            const Carrot::BufferView vertexBuffer = vertexData.view.subView(vertexOffset, sizeof(ClusterVertex) * meshlet.vertexCount);
-            const Carrot::BufferView indexBuffer = indexData.view.subView(indexOffset, sizeof(ClusterIndex) * meshlet.indexCount);
-            clusterMeshes[i + firstClusterIndex] = std::make_shared<LightMesh>(vertexBuffer, indexBuffer, sizeof(ClusterVertex), sizeof(ClusterIndex));
+            if(needsFloatVertices) {
+                const Carrot::BufferView vertexBuffer = floatVertexData.view.subView(firstVertex * sizeof(ClusterVertex), sizeof(ClusterVertex) * meshlet.vertexCount);
+                const Carrot::BufferView indexBuffer = indexData.view.subView(indexOffset, sizeof(ClusterIndex) * meshlet.indexCount);
+                clusterMeshes[i + firstClusterIndex] = std::make_shared<LightMesh>(vertexBuffer, indexBuffer, sizeof(ClusterVertex), sizeof(ClusterIndex));
+            }
 
-            vertexOffset += sizeof(ClusterVertex) * meshlet.vertexCount;
+            firstVertex += meshlet.vertexCount;
             indexOffset += sizeof(ClusterIndex) * meshlet.indexCount;
         }
 
+        // the template owns the buffer used for rendering, and the float copy for raytracing if it is a different buffer
+        BufferAllocation vertexData = std::move(quantized ? quantizedVertexData : floatVertexData);
+        BufferAllocation rtVertexData;
+        if(quantized) {
+            rtVertexData = std::move(floatVertexData);
+        }
+
         requireClusterUpdate = true;
         std::shared_ptr<ClustersTemplate> pTemplate = geometries.create(std::ref(*this),
                                  firstGroupIndex, firstClusterIndex, std::span{ gpuClusters.data() + firstClusterIndex, desc.meshlets.size() },
-                                 std::move(vertexData), std::move(indexData), std::move(rtTransformData));
+                                 std::move(vertexData), std::move(indexData), std::move(rtTransformData), std::move(rtVertexData));
         for(std::size_t i = 0; i < desc.meshlets.size(); i++) {
             templatesFromClusters[i + firstClusterIndex] = pTemplate->getSlot();
             groupsFromClusters[i + firstClusterIndex] = firstGroupIndex + desc.meshlets[i].groupIndex;
@@ -358,15 +405,6 @@ namespace Carrot::Render {
     void ClusterManager::beginFrame(const Carrot::Render::Context& mainRenderContext) {
         ZoneScoped;
 
-        {
-            Async::LockGuard l { accessLock };
-            auto purge = [](auto& pool) {
-                pool.erase(std::find_if(WHOLE_CONTAINER(pool), [](auto a) { return a.second.expired(); }), pool.end());
-            };
-            purge(models);
-            purge(geometries);
-        }
-
         if(GetEngine().getCapabilities().supportsRaytracing) {
             if(mainRenderContext.lastSwapchainIndex != static_cast<std::size_t>(-1)) {
                 queryVisibleGroupsAndActivateRTInstances(mainRenderContext.swapchainIndex); // TODO: which frame index should be used?
@@ -453,9 +491,21 @@ namespace Carrot::Render {
 
             instanceDataGPUVisibleArray = std::make_shared<BufferAllocation>(std::move(GetResourceAllocator().allocateStagingBuffer(sizeof(ClusterBasedModelData) * models.getRequiredStorageCount(), alignof(InstanceData))));
 
+            // the buffer is shared by all viewports: all of them need to write their models again
+            Async::LockGuard l { accessLock };
+            models.markAllDirty();
+
             requireInstanceUpdate = false;
         }
 
+        {
+            Async::LockGuard l { accessLock };
+            const auto dirtyModels = models.consumeDirtyRange();
+            for(auto& [_, viewportData] : perViewport) {
+                viewportData.dirtyModels.merge(dirtyModels);
+            }
+        }
+
         BufferView activeModelsBufferView;
         BufferView activeGroupsBufferView;
         BufferView activeGroupOffsetsBufferView;
@@ -475,13 +525,23 @@ namespace Carrot::Render {
         if(instanceDataGPUVisibleArray) {
             ClusterBasedModelData* pModelData = instanceDataGPUVisibleArray->view.map<ClusterBasedModelData>();
 
+            // only models created or modified since the last render of this viewport are written
+            auto& dirtyModels = perViewport[renderContext.pViewport].dirtyModels;
+            for(std::uint32_t slot = dirtyModels.begin; slot < dirtyModels.end; slot++) {
+                if(auto pLockedModel = models.find(slot).lock()) {
+                    if(pLockedModel->pViewport == renderContext.pViewport) {
+                        pModelData[slot].visible = pLockedModel->enabled;
+                        pModelData[slot].instanceData = pLockedModel->instanceData;
+                    }
+                }
+            }
+            dirtyModels = {};
+
             for(auto& [slot, pModel] : models) {
                 if(auto pLockedModel = pModel.lock()) {
                     if(pLockedModel->pViewport != renderContext.pViewport) {
                         continue;
                     }
-                    pModelData[slot].visible = pLockedModel->enabled;
-                    pModelData[slot].instanceData = pLockedModel->instanceData;
 
                     std::size_t activeInstancesOffset = activeInstances.size();
                     activeInstances.ensureReserve(activeInstancesOffset + pLockedModel->instanceCount);
@@ -585,14 +645,14 @@ namespace Carrot::Render {
             pushConstant.setData(std::move(data));
         }
 
-        Render::PacketCommand& drawCommand = packet.commands.emplace_back();
+        Render::PacketCommand& drawCommand = packet.commands.emplaceBack();
         const int groupSize = 32;
         drawCommand.drawMeshTasks.groupCountX = activeInstances.size() / groupSize;
         drawCommand.drawMeshTasks.groupCountY = 1;
         drawCommand.drawMeshTasks.groupCountZ = 1;
         renderer.render(packet);
 
-        Render::PacketCommand& prePassDrawCommand = prePassPacket.commands.emplace_back();
+        Render::PacketCommand& prePassDrawCommand = prePassPacket.commands.emplaceBack();
         prePassDrawCommand.compute.x = activeGroupOffsets.size() / groupSize;
         prePassDrawCommand.compute.y = 1;
         prePassDrawCommand.compute.z = 1;
@@ -739,6 +799,7 @@ namespace Carrot::Render {
                     }
                 },
                 .joiner = &sync,
+                .priority = TaskPriority::FrameCritical,
             }, TaskScheduler::FrameParallelWork);
         };
 
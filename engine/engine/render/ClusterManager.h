@@ -35,6 +35,14 @@ namespace Carrot::Render {
     class ClusterManager;
     class Viewport;
 
+    /**
+     * Format of the vertices of a cluster. Keep in sync with CLUSTER_VERTEX_FORMAT_* in clusters.glsl
+     */
+    enum class ClusterVertexFormat: std::uint8_t {
+        Packed = 0, // Carrot::PackedVertex
+        Quantized = 1, // Carrot::QuantizedVertex, relative to the quantization bounds of the cluster
+    };
+
     /**
      * Sent as-is to the GPU
      */
@@ -44,11 +52,14 @@ namespace Carrot::Render {
         std::uint8_t triangleCount;
         std::uint8_t vertexCount;
         std::uint8_t lod;
+        ClusterVertexFormat vertexFormat = ClusterVertexFormat::Packed;
         glm::mat4x3 transform{ 1.0f };
         Math::Sphere boundingSphere{}; // xyz + radius
         Math::Sphere parentBoundingSphere{}; // xyz + radius
         float error = 0.0f;
         float parentError = std::numeric_limits<float>::infinity();
+        glm::vec3 quantizationBoundsMin{ 0.0f }; // only used by quantized vertices
+        glm::vec3 quantizationBoundsMax{ 0.0f }; // only used by quantized vertices
     };
 
     /**
@@ -79,14 +90,16 @@ namespace Carrot::Render {
         const Carrot::BufferAllocation vertexData;
         const Carrot::BufferAllocation indexData;
         const Carrot::BufferAllocation rtTransformData;
+        const Carrot::BufferAllocation rtVertexData; // float vertices used by raytracing, only when 'vertexData' is quantized
 
-        explicit ClustersTemplate(std::size_t index, std::function<void(WeakPoolHandle*)> destructor,
+        explicit ClustersTemplate(std::size_t index, WeakPoolHandle::Releaser releaser,
                                   ClusterManager& manager,
                                   std::size_t firstGroupIndex,
                                   std::size_t firstCluster, std::span<const Cluster> clusters,
                                   Carrot::BufferAllocation&& vertexData,
                                   Carrot::BufferAllocation&& indexData,
-                                  Carrot::BufferAllocation&& rtTransformData
+                                  Carrot::BufferAllocation&& rtTransformData,
+                                  Carrot::BufferAllocation&& rtVertexData
                                   );
 
         ~ClustersTemplate();
@@ -109,7 +122,7 @@ namespace Carrot::Render {
         std::uint32_t instanceCount; // count of ClusterInstances related to this model
         Carrot::Vector<std::uint32_t> clustersInstanceVector; // just the list from firstInstance to firstInstance+instanceCount, used to quickly fill activeInstances during rendering
 
-        explicit ClusterModel(std::size_t index, std::function<void(WeakPoolHandle*)> destructor,
+        explicit ClusterModel(std::size_t index, WeakPoolHandle::Releaser releaser,
                                   ClusterManager& manager,
                                   std::span<std::shared_ptr<ClustersTemplate>>,
                                   std::span<std::shared_ptr<MaterialHandle>>,
@@ -118,6 +131,9 @@ namespace Carrot::Render {
 
         std::shared_ptr<ClusterModel> clone();
 
+        /// Must be called after modifying 'instanceData' or 'enabled', so that the GPU copy is updated during the next render
+        void markDirty();
+
     private:
         ClusterManager& manager;
     };
@@ -135,6 +151,13 @@ namespace Carrot::Render {
         /// Indices of vertices inside 'meshletVertexIndices', used by meshlets to describe their triangles
         std::span<std::uint32_t> meshletIndices;
 
+        /// Optional quantized copy of 'originalVertices' (same size). When present, clusters are rendered with these vertices,
+        /// and float vertices are uploaded only if raytracing is supported (BLASes need float positions)
+        std::span<const Carrot::QuantizedVertex> quantizedVertices;
+
+        /// Bounds used to quantize the positions of 'quantizedVertices'
+        Math::AABB quantizationBounds;
+
         glm::mat4 transform{1.0f};
     };
 
@@ -260,6 +283,7 @@ namespace Carrot::Render {
             Render::PerFrame<UniquePtr<Carrot::Buffer>> readbackBuffersPerFrame;
 
             bool requireInstanceUpdate = false;
+            WeakPool<ClusterModel>::DirtyRange dirtyModels; // slots of models which need to be written again inside instanceDataGPUVisibleArray
             std::shared_ptr<Carrot::BufferAllocation> instanceGPUVisibleArray;
             std::shared_ptr<Carrot::Pipeline> prePassPipeline;
             std::shared_ptr<Carrot::Pipeline> pipeline;
@@ -300,6 +324,8 @@ namespace Carrot::Render {
         Render::PerFrame<std::shared_ptr<Carrot::BufferAllocation>> instanceDataPerFrame;
 
         Carrot::StackAllocator activeInstancesAllocator { Carrot::Allocator::getDefault() };
+
+        friend struct ClusterModel;
     };
 
 } // Carrot::Render
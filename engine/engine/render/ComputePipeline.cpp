@@ -4,6 +4,7 @@
 
 #include "ComputePipeline.h"
 #include "engine/render/resources/ResourceAllocator.h"
+#include "engine/render/resources/PipelineCache.h"
 #include "engine/utils/Macros.h"
 
 Carrot::ComputePipelineBuilder::ComputePipelineBuilder(Carrot::Engine& engine): engine(engine) {
@@ -200,10 +201,10 @@ Carrot::ComputePipeline::ComputePipeline(Carrot::Engine& engine, const IO::Resou
             .pPushConstantRanges = nullptr,
     }, engine.getAllocator());
 
-    computePipeline = engine.getLogicalDevice().createComputePipelineUnique(nullptr, vk::ComputePipelineCreateInfo {
+    computePipeline = engine.getVulkanDriver().getPipelineCache().createComputePipeline(vk::ComputePipelineCreateInfo {
             .stage = computeStage.createPipelineShaderStage(vk::ShaderStageFlagBits::eCompute, &specialization),
             .layout = *computePipelineLayout,
-    }, engine.getAllocator()).value;
+    });
 
     finishedFence = engine.getLogicalDevice().createFenceUnique(vk::FenceCreateInfo {
         .flags = vk::FenceCreateFlagBits::eSignaled
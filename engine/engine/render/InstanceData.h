@@ -12,6 +12,8 @@ namespace Carrot {
         alignas(16) Carrot::UUID uuid = Carrot::UUID::null();
         alignas(16) glm::mat4 transform{1.0f};
         glm::mat4 lastFrameTransform{0.0f};
+
+        bool operator==(const InstanceData& other) const = default;
     };
 
     struct AnimatedInstanceData {
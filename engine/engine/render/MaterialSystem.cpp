@@ -16,8 +16,8 @@ namespace Carrot::Render {
     static const std::uint32_t BindingCount = 5;
     static Carrot::RuntimeOption ShowDebug("Engine/Materials Debug", false);
 
-    TextureHandle::TextureHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor, MaterialSystem& system)
-    : WeakPoolHandle::WeakPoolHandle(index, destructor)
+    TextureHandle::TextureHandle(std::uint32_t index, WeakPoolHandle::Releaser releaser, MaterialSystem& system)
+    : WeakPoolHandle::WeakPoolHandle(index, releaser)
     , materialSystem(system)
     {
 
@@ -49,6 +49,11 @@ namespace Carrot::Render {
         GetVulkanDevice().updateDescriptorSets(write, {});
     }
 
+    void TextureHandle::markDirty() {
+        Async::LockGuard l { materialSystem.accessLock };
+        materialSystem.textureHandles.markDirty(getSlot());
+    }
+
     TextureHandle::~TextureHandle() noexcept {
         for(std::size_t index = 0; index < GetEngine().getSwapchainImageCount(); index++) {
             materialSystem.boundTextures[index][getSlot()] = materialSystem.invalidTexture->getView();
@@ -56,7 +61,7 @@ namespace Carrot::Render {
         materialSystem.descriptorNeedsUpdate = std::vector<bool>(materialSystem.descriptorSets.size(), true);
     }
 
-    MaterialHandle::MaterialHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor, MaterialSystem& system): WeakPoolHandle::WeakPoolHandle(index, destructor), materialSystem(system) {
+    MaterialHandle::MaterialHandle(std::uint32_t index, WeakPoolHandle::Releaser releaser, MaterialSystem& system): WeakPoolHandle::WeakPoolHandle(index, releaser), materialSystem(system) {
 
     }
 
@@ -127,10 +132,16 @@ namespace Carrot::Render {
         emissive = other.emissive;
         metallicRoughness = other.metallicRoughness;
         normalMap = other.normalMap;
+        markDirty();
 
         return *this;
     }
 
+    void MaterialHandle::markDirty() {
+        Async::LockGuard l { materialSystem.accessLock };
+        materialSystem.materialHandles.markDirty(getSlot());
+    }
+
     void MaterialHandle::updateHandle(const Carrot::Render::Context& renderContext) {
         auto* data = materialSystem.getData(*this);
 
@@ -166,6 +177,7 @@ namespace Carrot::Render {
     void MaterialSystem::init() {
         reallocateMaterialBuffer(DefaultMaterialBufferSize);
         boundTextures.resize(GetEngine().getSwapchainImageCount());
+        pendingTextureUpdates.resize(GetEngine().getSwapchainImageCount());
 
         vk::ShaderStageFlags stageFlags = Carrot::AllVkStages;
         std::array<vk::DescriptorSetLayoutBinding, BindingCount> bindings = {
@@ -279,6 +291,7 @@ namespace Carrot::Render {
         invalidMaterialHandle->normalMap = invalidTextureHandle;
         invalidMaterialHandle->emissive = invalidTextureHandle;
         invalidMaterialHandle->metallicRoughness = invalidTextureHandle;
+        invalidMaterialHandle->markDirty();
 
         ditheringTexture = GetRenderer().getOrCreateTexture("dithering.png");
         ditheringTextureHandle = createTextureHandle(ditheringTexture);
@@ -439,19 +452,35 @@ namespace Carrot::Render {
             ImGui::End();
         }
 
-        if(materialHandles.getRequiredStorageCount() >= materialBufferSize) {
-            reallocateMaterialBuffer(Carrot::Math::nextPowerOf2(materialHandles.getRequiredStorageCount()));
+        WeakPool<MaterialHandle>::DirtyRange dirtyMaterials;
+        WeakPool<TextureHandle>::DirtyRange dirtyTextures;
+        {
+            Async::LockGuard l { accessLock };
+            if(materialHandles.getRequiredStorageCount() >= materialBufferSize) {
+                reallocateMaterialBuffer(Carrot::Math::nextPowerOf2(materialHandles.getRequiredStorageCount()));
+                materialHandles.markAllDirty(); // new buffer, everything needs to be written again
+            }
+            dirtyMaterials = materialHandles.consumeDirtyRange();
+            dirtyTextures = textureHandles.consumeDirtyRange();
+        }
+
+        // only handles created or modified since the last frame are written.
+        // textures are bound inside per-swapchain image descriptor sets, so each set keeps its own pending range
+        for(auto& pending : pendingTextureUpdates) {
+            pending.merge(dirtyTextures);
         }
+        auto& texturesToUpdate = pendingTextureUpdates[renderContext.swapchainIndex];
 
-        auto updateType = [&](auto registry) {
-            for(auto& [slot, handlePtr] : registry) {
-                if(auto handle = handlePtr.lock()) {
+        auto updateRange = [&](auto& registry, const auto& range) {
+            for(std::uint32_t slot = range.begin; slot < range.end; slot++) {
+                if(auto handle = registry.find(slot).lock()) {
                     handle->updateHandle(renderContext);
                 }
             }
         };
-        updateType(materialHandles);
-        updateType(textureHandles);
+        updateRange(materialHandles, dirtyMaterials);
+        updateRange(textureHandles, texturesToUpdate);
+        texturesToUpdate = {};
 
         updateDescriptorSets(renderContext);
     }
@@ -546,6 +575,12 @@ namespace Carrot::Render {
     void MaterialSystem::onSwapchainImageCountChange(size_t newCount) {
         reallocateDescriptorSets();
         boundTextures.resize(newCount);
+
+        // new descriptor sets: all textures need to be bound again
+        WeakPool<TextureHandle>::DirtyRange allTextures;
+        allTextures.begin = 0;
+        allTextures.end = static_cast<std::uint32_t>(textureHandles.getRequiredStorageCount());
+        pendingTextureUpdates.assign(newCount, allTextures);
     }
 
     void MaterialSystem::onSwapchainSizeChange(Window& window, int newWidth, int newHeight) {
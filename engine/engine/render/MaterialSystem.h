@@ -38,10 +38,13 @@ namespace Carrot::Render {
     public:
         Texture::Ref texture;
 
-        /*[[deprecated]] */explicit TextureHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor, MaterialSystem& system);
+        /*[[deprecated]] */explicit TextureHandle(std::uint32_t index, WeakPoolHandle::Releaser releaser, MaterialSystem& system);
 
         ~TextureHandle();
 
+        /// Call after changing 'texture', so that the descriptor sets are updated at the end of the frame
+        void markDirty();
+
     private:
         void updateHandle(const Carrot::Render::Context& renderContext);
 
@@ -66,7 +69,7 @@ namespace Carrot::Render {
 
         bool isTransparent = false;
 
-        /*[[deprecated]] */explicit MaterialHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor, MaterialSystem& system);
+        /*[[deprecated]] */explicit MaterialHandle(std::uint32_t index, WeakPoolHandle::Releaser releaser, MaterialSystem& system);
 
         ~MaterialHandle();
 
@@ -75,6 +78,10 @@ namespace Carrot::Render {
 
         MaterialHandle& operator=(const MaterialHandle& other);
 
+        /// Call after changing the properties of this material, so that its GPU data is updated at the end of the frame.
+        /// Only the materials marked dirty (or created) since the last frame are written
+        void markDirty();
+
     private:
         void updateHandle(const Carrot::Render::Context& renderContext);
 
@@ -148,6 +155,7 @@ namespace Carrot::Render {
         vk::UniqueDescriptorPool descriptorSetPool{};
         std::vector<vk::DescriptorSet> descriptorSets;
         std::vector<bool> descriptorNeedsUpdate;
+        std::vector<WeakPool<TextureHandle>::DirtyRange> pendingTextureUpdates; // per swapchain image, texture slots to rebind
 
     private:
         Carrot::Render::Texture::Ref invalidTexture = nullptr;
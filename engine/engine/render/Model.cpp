@@ -5,6 +5,7 @@
 #include "Model.h"
 #include "engine/render/resources/Mesh.h"
 #include <iostream>
+#include <limits>
 #include <core/utils/stringmanip.h>
 #include "engine/render/resources/Pipeline.h"
 #include <glm/gtx/quaternion.hpp>
@@ -59,6 +60,9 @@ void Carrot::Model::loadInner(TaskHandle& task, Carrot::Engine& engine, const Ca
         transparentMeshesPipeline = engine.getRenderer().getOrCreatePipeline("forward-noraytracing");
     }*/
     transparentMeshesPipeline = engine.getRenderer().getOrCreatePipeline("gBuffer-transparent");
+    // start compiling the pipeline variants while the rest of the model loads
+    engine.getRenderer().preparePipeline(opaqueMeshesPipeline, Render::PassEnum::OpaqueGBuffer);
+    engine.getRenderer().preparePipeline(transparentMeshesPipeline, Render::PassEnum::TransparentGBuffer);
 
     Carrot::Async::Counter waitMaterialLoads;
     // TODO: reduce task count
@@ -113,6 +117,7 @@ void Carrot::Model::loadInner(TaskHandle& task, Carrot::Engine& engine, const Ca
                 handle->emissiveColor = material.emissiveFactor;
                 handle->roughnessFactor = material.roughnessFactor;
                 handle->metallicFactor = material.metallicFactor;
+                handle->markDirty();
             },
             .joiner = &waitMaterialLoads,
         }, TaskScheduler::AssetLoading);
@@ -143,6 +148,8 @@ void Carrot::Model::loadInner(TaskHandle& task, Carrot::Engine& engine, const Ca
         info.meshletVertexIndices = primitive.meshletVertexIndices;
         info.meshletIndices = primitive.meshletIndices;
         info.meshlets = primitive.meshlets;
+        info.quantizedVertices = primitive.quantizedVertices;
+        info.quantizationBounds = primitive.quantizationBounds;
         info.startVertex = oldVertexCount;
         info.startIndex = oldIndexCount;
         info.vertexCount = primitive.vertices.size();
@@ -156,6 +163,9 @@ void Carrot::Model::loadInner(TaskHandle& task, Carrot::Engine& engine, const Ca
         staticMeshData = std::make_unique<SingleMesh>(staticVertices, staticIndices);
     }
 
+    // model-space bounds of all static meshes
+    glm::vec3 staticBoundsMin { std::numeric_limits<float>::infinity() };
+    glm::vec3 staticBoundsMax { -std::numeric_limits<float>::infinity() };
     std::function<void(const Carrot::Render::SkeletonTreeNode&, glm::mat4)> recursivelyLoadNodes = [&](const Carrot::Render::SkeletonTreeNode& node, const glm::mat4& nodeTransform) {
         glm::mat4 transform = nodeTransform * node.bone.originalTransform;
         if(node.meshIndices.has_value()) {
@@ -183,6 +193,11 @@ void Carrot::Model::loadInner(TaskHandle& task, Carrot::Engine& engine, const Ca
 
                     staticMeshes[material.getSlot()].emplace_back(mesh, transform, sphere, drawCommands.size(), meshIndex, node.nodeKey);
 
+                    Math::Sphere modelSpaceSphere = sphere;
+                    modelSpaceSphere.transform(transform);
+                    staticBoundsMin = glm::min(staticBoundsMin, modelSpaceSphere.center - modelSpaceSphere.radius);
+                    staticBoundsMax = glm::max(staticBoundsMax, modelSpaceSphere.center + modelSpaceSphere.radius);
+
 
 
                     auto& cmd = drawCommands.emplace_back();
@@ -209,6 +224,9 @@ void Carrot::Model::loadInner(TaskHandle& task, Carrot::Engine& engine, const Ca
     if(scene.nodeHierarchy) {
         recursivelyLoadNodes(scene.nodeHierarchy->hierarchy, glm::mat4{1.0f});
     }
+    if(!staticMeshes.empty()) {
+        staticBoundingSphere.loadFromAABB(staticBoundsMin, staticBoundsMax);
+    }
 
     // upload staging buffer to GPU buffer
 
@@ -486,6 +504,8 @@ std::shared_ptr<Carrot::Render::ClustersTemplate> Carrot::Model::lazyLoadMeshlet
         desc.originalVertices = std::span { staticVertices.data() + sMeshInfo.startVertex, sMeshInfo.vertexCount };
         desc.meshletVertexIndices = sMeshInfo.meshletVertexIndices;
         desc.meshletIndices = sMeshInfo.meshletIndices;
+        desc.quantizedVertices = sMeshInfo.quantizedVertices;
+        desc.quantizationBounds = sMeshInfo.quantizationBounds;
         desc.transform = transform;
 
         auto& mgr = GetRenderer().getMeshletManager();
@@ -53,6 +53,8 @@ namespace Carrot {
             std::vector<Render::Meshlet> meshlets;
             std::vector<std::uint32_t> meshletVertexIndices;
             std::vector<std::uint32_t> meshletIndices;
+            std::vector<Carrot::QuantizedVertex> quantizedVertices; // empty if the model was not quantized by Fertilizer
+            Math::AABB quantizationBounds;
             std::size_t startVertex = 0;
             std::size_t vertexCount = 0;
             std::size_t startIndex = 0;
@@ -70,6 +72,9 @@ namespace Carrot {
 
         [[nodiscard]] const std::unordered_map<std::uint32_t, std::vector<MeshAndTransform>>& getStaticMeshesPerMaterial() const { return staticMeshes; }
 
+        /// Sphere enclosing all static meshes of this model, in model space. Empty sphere if there are no static meshes
+        const Math::Sphere& getStaticBoundingSphere() const { return staticBoundingSphere; }
+
         const StaticMeshInfo& getStaticMeshInfo(std::size_t staticMeshIndex) const;
 
         Carrot::Buffer& getAnimationDataBuffer();
@@ -131,6 +136,7 @@ namespace Carrot {
         std::shared_ptr<Carrot::Pipeline> transparentMeshesPipeline;
         std::unordered_map<std::uint32_t, std::vector<MeshAndTransform>> staticMeshes{};
         std::unordered_map<std::uint32_t, std::vector<MeshAndTransform>> skinnedMeshes{};
+        Math::Sphere staticBoundingSphere;
         std::vector<std::shared_ptr<Render::MaterialHandle>> materials{};
 
         std::vector<Carrot::Vertex> staticVertices;
@@ -138,6 +138,8 @@ namespace Carrot::Render {
     ModelRenderer::ModelRenderer(Model& model): model(model) {
         opaqueMeshesPipeline = GetRenderer().getOrCreatePipeline("gBuffer");
         transparentMeshesPipeline = GetRenderer().getOrCreatePipeline("gBuffer-transparent");
+        GetRenderer().preparePipeline(opaqueMeshesPipeline, Render::PassEnum::OpaqueGBuffer);
+        GetRenderer().preparePipeline(transparentMeshesPipeline, Render::PassEnum::TransparentGBuffer);
 
         recreateStructures();
     }
@@ -196,6 +198,7 @@ namespace Carrot::Render {
                 if(const auto& element = texturesObj.FindMember("metallic_roughness_texture"); element != texturesObj.MemberEnd()) {
                     override.materialTextures->metallicRoughness = loadTexture(element->value);
                 }
+                override.materialTextures->markDirty();
             }
             if(overrideObj.HasMember("virtualized_geometry")) {
                 override.virtualizedGeometry = overrideObj["virtualized_geometry"].GetBool();
@@ -346,9 +349,10 @@ namespace Carrot::Render {
         auto iter = storage.clusterModelsPerViewport.find(renderContext.pViewport);
         if(iter != storage.clusterModelsPerViewport.end()) {
             auto& pInstance = iter->second;
-            if(pInstance) {
+            if(pInstance && (!pInstance->enabled || pInstance->instanceData != instanceData)) {
                 pInstance->enabled = true;
                 pInstance->instanceData = instanceData;
+                pInstance->markDirty();
             }
         }
 
@@ -361,7 +365,7 @@ namespace Carrot::Render {
             Render::Packet& renderPacket = GetRenderer().makeRenderPacket(renderPass, Render::PacketType::DrawIndexedInstanced, renderContext);
             renderPacket.pipeline = bucket.pipeline;
 
-            renderPacket.commands = bucket.drawCommands;
+            renderPacket.commands = std::span<const Render::PacketCommand>{ bucket.drawCommands };
 
             renderPacket.vertexBuffer = model.getStaticMeshData().getVertexBuffer();
             renderPacket.indexBuffer = model.getStaticMeshData().getIndexBuffer();
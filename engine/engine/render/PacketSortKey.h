@@ -0,0 +1,94 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <engine/render/PassEnum.h>
+
+namespace Carrot::Render {
+    /**
+     * Layout of Render::Packet::sortKey, from most to least significant bits:
+     *  - viewport, then pass: packets of a given viewport & pass are contiguous once sorted
+     *  - for z-ordered passes (see isZOrderedPass): z-order on the full 32 bits, then pipeline. Mesh and material are dropped,
+     *    the order of packets with the same z-order and pipeline is the submission order (the sort is stable)
+     *  - for other passes: pipeline, then mesh, to minimize state changes. Material comes last: materials are bindless,
+     *    it only improves locality
+     * Indices of pipelines, meshes and materials only need to group identical values together: they are clamped if there
+     * are too many of them. Viewport and pass indices must be exact.
+     */
+    namespace PacketSortKey {
+        constexpr std::uint64_t ViewportBits = 6;
+        constexpr std::uint64_t PassBits = 6;
+        constexpr std::uint64_t ZOrderBits = 32;
+        constexpr std::uint64_t PipelineBits = 12;
+        constexpr std::uint64_t MeshBits = 12;
+        constexpr std::uint64_t MaterialBits = 8;
+        static_assert(ViewportBits + PassBits + ZOrderBits + PipelineBits <= 64);
+        static_assert(ViewportBits + PassBits + PipelineBits + MeshBits + MaterialBits <= 64);
+
+        constexpr std::uint64_t ViewportShift = 64 - ViewportBits;
+        constexpr std::uint64_t PassShift = ViewportShift - PassBits;
+
+        // z-ordered passes
+        constexpr std::uint64_t ZOrderShift = PassShift - ZOrderBits;
+        constexpr std::uint64_t ZOrderedPipelineShift = ZOrderShift - PipelineBits;
+
+        // other passes
+        constexpr std::uint64_t PipelineShift = PassShift - PipelineBits;
+        constexpr std::uint64_t MeshShift = PipelineShift - MeshBits;
+        constexpr std::uint64_t MaterialShift = MeshShift - MaterialBits;
+
+        constexpr std::uint64_t maxValueForBits(std::uint64_t bits) {
+            return (1ull << bits) - 1;
+        }
+
+        /// Passes in which packets are drawn back to front (or in submission order for ImGui), based on their z-order
+        constexpr bool isZOrderedPass(PassName pass) {
+            return pass == PassEnum::TransparentGBuffer || pass == PassEnum::ImGui;
+        }
+
+        /// Maps 'zOrder' to an unsigned integer with the same ordering. All bits are kept: close z-orders never compare equal
+        constexpr std::uint64_t encodeZOrder(float zOrder) {
+            std::uint32_t bits = std::bit_cast<std::uint32_t>(zOrder);
+            bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+            return bits;
+        }
+
+        /// Values used to build the key of a packet. 'viewportIndex' and 'passIndex' must fit in ViewportBits and PassBits
+        struct Fields {
+            std::uint64_t viewportIndex = 0;
+            std::uint64_t passIndex = 0;
+            bool zOrdered = false;
+            float zOrder = 0.0f;
+            std::uint64_t pipelineIndex = 0;
+            std::uint64_t meshIndex = 0;
+            std::uint64_t materialIndex = 0;
+        };
+
+        constexpr std::uint64_t make(const Fields& fields) {
+            std::uint64_t key = (fields.viewportIndex << ViewportShift) | (fields.passIndex << PassShift);
+            const std::uint64_t pipelineIndex = std::min(fields.pipelineIndex, maxValueForBits(PipelineBits));
+            if(fields.zOrdered) {
+                key |= (encodeZOrder(fields.zOrder) << ZOrderShift)
+                     | (pipelineIndex << ZOrderedPipelineShift);
+            } else {
+                key |= (pipelineIndex << PipelineShift)
+                     | (std::min(fields.meshIndex, maxValueForBits(MeshBits)) << MeshShift)
+                     | (std::min(fields.materialIndex, maxValueForBits(MaterialBits)) << MaterialShift);
+            }
+            return key;
+        }
+
+        constexpr std::uint64_t getViewportIndex(std::uint64_t key) {
+            return key >> ViewportShift;
+        }
+
+        constexpr std::uint64_t getPassIndex(std::uint64_t key) {
+            return (key >> PassShift) & maxValueForBits(PassBits);
+        }
+    }
+}
@@ -4,6 +4,7 @@
 
 #include "RenderGraph.h"
 #include "core/utils/Assert.h"
+#include "core/utils/Containers.h"
 #include "core/io/Logging.hpp"
 #include "engine/utils/Macros.h"
 #include "engine/render/TextureRepository.h"
@@ -110,6 +111,15 @@ namespace Carrot::Render {
         GetVulkanDriver().getResourceRepository().setBufferReuseHistoryLength(toReuse.rootID, historyLength);
     }
 
+    void GraphBuilder::allowAliasing(const FrameResource& texture) {
+        verify(texture.type != ResourceType::StorageBuffer, "Only textures can be aliased");
+        verify(texture.imageOrigin == ImageOrigin::Created, "Only textures created by the graph can be aliased");
+        auto alreadyAdded = std::find_if(WHOLE_CONTAINER(aliasableResources), [&](const FrameResource& r) { return r.rootID == texture.rootID; });
+        if(alreadyAdded == aliasableResources.end()) {
+            aliasableResources.emplace_back(texture);
+        }
+    }
+
     FrameResource& GraphBuilder::createRenderTarget(std::string name, vk::Format format, TextureSize size, vk::AttachmentLoadOp loadOp,
                                               vk::ClearValue clearValue, vk::ImageLayout layout) {
         return createTarget(false, name, format, size, loadOp, clearValue, layout);
@@ -184,8 +194,16 @@ namespace Carrot::Render {
     std::unique_ptr<Graph> GraphBuilder::compile() {
         auto result = std::make_unique<Graph>(GetVulkanDriver());
 
+        // schedule first: textures created while compiling passes need to know where aliased textures go
+        for(const auto& [name, pass] : passes) {
+            result->scheduledPasses.emplace_back(pass->getScheduledPass());
+        }
+        result->aliasableResources = aliasableResources;
+        result->buildSchedule(window.getFramebufferExtent());
+
+        std::size_t passIndex = 0;
         for(const auto& [name, pass] : passes) {
-            result->passes.emplace_back(name, std::move(pass->compile(GetVulkanDriver(), window, *result)));
+            result->passes.emplace_back(name, std::move(pass->compile(GetVulkanDriver(), window, *result, result->schedule.getBarriers(passIndex++))));
         }
 
         // TODO: actually sort
@@ -202,6 +220,12 @@ namespace Carrot::Render {
         nodesContext = ed::CreateEditor(&config);
     }
 
+    Graph::~Graph() {
+        for(const auto& resource : aliasableResources) {
+            driver.getResourceRepository().removeAliasedPlacement(resource.rootID);
+        }
+    }
+
     static std::uint32_t uniqueID = 1;
     static std::unordered_map<std::uint32_t, ed::NodeId> nodes;
 
@@ -439,6 +463,10 @@ namespace Carrot::Render {
                 }
 
                 if(graphToDebug == this) {
+                    if(ImGui::CollapsingHeader("Schedule")) {
+                        ImGui::TextUnformatted(schedule.describe().c_str());
+                    }
+
                     ed::SetCurrentEditor((ed::EditorContext*)nodesContext);
                     ed::EnableShortcuts(true);
 
@@ -623,6 +651,44 @@ namespace Carrot::Render {
         return wanted;
     }
 
+    void Graph::buildSchedule(const vk::Extent2D& viewportSize) {
+        std::vector<TransientResource> transients;
+        transients.reserve(aliasableResources.size());
+        for(const auto& resource : aliasableResources) {
+            transients.emplace_back(TransientResource {
+                .resourceID = resource.rootID,
+                .memoryRequirements = Image::getMemoryRequirements(driver, ResourceRepository::computeTextureSize(resource, viewportSize), computeUsages(resource), resource.format),
+            });
+        }
+        schedule = Schedule::build(scheduledPasses, transients);
+
+        // heaps still used by existing textures are kept alive by these textures
+        transientHeaps.clear();
+        if(schedule.getHeapSize() > 0) {
+            for(std::size_t i = 0; i < driver.getSwapchainImageCount(); i++) {
+                auto* pHeap = new DeviceMemory(vk::MemoryAllocateInfo {
+                    .allocationSize = schedule.getHeapSize(),
+                    .memoryTypeIndex = driver.findMemoryType(schedule.getHeapMemoryTypeBits(), vk::MemoryPropertyFlagBits::eDeviceLocal),
+                });
+                pHeap->name("RenderGraph transient heap");
+                transientHeaps.emplace_back(pHeap, [](DeviceMemory* pMemory) {
+                    GetVulkanDriver().deferDestroy("RenderGraph transient heap", std::move(*pMemory));
+                    delete pMemory;
+                });
+            }
+            Carrot::Log::info("Render graph transient heap: %llu bytes (%llu bytes without aliasing)", schedule.getHeapSize(), schedule.getUnaliasedSize());
+        }
+
+        auto& repository = driver.getResourceRepository();
+        for(const auto& resource : aliasableResources) {
+            if(const TransientPlacement* pPlacement = schedule.getPlacement(resource.rootID)) {
+                repository.setAliasedPlacement(resource.rootID, transientHeaps, pPlacement->offset);
+            } else {
+                repository.removeAliasedPlacement(resource.rootID);
+            }
+        }
+    }
+
     Render::Texture& Graph::createTexture(const FrameResource& resource, size_t frameIndex, const vk::Extent2D& viewportSize) {
         return driver.getResourceRepository().createTexture(resource, frameIndex,
             computeUsages(resource),
@@ -655,7 +721,14 @@ namespace Carrot::Render {
     }
 
     void Graph::onSwapchainSizeChange(Window& window, int newWidth, int newHeight) {
+        // aliased textures are recreated by their passes, inside heaps matching the new size
+        buildSchedule(vk::Extent2D {
+            .width = static_cast<std::uint32_t>(newWidth),
+            .height = static_cast<std::uint32_t>(newHeight),
+        });
+        std::size_t passIndex = 0;
         for(auto& [n, pass] : passes) {
+            pass->setBarriers(schedule.getBarriers(passIndex++));
             pass->onSwapchainSizeChange(window, newWidth, newHeight);
         }
     }
@@ -18,6 +18,7 @@ namespace Carrot::Render {
     class Graph: public SwapchainAware {
     public:
         explicit Graph(VulkanDriver& driver);
+        ~Graph();
 
         /**
          * Setups graph for this frame
@@ -42,6 +43,9 @@ namespace Carrot::Render {
 
         VulkanDriver& getVulkanDriver() { return driver; }
 
+        /// Lifetimes, barriers and memory aliasing computed when compiling this graph
+        const Schedule& getSchedule() const { return schedule; }
+
     public:
         Render::CompiledPass* getPass(std::string_view passName) const;
 
@@ -60,6 +64,9 @@ namespace Carrot::Render {
         void onSwapchainSizeChange(Window& window, int newWidth, int newHeight) override;
 
     private:
+        /// Computes the schedule for the given viewport size, and allocates the memory shared by aliased textures
+        void buildSchedule(const vk::Extent2D& viewportSize);
+
         // Draws a source resource to the destination texture
         void drawViewer(const Render::Context& context, const Render::FrameResource& sourceResource, std::unique_ptr<Texture>& destinationTexture, vk::CommandBuffer cmds);
 
@@ -72,6 +79,11 @@ namespace Carrot::Render {
         std::vector<Render::CompiledPass*> sortedPasses;
         std::list<std::pair<std::string, std::any>> passesData;
 
+        std::vector<ScheduledPass> scheduledPasses;
+        std::vector<FrameResource> aliasableResources;
+        Schedule schedule;
+        std::vector<std::shared_ptr<DeviceMemory>> transientHeaps; // one per swapchain image
+
         // for imgui debug
         void* nodesContext = nullptr;
         const FrameResource* hoveredResourceForMain = nullptr;
@@ -137,6 +149,11 @@ namespace Carrot::Render {
 
         void reuseBufferAcrossFrames(const FrameResource& toReuse, std::size_t historyLength);
 
+        /// Allows this texture to share its memory with other textures of the graph which are never used at the same time.
+        /// Its contents are undefined before the first pass using it, and lost after the last one: do not use for textures
+        /// read from a previous frame, or outside of the graph.
+        void allowAliasing(const FrameResource& texture);
+
         template<typename Type>
         std::optional<Type> getPassData(std::string_view passName) const {
             for(const auto& [name, passData] : passesData) {
@@ -153,6 +170,7 @@ namespace Carrot::Render {
         std::set<Carrot::UUID> toPresent;
         std::list<std::pair<std::string, std::shared_ptr<Render::PassBase>>> passes;
         std::list<std::pair<std::string, std::any>> passesData;
+        std::vector<FrameResource> aliasableResources;
         Render::PassBase* currentPass = nullptr;
     };
 
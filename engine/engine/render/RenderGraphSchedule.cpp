@@ -0,0 +1,363 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "RenderGraphSchedule.h"
+#include <algorithm>
+#include "core/utils/Assert.h"
+#include "core/utils/stringmanip.h"
+
+namespace Carrot::Render {
+    using Stage = vk::PipelineStageFlagBits2KHR;
+    using Access = vk::AccessFlagBits2KHR;
+
+    static constexpr vk::AccessFlags2KHR WriteAccesses = Access::eShaderWrite
+                                                       | Access::eColorAttachmentWrite
+                                                       | Access::eDepthStencilAttachmentWrite
+                                                       | Access::eTransferWrite
+                                                       | Access::eMemoryWrite;
+
+    struct StageAccess {
+        vk::PipelineStageFlags2KHR stages;
+        vk::AccessFlags2KHR access;
+    };
+
+    struct ResourceState {
+        StageAccess lastUse; // stages and accesses of the last pass which used the resource
+        bool written = false; // did that pass (maybe) write to the resource?
+    };
+
+    /// Which stages of the pass touch the resource, and how. Attachments are used in their final layout ('layout')
+    static StageAccess inferStageAccess(const ScheduledPass& pass, const ScheduledAccess& access) {
+        if(access.isBuffer) {
+            StageAccess result;
+            if(pass.rasterized) {
+                result.stages = pass.shaderStages | Stage::eDrawIndirect | Stage::eVertexInput;
+                result.access = Access::eShaderRead | Access::eIndirectCommandRead | Access::eVertexAttributeRead;
+            } else {
+                // non-rasterized passes also fill and copy buffers
+                result.stages = pass.shaderStages | Stage::eTransfer;
+                result.access = Access::eShaderRead | Access::eTransferRead;
+                if(access.write) {
+                    result.access |= Access::eTransferWrite;
+                }
+            }
+            if(access.write) {
+                result.access |= Access::eShaderWrite;
+            }
+            return result;
+        }
+
+        switch(access.layout) {
+            case vk::ImageLayout::eColorAttachmentOptimal:
+            case vk::ImageLayout::ePresentSrcKHR: // presented images are rendered to as color attachments
+                return { Stage::eColorAttachmentOutput, Access::eColorAttachmentRead | Access::eColorAttachmentWrite };
+
+            case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+            case vk::ImageLayout::eDepthAttachmentOptimal:
+            case vk::ImageLayout::eStencilAttachmentOptimal:
+                return { Stage::eEarlyFragmentTests | Stage::eLateFragmentTests, Access::eDepthStencilAttachmentRead | Access::eDepthStencilAttachmentWrite };
+
+            case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+            case vk::ImageLayout::eDepthReadOnlyOptimal:
+            case vk::ImageLayout::eStencilReadOnlyOptimal: {
+                StageAccess result { pass.shaderStages, Access::eShaderRead | Access::eDepthStencilAttachmentRead };
+                if(pass.rasterized) {
+                    result.stages |= Stage::eEarlyFragmentTests | Stage::eLateFragmentTests;
+                }
+                return result;
+            }
+
+            case vk::ImageLayout::eTransferSrcOptimal:
+                return { Stage::eTransfer, Access::eTransferRead };
+
+            case vk::ImageLayout::eTransferDstOptimal:
+                return { Stage::eTransfer, Access::eTransferWrite };
+
+            case vk::ImageLayout::eShaderReadOnlyOptimal:
+                return { pass.shaderStages, Access::eShaderRead };
+
+            case vk::ImageLayout::eGeneral:
+                return { pass.shaderStages, Access::eShaderRead | Access::eShaderWrite };
+
+            default:
+                return { Stage::eAllCommands, Access::eMemoryRead | Access::eMemoryWrite };
+        }
+    }
+
+    /// Storage resources can be written by shaders even when they are declared as inputs, so they are considered as written
+    static bool mayWrite(const ScheduledAccess& access) {
+        return access.write || access.isBuffer || access.layout == vk::ImageLayout::eGeneral;
+    }
+
+    static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    static bool overlaps(const ResourceLifetime& a, const ResourceLifetime& b) {
+        return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+    }
+
+    static bool overlaps(const TransientPlacement& a, const TransientPlacement& b) {
+        return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+    }
+
+    bool PassBarriers::hasMemoryBarrier() const {
+        return srcStages != vk::PipelineStageFlags2KHR{} || dstStages != vk::PipelineStageFlags2KHR{};
+    }
+
+    bool PassBarriers::empty() const {
+        return images.empty() && !hasMemoryBarrier();
+    }
+
+    Schedule Schedule::build(std::span<const ScheduledPass> passes, std::span<const TransientResource> transients) {
+        verify(passes.size() <= UINT32_MAX, "Too many passes");
+        Schedule result;
+        result.passNames.reserve(passes.size());
+        result.barriers.resize(passes.size());
+
+        // lifetimes
+        for(std::uint32_t passIndex = 0; passIndex < passes.size(); passIndex++) {
+            result.passNames.push_back(passes[passIndex].name);
+            for(const ScheduledAccess& access : passes[passIndex].accesses) {
+                result.resourceNames.try_emplace(access.resourceID, access.name);
+                auto [iter, inserted] = result.lifetimes.try_emplace(access.resourceID, ResourceLifetime { passIndex, passIndex });
+                iter->second.lastPass = passIndex;
+            }
+        }
+
+        // placement of transient resources: biggest first, each one at the lowest offset which does not collide with a
+        // resource alive at the same time
+        std::vector<const TransientResource*> candidates;
+        for(const TransientResource& transient : transients) {
+            if(result.lifetimes.contains(transient.resourceID) && transient.memoryRequirements.size > 0) {
+                candidates.push_back(&transient);
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [&](const TransientResource* a, const TransientResource* b) {
+            if(a->memoryRequirements.size != b->memoryRequirements.size) {
+                return a->memoryRequirements.size > b->memoryRequirements.size;
+            }
+            return result.lifetimes[a->resourceID].firstPass < result.lifetimes[b->resourceID].firstPass;
+        });
+
+        std::vector<TransientPlacement> conflicts;
+        for(const TransientResource* pCandidate : candidates) {
+            const vk::MemoryRequirements& requirements = pCandidate->memoryRequirements;
+            if((result.heapMemoryTypeBits & requirements.memoryTypeBits) == 0) {
+                continue;
+            }
+
+            const ResourceLifetime& lifetime = result.lifetimes[pCandidate->resourceID];
+            conflicts.clear();
+            for(const auto& [otherID, otherPlacement] : result.placements) {
+                if(overlaps(lifetime, result.lifetimes[otherID])) {
+                    conflicts.push_back(otherPlacement);
+                }
+            }
+            std::sort(conflicts.begin(), conflicts.end(), [](const TransientPlacement& a, const TransientPlacement& b) {
+                return a.offset < b.offset;
+            });
+
+            const vk::DeviceSize alignment = std::max<vk::DeviceSize>(1, requirements.alignment);
+            vk::DeviceSize offset = 0;
+            for(const TransientPlacement& conflict : conflicts) {
+                if(alignUp(offset, alignment) + requirements.size <= conflict.offset) {
+                    break;
+                }
+                offset = std::max(offset, conflict.offset + conflict.size);
+            }
+            offset = alignUp(offset, alignment);
+
+            result.placements[pCandidate->resourceID] = TransientPlacement { .offset = offset, .size = requirements.size };
+            result.heapSize = std::max(result.heapSize, offset + requirements.size);
+            result.heapAlignment = std::max(result.heapAlignment, alignment);
+            result.heapMemoryTypeBits &= requirements.memoryTypeBits;
+            result.unaliasedSize += requirements.size;
+        }
+
+        // barriers
+        std::unordered_map<Carrot::UUID, ResourceState> states;
+        std::unordered_map<Carrot::UUID, ResourceState> passStates;
+        for(std::uint32_t passIndex = 0; passIndex < passes.size(); passIndex++) {
+            const ScheduledPass& pass = passes[passIndex];
+            PassBarriers& passBarriers = result.barriers[passIndex];
+
+            // what the previous users of the memory of an aliased resource did with it, which must be finished before reusing it
+            auto getPreviousOccupants = [&](const Carrot::UUID& resourceID) {
+                StageAccess previousOccupants;
+                const TransientPlacement& placement = result.placements.at(resourceID);
+                for(const auto& [otherID, otherPlacement] : result.placements) {
+                    if(otherID == resourceID || result.lifetimes[otherID].lastPass >= passIndex || !overlaps(placement, otherPlacement)) {
+                        continue;
+                    }
+                    const ResourceState& otherState = states.at(otherID);
+                    previousOccupants.stages |= otherState.lastUse.stages;
+                    previousOccupants.access |= otherState.lastUse.access & WriteAccesses;
+                }
+                return previousOccupants;
+            };
+
+            for(const ScheduledAccess& access : pass.accesses) {
+                const StageAccess dst = inferStageAccess(pass, access);
+                const bool firstUseOfAliased = result.placements.contains(access.resourceID) && result.lifetimes[access.resourceID].firstPass == passIndex;
+                auto stateIter = states.find(access.resourceID);
+
+                if(!access.isBuffer) {
+                    // contents of aliased resources do not survive from one use to the next: start from an undefined layout
+                    const vk::ImageLayout from = firstUseOfAliased ? vk::ImageLayout::eUndefined : access.previousLayout;
+                    const vk::ImageLayout to = access.isAttachment ? access.previousLayout : access.layout;
+                    if(from != to && to != vk::ImageLayout::eUndefined) {
+                        auto existing = std::find_if(passBarriers.images.begin(), passBarriers.images.end(), [&](const ScheduledImageBarrier& b) {
+                            return b.resourceID == access.resourceID;
+                        });
+                        if(existing != passBarriers.images.end()) {
+                            // resource is used multiple times by this pass, the first transition wins
+                            existing->dstStages |= dst.stages;
+                            existing->dstAccess |= dst.access;
+                            continue;
+                        }
+
+                        StageAccess src;
+                        if(firstUseOfAliased) {
+                            src = getPreviousOccupants(access.resourceID);
+                        } else if(stateIter != states.end()) {
+                            src = stateIter->second.lastUse;
+                            src.access &= WriteAccesses;
+                        } else {
+                            // first use in this frame, last use is unknown (previous frame, or outside of the graph)
+                            src = { Stage::eAllCommands, Access::eMemoryWrite };
+                        }
+                        passBarriers.images.emplace_back(ScheduledImageBarrier {
+                            .resourceID = access.resourceID,
+                            .oldLayout = from,
+                            .newLayout = to,
+                            .aspect = access.aspect,
+                            .srcStages = src.stages,
+                            .srcAccess = src.access,
+                            .dstStages = dst.stages,
+                            .dstAccess = dst.access,
+                        });
+                        continue;
+                    }
+                }
+
+                if(access.clearEachFrame) {
+                    passBarriers.srcStages |= Stage::eTransfer;
+                    passBarriers.srcAccess |= Access::eTransferWrite;
+                    passBarriers.dstStages |= dst.stages;
+                    passBarriers.dstAccess |= dst.access;
+                }
+
+                if(firstUseOfAliased) {
+                    const StageAccess src = getPreviousOccupants(access.resourceID);
+                    if(src.stages) {
+                        passBarriers.srcStages |= src.stages;
+                        passBarriers.srcAccess |= src.access;
+                        passBarriers.dstStages |= dst.stages;
+                        passBarriers.dstAccess |= dst.access;
+                    }
+                    continue;
+                }
+
+                if(stateIter == states.end()) {
+                    continue;
+                }
+                const ResourceState& previous = stateIter->second;
+                if(previous.written) { // read-after-write or write-after-write: make the writes visible
+                    passBarriers.srcStages |= previous.lastUse.stages;
+                    passBarriers.srcAccess |= previous.lastUse.access & WriteAccesses;
+                    passBarriers.dstStages |= dst.stages;
+                    passBarriers.dstAccess |= dst.access;
+                } else if(mayWrite(access)) { // write-after-read: execution dependency is enough
+                    passBarriers.srcStages |= previous.lastUse.stages;
+                    passBarriers.dstStages |= dst.stages;
+                }
+            }
+
+            // state changes are applied once the whole pass is processed: accesses inside a pass are not ordered
+            passStates.clear();
+            for(const ScheduledAccess& access : pass.accesses) {
+                const StageAccess stageAccess = inferStageAccess(pass, access);
+                ResourceState& state = passStates[access.resourceID];
+                state.lastUse.stages |= stageAccess.stages;
+                state.lastUse.access |= stageAccess.access;
+                state.written |= mayWrite(access);
+            }
+            for(auto& [resourceID, state] : passStates) {
+                states[resourceID] = state;
+            }
+        }
+
+        return result;
+    }
+
+    std::size_t Schedule::getPassCount() const {
+        return barriers.size();
+    }
+
+    const PassBarriers& Schedule::getBarriers(std::size_t passIndex) const {
+        verify(passIndex < barriers.size(), "Out of bounds pass index");
+        return barriers[passIndex];
+    }
+
+    const ResourceLifetime* Schedule::getLifetime(const Carrot::UUID& resourceID) const {
+        auto iter = lifetimes.find(resourceID);
+        return iter == lifetimes.end() ? nullptr : &iter->second;
+    }
+
+    const TransientPlacement* Schedule::getPlacement(const Carrot::UUID& resourceID) const {
+        auto iter = placements.find(resourceID);
+        return iter == placements.end() ? nullptr : &iter->second;
+    }
+
+    vk::DeviceSize Schedule::getHeapSize() const {
+        return heapSize;
+    }
+
+    vk::DeviceSize Schedule::getHeapAlignment() const {
+        return heapAlignment;
+    }
+
+    std::uint32_t Schedule::getHeapMemoryTypeBits() const {
+        return heapMemoryTypeBits;
+    }
+
+    vk::DeviceSize Schedule::getUnaliasedSize() const {
+        return unaliasedSize;
+    }
+
+    std::string Schedule::describe() const {
+        auto getName = [&](const Carrot::UUID& resourceID) -> std::string {
+            auto iter = resourceNames.find(resourceID);
+            return iter == resourceNames.end() ? resourceID.toString() : iter->second;
+        };
+
+        std::string result;
+        for(std::size_t passIndex = 0; passIndex < barriers.size(); passIndex++) {
+            const PassBarriers& passBarriers = barriers[passIndex];
+            result += Carrot::sprintf("Pass %llu: %s\n", static_cast<unsigned long long>(passIndex), passNames[passIndex].c_str());
+            for(const ScheduledImageBarrier& image : passBarriers.images) {
+                result += Carrot::sprintf("    %s: %s -> %s (src %s %s, dst %s %s)\n", getName(image.resourceID).c_str(),
+                                          to_string(image.oldLayout).c_str(), to_string(image.newLayout).c_str(),
+                                          to_string(image.srcStages).c_str(), to_string(image.srcAccess).c_str(),
+                                          to_string(image.dstStages).c_str(), to_string(image.dstAccess).c_str());
+            }
+            if(passBarriers.hasMemoryBarrier()) {
+                result += Carrot::sprintf("    memory (src %s %s, dst %s %s)\n",
+                                          to_string(passBarriers.srcStages).c_str(), to_string(passBarriers.srcAccess).c_str(),
+                                          to_string(passBarriers.dstStages).c_str(), to_string(passBarriers.dstAccess).c_str());
+            }
+        }
+
+        result += Carrot::sprintf("Transient heap: %llu bytes (%llu bytes without aliasing)\n",
+                                  static_cast<unsigned long long>(heapSize), static_cast<unsigned long long>(unaliasedSize));
+        for(const auto& [resourceID, placement] : placements) {
+            const ResourceLifetime& lifetime = lifetimes.at(resourceID);
+            result += Carrot::sprintf("    %s: passes [%u; %u], offset %llu, size %llu\n", getName(resourceID).c_str(),
+                                      lifetime.firstPass, lifetime.lastPass,
+                                      static_cast<unsigned long long>(placement.offset), static_cast<unsigned long long>(placement.size));
+        }
+        return result;
+    }
+}
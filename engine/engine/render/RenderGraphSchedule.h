@@ -0,0 +1,137 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+#include "core/utils/UUID.h"
+
+namespace Carrot::Render {
+    /// How a pass uses a resource, as seen by the schedule
+    struct ScheduledAccess {
+        Carrot::UUID resourceID; //< root ID of the resource
+        std::string name; //< for debugging
+        bool isBuffer = false;
+        bool write = false;
+
+        /// Layout before this access, and layout used by this access. Ignored for buffers
+        vk::ImageLayout previousLayout = vk::ImageLayout::eUndefined;
+        vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+        vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+
+        /// Attachment of a render pass: the render pass transitions the image from 'previousLayout' to 'layout' by itself
+        bool isAttachment = false;
+
+        /// Buffer is filled with 0 by the pass before its barrier (see CompiledPass::performTransitions)
+        bool clearEachFrame = false;
+    };
+
+    /// Pass to schedule, in execution order
+    struct ScheduledPass {
+        std::string name;
+        bool rasterized = true;
+
+        /// Stages in which the shaders of this pass run (vertex+fragment for rasterized passes, compute and raytracing otherwise)
+        vk::PipelineStageFlags2KHR shaderStages;
+        std::vector<ScheduledAccess> accesses;
+    };
+
+    /// Resource which is allowed to share its memory with others, as long as their lifetimes do not overlap
+    struct TransientResource {
+        Carrot::UUID resourceID;
+        vk::MemoryRequirements memoryRequirements;
+    };
+
+    /// Layout transition emitted at the start of a pass
+    struct ScheduledImageBarrier {
+        Carrot::UUID resourceID;
+        vk::ImageLayout oldLayout = vk::ImageLayout::eUndefined;
+        vk::ImageLayout newLayout = vk::ImageLayout::eUndefined;
+        vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+        vk::PipelineStageFlags2KHR srcStages;
+        vk::AccessFlags2KHR srcAccess;
+        vk::PipelineStageFlags2KHR dstStages;
+        vk::AccessFlags2KHR dstAccess;
+    };
+
+    /// All synchronisation needed at the start of a pass, meant to be recorded as a single vkCmdPipelineBarrier2
+    struct PassBarriers {
+        std::vector<ScheduledImageBarrier> images;
+
+        /// Global memory barrier, for hazards which do not need a layout transition (buffers, storage images...)
+        vk::PipelineStageFlags2KHR srcStages;
+        vk::AccessFlags2KHR srcAccess;
+        vk::PipelineStageFlags2KHR dstStages;
+        vk::AccessFlags2KHR dstAccess;
+
+        bool hasMemoryBarrier() const;
+        bool empty() const;
+    };
+
+    /// Index of the first and last pass which access a resource
+    struct ResourceLifetime {
+        std::uint32_t firstPass = 0;
+        std::uint32_t lastPass = 0;
+    };
+
+    /// Where a transient resource lives inside the transient memory heap
+    struct TransientPlacement {
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+    };
+
+    /**
+     * Result of the compilation of a render graph: lifetimes of resources, barriers between passes and placement of
+     * transient resources in a shared memory heap.
+     * Does not touch the GPU, and can be built and inspected without a device.
+     */
+    class Schedule {
+    public:
+        Schedule() = default;
+
+        /**
+         * Computes the schedule of the given passes
+         * \param passes passes, in execution order
+         * \param transients resources which can be aliased. Resources which are not accessed by any pass, or whose
+         *  memory type is incompatible with the other transients, keep their own memory (they get no placement)
+         */
+        static Schedule build(std::span<const ScheduledPass> passes, std::span<const TransientResource> transients);
+
+    public:
+        std::size_t getPassCount() const;
+        const PassBarriers& getBarriers(std::size_t passIndex) const;
+
+        /// nullptr if the resource is not accessed by any pass
+        const ResourceLifetime* getLifetime(const Carrot::UUID& resourceID) const;
+
+        /// nullptr if the resource does not live inside the transient heap
+        const TransientPlacement* getPlacement(const Carrot::UUID& resourceID) const;
+
+        /// Size of the memory heap that must be allocated for the transient resources. 0 if there are none
+        vk::DeviceSize getHeapSize() const;
+        vk::DeviceSize getHeapAlignment() const;
+        std::uint32_t getHeapMemoryTypeBits() const;
+
+        /// Memory that transient resources would use if they were not aliased
+        vk::DeviceSize getUnaliasedSize() const;
+
+        /// Human-readable dump of the schedule, for debugging
+        std::string describe() const;
+
+    private:
+        std::vector<std::string> passNames;
+        std::vector<PassBarriers> barriers;
+        std::unordered_map<Carrot::UUID, ResourceLifetime> lifetimes;
+        std::unordered_map<Carrot::UUID, TransientPlacement> placements;
+        std::unordered_map<Carrot::UUID, std::string> resourceNames;
+        vk::DeviceSize heapSize = 0;
+        vk::DeviceSize heapAlignment = 1;
+        std::uint32_t heapMemoryTypeBits = ~0u;
+        vk::DeviceSize unaliasedSize = 0;
+    };
+}
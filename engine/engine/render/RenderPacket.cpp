@@ -40,7 +40,7 @@ namespace Carrot::Render {
         vertexBuffer = mesh.getVertexBuffer();
         indexBuffer = mesh.getIndexBuffer();
 
-        auto& cmd = commands.empty() ? commands.emplace_back().drawIndexedInstanced : commands[0].drawIndexedInstanced;
+        auto& cmd = commands.empty() ? commands.emplaceBack().drawIndexedInstanced : commands[0].drawIndexedInstanced;
         cmd.indexCount = mesh.getIndexCount();
         cmd.instanceCount = 1;
     }
@@ -130,11 +130,11 @@ namespace Carrot::Render {
         return false; // TODO: fix packet merging
     }
 
-    void Packet::record(Carrot::Allocator& tempAllocator, vk::RenderPass pass, const Carrot::Render::Context& renderContext, vk::CommandBuffer& cmds, const Packet* previousPacket) const {
+    bool Packet::record(Carrot::Allocator& tempAllocator, vk::RenderPass pass, const Carrot::Render::Context& renderContext, vk::CommandBuffer& cmds, const Packet* previousPacket) const {
         ZoneScoped;
 
         if(commands.empty()) {
-            return; // nothing to draw
+            return false; // nothing to draw
         }
 
         if(false)
@@ -149,6 +149,10 @@ namespace Carrot::Render {
         const bool isCompute = packetType == PacketType::Compute;
         const vk::PipelineBindPoint bindPoint = isCompute ? vk::PipelineBindPoint::eCompute : vk::PipelineBindPoint::eGraphics;
 
+        if(!pipeline->isReadyToBind(pass)) {
+            return false; // pipeline variant is still compiling on a worker thread, skip this packet for now
+        }
+
         const bool skipPipelineBind = previousPacket != nullptr
                 && previousPacket->pipeline == pipeline;
         std::vector<std::uint32_t> dynamicOffsets;
@@ -283,6 +287,7 @@ namespace Carrot::Render {
             default:
                 verify(false, "Don't know what to do :(");
         }
+        return true;
     }
 
     std::span<std::uint8_t> Packet::allocateGeneric(std::size_t size) {
@@ -334,6 +339,7 @@ namespace Carrot::Render {
         instanceCount = std::move(toMove.instanceCount);
 
         transparentGBuffer = std::move(toMove.transparentGBuffer);
+        sortKey = toMove.sortKey;
 
         source = std::move(toMove.source);
         instancingDataBuffer = std::move(toMove.instancingDataBuffer);
@@ -363,6 +369,7 @@ namespace Carrot::Render {
         instanceCount = toCopy.instanceCount;
 
         transparentGBuffer = toCopy.transparentGBuffer;
+        sortKey = toCopy.sortKey;
 
         source = toCopy.source;
 
@@ -10,6 +10,8 @@
 #include <list>
 #include <span>
 #include <core/Allocator.h>
+#include <core/allocators/FrameArenaAllocator.h>
+#include <core/containers/Vector.hpp>
 
 #include "resources/Buffer.h"
 #include "resources/BufferView.h"
@@ -97,7 +99,7 @@ namespace Carrot::Render {
         std::uint32_t instanceCount = 1; // Total number of instances for this packet, used to offset firstInstance when merging packets
 
         PacketType packetType = PacketType::Unknown;
-        std::vector<PacketCommand> commands;
+        Carrot::Vector<PacketCommand> commands { FrameArenaAllocator::get() }; // packets only live for a few frames
 
         TransparentPassData transparentGBuffer;
 
@@ -106,6 +108,9 @@ namespace Carrot::Render {
         std::optional<vk::Viewport> viewportExtents;
         std::optional<vk::Rect2D> scissor;
 
+        /// Packed viewport, pass, z-order, pipeline, mesh and material. Filled by VulkanRenderer when sorting packets, see VulkanRenderer::sortRenderPackets
+        std::uint64_t sortKey = 0;
+
     public:
         explicit Packet(PacketContainer& container, PassName pass, const Render::PacketType& packetType, std::source_location location = std::source_location::current());
 
@@ -142,7 +147,8 @@ namespace Carrot::Render {
         /// \param renderContext
         /// \param commands
         /// \param previousRenderPacket if you know the proper state is already bound, you can skip its bind thanks to this parameter to save time
-        void record(Carrot::Allocator& tempAllocator, vk::RenderPass pass, const Carrot::Render::Context& renderContext, vk::CommandBuffer& commands, const Packet* previousRenderPacket) const;
+        /// \return false if nothing was recorded (no commands, or pipeline still compiling). In that case, this packet must not be used as 'previousRenderPacket'
+        bool record(Carrot::Allocator& tempAllocator, vk::RenderPass pass, const Carrot::Render::Context& renderContext, vk::CommandBuffer& commands, const Packet* previousRenderPacket) const;
 
     private:
         std::span<std::uint8_t> allocateGeneric(std::size_t size);
@@ -20,7 +20,7 @@ Carrot::Render::CompiledPass::CompiledPass(
         vk::UniqueRenderPass&& renderPass,
         const std::vector<vk::ClearValue>& clearValues,
         const CompiledPassCallback& renderingCode,
-        std::vector<ImageTransition>&& prePassTransitions,
+        PassBarriers barriers,
         InitCallback initCallback,
         SwapchainRecreationCallback swapchainCallback,
         bool prerecordable,
@@ -31,7 +31,7 @@ Carrot::Render::CompiledPass::CompiledPass(
         renderPass(std::move(renderPass)),
         clearValues(clearValues),
         renderingCode(renderingCode),
-        prePassTransitions(prePassTransitions),
+        barriers(std::move(barriers)),
         initCallback(std::move(initCallback)),
         swapchainRecreationCallback(std::move(swapchainCallback)),
         name(std::move(name)),
@@ -52,7 +52,7 @@ Carrot::Render::CompiledPass::CompiledPass(
         std::string name,
         const vk::Extent2D& viewportSize,
         const CompiledPassCallback& renderingCode,
-        std::vector<ImageTransition>&& prePassTransitions,
+        PassBarriers barriers,
         InitCallback initCallback,
         SwapchainRecreationCallback swapchainCallback,
         bool prerecordable,
@@ -62,7 +62,7 @@ Carrot::Render::CompiledPass::CompiledPass(
         framebuffers(),
         renderPass(),
         renderingCode(renderingCode),
-        prePassTransitions(prePassTransitions),
+        barriers(std::move(barriers)),
         initCallback(std::move(initCallback)),
         swapchainRecreationCallback(std::move(swapchainCallback)),
         name(std::move(name)),
@@ -80,37 +80,75 @@ Carrot::Render::CompiledPass::CompiledPass(
 
 void Carrot::Render::CompiledPass::performTransitions(const Render::Context& renderContext, vk::CommandBuffer& cmds) {
     { // TODO: pre-record
-        ZoneScopedN("Pre-Pass Layout transitions");
+        ZoneScopedN("Pre-Pass barriers");
 
-        // TODO: batch transitions
-        for(const auto& transition : prePassTransitions) {
-            auto& tex = graph.getTexture(transition.resourceID, renderContext.swapchainIndex);
-            tex.assumeLayout(transition.from);
-            tex.transitionInline(cmds, transition.to, transition.aspect);
-        }
-
-        Carrot::Vector<vk::BufferMemoryBarrier> bufferBarriers;
+        // fills are made visible to this pass by the barrier below (see ScheduledAccess::clearEachFrame)
         for(std::size_t i = 0; i < outputs.size(); i++) {
             if(needBufferClearEachFrame[i]) {
                 auto& buffer = graph.getBuffer(outputs[i], renderContext.frameCount);
                 cmds.fillBuffer(buffer.view.getVulkanBuffer(), buffer.view.getStart(), buffer.view.getSize(), 0);
-                bufferBarriers.emplaceBack(vk::BufferMemoryBarrier {
-                    .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
-                    .dstAccessMask = vk::AccessFlagBits::eMemoryRead,
-                    .buffer = buffer.view.getVulkanBuffer(),
-                    .offset = buffer.view.getStart(),
-                    .size = buffer.view.getSize(),
-                });
             }
         }
 
-        if (!bufferBarriers.empty()) {
-            cmds.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eBottomOfPipe, static_cast<vk::DependencyFlags>(0), {},
-                bufferBarriers, {});
+        if(barriers.empty()) {
+            return;
+        }
+
+        Carrot::Vector<vk::ImageMemoryBarrier2KHR> imageBarriers;
+        imageBarriers.setCapacity(barriers.images.size());
+        for(const auto& barrier : barriers.images) {
+            auto& tex = graph.getTexture(findResource(barrier.resourceID), renderContext.swapchainIndex);
+            imageBarriers.emplaceBack(vk::ImageMemoryBarrier2KHR {
+                .srcStageMask = barrier.srcStages,
+                .srcAccessMask = barrier.srcAccess,
+                .dstStageMask = barrier.dstStages,
+                .dstAccessMask = barrier.dstAccess,
+                .oldLayout = barrier.oldLayout,
+                .newLayout = barrier.newLayout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = tex.getVulkanImage(),
+                .subresourceRange = {
+                    .aspectMask = barrier.aspect,
+                    .baseMipLevel = 0,
+                    .levelCount = VK_REMAINING_MIP_LEVELS,
+                    .baseArrayLayer = 0,
+                    .layerCount = VK_REMAINING_ARRAY_LAYERS,
+                },
+            });
+            tex.assumeLayout(barrier.newLayout);
         }
+
+        vk::MemoryBarrier2KHR memoryBarrier {
+            .srcStageMask = barriers.srcStages,
+            .srcAccessMask = barriers.srcAccess,
+            .dstStageMask = barriers.dstStages,
+            .dstAccessMask = barriers.dstAccess,
+        };
+        cmds.pipelineBarrier2KHR(vk::DependencyInfoKHR {
+            .memoryBarrierCount = barriers.hasMemoryBarrier() ? 1u : 0u,
+            .pMemoryBarriers = &memoryBarrier,
+            .imageMemoryBarrierCount = static_cast<std::uint32_t>(imageBarriers.size()),
+            .pImageMemoryBarriers = imageBarriers.data(),
+        });
     }
 }
 
+const Carrot::Render::FrameResource& Carrot::Render::CompiledPass::findResource(const Carrot::UUID& rootID) const {
+    auto isResource = [&](const FrameResource& r) { return r.rootID == rootID; };
+    auto inputIter = std::find_if(WHOLE_CONTAINER(inputs), isResource);
+    if(inputIter != inputs.end()) {
+        return *inputIter;
+    }
+    auto outputIter = std::find_if(WHOLE_CONTAINER(outputs), isResource);
+    verify(outputIter != outputs.end(), Carrot::sprintf("Resource %s is not used by pass %s", rootID.toString().c_str(), name.c_str()));
+    return *outputIter;
+}
+
+void Carrot::Render::CompiledPass::setBarriers(PassBarriers barriers) {
+    this->barriers = std::move(barriers);
+}
+
 void Carrot::Render::CompiledPass::execute(const Render::Context& renderContext, vk::CommandBuffer& cmds) {
     // TODO: allow whole execute to be pre-recorded?
 
@@ -185,25 +223,13 @@ void Carrot::Render::PassBase::present(FrameResource& toPresent) {
     output->resource.layout = vk::ImageLayout::ePresentSrcKHR;
 }
 
-std::unique_ptr<Carrot::Render::CompiledPass> Carrot::Render::PassBase::compile(Carrot::VulkanDriver& driver, Carrot::Window& window, Carrot::Render::Graph& graph) {
+std::unique_ptr<Carrot::Render::CompiledPass> Carrot::Render::PassBase::compile(Carrot::VulkanDriver& driver, Carrot::Window& window, Carrot::Render::Graph& graph, const PassBarriers& barriers) {
     // TODO: input and output can be the same attachment (subpasses)
     std::vector<vk::AttachmentDescription> attachments;
     std::vector<vk::AttachmentReference> inputAttachments;
     std::vector<vk::AttachmentReference> outputAttachments;
     std::unique_ptr<vk::AttachmentReference> depthAttachmentRef = nullptr;
 
-    std::vector<ImageTransition> prePassTransitions;
-    for(const auto& input : inputs) {
-        auto initialLayout = input.resource.previousLayout;//graph.getFinalLayouts()[input.resource.parentID]; // input is not the resource itself, but a new instance returned by read()
-        //assert(initialLayout != vk::ImageLayout::eUndefined);
-        if(initialLayout != input.expectedLayout) {
-            auto it = std::find_if(WHOLE_CONTAINER(prePassTransitions), [&](const auto& e) { return e.resourceID == input.resource.rootID; });
-            if(it == prePassTransitions.end()) {
-                prePassTransitions.emplace_back(input.resource.rootID, initialLayout, input.resource.layout, input.aspect);
-            }
-        }
-    }
-
     std::vector<vk::ClearValue> clearValues;
     for(const auto& output : outputs) {
         if(output.resource.type != ResourceType::RenderTarget) {
@@ -374,7 +400,7 @@ std::unique_ptr<Carrot::Render::CompiledPass> Carrot::Render::PassBase::compile(
             return framebuffers;
         };
         result = std::make_unique<CompiledPass>(graph, name, viewportSize, std::move(renderPass), clearValues,
-                                         generateCallback(), std::move(prePassTransitions), init, generateSwapchainCallback(), prerecordable, passID);
+                                         generateCallback(), barriers, init, generateSwapchainCallback(), prerecordable, passID);
     } else {
         auto init = [resetBuffers, outputs = outputs](CompiledPass& pass, const vk::Extent2D& viewportSize, vk::Extent2D& renderSize) {
             for (int i = 0; i < pass.getVulkanDriver().getSwapchainImageCount(); ++i) {
@@ -394,13 +420,54 @@ std::unique_ptr<Carrot::Render::CompiledPass> Carrot::Render::PassBase::compile(
             renderSize.height = 0;
             return std::vector<vk::UniqueFramebuffer>{}; // no framebuffers for non-rasterized passes
         };
-        result = make_unique<CompiledPass>(graph, name, viewportSize, generateCallback(), std::move(prePassTransitions), init, generateSwapchainCallback(), prerecordable, passID);
+        result = make_unique<CompiledPass>(graph, name, viewportSize, generateCallback(), barriers, init, generateSwapchainCallback(), prerecordable, passID);
     }
     result->setInputsOutputsForDebug(inputs, outputs);
     postCompile(*result);
     return result;
 }
 
+Carrot::Render::ScheduledPass Carrot::Render::PassBase::getScheduledPass() const {
+    ScheduledPass result {
+        .name = name,
+        .rasterized = rasterized,
+    };
+    if(rasterized) {
+        result.shaderStages = vk::PipelineStageFlagBits2KHR::eVertexShader | vk::PipelineStageFlagBits2KHR::eFragmentShader;
+    } else {
+        result.shaderStages = vk::PipelineStageFlagBits2KHR::eComputeShader;
+        if(GetCapabilities().supportsRaytracing) {
+            result.shaderStages |= vk::PipelineStageFlagBits2KHR::eRayTracingShaderKHR;
+        }
+    }
+
+    for(const auto& input : inputs) {
+        result.accesses.emplace_back(ScheduledAccess {
+            .resourceID = input.resource.rootID,
+            .name = input.resource.name,
+            .isBuffer = input.resource.type == ResourceType::StorageBuffer,
+            .write = false,
+            .previousLayout = input.resource.previousLayout,
+            .layout = input.resource.layout,
+            .aspect = input.aspect,
+        });
+    }
+    for(const auto& output : outputs) {
+        result.accesses.emplace_back(ScheduledAccess {
+            .resourceID = output.resource.rootID,
+            .name = output.resource.name,
+            .isBuffer = output.resource.type == ResourceType::StorageBuffer,
+            .write = true,
+            .previousLayout = output.resource.previousLayout,
+            .layout = output.resource.layout,
+            .aspect = output.aspect,
+            .isAttachment = rasterized && output.resource.type == ResourceType::RenderTarget,
+            .clearEachFrame = output.clearBufferEachFrame,
+        });
+    }
+    return result;
+}
+
 void Carrot::Render::CompiledPass::setInputsOutputsForDebug(const std::list<Input>& _inputs, const std::list<Output>& _outputs) {
     inputs.reserve(_inputs.size());
     outputs.reserve(_outputs.size());
@@ -444,6 +511,12 @@ void Carrot::Render::CompiledPass::onSwapchainSizeChange(Window& window, int new
     }
 }
 
+Carrot::Render::CompiledPass::~CompiledPass() {
+    if(renderPass) {
+        GetRenderer().forgetRenderPass(*renderPass);
+    }
+}
+
 Carrot::VulkanDriver& Carrot::Render::CompiledPass::getVulkanDriver() const {
     return graph.getVulkanDriver();
 }
@@ -9,6 +9,7 @@
 #include "engine/render/resources/Texture.h"
 #include "core/utils/UUID.h"
 #include "engine/render/RenderPassData.h"
+#include "engine/render/RenderGraphSchedule.h"
 #include <any>
 
 namespace Carrot::Render {
@@ -40,15 +41,6 @@ namespace Carrot::Render {
         Output(const FrameResource& resource, vk::AttachmentLoadOp loadOp, vk::ClearValue clearValue, vk::ImageAspectFlags aspect): resource(resource), loadOp(loadOp), clearValue(clearValue), aspect(aspect) {}
     };
 
-    struct ImageTransition {
-        Carrot::UUID resourceID;
-        vk::ImageLayout from;
-        vk::ImageLayout to;
-        vk::ImageAspectFlags aspect;
-
-        explicit ImageTransition(Carrot::UUID resourceID, vk::ImageLayout from, vk::ImageLayout to, vk::ImageAspectFlags aspect): resourceID(resourceID), from(from), to(to), aspect(aspect) {}
-    };
-
     class CompiledPass: public SwapchainAware {
     public:
         using InitCallback = std::function<std::vector<vk::UniqueFramebuffer>(CompiledPass&, const vk::Extent2D&, vk::Extent2D&)>;
@@ -61,7 +53,7 @@ namespace Carrot::Render {
                 vk::UniqueRenderPass&& renderPass,
                 const std::vector<vk::ClearValue>& clearValues,
                 const CompiledPassCallback& renderingCode,
-                std::vector<ImageTransition>&& prePassTransitions,
+                PassBarriers barriers,
                 InitCallback initCallback,
                 SwapchainRecreationCallback swapchainCallback,
                 bool prerecordable,
@@ -74,13 +66,15 @@ namespace Carrot::Render {
                 std::string name,
                 const vk::Extent2D& viewportSize,
                 const CompiledPassCallback& renderingCode,
-                std::vector<ImageTransition>&& prePassTransitions,
+                PassBarriers barriers,
                 InitCallback initCallback,
                 SwapchainRecreationCallback swapchainCallback,
                 bool prerecordable,
                 const Carrot::UUID& passID
         );
 
+        ~CompiledPass();
+
     public:
         void execute(const Render::Context& data, vk::CommandBuffer& cmds);
 
@@ -101,6 +95,10 @@ namespace Carrot::Render {
         std::span<const FrameResource> getOutputs() const { return outputs; }
         std::span<const FrameResource> getInputOutputs() const { return inouts; }
 
+        /// Barriers recorded before this pass, computed by the graph schedule
+        const PassBarriers& getBarriers() const { return barriers; }
+        void setBarriers(PassBarriers barriers);
+
         void refresh();
 
     public:
@@ -117,6 +115,7 @@ namespace Carrot::Render {
         void createCommandBuffers(const Render::Context& renderContext);
         void recordCommands(const Render::Context& renderContext);
         void performTransitions(const Render::Context& renderContext, vk::CommandBuffer& cmds);
+        const FrameResource& findResource(const Carrot::UUID& rootID) const;
 
     private:
         Graph& graph;
@@ -126,7 +125,7 @@ namespace Carrot::Render {
         std::vector<vk::UniqueFramebuffer> framebuffers;
         vk::UniqueRenderPass renderPass;
         std::vector<vk::ClearValue> clearValues;
-        std::vector<ImageTransition> prePassTransitions;
+        PassBarriers barriers;
         CompiledPassCallback renderingCode;
         InitCallback initCallback;
         SwapchainRecreationCallback swapchainRecreationCallback;
@@ -172,9 +171,13 @@ namespace Carrot::Render {
          * @param driver
          * @param window window for which this pass will be used. Mostly used to know the size of the framebuffer
          * @param graph
+         * @param barriers barriers to record before this pass, computed by the graph schedule
          * @return
          */
-        std::unique_ptr<CompiledPass> compile(Carrot::VulkanDriver& driver, Window& window, Graph& graph);
+        std::unique_ptr<CompiledPass> compile(Carrot::VulkanDriver& driver, Window& window, Graph& graph, const PassBarriers& barriers);
+
+        /// How this pass uses its resources, for the graph schedule
+        ScheduledPass getScheduledPass() const;
 
     protected:
         Carrot::VulkanDriver& driver;
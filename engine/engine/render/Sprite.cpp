@@ -99,5 +99,6 @@ namespace Carrot::Render {
         verify(this->texture != nullptr, "Cannot create sprite with no texture");
         material = GetRenderer().getMaterialSystem().createMaterialHandle();
         material->albedo = GetRenderer().getMaterialSystem().createTextureHandle(texture);
+        material->markDirty();
     }
 }
\ No newline at end of file
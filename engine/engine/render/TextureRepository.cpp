@@ -46,7 +46,6 @@ namespace Carrot::Render {
 
     Texture& ResourceRepository::createTexture(const FrameResource& resource, size_t frameIndex, vk::ImageUsageFlags textureUsages, const vk::Extent2D& viewportSize) {
         verify(resource.type == ResourceType::StorageImage || resource.type == ResourceType::RenderTarget, Carrot::sprintf("Resource %s is not a texture", resource.name.c_str()));
-        // TODO: aliasing
         if(textures.empty()) {
             textures.resize(driver.getSwapchainImageCount());
         }
@@ -58,28 +57,24 @@ namespace Carrot::Render {
 
         auto it = textures[frameIndex].find(resource.rootID);
         if(it == textures[frameIndex].end()) {
-            vk::Extent3D size;
-            switch(resource.size.type) {
-                case TextureSize::Type::SwapchainProportional: {
-                    size.width = static_cast<std::uint32_t>(resource.size.width * viewportSize.width);
-                    size.height = static_cast<std::uint32_t>(resource.size.height * viewportSize.height);
-                    size.depth = static_cast<std::uint32_t>(resource.size.depth * 1);
-                } break;
-
-                case TextureSize::Type::Fixed: {
-                    size.width = static_cast<std::uint32_t>(resource.size.width);
-                    size.height = static_cast<std::uint32_t>(resource.size.height);
-                    size.depth = static_cast<std::uint32_t>(resource.size.depth);
-                } break;
-            }
+            const vk::Extent3D size = computeTextureSize(resource, viewportSize);
             auto format = resource.format;
 
             verify(resource.imageOrigin == Render::ImageOrigin::Created, "Must be an explicitely created texture");
-            Texture::Ref texture = std::make_shared<Texture>(driver,
-                                                size,
-                                                textureUsages,
-                                                format
-            );
+            Texture::Ref texture;
+            auto placementIter = aliasedPlacements.find(resource.rootID);
+            if(placementIter != aliasedPlacements.end()) {
+                const AliasedPlacement& placement = placementIter->second;
+                texture = std::make_shared<Texture>(std::make_unique<Image>(driver, size, textureUsages, format, placement.heaps[frameIndex], placement.offset));
+                // memory may have been used by another texture, contents are undefined
+                texture->assumeLayout(vk::ImageLayout::eUndefined);
+            } else {
+                texture = std::make_shared<Texture>(driver,
+                                                    size,
+                                                    textureUsages,
+                                                    format
+                );
+            }
             texture->name(resource.name + " (RenderGraph)");
             textures[frameIndex][resource.rootID] = std::move(texture);
         } else {
@@ -89,6 +84,36 @@ namespace Carrot::Render {
         return getTexture(resource, frameIndex);
     }
 
+    vk::Extent3D ResourceRepository::computeTextureSize(const FrameResource& resource, const vk::Extent2D& viewportSize) {
+        vk::Extent3D size;
+        switch(resource.size.type) {
+            case TextureSize::Type::SwapchainProportional: {
+                size.width = static_cast<std::uint32_t>(resource.size.width * viewportSize.width);
+                size.height = static_cast<std::uint32_t>(resource.size.height * viewportSize.height);
+                size.depth = static_cast<std::uint32_t>(resource.size.depth * 1);
+            } break;
+
+            case TextureSize::Type::Fixed: {
+                size.width = static_cast<std::uint32_t>(resource.size.width);
+                size.height = static_cast<std::uint32_t>(resource.size.height);
+                size.depth = static_cast<std::uint32_t>(resource.size.depth);
+            } break;
+        }
+        return size;
+    }
+
+    void ResourceRepository::setAliasedPlacement(const Carrot::UUID& id, const std::vector<std::shared_ptr<DeviceMemory>>& heaps, vk::DeviceSize offset) {
+        verify(heaps.size() == driver.getSwapchainImageCount(), "Need one heap per swapchain image");
+        aliasedPlacements[id] = AliasedPlacement {
+            .heaps = heaps,
+            .offset = offset,
+        };
+    }
+
+    void ResourceRepository::removeAliasedPlacement(const Carrot::UUID& id) {
+        aliasedPlacements.erase(id);
+    }
+
     static BufferAllocation makeBufferAlloc(const FrameResource& buffer, vk::BufferUsageFlags usages) {
         BufferAllocation alloc = GetResourceAllocator().allocateDeviceBuffer(buffer.bufferSize, usages);
         alloc.name(buffer.name);
@@ -31,6 +31,14 @@ namespace Carrot::Render {
         Texture& getOrCreateTexture(const FrameResource& id, size_t swapchainIndex, vk::ImageUsageFlags textureUsages, const vk::Extent2D& viewportSize);
         vk::ImageUsageFlags& getTextureUsages(const Carrot::UUID& id);
 
+        /// Size of the texture created for the given resource
+        static vk::Extent3D computeTextureSize(const FrameResource& texture, const vk::Extent2D& viewportSize);
+
+        /// Textures created for the resource with the given ID will be bound to heaps[swapchainIndex] at 'offset', instead
+        /// of allocating their own memory. Does not affect textures which already exist.
+        void setAliasedPlacement(const Carrot::UUID& id, const std::vector<std::shared_ptr<DeviceMemory>>& heaps, vk::DeviceSize offset);
+        void removeAliasedPlacement(const Carrot::UUID& id);
+
         BufferChain& createBuffer(const FrameResource& texture, vk::BufferUsageFlags usages);
         BufferAllocation& getBuffer(const FrameResource& texture, size_t frameIndex);
         BufferAllocation& getBuffer(const Carrot::UUID& id, size_t frameIndex);
@@ -78,6 +86,12 @@ namespace Carrot::Render {
         std::unordered_map<Carrot::UUID, vk::ImageUsageFlags> textureUsages;
         std::unordered_map<Carrot::UUID, Carrot::UUID> resourceOwners;
 
+        struct AliasedPlacement {
+            std::vector<std::shared_ptr<DeviceMemory>> heaps; // one per swapchain image
+            vk::DeviceSize offset = 0;
+        };
+        std::unordered_map<Carrot::UUID, AliasedPlacement> aliasedPlacements;
+
         std::unordered_map<Carrot::UUID, BufferChain> buffers;
         std::unordered_map<Carrot::UUID, std::size_t> bufferReuseHistoryLengths; // assumed 0 if key is missing
         std::unordered_map<Carrot::UUID, vk::BufferUsageFlags> bufferUsages;
@@ -20,14 +20,17 @@
 #include "core/io/IO.h"
 #include "engine/render/DebugBufferObject.h"
 #include "engine/render/GBufferDrawData.h"
+#include "engine/render/PacketSortKey.h"
 #include "engine/render/resources/Buffer.h"
 #include "engine/render/resources/Font.h"
 #include "engine/render/resources/ResourceAllocator.h"
 #include "engine/math/Transform.h"
-#include <execution>
+#include <algorithm>
+#include <bit>
 #include <robin_hood.h>
 #include <core/math/BasicFunctions.h>
 #include <IconsFontAwesome5.h>
+#include <core/allocators/FrameArenaAllocator.h>
 #include <core/allocators/StackAllocator.h>
 #include <engine/console/Console.h>
 #include <engine/vulkan/VulkanDefines.h>
@@ -130,6 +133,7 @@ void Carrot::VulkanRenderer::lateInit() {
     gBufferPipeline = getOrCreatePipeline("gBuffer");
     whiteMaterial = getMaterialSystem().createMaterialHandle();
     whiteMaterial->albedo = getMaterialSystem().getWhiteTexture();
+    whiteMaterial->markDirty();
 
     // requires whiteMaterial
     debugArrowModel = GetAssetServer().blockingLoadModel("resources/models/simple_arrow.gltf");
@@ -139,6 +143,72 @@ std::shared_ptr<Carrot::Pipeline> Carrot::VulkanRenderer::getOrCreateRenderPassS
     return getOrCreatePipeline(name, reinterpret_cast<std::uint64_t>((void*) &renderPass));
 }
 
+void Carrot::VulkanRenderer::preparePipeline(const std::shared_ptr<Pipeline>& pipeline, Render::PassName pass) {
+    auto isSamePipeline = [&](const std::weak_ptr<Pipeline>& other) {
+        return !other.owner_before(pipeline) && !pipeline.owner_before(other);
+    };
+
+    Async::LockGuard lk { pipelinePreparationsAccess };
+    PipelinePreparation& preparation = pipelinePreparations[pass.key];
+    if(std::ranges::any_of(preparation.preparedPipelines, isSamePipeline) || std::ranges::any_of(preparation.pendingPipelines, isSamePipeline)) {
+        return;
+    }
+    preparation.pendingPipelines.emplace_back(pipeline);
+}
+
+void Carrot::VulkanRenderer::preparePipelinesForRenderPass(Render::PassName pass, vk::RenderPass renderPass) {
+    Async::LockGuard lk { pipelinePreparationsAccess };
+    auto it = pipelinePreparations.find(pass.key);
+    if(it == pipelinePreparations.end()) {
+        return;
+    }
+
+    PipelinePreparation& preparation = it->second;
+    auto prepare = [](const std::weak_ptr<Pipeline>& weakPipeline, vk::RenderPass renderPass) {
+        if(std::shared_ptr<Pipeline> pipeline = weakPipeline.lock()) {
+            pipeline->prepareForRenderPass(renderPass);
+        }
+    };
+
+    if(std::ranges::find(preparation.renderPasses, renderPass) == preparation.renderPasses.end()) {
+        preparation.renderPasses.push_back(renderPass);
+        std::erase_if(preparation.preparedPipelines, [](const std::weak_ptr<Pipeline>& p) { return p.expired(); });
+        for(const auto& pipeline : preparation.preparedPipelines) {
+            prepare(pipeline, renderPass);
+        }
+    }
+
+    for(const auto& pipeline : preparation.pendingPipelines) {
+        for(const vk::RenderPass& knownRenderPass : preparation.renderPasses) {
+            prepare(pipeline, knownRenderPass);
+        }
+        preparation.preparedPipelines.push_back(pipeline);
+    }
+    preparation.pendingPipelines.clear();
+}
+
+void Carrot::VulkanRenderer::forgetRenderPass(vk::RenderPass renderPass) {
+    std::vector<std::shared_ptr<Pipeline>> pipelinesToUpdate;
+    {
+        Async::LockGuard lk { pipelinePreparationsAccess };
+        for(auto& [_, preparation] : pipelinePreparations) {
+            if(std::erase(preparation.renderPasses, renderPass) == 0) {
+                continue;
+            }
+            for(const auto& weakPipeline : preparation.preparedPipelines) {
+                if(std::shared_ptr<Pipeline> pipeline = weakPipeline.lock()) {
+                    pipelinesToUpdate.emplace_back(std::move(pipeline));
+                }
+            }
+        }
+    }
+
+    // outside of the lock: this may wait for variants still being created on worker threads
+    for(const auto& pipeline : pipelinesToUpdate) {
+        pipeline->forgetRenderPass(renderPass);
+    }
+}
+
 std::shared_ptr<Carrot::Pipeline> Carrot::VulkanRenderer::getOrCreatePipeline(const std::string& name, std::uint64_t instanceOffset) {
     return getOrCreatePipelineFullPath("resources/pipelines/"+name+".pipeline", instanceOffset);
 }
@@ -771,6 +841,7 @@ void Carrot::VulkanRenderer::beginFrame(const Carrot::Render::Context& renderCon
                 (*(*ppArray))[currentIndex].beginFrame();
             },
             .joiner = &prepareThreadRenderPackets,
+            .priority = TaskPriority::FrameCritical,
         };
         GetTaskScheduler().schedule(std::move(task), TaskScheduler::FrameParallelWork);
     }
@@ -926,6 +997,7 @@ void Carrot::VulkanRenderer::startRecord(std::uint8_t frameIndex, const Carrot::
                     }
                 },
                 .joiner = &mustBeDoneByNextFrameCounter,
+                .priority = TaskPriority::FrameCritical,
         };
         GetTaskScheduler().schedule(std::move(task), TaskScheduler::FrameParallelWork);
     }
@@ -955,6 +1027,14 @@ void Carrot::VulkanRenderer::startRecord(std::uint8_t frameIndex, const Carrot::
         ImGui::Text("Draw call reduction: %0.1f%%", (1.0f - ratio)*100);
         ImGui::Text("Instance buffer size this frame: %s", Carrot::IO::getHumanReadableFileSize(singleFrameAllocator.getAllocatedSizeThisFrame()).c_str());
         ImGui::Text("Instance buffer size total: %s", Carrot::IO::getHumanReadableFileSize(singleFrameAllocator.getAllocatedSizeAllFrames()).c_str());
+
+        const FrameArenaAllocator::Stats arenaStats = FrameArenaAllocator::get().getStats();
+        ImGui::Text("Frame arenas: %s this frame, %s previous frame, %s high-water mark, %s reserved over %llu threads",
+                    Carrot::IO::getHumanReadableFileSize(arenaStats.currentFrameBytes).c_str(),
+                    Carrot::IO::getHumanReadableFileSize(arenaStats.previousFrameBytes).c_str(),
+                    Carrot::IO::getHumanReadableFileSize(arenaStats.highWaterMark).c_str(),
+                    Carrot::IO::getHumanReadableFileSize(arenaStats.reservedBytes).c_str(),
+                    static_cast<std::uint64_t>(arenaStats.threadCount));
     }
 
     if(DebugRenderPacket) {
@@ -1541,13 +1621,18 @@ void Carrot::VulkanRenderer::recordPassPackets(Carrot::Render::PassName packetPa
     Carrot::Render::Viewport* viewport = renderContext.pViewport;
     verify(viewport, "Viewport cannot be null");
 
+    if(pass) {
+        preparePipelinesForRenderPass(packetPass, pass);
+    }
+
     auto packets = getRenderPackets(viewport, packetPass);
     const Carrot::Render::Packet* previousPacket = nullptr;
     Carrot::StackAllocator tempAllocator { Carrot::Allocator::getDefault() };
     for(const auto& p : packets) {
         tempAllocator.clear();
-        p.record(tempAllocator, pass, renderContext, commands, previousPacket);
-        previousPacket = &p;
+        if(p.record(tempAllocator, pass, renderContext, commands, previousPacket)) {
+            previousPacket = &p;
+        }
     }
 }
 
@@ -1603,54 +1688,99 @@ void Carrot::VulkanRenderer::recordTransparentGBufferPass(vk::RenderPass pass, C
 
 std::span<const Carrot::Render::Packet> Carrot::VulkanRenderer::getRenderPackets(Carrot::Render::Viewport* viewport, Carrot::Render::PassName pass) const {
     ZoneScoped;
-    auto predicate = [&](const auto& packet) {
-        return packet.viewport == viewport && packet.pass == pass;
-    };
-    auto first = std::find_if(preparedRenderPackets.begin(), preparedRenderPackets.end(), predicate);
-    if(first == preparedRenderPackets.end())
+    auto viewportIt = packetViewportIndices.find(viewport);
+    if(viewportIt == packetViewportIndices.end()) {
+        return {};
+    }
+    auto passIt = packetPassIndices.find(pass.key);
+    if(passIt == packetPassIndices.end()) {
         return {};
-    std::size_t startIndex = std::distance(preparedRenderPackets.begin(), first);
-    std::size_t endIndexInclusive = startIndex;
-    for (std::size_t index = startIndex; index < preparedRenderPackets.size(); ++index) {
-        if(!predicate(preparedRenderPackets[index])) {
-            break;
-        }
-
-        endIndexInclusive = index;
     }
 
-    return std::span<const Render::Packet> { &preparedRenderPackets[startIndex], static_cast<std::size_t>(endIndexInclusive - startIndex + 1) };
+    const PacketRange& range = packetRanges[viewportIt->second * packetPassIndices.size() + passIt->second];
+    return std::span<const Render::Packet> { preparedRenderPackets.data() + range.start, range.count };
 }
 
 void Carrot::VulkanRenderer::sortRenderPackets(std::vector<Carrot::Render::Packet>& inputPackets) {
     ZoneScoped;
-    // sort by viewport, pass, then pipeline, then mesh
-    std::sort(std::execution::par_unseq, inputPackets.begin(), inputPackets.end(), [&](const Render::Packet& a, const Render::Packet& b) {
-        if(a.viewport != b.viewport) {
-            return a.viewport < b.viewport;
-        }
+    // see PacketSortKey.h for the layout of the keys
+    static robin_hood::unordered_flat_map<const Carrot::Pipeline*, std::uint32_t> pipelineIndices;
+    static robin_hood::unordered_flat_map<VkBuffer, std::uint32_t> meshIndices;
+    pipelineIndices.clear();
+    meshIndices.clear();
+    packetViewportIndices.clear();
+    packetPassIndices.clear();
+    packetRanges.clear();
+
+    auto getIndex = [](auto& indexMap, const auto& key) -> std::uint64_t {
+        return indexMap.try_emplace(key, static_cast<std::uint32_t>(indexMap.size())).first->second;
+    };
 
-        if(a.pass != b.pass) {
-            return a.pass.key < b.pass.key;
-        }
+    const std::size_t packetCount = inputPackets.size();
+    packetSortKeys.resize(packetCount);
+    packetSortScratch.resize(packetCount);
+    {
+        ZoneScopedN("Compute sort keys");
+        for(std::size_t i = 0; i < packetCount; i++) {
+            Render::Packet& packet = inputPackets[i];
+            const bool zOrdered = Render::PacketSortKey::isZOrderedPass(packet.pass);
+            Render::PacketSortKey::Fields fields {
+                .viewportIndex = getIndex(packetViewportIndices, packet.viewport),
+                .passIndex = getIndex(packetPassIndices, packet.pass.key),
+                .zOrdered = zOrdered,
+                .zOrder = packet.transparentGBuffer.zOrder,
+                .pipelineIndex = getIndex(pipelineIndices, packet.pipeline.get()),
+            };
+
+            if(!zOrdered) {
+                // packets without vertex buffer go last
+                fields.meshIndex = Render::PacketSortKey::maxValueForBits(Render::PacketSortKey::MeshBits);
+                if(packet.vertexBuffer) {
+                    fields.meshIndex = std::min(getIndex(meshIndices, static_cast<VkBuffer>(packet.vertexBuffer.getVulkanBuffer())), fields.meshIndex - 1);
+                }
 
-        if(a.transparentGBuffer.zOrder != b.transparentGBuffer.zOrder) {
-            return a.transparentGBuffer.zOrder < b.transparentGBuffer.zOrder;
+                if(packet.perDrawData.size() >= sizeof(GBufferDrawData)) {
+                    const GBufferDrawData* pDrawData = reinterpret_cast<const GBufferDrawData*>(packet.perDrawData.data());
+                    fields.materialIndex = pDrawData->materialIndex;
+                }
+            }
+
+            packet.sortKey = Render::PacketSortKey::make(fields);
+            packetSortKeys[i] = SortKeyIndex { .key = packet.sortKey, .index = static_cast<std::uint32_t>(i) };
         }
+    }
+    verify(packetViewportIndices.size() <= Render::PacketSortKey::maxValueForBits(Render::PacketSortKey::ViewportBits) + 1, "Too many viewports with render packets in a single frame");
+    verify(packetPassIndices.size() <= Render::PacketSortKey::maxValueForBits(Render::PacketSortKey::PassBits) + 1, "Too many passes with render packets in a single frame");
 
-        if(a.pipeline != b.pipeline) {
-            return a.pipeline < b.pipeline;
+    radixSort(packetSortKeys, packetSortScratch);
+
+    {
+        ZoneScopedN("Reorder packets");
+        sortedRenderPacketsStorage.clear();
+        sortedRenderPacketsStorage.reserve(packetCount);
+        for(const SortKeyIndex& sorted : packetSortKeys) {
+            sortedRenderPacketsStorage.emplace_back(std::move(inputPackets[sorted.index]));
         }
+        inputPackets.swap(sortedRenderPacketsStorage);
+        sortedRenderPacketsStorage.clear();
+    }
 
-        if(a.vertexBuffer && b.vertexBuffer) {
-            return a.vertexBuffer.getVulkanBuffer() < b.vertexBuffer.getVulkanBuffer();
-        } else if(a.vertexBuffer) {
-            return true;
-        } else if(b.vertexBuffer) {
-            return false;
+    {
+        ZoneScopedN("Build packet ranges");
+        // packets of a given viewport & pass are contiguous, because they are the most significant bits of the key
+        const std::size_t passCount = packetPassIndices.size();
+        packetRanges.resize(packetViewportIndices.size() * passCount);
+        for(std::size_t i = 0; i < packetCount; i++) {
+            const std::uint64_t key = packetSortKeys[i].key;
+            const std::uint64_t viewportIndex = Render::PacketSortKey::getViewportIndex(key);
+            const std::uint64_t passIndex = Render::PacketSortKey::getPassIndex(key);
+            PacketRange& range = packetRanges[viewportIndex * passCount + passIndex];
+            if(range.count == 0) {
+                range.start = static_cast<std::uint32_t>(i);
+            }
+            range.count++;
         }
-        return false;
-    });
+    }
 }
 
 void Carrot::VulkanRenderer::renderSphere(const Carrot::Render::Context& renderContext, const glm::mat4& transform, float radius, const glm::vec4& color, const Carrot::UUID& objectID) {
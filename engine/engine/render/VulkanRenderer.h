@@ -30,6 +30,7 @@
 #include <core/async/Coroutines.hpp>
 #include <core/async/Locks.h>
 #include <core/async/ParallelMap.hpp>
+#include <core/utils/RadixSort.h>
 
 namespace sol {
     class state;
@@ -130,6 +131,20 @@ namespace Carrot {
         /// Different render passes can be used to force the engine to create a new instance. (Can be used for different blit pipelines, each with a different texture)
         std::shared_ptr<Pipeline> getOrCreateRenderPassSpecificPipeline(const std::string& name, const vk::RenderPass& pass);
 
+        /**
+         * Starts the creation of the variants of 'pipeline' for the render passes consuming the packets of 'pass', on worker
+         * threads (see Pipeline::prepareForRenderPass). Render passes which did not record packets yet are handled once they do.
+         * Meant to be called when loading models and materials, so that asynchronous pipelines are ready before their first bind.
+         * Can be called from any thread.
+         */
+        void preparePipeline(const std::shared_ptr<Pipeline>& pipeline, Render::PassName pass);
+
+        /**
+         * Removes 'renderPass' from the render passes known by pipeline preparation, and destroys the variants created for it by
+         * prepared pipelines. Must be called before destroying a render pass: Vulkan can reuse its handle for a new, incompatible render pass.
+         */
+        void forgetRenderPass(vk::RenderPass renderPass);
+
         std::shared_ptr<Render::Texture> getOrCreateTexture(const std::string& textureName);
 
         std::shared_ptr<Render::Font> getOrCreateFront(const Carrot::IO::Resource& from);
@@ -398,6 +413,21 @@ namespace Carrot {
 
         // render thread only
         std::vector<Render::Packet> preparedRenderPackets;
+        std::vector<Render::Packet> sortedRenderPacketsStorage; // destination of the reordering of preparedRenderPackets, reused between frames
+        std::vector<SortKeyIndex> packetSortKeys;
+        std::vector<SortKeyIndex> packetSortScratch;
+
+        struct PacketRange {
+            std::uint32_t start = 0;
+            std::uint32_t count = 0;
+        };
+
+        /// Dense indices given to viewports and passes of this frame's packets, used inside sort keys and to index 'packetRanges'
+        robin_hood::unordered_flat_map<Render::Viewport*, std::uint32_t> packetViewportIndices;
+        robin_hood::unordered_flat_map<std::uint64_t, std::uint32_t> packetPassIndices;
+
+        /// Range of preparedRenderPackets used by each viewport & pass, at index 'viewportIndex * packetPassIndices.size() + passIndex'
+        std::vector<PacketRange> packetRanges;
 
         std::shared_ptr<Carrot::Model> unitSphereModel;
         std::shared_ptr<Carrot::Model> unitCubeModel;
@@ -421,6 +451,20 @@ namespace Carrot {
         };
         ThreadSafeQueue<AsyncCopyDesc> asyncCopiesQueue;
 
+    private:
+        /// Pipelines to prepare for the render passes consuming packets of a given PassName
+        struct PipelinePreparation {
+            std::vector<vk::RenderPass> renderPasses; //< render passes which recorded packets of this PassName
+            std::vector<std::weak_ptr<Pipeline>> preparedPipelines; //< prepared for all of 'renderPasses'
+            std::vector<std::weak_ptr<Pipeline>> pendingPipelines; //< not prepared for any render pass yet
+        };
+
+        /// Called when recording packets, prepares the pipelines which are not prepared for 'renderPass' yet
+        void preparePipelinesForRenderPass(Render::PassName pass, vk::RenderPass renderPass);
+
+        Async::SpinLock pipelinePreparationsAccess;
+        std::unordered_map<std::uint64_t, PipelinePreparation> pipelinePreparations; // PassName::key -> pipelines to prepare
+
     private:
         bool hasBlinked = false;
         double blinkTime = -1.0;
@@ -12,6 +12,7 @@
 #include "engine/render/GBufferDrawData.h"
 #include "engine/render/raytracing/ASBuilder.h"
 #include "engine/render/resources/LightMesh.h"
+#include "engine/render/resources/PipelineCache.h"
 
 extern Carrot::RuntimeOption DrawBoundingSpheres;
 
@@ -308,10 +309,10 @@ void Carrot::AnimatedInstances::createSkinningComputePipeline() {
             .pushConstantRangeCount = 0,
             .pPushConstantRanges = nullptr,
     }, engine.getAllocator());
-    computePipeline = engine.getLogicalDevice().createComputePipelineUnique(nullptr, vk::ComputePipelineCreateInfo {
+    computePipeline = engine.getVulkanDriver().getPipelineCache().createComputePipeline(vk::ComputePipelineCreateInfo {
             .stage = computeStage.createPipelineShaderStage(vk::ShaderStageFlagBits::eCompute, &specialization),
             .layout = *computePipelineLayout,
-    }, engine.getAllocator()).value;
+    });
 
     std::uint32_t vertexGroups = (vertexCountPerInstance + 127) / 128;
     std::uint32_t instanceGroups = (maxInstanceCount + 7)/8;
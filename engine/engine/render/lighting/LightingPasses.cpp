@@ -164,6 +164,9 @@ namespace Carrot::Render {
                                                              format,
                                                              framebufferSize,
                                                              vk::ImageLayout::eGeneral);
+             // only used inside the pass which creates them, never from a previous frame
+             graph.allowAliasing(data.noisy);
+             graph.allowAliasing(data.samples);
              data.historyLength = graph.createStorageTarget(Carrot::sprintf("%s (temporal history length)", name),
                                                              vk::Format::eR32G32B32A32Sfloat,
                                                              framebufferSize,
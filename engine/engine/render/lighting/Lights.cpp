@@ -25,13 +25,17 @@ namespace Carrot::Render {
         point.quadraticAttenuation = 0.032f;
     }
 
-    LightHandle::LightHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor, Lighting& system): WeakPoolHandle::WeakPoolHandle(index, std::move(destructor)), lightingSystem(system) {}
+    LightHandle::LightHandle(std::uint32_t index, WeakPoolHandle::Releaser releaser, Lighting& system): WeakPoolHandle::WeakPoolHandle(index, releaser), lightingSystem(system) {}
 
     void LightHandle::updateHandle(const Carrot::Render::Context& renderContext) {
         auto& data = lightingSystem.getLightData(*this);
         data = light;
     }
 
+    void LightHandle::markDirty() {
+        lightingSystem.lightHandles.markDirty(getSlot());
+    }
+
     LightHandle::~LightHandle() {
         auto& data = lightingSystem.getLightData(*this);
         data.flags = LightFlags::None;
@@ -84,7 +88,7 @@ namespace Carrot::Render {
     std::shared_ptr<LightHandle> Lighting::create() {
         auto ptr = lightHandles.create(std::ref(*this));
         if(lightHandles.getRequiredStorageCount() > lightBufferSize) {
-            reallocateBuffers(Carrot::Math::nextPowerOf2(lightHandles.size()));
+            reallocateBuffers(Carrot::Math::nextPowerOf2(lightHandles.getRequiredStorageCount()));
         }
         return ptr;
     }
@@ -105,6 +109,10 @@ namespace Carrot::Render {
                 vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostVisible
         );
         activeLightsData = activeLightsBuffer->map<ActiveLightsData>();
+        activeLightsData->count = 0;
+
+        // new buffers, all lights need to be written again
+        lightHandles.markAllDirty();
 
         descriptorNeedsUpdate = std::vector<bool>(descriptorSets.size(), true);
     }
@@ -131,25 +139,33 @@ namespace Carrot::Render {
             }
         }
 
-        lightHandles.erase(std::find_if(WHOLE_CONTAINER(lightHandles), [](auto& handlePtr) { return handlePtr.second.expired(); }), lightHandles.end());
         data->lightCount = lightBufferSize;
         data->ambient = ambientColor;
         data->fogColor = fogColor;
         data->fogDepth = fogDepth;
         data->fogDistance = fogDistance;
 
-        std::uint32_t activeCount = 0;
-        for(auto& [slot, handlePtr] : lightHandles) {
-            if(auto handle = handlePtr.lock()) {
-                handle->updateHandle(renderContext);
-                if((handle->light.flags & LightFlags::Enabled) != LightFlags::None) {
-                    activeLightsData->indices[activeCount] = slot;
-                    activeCount++;
+        // only lights created, removed or modified since the last frame are written
+        const auto dirtyLights = lightHandles.consumeDirtyRange();
+        if(!dirtyLights.empty()) {
+            for(std::uint32_t slot = dirtyLights.begin; slot < dirtyLights.end; slot++) {
+                if(auto handle = lightHandles.find(slot).lock()) {
+                    handle->updateHandle(renderContext);
                 }
             }
-        }
 
-        activeLightsData->count = activeCount;
+            std::uint32_t activeCount = 0;
+            for(auto& [slot, handlePtr] : lightHandles) {
+                if(auto handle = handlePtr.lock()) {
+                    if((handle->light.flags & LightFlags::Enabled) != LightFlags::None) {
+                        activeLightsData->indices[activeCount] = slot;
+                        activeCount++;
+                    }
+                }
+            }
+
+            activeLightsData->count = activeCount;
+        }
 
         if(descriptorNeedsUpdate[renderContext.swapchainIndex]) {
             auto& set = descriptorSets[renderContext.swapchainIndex];
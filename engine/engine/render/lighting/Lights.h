@@ -67,10 +67,13 @@ namespace Carrot::Render {
     public:
         Light light;
 
-        /*[[deprecated]] */explicit LightHandle(std::uint32_t index, std::function<void(WeakPoolHandle*)> destructor, Lighting& system);
+        /*[[deprecated]] */explicit LightHandle(std::uint32_t index, WeakPoolHandle::Releaser releaser, Lighting& system);
 
         ~LightHandle();
 
+        /// Must be called after modifying 'light', so that the light buffer is updated during the next frame
+        void markDirty();
+
     private:
         void updateHandle(const Carrot::Render::Context& renderContext);
 
@@ -85,6 +85,7 @@ namespace Carrot::Render {
         auto material = GetRenderer().getMaterialSystem().createMaterialHandle();
         auto textureHandle = GetRenderer().getMaterialSystem().createTextureHandle(bitmap);
         material->albedo = textureHandle;
+        material->markDirty();
         auto mesh = std::make_unique<Carrot::SingleMesh>(
                                                    std::vector<Carrot::SimpleVertexWithInstanceData>{
                                                            {{0, 0, 0}},
@@ -25,9 +25,8 @@
 /*static*/ Carrot::Async::SpinLock Carrot::Image::AliveImagesAccess{};
 /*static*/ std::unordered_set<const Carrot::Image*> Carrot::Image::AliveImages{};
 
-Carrot::Image::Image(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::ImageUsageFlags usage, vk::Format format,
-                     std::set<std::uint32_t> families, vk::ImageCreateFlags flags, vk::ImageType imageType, std::uint32_t layerCount, std::uint32_t mipCount):
-        Carrot::DebugNameable(), driver(driver), size(extent), layerCount(layerCount), mipCount(mipCount), usage(usage), format(format), imageData(true) {
+static vk::UniqueImage createVulkanImage(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::ImageUsageFlags usage, vk::Format format,
+                                        std::set<std::uint32_t> families, vk::ImageCreateFlags flags, vk::ImageType imageType, std::uint32_t layerCount, std::uint32_t mipCount) {
     vk::ImageCreateInfo createInfo{
         .flags = flags,
         .imageType = imageType,
@@ -54,7 +53,13 @@ Carrot::Image::Image(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::Imag
         createInfo.queueFamilyIndexCount = static_cast<uint32_t>(familyList.size());
         createInfo.pQueueFamilyIndices = familyList.data();
     }
-    imageData.asOwned.vkImage = driver.getLogicalDevice().createImageUnique(createInfo, driver.getAllocationCallbacks());
+    return driver.getLogicalDevice().createImageUnique(createInfo, driver.getAllocationCallbacks());
+}
+
+Carrot::Image::Image(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::ImageUsageFlags usage, vk::Format format,
+                     std::set<std::uint32_t> families, vk::ImageCreateFlags flags, vk::ImageType imageType, std::uint32_t layerCount, std::uint32_t mipCount):
+        Carrot::DebugNameable(), driver(driver), size(extent), layerCount(layerCount), mipCount(mipCount), usage(usage), format(format), imageData(true) {
+    imageData.asOwned.vkImage = createVulkanImage(driver, extent, usage, format, std::move(families), flags, imageType, layerCount, mipCount);
 
     // allocate memory to use image
     vk::MemoryRequirements requirements = driver.getLogicalDevice().getImageMemoryRequirements(getVulkanImage());
@@ -72,6 +77,24 @@ Carrot::Image::Image(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::Imag
     AliveImages.insert(this);
 }
 
+Carrot::Image::Image(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::ImageUsageFlags usage, vk::Format format,
+                     std::shared_ptr<Carrot::DeviceMemory> memory, vk::DeviceSize memoryOffset):
+        Carrot::DebugNameable(), driver(driver), size(extent), usage(usage), format(format), imageData(true) {
+    verify(memory, "Aliased images need memory to bind to");
+    imageData.asOwned.vkImage = createVulkanImage(driver, extent, usage, format, {}, {}, vk::ImageType::e2D, layerCount, mipCount);
+    imageData.asOwned.aliasedMemory = std::move(memory);
+
+    driver.getLogicalDevice().bindImageMemory(getVulkanImage(), getVkMemory(), memoryOffset);
+
+    Async::LockGuard g { AliveImagesAccess };
+    AliveImages.insert(this);
+}
+
+vk::MemoryRequirements Carrot::Image::getMemoryRequirements(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::ImageUsageFlags usage, vk::Format format) {
+    vk::UniqueImage image = createVulkanImage(driver, extent, usage, format, {}, {}, vk::ImageType::e2D, 1, 1);
+    return driver.getLogicalDevice().getImageMemoryRequirements(*image);
+}
+
 Carrot::Image::Image(Carrot::VulkanDriver& driver, vk::Image toView, vk::Extent3D extent, vk::Format format, std::uint32_t layerCount, std::uint32_t mipCount)
 : driver(driver), imageData(false), format(format), layerCount(layerCount), mipCount(mipCount), size(extent) {
     imageData.asView.vkImage = toView;
@@ -158,8 +181,8 @@ std::unique_ptr<Carrot::Image> Carrot::Image::fromFile(Carrot::VulkanDriver& dev
     int channels;
 
     auto loadThroughStbi = [&]() {
-        auto buffer = resource.readAll();
-        stbi_uc* pixels = stbi_load_from_memory(buffer.get(), resource.getSize(), &width, &height, &channels, STBI_rgb_alpha);
+        const Carrot::IO::MappedResource buffer = resource.map();
+        stbi_uc* pixels = stbi_load_from_memory(buffer.data(), static_cast<int>(buffer.size()), &width, &height, &channels, STBI_rgb_alpha);
         if(!pixels) {
             throw std::runtime_error("Failed to load image "+resource.getName());
         }
@@ -242,10 +265,10 @@ std::unique_ptr<Carrot::Image> Carrot::Image::fromFile(Carrot::VulkanDriver& dev
             ktxTexture2* texture;
             KTX_error_code result;
             {
-                std::unique_ptr<std::uint8_t[]> ktxData = resource.readAll();
-                std::size_t ktxDataSize = resource.getSize();
+                // no intermediate copy: libktx reads directly from the mapped file
+                const Carrot::IO::MappedResource ktxData = resource.map();
 
-                result = ktxTexture2_CreateFromMemory(ktxData.get(), ktxDataSize,
+                result = ktxTexture2_CreateFromMemory(ktxData.data(), ktxData.size(),
                                                      KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT,
                                                      &texture);
 
@@ -522,7 +545,7 @@ vk::UniqueImageView Carrot::Image::createImageView(vk::Format imageFormat, vk::I
 
 void Carrot::Image::setDebugNames(const std::string& name) {
     nameSingle(name, getVulkanImage());
-    if(imageData.ownsImage) {
+    if(imageData.ownsImage && !imageData.asOwned.aliasedMemory) { // aliased memory is named by its owner
         imageData.asOwned.memory.name(name);
         nameSingle(name + " Memory", getVkMemory());
     }
@@ -615,6 +638,9 @@ vk::Format Carrot::Image::getFormat() const {
 
 vk::DeviceMemory Carrot::Image::getVkMemory() const {
     verify(imageData.ownsImage, "Cannot access memory of not-owned image.")
+    if(imageData.asOwned.aliasedMemory) {
+        return imageData.asOwned.aliasedMemory->getVulkanMemory();
+    }
     return imageData.asOwned.memory.getVulkanMemory();
 }
 
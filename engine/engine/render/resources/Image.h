@@ -29,6 +29,7 @@ namespace Carrot {
                 struct {
                     vk::UniqueImage vkImage = {};
                     Carrot::DeviceMemory memory = {};
+                    std::shared_ptr<Carrot::DeviceMemory> aliasedMemory; // memory shared with other images, 'memory' is empty if set
                 } asOwned;
 
                 struct {
@@ -47,6 +48,7 @@ namespace Carrot {
             ~ImageData() {
                 if(ownsImage) {
                     asOwned.memory = {};
+                    asOwned.aliasedMemory = nullptr;
                     asOwned.vkImage.reset();
                 }
             }
@@ -74,6 +76,15 @@ namespace Carrot {
                        std::uint32_t layerCount = 1,
                        std::uint32_t mipCount = 1);
 
+        /// Creates a new empty 2D image with the given parameters, bound to 'memory' at 'memoryOffset' instead of allocating its own memory.
+        /// Used to alias images which are never used at the same time. 'memory' is kept alive as long as this image
+        explicit Image(Carrot::VulkanDriver& driver,
+                       vk::Extent3D extent,
+                       vk::ImageUsageFlags usage,
+                       vk::Format format,
+                       std::shared_ptr<Carrot::DeviceMemory> memory,
+                       vk::DeviceSize memoryOffset);
+
         explicit Image(Carrot::VulkanDriver& driver, vk::Image toView,
                        vk::Extent3D extent,
                        vk::Format format,
@@ -91,6 +102,7 @@ namespace Carrot {
         vk::DeviceMemory getVkMemory() const;
 
         /// Only valid for owned images (ie created by the engine, not swapchain / external libs)
+        /// Empty for aliased images: their memory is owned by whoever created it
         const Carrot::DeviceMemory& getMemory() const;
 
         const vk::Extent3D& getSize() const;
@@ -117,6 +129,9 @@ namespace Carrot {
         /// Creates a ImageView pointing to this image
         vk::UniqueImageView createImageView(vk::Format imageFormat = vk::Format::eR8G8B8A8Unorm, vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor, vk::ImageViewType viewType = vk::ImageViewType::e2D, std::uint32_t layerCount = 1);
 
+        /// Memory requirements of a 2D image created with the given parameters, without allocating anything
+        static vk::MemoryRequirements getMemoryRequirements(Carrot::VulkanDriver& driver, vk::Extent3D extent, vk::ImageUsageFlags usage, vk::Format format);
+
         /// Create and fill an Image from a given image file
         static std::unique_ptr<Image> fromFile(Carrot::VulkanDriver& device, const Carrot::IO::Resource resource);
 
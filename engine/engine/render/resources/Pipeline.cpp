@@ -17,6 +17,7 @@
 #include <engine/utils/Profiling.h>
 #include <engine/Engine.h>
 #include <engine/render/VulkanRenderer.h>
+#include <engine/render/resources/PipelineCache.h>
 
 static Carrot::Lookup PolygonModes = std::array {
         Carrot::LookupEntry<vk::PolygonMode>(vk::PolygonMode::eFill, "fill"),
@@ -24,6 +25,11 @@ static Carrot::Lookup PolygonModes = std::array {
         Carrot::LookupEntry<vk::PolygonMode>(vk::PolygonMode::eFill, "point_cloud"),
 };
 
+static Carrot::Lookup PipelineCompilations = std::array {
+        Carrot::LookupEntry<Carrot::PipelineCompilation>(Carrot::PipelineCompilation::Blocking, "blocking"),
+        Carrot::LookupEntry<Carrot::PipelineCompilation>(Carrot::PipelineCompilation::Asynchronous, "async"),
+};
+
 static Carrot::Lookup DescriptorSetType = std::array {
         Carrot::LookupEntry<Carrot::PipelineDescription::DescriptorSet::Type>(Carrot::PipelineDescription::DescriptorSet::Type::Autofill, "autofill"),
         Carrot::LookupEntry<Carrot::PipelineDescription::DescriptorSet::Type>(Carrot::PipelineDescription::DescriptorSet::Type::Empty, "empty"),
@@ -77,11 +83,19 @@ Carrot::Pipeline::Pipeline(Carrot::VulkanDriver& driver, const PipelineDescripti
     reloadShaders(false);
 }
 
+Carrot::Pipeline::~Pipeline() {
+    waitForPendingVariants(); // worker threads may still be using this pipeline
+}
+
 void Carrot::Pipeline::reloadShaders(bool needDeviceWait) {
     if(needDeviceWait) {
         WaitDeviceIdle();
     }
-    vkPipelines.clear(); // flush existing pipelines
+    waitForPendingVariants(); // they use the templates which are about to be recreated
+    {
+        std::lock_guard l { variantsAccess };
+        vkPipelines.clear(); // flush existing pipelines
+    }
     stages->reload();
 
     std::vector<vk::DescriptorSetLayout> layouts{};
@@ -432,23 +446,143 @@ const vk::PushConstantRange& Carrot::Pipeline::getPushConstant(std::string_view
     return pushConstantMap[std::string(name)];
 }
 
+vk::UniquePipeline Carrot::Pipeline::createPipeline(vk::RenderPass pass) const {
+    ZoneScopedN("Create pipeline variant");
+    vk::UniquePipeline pipeline;
+    if(description.type == PipelineType::Compute) {
+        pipeline = driver.getPipelineCache().createComputePipeline(computePipelineTemplate.pipelineInfo);
+    } else {
+        vk::GraphicsPipelineCreateInfo info = graphicsPipelineTemplate.pipelineInfo;
+        info.renderPass = pass;
+        pipeline = driver.getPipelineCache().createGraphicsPipeline(info);
+    }
+
+    if(!debugName.empty()) {
+        DebugNameable::nameSingle(debugName, *pipeline);
+    }
+    return pipeline;
+}
+
+Carrot::Pipeline::Variant& Carrot::Pipeline::getOrStartVariant(vk::RenderPass pass) const {
+    auto& pVariant = vkPipelines[pass];
+    if(!pVariant) {
+        pVariant = std::make_unique<Variant>();
+        pVariant->compiling = std::make_unique<Async::Counter>();
+
+        Variant* pTarget = pVariant.get();
+        driver.getPipelineCache().onAsyncCompilationStart();
+        GetTaskScheduler().schedule(TaskDescription {
+            .name = "Create pipeline variant",
+            .task = [this, pass, pTarget](TaskHandle&) {
+                vk::UniquePipeline pipeline;
+                try {
+                    pipeline = createPipeline(pass);
+                } catch(std::exception& e) {
+                    // bind will try again on the render thread, and report the error there
+                    Carrot::Log::error("Failed to create pipeline variant of %s: %s", debugName.c_str(), e.what());
+                }
+
+                {
+                    std::lock_guard l { variantsAccess };
+                    if(!pTarget->pipeline) { // could have been created by a blocking bind in the meantime
+                        pTarget->pipeline = std::move(pipeline);
+                    }
+                }
+                driver.getPipelineCache().onAsyncCompilationEnd();
+            },
+            .joiner = pVariant->compiling.get(),
+        }, TaskScheduler::AssetLoading);
+    }
+    return *pVariant;
+}
+
+void Carrot::Pipeline::prepareForRenderPass(vk::RenderPass pass) const {
+    std::lock_guard l { variantsAccess };
+    getOrStartVariant(pass);
+}
+
+bool Carrot::Pipeline::isReadyToBind(vk::RenderPass pass) const {
+    if(description.compilation == PipelineCompilation::Blocking) {
+        return true;
+    }
+
+    std::lock_guard l { variantsAccess };
+    const Variant& variant = getOrStartVariant(pass);
+    // no pipeline and not compiling anymore: creation failed, let bind report the error
+    return variant.pipeline || !variant.compiling || variant.compiling->isIdle();
+}
+
+void Carrot::Pipeline::forgetRenderPass(vk::RenderPass pass) const {
+    Async::Counter* pCompiling = nullptr;
+    {
+        std::lock_guard l { variantsAccess };
+        auto it = vkPipelines.find(pass);
+        if(it == vkPipelines.end()) {
+            return;
+        }
+        pCompiling = it->second->compiling.get();
+    }
+
+    if(pCompiling != nullptr) {
+        pCompiling->busyWait(); // the worker thread is still using the render pass
+    }
+
+    std::lock_guard l { variantsAccess };
+    vkPipelines.erase(pass);
+}
+
+void Carrot::Pipeline::waitForPendingVariants() const {
+    std::vector<Async::Counter*> pending;
+    {
+        std::lock_guard l { variantsAccess };
+        for(const auto& [_, pVariant] : vkPipelines) {
+            if(pVariant->compiling) {
+                pending.push_back(pVariant->compiling.get());
+            }
+        }
+    }
+    for(Async::Counter* pCounter : pending) {
+        pCounter->busyWait();
+    }
+}
+
 vk::Pipeline& Carrot::Pipeline::getOrCreatePipelineForRenderPass(vk::RenderPass pass) const {
-    auto it = vkPipelines.find(pass);
-    if(it == vkPipelines.end()) {
-        if(description.type == PipelineType::Compute) {
-            vk::ComputePipelineCreateInfo info = computePipelineTemplate.pipelineInfo;
-            vkPipelines[pass] = std::move(driver.getLogicalDevice().createComputePipelineUnique(nullptr, info, nullptr).value);
-        } else {
-            vk::GraphicsPipelineCreateInfo info = graphicsPipelineTemplate.pipelineInfo;
-            info.renderPass = pass;
-            vkPipelines[pass] = std::move(driver.getLogicalDevice().createGraphicsPipelineUnique(nullptr, info, nullptr).value);
+    Async::Counter* pCompiling = nullptr;
+    {
+        std::lock_guard l { variantsAccess };
+        auto it = vkPipelines.find(pass);
+        if(it != vkPipelines.end()) {
+            if(it->second->pipeline) {
+                return *it->second->pipeline;
+            }
+            pCompiling = it->second->compiling.get();
         }
+    }
+
+    if(pCompiling != nullptr) {
+        ZoneScopedN("Wait for pipeline variant");
+        pCompiling->busyWait();
 
-        if(!debugName.empty()) {
-            DebugNameable::nameSingle(debugName, *vkPipelines[pass]);
+        std::lock_guard l { variantsAccess };
+        const Variant& variant = *vkPipelines.at(pass);
+        if(variant.pipeline) {
+            return *variant.pipeline;
         }
+        // creation failed on the worker thread, try again here
+    }
+
+    // created outside of the lock, to avoid blocking threads using other variants
+    vk::UniquePipeline pipeline = createPipeline(pass);
+
+    std::lock_guard l { variantsAccess };
+    auto& pVariant = vkPipelines[pass];
+    if(!pVariant) {
+        pVariant = std::make_unique<Variant>();
+    }
+    if(!pVariant->pipeline) { // another thread may have created it in the meantime
+        pVariant->pipeline = std::move(pipeline);
     }
-    return *vkPipelines[pass];
+    return *pVariant->pipeline;
 }
 
 void Carrot::Pipeline::bind(vk::RenderPass pass, const Carrot::Render::Context& renderContext, vk::CommandBuffer& commands, vk::PipelineBindPoint bindPoint, std::vector<std::uint32_t> dynamicOffsets) const {
@@ -720,8 +854,11 @@ void Carrot::Pipeline::onSwapchainSizeChange(Window& window, int newWidth, int n
 }
 
 void Carrot::Pipeline::setDebugNames(const std::string& name) {
-    for(auto& [_, pPipeline] : vkPipelines) {
-        DebugNameable::nameSingle(name, *pPipeline);
+    std::lock_guard l { variantsAccess };
+    for(auto& [_, pVariant] : vkPipelines) {
+        if(pVariant->pipeline) {
+            DebugNameable::nameSingle(name, *pVariant->pipeline);
+        }
     }
     debugName = name;
 }
@@ -796,6 +933,10 @@ Carrot::PipelineDescription::PipelineDescription(const Carrot::IO::Resource json
         polygonMode = PolygonModes[json["fillMode"].GetString()];
     }
 
+    if(json.HasMember("compilation")) {
+        compilation = PipelineCompilations[json["compilation"].GetString()];
+    }
+
     if(json.HasMember("descriptorSets")) {
         setCount = 0;
         auto sets = json["descriptorSets"].GetArray();
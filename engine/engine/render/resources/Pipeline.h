@@ -10,6 +10,7 @@
 #include "VertexFormat.h"
 #include "engine/render/shaders/ShaderSource.h"
 #include <core/utils/Lookup.hpp>
+#include <core/async/Counter.h>
 
 namespace Carrot {
     class Material;
@@ -29,6 +30,15 @@ namespace Carrot {
         Unknown
     };
 
+    /// What to do when a pipeline variant is needed (first use with a given render pass) but not created yet
+    enum class PipelineCompilation {
+        /// Create the variant on the calling thread (or wait for it if it is already compiling)
+        Blocking,
+
+        /// Create the variant on a worker thread. Render packets using this pipeline are skipped until it is ready
+        Asynchronous,
+    };
+
     struct PipelineDescription {
         struct DescriptorSet {
             enum class Type {
@@ -69,6 +79,7 @@ namespace Carrot {
 
         vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
 
+        PipelineCompilation compilation = PipelineCompilation::Blocking;
 
         Render::ShaderSource computeShader;
         Render::ShaderSource taskShader;
@@ -85,9 +96,11 @@ namespace Carrot {
     public:
         explicit Pipeline(Carrot::VulkanDriver& driver, const Carrot::IO::Resource pipelineDescription);
         explicit Pipeline(Carrot::VulkanDriver& driver, const PipelineDescription& description);
+        ~Pipeline();
 
         /**
-         * Binds pipeline + descriptor sets
+         * Binds pipeline + descriptor sets.
+         * Waits for the pipeline variant of 'pass' if it is not created yet, use isReadyToBind to avoid stalls.
          */
         void bind(vk::RenderPass pass, const Carrot::Render::Context& renderContext, vk::CommandBuffer& commands, vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics, std::vector<std::uint32_t> dynamicOffsets = {}) const;
 
@@ -100,6 +113,25 @@ namespace Carrot {
 
         const vk::PushConstantRange& getPushConstant(std::string_view name) const;
 
+        /**
+         * Starts the creation of the pipeline variant for 'pass' on a worker thread, if it does not exist yet.
+         * Can be used to create pipelines in advance, for instance while loading a level.
+         */
+        void prepareForRenderPass(vk::RenderPass pass) const;
+
+        /**
+         * Returns false if binding this pipeline for 'pass' right now would create it, while its description asks for asynchronous
+         * compilation. In that case, the creation of the variant is started and the draw should be skipped.
+         * Always true for blocking pipelines.
+         */
+        bool isReadyToBind(vk::RenderPass pass) const;
+
+        /**
+         * Destroys the variant created for 'pass', waiting for its creation if it is still in progress.
+         * Used when 'pass' is about to be destroyed. The GPU must not use the variant anymore.
+         */
+        void forgetRenderPass(vk::RenderPass pass) const;
+
     public:
         [[nodiscard]] const vk::PipelineLayout& getPipelineLayout() const;
         [[nodiscard]] const vk::DescriptorSetLayout& getDescriptorSetLayout(std::uint32_t setID) const;
@@ -131,8 +163,21 @@ namespace Carrot {
 
         void allocateDescriptorSets();
 
+        struct Variant {
+            vk::UniquePipeline pipeline;
+            std::unique_ptr<Async::Counter> compiling; // not idle while this variant is created on a worker thread
+        };
+
         vk::Pipeline& getOrCreatePipelineForRenderPass(vk::RenderPass pass) const;
 
+        /// Returns the variant for 'pass', starting its creation on a worker thread if it does not exist. Lock 'variantsAccess' before calling
+        Variant& getOrStartVariant(vk::RenderPass pass) const;
+
+        vk::UniquePipeline createPipeline(vk::RenderPass pass) const;
+
+        /// Waits for variants currently created on worker threads
+        void waitForPendingVariants() const;
+
         void reloadShaders(bool needDeviceWait);
 
         void createGraphicsTemplate();
@@ -189,7 +234,8 @@ namespace Carrot {
         std::vector<vk::UniqueDescriptorSetLayout> descriptorSetLayouts{};
 
         PipelineDescription description;
-        mutable std::unordered_map<vk::RenderPass, vk::UniquePipeline> vkPipelines{};
+        mutable std::mutex variantsAccess;
+        mutable std::unordered_map<vk::RenderPass, std::unique_ptr<Variant>> vkPipelines{};
 
         mutable std::unordered_map<std::string, vk::PushConstantRange> pushConstantMap{};
     };
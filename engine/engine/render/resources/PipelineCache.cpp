@@ -0,0 +1,233 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "PipelineCache.h"
+#include <engine/vulkan/VulkanDriver.h>
+#include <core/io/Logging.hpp>
+#include <core/utils/CRC64.hpp>
+#include <imgui.h>
+#include <cstring>
+#include <fstream>
+
+namespace Carrot::Render {
+    static constexpr char FileMagic[4] = { 'C', 'P', 'S', 'O' };
+
+    /// Header of cache files, written before the data returned by vkGetPipelineCacheData
+    struct FileHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t vendorID;
+        std::uint32_t deviceID;
+        std::uint32_t driverVersion;
+        std::uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        std::uint64_t dataSize;
+        std::uint64_t dataHash; // CRC64 of the data, detects truncated or corrupted files
+    };
+
+    PipelineCache::PipelineCache(VulkanDriver& driver, std::filesystem::path _cacheFile, bool creationFeedbackSupported)
+        : driver(driver)
+        , cacheFile(std::move(_cacheFile))
+        , creationFeedbackSupported(creationFeedbackSupported)
+    {
+        deviceProperties = driver.getPhysicalDevice().getProperties();
+
+        std::vector<std::uint8_t> fileContents;
+        if(!cacheFile.empty()) {
+            std::ifstream input { cacheFile, std::ios::binary | std::ios::in };
+            if(input) {
+                fileContents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+            }
+        }
+
+        std::span<const std::uint8_t> initialData = validate(fileContents, deviceProperties);
+        if(!fileContents.empty() && initialData.empty()) {
+            Carrot::Log::warn("Ignoring pipeline cache %s: it was produced by another device or driver, or is corrupted", cacheFile.string().c_str());
+        } else if(!initialData.empty()) {
+            Carrot::Log::info("Loaded pipeline cache from %s (%llu bytes)", cacheFile.string().c_str(), static_cast<std::uint64_t>(initialData.size()));
+        }
+
+        cache = driver.getLogicalDevice().createPipelineCacheUnique(vk::PipelineCacheCreateInfo {
+            .initialDataSize = initialData.size(),
+            .pInitialData = initialData.data(),
+        }, driver.getAllocationCallbacks());
+    }
+
+    PipelineCache::~PipelineCache() {
+        const Statistics stats = getStatistics();
+        Carrot::Log::info("Pipeline cache: %llu pipelines created (%llu hits, %llu misses), %.2f ms total creation time",
+                          stats.createdPipelines, stats.cacheHits, stats.cacheMisses,
+                          std::chrono::duration<double, std::milli>(stats.totalCreationTime).count());
+        save();
+    }
+
+    void PipelineCache::save() {
+        if(cacheFile.empty()) {
+            return;
+        }
+
+        const std::vector<std::uint8_t> cacheData = driver.getLogicalDevice().getPipelineCacheData(*cache);
+        const std::vector<std::uint8_t> fileContents = encode(cacheData, deviceProperties);
+
+        // write to a temporary file first, to never leave a partially written cache behind
+        std::filesystem::path tmpFile = cacheFile;
+        tmpFile += ".tmp";
+        {
+            std::ofstream output { tmpFile, std::ios::binary | std::ios::out | std::ios::trunc };
+            if(!output) {
+                Carrot::Log::warn("Could not write pipeline cache to %s", tmpFile.string().c_str());
+                return;
+            }
+            output.write(reinterpret_cast<const char*>(fileContents.data()), fileContents.size());
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmpFile, cacheFile, ec);
+        if(ec) {
+            Carrot::Log::warn("Could not write pipeline cache to %s: %s", cacheFile.string().c_str(), ec.message().c_str());
+        }
+    }
+
+    std::span<const std::uint8_t> PipelineCache::validate(std::span<const std::uint8_t> fileContents, const vk::PhysicalDeviceProperties& properties) {
+        FileHeader header;
+        if(fileContents.size() < sizeof(header)) {
+            return {};
+        }
+        std::memcpy(&header, fileContents.data(), sizeof(header));
+
+        if(std::memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0 || header.version != FileVersion) {
+            return {};
+        }
+        if(header.vendorID != properties.vendorID
+        || header.deviceID != properties.deviceID
+        || header.driverVersion != properties.driverVersion
+        || std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0) {
+            return {};
+        }
+
+        const std::span<const std::uint8_t> data = fileContents.subspan(sizeof(header));
+        if(data.size() != header.dataSize || Carrot::CRC64(reinterpret_cast<const char*>(data.data()), data.size()) != header.dataHash) {
+            return {};
+        }
+
+        // drivers are supposed to validate the data themselves, but some crash on invalid data instead
+        VkPipelineCacheHeaderVersionOne vkHeader;
+        if(data.size() < sizeof(vkHeader)) {
+            return {};
+        }
+        std::memcpy(&vkHeader, data.data(), sizeof(vkHeader));
+        if(vkHeader.headerSize < sizeof(vkHeader)
+        || vkHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        || vkHeader.vendorID != properties.vendorID
+        || vkHeader.deviceID != properties.deviceID
+        || std::memcmp(vkHeader.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) != 0) {
+            return {};
+        }
+        return data;
+    }
+
+    std::vector<std::uint8_t> PipelineCache::encode(std::span<const std::uint8_t> cacheData, const vk::PhysicalDeviceProperties& properties) {
+        FileHeader header {
+            .version = FileVersion,
+            .vendorID = properties.vendorID,
+            .deviceID = properties.deviceID,
+            .driverVersion = properties.driverVersion,
+            .dataSize = cacheData.size(),
+            .dataHash = Carrot::CRC64(reinterpret_cast<const char*>(cacheData.data()), cacheData.size()),
+        };
+        std::memcpy(header.magic, FileMagic, sizeof(FileMagic));
+        std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+        std::vector<std::uint8_t> contents;
+        contents.resize(sizeof(header) + cacheData.size());
+        std::memcpy(contents.data(), &header, sizeof(header));
+        std::memcpy(contents.data() + sizeof(header), cacheData.data(), cacheData.size());
+        return contents;
+    }
+
+    template<typename CreateInfo, typename CreateFunc>
+    vk::UniquePipeline PipelineCache::createPipeline(CreateInfo createInfo, CreateFunc create) {
+        vk::PipelineCreationFeedback feedback{};
+        vk::PipelineCreationFeedbackCreateInfo feedbackInfo {
+            .pPipelineCreationFeedback = &feedback,
+        };
+        if(creationFeedbackSupported) {
+            feedbackInfo.pNext = createInfo.pNext;
+            createInfo.pNext = &feedbackInfo;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        vk::UniquePipeline pipeline = create(createInfo);
+        recordCreation(std::chrono::steady_clock::now() - start, feedback);
+        return pipeline;
+    }
+
+    vk::UniquePipeline PipelineCache::createGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& createInfo) {
+        return createPipeline(createInfo, [&](const vk::GraphicsPipelineCreateInfo& info) {
+            return std::move(driver.getLogicalDevice().createGraphicsPipelineUnique(*cache, info, driver.getAllocationCallbacks()).value);
+        });
+    }
+
+    vk::UniquePipeline PipelineCache::createComputePipeline(const vk::ComputePipelineCreateInfo& createInfo) {
+        return createPipeline(createInfo, [&](const vk::ComputePipelineCreateInfo& info) {
+            return std::move(driver.getLogicalDevice().createComputePipelineUnique(*cache, info, driver.getAllocationCallbacks()).value);
+        });
+    }
+
+    void PipelineCache::recordCreation(std::chrono::nanoseconds duration, const vk::PipelineCreationFeedback& feedback) {
+        createdPipelines++;
+        if(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eValid) {
+            if(feedback.flags & vk::PipelineCreationFeedbackFlagBits::eApplicationPipelineCacheHit) {
+                cacheHits++;
+            } else {
+                cacheMisses++;
+            }
+        }
+
+        const std::int64_t durationNs = duration.count();
+        totalCreationTimeNs += durationNs;
+        std::int64_t previousMax = maxCreationTimeNs.load();
+        while(previousMax < durationNs && !maxCreationTimeNs.compare_exchange_weak(previousMax, durationNs)) {}
+    }
+
+    void PipelineCache::onAsyncCompilationStart() {
+        pendingPipelines++;
+    }
+
+    void PipelineCache::onAsyncCompilationEnd() {
+        pendingPipelines--;
+    }
+
+    PipelineCache::Statistics PipelineCache::getStatistics() const {
+        return Statistics {
+            .createdPipelines = createdPipelines.load(),
+            .cacheHits = cacheHits.load(),
+            .cacheMisses = cacheMisses.load(),
+            .pendingPipelines = pendingPipelines.load(),
+            .totalCreationTime = std::chrono::nanoseconds { totalCreationTimeNs.load() },
+            .maxCreationTime = std::chrono::nanoseconds { maxCreationTimeNs.load() },
+        };
+    }
+
+    void PipelineCache::showDebugWindow(bool& isOpen) const {
+        if(ImGui::Begin("Pipeline cache", &isOpen)) {
+            const Statistics stats = getStatistics();
+            const double totalMs = std::chrono::duration<double, std::milli>(stats.totalCreationTime).count();
+            const double maxMs = std::chrono::duration<double, std::milli>(stats.maxCreationTime).count();
+
+            ImGui::Text("File: %s", cacheFile.empty() ? "<in memory>" : cacheFile.string().c_str());
+            ImGui::Text("Created pipelines: %llu", stats.createdPipelines);
+            ImGui::Text("Pending pipelines: %llu", stats.pendingPipelines);
+            if(creationFeedbackSupported) {
+                ImGui::Text("Cache hits: %llu", stats.cacheHits);
+                ImGui::Text("Cache misses: %llu", stats.cacheMisses);
+            } else {
+                ImGui::TextUnformatted(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME " is not supported, hits and misses are unknown.");
+            }
+            ImGui::Text("Total creation time: %.2f ms", totalMs);
+            ImGui::Text("Average creation time: %.2f ms", stats.createdPipelines > 0 ? totalMs / stats.createdPipelines : 0.0);
+            ImGui::Text("Max creation time: %.2f ms", maxMs);
+        }
+        ImGui::End();
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include <engine/vulkan/includes.h>
+
+namespace Carrot {
+    class VulkanDriver;
+}
+
+namespace Carrot::Render {
+    /**
+     * Wraps the VkPipelineCache used to create all pipelines of the engine, and persists it to disk between runs.
+     * The saved file starts with a header identifying the device & driver which produced it, stale or corrupted files
+     * are ignored (the cache starts empty in that case).
+     * All creation functions can be called from any thread.
+     */
+    class PipelineCache {
+    public:
+        struct Statistics {
+            std::uint64_t createdPipelines = 0;
+
+            /// Pipelines which the driver found inside the cache. Only available with VK_EXT_pipeline_creation_feedback
+            std::uint64_t cacheHits = 0;
+            /// Pipelines which the driver had to compile. Only available with VK_EXT_pipeline_creation_feedback
+            std::uint64_t cacheMisses = 0;
+
+            /// Pipelines currently compiled asynchronously (see Pipeline)
+            std::uint64_t pendingPipelines = 0;
+
+            std::chrono::nanoseconds totalCreationTime{0};
+            std::chrono::nanoseconds maxCreationTime{0};
+        };
+
+        /// Bump when the layout of the file header changes
+        static constexpr std::uint32_t FileVersion = 1;
+
+        /**
+         * @param driver driver owning the device to create pipelines on
+         * @param cacheFile where to load/save the cache. Empty path to keep the cache in memory only
+         * @param creationFeedbackSupported whether VK_EXT_pipeline_creation_feedback is enabled on the device, used for hit/miss statistics
+         */
+        explicit PipelineCache(VulkanDriver& driver, std::filesystem::path cacheFile, bool creationFeedbackSupported);
+        ~PipelineCache();
+
+        /// Writes the contents of the cache to disk. Called automatically on destruction
+        void save();
+
+        vk::UniquePipeline createGraphicsPipeline(const vk::GraphicsPipelineCreateInfo& createInfo);
+        vk::UniquePipeline createComputePipeline(const vk::ComputePipelineCreateInfo& createInfo);
+
+        vk::PipelineCache getVulkanCache() const { return *cache; }
+
+    public: // statistics
+        Statistics getStatistics() const;
+
+        void onAsyncCompilationStart();
+        void onAsyncCompilationEnd();
+
+        void showDebugWindow(bool& isOpen) const;
+
+    public:
+        /**
+         * Checks that 'fileContents' (contents of a file written by 'save') was produced by the device with the given properties,
+         * and returns the part which can be given to Vulkan. Returns an empty span if the file cannot be used.
+         */
+        static std::span<const std::uint8_t> validate(std::span<const std::uint8_t> fileContents, const vk::PhysicalDeviceProperties& properties);
+
+        /// Builds the contents of a cache file, from the data returned by vkGetPipelineCacheData
+        static std::vector<std::uint8_t> encode(std::span<const std::uint8_t> cacheData, const vk::PhysicalDeviceProperties& properties);
+
+    private:
+        template<typename CreateInfo, typename CreateFunc>
+        vk::UniquePipeline createPipeline(CreateInfo createInfo, CreateFunc create);
+
+        void recordCreation(std::chrono::nanoseconds duration, const vk::PipelineCreationFeedback& feedback);
+
+        VulkanDriver& driver;
+        std::filesystem::path cacheFile;
+        bool creationFeedbackSupported = false;
+        vk::PhysicalDeviceProperties deviceProperties;
+        vk::UniquePipelineCache cache;
+
+        std::atomic<std::uint64_t> createdPipelines = 0;
+        std::atomic<std::uint64_t> cacheHits = 0;
+        std::atomic<std::uint64_t> cacheMisses = 0;
+        std::atomic<std::uint64_t> pendingPipelines = 0;
+        std::atomic<std::int64_t> totalCreationTimeNs = 0;
+        std::atomic<std::int64_t> maxCreationTimeNs = 0;
+    };
+}
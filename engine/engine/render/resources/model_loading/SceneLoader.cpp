@@ -4,20 +4,52 @@
 
 #include "SceneLoader.h"
 #include <core/scene/AssimpLoader.h>
+#include <core/scene/CookedModel.h>
 #include <core/scene/GLTFLoader.h>
 #include <core/utils/stringmanip.h>
+#include <core/io/Logging.hpp>
+#include <core/Macros.h>
 #include <engine/io/AssimpCompatibilityLayer.h>
 
 #include <assimp/Importer.hpp>
 
 namespace Carrot::Render {
+    bool SceneLoader::loadCooked(const Carrot::IO::Resource& gltfFile) {
+        const IO::VFS::Path gltfPath { gltfFile.getName() };
+        const IO::VFS::Path cookedPath = gltfPath.withExtension(CookedModel::Extension);
+        if(!GetVFS().exists(cookedPath)) {
+            return false;
+        }
+
+        // a glTF modified after being processed by Fertilizer no longer matches its cooked model
+        std::error_code ec;
+        const auto gltfTimestamp = std::filesystem::last_write_time(gltfFile.getFilepath(), ec);
+        const auto cookedTimestamp = std::filesystem::last_write_time(GetVFS().resolve(cookedPath), ec);
+        if(ec || cookedTimestamp < gltfTimestamp) {
+            return false;
+        }
+
+        try {
+            scene = std::move(CookedModel::load(IO::Resource { cookedPath }, gltfPath));
+            scene.debugName = gltfFile.getName();
+            return true;
+        } catch(std::exception& e) {
+            Carrot::Log::warn("Could not load cooked model %s, falling back to glTF: %s", cookedPath.toString().c_str(), e.what());
+            return false;
+        }
+    }
+
     LoadedScene& SceneLoader::load(const Carrot::IO::Resource& file) {
         verify(file.isFile(), "In-memory models are not supported!");
         const Carrot::IO::Path filePath { Carrot::toString(file.getFilepath().u8string()).c_str() };
 
-        if(filePath.getExtension() == ".gltf") {
-            Render::GLTFLoader loader;
-            scene = std::move(loader.load(file));
+        if(filePath.getExtension() == CookedModel::Extension) {
+            scene = std::move(CookedModel::load(file, IO::VFS::Path { file.getName() }));
+        } else if(filePath.getExtension() == ".gltf") {
+            if(!loadCooked(file)) {
+                Render::GLTFLoader loader;
+                scene = std::move(loader.load(file));
+            }
         } else {
             Render::AssimpLoader loader;
             Assimp::Importer importer{};
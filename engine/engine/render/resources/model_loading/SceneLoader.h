@@ -16,6 +16,10 @@ namespace Carrot::Render {
         LoadedScene& load(const Carrot::IO::Resource& resource);
 
     private:
+        /// Loads the cooked model written by Fertilizer next to 'gltfFile', if there is an up-to-date one.
+        /// Returns false if the glTF must be loaded instead
+        bool loadCooked(const Carrot::IO::Resource& gltfFile);
+
         LoadedScene scene;
     };
 
@@ -0,0 +1,664 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "BinaryScene.h"
+#include <bit>
+#include <memory>
+#include <unordered_map>
+#include <core/async/Counter.h>
+#include <core/io/Resource.h>
+#include <core/io/Serialisation.h>
+#include <core/utils/stringmanip.h>
+#include <engine/assets/AssetServer.h>
+#include <engine/scene/Scene.h>
+#include <engine/task/TaskScheduler.h>
+#include <engine/utils/Macros.h>
+#include <engine/utils/Profiling.h>
+
+namespace Carrot::BinaryScene {
+    enum class ValueTag: std::uint8_t {
+        Null,
+        False,
+        True,
+        Int64,
+        Uint64,
+        Double,
+        String,
+        EntityReference, //< u32 index of an entity of the scene
+        Array,
+        Object,
+    };
+
+    /// Keys of entity objects which are stored in entity records instead of component blocks
+    static bool isEntityProperty(std::string_view key) {
+        return key == "name" || key == "parent" || key == "flags";
+    }
+
+    static void append(std::vector<std::uint8_t>& destination, const std::vector<std::uint8_t>& data) {
+        destination.insert(destination.end(), data.begin(), data.end());
+    }
+
+    template<typename T>
+    static void appendValue(std::vector<std::uint8_t>& destination, const T& value) {
+        std::vector<std::uint8_t> bytes;
+        IO::VectorWriter writer { bytes };
+        writer << value;
+        append(destination, bytes);
+    }
+
+    static rapidjson::Value copyString(const std::string& str, rapidjson::Document::AllocatorType& allocator) {
+        return rapidjson::Value{str.c_str(), static_cast<rapidjson::SizeType>(str.size()), allocator};
+    }
+
+    /// Encodes JSON values, and builds the string table while doing so
+    class Encoder {
+    public:
+        explicit Encoder(const rapidjson::Value& entities) {
+            for(const auto& [key, _] : entities.GetObject()) {
+                entityIndices.emplace(std::string { key.GetString(), key.GetStringLength() }, static_cast<std::uint32_t>(entityIndices.size()));
+            }
+        }
+
+        std::uint32_t getStringIndex(std::string_view str) {
+            auto [it, inserted] = stringIndices.try_emplace(std::string { str }, static_cast<std::uint32_t>(strings.size()));
+            if(inserted) {
+                strings.emplace_back(it->first);
+                referenceCounts.emplace_back(0);
+            }
+            referenceCounts[it->second]++;
+            return it->second;
+        }
+
+        void write(IO::VectorWriter& out, const rapidjson::Value& value) {
+            if(value.IsNull()) {
+                writeTag(out, ValueTag::Null);
+            } else if(value.IsBool()) {
+                writeTag(out, value.GetBool() ? ValueTag::True : ValueTag::False);
+            } else if(value.IsDouble()) {
+                writeTag(out, ValueTag::Double);
+                out << value.GetDouble();
+            } else if(value.IsInt64()) {
+                writeTag(out, ValueTag::Int64);
+                out << std::bit_cast<std::uint64_t>(value.GetInt64());
+            } else if(value.IsUint64()) {
+                writeTag(out, ValueTag::Uint64);
+                out << static_cast<std::uint64_t>(value.GetUint64());
+            } else if(value.IsString()) {
+                const std::string str { value.GetString(), value.GetStringLength() };
+                if(auto entityIt = entityIndices.find(str); entityIt != entityIndices.end()) {
+                    writeTag(out, ValueTag::EntityReference);
+                    out << entityIt->second;
+                } else {
+                    writeTag(out, ValueTag::String);
+                    out << getStringIndex(str);
+                }
+            } else if(value.IsArray()) {
+                writeTag(out, ValueTag::Array);
+                out << static_cast<std::uint32_t>(value.Size());
+                for(const auto& element : value.GetArray()) {
+                    write(out, element);
+                }
+            } else {
+                writeObject(out, value);
+            }
+        }
+
+        /// Writes an object, without the member named 'skippedMember' (if any)
+        void writeObject(IO::VectorWriter& out, const rapidjson::Value& object, std::string_view skippedMember = {}) {
+            writeTag(out, ValueTag::Object);
+            std::uint32_t memberCount = 0;
+            for(const auto& [key, _] : object.GetObject()) {
+                if(std::string_view { key.GetString(), key.GetStringLength() } != skippedMember) {
+                    memberCount++;
+                }
+            }
+            out << memberCount;
+            for(const auto& [key, member] : object.GetObject()) {
+                const std::string_view keyStr { key.GetString(), key.GetStringLength() };
+                if(keyStr == skippedMember) {
+                    continue;
+                }
+                out << getStringIndex(keyStr);
+                write(out, member);
+            }
+        }
+
+        void writeStringTable(IO::VectorWriter& out) const {
+            out << static_cast<std::uint32_t>(strings.size());
+            for(std::size_t i = 0; i < strings.size(); i++) {
+                out << referenceCounts[i];
+                // not VectorWriter::operator<<(std::string), which writes a 64-bit length
+                out << static_cast<std::uint32_t>(strings[i].size());
+                for(const char c : strings[i]) {
+                    out << c;
+                }
+            }
+        }
+
+    private:
+        static void writeTag(IO::VectorWriter& out, ValueTag tag) {
+            out << static_cast<std::uint8_t>(tag);
+        }
+
+        std::unordered_map<std::string, std::uint32_t> stringIndices;
+        std::vector<std::string> strings;
+        std::vector<std::uint32_t> referenceCounts;
+        std::unordered_map<std::string, std::uint32_t> entityIndices;
+    };
+
+    struct StringTable {
+        std::vector<std::string> strings;
+        std::vector<std::int64_t> referenceCounts;
+
+        const std::string& get(std::uint32_t index) const {
+            if(index >= strings.size()) {
+                throw std::runtime_error(Carrot::sprintf("Invalid string index %u", index));
+            }
+            return strings[index];
+        }
+    };
+
+    /// Decodes values back to JSON
+    class Decoder {
+    public:
+        /// If 'copyStrings' is false, decoded values reference 'strings' and 'entityIDs', and must not outlive them
+        Decoder(const StringTable& strings, const std::vector<std::string>& entityIDs, bool copyStrings)
+        : strings(strings), entityIDs(entityIDs), copyStrings(copyStrings) {}
+
+        rapidjson::Value read(IO::VectorReader& in, rapidjson::Document::AllocatorType& allocator) const {
+            std::uint8_t tag;
+            in >> tag;
+            switch(static_cast<ValueTag>(tag)) {
+                case ValueTag::Null:
+                    return rapidjson::Value{};
+                case ValueTag::False:
+                    return rapidjson::Value{false};
+                case ValueTag::True:
+                    return rapidjson::Value{true};
+
+                case ValueTag::Int64: {
+                    std::uint64_t v;
+                    in >> v;
+                    return rapidjson::Value{std::bit_cast<std::int64_t>(v)};
+                }
+
+                case ValueTag::Uint64: {
+                    std::uint64_t v;
+                    in >> v;
+                    return rapidjson::Value{v};
+                }
+
+                case ValueTag::Double: {
+                    double v;
+                    in >> v;
+                    return rapidjson::Value{v};
+                }
+
+                case ValueTag::String: {
+                    std::uint32_t index;
+                    in >> index;
+                    return makeString(strings.get(index), allocator);
+                }
+
+                case ValueTag::EntityReference: {
+                    std::uint32_t index;
+                    in >> index;
+                    if(index >= entityIDs.size()) {
+                        throw std::runtime_error(Carrot::sprintf("Invalid entity index %u", index));
+                    }
+                    return makeString(entityIDs[index], allocator);
+                }
+
+                case ValueTag::Array: {
+                    std::uint32_t count;
+                    in >> count;
+                    rapidjson::Value array{rapidjson::kArrayType};
+                    array.Reserve(count, allocator);
+                    for(std::uint32_t i = 0; i < count; i++) {
+                        array.PushBack(read(in, allocator), allocator);
+                    }
+                    return array;
+                }
+
+                case ValueTag::Object: {
+                    std::uint32_t count;
+                    in >> count;
+                    rapidjson::Value object{rapidjson::kObjectType};
+                    for(std::uint32_t i = 0; i < count; i++) {
+                        std::uint32_t keyIndex;
+                        in >> keyIndex;
+                        rapidjson::Value key = makeString(strings.get(keyIndex), allocator);
+                        object.AddMember(key, read(in, allocator), allocator);
+                    }
+                    return object;
+                }
+
+                default:
+                    throw std::runtime_error(Carrot::sprintf("Invalid value tag %u", static_cast<std::uint32_t>(tag)));
+            }
+        }
+
+        /// Advances 'in' past the next value, without decoding it
+        static void skip(IO::VectorReader& in) {
+            std::uint8_t tag;
+            in >> tag;
+            std::uint32_t u32;
+            std::uint64_t u64;
+            switch(static_cast<ValueTag>(tag)) {
+                case ValueTag::Null:
+                case ValueTag::False:
+                case ValueTag::True:
+                    break;
+
+                case ValueTag::Int64:
+                case ValueTag::Uint64:
+                case ValueTag::Double:
+                    in >> u64;
+                    break;
+
+                case ValueTag::String:
+                case ValueTag::EntityReference:
+                    in >> u32;
+                    break;
+
+                case ValueTag::Array: {
+                    std::uint32_t count;
+                    in >> count;
+                    for(std::uint32_t i = 0; i < count; i++) {
+                        skip(in);
+                    }
+                } break;
+
+                case ValueTag::Object: {
+                    std::uint32_t count;
+                    in >> count;
+                    for(std::uint32_t i = 0; i < count; i++) {
+                        in >> u32; // key
+                        skip(in);
+                    }
+                } break;
+
+                default:
+                    throw std::runtime_error(Carrot::sprintf("Invalid value tag %u", static_cast<std::uint32_t>(tag)));
+            }
+        }
+
+    private:
+        rapidjson::Value makeString(const std::string& str, rapidjson::Document::AllocatorType& allocator) const {
+            if(copyStrings) {
+                return copyString(str, allocator);
+            }
+            return rapidjson::Value{rapidjson::StringRef(str.c_str(), str.size())};
+        }
+
+        const StringTable& strings;
+        const std::vector<std::string>& entityIDs;
+        bool copyStrings = true;
+    };
+
+    /// Components of a single type
+    struct ComponentBlock {
+        std::uint32_t typeName = 0;
+        std::uint32_t componentCount = 0;
+        std::vector<std::uint8_t> data;
+
+        rapidjson::Document document; //< owns the memory of 'components'
+        std::vector<std::pair<std::uint32_t, rapidjson::Value>> components; //< entity index + component JSON
+        std::string error; //< not empty if decoding failed
+
+        void decode(const Decoder& decoder) {
+            IO::VectorReader reader { data };
+            components.reserve(componentCount);
+            for(std::uint32_t i = 0; i < componentCount; i++) {
+                std::uint32_t entityIndex;
+                reader >> entityIndex;
+                components.emplace_back(entityIndex, decoder.read(reader, document.GetAllocator()));
+            }
+        }
+    };
+
+    struct EntityRecord {
+        EntityID id;
+        std::uint32_t name = 0;
+        rapidjson::Value parent;
+        rapidjson::Value flags;
+    };
+
+    /// Reads a binary scene section by section, the entire file is never loaded at once
+    class StreamReader {
+    public:
+        StringTable strings;
+        std::vector<std::uint8_t> settingsData;
+        std::uint32_t blockCount = 0;
+
+        rapidjson::Document entityDocument; //< owns the memory of parents and flags inside 'entities'
+        std::vector<EntityRecord> entities;
+        std::vector<std::string> entityIDs; //< string version of entity IDs, referenced by decoded values
+
+        /// Reads the header, string table, settings and entities. 'remapIDs' generates new IDs for entities
+        explicit StreamReader(const IO::Resource& resource, bool remapIDs): resource(resource) {
+            if(readValue<std::uint32_t>() != Magic) {
+                throw std::runtime_error("Not a binary scene");
+            }
+            const std::uint32_t version = readValue<std::uint32_t>();
+            if(version != Version) {
+                throw std::runtime_error(Carrot::sprintf("Unsupported binary scene version %u (expected %u)", version, Version));
+            }
+
+            readStringTable();
+            settingsData = readSection();
+            readEntities(remapIDs);
+            blockCount = readValue<std::uint32_t>();
+        }
+
+        std::unique_ptr<ComponentBlock> readBlock() {
+            auto pBlock = std::make_unique<ComponentBlock>();
+            pBlock->typeName = readValue<std::uint32_t>();
+            pBlock->componentCount = readValue<std::uint32_t>();
+            pBlock->data = readSection();
+            return pBlock;
+        }
+
+    private:
+        void readStringTable() {
+            std::vector<std::uint8_t> data = readSection();
+            IO::VectorReader reader { data };
+            std::uint32_t count;
+            reader >> count;
+            strings.strings.resize(count);
+            strings.referenceCounts.resize(count);
+            for(std::uint32_t i = 0; i < count; i++) {
+                std::uint32_t referenceCount;
+                reader >> referenceCount;
+                reader >> strings.strings[i];
+                strings.referenceCounts[i] = referenceCount;
+            }
+        }
+
+        void readEntities(bool remapIDs) {
+            std::vector<std::uint8_t> data = readSection();
+            std::uint32_t count;
+
+            // IDs first: parents can be stored after their children
+            IO::VectorReader idReader { data };
+            idReader >> count;
+            entities.resize(count);
+            entityIDs.resize(count);
+            for(std::uint32_t i = 0; i < count; i++) {
+                std::uint32_t id[4];
+                idReader >> id[0] >> id[1] >> id[2] >> id[3];
+                idReader >> entities[i].name;
+                Decoder::skip(idReader); // parent
+                Decoder::skip(idReader); // flags
+
+                entities[i].id = remapIDs ? Carrot::UUID{} : Carrot::UUID{ id[0], id[1], id[2], id[3] };
+                entityIDs[i] = entities[i].id.toString();
+            }
+
+            IO::VectorReader propertyReader { data };
+            propertyReader >> count;
+            const Decoder decoder { strings, entityIDs, false };
+            for(std::uint32_t i = 0; i < count; i++) {
+                std::uint32_t skipped;
+                for(int j = 0; j < 5; j++) { // ID + name
+                    propertyReader >> skipped;
+                }
+                entities[i].parent = decoder.read(propertyReader, entityDocument.GetAllocator());
+                entities[i].flags = decoder.read(propertyReader, entityDocument.GetAllocator());
+            }
+        }
+
+        std::vector<std::uint8_t> read(std::uint64_t size) {
+            if(offset + size > resource.getSize()) {
+                throw std::runtime_error("Truncated binary scene");
+            }
+            std::vector<std::uint8_t> bytes;
+            bytes.resize(size);
+            resource.read(bytes, offset);
+            offset += size;
+            return bytes;
+        }
+
+        template<typename T>
+        T readValue() {
+            std::vector<std::uint8_t> bytes = read(sizeof(T));
+            IO::VectorReader reader { bytes };
+            T value;
+            reader >> value;
+            return value;
+        }
+
+        std::vector<std::uint8_t> readSection() {
+            return read(readValue<std::uint64_t>());
+        }
+
+        const IO::Resource& resource;
+        std::uint64_t offset = 0;
+    };
+
+    bool isBinaryScene(const Carrot::IO::VFS::Path& path) {
+        return path.getExtension() == Extension;
+    }
+
+    std::vector<std::uint8_t> fromJSON(const rapidjson::Value& sceneJSON) {
+        ZoneScoped;
+        const rapidjson::Value& entities = sceneJSON["entities"];
+        Encoder encoder { entities };
+
+        std::vector<std::uint8_t> settingsData;
+        {
+            IO::VectorWriter writer { settingsData };
+            encoder.writeObject(writer, sceneJSON, "entities");
+        }
+
+        struct Block {
+            std::uint32_t typeName = 0;
+            std::uint32_t componentCount = 0;
+            std::vector<std::uint8_t> data;
+        };
+        std::vector<Block> blocks;
+        std::unordered_map<std::string, std::size_t> blockIndices;
+
+        std::vector<std::uint8_t> entityData;
+        {
+            const rapidjson::Value null{};
+            IO::VectorWriter writer { entityData };
+            writer << static_cast<std::uint32_t>(entities.MemberCount());
+            std::uint32_t entityIndex = 0;
+            for(const auto& [key, entity] : entities.GetObject()) {
+                const EntityID id { std::string { key.GetString(), key.GetStringLength() } };
+                writer << id.data0() << id.data1() << id.data2() << id.data3();
+                writer << encoder.getStringIndex(entity["name"].GetString());
+                encoder.write(writer, entity.HasMember("parent") ? entity["parent"] : null);
+                encoder.write(writer, entity.HasMember("flags") ? entity["flags"] : null);
+
+                for(const auto& [componentKey, componentJSON] : entity.GetObject()) {
+                    const std::string componentName { componentKey.GetString(), componentKey.GetStringLength() };
+                    if(isEntityProperty(componentName)) {
+                        continue;
+                    }
+                    auto [it, inserted] = blockIndices.try_emplace(componentName, blocks.size());
+                    if(inserted) {
+                        blocks.emplace_back().typeName = encoder.getStringIndex(componentName);
+                    }
+
+                    std::vector<std::uint8_t> componentData;
+                    IO::VectorWriter componentWriter { componentData };
+                    componentWriter << entityIndex;
+                    encoder.write(componentWriter, componentJSON);
+
+                    Block& block = blocks[it->second];
+                    append(block.data, componentData);
+                    block.componentCount++;
+                }
+                entityIndex++;
+            }
+        }
+
+        std::vector<std::uint8_t> stringData;
+        {
+            IO::VectorWriter writer { stringData };
+            encoder.writeStringTable(writer);
+        }
+
+        std::vector<std::uint8_t> result;
+        appendValue(result, Magic);
+        appendValue(result, Version);
+        for(const auto* pSection : { &stringData, &settingsData, &entityData }) {
+            appendValue(result, static_cast<std::uint64_t>(pSection->size()));
+            append(result, *pSection);
+        }
+        appendValue(result, static_cast<std::uint32_t>(blocks.size()));
+        for(const Block& block : blocks) {
+            appendValue(result, block.typeName);
+            appendValue(result, block.componentCount);
+            appendValue(result, static_cast<std::uint64_t>(block.data.size()));
+            append(result, block.data);
+        }
+        return result;
+    }
+
+    void toJSON(const std::vector<std::uint8_t>& binaryScene, rapidjson::Document& out) {
+        ZoneScoped;
+        const IO::Resource resource { std::span<const std::uint8_t> { binaryScene } };
+        StreamReader reader { resource, false };
+
+        auto& allocator = out.GetAllocator();
+        const Decoder decoder { reader.strings, reader.entityIDs, true };
+        IO::VectorReader settingsReader { reader.settingsData };
+        rapidjson::Value settings = decoder.read(settingsReader, allocator);
+        if(!settings.IsObject()) {
+            throw std::runtime_error("Invalid scene settings");
+        }
+        static_cast<rapidjson::Value&>(out) = settings;
+
+        std::vector<rapidjson::Value> entityObjects;
+        entityObjects.reserve(reader.entities.size());
+        for(const auto& entity : reader.entities) {
+            rapidjson::Value& entityObject = entityObjects.emplace_back(rapidjson::kObjectType);
+            entityObject.AddMember("name", copyString(reader.strings.get(entity.name), allocator), allocator);
+            // parent and flags reference the reader's strings
+            if(entity.parent.IsString()) {
+                entityObject.AddMember("parent", copyString(std::string { entity.parent.GetString(), entity.parent.GetStringLength() }, allocator), allocator);
+            }
+            if(entity.flags.IsString()) {
+                entityObject.AddMember("flags", copyString(std::string { entity.flags.GetString(), entity.flags.GetStringLength() }, allocator), allocator);
+            }
+        }
+
+        for(std::uint32_t blockIndex = 0; blockIndex < reader.blockCount; blockIndex++) {
+            auto pBlock = reader.readBlock();
+            pBlock->decode(decoder);
+            const std::string& typeName = reader.strings.get(pBlock->typeName);
+            for(auto& [entityIndex, componentJSON] : pBlock->components) {
+                if(entityIndex >= entityObjects.size()) {
+                    throw std::runtime_error(Carrot::sprintf("Invalid entity index %u", entityIndex));
+                }
+                entityObjects[entityIndex].AddMember(copyString(typeName, allocator), rapidjson::Value{componentJSON, allocator}, allocator);
+            }
+        }
+
+        rapidjson::Value entities{rapidjson::kObjectType};
+        for(std::size_t i = 0; i < entityObjects.size(); i++) {
+            entities.AddMember(copyString(reader.entityIDs[i], allocator), entityObjects[i], allocator);
+        }
+        out.AddMember("entities", entities, allocator);
+    }
+
+    void load(const Carrot::IO::VFS::Path& path, Scene& scene, const LoadOptions& options) {
+        IO::Resource resource { path };
+        resource.open();
+        load(resource, scene, options);
+    }
+
+    void load(const IO::Resource& resource, Scene& scene, const LoadOptions& options) {
+        ZoneScoped;
+        StreamReader reader { resource, options.remapEntityIDs };
+        // the string table contains every path referenced by the scene: start converting assets before creating components
+        GetAssetServer().prefetchStrings(reader.strings.strings, reader.strings.referenceCounts);
+
+        const Decoder decoder { reader.strings, reader.entityIDs, false };
+        Async::Counter decodingDone;
+        auto waitForDecoding = [&]() {
+            // main thread will help
+            while(!decodingDone.isIdle()) {
+                GetTaskScheduler().stealJobAndRun(TaskScheduler::FrameParallelWork);
+            }
+        };
+
+        // decoded values reference the strings of 'reader' and the memory of 'blocks': both must outlive Scene::deserialise
+        std::vector<std::unique_ptr<ComponentBlock>> blocks;
+        rapidjson::Document sceneJSON;
+        auto& allocator = sceneJSON.GetAllocator();
+        std::vector<rapidjson::Value> entityObjects;
+        try {
+            // decode each block while the next ones are read
+            blocks.reserve(reader.blockCount);
+            for(std::uint32_t blockIndex = 0; blockIndex < reader.blockCount; blockIndex++) {
+                ComponentBlock* pBlock = blocks.emplace_back(reader.readBlock()).get();
+                GetTaskScheduler().schedule(TaskDescription {
+                    .name = "Decode scene component block",
+                    .task = [pBlock, &decoder](Carrot::TaskHandle&) {
+                        try {
+                            pBlock->decode(decoder);
+                        } catch(std::exception& e) {
+                            pBlock->error = e.what();
+                        }
+                    },
+                    .joiner = &decodingDone,
+                }, TaskScheduler::FrameParallelWork);
+            }
+
+            // settings and entity records while blocks are decoded
+            IO::VectorReader settingsReader { reader.settingsData };
+            rapidjson::Value settingsValue = decoder.read(settingsReader, allocator);
+            if(!settingsValue.IsObject()) {
+                throw std::runtime_error("Invalid scene settings");
+            }
+            static_cast<rapidjson::Value&>(sceneJSON) = settingsValue;
+
+            entityObjects.reserve(reader.entities.size());
+            for(auto& record : reader.entities) {
+                rapidjson::Value& entityObject = entityObjects.emplace_back(rapidjson::kObjectType);
+                const std::string& name = reader.strings.get(record.name);
+                entityObject.AddMember("name", rapidjson::Value{rapidjson::StringRef(name.c_str(), name.size())}, allocator);
+                if(record.parent.IsString()) {
+                    entityObject.AddMember("parent", record.parent, allocator);
+                }
+                if(record.flags.IsString()) {
+                    entityObject.AddMember("flags", record.flags, allocator);
+                }
+            }
+        } catch(...) {
+            // tasks reference local variables
+            waitForDecoding();
+            throw;
+        }
+        waitForDecoding();
+
+        for(const auto& pBlock : blocks) {
+            const std::string& typeName = reader.strings.get(pBlock->typeName);
+            if(!pBlock->error.empty()) {
+                throw std::runtime_error(Carrot::sprintf("Failed to decode components of type %s: %s", typeName.c_str(), pBlock->error.c_str()));
+            }
+            for(auto& [entityIndex, componentJSON] : pBlock->components) {
+                if(entityIndex >= entityObjects.size()) {
+                    throw std::runtime_error(Carrot::sprintf("Invalid entity index %u", entityIndex));
+                }
+                entityObjects[entityIndex].AddMember(rapidjson::StringRef(typeName.c_str(), typeName.size()), componentJSON, allocator);
+            }
+        }
+
+        rapidjson::Value entities{rapidjson::kObjectType};
+        for(std::size_t i = 0; i < entityObjects.size(); i++) {
+            const std::string& id = reader.entityIDs[i];
+            entities.AddMember(rapidjson::StringRef(id.c_str(), id.size()), entityObjects[i], allocator);
+        }
+        sceneJSON.AddMember("entities", entities, allocator);
+
+        // same path as JSON scenes: world data, then each entity with its components, then systems. Component
+        // constructors access engine systems (physics, lights, scripting), so this stays on the loading thread
+        scene.deserialise(sceneJSON);
+    }
+}
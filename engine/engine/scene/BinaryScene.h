@@ -0,0 +1,69 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <rapidjson/document.h>
+#include <core/io/vfs/VirtualFileSystem.h>
+
+namespace Carrot {
+    class Scene;
+}
+
+namespace Carrot::IO {
+    class Resource;
+}
+
+/**
+ * Binary container for scenes. The JSON representation (see Scene::serialise) stays the source format, binary scenes are
+ * generated from it and are faster to load: no text parsing, strings are stored once, and components are grouped by type
+ * in blocks which are decoded in parallel.
+ *
+ * Layout (little-endian):
+ *  - Header: magic ("CSCN"), u32 version
+ *  - String table: u64 byte size, u32 count, then for each string: u32 reference count, u32 length, characters.
+ *    Contains every key and string value of the scene.
+ *  - Settings: u64 byte size, encoded scene JSON without its entities (world data, lighting, skybox, systems)
+ *  - Entities: u64 byte size, u32 count, then for each entity: UUID (4x u32), u32 name (string index), encoded parent, encoded flags
+ *  - Component blocks: u32 count, then for each component type: u32 type name (string index), u32 component count,
+ *    u64 byte size, then for each component: u32 entity index, encoded value
+ *
+ * Values are encoded as a tag byte followed by their data. Strings which are the ID of an entity of the scene are stored as
+ * the index of the entity instead, which allows IDs to be remapped when loading.
+ */
+namespace Carrot::BinaryScene {
+    constexpr std::uint32_t Magic = 0x4E435343; // "CSCN"
+    constexpr std::uint32_t Version = 1;
+    constexpr std::string_view Extension = ".cscene";
+
+    struct LoadOptions {
+        /// Gives new IDs to the loaded entities (and updates references to them). Allows to load the same scene multiple times inside a world
+        bool remapEntityIDs = false;
+    };
+
+    /// Is the given path a binary scene? (based on its extension)
+    bool isBinaryScene(const Carrot::IO::VFS::Path& path);
+
+    /// Converts the JSON representation of a scene (see Scene::serialise) to the binary format
+    std::vector<std::uint8_t> fromJSON(const rapidjson::Value& sceneJSON);
+
+    /// Converts a binary scene back to its JSON representation, which can be given to Scene::deserialise. Throws on invalid data
+    void toJSON(const std::vector<std::uint8_t>& binaryScene, rapidjson::Document& out);
+
+    /**
+     * Loads the binary scene at 'path' inside 'scene'.
+     * The file is read section by section, and component blocks are decoded on the TaskScheduler while the next ones are read.
+     * The decoded values are then given to Scene::deserialise, so the scene is created exactly like its JSON representation
+     * would be (world data, entities with their components, then systems). Inside an entity, components are added in the
+     * order of their blocks, as in the JSON returned by toJSON.
+     * Throws on invalid data.
+     */
+    void load(const Carrot::IO::VFS::Path& path, Scene& scene, const LoadOptions& options = {});
+
+    /// Loads the binary scene inside 'resource', see load(const Carrot::IO::VFS::Path&, Scene&, const LoadOptions&)
+    void load(const Carrot::IO::Resource& resource, Scene& scene, const LoadOptions& options = {});
+}
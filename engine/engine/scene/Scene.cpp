@@ -201,4 +201,18 @@ namespace Carrot {
         lighting = toCopy.lighting;
         skybox = toCopy.skybox;
     }
+
+    Scene::Snapshot Scene::takeSnapshot() {
+        return Snapshot {
+            .world = world.takeSnapshot(),
+            .lighting = lighting,
+            .skybox = skybox,
+        };
+    }
+
+    void Scene::restoreSnapshot(Snapshot&& snapshot) {
+        world.restoreSnapshot(std::move(snapshot.world));
+        lighting = snapshot.lighting;
+        skybox = snapshot.skybox;
+    }
 }
\ No newline at end of file
@@ -71,6 +71,26 @@ namespace Carrot {
         void copyFrom(const Scene& toCopy);
         Scene& operator=(const Scene& toCopy) = delete;
 
+    public:
+        /// Copy-on-write copy of a scene, see ECS::WorldSnapshot
+        struct Snapshot {
+            std::unique_ptr<Carrot::ECS::WorldSnapshot> world;
+            Lighting lighting;
+            Carrot::Skybox::Type skybox = Carrot::Skybox::Type::None;
+        };
+
+        /**
+         * Takes a snapshot of this scene. Cheap compared to copyFrom: the world is not copied immediately, only the parts
+         * modified after this call are saved.
+         */
+        Snapshot takeSnapshot();
+
+        /**
+         * Brings back the scene to the state it had when the snapshot was taken.
+         * Systems are replaced by the ones from the snapshot, and must be loaded (see load)
+         */
+        void restoreSnapshot(Snapshot&& snapshot);
+
     private:
         std::vector<Carrot::Render::Viewport*> viewports;
     };
@@ -5,6 +5,9 @@
 #include <core/io/Logging.hpp>
 #include "SceneManager.h"
 
+#include <engine/utils/Macros.h>
+#include <engine/assets/AssetServer.h>
+#include <engine/scene/BinaryScene.h>
 #include <core/scripting/csharp/Engine.h>
 #include <engine/scripting/CSharpBindings.h>
 #include <engine/scripting/CSharpReflectionHelper.h>
@@ -23,10 +26,15 @@ namespace Carrot {
         auto& scene = scenes.emplace_back();
         rapidjson::Document sceneDoc;
         try {
-            Carrot::IO::Resource sceneData = path;
-            sceneDoc.Parse(sceneData.readText());
-
-            scene.deserialise(sceneDoc);
+            if(BinaryScene::isBinaryScene(path)) {
+                BinaryScene::load(path, scene);
+            } else {
+                Carrot::IO::Resource sceneData = path;
+                sceneDoc.Parse(sceneData.readText());
+                GetAssetServer().prefetchScene(sceneDoc);
+
+                scene.deserialise(sceneDoc);
+            }
         } catch (std::exception& e) {
             Carrot::Log::error("Failed to open scene: %s", e.what());
             scene.clear();
@@ -37,10 +45,15 @@ namespace Carrot {
     Scene& SceneManager::loadSceneAdditive(const Carrot::IO::VFS::Path& path, Scene& addTo) {
         rapidjson::Document sceneDoc;
         try {
-            Carrot::IO::Resource sceneData = path;
-            sceneDoc.Parse(sceneData.readText());
-
-            addTo.deserialise(sceneDoc);
+            if(BinaryScene::isBinaryScene(path)) {
+                BinaryScene::load(path, addTo);
+            } else {
+                Carrot::IO::Resource sceneData = path;
+                sceneDoc.Parse(sceneData.readText());
+                GetAssetServer().prefetchScene(sceneDoc);
+
+                addTo.deserialise(sceneDoc);
+            }
         } catch (std::exception& e) {
             Carrot::Log::error("Failed to open scene: %s", e.what());
         }
@@ -51,11 +64,16 @@ namespace Carrot {
         rapidjson::Document sceneDoc;
         Scene& mainScene = getMainScene();
         try {
-            Carrot::IO::Resource sceneData = scenePath;
-            sceneDoc.Parse(sceneData.readText());
-
             mainScene.clear();
-            mainScene.deserialise(sceneDoc);
+            if(BinaryScene::isBinaryScene(scenePath)) {
+                BinaryScene::load(scenePath, mainScene);
+            } else {
+                Carrot::IO::Resource sceneData = scenePath;
+                sceneDoc.Parse(sceneData.readText());
+                GetAssetServer().prefetchScene(sceneDoc);
+
+                mainScene.deserialise(sceneDoc);
+            }
         } catch (std::exception& e) {
             Carrot::Log::error("Failed to open scene: %s", e.what());
             mainScene.clear();
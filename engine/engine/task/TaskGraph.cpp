@@ -0,0 +1,208 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include "TaskGraph.h"
+#include <algorithm>
+#include <chrono>
+#include <core/io/Logging.hpp>
+#include <core/utils/stringmanip.h>
+#include <engine/utils/Macros.h>
+#include <engine/utils/Profiling.h>
+
+namespace Carrot {
+    /// Weight of the latest measure in the estimated duration of nodes
+    constexpr float DurationSmoothing = 0.2f;
+
+    /// Nodes whose longest path is within this ratio of the critical path are considered on the critical path
+    constexpr float CriticalPathTolerance = 0.95f;
+
+    TaskGraph::TaskGraph(std::string name): name(std::move(name)) {}
+
+    TaskGraph::~TaskGraph() {
+        verify(!isRunning(), "Cannot destroy a TaskGraph while it is executing");
+    }
+
+    TaskGraph::NodeID TaskGraph::addNode(NodeDescription&& description) {
+        verify(!isRunning(), "Cannot modify a TaskGraph while it is executing");
+        verify(description.task, "No valid task");
+        const NodeID id = static_cast<NodeID>(nodes.size());
+        Node& node = nodes.emplace_back();
+        node.description = std::move(description);
+        dirty = true;
+        return id;
+    }
+
+    void TaskGraph::addDependency(NodeID before, NodeID after) {
+        verify(!isRunning(), "Cannot modify a TaskGraph while it is executing");
+        verify(before < nodes.size() && after < nodes.size(), "Invalid node ID");
+        verify(before != after, "A node cannot depend on itself");
+        auto& successors = nodes[before].successors;
+        if(std::find(successors.begin(), successors.end(), after) != successors.end()) {
+            return; // already present
+        }
+        successors.push_back(after);
+        nodes[after].predecessorCount++;
+        dirty = true;
+    }
+
+    void TaskGraph::compile() {
+        // Kahn's algorithm: if some nodes are never reached, they are part of a cycle
+        topologicalOrder.clear();
+        topologicalOrder.reserve(nodes.size());
+        roots.clear();
+
+        std::vector<std::uint32_t> remaining;
+        remaining.resize(nodes.size());
+        for(NodeID id = 0; id < nodes.size(); id++) {
+            remaining[id] = nodes[id].predecessorCount;
+            if(remaining[id] == 0) {
+                topologicalOrder.push_back(id);
+                roots.push_back(id);
+            }
+        }
+        for(std::size_t i = 0; i < topologicalOrder.size(); i++) {
+            for(const NodeID successor : nodes[topologicalOrder[i]].successors) {
+                if(--remaining[successor] == 0) {
+                    topologicalOrder.push_back(successor);
+                }
+            }
+        }
+
+        if(topologicalOrder.size() != nodes.size()) {
+            std::string nodesInCycle;
+            for(NodeID id = 0; id < nodes.size(); id++) {
+                if(remaining[id] != 0) {
+                    if(!nodesInCycle.empty()) {
+                        nodesInCycle += ", ";
+                    }
+                    nodesInCycle += nodes[id].description.name;
+                }
+            }
+            throw std::runtime_error(Carrot::sprintf("Task graph '%s' has a cycle between nodes: %s", name.c_str(), nodesInCycle.c_str()));
+        }
+        dirty = false;
+    }
+
+    void TaskGraph::execute(Async::Counter& done) {
+        verify(!isRunning(), "TaskGraph is already executing");
+        if(dirty) {
+            compile();
+        }
+        if(nodes.empty()) {
+            return;
+        }
+
+        prepareExecution();
+
+        pDone = &done;
+        done.increment();
+        remainingNodes = static_cast<std::uint32_t>(nodes.size());
+        for(const NodeID root : roots) {
+            scheduleNode(root);
+        }
+    }
+
+    void TaskGraph::executeAndWait() {
+        Async::Counter done;
+        execute(done);
+        while(!done.isIdle()) {
+            GetTaskScheduler().stealJobAndRun(TaskScheduler::FrameParallelWork);
+        }
+    }
+
+    bool TaskGraph::isRunning() const {
+        return remainingNodes.load() != 0;
+    }
+
+    std::size_t TaskGraph::getNodeCount() const {
+        return nodes.size();
+    }
+
+    void TaskGraph::prepareExecution() {
+        ZoneScoped;
+        auto durationOf = [](const Node& node) {
+            // never executed: consider all such nodes equal
+            return node.estimatedDuration < 0.0f ? 1e-6f : node.estimatedDuration;
+        };
+
+        for(Node& node : nodes) {
+            node.longestPathToNode = 0.0f;
+        }
+        for(const NodeID id : topologicalOrder) {
+            Node& node = nodes[id];
+            const float endTime = node.longestPathToNode + durationOf(node);
+            for(const NodeID successor : node.successors) {
+                nodes[successor].longestPathToNode = std::max(nodes[successor].longestPathToNode, endTime);
+            }
+        }
+
+        float criticalPathLength = 0.0f;
+        for(auto it = topologicalOrder.rbegin(); it != topologicalOrder.rend(); ++it) {
+            Node& node = nodes[*it];
+            float longestSuccessorPath = 0.0f;
+            for(const NodeID successor : node.successors) {
+                longestSuccessorPath = std::max(longestSuccessorPath, nodes[successor].longestPathFromNode);
+            }
+            node.longestPathFromNode = durationOf(node) + longestSuccessorPath;
+            criticalPathLength = std::max(criticalPathLength, node.longestPathFromNode);
+        }
+
+        auto moreCritical = [&](NodeID a, NodeID b) {
+            return nodes[a].longestPathFromNode > nodes[b].longestPathFromNode;
+        };
+        std::sort(roots.begin(), roots.end(), moreCritical);
+        for(Node& node : nodes) {
+            std::sort(node.successors.begin(), node.successors.end(), moreCritical);
+
+            node.remainingPredecessors = node.predecessorCount;
+            node.effectivePriority = node.description.priority;
+            const bool onCriticalPath = node.longestPathToNode + node.longestPathFromNode >= criticalPathLength * CriticalPathTolerance;
+            if(onCriticalPath && node.effectivePriority != TaskPriority::FrameCritical) {
+                node.effectivePriority = static_cast<TaskPriority>(static_cast<std::uint8_t>(node.effectivePriority) - 1);
+            }
+        }
+    }
+
+    void TaskGraph::scheduleNode(NodeID nodeID) {
+        const Node& node = nodes[nodeID];
+        GetTaskScheduler().schedule(TaskDescription {
+            .name = node.description.name,
+            .task = [this, nodeID](TaskHandle& task) {
+                runNode(task, nodeID);
+            },
+            .priority = node.effectivePriority,
+            .stackSize = node.description.stackSize,
+        }, node.description.lane);
+    }
+
+    void TaskGraph::runNode(TaskHandle& task, NodeID nodeID) {
+        Node& node = nodes[nodeID];
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            node.description.task(task);
+        } catch(const std::exception& e) {
+            // successors must still run, otherwise the graph never finishes
+            Carrot::Log::error("Error while executing node '%s' of task graph '%s': %s", node.description.name.c_str(), name.c_str(), e.what());
+        }
+        const float duration = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        if(node.estimatedDuration < 0.0f) {
+            node.estimatedDuration = duration;
+        } else {
+            node.estimatedDuration += (duration - node.estimatedDuration) * DurationSmoothing;
+        }
+
+        // successors are sorted by criticality
+        for(const NodeID successor : node.successors) {
+            if(--nodes[successor].remainingPredecessors == 0) {
+                scheduleNode(successor);
+            }
+        }
+
+        // the graph can be executed again or destroyed as soon as 'done' is decremented, don't use 'this' afterwards
+        Async::Counter* pCounter = pDone;
+        if(--remainingNodes == 0) {
+            pCounter->decrement();
+        }
+    }
+}
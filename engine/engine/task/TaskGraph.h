@@ -0,0 +1,104 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <engine/task/TaskScheduler.h>
+
+namespace Carrot {
+    /**
+     * Set of tasks with dependencies between them, declared once and executed as many times as needed (eg. once per frame).
+     * Each node is scheduled on the TaskScheduler as soon as all its dependencies are finished.
+     *
+     * The duration of each node is measured at each execution, and used to estimate the critical path of the next one:
+     * nodes with the longest chain of work after them are scheduled first, and nodes on the critical path get a higher
+     * priority.
+     *
+     * Executing the graph again does not reallocate its structure.
+     * Not thread-safe: the graph must not be modified while it is executing.
+     */
+    class TaskGraph {
+    public:
+        using NodeID = std::uint32_t;
+
+        struct NodeDescription {
+            /// Name/Description of the node, used for the tasks scheduled for it
+            std::string name;
+
+            /// What to execute
+            TaskProc task;
+
+            /// Where to execute the node
+            Async::TaskLane lane = TaskScheduler::FrameParallelWork;
+
+            /// Priority of the node. Nodes on the critical path are promoted to the next priority
+            TaskPriority priority = TaskPriority::Normal;
+
+            /// Stack needed by the node
+            TaskStackSize stackSize = TaskStackSize::Small;
+        };
+
+        explicit TaskGraph(std::string name);
+        ~TaskGraph();
+
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        /// Adds a node to this graph. It starts as soon as the graph is executed, unless dependencies are added to it
+        NodeID addNode(NodeDescription&& description);
+
+        /// 'after' will only start once 'before' is finished
+        void addDependency(NodeID before, NodeID after);
+
+        /// Checks that the graph has no cycle, and prepares it for execution. Throws if there is a cycle.
+        /// Called automatically by execute if the graph changed since the last call
+        void compile();
+
+        /**
+         * Starts executing the graph, and returns immediately.
+         * @param done incremented now, decremented once all nodes are finished
+         */
+        void execute(Async::Counter& done);
+
+        /// Executes the graph, and helps the FrameParallelWork lane until all nodes are finished
+        void executeAndWait();
+
+        /// Is this graph currently executing?
+        bool isRunning() const;
+
+        std::size_t getNodeCount() const;
+
+    private:
+        struct Node {
+            NodeDescription description;
+            std::vector<NodeID> successors;
+            std::uint32_t predecessorCount = 0;
+
+            std::atomic<std::uint32_t> remainingPredecessors = 0;
+            TaskPriority effectivePriority = TaskPriority::Normal;
+
+            float estimatedDuration = -1.0f; // in seconds, negative if never executed
+            float longestPathFromNode = 0.0f; // duration of this node and of the longest chain of successors
+            float longestPathToNode = 0.0f; // duration of the longest chain of predecessors
+        };
+
+        /// Updates the critical path estimation and the order in which nodes are scheduled
+        void prepareExecution();
+        void scheduleNode(NodeID nodeID);
+        void runNode(TaskHandle& task, NodeID nodeID);
+
+    private:
+        std::string name;
+        std::deque<Node> nodes; // deque: nodes are not movable, and their address must not change
+        std::vector<NodeID> topologicalOrder;
+        std::vector<NodeID> roots;
+        bool dirty = true;
+
+        std::atomic<std::uint32_t> remainingNodes = 0;
+        Async::Counter* pDone = nullptr;
+    };
+}
@@ -10,13 +10,13 @@
 #include "engine/render/VulkanRenderer.h"
 #include <engine/console/RuntimeOption.hpp>
 #include "core/io/Logging.hpp"
+#include <random>
 
 static std::atomic<std::int64_t> TaskScheduledThisFrameCount{0};
 static std::atomic<std::int64_t> TaskDataCreatedThisFrameCount{0};
 static std::atomic<std::int64_t> TaskDataCreatedCount{0};
 static std::atomic<std::int64_t> AliveTaskDataCount{0};
 static std::atomic<std::int64_t> ActiveTaskCount{0};
-static std::atomic<std::int64_t> FiberCreatedCount{0};
 static Carrot::RuntimeOption ShowDebug("Debug/Task Scheduler", false);
 
 namespace Carrot {
@@ -27,24 +27,96 @@ namespace Carrot {
 
     struct FiberLocalStorage {
         TaskData* taskData = nullptr;
-        std::string* fiberTracyID = nullptr; //< unique ID for Tracy. Allocated once and never deleted, because it may need to survive past 'main' !
+        const std::string* fiberTracyID = nullptr; //< unique ID for Tracy, see acquireFiberName
         bool isFullyInit = false;
         bool tracyEnteredFiber = false;
     };
 
     static_assert(sizeof(FiberLocalStorage) <= sizeof(Cider::FiberHandle::localStorage));
 
+    /// Index of the range of ParallelForJob used by the current thread, 0 for threads which are not FrameParallelWork workers
+    static thread_local std::size_t ParallelForParticipantIndex = 0;
+
+    /// Lane of the current thread, if it is a worker. Undefined otherwise
+    static thread_local Async::TaskLane CurrentWorkerLane = Async::TaskLane::Undefined;
+    static thread_local std::size_t CurrentWorkerIndex = TaskData::NoWorker;
+
+    static bool isWorkerOf(const Async::TaskLane& lane) {
+        return CurrentWorkerIndex != TaskData::NoWorker && CurrentWorkerLane == lane;
+    }
+
+    static std::uint64_t packRange(std::size_t begin, std::size_t end) {
+        return (static_cast<std::uint64_t>(begin) << 32) | static_cast<std::uint64_t>(end);
+    }
+
+    static std::uint32_t rangeBegin(std::uint64_t packed) {
+        return static_cast<std::uint32_t>(packed >> 32);
+    }
+
+    static std::uint32_t rangeEnd(std::uint64_t packed) {
+        return static_cast<std::uint32_t>(packed);
+    }
+
     static TaskData& getTaskData(Cider::FiberHandle& fiberHandle) {
         auto* fls = (FiberLocalStorage*) &fiberHandle.localStorage[0];
         return *fls->taskData;
     }
 
-    TaskData::TaskData() {
+    /// Reserved address space of stacks, per TaskStackSize
+    constexpr std::array<std::size_t, static_cast<std::size_t>(TaskStackSize::Count)> StackSizes {
+        1 * 1024 * 1024,
+        64 * 1024 * 1024,
+    };
+
+    /// Max number of idle TaskData kept for reuse, per TaskStackSize, until the engine applies the capacities from its Configuration
+    constexpr std::array<std::size_t, static_cast<std::size_t>(TaskStackSize::Count)> DefaultPoolCapacities {
+        1024,
+        64,
+    };
+
+    static const char* getPoolName(TaskStackSize stackSize) {
+        return stackSize == TaskStackSize::Small ? "Small" : "Large";
+    }
+
+    /// Logging every occurrence would flood the log when a pool is too small: only log the 1st, 2nd, 4th, 8th, etc.
+    static bool shouldLogPoolEvent(std::int64_t occurrence) {
+        return (occurrence & (occurrence - 1)) == 0;
+    }
+
+    /// Fiber names given to Tracy must stay valid until the end of the program (even past 'main'), so they are never
+    /// deleted. Instead, names of destroyed fibers are reused by new ones: there are never more names than fibers alive at once
+    static std::mutex FiberNamesAccess;
+    static std::vector<const std::string*> FreeFiberNames;
+    static std::int64_t FiberNameCount = 0;
+
+    static const std::string* acquireFiberName() {
+        std::lock_guard l { FiberNamesAccess };
+        if(!FreeFiberNames.empty()) {
+            const std::string* pName = FreeFiberNames.back();
+            FreeFiberNames.pop_back();
+            return pName;
+        }
+        return new std::string { Carrot::sprintf("Fiber %lld", FiberNameCount++) };
+    }
+
+    static void releaseFiberName(const std::string* pName) {
+        std::lock_guard l { FiberNamesAccess };
+        FreeFiberNames.push_back(pName);
+    }
+
+    TaskData::TaskData(TaskStackSize stackSize): stack(StackSizes[static_cast<std::size_t>(stackSize)]) {
+        this->stackSize = stackSize;
         TaskDataCreatedCount++;
         TaskDataCreatedThisFrameCount++;
+        AliveTaskDataCount++;
     }
 
     TaskData::~TaskData() {
+        // destroy the fiber before its stack
+        fiber = nullptr;
+        if(pTracyID) {
+            releaseFiberName(pTracyID);
+        }
         AliveTaskDataCount--;
     }
 
@@ -52,17 +124,61 @@ namespace Carrot {
         taskData.wantedLane = resumeOn;
         fiberHandle.yieldOnTop([this]() {
             auto task = this->taskData.shared_from_this();
-            GetTaskScheduler().taskQueues[taskData.wantedLane].enqueue(std::move(task));
+            GetTaskScheduler().enqueue(std::move(task), taskData.wantedLane);
         });
     }
 
     void TaskHandle::yield() {
         fiberHandle.yieldOnTop([this]() {
             auto task = this->taskData.shared_from_this();
-            GetTaskScheduler().taskQueues[taskData.currentLane].enqueue(std::move(task));
+            GetTaskScheduler().enqueue(std::move(task), taskData.currentLane, true);
         });
     }
 
+    void TaskScheduler::TaskDeque::pushBack(std::shared_ptr<TaskData>&& task) {
+        std::lock_guard l { access };
+        tasks.push_back(std::move(task));
+        count++;
+    }
+
+    void TaskScheduler::TaskDeque::pushFront(std::shared_ptr<TaskData>&& task) {
+        std::lock_guard l { access };
+        tasks.push_front(std::move(task));
+        count++;
+    }
+
+    bool TaskScheduler::TaskDeque::popBack(std::shared_ptr<TaskData>& out) {
+        if(count.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        std::lock_guard l { access };
+        if(tasks.empty()) {
+            return false;
+        }
+        out = std::move(tasks.back());
+        tasks.pop_back();
+        count--;
+        return true;
+    }
+
+    bool TaskScheduler::TaskDeque::popFront(std::shared_ptr<TaskData>& out) {
+        if(count.load(std::memory_order_relaxed) == 0) {
+            return false;
+        }
+        std::lock_guard l { access };
+        if(tasks.empty()) {
+            return false;
+        }
+        out = std::move(tasks.front());
+        tasks.pop_front();
+        count--;
+        return true;
+    }
+
+    std::size_t TaskScheduler::TaskDeque::size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
     void TaskHandle::wait(Async::Counter& counter) {
         counter.wait(*this);
     }
@@ -114,61 +230,101 @@ namespace Carrot {
         };
 
         const std::size_t inFrameCount = frameParallelWorkParallelismAmount();
-        std::size_t availableThreads = inFrameCount + assetLoadingParallelismAmount();
+        const std::size_t assetLoadingCount = assetLoadingParallelismAmount();
+        for(const Async::TaskLane& lane : { FrameParallelWork, AssetLoading, MainLoop, Rendering }) {
+            lanes[lane] = std::make_unique<Lane>();
+        }
+        for(std::size_t i = 0; i < inFrameCount; i++) {
+            lanes[FrameParallelWork]->workerDeques.emplace_back(std::make_unique<PerPriorityDeques>());
+        }
+        for(std::size_t i = 0; i < assetLoadingCount; i++) {
+            lanes[AssetLoading]->workerDeques.emplace_back(std::make_unique<PerPriorityDeques>());
+        }
+
+        for(std::size_t i = 0; i < taskDataPools.size(); i++) {
+            taskDataPools[i].capacity = DefaultPoolCapacities[i];
+        }
+        // enough for the usual burst of small tasks at the start of a frame
+        warmUp(TaskStackSize::Small, inFrameCount * 4);
+
+        std::size_t availableThreads = inFrameCount + assetLoadingCount;
         parallelThreads.resize(availableThreads);
         for (std::size_t i = 0; i < availableThreads; i++) {
             bool isInFrame = i < inFrameCount;
-            parallelThreads[i] = std::thread([isInFrame, this]() {
+            parallelThreads[i] = std::thread([isInFrame, i, inFrameCount, this]() {
                 GetRenderer().makeCurrentThreadRenderCapable();
-                threadProc(isInFrame ? FrameParallelWork : AssetLoading);
+                if(isInFrame) {
+                    threadProc(FrameParallelWork, i, i+1);
+                } else {
+                    threadProc(AssetLoading, i - inFrameCount, 0);
+                }
             });
             Carrot::Threads::setName(parallelThreads[i], Carrot::sprintf("%sParallelTask #%d", isInFrame ? "Frame" : "AssetLoading", isInFrame ? i+1 : i - inFrameCount + 1));
         }
     }
 
     TaskScheduler::~TaskScheduler() {
+        for(std::size_t i = 0; i < taskDataPools.size(); i++) {
+            const TaskDataPool& pool = taskDataPools[i];
+            Carrot::Log::info("%s fiber pool: capacity %llu, %lld hits, %lld misses, %lld reclaimed", getPoolName(static_cast<TaskStackSize>(i)),
+                              pool.capacity.load(), pool.hits.load(), pool.misses.load(), pool.reclaimed.load());
+        }
+
         running = false;
-        for(auto& [_, queue] : taskQueues) {
-            //queue.();
+        for(auto& [_, pLane] : lanes) {
+            pLane->wakeUp.signal(pLane->workerDeques.size());
         }
         for (auto& t : parallelThreads) {
             t.join();
         }
     }
 
-    std::shared_ptr<TaskData> TaskScheduler::getOrReuseTaskData() {
+    std::shared_ptr<TaskData> TaskScheduler::getOrReuseTaskData(TaskStackSize stackSize) {
         ZoneScoped;
+        TaskDataPool& pool = taskDataPools[static_cast<std::size_t>(stackSize)];
         std::shared_ptr<TaskData> taskData;
-        if(reusableTaskData.try_dequeue(taskData)) {
+        if(pool.idle.try_dequeue(taskData)) {
+            pool.hits++;
             return taskData;
         }
 
+        const std::int64_t misses = ++pool.misses;
+        if(shouldLogPoolEvent(misses)) {
+            Carrot::Log::warn("%s fiber pool exhausted, creating a new fiber (%lld misses so far). Consider warming it up", getPoolName(stackSize), misses);
+        }
+        return createTaskData(stackSize);
+    }
+
+    std::shared_ptr<TaskData> TaskScheduler::createTaskData(TaskStackSize stackSize) {
+        std::shared_ptr<TaskData> taskData;
         {
             ZoneScopedN("allocate TaskData");
-            taskData = std::make_shared<TaskData>();
+            taskData = std::make_shared<TaskData>(stackSize);
         }
-        std::string* pTracyID = new std::string{Carrot::sprintf("Fiber %ll", FiberCreatedCount++)};
-        auto fiberProc = [pTracyID, pTaskKeepAlive = taskData, pTaskScheduler = this](Cider::FiberHandle& fiber) {
+        taskData->pTracyID = acquireFiberName();
+
+        // the fiber only references its TaskData by raw pointer: the TaskData is kept alive by the pool or by the
+        // thread executing it, and can be destroyed while its fiber is idle
+        auto fiberProc = [pTaskData = taskData.get(), pTaskScheduler = this](Cider::FiberHandle& fiber) {
             {
                 struct Data {
-                    std::shared_ptr<TaskData> pTask;
+                    TaskData* pTask = nullptr;
                     TaskScheduler* pTaskScheduler = nullptr;
                 };
                 Data data {
-                        .pTask = pTaskKeepAlive,
+                        .pTask = pTaskData,
                         .pTaskScheduler = pTaskScheduler
                 };
 
                 auto* fls = (FiberLocalStorage*) &fiber.localStorage[0];
-                fls->fiberTracyID = pTracyID;
+                fls->fiberTracyID = pTaskData->pTracyID;
                 fls->isFullyInit = true;
 
                 while(true) {
                     // yield this fiber, and sets up task data for reuse
                     fiber.yieldOnTop([](void* pUserData) {
                         Data* pData = (Data*)pUserData;
-                        auto pTask = pData->pTask;
-                        pData->pTaskScheduler->reusableTaskData.enqueue(std::move(pTask));
+                        pData->pTaskScheduler->recycleTaskData(pData->pTask->shared_from_this());
                     }, &data);
                 }
             }
@@ -178,34 +334,137 @@ namespace Carrot {
         return taskData;
     }
 
-    void TaskScheduler::runSingleTask(Async::TaskLane localLane, bool allowBlocking) {
-        std::shared_ptr<TaskData> toRun = nullptr;
-        auto& taskQueue = taskQueues[localLane];
-        bool foundSomethingToExecute = false;
-        if(allowBlocking) {
-            foundSomethingToExecute = taskQueue.wait_dequeue_timed(toRun, 1'000'000); // with timeout to handle shutdown of game
+    void TaskScheduler::recycleTaskData(std::shared_ptr<TaskData>&& taskData) {
+        TaskDataPool& pool = taskDataPools[static_cast<std::size_t>(taskData->stackSize)];
+
+        // release resources captured by the task now, instead of when the TaskData is reused
+        taskData->task = nullptr;
+        taskData->name.clear();
+        taskData->dependency = nullptr;
+        taskData->joiner = nullptr;
+
+        // approximate size is good enough for a soft limit
+        if(pool.idle.size_approx() >= pool.capacity.load()) {
+            // reclaim: the TaskData (and its stack) is destroyed once the executing thread releases it
+            const std::int64_t reclaimed = ++pool.reclaimed;
+            if(shouldLogPoolEvent(reclaimed)) {
+                Carrot::Log::warn("%s fiber pool is full (capacity %llu), destroying a fiber (%lld reclaimed so far). Consider raising its capacity in Configuration",
+                                  getPoolName(taskData->stackSize), pool.capacity.load(), reclaimed);
+            }
+            return;
+        }
+        pool.idle.enqueue(std::move(taskData));
+    }
+
+    void TaskScheduler::warmUp(TaskStackSize stackSize, std::size_t count) {
+        ZoneScoped;
+        TaskDataPool& pool = taskDataPools[static_cast<std::size_t>(stackSize)];
+        const std::size_t target = std::min(count, pool.capacity.load());
+        while(pool.idle.size_approx() < target) {
+            pool.idle.enqueue(createTaskData(stackSize));
+        }
+    }
+
+    void TaskScheduler::setPoolCapacity(TaskStackSize stackSize, std::size_t capacity) {
+        TaskDataPool& pool = taskDataPools[static_cast<std::size_t>(stackSize)];
+        pool.capacity = capacity;
+
+        // trim right away, instead of waiting for tasks to finish
+        std::shared_ptr<TaskData> taskData;
+        while(pool.idle.size_approx() > capacity && pool.idle.try_dequeue(taskData)) {
+            pool.reclaimed++;
+            taskData = nullptr;
+        }
+    }
+
+    void TaskScheduler::enqueue(std::shared_ptr<TaskData>&& task, const Async::TaskLane& laneID, bool yielded) {
+        Lane& lane = *lanes.at(laneID);
+        TaskDeque* pDeque = nullptr;
+        bool isWorkerDeque = true;
+        const std::size_t priorityIndex = static_cast<std::size_t>(task->priority);
+        if(task->currentLane == laneID && task->lastWorkerIndex < lane.workerDeques.size()) {
+            // resumed task: go back to the worker which executed it last
+            pDeque = &(*lane.workerDeques[task->lastWorkerIndex])[priorityIndex];
+        } else if(isWorkerOf(laneID)) {
+            pDeque = &(*lane.workerDeques[CurrentWorkerIndex])[priorityIndex];
         } else {
-            foundSomethingToExecute = taskQueue.try_dequeue(toRun);
+            pDeque = &lane.injected[priorityIndex];
+            isWorkerDeque = false;
+        }
+
+        // worker deques are popped from the back by their owner: yielded tasks go to the front to let others progress.
+        // Injected deques are popped from the front, so they stay FIFO
+        if(isWorkerDeque && yielded) {
+            pDeque->pushFront(std::move(task));
+        } else {
+            pDeque->pushBack(std::move(task));
         }
-        if(foundSomethingToExecute) {
-            ZoneScopedN("Run task");
-            ZoneText(toRun->name.c_str(), toRun->name.size());
-            try {
-                toRun->currentLane = localLane;
-                toRun->fiber->switchTo();
 
-                // handle task lane changes
-                if(toRun->wantedLane != localLane) {
-                    taskQueues[toRun->wantedLane].enqueue(std::move(toRun));
+        if(!lane.workerDeques.empty()) {
+            lane.wakeUp.signal();
+        }
+    }
+
+    bool TaskScheduler::findTask(const Async::TaskLane& laneID, std::shared_ptr<TaskData>& out) {
+        static thread_local std::minstd_rand stealRNG { static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) };
+
+        Lane& lane = *lanes.at(laneID);
+        const std::size_t workerCount = lane.workerDeques.size();
+        const bool isWorker = isWorkerOf(laneID);
+        for(std::size_t priorityIndex = 0; priorityIndex < static_cast<std::size_t>(TaskPriority::Count); priorityIndex++) {
+            if(isWorker && (*lane.workerDeques[CurrentWorkerIndex])[priorityIndex].popBack(out)) {
+                return true;
+            }
+            if(lane.injected[priorityIndex].popFront(out)) {
+                return true;
+            }
+            if(workerCount == 0) {
+                continue;
+            }
+            const std::size_t firstVictim = stealRNG() % workerCount;
+            for(std::size_t i = 0; i < workerCount; i++) {
+                const std::size_t victim = (firstVictim + i) % workerCount;
+                if(isWorker && victim == CurrentWorkerIndex) {
+                    continue;
                 }
-            } catch (const std::exception& e) {
-                // don't crash thread if a task fails
-                Carrot::Log::error("Error while executing scheduled task '%s': %s", toRun->name.c_str(), e.what());
+                if((*lane.workerDeques[victim])[priorityIndex].popFront(out)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void TaskScheduler::runSingleTask(Async::TaskLane localLane, bool allowBlocking) {
+        if(localLane == FrameParallelWork) {
+            helpParallelForJobs();
+        }
+
+        std::shared_ptr<TaskData> toRun = nullptr;
+        if(!findTask(localLane, toRun)) {
+            if(allowBlocking) {
+                lanes.at(localLane)->wakeUp.wait(1'000'000); // with timeout to handle shutdown of game
             }
+            return;
+        }
+
+        ZoneScopedN("Run task");
+        ZoneText(toRun->name.c_str(), toRun->name.size());
+        try {
+            toRun->currentLane = localLane;
+            toRun->lastWorkerIndex = isWorkerOf(localLane) ? CurrentWorkerIndex : TaskData::NoWorker;
+            // lane changes are handled by TaskHandle::changeLane
+            toRun->fiber->switchTo();
+        } catch (const std::exception& e) {
+            // don't crash thread if a task fails
+            Carrot::Log::error("Error while executing scheduled task '%s': %s", toRun->name.c_str(), e.what());
         }
     }
 
-    void TaskScheduler::threadProc(const Async::TaskLane& lane) {
+    void TaskScheduler::threadProc(const Async::TaskLane& lane, std::size_t workerIndex, std::size_t parallelForParticipantIndex) {
+        CurrentWorkerLane = lane;
+        CurrentWorkerIndex = workerIndex;
+        ParallelForParticipantIndex = parallelForParticipantIndex;
         while(running) {
             runSingleTask(lane, true);
         }
@@ -227,6 +486,28 @@ namespace Carrot {
                 ImGui::Text("Alive TaskData: %llu", AliveTaskDataCount.load());
                 ImGui::Text("Total TaskData created: %llu", TaskDataCreatedCount.load());
                 ImGui::Text("TaskData created this frame: %llu", taskDataCreatedThisFrame);
+
+                auto showPool = [&](const char* poolName, TaskStackSize stackSize) {
+                    const TaskDataPool& pool = taskDataPools[static_cast<std::size_t>(stackSize)];
+                    ImGui::Text("%s fiber pool: %llu idle / %llu capacity, %llu hits, %llu misses, %llu reclaimed", poolName,
+                                pool.idle.size_approx(), pool.capacity.load(), pool.hits.load(), pool.misses.load(), pool.reclaimed.load());
+                };
+                showPool("Small", TaskStackSize::Small);
+                showPool("Large", TaskStackSize::Large);
+
+                auto showPendingTasks = [&](const char* laneName, const Async::TaskLane& laneID) {
+                    std::array<std::size_t, static_cast<std::size_t>(TaskPriority::Count)> pending{};
+                    const Lane& lane = *lanes.at(laneID);
+                    for(std::size_t priorityIndex = 0; priorityIndex < pending.size(); priorityIndex++) {
+                        pending[priorityIndex] += lane.injected[priorityIndex].size();
+                        for(const auto& pWorkerDeques : lane.workerDeques) {
+                            pending[priorityIndex] += (*pWorkerDeques)[priorityIndex].size();
+                        }
+                    }
+                    ImGui::Text("Pending %s tasks (critical/normal/background): %llu / %llu / %llu", laneName, pending[0], pending[1], pending[2]);
+                };
+                showPendingTasks("FrameParallelWork", FrameParallelWork);
+                showPendingTasks("AssetLoading", AssetLoading);
             }
             ImGui::End();
         }
@@ -237,39 +518,177 @@ namespace Carrot {
     }
 
 
-    void TaskScheduler::parallelFor(std::size_t count, const std::function<void(std::size_t)>& forEach, std::size_t granularity) {
-        if(count == 0) {
-            return;
+    ParallelForJob::ParallelForJob(std::size_t offset, std::size_t count, std::size_t participantCount, std::size_t minGranularity, ChunkProc proc, void* pUserData)
+    : participantCount(std::min(participantCount, MaxParticipants))
+    , minGranularity(minGranularity)
+    , offset(offset)
+    , remaining(count)
+    , proc(proc)
+    , pUserData(pUserData)
+    {
+        verify(count <= std::numeric_limits<std::uint32_t>::max(), "ParallelForJob ranges are 32-bit");
+        verify(this->participantCount > 0, "Need at least one participant");
+        const std::size_t countPerParticipant = count / this->participantCount;
+        std::size_t begin = 0;
+        for(std::size_t i = 0; i < MaxParticipants; i++) {
+            std::size_t end = begin;
+            if(i < this->participantCount) {
+                end = (i == this->participantCount - 1) ? count : begin + countPerParticipant;
+            }
+            ranges[i].packed.store(packRange(begin, end), std::memory_order_relaxed);
+            begin = end;
         }
+    }
+
+    void ParallelForJob::participate(std::size_t participantIndex) {
+        // only the owner of a range takes items from its front, or refills it
+        const bool ownsRange = participantIndex < participantCount;
+        std::size_t grain = minGranularity;
+        while(true) {
+            std::uint32_t begin = 0;
+            std::uint32_t end = 0;
+            if(!ownsRange || !takeFront(participantIndex, grain, begin, end)) {
+                if(!steal(ownsRange ? std::numeric_limits<std::uint32_t>::max() : grain, begin, end)) {
+                    return;
+                }
 
-        verify(granularity > 0, "Cannot have a granularity of 0");
+                // keep the stolen range as our own, so that other participants can steal from it too
+                if(ownsRange && end - begin > grain) {
+                    ranges[participantIndex].packed.store(packRange(begin + grain, end));
+                    end = begin + grain;
+                }
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            runChunk(begin, end);
 
-        auto run = [&](std::size_t startIndex) {
-            for(std::size_t i = startIndex; i < startIndex + granularity && i < count; i++) {
-                forEach(i);
+            // grow chunks while they are too quick to execute, to amortize the cost of taking them
+            constexpr std::chrono::microseconds TargetChunkDuration { 50 };
+            if(end - begin >= grain && std::chrono::steady_clock::now() - start < TargetChunkDuration) {
+                grain *= 2;
             }
-        };
+        }
+    }
+
+    bool ParallelForJob::isFinished() const {
+        return remaining.load() == 0;
+    }
+
+    void ParallelForJob::rethrowIfFailed() {
+        if(failed.load()) {
+            std::rethrow_exception(exception);
+        }
+    }
 
-        std::size_t parallelJobs = count / granularity; // truncate on purpose, the calling thread will participate
-        if(parallelJobs > 0) {
-            Async::Counter sync;
-            for(std::size_t jobIndex = 0; jobIndex < parallelJobs; jobIndex++) {
-                schedule(TaskDescription {
-                        .name = "Parallel ForEach",
-                        .task = [&, jobIndex](Carrot::TaskHandle&) {
-                            std::size_t startIndex = jobIndex * granularity;
-                            run(startIndex);
-                        },
-                        .joiner = &sync,
-                }, FrameParallelWork);
+    bool ParallelForJob::takeFront(std::size_t rangeIndex, std::size_t maxCount, std::uint32_t& outBegin, std::uint32_t& outEnd) {
+        std::uint64_t packed = ranges[rangeIndex].packed.load();
+        while(true) {
+            const std::uint32_t begin = rangeBegin(packed);
+            const std::uint32_t end = rangeEnd(packed);
+            if(begin >= end) {
+                return false;
+            }
+            const std::uint32_t takenEnd = static_cast<std::uint32_t>(begin + std::min<std::size_t>(maxCount, end - begin));
+            if(ranges[rangeIndex].packed.compare_exchange_weak(packed, packRange(takenEnd, end))) {
+                outBegin = begin;
+                outEnd = takenEnd;
+                return true;
             }
+        }
+    }
 
-            run(parallelJobs * granularity);
-            while(!sync.isIdle()) {
-                stealJobAndRun(FrameParallelWork);
+    bool ParallelForJob::steal(std::size_t maxCount, std::uint32_t& outBegin, std::uint32_t& outEnd) {
+        while(true) {
+            std::size_t victimIndex = participantCount;
+            std::uint64_t victimPacked = 0;
+            std::uint32_t largestSize = 0;
+            for(std::size_t i = 0; i < participantCount; i++) {
+                const std::uint64_t packed = ranges[i].packed.load();
+                const std::uint32_t size = rangeEnd(packed) - rangeBegin(packed);
+                if(rangeBegin(packed) < rangeEnd(packed) && size > largestSize) {
+                    largestSize = size;
+                    victimIndex = i;
+                    victimPacked = packed;
+                }
             }
-        } else {
-            run(0);
+            if(victimIndex == participantCount) {
+                return false; // nothing left to take
+            }
+
+            const std::uint32_t begin = rangeBegin(victimPacked);
+            const std::uint32_t end = rangeEnd(victimPacked);
+            std::uint32_t middle = begin + (end - begin) / 2;
+            if(end - middle > maxCount) {
+                middle = static_cast<std::uint32_t>(end - maxCount);
+            }
+            if(ranges[victimIndex].packed.compare_exchange_strong(victimPacked, packRange(begin, middle))) {
+                outBegin = middle;
+                outEnd = end;
+                return true;
+            }
+            // victim changed in the meantime, try again
+        }
+    }
+
+    void ParallelForJob::runChunk(std::uint32_t begin, std::uint32_t end) {
+        if(!failed.load(std::memory_order_relaxed)) {
+            try {
+                proc(pUserData, offset + begin, offset + end);
+            } catch(...) {
+                if(!failed.exchange(true)) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+        remaining.fetch_sub(end - begin);
+    }
+
+    void TaskScheduler::runParallelForJob(ParallelForJob& job, std::size_t chunkCount) {
+        ZoneScoped;
+        std::size_t slot = MaxParallelForJobs;
+        for(std::size_t i = 0; i < MaxParallelForJobs; i++) {
+            ParallelForJob* expected = nullptr;
+            if(parallelForJobs[i].compare_exchange_strong(expected, &job)) {
+                slot = i;
+                break;
+            }
+        }
+
+        if(slot != MaxParallelForJobs) {
+            // wake up sleeping workers, they help with parallelFor jobs before looking for tasks
+            const std::size_t toWake = std::min(chunkCount - 1, frameParallelWorkParallelismAmount());
+            lanes.at(FrameParallelWork)->wakeUp.signal(toWake);
+        }
+        // else: too many jobs in flight, run everything on this thread
+
+        job.participate(0);
+        while(!job.isFinished()) {
+            // other participants are finishing their last chunk
+            std::this_thread::yield();
+        }
+
+        if(slot != MaxParallelForJobs) {
+            parallelForJobs[slot].store(nullptr);
+            while(parallelForJobUsers[slot].load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        job.rethrowIfFailed();
+    }
+
+    void TaskScheduler::helpParallelForJobs() {
+        for(std::size_t slot = 0; slot < MaxParallelForJobs; slot++) {
+            if(parallelForJobs[slot].load(std::memory_order_relaxed) == nullptr) {
+                continue;
+            }
+
+            parallelForJobUsers[slot]++;
+            if(ParallelForJob* pJob = parallelForJobs[slot].load()) {
+                // range 0 belongs to the thread which called parallelFor
+                pJob->participate(ParallelForParticipantIndex != 0 ? ParallelForParticipantIndex : ParallelForJob::MaxParticipants);
+            }
+            parallelForJobUsers[slot]--;
         }
     }
 
@@ -295,12 +714,16 @@ namespace Carrot {
             description.joiner->increment();
         }
 
-        auto pNewTask = getOrReuseTaskData();
+        // asset loading often goes through third-party libraries with unknown stack usage
+        const TaskStackSize stackSize = lane == AssetLoading ? TaskStackSize::Large : description.stackSize;
+        auto pNewTask = getOrReuseTaskData(stackSize);
         pNewTask->wantedLane = lane;
         pNewTask->currentLane = lane;
         pNewTask->name = description.name;
         pNewTask->dependency = description.dependency;
         pNewTask->joiner = description.joiner;
+        pNewTask->priority = description.priority;
+        pNewTask->lastWorkerIndex = TaskData::NoWorker;
         pNewTask->task = description.task;
 
         {
@@ -344,14 +767,14 @@ namespace Carrot {
             // if task is not waiting on something, start it
             if(!pNewTask->dependency) {
                 ZoneScopedN("Push task description to queue");
-                taskQueues[lane].enqueue(std::move(pNewTask));
+                enqueue(std::move(pNewTask), lane);
             }
         }
     }
 
     void TaskScheduler::FiberScheduler::schedule(Cider::FiberHandle& toSchedule) {
         auto& taskData = getTaskData(toSchedule);
-        taskScheduler.taskQueues[taskData.wantedLane].enqueue(taskData.shared_from_this());
+        taskScheduler.enqueue(taskData.shared_from_this(), taskData.wantedLane);
     }
 
     void TaskScheduler::FiberScheduler::schedule(Cider::FiberHandle& toSchedule, Cider::Proc proc, void *userData) {
@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <array>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <core/ThreadSafeQueue.hpp>
@@ -16,6 +21,7 @@
 #include <cider/scheduling/Scheduler.h>
 #include <concurrentqueue.h>
 #include <blockingconcurrentqueue.h>
+#include <lightweightsemaphore.h>
 #include <core/containers/Vector.hpp>
 
 namespace Carrot {
@@ -74,6 +80,31 @@ namespace Carrot {
         friend class TaskScheduler;
     };
 
+    /// Order in which the tasks of a lane are started: a task is never started while a task of higher priority is waiting
+    enum class TaskPriority: std::uint8_t {
+        /// Work that the current frame waits for
+        FrameCritical,
+
+        /// Default priority
+        Normal,
+
+        /// Work that can take several frames, like asset streaming
+        Background,
+
+        Count
+    };
+
+    /// Size class of the stack of the fiber executing a task. Stacks grow on demand, only their address space is reserved upfront
+    enum class TaskStackSize: std::uint8_t {
+        /// Default, enough for most tasks
+        Small,
+
+        /// For deep recursion or big stack allocations (third-party loaders, etc.). Tasks of AssetLoading always use large stacks
+        Large,
+
+        Count
+    };
+
     struct TaskDescription {
         /// Name/Description of the task.
         std::string name;
@@ -87,30 +118,106 @@ namespace Carrot {
 
         /// Incremented when the task is scheduled, decremented when the task is finished
         Async::Counter* joiner = nullptr;
+
+        /// Tasks with a higher priority are started first
+        TaskPriority priority = TaskPriority::Normal;
+
+        /// Stack needed by this task
+        TaskStackSize stackSize = TaskStackSize::Small;
     };
 
     struct TaskData : public TaskDescription, public std::enable_shared_from_this<TaskData> {
-        //char stack[4096*16] { 0 };
-        Cider::GrowingStack stack { 64 * 1024 * 1024 };
+        Cider::GrowingStack stack;
         Async::TaskLane currentLane = Async::TaskLane::Undefined;
         Async::TaskLane wantedLane = Async::TaskLane::Undefined;
         std::unique_ptr<Cider::Fiber> fiber = nullptr;
 
-        TaskData();
+        /// Worker (of 'currentLane') which last executed this task, resumed tasks go back to it if possible
+        constexpr static std::size_t NoWorker = std::numeric_limits<std::size_t>::max();
+        std::size_t lastWorkerIndex = NoWorker;
+
+        /// Name of the fiber for Tracy, recycled once this TaskData is destroyed
+        const std::string* pTracyID = nullptr;
+
+        explicit TaskData(TaskStackSize stackSize);
         ~TaskData();
     };
 
+    /**
+     * Data-parallel loop, executed directly on the threads of FrameParallelWork: no fiber, no TaskData, no allocation.
+     * Lives on the stack of the thread calling TaskScheduler::parallelFor.
+     *
+     * The range is split evenly between participants at start. Each participant takes chunks from the front of its own
+     * range, and steals the second half of the largest remaining range once its own is empty.
+     * The size of chunks is tuned per participant, to keep per-chunk overhead low even when items are cheap.
+     */
+    class ParallelForJob {
+    public:
+        using ChunkProc = void(*)(void* pUserData, std::size_t begin, std::size_t end);
+
+        constexpr static std::size_t MaxParticipants = 64;
+
+        /**
+         * @param offset first index of the loop
+         * @param count how many items to process, must fit on 32 bits
+         * @param participantCount how many threads are expected to participate (caller included)
+         * @param minGranularity minimum chunk size
+         * @param proc called for each chunk, with [begin; end[ offset by 'offset'
+         */
+        ParallelForJob(std::size_t offset, std::size_t count, std::size_t participantCount, std::size_t minGranularity, ChunkProc proc, void* pUserData);
+
+        /// Executes chunks of this job until there is nothing left to take. 'participantIndex' is the range to start from
+        void participate(std::size_t participantIndex);
+
+        /// Have all items been processed?
+        bool isFinished() const;
+
+        /// Rethrows the first exception thrown by a chunk, if any. Call only once isFinished() returns true
+        void rethrowIfFailed();
+
+    private:
+        /// Takes at most 'maxCount' items from the front of the given range
+        bool takeFront(std::size_t rangeIndex, std::size_t maxCount, std::uint32_t& outBegin, std::uint32_t& outEnd);
+
+        /// Takes the second half of the largest range, at most 'maxCount' items
+        bool steal(std::size_t maxCount, std::uint32_t& outBegin, std::uint32_t& outEnd);
+
+        void runChunk(std::uint32_t begin, std::uint32_t end);
+
+    private:
+        /// [begin; end[ packed inside a single value, to update both at once
+        struct alignas(64) Range {
+            std::atomic<std::uint64_t> packed;
+        };
+
+        std::array<Range, MaxParticipants> ranges;
+        std::size_t participantCount = 0;
+        std::size_t minGranularity = 1;
+        std::size_t offset = 0;
+        std::atomic<std::size_t> remaining;
+
+        ChunkProc proc = nullptr;
+        void* pUserData = nullptr;
+
+        std::atomic<bool> failed = false;
+        std::exception_ptr exception;
+    };
+
     class TaskScheduler {
     public:
         /**
-         * Executes 'count' tasks in parallel, executing 'forEach' for each task.
+         * Executes 'forEach' for each index in [0; count[, in parallel.
+         * Items are processed directly on the threads of FrameParallelWork (see ParallelForJob), without fibers, and
+         * 'forEach' is called without type erasure.
          * The calling thread will also participate.
-         * Waits until all tasks are done before returning
-         * @param count how many tasks to execute
-         * @param forEach what to execute for each task
-         * @param granularity how many tasks at once per thread
+         * Waits until all items are done before returning. The first exception thrown by 'forEach' is rethrown here.
+         * 'forEach' must not yield the current fiber.
+         * @param count how many items to process
+         * @param forEach what to execute for each item
+         * @param minGranularity minimum number of items processed at once per thread. Chunks grow automatically when items are cheap
          */
-        void parallelFor(std::size_t count, const std::function<void(std::size_t)>& forEach, std::size_t granularity);
+        template<typename Func>
+        void parallelFor(std::size_t count, Func&& forEach, std::size_t minGranularity = 1);
 
         Carrot::Vector<std::thread::id> getParallelThreadIDs() const;
 
@@ -128,6 +235,15 @@ namespace Carrot {
         /// If there are no jobs to steal, does nothing
         void stealJobAndRun(const Async::TaskLane& lane);
 
+    public: // fiber pool
+        /// Creates fibers (and their stacks) in advance, so that scheduling 'count' tasks of the given stack size does
+        /// not allocate. Does not go above the capacity of the pool
+        void warmUp(TaskStackSize stackSize, std::size_t count);
+
+        /// Max number of idle fibers kept for reuse. Fibers finishing their task while the pool is full are destroyed.
+        /// Set by the engine from Configuration
+        void setPoolCapacity(TaskStackSize stackSize, std::size_t capacity);
+
     public:
         /// How many threads can we use for the task scheduler? Only count "short" tasks
         static std::size_t frameParallelWorkParallelismAmount();
@@ -152,9 +268,69 @@ namespace Carrot {
         TaskScheduler();
         ~TaskScheduler();
 
-        std::shared_ptr<TaskData> getOrReuseTaskData();
+        /**
+         * Tasks protected by a mutex. The worker owning the deque pushes and pops at the back (LIFO, the most recent task
+         * is the most likely to have its data in cache), other workers steal from the front.
+         */
+        class TaskDeque {
+        public:
+            void pushBack(std::shared_ptr<TaskData>&& task);
+            void pushFront(std::shared_ptr<TaskData>&& task);
+            bool popBack(std::shared_ptr<TaskData>& out);
+            bool popFront(std::shared_ptr<TaskData>& out);
+
+            /// Approximate, used to skip empty deques without locking
+            std::size_t size() const;
+
+        private:
+            std::mutex access;
+            std::deque<std::shared_ptr<TaskData>> tasks;
+            std::atomic<std::size_t> count = 0;
+        };
+
+        using PerPriorityDeques = std::array<TaskDeque, static_cast<std::size_t>(TaskPriority::Count)>;
+
+        struct Lane {
+            /// Tasks scheduled from threads which are not workers of this lane
+            PerPriorityDeques injected;
+
+            /// One set of deques per worker of this lane. Empty for lanes executed by the main thread
+            std::vector<std::unique_ptr<PerPriorityDeques>> workerDeques;
+
+            /// Signaled when tasks are added, workers sleep on it when there is nothing to do
+            moodycamel::LightweightSemaphore wakeUp;
+        };
+
+        /// Idle TaskData (with their fiber and stack) of a given stack size
+        struct TaskDataPool {
+            moodycamel::ConcurrentQueue<std::shared_ptr<TaskData>> idle;
+            std::atomic<std::size_t> capacity = 0;
+
+            std::atomic<std::int64_t> hits = 0; //< reused a pooled TaskData
+            std::atomic<std::int64_t> misses = 0; //< had to create a new TaskData
+            std::atomic<std::int64_t> reclaimed = 0; //< destroyed because the pool was full
+        };
+
+        std::shared_ptr<TaskData> getOrReuseTaskData(TaskStackSize stackSize);
+        std::shared_ptr<TaskData> createTaskData(TaskStackSize stackSize);
+
+        /// Called once a TaskData has finished its task: puts it back in its pool, or drops it if the pool is full
+        void recycleTaskData(std::shared_ptr<TaskData>&& taskData);
         void runSingleTask(Async::TaskLane lane, bool allowBlocking);
-        void threadProc(const Async::TaskLane& lane);
+        void threadProc(const Async::TaskLane& lane, std::size_t workerIndex, std::size_t parallelForParticipantIndex);
+
+        /// Adds a task to the deques of the given lane. Yielded tasks are put behind the other tasks of the current worker
+        void enqueue(std::shared_ptr<TaskData>&& task, const Async::TaskLane& lane, bool yielded = false);
+
+        /// Finds the next task to execute on the current thread: for each priority, looks in the deque of the current
+        /// worker, then the injected tasks, then steals from a random worker
+        bool findTask(const Async::TaskLane& lane, std::shared_ptr<TaskData>& out);
+
+        /// Makes the job visible to workers, runs it, and waits for its completion
+        void runParallelForJob(ParallelForJob& job, std::size_t chunkCount);
+
+        /// Participates in the parallelFor jobs currently in progress
+        void helpParallelForJobs();
 
     private:
         class FiberScheduler: public Cider::Scheduler {
@@ -172,15 +348,22 @@ namespace Carrot {
         };
         FiberScheduler fiberScheduler { *this };
 
-        using TaskQueue = moodycamel::BlockingConcurrentQueue<std::shared_ptr<TaskData>>;
-        std::unordered_map<Async::TaskLane, TaskQueue> taskQueues;
+        std::unordered_map<Async::TaskLane, std::unique_ptr<Lane>> lanes; // created in the constructor, not modified afterwards
 
-        TaskQueue reusableTaskData;
+        std::array<TaskDataPool, static_cast<std::size_t>(TaskStackSize::Count)> taskDataPools;
         std::atomic<bool> running = true;
         std::vector<std::thread> parallelThreads;
 
+        /// parallelFor jobs in progress. 'parallelForJobUsers' counts the workers currently reading a slot, so that the
+        /// job (which lives on the stack of its caller) is not destroyed while a worker still uses it
+        constexpr static std::size_t MaxParallelForJobs = 32;
+        std::array<std::atomic<ParallelForJob*>, MaxParallelForJobs> parallelForJobs{};
+        std::array<std::atomic<std::uint32_t>, MaxParallelForJobs> parallelForJobUsers{};
+
         friend class Engine;
         friend class FiberScheduler;
         friend class TaskHandle;
     };
 }
+
+#include "TaskScheduler.ipp"
@@ -0,0 +1,43 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#pragma once
+
+#include <limits>
+
+namespace Carrot {
+    template<typename Func>
+    void TaskScheduler::parallelFor(std::size_t count, Func&& forEach, std::size_t minGranularity) {
+        if(count == 0) {
+            return;
+        }
+
+        verify(minGranularity > 0, "Cannot have a granularity of 0");
+
+        const std::size_t participantCount = std::min(frameParallelWorkParallelismAmount() + 1 /* calling thread */, ParallelForJob::MaxParticipants);
+        if(count <= minGranularity || participantCount <= 1) {
+            for(std::size_t i = 0; i < count; i++) {
+                forEach(i);
+            }
+            return;
+        }
+
+        using FuncType = std::remove_reference_t<Func>;
+        ParallelForJob::ChunkProc chunkProc = [](void* pUserData, std::size_t begin, std::size_t end) {
+            FuncType& f = *static_cast<FuncType*>(pUserData);
+            for(std::size_t i = begin; i < end; i++) {
+                f(i);
+            }
+        };
+        void* pUserData = const_cast<void*>(static_cast<const void*>(std::addressof(forEach)));
+
+        // ranges are stored on 32 bits, split huge loops in multiple jobs
+        constexpr std::size_t MaxJobSize = std::numeric_limits<std::uint32_t>::max();
+        for(std::size_t start = 0; start < count; start += MaxJobSize) {
+            const std::size_t jobSize = std::min(MaxJobSize, count - start);
+            ParallelForJob job { start, jobSize, participantCount, minGranularity, chunkProc, pUserData };
+            runParallelForJob(job, (jobSize + minGranularity - 1) / minGranularity);
+        }
+    }
+}
@@ -14,6 +14,7 @@
 #include "engine/render/TextureRepository.h"
 #include "engine/utils/Macros.h"
 #include "engine/render/resources/BufferView.h"
+#include "engine/render/resources/PipelineCache.h"
 #include <iostream>
 #include <map>
 #include <set>
@@ -187,6 +188,7 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
 }
 
 static Carrot::RuntimeOption showGPUMemoryUsage("GPU/Show GPU Memory", false);
+static Carrot::RuntimeOption showPipelineCacheStatistics("GPU/Show Pipeline Cache", false);
 
 Carrot::VulkanDriver::VulkanDriver(Carrot::Window& window, Configuration config, Carrot::Engine* engine, Carrot::VR::Interface* vrInterface):
     vrInterface(vrInterface),
@@ -211,6 +213,8 @@ Carrot::VulkanDriver::VulkanDriver(Carrot::Window& window, Configuration config,
     fillRenderingCapabilities();
     createLogicalDevice();
 
+    pipelineCache = std::make_unique<Render::PipelineCache>(*this, this->config.pipelineCacheFile, pipelineCreationFeedbackSupported);
+
     createTransferCommandPool();
     createGraphicsCommandPool();
     createComputeCommandPool();
@@ -503,6 +507,10 @@ void Carrot::VulkanDriver::fillRenderingCapabilities() {
     if(availableSet.contains(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
         memoryBudgetSupported = true;
     }
+
+    if(availableSet.contains(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME)) {
+        pipelineCreationFeedbackSupported = true;
+    }
 }
 
 void Carrot::VulkanDriver::createLogicalDevice() {
@@ -589,6 +597,10 @@ void Carrot::VulkanDriver::createLogicalDevice() {
 
     std::vector<const char*> deviceExtensions = VULKAN_DEVICE_EXTENSIONS; // copy
 
+    if(pipelineCreationFeedbackSupported) {
+        deviceExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME); // only used for statistics
+    }
+
     if(GetCapabilities().supportsRaytracing) {
         for(const auto& rayTracingExt : RayTracer::getRequiredDeviceExtensions()) {
             deviceExtensions.push_back(rayTracingExt);
@@ -785,6 +797,8 @@ vk::Format Carrot::VulkanDriver::findDepthFormat() {
 }
 
 Carrot::VulkanDriver::~VulkanDriver() {
+    pipelineCache = nullptr; // saves the cache while the device still exists
+
 #ifdef AFTERMATH_ENABLE
     if (engine->getSettings().useAftermath) {
         shutdownAftermath();
@@ -1286,6 +1300,14 @@ void Carrot::VulkanDriver::startFrame(const Carrot::Render::Context& renderConte
             showGPUMemoryUsage.setValue(false);
         }
     }
+
+    if(showPipelineCacheStatistics) {
+        bool isOpen = true;
+        pipelineCache->showDebugWindow(isOpen);
+        if(!isOpen) {
+            showPipelineCacheStatistics.setValue(false);
+        }
+    }
 }
 
 void Carrot::VulkanDriver::submitGraphics(const vk::SubmitInfo2& submit, const vk::Fence& completeFence) {
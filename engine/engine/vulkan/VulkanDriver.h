@@ -27,6 +27,7 @@ namespace Carrot {
     namespace Render {
         class Texture;
         class ResourceRepository;
+        class PipelineCache;
         struct Context;
         enum class Eye;
     };
@@ -179,6 +180,9 @@ namespace Carrot {
 
         Render::ResourceRepository& getResourceRepository() { return *resourceRepository; };
 
+        /// Cache to use when creating pipelines, persisted to disk between runs
+        Render::PipelineCache& getPipelineCache() { return *pipelineCache; };
+
         const Configuration& getConfiguration() { return config; }
 
         bool hasDebugNames() const;
@@ -293,6 +297,7 @@ namespace Carrot {
         vk::UniqueDescriptorSetLayout emptyDescriptorSetLayout{};
 
         std::unique_ptr<Render::ResourceRepository> resourceRepository = nullptr;
+        std::unique_ptr<Render::PipelineCache> pipelineCache = nullptr;
 
         Async::SpinLock deferredDestroysLock;
         std::unordered_map<std::uint32_t, std::vector<DeferredCommandBufferDestruction>> deferredCommandBufferDestructions;
@@ -359,6 +364,7 @@ namespace Carrot {
         vk::PhysicalDeviceMemoryProperties baseProperties{};
 
         bool memoryBudgetSupported = false;
+        bool pipelineCreationFeedbackSupported = false;
         vk::DeviceSize gpuHeapBudgets[VK_MAX_MEMORY_HEAPS] = {0};
         vk::DeviceSize gpuHeapUsages[VK_MAX_MEMORY_HEAPS] = {0};
     };
@@ -18,6 +18,36 @@ struct PackedVertex {
     vec2 uv;
 };
 
+// See Carrot::QuantizedVertex and core/render/VertexQuantization.cpp
+struct QuantizedVertex {
+    uint positionXY;
+    uint positionZ;
+    uint normal;
+    uint tangent;
+    uint uv;
+    uint color;
+};
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+PackedVertex decodeQuantizedVertex(QuantizedVertex v, vec3 boundsMin, vec3 boundsMax) {
+    PackedVertex result;
+    vec3 relativePosition = vec3(unpackUnorm2x16(v.positionXY), unpackUnorm2x16(v.positionZ & 0xFFFFu).x);
+    result.pos = boundsMin + relativePosition * (boundsMax - boundsMin);
+    result.normal = decodeOctahedral(unpackSnorm2x16(v.normal));
+    float bitangentSign = (v.positionZ & 0x80000000u) != 0u ? -1.0 : 1.0;
+    result.tangent = vec4(decodeOctahedral(unpackSnorm2x16(v.tangent)), bitangentSign);
+    result.uv = unpackHalf2x16(v.uv);
+    result.color = unpackUnorm4x8(v.color).rgb;
+    return result;
+}
+
 layout(buffer_reference, std140) buffer VertexBuffer {
     Vertex v[];
 };
@@ -26,6 +56,10 @@ layout(buffer_reference, scalar) buffer PackedVertexBuffer {
     PackedVertex v[];
 };
 
+layout(buffer_reference, scalar) buffer QuantizedVertexBuffer {
+    QuantizedVertex v[];
+};
+
 layout(buffer_reference, scalar) buffer IndexBuffer {
     uint i[];
 };
@@ -1,16 +1,29 @@
+// Keep in sync with Carrot::Render::ClusterVertexFormat
+#define CLUSTER_VERTEX_FORMAT_PACKED 0
+#define CLUSTER_VERTEX_FORMAT_QUANTIZED 1
+
 struct Cluster {
-    PackedVertexBuffer vertices;
+    PackedVertexBuffer vertices; // QuantizedVertexBuffer if vertexFormat is CLUSTER_VERTEX_FORMAT_QUANTIZED
     IndexBuffer16 indices;
     uint8_t triangleCount;
     uint8_t vertexCount;
     uint8_t lod;
+    uint8_t vertexFormat;
     mat4x3 transform;
     vec4 boundingSphere;
     vec4 parentBoundingSphere;
     float error;
     float parentError;
+    vec3 quantizationBoundsMin;
+    vec3 quantizationBoundsMax;
 };
 
+// Vertex 'index' of the given cluster, whatever the format used to store its vertices
+#define getClusterVertex(cluster, index) \
+    ((cluster).vertexFormat == CLUSTER_VERTEX_FORMAT_QUANTIZED \
+        ? decodeQuantizedVertex(QuantizedVertexBuffer(uint64_t((cluster).vertices)).v[(index)], (cluster).quantizationBoundsMin, (cluster).quantizationBoundsMax) \
+        : (cluster).vertices.v[(index)])
+
 struct ClusterInstance {
     uint32_t clusterID;
     uint32_t materialIndex;
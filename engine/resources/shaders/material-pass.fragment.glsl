@@ -164,7 +164,7 @@ void main() {
     uint clusterID = instances[instanceIndex].clusterID;
     uint materialIndex = instances[instanceIndex].materialIndex;
 
-#define getVertex(n) (clusters[clusterID].vertices.v[clusters[clusterID].indices.i[(n)]])
+#define getVertex(n) getClusterVertex(clusters[clusterID], clusters[clusterID].indices.i[(n)])
     PackedVertex vA = getVertex(triangleIndex * 3 + 0);
     PackedVertex vB = getVertex(triangleIndex * 3 + 1);
     PackedVertex vC = getVertex(triangleIndex * 3 + 2);
@@ -1,6 +1,7 @@
 #extension GL_EXT_shader_explicit_arithmetic_types_int8 : require
 #extension GL_EXT_shader_explicit_arithmetic_types_int16 : require
 #extension GL_EXT_shader_explicit_arithmetic_types_int32 : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
 #extension GL_EXT_buffer_reference : require
 #extension GL_EXT_buffer_reference2 : require
 #extension GL_EXT_scalar_block_layout : require
@@ -40,7 +41,7 @@ void main() {
     instanceID = instanceDrawData.uuid0;
     uint clusterID = instances[instanceID].clusterID;
     uint modelDataIndex = instances[instanceID].instanceDataIndex;
-    PackedVertex vertex = clusters[clusterID].vertices.v[clusters[clusterID].indices.i[gl_VertexIndex]];
+    PackedVertex vertex = getClusterVertex(clusters[clusterID], clusters[clusterID].indices.i[gl_VertexIndex]);
 
     mat4 modelview = cbo.view * modelData[modelDataIndex].transform * mat4(clusters[clusterID].transform);
 
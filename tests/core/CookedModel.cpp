@@ -0,0 +1,291 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/scene/CookedModel.h>
+#include <core/scene/GLTFLoader.h>
+#include <core/render/MeshCompression.h>
+#include <core/render/VertexQuantization.h>
+#include <cstring>
+#include <span>
+
+using namespace Carrot::Render;
+
+static LoadedScene makeScene() {
+    LoadedScene scene;
+
+    LoadedMaterial& material = scene.materials.emplace_back();
+    material.name = "Material";
+    material.blendMode = LoadedMaterial::BlendMode::Blend;
+    material.albedo = Carrot::IO::VFS::Path{}.relative(Carrot::IO::Path("textures/albedo.png"));
+    material.baseColorFactor = glm::vec4(0.5f, 0.25f, 1.0f, 1.0f);
+    material.roughnessFactor = 0.3f;
+
+    LoadedPrimitive& primitive = scene.primitives.emplace_back();
+    primitive.name = "Quad";
+    primitive.materialIndex = 0;
+    primitive.hadNormals = true;
+    primitive.minPos = glm::vec3(-1, -1, 0);
+    primitive.maxPos = glm::vec3(1, 1, 0);
+    for(int i = 0; i < 4; i++) {
+        Carrot::Vertex& vertex = primitive.vertices.emplace_back();
+        vertex.pos = glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, 0.0f, 1.0f);
+        vertex.color = glm::vec3(1.0f);
+        vertex.normal = glm::vec3(0, 0, 1);
+        vertex.tangent = glm::vec4(1, 0, 0, 1);
+        vertex.uv = glm::vec2(vertex.pos.x, vertex.pos.y);
+    }
+    primitive.indices = { 0, 1, 2, 2, 1, 3 };
+    primitive.meshletVertexIndices = { 0, 1, 2, 3 };
+    primitive.meshletIndices = { 0, 1, 2, 2, 1, 3 };
+    Meshlet& meshlet = primitive.meshlets.emplace_back();
+    meshlet.vertexCount = 4;
+    meshlet.indexCount = 6;
+    meshlet.boundingSphere.radius = 1.5f;
+    meshlet.clusterError = 0.125f;
+    primitive.quantizationBounds = Carrot::Math::AABB { primitive.minPos, primitive.maxPos };
+    for(const Carrot::Vertex& vertex : primitive.vertices) {
+        primitive.quantizedVertices.push_back(Carrot::VertexQuantization::encode(Carrot::PackedVertex { vertex }, primitive.quantizationBounds));
+    }
+
+    scene.nodeHierarchy = std::make_unique<Skeleton>(glm::mat4 { 2.0f });
+    scene.nodeHierarchy->hierarchy.bone.name = "Model root ";
+    SkeletonTreeNode& bone = scene.nodeHierarchy->hierarchy.newChild();
+    bone.bone.name = "Bone";
+    bone.bone.transform = glm::mat4 { 3.0f };
+    bone.nodeKey.value = 1;
+    bone.meshIndices = std::vector<std::size_t> { 0 };
+    scene.nodeHierarchy->hierarchy.newChild().bone.name = "Other bone";
+
+    PrecomputedBLAS& blas = scene.precomputedBLASes[NodeKey { 1 }][Carrot::Pair<std::uint32_t, std::uint32_t> { 0, 0 }];
+    blas.blasBytes.resize(sizeof(Carrot::VkAccelerationStructureHeader) + 5);
+    for(std::size_t i = 0; i < blas.blasBytes.size(); i++) {
+        blas.blasBytes[i] = static_cast<std::uint8_t>(i);
+    }
+
+    scene.boneMapping[0]["Bone"] = 0;
+    scene.offsetMatrices[0]["Bone"] = glm::mat4 { 4.0f };
+
+    Carrot::Animation& animation = scene.animationData.emplace_back();
+    animation.duration = 2.0f;
+    animation.keyframeCount = 2;
+    animation.keyframes.emplace_back(0.0f).boneTransforms = { glm::mat4 { 1.0f } };
+    animation.keyframes.emplace_back(2.0f).boneTransforms = { glm::mat4 { 5.0f } };
+    scene.animationMapping["Walk"] = 0;
+    return scene;
+}
+
+TEST(CookedModel, RoundTrip) {
+    const LoadedScene scene = makeScene();
+    const std::vector<std::uint8_t> cooked = CookedModel::cook(scene);
+    ASSERT_TRUE(CookedModel::isCookedModel(cooked));
+    EXPECT_EQ(cooked, CookedModel::cook(scene)); // deterministic
+
+    EXPECT_EQ(CookedModel::validate(cooked), std::vector<std::string>{});
+
+    const LoadedScene loaded = CookedModel::load(cooked, {});
+    EXPECT_EQ(CookedModel::compare(scene, loaded), std::vector<std::string>{});
+
+    // paths are made relative to the model
+    const Carrot::IO::VFS::Path modelPath { "game", "models/character.gltf" };
+    const LoadedScene relocated = CookedModel::load(cooked, modelPath);
+    EXPECT_EQ(relocated.materials[0].albedo, modelPath.relative(Carrot::IO::Path("textures/albedo.png")));
+    EXPECT_TRUE(relocated.materials[0].normalMap.isEmpty());
+    EXPECT_EQ(relocated.nodeHierarchy->hierarchy.bone.name, "Model root " + modelPath.toString());
+}
+
+TEST(CookedModel, Validation) {
+    const LoadedScene scene = makeScene();
+    const std::vector<std::uint8_t> cooked = CookedModel::cook(scene);
+
+    std::vector<std::uint8_t> badMagic = cooked;
+    badMagic[0] ^= 0xFF;
+    EXPECT_FALSE(CookedModel::isCookedModel(badMagic));
+    EXPECT_FALSE(CookedModel::validate(badMagic).empty());
+    EXPECT_ANY_THROW(CookedModel::load(badMagic, {}));
+
+    std::vector<std::uint8_t> truncated { cooked.begin(), cooked.end() - 16 };
+    EXPECT_FALSE(CookedModel::validate(truncated).empty());
+
+    // meshlet indices are local to their meshlet
+    LoadedScene badMeshlet = makeScene();
+    badMeshlet.primitives[0].meshletIndices[4] = 4;
+    EXPECT_FALSE(CookedModel::validate(CookedModel::cook(badMeshlet)).empty());
+
+    LoadedScene badQuantizedVertices = makeScene();
+    badQuantizedVertices.primitives[0].quantizedVertices.pop_back();
+    EXPECT_FALSE(CookedModel::validate(CookedModel::cook(badQuantizedVertices)).empty());
+
+    LoadedScene badIndices = makeScene();
+    badIndices.primitives[0].indices[0] = 42;
+    EXPECT_FALSE(CookedModel::validate(CookedModel::cook(badIndices)).empty());
+
+    LoadedScene different = makeScene();
+    different.primitives[0].vertices[2].uv.x = 0.5f;
+    EXPECT_EQ(CookedModel::compare(scene, CookedModel::load(CookedModel::cook(different), {})).size(), 1);
+}
+
+TEST(CookedModel, VertexPaddingIsZeroed) {
+    LoadedScene zeroPadding = makeScene();
+    LoadedScene garbagePadding = makeScene();
+    for(Carrot::Vertex& vertex : garbagePadding.primitives[0].vertices) {
+        const Carrot::Vertex copy = vertex;
+        std::memset(static_cast<void*>(&vertex), 0xCD, sizeof(vertex));
+        vertex.pos = copy.pos;
+        vertex.color = copy.color;
+        vertex.normal = copy.normal;
+        vertex.tangent = copy.tangent;
+        vertex.uv = copy.uv;
+    }
+    EXPECT_EQ(CookedModel::cook(zeroPadding), CookedModel::cook(garbagePadding));
+}
+
+/// Adds an accessor (and its buffer view) reading 'elements' from the first buffer of 'model'
+template<typename T>
+static int addAccessor(tinygltf::Model& model, std::span<const T> elements, int componentType, int type) {
+    std::vector<unsigned char>& data = model.buffers[0].data;
+    const std::size_t offset = (data.size() + 3) & ~std::size_t(3);
+    data.resize(offset + elements.size_bytes());
+    std::memcpy(data.data() + offset, elements.data(), elements.size_bytes());
+
+    tinygltf::BufferView& view = model.bufferViews.emplace_back();
+    view.buffer = 0;
+    view.byteOffset = offset;
+    view.byteLength = elements.size_bytes();
+
+    tinygltf::Accessor& accessor = model.accessors.emplace_back();
+    accessor.bufferView = static_cast<int>(model.bufferViews.size() - 1);
+    accessor.componentType = componentType;
+    accessor.type = type;
+    accessor.count = elements.size();
+    return static_cast<int>(model.accessors.size() - 1);
+}
+
+/// Small glTF, as exported by Fertilizer: a textured quad with a blended material, inside a node hierarchy
+static tinygltf::Model makeGLTF() {
+    tinygltf::Model model;
+    model.buffers.emplace_back();
+
+    const std::vector<glm::vec3> positions = { { -1, -1, 0 }, { 1, -1, 0 }, { -1, 1, 0 }, { 1, 1, 0 } };
+    const std::vector<glm::vec3> normals(4, glm::vec3 { 0, 0, 1 });
+    const std::vector<glm::vec4> tangents(4, glm::vec4 { 1, 0, 0, -1 });
+    const std::vector<glm::vec2> uvs = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+    const std::vector<std::uint16_t> indices = { 0, 1, 2, 2, 1, 3 };
+
+    tinygltf::Primitive primitive;
+    primitive.mode = TINYGLTF_MODE_TRIANGLES;
+    primitive.material = 0;
+    primitive.attributes["POSITION"] = addAccessor<glm::vec3>(model, positions, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+    primitive.attributes["NORMAL"] = addAccessor<glm::vec3>(model, normals, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+    primitive.attributes["TANGENT"] = addAccessor<glm::vec4>(model, tangents, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4);
+    primitive.attributes["TEXCOORD_0"] = addAccessor<glm::vec2>(model, uvs, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2);
+    primitive.indices = addAccessor<std::uint16_t>(model, indices, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_SCALAR);
+
+    tinygltf::Mesh& mesh = model.meshes.emplace_back();
+    mesh.name = "Quad";
+    mesh.primitives.push_back(primitive);
+
+    model.images.emplace_back().uri = "textures/albedo.png";
+    model.textures.emplace_back().source = 0;
+    tinygltf::Material& material = model.materials.emplace_back();
+    material.name = "Material";
+    material.alphaMode = "BLEND";
+    material.pbrMetallicRoughness.baseColorFactor = { 0.5, 0.25, 1.0, 1.0 };
+    material.pbrMetallicRoughness.roughnessFactor = 0.3;
+    material.pbrMetallicRoughness.baseColorTexture.index = 0;
+
+    tinygltf::Node& parent = model.nodes.emplace_back();
+    parent.name = "Parent";
+    parent.translation = { 1.0, 2.0, 3.0 };
+    parent.children = { 1 };
+    tinygltf::Node& child = model.nodes.emplace_back();
+    child.name = "Child";
+    child.mesh = 0;
+    child.scale = { 2.0, 2.0, 2.0 };
+
+    model.scenes.emplace_back().nodes = { 0 };
+    model.defaultScene = 0;
+    return model;
+}
+
+TEST(CookedModel, SameSceneAsGLTFLoader) {
+    const tinygltf::Model model = makeGLTF();
+    GLTFLoader loader{};
+
+    // what Fertilizer does: cook the scene obtained from the exported glTF
+    const LoadedScene fromGLTF = loader.load(model, {});
+    ASSERT_EQ(fromGLTF.primitives.size(), 1);
+    ASSERT_EQ(fromGLTF.primitives[0].vertices.size(), 4);
+    const std::vector<std::uint8_t> cooked = CookedModel::cook(fromGLTF);
+    EXPECT_EQ(CookedModel::validate(cooked), std::vector<std::string>{});
+    EXPECT_EQ(CookedModel::compare(fromGLTF, CookedModel::load(cooked, {})), std::vector<std::string>{});
+
+    // what the engine does: load the cooked model instead of the glTF at the same path
+    const Carrot::IO::VFS::Path modelPath { "game", "models/quad.gltf" };
+    const LoadedScene expected = loader.load(model, modelPath);
+    const LoadedScene actual = CookedModel::load(cooked, modelPath);
+    EXPECT_EQ(CookedModel::compare(expected, actual), std::vector<std::string>{});
+    EXPECT_EQ(actual.materials[0].albedo, modelPath.relative(Carrot::IO::Path("textures/albedo.png")));
+}
+
+TEST(CookedModel, QuantizedVerticesFromGLTF) {
+    tinygltf::Model model = makeGLTF();
+    GLTFLoader loader{};
+    const LoadedScene plain = loader.load(model, {});
+    ASSERT_EQ(plain.primitives.size(), 1);
+    EXPECT_TRUE(plain.primitives[0].quantizedVertices.empty());
+
+    // add the meshlet data written by Fertilizer, with its quantized vertices
+    const LoadedPrimitive& source = plain.primitives[0];
+    std::vector<Carrot::PackedVertex> packedVertices;
+    for(const Carrot::Vertex& vertex : source.vertices) {
+        packedVertices.emplace_back(vertex);
+    }
+    const Carrot::Math::AABB bounds = Carrot::VertexQuantization::computeBounds(packedVertices);
+    std::vector<Carrot::QuantizedVertex> quantizedVertices(packedVertices.size());
+    Carrot::VertexQuantization::encode(packedVertices, bounds, quantizedVertices);
+
+    Meshlet meshlet;
+    meshlet.vertexCount = 4;
+    meshlet.indexCount = 6;
+    const std::vector<std::uint32_t> meshletVertexIndices = { 0, 1, 2, 3 };
+    const std::vector<std::uint32_t> meshletIndices = { 0, 1, 2, 2, 1, 3 };
+    const std::vector<std::uint8_t> meshletBytes { reinterpret_cast<const std::uint8_t*>(&meshlet), reinterpret_cast<const std::uint8_t*>(&meshlet + 1) };
+    const std::vector<std::uint8_t> compressedVertexIndices = Carrot::MeshCompression::encodeIndexSequence(meshletVertexIndices);
+    const std::vector<std::uint8_t> compressedIndices = Carrot::MeshCompression::encodeIndexBuffer(meshletIndices);
+    const std::vector<std::uint8_t> compressedVertices = Carrot::MeshCompression::encodeVertexBuffer(std::span<const Carrot::QuantizedVertex> { quantizedVertices });
+
+    auto addBytes = [&](const std::vector<std::uint8_t>& bytes) {
+        return tinygltf::Value { addAccessor<std::uint8_t>(model, bytes, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_SCALAR) };
+    };
+    auto toValue = [](const glm::vec3& v) {
+        return tinygltf::Value { tinygltf::Value::Array { tinygltf::Value { static_cast<double>(v.x) }, tinygltf::Value { static_cast<double>(v.y) }, tinygltf::Value { static_cast<double>(v.z) } } };
+    };
+    tinygltf::Value::Object extension;
+    extension["meshlets"] = addBytes(meshletBytes);
+    extension["meshlets_vertex_indices"] = addBytes(compressedVertexIndices);
+    extension["meshlets_indices"] = addBytes(compressedIndices);
+    extension["compression"] = tinygltf::Value { std::string { GLTFLoader::CARROT_MESHLETS_MESHOPT_COMPRESSION } };
+    extension["meshlets_vertex_indices_count"] = tinygltf::Value { static_cast<int>(meshletVertexIndices.size()) };
+    extension["meshlets_indices_count"] = tinygltf::Value { static_cast<int>(meshletIndices.size()) };
+    extension["quantized_vertices"] = addBytes(compressedVertices);
+    extension["quantized_vertices_count"] = tinygltf::Value { static_cast<int>(quantizedVertices.size()) };
+    extension["quantization_bounds_min"] = toValue(bounds.min);
+    extension["quantization_bounds_max"] = toValue(bounds.max);
+    model.meshes[0].primitives[0].extensions[GLTFLoader::CARROT_MESHLETS_EXTENSION_NAME] = tinygltf::Value { std::move(extension) };
+
+    const LoadedScene fromGLTF = loader.load(model, {});
+    const LoadedPrimitive& primitive = fromGLTF.primitives[0];
+    ASSERT_EQ(primitive.quantizedVertices.size(), quantizedVertices.size());
+    EXPECT_EQ(std::memcmp(primitive.quantizedVertices.data(), quantizedVertices.data(), quantizedVertices.size() * sizeof(Carrot::QuantizedVertex)), 0);
+    EXPECT_EQ(primitive.quantizationBounds.min, bounds.min);
+    EXPECT_EQ(primitive.quantizationBounds.max, bounds.max);
+    EXPECT_EQ(primitive.meshletVertexIndices, meshletVertexIndices);
+
+    // the cooked model keeps them too
+    const std::vector<std::uint8_t> cooked = CookedModel::cook(fromGLTF);
+    EXPECT_EQ(CookedModel::validate(cooked), std::vector<std::string>{});
+    EXPECT_EQ(CookedModel::compare(fromGLTF, CookedModel::load(cooked, {})), std::vector<std::string>{});
+}
@@ -0,0 +1,89 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+#include <core/math/CullingGrid.h>
+
+using namespace Carrot::Math;
+
+/// Frustum of the axis-aligned box [-halfSize; halfSize], planes pointing inside
+static std::array<Plane, 6> makeBoxFrustum(float halfSize) {
+    std::array<Plane, 6> planes;
+    for(int axis = 0; axis < 3; axis++) {
+        glm::vec3 normal { 0.0f };
+        normal[axis] = 1.0f;
+        planes[axis * 2 + 0] = Plane { .normal = normal, .distanceFromOrigin = halfSize };
+        planes[axis * 2 + 1] = Plane { .normal = -normal, .distanceFromOrigin = halfSize };
+    }
+    return planes;
+}
+
+static bool isVisible(const Sphere& sphere, const std::array<Plane, 6>& frustum) {
+    for(const Plane& plane : frustum) {
+        if(plane.getSignedDistance(sphere.center) < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST(CullingGrid, SimpleCases) {
+    const std::array<Plane, 6> frustum = makeBoxFrustum(10.0f);
+    const std::vector<Sphere> spheres {
+        Sphere { .center = { 0, 0, 0 }, .radius = 1.0f },     // inside
+        Sphere { .center = { 50, 0, 0 }, .radius = 1.0f },    // outside
+        Sphere { .center = { 10.5f, 0, 0 }, .radius = 1.0f }, // intersecting a plane
+        Sphere { .center = { -12, 0, 0 }, .radius = 1.0f },   // outside, but close
+        Sphere { .center = { 100, 0, 0 }, .radius = 95.0f },  // very large sphere, far away
+    };
+
+    CullingGrid grid { 4.0f };
+    grid.rebuild(spheres);
+    EXPECT_EQ(grid.getObjectCount(), spheres.size());
+
+    std::vector<std::uint8_t> visibility(spheres.size(), 42);
+    grid.cull(frustum, visibility);
+    EXPECT_EQ(visibility, (std::vector<std::uint8_t>{ 1, 0, 1, 0, 1 }));
+
+    grid.rebuild({});
+    visibility.clear();
+    grid.cull(frustum, visibility);
+    EXPECT_EQ(grid.getCellCount(), 0);
+}
+
+TEST(CullingGrid, SameResultsAsIndividualTests) {
+    std::mt19937 rng { 1234 };
+    std::uniform_real_distribution<float> position { -100.0f, 100.0f };
+    std::uniform_real_distribution<float> radius { 0.0f, 8.0f };
+
+    std::vector<Sphere> spheres;
+    spheres.resize(10000);
+    for(Sphere& sphere : spheres) {
+        sphere.center = glm::vec3 { position(rng), position(rng), position(rng) };
+        sphere.radius = radius(rng);
+    }
+
+    CullingGrid grid { 16.0f };
+    grid.rebuild(spheres);
+    EXPECT_GT(grid.getCellCount(), 1);
+
+    // a tilted frustum, so that cells are not aligned with planes
+    std::array<Plane, 6> frustum = makeBoxFrustum(40.0f);
+    frustum[0] = Plane { .normal = { 1, 1, 0 }, .distanceFromOrigin = 30.0f };
+    frustum[0].normalize();
+
+    std::vector<std::uint8_t> visibility(spheres.size(), 42);
+    grid.cull(frustum, visibility);
+
+    std::size_t visibleCount = 0;
+    for(std::size_t i = 0; i < spheres.size(); i++) {
+        ASSERT_EQ(visibility[i], isVisible(spheres[i], frustum) ? 1 : 0) << "Sphere " << i;
+        visibleCount += visibility[i];
+    }
+    EXPECT_GT(visibleCount, 0);
+    EXPECT_LT(visibleCount, spheres.size());
+}
@@ -9,8 +9,19 @@
 using namespace Carrot;
 using namespace Carrot::IO;
 
+/// Dispatches file events until 'condition' is true, or a timeout is reached
+template<typename Condition>
+static void dispatchUntil(Condition condition) {
+    const auto start = std::chrono::steady_clock::now();
+    while(!condition() && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        FileWatcherService::getInstance().dispatchEvents();
+    }
+}
+
 TEST(FileWatching, DetectModification) {
     std::filesystem::path testFile = "mytestfile.txt";
+    FileWatcherService::getInstance().setDebounceDelay(std::chrono::milliseconds(50));
 
     std::ofstream out(testFile);
     out << "Hello";
@@ -23,22 +34,24 @@ TEST(FileWatching, DetectModification) {
     FileWatcher watcher([&detectedChanges](const auto& path) {
         detectedChanges++;
     }, {testFile});
-    watcher.tick();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    FileWatcherService::getInstance().dispatchEvents();
 
     ASSERT_EQ(detectedChanges, 0);
 
     out << " world";
     out.flush();
 
-    std::this_thread::sleep_for(std::chrono::duration<float>(0.1f));
-
-    watcher.tick();
+    dispatchUntil([&]() { return detectedChanges >= 1; });
     ASSERT_EQ(detectedChanges, 1);
 
     out << "!";
     out.close();
 
-    watcher.tick();
+    // modification + close must be coalesced into a single event
+    dispatchUntil([&]() { return detectedChanges >= 2; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    FileWatcherService::getInstance().dispatchEvents();
     ASSERT_EQ(detectedChanges, 2);
 
     std::filesystem::remove(testFile);
@@ -0,0 +1,70 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/allocators/FrameArenaAllocator.h>
+#include <core/containers/Vector.hpp>
+#include <cstring>
+#include <thread>
+
+using namespace Carrot;
+
+TEST(FrameArenaAllocator, AllocationsAreAligned) {
+    FrameArenaAllocator& allocator = FrameArenaAllocator::get();
+    allocator.newFrame();
+    for(std::size_t alignment = 1; alignment <= 256; alignment *= 2) {
+        MemoryBlock block = allocator.allocate(3, alignment);
+        ASSERT_NE(block.ptr, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block.ptr) % alignment, 0);
+        allocator.deallocate(block);
+    }
+
+    // larger than a chunk
+    MemoryBlock large = allocator.allocate(FrameArenaAllocator::DefaultChunkSize * 3, 16);
+    ASSERT_NE(large.ptr, nullptr);
+    std::memset(large.ptr, 0xFF, large.size);
+}
+
+TEST(FrameArenaAllocator, LatestAllocationGrowsInPlace) {
+    FrameArenaAllocator& allocator = FrameArenaAllocator::get();
+    allocator.newFrame();
+    MemoryBlock block = allocator.allocate(16, 8);
+    MemoryBlock grown = allocator.reallocate(block, 64, 8);
+    EXPECT_EQ(grown.ptr, block.ptr);
+    EXPECT_EQ(grown.size, 64);
+
+    allocator.allocate(16, 8);
+    MemoryBlock moved = allocator.reallocate(grown, 128, 8);
+    EXPECT_NE(moved.ptr, grown.ptr);
+}
+
+TEST(FrameArenaAllocator, MemoryLivesForFrameCount) {
+    FrameArenaAllocator& allocator = FrameArenaAllocator::get();
+    allocator.newFrame();
+    Vector<int> values { allocator };
+    for(int i = 0; i < 1000; i++) {
+        values.pushBack(i);
+    }
+
+    // allocations from other threads and following frames must not overwrite the vector
+    for(std::size_t frame = 1; frame < FrameArenaAllocator::FrameCount; frame++) {
+        allocator.newFrame();
+        std::thread other([&]() {
+            MemoryBlock block = allocator.allocate(4096, 4);
+            std::memset(block.ptr, 0, block.size);
+        });
+        other.join();
+        MemoryBlock block = allocator.allocate(4096, 4);
+        std::memset(block.ptr, 0, block.size);
+    }
+    for(int i = 0; i < 1000; i++) {
+        ASSERT_EQ(values[i], i);
+    }
+
+    const FrameArenaAllocator::Stats stats = allocator.getStats();
+    EXPECT_GE(stats.currentFrameBytes, 4096);
+    EXPECT_GE(stats.highWaterMark, stats.previousFrameBytes);
+    EXPECT_GT(stats.reservedBytes, 0);
+}
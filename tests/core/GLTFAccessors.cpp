@@ -0,0 +1,149 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/scene/GLTFAccessors.h>
+#include <glm/glm.hpp>
+#include <cstring>
+#include <vector>
+
+using namespace Carrot::Render;
+
+TEST(GLTFAccessors, NormalizedIntegers) {
+    const std::uint8_t unsignedBytes[] { 0, 51, 255 };
+    float converted[3];
+    GLTFAccessors::convert(GLTFAccessors::StridedElements {
+        .pData = unsignedBytes,
+        .stride = 1,
+        .count = 3,
+        .componentType = GLTFAccessors::ComponentType::UnsignedByte,
+        .componentCount = 1,
+        .normalized = true,
+    }, converted, sizeof(float), 1);
+    EXPECT_EQ(converted[0], 0.0f);
+    EXPECT_FLOAT_EQ(converted[1], 0.2f);
+    EXPECT_EQ(converted[2], 1.0f);
+
+    const std::int16_t signedShorts[] { -32768, -32767, 32767 };
+    GLTFAccessors::convert(GLTFAccessors::StridedElements {
+        .pData = reinterpret_cast<const std::uint8_t*>(signedShorts),
+        .stride = sizeof(std::int16_t),
+        .count = 3,
+        .componentType = GLTFAccessors::ComponentType::Short,
+        .componentCount = 1,
+        .normalized = true,
+    }, converted, sizeof(float), 1);
+    EXPECT_EQ(converted[0], -1.0f);
+    EXPECT_EQ(converted[1], -1.0f);
+    EXPECT_EQ(converted[2], 1.0f);
+
+    // not normalized: values are kept as-is (for instance, quantized positions)
+    GLTFAccessors::convert(GLTFAccessors::StridedElements {
+        .pData = unsignedBytes,
+        .stride = 1,
+        .count = 3,
+        .componentType = GLTFAccessors::ComponentType::UnsignedByte,
+        .componentCount = 1,
+        .normalized = false,
+    }, converted, sizeof(float), 1);
+    EXPECT_EQ(converted[1], 51.0f);
+}
+
+TEST(GLTFAccessors, InterleavedToInterleaved) {
+    struct SourceVertex {
+        float position[3];
+        std::uint16_t uv[2];
+    };
+    struct DestinationVertex {
+        glm::vec4 pos { 0, 0, 0, 1 };
+        glm::vec2 uv { -1 };
+    };
+
+    std::vector<SourceVertex> source(5);
+    for(std::size_t i = 0; i < source.size(); i++) {
+        source[i].position[0] = float(i);
+        source[i].position[1] = float(i) * 2.0f;
+        source[i].position[2] = float(i) * 3.0f;
+        source[i].uv[0] = static_cast<std::uint16_t>(i * 1000);
+        source[i].uv[1] = 65535;
+    }
+
+    std::vector<DestinationVertex> destination(source.size());
+    GLTFAccessors::StridedElements positions {
+        .pData = reinterpret_cast<const std::uint8_t*>(source.data()) + offsetof(SourceVertex, position),
+        .stride = sizeof(SourceVertex),
+        .count = source.size(),
+        .componentType = GLTFAccessors::ComponentType::Float,
+        .componentCount = 3,
+    };
+    GLTFAccessors::convert(positions, &destination[0].pos.x, sizeof(DestinationVertex), 3);
+
+    GLTFAccessors::StridedElements uvs {
+        .pData = reinterpret_cast<const std::uint8_t*>(source.data()) + offsetof(SourceVertex, uv),
+        .stride = sizeof(SourceVertex),
+        .count = source.size(),
+        .componentType = GLTFAccessors::ComponentType::UnsignedShort,
+        .componentCount = 2,
+        .normalized = true,
+    };
+    // only read U: V must keep its previous value
+    GLTFAccessors::convert(uvs, &destination[0].uv.x, sizeof(DestinationVertex), 1);
+
+    for(std::size_t i = 0; i < source.size(); i++) {
+        EXPECT_EQ(destination[i].pos, glm::vec4(i, i * 2, i * 3, 1));
+        EXPECT_FLOAT_EQ(destination[i].uv.x, (i * 1000) / 65535.0f);
+        EXPECT_EQ(destination[i].uv.y, -1.0f);
+    }
+}
+
+TEST(GLTFAccessors, Sparse) {
+    // no buffer view: starts from zeros
+    std::vector<glm::vec3> destination(6, glm::vec3 { 5.0f });
+    GLTFAccessors::convert(GLTFAccessors::StridedElements {
+        .pData = nullptr,
+        .count = destination.size(),
+        .componentType = GLTFAccessors::ComponentType::Float,
+        .componentCount = 3,
+    }, &destination[0].x, sizeof(glm::vec3), 3);
+    for(const glm::vec3& v : destination) {
+        EXPECT_EQ(v, glm::vec3(0.0f));
+    }
+
+    const std::uint8_t indices[] { 1, 4 };
+    const std::int8_t values[] { 127, 0, -127, 0, 127, 0 };
+    GLTFAccessors::convertSparse(GLTFAccessors::StridedElements {
+        .pData = indices,
+        .stride = 1,
+        .count = 2,
+        .componentType = GLTFAccessors::ComponentType::UnsignedByte,
+    }, GLTFAccessors::StridedElements {
+        .pData = reinterpret_cast<const std::uint8_t*>(values),
+        .stride = 3,
+        .count = 2,
+        .componentType = GLTFAccessors::ComponentType::Byte,
+        .componentCount = 3,
+        .normalized = true,
+    }, destination.size(), &destination[0].x, sizeof(glm::vec3), 3);
+
+    EXPECT_EQ(destination[0], glm::vec3(0.0f));
+    EXPECT_EQ(destination[1], glm::vec3(1, 0, -1));
+    EXPECT_EQ(destination[2], glm::vec3(0.0f));
+    EXPECT_EQ(destination[4], glm::vec3(0, 1, 0));
+
+    const std::uint8_t outOfBounds[] { 6, 0 };
+    EXPECT_ANY_THROW(GLTFAccessors::convertSparse(GLTFAccessors::StridedElements {
+        .pData = outOfBounds,
+        .stride = 1,
+        .count = 2,
+        .componentType = GLTFAccessors::ComponentType::UnsignedByte,
+    }, GLTFAccessors::StridedElements {
+        .pData = reinterpret_cast<const std::uint8_t*>(values),
+        .stride = 3,
+        .count = 2,
+        .componentType = GLTFAccessors::ComponentType::Byte,
+        .componentCount = 3,
+        .normalized = true,
+    }, destination.size(), &destination[0].x, sizeof(glm::vec3), 3));
+}
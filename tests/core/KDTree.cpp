@@ -0,0 +1,109 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/allocators/MallocAllocator.h>
+#include <core/containers/KDTree.hpp>
+#include <algorithm>
+#include <random>
+
+using namespace Carrot;
+
+struct Point {
+    glm::vec3 position;
+
+    glm::vec3 getPosition() const {
+        return position;
+    }
+};
+
+static std::vector<Point> generatePoints(std::size_t count, std::uint32_t seed) {
+    std::mt19937 rng { seed };
+    std::uniform_real_distribution<float> distribution { -10.0f, 10.0f };
+    std::vector<Point> points;
+    points.resize(count);
+    for(auto& p : points) {
+        p.position = { distribution(rng), distribution(rng), distribution(rng) };
+    }
+    return points;
+}
+
+TEST(KDTree, Empty) {
+    KDTree<Point> tree { MallocAllocator::instance };
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.closestNeighbor(Point{}), -1);
+
+    Vector<std::size_t> neighbors;
+    tree.getNeighbors(neighbors, Point{}, 100.0f);
+    EXPECT_TRUE(neighbors.empty());
+}
+
+TEST(KDTree, NeighborsMatchBruteForce) {
+    const std::vector<Point> points = generatePoints(5000, 42);
+    const std::vector<Point> queries = generatePoints(200, 1337);
+    KDTree<Point> tree { MallocAllocator::instance, points };
+    EXPECT_EQ(tree.size(), points.size());
+
+    const float radius = 1.5f;
+    for(const Point& query : queries) {
+        Vector<std::size_t> neighbors;
+        tree.getNeighbors(neighbors, query, radius);
+        std::vector<std::size_t> result { neighbors.begin(), neighbors.end() };
+        std::sort(result.begin(), result.end());
+
+        std::vector<std::size_t> expected;
+        for(std::size_t i = 0; i < points.size(); i++) {
+            if(glm::distance2(points[i].position, query.position) <= radius * radius) {
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(result, expected);
+    }
+}
+
+TEST(KDTree, RangeSearchMatchesBruteForce) {
+    const std::vector<Point> points = generatePoints(5000, 7);
+    KDTree<Point> tree { MallocAllocator::instance, points };
+
+    const glm::vec3 min { -2.0f, -5.0f, 0.0f };
+    const glm::vec3 max { 3.0f, 1.0f, 8.0f };
+    Vector<std::size_t> found;
+    tree.rangeSearch(found, min, max);
+    std::vector<std::size_t> result { found.begin(), found.end() };
+    std::sort(result.begin(), result.end());
+
+    std::vector<std::size_t> expected;
+    for(std::size_t i = 0; i < points.size(); i++) {
+        if(glm::all(glm::greaterThanEqual(points[i].position, min)) && glm::all(glm::lessThan(points[i].position, max))) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(result, expected);
+}
+
+TEST(KDTree, KNearestMatchesBruteForce) {
+    const std::vector<Point> points = generatePoints(3000, 3);
+    const std::vector<Point> queries = generatePoints(100, 4);
+    KDTree<Point> tree { MallocAllocator::instance, points };
+
+    constexpr std::size_t k = 8;
+    std::vector<std::int64_t> result;
+    result.resize(queries.size() * k);
+    tree.getKNearestNeighborsBatch(result, queries, k);
+
+    for(std::size_t q = 0; q < queries.size(); q++) {
+        std::vector<std::size_t> expected;
+        for(std::size_t i = 0; i < points.size(); i++) {
+            expected.push_back(i);
+        }
+        std::partial_sort(expected.begin(), expected.begin() + k, expected.end(), [&](std::size_t a, std::size_t b) {
+            return glm::distance2(points[a].position, queries[q].position) < glm::distance2(points[b].position, queries[q].position);
+        });
+        for(std::size_t i = 0; i < k; i++) {
+            EXPECT_EQ(result[q * k + i], expected[i]);
+        }
+        EXPECT_EQ(tree.closestNeighbor(queries[q]), expected[0]);
+    }
+}
@@ -3,6 +3,7 @@
 //
 
 #include <core/io/Logging.hpp>
+#include <core/utils/Assert.h>
 
 using namespace Carrot;
 
@@ -18,5 +19,34 @@ int main() {
     Carrot::Log::error("other test %s %s %s", "hiii", "hiii2", "hiii3");
     Carrot::Log::error("other test %s %s %s %s", "hiii", "hiii2", "hiii3", "hiii4");
 
+    Carrot::Log::Category quietCategory { "Quiet", Carrot::Log::Severity::Warning };
+    Carrot::Log::info(quietCategory, "filtered out %d", 3);
+    Carrot::Log::warn(quietCategory, "not filtered %d", 4);
+
+    Carrot::Log::setGlobalMinimumSeverity(Carrot::Log::Severity::Error);
+    Carrot::Log::warn("filtered out %d", 5);
+    Carrot::Log::error(quietCategory, "not filtered %d", 6);
+    Carrot::Log::setGlobalMinimumSeverity(Carrot::Log::Severity::Debug);
+
+    Carrot::Log::flush();
+
+    // counted first, then checked: the visitor must not log
+    int filteredOut = 0;
+    int notFiltered = 0;
+    bool wrongCategory = false;
+    Carrot::Log::visitMessageHistory([&](const Carrot::Log::MessageHistory& history) {
+        for(std::int64_t i = 0; i < history.getCount(); i++) {
+            const Carrot::Log::Message& message = history[i];
+            if(message.message.starts_with("filtered out")) {
+                filteredOut++;
+            } else if(message.message.starts_with("not filtered")) {
+                wrongCategory |= message.category != "Quiet";
+                notFiltered++;
+            }
+        }
+    });
+    verify(filteredOut == 0, "Messages below the minimum severity must be discarded");
+    verify(notFiltered == 2, "Messages above the minimum severity must be kept");
+    verify(!wrongCategory, "Messages must keep their category");
     return 0;
 }
\ No newline at end of file
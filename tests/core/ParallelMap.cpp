@@ -0,0 +1,129 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/async/ParallelMap.hpp>
+#include <string>
+#include <thread>
+
+using namespace Carrot::Async;
+
+TEST(ParallelMap, BasicOperations) {
+    ParallelMap<int, std::string> map;
+    EXPECT_EQ(map.find(42), nullptr);
+    EXPECT_EQ(map.getOrCompute(42, []() { return "hello"; }), "hello");
+    EXPECT_EQ(map.getOrCompute(42, []() { return "other"; }), "hello");
+    ASSERT_NE(map.find(42), nullptr);
+    EXPECT_EQ(*map.find(42), "hello");
+    EXPECT_EQ(map.size(), 1);
+
+    map.replace(42, "replaced");
+    EXPECT_EQ(*map.find(42), "replaced");
+
+    EXPECT_TRUE(map.remove(42));
+    EXPECT_FALSE(map.remove(42));
+    EXPECT_EQ(map.find(42), nullptr);
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.getOrCompute(42, []() { return "recomputed"; }), "recomputed");
+
+    map.clear();
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_EQ(map.snapshot().size(), 0);
+}
+
+TEST(ParallelMap, ValuesNeverMove) {
+    ParallelMap<int, int> map;
+    int* pFirst = &map.getOrCompute(0, []() { return 0; });
+    for(int i = 1; i < 10000; i++) {
+        map.getOrCompute(i, [i]() { return i; });
+    }
+    EXPECT_EQ(pFirst, map.find(0));
+
+    auto snapshot = map.snapshot();
+    EXPECT_EQ(snapshot.size(), 10000);
+    for(auto& [key, pValue] : snapshot) {
+        EXPECT_EQ(key, *pValue);
+    }
+}
+
+TEST(ParallelMap, GeneratorCalledOncePerKey) {
+    constexpr int ThreadCount = 8;
+    constexpr int KeyCount = 2000;
+    ParallelMap<int, int> map;
+    std::atomic<int> generatorCalls = 0;
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < ThreadCount; t++) {
+        threads.emplace_back([&]() {
+            for(int key = 0; key < KeyCount; key++) {
+                const int value = map.getOrCompute(key, [&]() {
+                    generatorCalls++;
+                    return key * 2;
+                });
+                EXPECT_EQ(value, key * 2);
+            }
+        });
+    }
+    for(auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(generatorCalls.load(), KeyCount);
+    EXPECT_EQ(map.size(), KeyCount);
+}
+
+TEST(ParallelMap, ConcurrentInsertFindRemove) {
+    constexpr int ThreadCount = 8;
+    constexpr int KeysPerThread = 2000;
+    ParallelMap<int, int> map;
+
+    // each thread inserts and removes its own keys, and reads the keys of the other threads while they are modified.
+    // even keys are never removed, so their values can be read safely from any thread
+    std::vector<std::thread> threads;
+    for(int t = 0; t < ThreadCount; t++) {
+        threads.emplace_back([&, t]() {
+            const int firstKey = t * KeysPerThread;
+            const int otherThreadKey = ((t + 1) % ThreadCount) * KeysPerThread;
+            for(int i = 0; i < KeysPerThread; i++) {
+                const int key = firstKey + i;
+                EXPECT_EQ(map.getOrCompute(key, [key]() { return key * 2; }), key * 2);
+
+                const int otherKey = (otherThreadKey + i) & ~1;
+                if(const int* pValue = map.find(otherKey)) {
+                    EXPECT_EQ(*pValue, otherKey * 2);
+                }
+            }
+
+            for(int i = 1; i < KeysPerThread; i += 2) {
+                const int key = firstKey + i;
+                EXPECT_TRUE(map.remove(key));
+                EXPECT_EQ(map.find(key), nullptr);
+                if(key % 4 == 1) {
+                    map.replace(key, key * 3);
+                }
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    int expectedSize = 0;
+    for(int key = 0; key < ThreadCount * KeysPerThread; key++) {
+        const int* pValue = map.find(key);
+        if(key % 2 == 0) {
+            ASSERT_NE(pValue, nullptr) << key;
+            EXPECT_EQ(*pValue, key * 2);
+            expectedSize++;
+        } else if(key % 4 == 1) {
+            ASSERT_NE(pValue, nullptr) << key;
+            EXPECT_EQ(*pValue, key * 3);
+            expectedSize++;
+        } else {
+            EXPECT_EQ(pValue, nullptr) << key;
+        }
+    }
+    EXPECT_EQ(map.size(), expectedSize);
+    EXPECT_EQ(map.snapshot().size(), expectedSize);
+}
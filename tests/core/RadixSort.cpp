@@ -0,0 +1,93 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include <core/tasks/Tasks.h>
+#include <core/utils/RadixSort.h>
+
+using namespace Carrot;
+
+static std::vector<SortKeyIndex> makeItems(std::size_t count, std::uint64_t keyMask) {
+    std::mt19937_64 rng { 1234 };
+    std::vector<SortKeyIndex> items;
+    items.resize(count);
+    for(std::size_t i = 0; i < count; i++) {
+        items[i] = SortKeyIndex { .key = rng() & keyMask, .index = static_cast<std::uint32_t>(i) };
+    }
+    return items;
+}
+
+static void checkSorted(std::vector<SortKeyIndex> items) {
+    std::vector<SortKeyIndex> expected = items;
+    std::stable_sort(expected.begin(), expected.end(), [](const SortKeyIndex& a, const SortKeyIndex& b) {
+        return a.key < b.key;
+    });
+
+    std::vector<SortKeyIndex> scratch;
+    scratch.resize(items.size());
+    radixSort(items, scratch);
+
+    ASSERT_EQ(items.size(), expected.size());
+    for(std::size_t i = 0; i < items.size(); i++) {
+        ASSERT_EQ(items[i].key, expected[i].key);
+        ASSERT_EQ(items[i].index, expected[i].index); // must be stable
+    }
+}
+
+TEST(RadixSort, Small) {
+    checkSorted({});
+    checkSorted(makeItems(1, ~0ull));
+    checkSorted(makeItems(100, ~0ull));
+    checkSorted(makeItems(100, 0)); // all keys equal
+}
+
+TEST(RadixSort, ManyDuplicateKeys) {
+    checkSorted(makeItems(10000, 0xF00000000000000Full)); // most digits are skipped
+}
+
+TEST(RadixSort, CustomKey) {
+    struct Edge {
+        std::uint32_t meshletIndex;
+        std::uint64_t edgeKey;
+    };
+    std::vector<Edge> edges;
+    for(const SortKeyIndex& item : makeItems(5000, 0xFF000000FFull)) {
+        edges.push_back(Edge { .meshletIndex = item.index, .edgeKey = item.key });
+    }
+    std::vector<Edge> expected = edges;
+    std::stable_sort(expected.begin(), expected.end(), [](const Edge& a, const Edge& b) {
+        return a.edgeKey < b.edgeKey;
+    });
+
+    std::vector<Edge> scratch;
+    scratch.resize(edges.size());
+    radixSort(std::span { edges }, std::span { scratch }, [](const Edge& e) { return e.edgeKey; });
+    for(std::size_t i = 0; i < edges.size(); i++) {
+        ASSERT_EQ(edges[i].edgeKey, expected[i].edgeKey);
+        ASSERT_EQ(edges[i].meshletIndex, expected[i].meshletIndex);
+    }
+}
+
+TEST(RadixSort, ParallelBlocks) {
+    auto previousParallelFor = Carrot::Async::parallelFor;
+    Carrot::Async::parallelFor = [](std::size_t count, const std::function<void(std::size_t)>& forEach, std::size_t granularity) {
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i < count; i++) {
+            threads.emplace_back([&forEach, i]() { forEach(i); });
+        }
+        for(auto& t : threads) {
+            t.join();
+        }
+    };
+
+    checkSorted(makeItems(200000, ~0ull));
+    checkSorted(makeItems(200000, 0xFFFF0000FFull));
+
+    Carrot::Async::parallelFor = previousParallelFor;
+}
@@ -0,0 +1,146 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/render/MeshCompression.h>
+#include <core/render/VertexQuantization.h>
+#include <cstring>
+#include <random>
+
+using namespace Carrot;
+
+static glm::vec3 randomDirection(std::mt19937& rng) {
+    std::normal_distribution<float> distribution;
+    glm::vec3 v { distribution(rng), distribution(rng), distribution(rng) };
+    return glm::normalize(v);
+}
+
+static float angleBetween(const glm::vec3& a, const glm::vec3& b) {
+    // more precise than acos for small angles
+    return glm::atan(glm::length(glm::cross(a, b)), glm::dot(a, b));
+}
+
+TEST(VertexQuantization, OctahedralRoundTrip) {
+    // exact axes, including the folded lower hemisphere
+    for(const glm::vec3& axis : { glm::vec3{1,0,0}, glm::vec3{-1,0,0}, glm::vec3{0,1,0}, glm::vec3{0,-1,0}, glm::vec3{0,0,1}, glm::vec3{0,0,-1} }) {
+        EXPECT_LT(angleBetween(VertexQuantization::decodeOctahedral(VertexQuantization::encodeOctahedral(axis)), axis), 1e-5f);
+    }
+
+    std::mt19937 rng { 42 };
+    for(int i = 0; i < 10000; i++) {
+        const glm::vec3 direction = randomDirection(rng);
+        const glm::vec2 encoded = VertexQuantization::encodeOctahedral(direction);
+        EXPECT_LE(glm::abs(encoded.x), 1.0f);
+        EXPECT_LE(glm::abs(encoded.y), 1.0f);
+        EXPECT_LT(angleBetween(VertexQuantization::decodeOctahedral(encoded), direction), 1e-5f);
+    }
+}
+
+TEST(VertexQuantization, DecodeErrorIsBounded) {
+    std::mt19937 rng { 1234 };
+    std::uniform_real_distribution<float> positions { -50.0f, 50.0f };
+    std::uniform_real_distribution<float> unit { 0.0f, 1.0f };
+
+    std::vector<PackedVertex> vertices(1000);
+    for(PackedVertex& v : vertices) {
+        v.pos = { positions(rng), positions(rng) * 0.1f, positions(rng) };
+        v.normal = randomDirection(rng);
+        v.tangent = glm::vec4 { randomDirection(rng), unit(rng) < 0.5f ? -1.0f : 1.0f };
+        v.uv = { unit(rng) * 4.0f - 2.0f, unit(rng) };
+        v.color = { unit(rng), unit(rng), unit(rng) };
+    }
+
+    const Math::AABB bounds = VertexQuantization::computeBounds(vertices);
+    const glm::vec3 maxPositionError = VertexQuantization::getMaxPositionError(bounds);
+    std::vector<QuantizedVertex> quantized(vertices.size());
+    VertexQuantization::encode(vertices, bounds, quantized);
+
+    for(std::size_t i = 0; i < vertices.size(); i++) {
+        const PackedVertex& original = vertices[i];
+        const PackedVertex decoded = VertexQuantization::decode(quantized[i], bounds);
+
+        for(int axis = 0; axis < 3; axis++) {
+            // small slack for float rounding during the conversion
+            EXPECT_LE(glm::abs(decoded.pos[axis] - original.pos[axis]), maxPositionError[axis] * 1.01f) << "axis " << axis;
+        }
+        // 16 bits per component
+        EXPECT_LT(angleBetween(decoded.normal, original.normal), 1e-3f);
+        EXPECT_LT(angleBetween(glm::vec3 { decoded.tangent }, glm::vec3 { original.tangent }), 1e-3f);
+        EXPECT_EQ(decoded.tangent.w, original.tangent.w);
+        // half floats: 10 bits of mantissa
+        EXPECT_LE(glm::abs(decoded.uv.x - original.uv.x), 2.0f / 1024.0f);
+        EXPECT_LE(glm::abs(decoded.uv.y - original.uv.y), 1.0f / 1024.0f);
+        // 8 bits per channel
+        for(int channel = 0; channel < 3; channel++) {
+            EXPECT_LE(glm::abs(decoded.color[channel] - original.color[channel]), 0.5f / 255.0f + 1e-6f);
+        }
+    }
+}
+
+TEST(VertexQuantization, FlatBounds) {
+    PackedVertex v;
+    v.pos = { 1.0f, 2.0f, 3.0f };
+    v.normal = { 0, 1, 0 };
+    v.tangent = { 1, 0, 0, 1 };
+    v.uv = { 0.5f, 0.25f };
+    v.color = { 1, 1, 1 };
+
+    const PackedVertex vertices[] { v, v };
+    const Math::AABB bounds = VertexQuantization::computeBounds(vertices);
+    const PackedVertex decoded = VertexQuantization::decode(VertexQuantization::encode(v, bounds), bounds);
+    EXPECT_EQ(decoded.pos, v.pos);
+    EXPECT_EQ(decoded.uv, v.uv);
+}
+
+TEST(MeshCompression, IndexRoundTrip) {
+    // grid of quads, like meshlet triangles
+    std::vector<std::uint32_t> triangles;
+    constexpr std::uint32_t Size = 16;
+    for(std::uint32_t y = 0; y < Size - 1; y++) {
+        for(std::uint32_t x = 0; x < Size - 1; x++) {
+            const std::uint32_t i = x + y * Size;
+            triangles.insert(triangles.end(), { i, i + 1, i + Size, i + 1, i + Size + 1, i + Size });
+        }
+    }
+    const std::vector<std::uint8_t> encodedTriangles = MeshCompression::encodeIndexBuffer(triangles);
+    EXPECT_LT(encodedTriangles.size(), triangles.size() * sizeof(std::uint32_t));
+    std::vector<std::uint32_t> decodedTriangles(triangles.size());
+    MeshCompression::decodeIndexBuffer(encodedTriangles, decodedTriangles);
+    // the codec may rotate triangles, but keeps their winding
+    for(std::size_t t = 0; t < triangles.size(); t += 3) {
+        const std::uint32_t* pOriginal = &triangles[t];
+        const std::uint32_t* pDecoded = &decodedTriangles[t];
+        bool sameTriangle = false;
+        for(int rotation = 0; rotation < 3; rotation++) {
+            sameTriangle |= pDecoded[0] == pOriginal[rotation] && pDecoded[1] == pOriginal[(rotation + 1) % 3] && pDecoded[2] == pOriginal[(rotation + 2) % 3];
+        }
+        EXPECT_TRUE(sameTriangle) << "triangle " << t / 3;
+    }
+
+    std::vector<std::uint32_t> sequence { 5, 6, 7, 100, 101, 3, 4, 4000, 4001, 4002 };
+    std::vector<std::uint32_t> decodedSequence(sequence.size());
+    MeshCompression::decodeIndexSequence(MeshCompression::encodeIndexSequence(sequence), decodedSequence);
+    EXPECT_EQ(decodedSequence, sequence);
+
+    std::vector<std::uint8_t> garbage { 0xFF, 0x00, 0x12 };
+    EXPECT_THROW(MeshCompression::decodeIndexSequence(garbage, decodedSequence), std::runtime_error);
+}
+
+TEST(MeshCompression, QuantizedVertexRoundTrip) {
+    std::vector<QuantizedVertex> vertices(256);
+    for(std::uint32_t i = 0; i < vertices.size(); i++) {
+        vertices[i].positionXY = i * 37;
+        vertices[i].positionZ = i;
+        vertices[i].normal = 0x7FFF0000 + i;
+        vertices[i].tangent = 0x00007FFF;
+        vertices[i].uv = i * i;
+        vertices[i].color = 0xFFFFFFFF;
+    }
+
+    const std::vector<std::uint8_t> encoded = MeshCompression::encodeVertexBuffer<QuantizedVertex>(vertices);
+    std::vector<QuantizedVertex> decoded(vertices.size());
+    MeshCompression::decodeVertexBuffer<QuantizedVertex>(encoded, decoded);
+    EXPECT_EQ(0, std::memcmp(decoded.data(), vertices.data(), vertices.size() * sizeof(QuantizedVertex)));
+}
@@ -0,0 +1,90 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <core/utils/WeakPool.hpp>
+
+using namespace Carrot;
+
+struct Element: public WeakPoolHandle {
+    Element(std::uint32_t index, WeakPoolHandle::Releaser releaser, int value): WeakPoolHandle(index, releaser), value(value) {}
+
+    int value = 0;
+};
+
+TEST(WeakPool, SlotsAreReusedLowestFirst) {
+    WeakPool<Element> pool;
+    auto a = pool.create(1);
+    auto b = pool.create(2);
+    auto c = pool.create(3);
+    EXPECT_EQ(a->getSlot(), 1); // slot 0 is reserved
+    EXPECT_EQ(b->getSlot(), 2);
+    EXPECT_EQ(c->getSlot(), 3);
+    EXPECT_EQ(pool.size(), 3);
+    EXPECT_EQ(pool.getRequiredStorageCount(), 4);
+
+    const std::uint64_t idOfA = a->getID();
+    a = nullptr;
+    b = nullptr;
+    EXPECT_EQ(pool.size(), 1);
+    EXPECT_EQ(pool.getRequiredStorageCount(), 4);
+
+    auto d = pool.create(4);
+    EXPECT_EQ(d->getSlot(), 1);
+    EXPECT_NE(d->getID(), idOfA);
+    EXPECT_TRUE(pool.findByID(idOfA).expired());
+    EXPECT_EQ(pool.findByID(d->getID()).lock(), d);
+    EXPECT_EQ(pool.find(1).lock(), d);
+
+    c = nullptr;
+    EXPECT_EQ(pool.getRequiredStorageCount(), 2);
+}
+
+TEST(WeakPool, IterationSkipsFreeSlots) {
+    WeakPool<Element> pool;
+    std::vector<std::shared_ptr<Element>> elements;
+    for(int i = 0; i < 10; i++) {
+        elements.push_back(pool.create(i));
+    }
+    for(int i = 0; i < 10; i += 2) {
+        elements[i] = nullptr;
+    }
+
+    int count = 0;
+    for(auto& [slot, pElement] : pool) {
+        auto pLocked = pElement.lock();
+        ASSERT_NE(pLocked, nullptr);
+        EXPECT_EQ(pLocked->getSlot(), slot);
+        EXPECT_EQ(pLocked->value % 2, 1);
+        count++;
+    }
+    EXPECT_EQ(count, 5);
+}
+
+TEST(WeakPool, DirtyRange) {
+    WeakPool<Element> pool;
+    auto a = pool.create(0);
+    auto b = pool.create(0);
+    auto c = pool.create(0);
+    auto range = pool.consumeDirtyRange();
+    EXPECT_EQ(range.begin, 1);
+    EXPECT_EQ(range.end, 4);
+    EXPECT_TRUE(pool.getDirtyRange().empty());
+
+    pool.markDirty(b->getSlot());
+    range = pool.consumeDirtyRange();
+    EXPECT_EQ(range.begin, 2);
+    EXPECT_EQ(range.end, 3);
+
+    c = nullptr;
+    range = pool.consumeDirtyRange();
+    EXPECT_EQ(range.begin, 3);
+    EXPECT_EQ(range.end, 4);
+
+    pool.markAllDirty();
+    range = pool.consumeDirtyRange();
+    EXPECT_EQ(range.begin, 0);
+    EXPECT_EQ(range.end, pool.getRequiredStorageCount());
+}
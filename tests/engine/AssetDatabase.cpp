@@ -0,0 +1,114 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include "engine/assets/AssetDatabase.h"
+
+using namespace Carrot;
+namespace fs = std::filesystem;
+
+static void writeFile(const fs::path& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << contents;
+}
+
+TEST(AssetDatabase, DependencyChangeInvalidatesDependent) {
+    const fs::path root = fs::temp_directory_path() / "carrot_test_asset_database";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const fs::path texture = root / "texture.png";
+    const fs::path convertedTexture = root / "texture.ktx2";
+    const fs::path model = root / "model.gltf";
+    const fs::path convertedModel = root / "model.gmodel";
+    const fs::path databaseFile = root / "asset_database.json";
+    writeFile(texture, "texture v1");
+    writeFile(convertedTexture, "converted texture");
+    writeFile(model, "model");
+    writeFile(convertedModel, "converted model");
+
+    {
+        AssetDatabase database { databaseFile };
+        database.load();
+        EXPECT_TRUE(database.canAdoptExistingOutput(model));
+
+        database.recordConversion(texture, convertedTexture, 1, {});
+        database.recordConversion(model, convertedModel, 1, { texture });
+        EXPECT_TRUE(database.isUpToDate(model, convertedModel, 1));
+        EXPECT_FALSE(database.canAdoptExistingOutput(model));
+
+        // the texture changes and is converted again: the model must be converted again too, even though its
+        // converted file is still more recent than its source
+        writeFile(texture, "texture v2, with more data");
+        EXPECT_FALSE(database.isUpToDate(texture, convertedTexture, 1));
+        database.recordConversion(texture, convertedTexture, 1, {});
+        EXPECT_TRUE(database.isUpToDate(texture, convertedTexture, 1));
+        EXPECT_FALSE(database.isUpToDate(model, convertedModel, 1));
+        EXPECT_FALSE(database.canAdoptExistingOutput(model));
+        database.save();
+    }
+
+    {
+        // invalidation survives a restart
+        AssetDatabase database { databaseFile };
+        database.load();
+        EXPECT_TRUE(database.isUpToDate(texture, convertedTexture, 1));
+        EXPECT_FALSE(database.isUpToDate(model, convertedModel, 1));
+        EXPECT_FALSE(database.canAdoptExistingOutput(model));
+        ASSERT_EQ(database.getDependents(texture).size(), 1);
+
+        database.recordConversion(model, convertedModel, 1, { texture });
+        EXPECT_TRUE(database.isUpToDate(model, convertedModel, 1));
+    }
+
+    fs::remove_all(root);
+}
+
+TEST(AssetDatabase, FailedConversionIsNeverAdopted) {
+    const fs::path root = fs::temp_directory_path() / "carrot_test_asset_database_failure";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const fs::path source = root / "source.png";
+    writeFile(source, "source");
+
+    AssetDatabase database { root / "asset_database.json" };
+    database.load();
+    EXPECT_TRUE(database.canAdoptExistingOutput(source));
+    database.invalidate(source);
+    EXPECT_FALSE(database.canAdoptExistingOutput(source));
+
+    fs::remove_all(root);
+}
+
+TEST(AssetDatabase, InvalidFilesAreDiscarded) {
+    const fs::path root = fs::temp_directory_path() / "carrot_test_asset_database_invalid";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const fs::path databaseFile = root / "asset_database.json";
+
+    const std::string invalidDatabases[] = {
+        R"({"version": 1, "files": {}, "assets": {"a": {"output": "b", "hash": 0, "converter_version": 1, "depend)",
+        R"({"version": 1})",
+        R"({"version": "1", "files": {}, "assets": {}})",
+        R"({"version": 1, "files": [], "assets": {}})",
+        R"({"version": 1, "files": {"a": {"size": "big", "timestamp": 0, "hash": 0}}, "assets": {}})",
+        R"({"version": 1, "files": {}, "assets": {"a": {"output": "b", "hash": 0, "converter_version": 1}}})",
+        R"({"version": 1, "files": {}, "assets": {"a": {"output": 3, "hash": 0, "converter_version": 1, "dependencies": {}}}})",
+    };
+    for(const std::string& contents : invalidDatabases) {
+        writeFile(databaseFile, contents);
+        AssetDatabase database { databaseFile };
+        database.load();
+        EXPECT_TRUE(database.canAdoptExistingOutput("a")) << contents;
+    }
+
+    writeFile(databaseFile, R"({"version": 1, "files": {}, "assets": {"a": {"output": "b", "hash": 0, "converter_version": 1, "dependencies": {"c": 0}}}})");
+    AssetDatabase database { databaseFile };
+    database.load();
+    EXPECT_FALSE(database.canAdoptExistingOutput("a"));
+    EXPECT_EQ(database.getDependents("c").size(), 1);
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,129 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include "engine/Engine.h"
+#include "engine/ecs/components/TransformComponent.h"
+#include "engine/scene/BinaryScene.h"
+#include "engine/scene/Scene.h"
+#include "core/io/Resource.h"
+
+using namespace Carrot;
+
+#define START_ENGINE()                                      \
+Carrot::Configuration config;                               \
+config.applicationName = __FUNCTION__;                      \
+Carrot::Engine e{ config };
+
+static std::string toString(const rapidjson::Value& json) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer { buffer };
+    json.Accept(writer);
+    return buffer.GetString();
+}
+
+/// Parent with two children, one of them hidden
+static void fillScene(Scene& scene) {
+    ECS::World& world = scene.world;
+    ECS::Entity parent = world.newEntity("Parent").addComponent<ECS::TransformComponent>();
+    parent.getComponent<ECS::TransformComponent>()->localTransform.position = glm::vec3 { 1.0f, 2.0f, 3.0f };
+
+    ECS::Entity child = world.newEntity("Child").addComponent<ECS::TransformComponent>();
+    child.getComponent<ECS::TransformComponent>()->localTransform.scale = glm::vec3 { 0.5f };
+    child.setParent(parent);
+
+    ECS::Entity hidden = world.newEntity("Hidden").addComponent<ECS::TransformComponent>();
+    hidden.setFlags(ECS::EntityFlags::Hidden);
+    hidden.setParent(parent);
+
+    scene.lighting.ambient = glm::vec3 { 0.25f };
+    scene.lighting.raytracedShadows = false;
+}
+
+TEST(BinaryScene, JSONRoundTrip) {
+    START_ENGINE();
+
+    Scene scene;
+    fillScene(scene);
+    rapidjson::Document json;
+    json.SetObject();
+    scene.serialise(json);
+
+    const std::vector<std::uint8_t> binary = BinaryScene::fromJSON(json);
+    rapidjson::Document decoded;
+    decoded.SetObject();
+    BinaryScene::toJSON(binary, decoded);
+
+    // object comparison does not depend on member order
+    EXPECT_TRUE(decoded == json) << toString(json) << "\n" << toString(decoded);
+}
+
+TEST(BinaryScene, LoadGivesSameWorldAsJSON) {
+    START_ENGINE();
+
+    rapidjson::Document json;
+    json.SetObject();
+    {
+        Scene original;
+        fillScene(original);
+        original.serialise(json);
+    }
+    const std::vector<std::uint8_t> binary = BinaryScene::fromJSON(json);
+
+    Scene fromJSON;
+    fromJSON.deserialise(json);
+    Scene fromBinary;
+    BinaryScene::load(IO::Resource { binary }, fromBinary);
+
+    rapidjson::Document jsonFromJSON;
+    jsonFromJSON.SetObject();
+    fromJSON.serialise(jsonFromJSON);
+    rapidjson::Document jsonFromBinary;
+    jsonFromBinary.SetObject();
+    fromBinary.serialise(jsonFromBinary);
+    EXPECT_TRUE(jsonFromBinary == jsonFromJSON) << toString(jsonFromJSON) << "\n" << toString(jsonFromBinary);
+    EXPECT_TRUE(jsonFromBinary == json);
+
+    std::optional<ECS::Entity> child = fromBinary.world.findEntityByName("Child");
+    ASSERT_TRUE(child.has_value());
+    ASSERT_TRUE(child->getParent().has_value());
+    EXPECT_EQ(child->getParent()->getName(), "Parent");
+}
+
+TEST(BinaryScene, RemappedIDsKeepReferences) {
+    START_ENGINE();
+
+    rapidjson::Document json;
+    json.SetObject();
+    {
+        Scene original;
+        fillScene(original);
+        original.serialise(json);
+    }
+    const std::vector<std::uint8_t> binary = BinaryScene::fromJSON(json);
+
+    // the same scene twice inside a single world
+    Scene scene;
+    BinaryScene::load(IO::Resource { binary }, scene);
+    BinaryScene::load(IO::Resource { binary }, scene, BinaryScene::LoadOptions { .remapEntityIDs = true });
+
+    auto isOriginalID = [&](const ECS::Entity& entity) {
+        return json["entities"].HasMember(entity.getID().toString().c_str());
+    };
+    std::size_t entityCount = 0;
+    std::size_t childrenOfParents = 0;
+    for(const ECS::Entity& entity : scene.world.getAllEntities()) {
+        entityCount++;
+        if(std::optional<const ECS::Entity> parent = entity.getParent()) {
+            EXPECT_EQ(parent->getName(), "Parent");
+            // children of the remapped copy reference the remapped parent
+            EXPECT_EQ(isOriginalID(entity), isOriginalID(*parent));
+            childrenOfParents++;
+        }
+    }
+    EXPECT_EQ(entityCount, 6);
+    EXPECT_EQ(childrenOfParents, 4);
+}
@@ -0,0 +1,77 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <core/utils/RadixSort.h>
+#include <engine/render/PacketSortKey.h>
+
+using namespace Carrot;
+using namespace Carrot::Render;
+
+static std::uint64_t transparentKey(float zOrder, std::uint64_t pipelineIndex = 0) {
+    return PacketSortKey::make(PacketSortKey::Fields {
+        .viewportIndex = 1,
+        .passIndex = 2,
+        .zOrdered = true,
+        .zOrder = zOrder,
+        .pipelineIndex = pipelineIndex,
+    });
+}
+
+TEST(PacketSortKey, CloseZOrdersAreDistinct) {
+    const float zOrder = 1000.0f;
+    const float next = std::nextafter(zOrder, 2000.0f);
+    EXPECT_LT(transparentKey(zOrder), transparentKey(next));
+    EXPECT_LT(transparentKey(-next), transparentKey(-zOrder));
+    EXPECT_LT(transparentKey(-1.0f), transparentKey(0.0f));
+    EXPECT_LT(transparentKey(0.0f), transparentKey(std::numeric_limits<float>::denorm_min()));
+
+    // z-order has priority over the pipeline
+    EXPECT_LT(transparentKey(zOrder, 5), transparentKey(next, 0));
+
+    // ImGui draw indices: consecutive integers above 2^20 must keep their order
+    for(std::uint32_t drawIndex = 1 << 20; drawIndex < (1 << 20) + 100; drawIndex++) {
+        EXPECT_LT(transparentKey(static_cast<float>(drawIndex)), transparentKey(static_cast<float>(drawIndex + 1)));
+    }
+}
+
+TEST(PacketSortKey, ZOrderedPacketsAreSortedByZOrder) {
+    const std::vector<float> zOrders = { 3.0f, 1.0f + 1e-6f, 1.0f, -2.0f, 1.0f + 2e-6f, 1.0f };
+    std::vector<SortKeyIndex> items;
+    for(std::size_t i = 0; i < zOrders.size(); i++) {
+        items.push_back(SortKeyIndex { .key = transparentKey(zOrders[i], zOrders.size() - i), .index = static_cast<std::uint32_t>(i) });
+    }
+    std::vector<SortKeyIndex> scratch;
+    scratch.resize(items.size());
+    radixSort(items, scratch);
+
+    const std::vector<std::uint32_t> expectedOrder = { 3, 5, 2, 1, 4, 0 };
+    ASSERT_EQ(items.size(), expectedOrder.size());
+    for(std::size_t i = 0; i < items.size(); i++) {
+        EXPECT_EQ(items[i].index, expectedOrder[i]) << i;
+    }
+}
+
+TEST(PacketSortKey, ViewportAndPassAreKept) {
+    for(bool zOrdered : { false, true }) {
+        const std::uint64_t key = PacketSortKey::make(PacketSortKey::Fields {
+            .viewportIndex = 63,
+            .passIndex = 42,
+            .zOrdered = zOrdered,
+            .zOrder = -std::numeric_limits<float>::max(),
+            .pipelineIndex = ~0ull,
+            .meshIndex = ~0ull,
+            .materialIndex = ~0ull,
+        });
+        EXPECT_EQ(PacketSortKey::getViewportIndex(key), 63);
+        EXPECT_EQ(PacketSortKey::getPassIndex(key), 42);
+    }
+
+    EXPECT_TRUE(PacketSortKey::isZOrderedPass(PassEnum::TransparentGBuffer));
+    EXPECT_TRUE(PacketSortKey::isZOrderedPass(PassEnum::ImGui));
+    EXPECT_FALSE(PacketSortKey::isZOrderedPass(PassEnum::OpaqueGBuffer));
+}
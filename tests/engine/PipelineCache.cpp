@@ -0,0 +1,102 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "engine/Engine.h"
+#include "engine/render/resources/PipelineCache.h"
+
+using namespace Carrot::Render;
+namespace fs = std::filesystem;
+
+static vk::PhysicalDeviceProperties makeProperties() {
+    vk::PhysicalDeviceProperties properties;
+    properties.vendorID = 0x10005;
+    properties.deviceID = 42;
+    properties.driverVersion = VK_MAKE_VERSION(1, 2, 3);
+    for(std::uint8_t i = 0; i < VK_UUID_SIZE; i++) {
+        properties.pipelineCacheUUID[i] = i;
+    }
+    return properties;
+}
+
+/// Data looking like what vkGetPipelineCacheData returns for the given device
+static std::vector<std::uint8_t> makeCacheData(const vk::PhysicalDeviceProperties& properties) {
+    VkPipelineCacheHeaderVersionOne header {
+        .headerSize = sizeof(VkPipelineCacheHeaderVersionOne),
+        .headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE,
+        .vendorID = properties.vendorID,
+        .deviceID = properties.deviceID,
+    };
+    std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+
+    std::vector<std::uint8_t> data;
+    data.resize(sizeof(header) + 64);
+    std::memcpy(data.data(), &header, sizeof(header));
+    for(std::size_t i = sizeof(header); i < data.size(); i++) {
+        data[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    return data;
+}
+
+TEST(PipelineCache, FileRoundTrip) {
+    const vk::PhysicalDeviceProperties properties = makeProperties();
+    const std::vector<std::uint8_t> data = makeCacheData(properties);
+    const std::vector<std::uint8_t> file = PipelineCache::encode(data, properties);
+
+    std::span<const std::uint8_t> decoded = PipelineCache::validate(file, properties);
+    ASSERT_EQ(decoded.size(), data.size());
+    EXPECT_EQ(std::memcmp(decoded.data(), data.data(), data.size()), 0);
+}
+
+TEST(PipelineCache, RejectsOtherDevicesAndDrivers) {
+    const vk::PhysicalDeviceProperties properties = makeProperties();
+    const std::vector<std::uint8_t> file = PipelineCache::encode(makeCacheData(properties), properties);
+
+    vk::PhysicalDeviceProperties newerDriver = properties;
+    newerDriver.driverVersion = VK_MAKE_VERSION(1, 2, 4);
+    EXPECT_TRUE(PipelineCache::validate(file, newerDriver).empty());
+
+    vk::PhysicalDeviceProperties otherDevice = properties;
+    otherDevice.pipelineCacheUUID[3] = 0xFF;
+    EXPECT_TRUE(PipelineCache::validate(file, otherDevice).empty());
+
+    std::vector<std::uint8_t> corrupted = file;
+    corrupted.back() ^= 0xFF;
+    EXPECT_TRUE(PipelineCache::validate(corrupted, properties).empty());
+
+    std::vector<std::uint8_t> truncated { file.begin(), file.end() - 1 };
+    EXPECT_TRUE(PipelineCache::validate(truncated, properties).empty());
+
+    EXPECT_TRUE(PipelineCache::validate({}, properties).empty());
+}
+
+TEST(PipelineCache, PersistedOnShutdown) {
+    const fs::path cacheFile = fs::temp_directory_path() / "carrot_test_pipeline_cache.bin";
+    fs::remove(cacheFile);
+
+    {
+        Carrot::Configuration config;
+        config.applicationName = __FUNCTION__;
+        config.pipelineCacheFile = cacheFile.string();
+        Carrot::Engine e{ config };
+    }
+    ASSERT_TRUE(fs::exists(cacheFile));
+
+    {
+        Carrot::Configuration config;
+        config.applicationName = __FUNCTION__;
+        config.pipelineCacheFile = cacheFile.string();
+        Carrot::Engine e{ config };
+        const vk::PhysicalDeviceProperties properties = e.getVulkanDriver().getPhysicalDevice().getProperties();
+
+        std::ifstream input { cacheFile, std::ios::binary | std::ios::in };
+        const std::vector<std::uint8_t> contents { std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+        EXPECT_FALSE(PipelineCache::validate(contents, properties).empty());
+    }
+    fs::remove(cacheFile);
+}
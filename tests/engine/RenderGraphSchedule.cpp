@@ -0,0 +1,138 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "engine/render/RenderGraphSchedule.h"
+
+using namespace Carrot::Render;
+
+static ScheduledAccess imageAccess(const Carrot::UUID& id, bool write, vk::ImageLayout previousLayout, vk::ImageLayout layout) {
+    return ScheduledAccess {
+        .resourceID = id,
+        .write = write,
+        .previousLayout = previousLayout,
+        .layout = layout,
+    };
+}
+
+static ScheduledPass computePass(std::string name, std::vector<ScheduledAccess> accesses) {
+    return ScheduledPass {
+        .name = std::move(name),
+        .rasterized = false,
+        .shaderStages = vk::PipelineStageFlagBits2KHR::eComputeShader,
+        .accesses = std::move(accesses),
+    };
+}
+
+static TransientResource transient(const Carrot::UUID& id, vk::DeviceSize size, std::uint32_t memoryTypeBits = 0b11) {
+    return TransientResource {
+        .resourceID = id,
+        .memoryRequirements = vk::MemoryRequirements {
+            .size = size,
+            .alignment = 256,
+            .memoryTypeBits = memoryTypeBits,
+        },
+    };
+}
+
+/// a -> b -> c chain: a and c are never alive at the same time
+static std::vector<ScheduledPass> makeChain(const Carrot::UUID& a, const Carrot::UUID& b, const Carrot::UUID& c) {
+    constexpr vk::ImageLayout General = vk::ImageLayout::eGeneral;
+    return {
+        computePass("write a", { imageAccess(a, true, General, General) }),
+        computePass("a to b", { imageAccess(a, false, General, General), imageAccess(b, true, General, General) }),
+        computePass("b to c", { imageAccess(b, false, General, General), imageAccess(c, true, General, General) }),
+        computePass("read c", { imageAccess(c, false, General, General) }),
+    };
+}
+
+TEST(RenderGraphSchedule, AliasesDisjointLifetimes) {
+    Carrot::UUID a, b, c, incompatible;
+    std::vector<ScheduledPass> passes = makeChain(a, b, c);
+    passes[3].accesses.push_back(imageAccess(incompatible, true, vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral));
+
+    const std::vector<TransientResource> transients { transient(a, 1024), transient(b, 1024), transient(c, 1024), transient(incompatible, 512, 0b100) };
+    const Schedule schedule = Schedule::build(passes, transients);
+
+    ASSERT_NE(schedule.getLifetime(a), nullptr);
+    EXPECT_EQ(schedule.getLifetime(a)->firstPass, 0);
+    EXPECT_EQ(schedule.getLifetime(a)->lastPass, 1);
+    EXPECT_EQ(schedule.getLifetime(c)->firstPass, 2);
+    EXPECT_EQ(schedule.getLifetime(c)->lastPass, 3);
+
+    const TransientPlacement* pA = schedule.getPlacement(a);
+    const TransientPlacement* pB = schedule.getPlacement(b);
+    const TransientPlacement* pC = schedule.getPlacement(c);
+    ASSERT_TRUE(pA && pB && pC);
+    EXPECT_EQ(pA->offset, pC->offset);
+    EXPECT_NE(pA->offset, pB->offset);
+    EXPECT_EQ(schedule.getPlacement(incompatible), nullptr);
+
+    EXPECT_EQ(schedule.getHeapSize(), 2048);
+    EXPECT_EQ(schedule.getUnaliasedSize(), 3072);
+    EXPECT_EQ(schedule.getHeapMemoryTypeBits(), 0b11);
+}
+
+TEST(RenderGraphSchedule, AliasedResourceWaitsForPreviousOccupant) {
+    Carrot::UUID a, b, c;
+    const std::vector<ScheduledPass> passes = makeChain(a, b, c);
+    const Schedule schedule = Schedule::build(passes, std::vector { transient(a, 1024), transient(b, 1024), transient(c, 1024) });
+
+    // c reuses the memory of a: its contents are discarded, and a must no longer be in use
+    const PassBarriers& barriers = schedule.getBarriers(2);
+    ASSERT_EQ(barriers.images.size(), 1);
+    const ScheduledImageBarrier& barrier = barriers.images[0];
+    EXPECT_EQ(barrier.resourceID, c);
+    EXPECT_EQ(barrier.oldLayout, vk::ImageLayout::eUndefined);
+    EXPECT_EQ(barrier.newLayout, vk::ImageLayout::eGeneral);
+    EXPECT_EQ(barrier.srcStages, vk::PipelineStageFlagBits2KHR::eComputeShader);
+    EXPECT_EQ(barrier.srcAccess, vk::AccessFlagBits2KHR::eShaderWrite);
+
+    // b was written by the previous pass
+    EXPECT_TRUE(barriers.hasMemoryBarrier());
+    EXPECT_TRUE(barriers.srcAccess & vk::AccessFlagBits2KHR::eShaderWrite);
+    EXPECT_TRUE(barriers.dstAccess & vk::AccessFlagBits2KHR::eShaderRead);
+
+    EXPECT_NE(schedule.describe().find("b to c"), std::string::npos);
+}
+
+TEST(RenderGraphSchedule, ComputeToRasterizedBarriers) {
+    Carrot::UUID image, buffer;
+    const std::vector<ScheduledPass> passes {
+        computePass("compute", {
+            imageAccess(image, true, vk::ImageLayout::eGeneral, vk::ImageLayout::eGeneral),
+            ScheduledAccess { .resourceID = buffer, .isBuffer = true, .write = true, .clearEachFrame = true },
+        }),
+        ScheduledPass {
+            .name = "raster",
+            .rasterized = true,
+            .shaderStages = vk::PipelineStageFlagBits2KHR::eVertexShader | vk::PipelineStageFlagBits2KHR::eFragmentShader,
+            .accesses = {
+                imageAccess(image, false, vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal),
+                ScheduledAccess { .resourceID = buffer, .isBuffer = true },
+            },
+        },
+    };
+    const Schedule schedule = Schedule::build(passes, {});
+    EXPECT_EQ(schedule.getHeapSize(), 0);
+
+    // the buffer is filled before the first pass
+    const PassBarriers& computeBarriers = schedule.getBarriers(0);
+    EXPECT_TRUE(computeBarriers.images.empty());
+    EXPECT_EQ(computeBarriers.srcStages, vk::PipelineStageFlagBits2KHR::eTransfer);
+    EXPECT_TRUE(computeBarriers.dstStages & vk::PipelineStageFlagBits2KHR::eComputeShader);
+
+    const PassBarriers& rasterBarriers = schedule.getBarriers(1);
+    ASSERT_EQ(rasterBarriers.images.size(), 1);
+    EXPECT_EQ(rasterBarriers.images[0].oldLayout, vk::ImageLayout::eGeneral);
+    EXPECT_EQ(rasterBarriers.images[0].newLayout, vk::ImageLayout::eShaderReadOnlyOptimal);
+    EXPECT_TRUE(rasterBarriers.images[0].srcStages & vk::PipelineStageFlagBits2KHR::eComputeShader);
+    EXPECT_TRUE(rasterBarriers.images[0].dstStages & vk::PipelineStageFlagBits2KHR::eFragmentShader);
+
+    EXPECT_TRUE(rasterBarriers.srcStages & vk::PipelineStageFlagBits2KHR::eComputeShader);
+    EXPECT_TRUE(rasterBarriers.srcAccess & vk::AccessFlagBits2KHR::eShaderWrite);
+    EXPECT_TRUE(rasterBarriers.dstStages & vk::PipelineStageFlagBits2KHR::eVertexShader);
+    EXPECT_TRUE(rasterBarriers.dstAccess & vk::AccessFlagBits2KHR::eShaderRead);
+}
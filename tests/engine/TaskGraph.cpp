@@ -0,0 +1,107 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include <gtest/gtest.h>
+#include "engine/Engine.h"
+#include "engine/task/TaskGraph.h"
+
+using namespace Carrot;
+
+#define START_ENGINE()                                      \
+Carrot::Configuration config;                               \
+config.applicationName = __FUNCTION__;                      \
+Carrot::Engine e{ config };
+
+/// Records the order in which nodes are executed
+struct ExecutionLog {
+    std::mutex access;
+    std::vector<TaskGraph::NodeID> order;
+
+    TaskGraph::NodeID addNode(TaskGraph& graph, const char* name, TaskStackSize stackSize = TaskStackSize::Small) {
+        const TaskGraph::NodeID id = static_cast<TaskGraph::NodeID>(graph.getNodeCount());
+        return graph.addNode(TaskGraph::NodeDescription {
+            .name = name,
+            .task = [this, id](TaskHandle&) {
+                std::lock_guard l { access };
+                order.push_back(id);
+            },
+            .stackSize = stackSize,
+        });
+    }
+
+    std::size_t positionOf(TaskGraph::NodeID id) {
+        return std::find(order.begin(), order.end(), id) - order.begin();
+    }
+};
+
+TEST(TaskGraph, LinearChain) {
+    START_ENGINE();
+
+    TaskGraph graph { "LinearChain" };
+    ExecutionLog log;
+    std::vector<TaskGraph::NodeID> chain;
+    for(int i = 0; i < 8; i++) {
+        chain.push_back(log.addNode(graph, "Chain node", i % 2 == 0 ? TaskStackSize::Small : TaskStackSize::Large));
+    }
+    // declared in reverse order, to make sure the order comes from the dependencies and not from the insertion order
+    for(std::size_t i = chain.size() - 1; i > 0; i--) {
+        graph.addDependency(chain[i - 1], chain[i]);
+    }
+
+    for(int execution = 0; execution < 3; execution++) {
+        log.order.clear();
+        graph.executeAndWait();
+        EXPECT_FALSE(graph.isRunning());
+        EXPECT_EQ(log.order, chain);
+    }
+}
+
+TEST(TaskGraph, DiamondJoin) {
+    START_ENGINE();
+
+    TaskGraph graph { "DiamondJoin" };
+    ExecutionLog log;
+    const TaskGraph::NodeID top = log.addNode(graph, "Top");
+    const TaskGraph::NodeID left = log.addNode(graph, "Left");
+    const TaskGraph::NodeID right = log.addNode(graph, "Right");
+    const TaskGraph::NodeID bottom = log.addNode(graph, "Bottom");
+    graph.addDependency(top, left);
+    graph.addDependency(top, right);
+    graph.addDependency(left, bottom);
+    graph.addDependency(right, bottom);
+    graph.addDependency(right, bottom); // duplicates are ignored, otherwise 'bottom' would never start
+
+    for(int execution = 0; execution < 3; execution++) {
+        log.order.clear();
+        graph.executeAndWait();
+        ASSERT_EQ(log.order.size(), 4);
+        EXPECT_EQ(log.order.front(), top);
+        EXPECT_EQ(log.order.back(), bottom);
+        EXPECT_LT(log.positionOf(left), log.positionOf(bottom));
+        EXPECT_LT(log.positionOf(right), log.positionOf(bottom));
+    }
+}
+
+TEST(TaskGraph, CycleIsRejected) {
+    START_ENGINE();
+
+    TaskGraph graph { "Cycle" };
+    ExecutionLog log;
+    const TaskGraph::NodeID start = log.addNode(graph, "Start");
+    const TaskGraph::NodeID a = log.addNode(graph, "A");
+    const TaskGraph::NodeID b = log.addNode(graph, "B");
+    const TaskGraph::NodeID c = log.addNode(graph, "C");
+    graph.addDependency(start, a);
+    graph.addDependency(a, b);
+    graph.addDependency(b, c);
+    graph.addDependency(c, a);
+
+    EXPECT_THROW(graph.compile(), std::runtime_error);
+    EXPECT_THROW(graph.executeAndWait(), std::runtime_error);
+    EXPECT_FALSE(graph.isRunning());
+    EXPECT_TRUE(log.order.empty());
+}
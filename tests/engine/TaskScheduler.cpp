@@ -0,0 +1,35 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "engine/Engine.h"
+#include "engine/task/TaskScheduler.h"
+
+TEST(TaskScheduler, InjectedTasksRunInSubmissionOrder) {
+    Carrot::Configuration config;
+    config.applicationName = "TaskScheduler";
+    Carrot::Engine e{ config };
+
+    // the test thread is not a worker of MainLoop: tasks scheduled from here go to the injected deques of the lane
+    constexpr std::size_t TaskCount = 32;
+    std::vector<std::size_t> executionOrder;
+    for(std::size_t i = 0; i < TaskCount; i++) {
+        GetTaskScheduler().schedule(Carrot::TaskDescription {
+            .name = "FIFO test",
+            .task = [i, &executionOrder](Carrot::TaskHandle&) {
+                executionOrder.push_back(i);
+            },
+        }, Carrot::TaskScheduler::MainLoop);
+    }
+
+    for(std::size_t attempt = 0; attempt < TaskCount * 4 && executionOrder.size() < TaskCount; attempt++) {
+        GetTaskScheduler().executeMainLoop();
+    }
+
+    ASSERT_EQ(executionOrder.size(), TaskCount);
+    for(std::size_t i = 0; i < TaskCount; i++) {
+        EXPECT_EQ(executionOrder[i], i);
+    }
+}
@@ -0,0 +1,128 @@
+//
+// Created by jglrxavpok on 18/10/2026.
+//
+
+#include <gtest/gtest.h>
+#include "engine/Engine.h"
+#include "engine/ecs/World.h"
+#include "engine/ecs/WorldSnapshot.h"
+#include "engine/ecs/components/TransformComponent.h"
+#include "engine/ecs/systems/System.h"
+
+using namespace Carrot::ECS;
+
+#define START_ENGINE()                                      \
+Carrot::Configuration config;                               \
+config.applicationName = __FUNCTION__;                      \
+Carrot::Engine e{ config };
+
+class ReadingRenderSystem: public RenderSystem<TransformComponent> {
+public:
+    explicit ReadingRenderSystem(World& world): RenderSystem<TransformComponent>(world) {}
+
+    void onFrame(Carrot::Render::Context renderContext) override {}
+
+    float sumPositions() {
+        float sum = 0.0f;
+        forEachEntity([&](Entity& entity, TransformComponent& transform) {
+            sum += transform.localTransform.position.x;
+        });
+        return sum;
+    }
+
+    std::unique_ptr<System> duplicate(World& newOwner) const override {
+        return std::make_unique<ReadingRenderSystem>(newOwner);
+    }
+
+    const char* getName() const override {
+        return "ReadingRenderSystem";
+    }
+};
+
+class MovingLogicSystem: public LogicSystem<TransformComponent> {
+public:
+    explicit MovingLogicSystem(World& world): LogicSystem<TransformComponent>(world) {}
+
+    void moveAll(float dx) {
+        forEachEntity([&](Entity& entity, TransformComponent& transform) {
+            transform.localTransform.position.x += dx;
+        });
+    }
+
+    std::unique_ptr<System> duplicate(World& newOwner) const override {
+        return std::make_unique<MovingLogicSystem>(newOwner);
+    }
+
+    const char* getName() const override {
+        return "MovingLogicSystem";
+    }
+};
+
+static Entity createEntity(World& world, const char* name, float x) {
+    Entity entity = world.newEntity(name).addComponent<TransformComponent>();
+    entity.getComponent<TransformComponent>()->localTransform.position.x = x;
+    return entity;
+}
+
+TEST(WorldSnapshot, OnlyModifiedComponentsAreRestored) {
+    START_ENGINE();
+
+    World w;
+    ReadingRenderSystem& renderSystem = w.addRenderSystem<ReadingRenderSystem>();
+    const EntityID a = createEntity(w, "A", 1.0f).getID();
+    const EntityID b = createEntity(w, "B", 2.0f).getID();
+    const EntityID c = createEntity(w, "C", 3.0f).getID();
+    w.tick(0.0);
+    TransformComponent* pTransformC = &w.getComponent<TransformComponent>(c).asRef();
+
+    std::unique_ptr<WorldSnapshot> snapshot = w.takeSnapshot();
+
+    // reads are not modifications
+    EXPECT_FLOAT_EQ(renderSystem.sumPositions(), 6.0f);
+    EXPECT_FLOAT_EQ(w.readComponent<TransformComponent>(b)->localTransform.position.x, 2.0f);
+    EXPECT_TRUE(snapshot->getModifiedComponents().empty());
+
+    w.getComponent<TransformComponent>(a)->localTransform.position.x = 10.0f;
+    // write through a pointer kept from before the snapshot: not tracked, so not restored
+    pTransformC->localTransform.position.x = 30.0f;
+
+    EXPECT_TRUE(snapshot->wasModified(a, TransformComponent::getID()));
+    EXPECT_FALSE(snapshot->wasModified(b, TransformComponent::getID()));
+    EXPECT_FALSE(snapshot->wasModified(c, TransformComponent::getID()));
+    EXPECT_EQ(snapshot->getModifiedComponents().size(), 1);
+
+    w.restoreSnapshot(std::move(snapshot));
+
+    EXPECT_FLOAT_EQ(w.readComponent<TransformComponent>(a)->localTransform.position.x, 1.0f);
+    EXPECT_FLOAT_EQ(w.readComponent<TransformComponent>(b)->localTransform.position.x, 2.0f);
+
+    // untouched components are kept as-is: same object, same value
+    EXPECT_EQ(w.readComponent<TransformComponent>(c), pTransformC);
+    EXPECT_FLOAT_EQ(pTransformC->localTransform.position.x, 30.0f);
+}
+
+TEST(WorldSnapshot, LogicSystemIterationIsRestored) {
+    START_ENGINE();
+
+    World w;
+    MovingLogicSystem& logicSystem = w.addLogicSystem<MovingLogicSystem>();
+    const EntityID a = createEntity(w, "A", 1.0f).getID();
+    const EntityID b = createEntity(w, "B", 2.0f).getID();
+    w.tick(0.0);
+
+    std::unique_ptr<WorldSnapshot> snapshot = w.takeSnapshot();
+    logicSystem.moveAll(5.0f);
+    logicSystem.moveAll(5.0f);
+    EXPECT_FLOAT_EQ(w.readComponent<TransformComponent>(a)->localTransform.position.x, 11.0f);
+    EXPECT_EQ(snapshot->getModifiedComponents().size(), 2);
+
+    // entity created during play
+    const EntityID created = createEntity(w, "Created", 0.0f).getID();
+    EXPECT_TRUE(snapshot->wasModified(created, TransformComponent::getID()));
+
+    w.restoreSnapshot(std::move(snapshot));
+
+    EXPECT_FLOAT_EQ(w.readComponent<TransformComponent>(a)->localTransform.position.x, 1.0f);
+    EXPECT_FLOAT_EQ(w.readComponent<TransformComponent>(b)->localTransform.position.x, 2.0f);
+    EXPECT_FALSE(w.exists(created));
+}